@@ -119,13 +119,18 @@ bool DeserializeFileDB(const fs::path& path, Data& data)
 }
 } // namespace
 
-CBanDB::CBanDB(fs::path ban_list_path) : m_ban_list_path(std::move(ban_list_path))
+CBanDB::CBanDB(fs::path ban_list_path)
+    : m_ban_list_path(std::move(ban_list_path)),
+      m_journal_path(m_ban_list_path.parent_path() / "banlist.journal")
 {
 }
 
 bool CBanDB::Write(const banmap_t& banSet)
 {
-    return SerializeFileDB("banlist", m_ban_list_path, banSet);
+    if (!SerializeFileDB("banlist", m_ban_list_path, banSet)) return false;
+    // The snapshot supersedes all journaled mutations.
+    ResetJournal();
+    return true;
 }
 
 bool CBanDB::Read(banmap_t& banSet)
@@ -133,14 +138,144 @@ bool CBanDB::Read(banmap_t& banSet)
     return DeserializeFileDB(m_ban_list_path, banSet);
 }
 
+bool CBanDB::AppendJournal(const BanDelta& delta)
+{
+    const bool new_journal = !fs::exists(m_journal_path);
+    FILE* file = fsbridge::fopen(m_journal_path, "ab");
+    CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
+    if (fileout.IsNull()) {
+        return error("%s: Failed to open file %s", __func__, m_journal_path.string());
+    }
+
+    try {
+        // Tag a fresh journal with the network magic; individual records are
+        // not checksummed, so a torn tail just truncates the replay.
+        if (new_journal) fileout << Params().MessageStart();
+        fileout << delta;
+    } catch (const std::exception& e) {
+        return error("%s: Serialize or I/O error - %s", __func__, e.what());
+    }
+    if (!FileCommit(fileout.Get())) {
+        return error("%s: Failed to flush file %s", __func__, m_journal_path.string());
+    }
+    return true;
+}
+
+bool CBanDB::ReadJournal(banmap_t& banSet)
+{
+    FILE* file = fsbridge::fopen(m_journal_path, "rb");
+    if (!file) return true; // No journal since the last full write
+    CAutoFile filein(file, SER_DISK, CLIENT_VERSION);
+
+    int entries = 0;
+    try {
+        unsigned char pchMsgTmp[4];
+        filein >> pchMsgTmp;
+        if (memcmp(pchMsgTmp, Params().MessageStart(), sizeof(pchMsgTmp))) {
+            return error("%s: Invalid network magic number", __func__);
+        }
+        while (true) {
+            BanDelta delta;
+            filein >> delta;
+            if (delta.m_remove) {
+                banSet.erase(delta.m_sub_net);
+            } else {
+                banSet[delta.m_sub_net] = delta.m_entry;
+            }
+            entries++;
+        }
+    } catch (const std::exception&) {
+        // End of journal, possibly a torn tail from an unclean shutdown;
+        // everything up to this point has been applied.
+    }
+    LogPrintf("Replayed %i banlist journal entries from %s\n", entries, m_journal_path.filename().string());
+    return true;
+}
+
+void CBanDB::ResetJournal()
+{
+    try {
+        fs::remove(m_journal_path);
+    } catch (const fs::filesystem_error& e) {
+        LogPrintf("Unable to remove %s: %s\n", m_journal_path.string(), fsbridge::get_filesystem_error_message(e));
+    }
+}
+
 CAddrDB::CAddrDB()
 {
     pathAddr = GetDataDir() / "peers.dat";
+    pathJournal = GetDataDir() / "peers.journal";
 }
 
 bool CAddrDB::Write(const CAddrMan& addr)
 {
-    return SerializeFileDB("peers", pathAddr, addr);
+    if (!SerializeFileDB("peers", pathAddr, addr)) return false;
+    // The snapshot supersedes all journaled mutations.
+    ResetJournal();
+    return true;
+}
+
+bool CAddrDB::AppendJournal(const std::vector<AddrManDelta>& deltas)
+{
+    if (deltas.empty()) return true;
+
+    const bool new_journal = !fs::exists(pathJournal);
+    FILE* file = fsbridge::fopen(pathJournal, "ab");
+    CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
+    if (fileout.IsNull()) {
+        return error("%s: Failed to open file %s", __func__, pathJournal.string());
+    }
+
+    try {
+        // Tag a fresh journal with the network magic; individual records are
+        // not checksummed, so a torn tail just truncates the replay.
+        if (new_journal) fileout << Params().MessageStart();
+        for (const AddrManDelta& delta : deltas) {
+            fileout << delta;
+        }
+    } catch (const std::exception& e) {
+        return error("%s: Serialize or I/O error - %s", __func__, e.what());
+    }
+    if (!FileCommit(fileout.Get())) {
+        return error("%s: Failed to flush file %s", __func__, pathJournal.string());
+    }
+    return true;
+}
+
+bool CAddrDB::ReadJournal(CAddrMan& addr)
+{
+    FILE* file = fsbridge::fopen(pathJournal, "rb");
+    if (!file) return true; // No journal since the last full write
+    CAutoFile filein(file, SER_DISK, CLIENT_VERSION);
+
+    int entries = 0;
+    try {
+        unsigned char pchMsgTmp[4];
+        filein >> pchMsgTmp;
+        if (memcmp(pchMsgTmp, Params().MessageStart(), sizeof(pchMsgTmp))) {
+            return error("%s: Invalid network magic number", __func__);
+        }
+        while (true) {
+            AddrManDelta delta;
+            filein >> delta;
+            addr.ApplyDelta(delta);
+            entries++;
+        }
+    } catch (const std::exception&) {
+        // End of journal, possibly a torn tail from an unclean shutdown;
+        // everything up to this point has been applied.
+    }
+    LogPrintf("Replayed %i addrman journal entries from %s\n", entries, pathJournal.filename().string());
+    return true;
+}
+
+void CAddrDB::ResetJournal()
+{
+    try {
+        fs::remove(pathJournal);
+    } catch (const fs::filesystem_error& e) {
+        LogPrintf("Unable to remove %s: %s\n", pathJournal.string(), fsbridge::get_filesystem_error_message(e));
+    }
 }
 
 bool CAddrDB::Read(CAddrMan& addr)
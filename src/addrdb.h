@@ -8,6 +8,7 @@
 
 #include <fs.h>
 #include <net_types.h> // For banmap_t
+#include <netaddress.h>
 #include <serialize.h>
 
 #include <string>
@@ -16,6 +17,7 @@
 class CAddress;
 class CAddrMan;
 class CDataStream;
+struct AddrManDelta;
 
 class CBanEntry
 {
@@ -50,27 +52,57 @@ public:
     }
 };
 
-/** Access to the (IP) address database (peers.dat) */
+/** Access to the (IP) address database (peers.dat), plus the incremental
+ *  mutation journal (peers.journal) appended to between full writes. */
 class CAddrDB
 {
 private:
     fs::path pathAddr;
+    fs::path pathJournal;
 public:
     CAddrDB();
+    //! Write a full snapshot. This also removes the journal, whose contents
+    //! the snapshot supersedes (compaction).
     bool Write(const CAddrMan& addr);
     bool Read(CAddrMan& addr);
     static bool Read(CAddrMan& addr, CDataStream& ssPeers);
+    //! Append journaled mutations to peers.journal; O(changes) rather than a
+    //! full-table serialization.
+    bool AppendJournal(const std::vector<AddrManDelta>& deltas);
+    //! Replay peers.journal on top of a loaded addrman. A missing journal or
+    //! a torn tail (from an unclean shutdown) is not an error.
+    bool ReadJournal(CAddrMan& addr);
+    //! Remove the journal; called after a full snapshot write.
+    void ResetJournal();
 };
 
-/** Access to the banlist database (banlist.dat) */
+/** A single journaled banlist mutation: an upsert or removal of one subnet. */
+struct BanDelta {
+    bool m_remove{false};
+    CSubNet m_sub_net;
+    CBanEntry m_entry;
+
+    SERIALIZE_METHODS(BanDelta, obj) { READWRITE(obj.m_remove, obj.m_sub_net, obj.m_entry); }
+};
+
+/** Access to the banlist database (banlist.dat), plus the incremental
+ *  mutation journal (banlist.journal) appended to between full writes. */
 class CBanDB
 {
 private:
     const fs::path m_ban_list_path;
+    const fs::path m_journal_path;
 public:
     explicit CBanDB(fs::path ban_list_path);
+    //! Write a full snapshot. This also removes the journal, whose contents
+    //! the snapshot supersedes.
     bool Write(const banmap_t& banSet);
     bool Read(banmap_t& banSet);
+    //! Append one mutation to the journal without rewriting the snapshot.
+    bool AppendJournal(const BanDelta& delta);
+    //! Apply journaled mutations on top of a freshly read snapshot.
+    bool ReadJournal(banmap_t& banSet);
+    void ResetJournal();
 };
 
 /**
@@ -56,6 +56,20 @@ private:
     //! position in vRandom
     int nRandomPos{-1};
 
+    //! Memoized GetGroup()/GetMappedAS() results for the asmap-dependent
+    //! bucketing math (memory only). With -asmap, every bucket calculation
+    //! otherwise re-walks the asmap bit-trie for the same address. The cache
+    //! is keyed on the asmap's identity and recomputed if a different asmap
+    //! is passed (as the unit tests do).
+    mutable const std::vector<bool>* m_group_asmap{nullptr};
+    mutable size_t m_group_asmap_size{0};
+    mutable std::vector<unsigned char> m_group;
+    mutable uint32_t m_mapped_as{0};
+
+    //! Return the (possibly cached) GetGroup()/GetMappedAS() results for asmap.
+    const std::vector<unsigned char>& GetGroupCached(const std::vector<bool>& asmap) const;
+    uint32_t GetMappedASCached(const std::vector<bool>& asmap) const;
+
     friend class CAddrMan;
 
 public:
@@ -166,6 +180,44 @@ public:
 //! the maximum time we'll spend trying to resolve a tried table collision, in seconds
 static const int64_t ADDRMAN_TEST_WINDOW = 40*60; // 40 minutes
 
+/**
+ * A journaled addrman mutation, appended to peers.journal between full
+ * peers.dat writes so that address persistence is O(changes) rather than a
+ * full-table serialization (see CAddrDB::AppendJournal).
+ */
+struct AddrManDelta {
+    enum class Op : uint8_t {
+        ADD = 0,
+        GOOD = 1,
+        ATTEMPT = 2,
+    };
+
+    uint8_t op;
+    CAddress addr;
+    //! Only meaningful for ADD.
+    CNetAddr source;
+    //! nTimePenalty for ADD, nTime for GOOD/ATTEMPT.
+    int64_t time{0};
+    //! Only meaningful for ATTEMPT.
+    bool count_failure{false};
+
+    template <typename Stream>
+    void Serialize(Stream& s_) const
+    {
+        // Always use the v2 address format in the journal, so that it can
+        // carry Tor v3/I2P addresses regardless of the caller's version.
+        OverrideStream<Stream> s(&s_, s_.GetType(), s_.GetVersion() | ADDRV2_FORMAT);
+        s << op << addr << source << time << count_failure;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s_)
+    {
+        OverrideStream<Stream> s(&s_, s_.GetType(), s_.GetVersion() | ADDRV2_FORMAT);
+        s >> op >> addr >> source >> time >> count_failure;
+    }
+};
+
 /**
  * Stochastical (IP) address manager
  */
@@ -229,6 +281,27 @@ private:
     //! Holds addrs inserted into tried table that collide with existing entries. Test-before-evict discipline used to resolve these collisions.
     std::set<int> m_tried_collisions;
 
+    //! Mutations since the last journal flush or full peers.dat write.
+    std::vector<AddrManDelta> m_deltas GUARDED_BY(cs);
+
+    //! When set, m_deltas stopped being recorded because it hit
+    //! MAX_PENDING_DELTAS; the next TakeDeltas() caller must trigger a full
+    //! peers.dat write instead of a journal append.
+    bool m_deltas_overflowed GUARDED_BY(cs){false};
+
+    //! Cap on the in-memory mutation journal.
+    static constexpr size_t MAX_PENDING_DELTAS{100000};
+
+    //! Record a mutation for the persistence journal.
+    void RecordDelta(AddrManDelta&& delta) EXCLUSIVE_LOCKS_REQUIRED(cs)
+    {
+        if (m_deltas.size() >= MAX_PENDING_DELTAS) {
+            m_deltas_overflowed = true;
+            return;
+        }
+        m_deltas.push_back(std::move(delta));
+    }
+
 protected:
     //! secret key to randomize bucket select with
     uint256 nKey;
@@ -599,6 +672,40 @@ public:
         nLastGood = 1; //Initially at 1 so that "never" is strictly worse.
         mapInfo.clear();
         mapAddr.clear();
+        m_deltas.clear();
+        m_deltas_overflowed = false;
+    }
+
+    //! Move out the mutations journaled since the last call. Sets overflowed
+    //! if deltas were dropped, in which case the caller must write a full
+    //! peers.dat instead of appending the returned deltas to the journal.
+    std::vector<AddrManDelta> TakeDeltas(bool& overflowed)
+    {
+        LOCK(cs);
+        overflowed = m_deltas_overflowed;
+        m_deltas_overflowed = false;
+        std::vector<AddrManDelta> deltas;
+        deltas.swap(m_deltas);
+        return deltas;
+    }
+
+    //! Re-apply a journaled mutation at load time. Does not journal the
+    //! mutation again: it is already in the on-disk journal, which survives
+    //! until the next full peers.dat write.
+    void ApplyDelta(const AddrManDelta& delta)
+    {
+        LOCK(cs);
+        switch (static_cast<AddrManDelta::Op>(delta.op)) {
+        case AddrManDelta::Op::ADD:
+            Add_(delta.addr, delta.source, delta.time);
+            break;
+        case AddrManDelta::Op::GOOD:
+            Good_(delta.addr, true, delta.time);
+            break;
+        case AddrManDelta::Op::ATTEMPT:
+            Attempt_(delta.addr, delta.count_failure, delta.time);
+            break;
+        }
     }
 
     CAddrMan()
@@ -640,6 +747,7 @@ public:
         fRet |= Add_(addr, source, nTimePenalty);
         Check();
         if (fRet) {
+            RecordDelta({static_cast<uint8_t>(AddrManDelta::Op::ADD), addr, source, nTimePenalty});
             LogPrint(BCLog::ADDRMAN, "Added %s from %s: %i tried, %i new\n", addr.ToStringIPPort(), source.ToString(), nTried, nNew);
         }
         return fRet;
@@ -651,8 +759,12 @@ public:
         LOCK(cs);
         int nAdd = 0;
         Check();
-        for (std::vector<CAddress>::const_iterator it = vAddr.begin(); it != vAddr.end(); it++)
-            nAdd += Add_(*it, source, nTimePenalty) ? 1 : 0;
+        for (std::vector<CAddress>::const_iterator it = vAddr.begin(); it != vAddr.end(); it++) {
+            if (Add_(*it, source, nTimePenalty)) {
+                nAdd++;
+                RecordDelta({static_cast<uint8_t>(AddrManDelta::Op::ADD), *it, source, nTimePenalty});
+            }
+        }
         Check();
         if (nAdd) {
             LogPrint(BCLog::ADDRMAN, "Added %i addresses from %s: %i tried, %i new\n", nAdd, source.ToString(), nTried, nNew);
@@ -666,6 +778,7 @@ public:
         LOCK(cs);
         Check();
         Good_(addr, test_before_evict, nTime);
+        RecordDelta({static_cast<uint8_t>(AddrManDelta::Op::GOOD), CAddress{addr, NODE_NONE}, CNetAddr{}, nTime});
         Check();
     }
 
@@ -675,6 +788,7 @@ public:
         LOCK(cs);
         Check();
         Attempt_(addr, fCountFailure, nTime);
+        RecordDelta({static_cast<uint8_t>(AddrManDelta::Op::ATTEMPT), CAddress{addr, NODE_NONE}, CNetAddr{}, nTime, fCountFailure});
         Check();
     }
 
@@ -21,6 +21,7 @@ BanMan::BanMan(fs::path ban_file, CClientUIInterface* client_interface, int64_t
     m_is_dirty = false;
     banmap_t banmap;
     if (m_ban_db.Read(banmap)) {
+        m_ban_db.ReadJournal(banmap); // apply mutations journaled since the last full write
         SetBanned(banmap);        // thread save setter
         SetBannedSetDirty(false); // no need to write down, just read data
         SweepBanned();            // sweep out unused entries
@@ -62,6 +63,7 @@ void BanMan::ClearBanned()
     {
         LOCK(m_cs_banned);
         m_banned.clear();
+        m_banned_ranges.clear();
         m_is_dirty = true;
     }
     DumpBanlist(); //store banlist to disk
@@ -78,11 +80,14 @@ bool BanMan::IsBanned(const CNetAddr& net_addr)
 {
     auto current_time = GetTime();
     LOCK(m_cs_banned);
-    for (const auto& it : m_banned) {
-        CSubNet sub_net = it.first;
-        CBanEntry ban_entry = it.second;
-
-        if (current_time < ban_entry.nBanUntil && sub_net.Match(net_addr)) {
+    // Single-host bans are found with one map lookup.
+    auto it = m_banned.find(CSubNet{net_addr});
+    if (it != m_banned.end() && current_time < it->second.nBanUntil) {
+        return true;
+    }
+    // Only entries covering more than one address need subnet matching.
+    for (const auto& [sub_net, ban_until] : m_banned_ranges) {
+        if (current_time < ban_until && sub_net.Match(net_addr)) {
             return true;
         }
     }
@@ -131,14 +136,17 @@ void BanMan::Ban(const CSubNet& sub_net, int64_t ban_time_offset, bool since_uni
         LOCK(m_cs_banned);
         if (m_banned[sub_net].nBanUntil < ban_entry.nBanUntil) {
             m_banned[sub_net] = ban_entry;
+            if (!sub_net.IsSingleIP()) m_banned_ranges[sub_net] = ban_entry.nBanUntil;
             m_is_dirty = true;
         } else
             return;
     }
     if (m_client_interface) m_client_interface->BannedListChanged();
 
-    //store banlist to disk immediately
-    DumpBanlist();
+    // Journal the mutation immediately; the periodic DumpBanlist() compacts
+    // the journal into a fresh snapshot. If the append fails, the dirty flag
+    // still guarantees the next full dump persists this ban.
+    m_ban_db.AppendJournal({/*m_remove=*/false, sub_net, ban_entry});
 }
 
 bool BanMan::Unban(const CNetAddr& net_addr)
@@ -152,10 +160,11 @@ bool BanMan::Unban(const CSubNet& sub_net)
     {
         LOCK(m_cs_banned);
         if (m_banned.erase(sub_net) == 0) return false;
+        m_banned_ranges.erase(sub_net);
         m_is_dirty = true;
     }
     if (m_client_interface) m_client_interface->BannedListChanged();
-    DumpBanlist(); //store banlist to disk immediately
+    m_ban_db.AppendJournal({/*m_remove=*/true, sub_net, CBanEntry{}});
     return true;
 }
 
@@ -171,6 +180,10 @@ void BanMan::SetBanned(const banmap_t& banmap)
 {
     LOCK(m_cs_banned);
     m_banned = banmap;
+    m_banned_ranges.clear();
+    for (const auto& [sub_net, ban_entry] : m_banned) {
+        if (!sub_net.IsSingleIP()) m_banned_ranges[sub_net] = ban_entry.nBanUntil;
+    }
     m_is_dirty = true;
 }
 
@@ -186,6 +199,7 @@ void BanMan::SweepBanned()
             CBanEntry ban_entry = (*it).second;
             if (!sub_net.IsValid() || now > ban_entry.nBanUntil) {
                 m_banned.erase(it++);
+                m_banned_ranges.erase(sub_net);
                 m_is_dirty = true;
                 notify_ui = true;
                 LogPrint(BCLog::NET, "%s: Removed banned node ip/subnet from banlist.dat: %s\n", __func__, sub_net.ToString());
@@ -88,6 +88,11 @@ private:
 
     RecursiveMutex m_cs_banned;
     banmap_t m_banned GUARDED_BY(m_cs_banned);
+    //! Index of the entries in m_banned that cover more than a single
+    //! address, mapped to their nBanUntil. IsBanned(CNetAddr) finds
+    //! single-host bans (the common case) with one map lookup and only
+    //! runs subnet matching against these ranges.
+    std::map<CSubNet, int64_t> m_banned_ranges GUARDED_BY(m_cs_banned);
     bool m_is_dirty GUARDED_BY(m_cs_banned);
     CClientUIInterface* m_client_interface = nullptr;
     CBanDB m_ban_db;
@@ -48,39 +48,68 @@ static const int8_t mapBase58[256] = {
         if (zeroes > max_ret_len) return false;
         psz++;
     }
-    // Allocate enough space in big-endian base256 representation.
-    int size = strlen(psz) * 733 /1000 + 1; // log(58) / log(256), rounded up.
-    std::vector<unsigned char> b256(size);
-    // Process the characters.
+    // Validate the charset and find the end of the digits up front, so the
+    // arithmetic below runs over known-good input.
     static_assert(std::size(mapBase58) == 256, "mapBase58.size() should be 256"); // guarantee not out of range
-    while (*psz && !IsSpace(*psz)) {
-        // Decode base58 character
-        int carry = mapBase58[(uint8_t)*psz];
-        if (carry == -1)  // Invalid b58 character
+    const char* begin = psz;
+    const char* end = psz;
+    while (*end && !IsSpace(*end)) {
+        if (mapBase58[(uint8_t)*end] == -1) // Invalid b58 character
             return false;
-        int i = 0;
-        for (std::vector<unsigned char>::reverse_iterator it = b256.rbegin(); (carry != 0 || i < length) && (it != b256.rend()); ++it, ++i) {
-            carry += 58 * (*it);
-            *it = carry % 256;
-            carry /= 256;
-        }
-        assert(carry == 0);
-        length = i;
-        if (length + zeroes > max_ret_len) return false;
-        psz++;
+        end++;
     }
     // Skip trailing spaces.
-    while (IsSpace(*psz))
-        psz++;
-    if (*psz != 0)
+    const char* tail = end;
+    while (IsSpace(*tail))
+        tail++;
+    if (*tail != 0)
         return false;
-    // Skip leading zeroes in b256.
-    std::vector<unsigned char>::iterator it = b256.begin() + (size - length);
+
+    const int64_t digits = end - begin;
+    // A number of d digits needs at least (d - 1) * log(58) / log(256) bytes;
+    // reject oversized input before doing any work.
+    if (digits > 0 && (digits - 1) * 7327 / 10000 > (int64_t)max_ret_len - zeroes) return false;
+
+    // Decode in groups of up to 5 digits: 58^5 fits in 32 bits, so each group
+    // costs one multiply-accumulate pass over 32-bit limbs instead of one
+    // pass per digit.
+    std::vector<uint32_t> limbs; // little-endian, base 2^32
+    limbs.reserve(digits * 733 / 1000 / 4 + 1);
+    const char* p = begin;
+    while (p != end) {
+        uint32_t group = 0;
+        uint32_t mult = 1;
+        for (int i = 0; i < 5 && p != end; ++i, ++p) {
+            group = group * 58 + mapBase58[(uint8_t)*p];
+            mult *= 58;
+        }
+        // limbs = limbs * mult + group
+        uint64_t carry = group;
+        for (uint32_t& limb : limbs) {
+            uint64_t v = (uint64_t)limb * mult + carry;
+            limb = (uint32_t)v;
+            carry = v >> 32;
+        }
+        if (carry) limbs.push_back((uint32_t)carry);
+    }
+    // Write out the limbs as big-endian bytes, dropping leading zeroes.
+    std::vector<unsigned char> bytes;
+    bytes.reserve(limbs.size() * 4);
+    bool started = false;
+    for (auto it = limbs.rbegin(); it != limbs.rend(); ++it) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            const unsigned char byte = (*it >> shift) & 0xff;
+            if (!started && byte == 0) continue;
+            started = true;
+            bytes.push_back(byte);
+        }
+    }
+    length = bytes.size();
+    if (length + zeroes > max_ret_len) return false;
     // Copy result into output vector.
-    vch.reserve(zeroes + (b256.end() - it));
+    vch.reserve(zeroes + bytes.size());
     vch.assign(zeroes, 0x00);
-    while (it != b256.end())
-        vch.push_back(*(it++));
+    vch.insert(vch.end(), bytes.begin(), bytes.end());
     return true;
 }
 
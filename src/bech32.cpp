@@ -3,7 +3,6 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bech32.h>
-#include <util/vector.h>
 
 #include <assert.h>
 
@@ -30,6 +29,20 @@ const int8_t CHARSET_REV[128] = {
      1,  0,  3, 16, 11, 28, 12, 14,  6,  4,  2, -1, -1, -1, -1, -1
 };
 
+/** Precomputed multiples of k(x) = x^6 mod g(x) (see PolyModStep below): entry i is the XOR of
+ *  {2^n}k(x) for each set bit n in i. Looking up the outgoing coefficient c0 in this table
+ *  replaces five data-dependent branches per input character. */
+const uint32_t GENERATOR_TABLE[32] = {
+    0x00000000, 0x3b6a57b2, 0x26508e6d, 0x1d3ad9df,
+    0x1ea119fa, 0x25cb4e48, 0x38f19797, 0x039bc025,
+    0x3d4233dd, 0x0628646f, 0x1b12bdb0, 0x2078ea02,
+    0x23e32a27, 0x18897d95, 0x05b3a44a, 0x3ed9f3f8,
+    0x2a1462b3, 0x117e3501, 0x0c44ecde, 0x372ebb6c,
+    0x34b57b49, 0x0fdf2cfb, 0x12e5f524, 0x298fa296,
+    0x1756516e, 0x2c3c06dc, 0x3106df03, 0x0a6c88b1,
+    0x09f74894, 0x329d1f26, 0x2fa7c6f9, 0x14cd914b,
+};
+
 /* Determine the final constant to use for the specified encoding. */
 uint32_t EncodingConstant(Encoding encoding) {
     assert(encoding == Encoding::BECH32 || encoding == Encoding::BECH32M);
@@ -39,7 +52,7 @@ uint32_t EncodingConstant(Encoding encoding) {
 /** This function will compute what 6 5-bit values to XOR into the last 6 input values, in order to
  *  make the checksum 0. These 6 values are packed together in a single 30-bit integer. The higher
  *  bits correspond to earlier values. */
-uint32_t PolyMod(const data& v)
+uint32_t PolyMod(const data& v, uint32_t c = 1)
 {
     // The input is interpreted as a list of coefficients of a polynomial over F = GF(32), with an
     // implicit 1 in front. If the input is [v0,v1,v2,v3,v4], that polynomial is v(x) =
@@ -61,39 +74,32 @@ uint32_t PolyMod(const data& v)
     // (a^2 + 1) * (a^4 + a^3 + a) = (a^4 + a^3 + a) * a^2 + (a^4 + a^3 + a) = a^6 + a^5 + a^4 + a
     // = a^3 + 1 (mod a^5 + a^3 + 1) = {9}.
 
-    // During the course of the loop below, `c` contains the bitpacked coefficients of the
+    // During the course of PolyMod below, `c` contains the bitpacked coefficients of the
     // polynomial constructed from just the values of v that were processed so far, mod g(x). In
     // the above example, `c` initially corresponds to 1 mod g(x), and after processing 2 inputs of
     // v, it corresponds to x^2 + v0*x + v1 mod g(x). As 1 mod g(x) = 1, that is the starting value
     // for `c`.
-    uint32_t c = 1;
+
+    // We want to update `c` to correspond to a polynomial with one extra term. If the initial
+    // value of `c` consists of the coefficients of c(x) = f(x) mod g(x), we modify it to
+    // correspond to c'(x) = (f(x) * x + v_i) mod g(x), where v_i is the next input to
+    // process. Simplifying:
+    // c'(x) = (f(x) * x + v_i) mod g(x)
+    //         ((f(x) mod g(x)) * x + v_i) mod g(x)
+    //         (c(x) * x + v_i) mod g(x)
+    // If c(x) = c0*x^5 + c1*x^4 + c2*x^3 + c3*x^2 + c4*x + c5, we want to compute
+    // c'(x) = (c0*x^5 + c1*x^4 + c2*x^3 + c3*x^2 + c4*x + c5) * x + v_i mod g(x)
+    //       = c0*x^6 + c1*x^5 + c2*x^4 + c3*x^3 + c4*x^2 + c5*x + v_i mod g(x)
+    //       = c0*(x^6 mod g(x)) + c1*x^5 + c2*x^4 + c3*x^3 + c4*x^2 + c5*x + v_i
+    // If we call (x^6 mod g(x)) = k(x), this can be written as
+    // c'(x) = (c1*x^5 + c2*x^4 + c3*x^3 + c4*x^2 + c5*x + v_i) + c0*k(x)
+    // The addition of c0*k(x) is a single table lookup on c0 (GENERATOR_TABLE above).
+    //
+    // The `c` parameter allows resuming from the checksum state of previously processed values,
+    // so that callers can feed the expanded HRP and the data part separately, without
+    // concatenating them into a temporary vector.
     for (const auto v_i : v) {
-        // We want to update `c` to correspond to a polynomial with one extra term. If the initial
-        // value of `c` consists of the coefficients of c(x) = f(x) mod g(x), we modify it to
-        // correspond to c'(x) = (f(x) * x + v_i) mod g(x), where v_i is the next input to
-        // process. Simplifying:
-        // c'(x) = (f(x) * x + v_i) mod g(x)
-        //         ((f(x) mod g(x)) * x + v_i) mod g(x)
-        //         (c(x) * x + v_i) mod g(x)
-        // If c(x) = c0*x^5 + c1*x^4 + c2*x^3 + c3*x^2 + c4*x + c5, we want to compute
-        // c'(x) = (c0*x^5 + c1*x^4 + c2*x^3 + c3*x^2 + c4*x + c5) * x + v_i mod g(x)
-        //       = c0*x^6 + c1*x^5 + c2*x^4 + c3*x^3 + c4*x^2 + c5*x + v_i mod g(x)
-        //       = c0*(x^6 mod g(x)) + c1*x^5 + c2*x^4 + c3*x^3 + c4*x^2 + c5*x + v_i
-        // If we call (x^6 mod g(x)) = k(x), this can be written as
-        // c'(x) = (c1*x^5 + c2*x^4 + c3*x^3 + c4*x^2 + c5*x + v_i) + c0*k(x)
-
-        // First, determine the value of c0:
-        uint8_t c0 = c >> 25;
-
-        // Then compute c1*x^5 + c2*x^4 + c3*x^3 + c4*x^2 + c5*x + v_i:
-        c = ((c & 0x1ffffff) << 5) ^ v_i;
-
-        // Finally, for each set bit n in c0, conditionally add {2^n}k(x):
-        if (c0 & 1)  c ^= 0x3b6a57b2; //     k(x) = {29}x^5 + {22}x^4 + {20}x^3 + {21}x^2 + {29}x + {18}
-        if (c0 & 2)  c ^= 0x26508e6d; //  {2}k(x) = {19}x^5 +  {5}x^4 +     x^3 +  {3}x^2 + {19}x + {13}
-        if (c0 & 4)  c ^= 0x1ea119fa; //  {4}k(x) = {15}x^5 + {10}x^4 +  {2}x^3 +  {6}x^2 + {15}x + {26}
-        if (c0 & 8)  c ^= 0x3d4233dd; //  {8}k(x) = {30}x^5 + {20}x^4 +  {4}x^3 + {12}x^2 + {30}x + {29}
-        if (c0 & 16) c ^= 0x2a1462b3; // {16}k(x) = {21}x^5 +     x^4 +  {8}x^3 + {24}x^2 + {21}x + {19}
+        c = ((c & 0x1ffffff) << 5) ^ v_i ^ GENERATOR_TABLE[c >> 25];
     }
     return c;
 }
@@ -104,19 +110,15 @@ inline unsigned char LowerCase(unsigned char c)
     return (c >= 'A' && c <= 'Z') ? (c - 'A') + 'a' : c;
 }
 
-/** Expand a HRP for use in checksum computation. */
-data ExpandHRP(const std::string& hrp)
+/** Feed the expanded HRP (the high bits of each character, a zero, then the low bits) into the
+ *  checksum state directly, without materializing the expansion. */
+uint32_t PolyModHRP(const std::string& hrp)
 {
-    data ret;
-    ret.reserve(hrp.size() + 90);
-    ret.resize(hrp.size() * 2 + 1);
-    for (size_t i = 0; i < hrp.size(); ++i) {
-        unsigned char c = hrp[i];
-        ret[i] = c >> 5;
-        ret[i + hrp.size() + 1] = c & 0x1f;
-    }
-    ret[hrp.size()] = 0;
-    return ret;
+    uint32_t c = 1;
+    for (const char ch : hrp) c = ((c & 0x1ffffff) << 5) ^ (((unsigned char)ch) >> 5) ^ GENERATOR_TABLE[c >> 25];
+    c = ((c & 0x1ffffff) << 5) ^ GENERATOR_TABLE[c >> 25];
+    for (const char ch : hrp) c = ((c & 0x1ffffff) << 5) ^ (ch & 0x1f) ^ GENERATOR_TABLE[c >> 25];
+    return c;
 }
 
 /** Verify a checksum. */
@@ -126,7 +128,7 @@ Encoding VerifyChecksum(const std::string& hrp, const data& values)
     // if we required that the checksum was 0, it would be the case that appending a 0 to a valid
     // list of values would result in a new valid list. For that reason, Bech32 requires the
     // resulting checksum to be 1 instead. In Bech32m, this constant was amended.
-    const uint32_t check = PolyMod(Cat(ExpandHRP(hrp), values));
+    const uint32_t check = PolyMod(values, PolyModHRP(hrp));
     if (check == EncodingConstant(Encoding::BECH32)) return Encoding::BECH32;
     if (check == EncodingConstant(Encoding::BECH32M)) return Encoding::BECH32M;
     return Encoding::INVALID;
@@ -135,9 +137,10 @@ Encoding VerifyChecksum(const std::string& hrp, const data& values)
 /** Create a checksum. */
 data CreateChecksum(Encoding encoding, const std::string& hrp, const data& values)
 {
-    data enc = Cat(ExpandHRP(hrp), values);
-    enc.resize(enc.size() + 6); // Append 6 zeroes
-    uint32_t mod = PolyMod(enc) ^ EncodingConstant(encoding); // Determine what to XOR into those 6 zeroes.
+    uint32_t c = PolyMod(values, PolyModHRP(hrp));
+    // Append 6 zeroes.
+    for (int i = 0; i < 6; ++i) c = ((c & 0x1ffffff) << 5) ^ GENERATOR_TABLE[c >> 25];
+    uint32_t mod = c ^ EncodingConstant(encoding); // Determine what to XOR into those 6 zeroes.
     data ret(6);
     for (size_t i = 0; i < 6; ++i) {
         // Convert the 5-bit groups in mod to checksum values.
@@ -155,10 +158,12 @@ std::string Encode(Encoding encoding, const std::string& hrp, const data& values
     // result will always be invalid.
     for (const char& c : hrp) assert(c < 'A' || c > 'Z');
     data checksum = CreateChecksum(encoding, hrp, values);
-    data combined = Cat(values, checksum);
     std::string ret = hrp + '1';
-    ret.reserve(ret.size() + combined.size());
-    for (const auto c : combined) {
+    ret.reserve(ret.size() + values.size() + checksum.size());
+    for (const auto c : values) {
+        ret += CHARSET[c];
+    }
+    for (const auto c : checksum) {
         ret += CHARSET[c];
     }
     return ret;
@@ -50,6 +50,19 @@ static void Base58Decode(benchmark::Bench& bench)
 }
 
 
+static void Base58DecodeLong(benchmark::Bench& bench)
+{
+    // Extended-key-sized input (111 characters), where the cost of the
+    // per-digit bignum passes dominates.
+    const std::string data(111, 'z');
+    std::vector<unsigned char> vch;
+    bench.batch(data.size()).unit("byte").run([&] {
+        (void) DecodeBase58(data.c_str(), vch, 128);
+    });
+}
+
+
 BENCHMARK(Base58Encode);
 BENCHMARK(Base58CheckEncode);
 BENCHMARK(Base58Decode);
+BENCHMARK(Base58DecodeLong);
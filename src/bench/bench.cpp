@@ -6,9 +6,14 @@
 
 #include <chainparams.h>
 #include <test/util/setup_common.h>
+#include <tinyformat.h>
+#include <univalue.h>
 #include <validation.h>
 
+#include <fstream>
+#include <map>
 #include <regex>
+#include <sstream>
 
 const std::function<void(const std::string&)> G_TEST_LOG_FUN{};
 
@@ -30,6 +35,101 @@ void GenerateTemplateResults(const std::vector<ankerl::nanobench::Result>& bench
     std::cout << "Created '" << filename << "'" << std::endl;
 }
 
+//! Per-benchmark numbers recorded in a baseline file.
+struct BaselineEntry {
+    double median_ns;
+    double mad_pct; //!< median absolute percent error of the elapsed time
+    double ipc;     //!< instructions per cycle, 0 when perf counters are unavailable
+};
+
+BaselineEntry MakeBaselineEntry(const ankerl::nanobench::Result& r)
+{
+    using Measure = ankerl::nanobench::Result::Measure;
+    BaselineEntry e;
+    e.median_ns = r.median(Measure::elapsed) * 1e9;
+    e.mad_pct = r.medianAbsolutePercentError(Measure::elapsed) * 100.0;
+    e.ipc = 0.0;
+    if (r.has(Measure::instructions) && r.has(Measure::cpucycles) && r.median(Measure::cpucycles) > 0.0) {
+        e.ipc = r.median(Measure::instructions) / r.median(Measure::cpucycles);
+    }
+    return e;
+}
+
+bool LoadBaseline(const std::string& filename, std::map<std::string, BaselineEntry>& entries)
+{
+    std::ifstream fin(filename);
+    if (!fin.is_open()) return false;
+    std::stringstream contents;
+    contents << fin.rdbuf();
+    UniValue json;
+    if (!json.read(contents.str()) || !json.isObject()) {
+        std::cout << "Could not parse baseline file '" << filename << "'" << std::endl;
+        return false;
+    }
+    const UniValue& benchmarks = json["benchmarks"];
+    if (!benchmarks.isObject()) return false;
+    for (const std::string& name : benchmarks.getKeys()) {
+        const UniValue& v = benchmarks[name];
+        if (!v.isObject()) continue;
+        BaselineEntry e;
+        e.median_ns = v["median_ns"].get_real();
+        e.mad_pct = v["mad_pct"].get_real();
+        e.ipc = v["ipc"].get_real();
+        entries.emplace(name, e);
+    }
+    return true;
+}
+
+void SaveBaseline(const std::string& filename, const std::vector<ankerl::nanobench::Result>& results)
+{
+    UniValue benchmarks(UniValue::VOBJ);
+    for (const auto& r : results) {
+        const BaselineEntry e{MakeBaselineEntry(r)};
+        UniValue v(UniValue::VOBJ);
+        v.pushKV("median_ns", e.median_ns);
+        v.pushKV("mad_pct", e.mad_pct);
+        v.pushKV("ipc", e.ipc);
+        benchmarks.pushKV(r.config().mBenchmarkName, v);
+    }
+    UniValue json(UniValue::VOBJ);
+    json.pushKV("benchmarks", benchmarks);
+    std::ofstream fout(filename);
+    if (!fout.is_open()) {
+        std::cout << "Could not write baseline file '" << filename << "'" << std::endl;
+        return;
+    }
+    fout << json.write(/* prettyIndent */ 2) << std::endl;
+    std::cout << "Recorded baseline for " << results.size() << " benchmark(s) in '" << filename << "'" << std::endl;
+}
+
+//! Compare results against a recorded baseline. Returns false if any
+//! benchmark's median elapsed time regressed by more than threshold_pct.
+bool CompareToBaseline(const std::map<std::string, BaselineEntry>& baseline, const std::vector<ankerl::nanobench::Result>& results, double threshold_pct)
+{
+    bool ok{true};
+    std::cout << strprintf("\n%-40s %15s %15s %8s %8s\n", "benchmark", "baseline ns/op", "current ns/op", "delta%", "ipc");
+    for (const auto& r : results) {
+        const std::string& name{r.config().mBenchmarkName};
+        const BaselineEntry current{MakeBaselineEntry(r)};
+        const auto it{baseline.find(name)};
+        if (it == baseline.end()) {
+            std::cout << strprintf("%-40s %15s %15.1f %8s %8.2f (not in baseline)\n", name, "-", current.median_ns, "-", current.ipc);
+            continue;
+        }
+        const BaselineEntry& old{it->second};
+        const double delta_pct{old.median_ns > 0.0 ? (current.median_ns - old.median_ns) / old.median_ns * 100.0 : 0.0};
+        std::string note;
+        if (delta_pct > threshold_pct) {
+            // Flag noisy measurements so a flaky machine is distinguishable
+            // from a real regression in the pipeline output.
+            note = current.mad_pct > threshold_pct || old.mad_pct > threshold_pct ? " REGRESSION (noisy)" : " REGRESSION";
+            ok = false;
+        }
+        std::cout << strprintf("%-40s %15.1f %15.1f %+7.1f%% %8.2f%s\n", name, old.median_ns, current.median_ns, delta_pct, current.ipc, note);
+    }
+    return ok;
+}
+
 } // namespace
 
 benchmark::BenchRunner::BenchmarkMap& benchmark::BenchRunner::benchmarks()
@@ -43,7 +143,7 @@ benchmark::BenchRunner::BenchRunner(std::string name, benchmark::BenchFunction f
     benchmarks().insert(std::make_pair(name, func));
 }
 
-void benchmark::BenchRunner::RunAll(const Args& args)
+bool benchmark::BenchRunner::RunAll(const Args& args)
 {
     std::regex reFilter(args.regex_filter);
     std::smatch baseMatch;
@@ -71,8 +171,10 @@ void benchmark::BenchRunner::RunAll(const Args& args)
             std::cout << bench.complexityBigO() << std::endl;
         }
 
-        if (!bench.results().empty()) {
-            benchmarkResults.push_back(bench.results().back());
+        // A benchmark may produce several named results (e.g. one per script
+        // class); keep them all for the CSV/JSON/baseline outputs.
+        for (const auto& result : bench.results()) {
+            benchmarkResults.push_back(result);
         }
     }
 
@@ -80,4 +182,14 @@ void benchmark::BenchRunner::RunAll(const Args& args)
                                                                "{{#result}}{{name}}, {{epochs}}, {{average(iterations)}}, {{sumProduct(iterations, elapsed)}}, {{minimum(elapsed)}}, {{maximum(elapsed)}}, {{median(elapsed)}}\n"
                                                                "{{/result}}");
     GenerateTemplateResults(benchmarkResults, args.output_json, ankerl::nanobench::templates::json());
+
+    if (!args.baseline.empty() && !args.is_list_only) {
+        std::map<std::string, BaselineEntry> baseline;
+        if (LoadBaseline(args.baseline, baseline)) {
+            return CompareToBaseline(baseline, benchmarkResults, args.baseline_threshold);
+        }
+        // No usable baseline yet: record one for the next run to compare against.
+        SaveBaseline(args.baseline, benchmarkResults);
+    }
+    return true;
 }
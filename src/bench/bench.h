@@ -43,6 +43,8 @@ struct Args {
     std::vector<double> asymptote;
     std::string output_csv;
     std::string output_json;
+    std::string baseline;
+    double baseline_threshold;
 };
 
 class BenchRunner
@@ -53,7 +55,9 @@ class BenchRunner
 public:
     BenchRunner(std::string name, BenchFunction func);
 
-    static void RunAll(const Args& args);
+    //! Returns false if a baseline comparison was requested and at least one
+    //! benchmark regressed past the threshold.
+    static bool RunAll(const Args& args);
 };
 }
 // BENCHMARK(foo) expands to:  benchmark::BenchRunner bench_11foo("foo", foo);
@@ -11,6 +11,7 @@
 #include <memory>
 
 static const char* DEFAULT_BENCH_FILTER = ".*";
+static constexpr double DEFAULT_BASELINE_THRESHOLD{5.0};
 
 static void SetupBenchArgs(ArgsManager& argsman)
 {
@@ -21,6 +22,8 @@ static void SetupBenchArgs(ArgsManager& argsman)
     argsman.AddArg("-asymptote=n1,n2,n3,...", strprintf("Test asymptotic growth of the runtime of an algorithm, if supported by the benchmark"), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-output_csv=<output.csv>", "Generate CSV file with the most important benchmark results.", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-output_json=<output.json>", "Generate JSON file with all benchmark results.", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-baseline=<file.json>", "Record benchmark results in <file.json> if it does not exist, otherwise compare against it and exit with a nonzero status when a benchmark regresses past the threshold.", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-baseline_threshold=<percent>", strprintf("Median runtime increase treated as a regression when comparing against -baseline (default: %g%%)", DEFAULT_BASELINE_THRESHOLD), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 }
 
 // parses a comma separated list like "10,20,30,50"
@@ -59,8 +62,16 @@ int main(int argc, char** argv)
     args.asymptote = parseAsymptote(argsman.GetArg("-asymptote", ""));
     args.output_csv = argsman.GetArg("-output_csv", "");
     args.output_json = argsman.GetArg("-output_json", "");
+    args.baseline = argsman.GetArg("-baseline", "");
+    args.baseline_threshold = DEFAULT_BASELINE_THRESHOLD;
+    if (argsman.IsArgSet("-baseline_threshold") && !ParseDouble(argsman.GetArg("-baseline_threshold", ""), &args.baseline_threshold)) {
+        tfm::format(std::cerr, "Error parsing -baseline_threshold\n");
+        return EXIT_FAILURE;
+    }
 
-    benchmark::BenchRunner::RunAll(args);
+    if (!benchmark::BenchRunner::RunAll(args)) {
+        return EXIT_FAILURE;
+    }
 
     return EXIT_SUCCESS;
 }
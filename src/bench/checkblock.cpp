@@ -28,6 +28,22 @@ static void DeserializeBlockTest(benchmark::Bench& bench)
     });
 }
 
+static void SerializeBlockTest(benchmark::Bench& bench)
+{
+    CDataStream stream(benchmark::data::block413567, SER_NETWORK, PROTOCOL_VERSION);
+    CBlock block;
+    stream >> block;
+
+    CDataStream out(SER_NETWORK, PROTOCOL_VERSION);
+    out.reserve(benchmark::data::block413567.size());
+
+    bench.unit("block").run([&] {
+        out << block;
+        assert(out.size() == benchmark::data::block413567.size());
+        out.clear();
+    });
+}
+
 static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
 {
     CDataStream stream(benchmark::data::block413567, SER_NETWORK, PROTOCOL_VERSION);
@@ -50,4 +66,5 @@ static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
 }
 
 BENCHMARK(DeserializeBlockTest);
+BENCHMARK(SerializeBlockTest);
 BENCHMARK(DeserializeAndCheckBlockTest);
@@ -19,8 +19,10 @@ static const unsigned int QUEUE_BATCH_SIZE = 128;
 
 // This Benchmark tests the CheckQueue with a slightly realistic workload,
 // where checks all contain a prevector that is indirect 50% of the time
-// and there is a little bit of work done between calls to Add.
-static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
+// and there is a little bit of work done between calls to Add. Running it
+// for both scheduling modes shows how the work-stealing shards scale with
+// the core count compared to the single shared queue.
+static void CCheckQueueSpeedPrevectorJobImpl(benchmark::Bench& bench, bool work_stealing)
 {
     // We shouldn't ever be running with the checkqueue on a single core machine.
     if (GetNumCores() <= 1) return;
@@ -41,7 +43,7 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
         }
         void swap(PrevectorJob& x){p.swap(x.p);};
     };
-    CCheckQueue<PrevectorJob> queue {QUEUE_BATCH_SIZE};
+    CCheckQueue<PrevectorJob> queue {QUEUE_BATCH_SIZE, work_stealing};
     // The main thread should be counted to prevent thread oversubscription, and
     // to decrease the variance of benchmark results.
     queue.StartWorkerThreads(GetNumCores() - 1);
@@ -68,4 +70,15 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
     queue.StopWorkerThreads();
     ECC_Stop();
 }
+
+static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
+{
+    CCheckQueueSpeedPrevectorJobImpl(bench, /* work_stealing */ false);
+}
+
+static void CCheckQueueSpeedPrevectorJobWorkStealing(benchmark::Bench& bench)
+{
+    CCheckQueueSpeedPrevectorJobImpl(bench, /* work_stealing */ true);
+}
 BENCHMARK(CCheckQueueSpeedPrevectorJob);
+BENCHMARK(CCheckQueueSpeedPrevectorJobWorkStealing);
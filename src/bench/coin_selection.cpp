@@ -114,5 +114,53 @@ static void BnBExhaustion(benchmark::Bench& bench)
     });
 }
 
+// Knapsack selection over pools of different sizes, and the branch-and-bound
+// attempt at different effective feerates. BnB may legitimately find no
+// changeless solution once fees shift the effective values, so only the
+// knapsack variants assert success.
+static void CoinSelectionAtSize(benchmark::Bench& bench, int n_coins, CFeeRate effective_feerate, bool use_bnb, bool expect_success)
+{
+    NodeContext node;
+    auto chain = interfaces::MakeChain(node);
+    CWallet wallet(chain.get(), "", CreateDummyWalletDatabase());
+    wallet.SetupLegacyScriptPubKeyMan();
+    std::vector<std::unique_ptr<CWalletTx>> wtxs;
+    LOCK(wallet.cs_wallet);
+
+    for (int i = 0; i < n_coins; ++i) {
+        addCoin(1000 * COIN, wallet, wtxs);
+    }
+    addCoin(3 * COIN, wallet, wtxs);
+
+    std::vector<COutput> coins;
+    for (const auto& wtx : wtxs) {
+        coins.emplace_back(wtx.get(), 0 /* iIn */, 6 * 24 /* nDepthIn */, true /* spendable */, true /* solvable */, true /* safe */);
+    }
+
+    const CoinEligibilityFilter filter_standard(1, 6, 0);
+    const CoinSelectionParams coin_selection_params(use_bnb, /* change_output_size= */ 34,
+                                                    /* change_spend_size= */ 148, effective_feerate,
+                                                    /* long_term_feerate= */ CFeeRate(0), /* discard_feerate= */ CFeeRate(0),
+                                                    /* tx_no_inputs_size= */ 0, /* avoid_partial= */ false);
+    bench.run([&] {
+        std::set<CInputCoin> setCoinsRet;
+        CAmount nValueRet;
+        bool bnb_used;
+        bool success = wallet.SelectCoinsMinConf(1003 * COIN, filter_standard, coins, setCoinsRet, nValueRet, coin_selection_params, bnb_used);
+        if (expect_success) assert(success);
+    });
+}
+
+static void CoinSelectionKnapsack100(benchmark::Bench& bench) { CoinSelectionAtSize(bench, 100, CFeeRate(0), /* use_bnb */ false, /* expect_success */ true); }
+static void CoinSelectionKnapsack1000(benchmark::Bench& bench) { CoinSelectionAtSize(bench, 1000, CFeeRate(0), /* use_bnb */ false, /* expect_success */ true); }
+static void CoinSelectionKnapsack5000(benchmark::Bench& bench) { CoinSelectionAtSize(bench, 5000, CFeeRate(0), /* use_bnb */ false, /* expect_success */ true); }
+static void CoinSelectionBnBLowFee(benchmark::Bench& bench) { CoinSelectionAtSize(bench, 1000, CFeeRate(1000), /* use_bnb */ true, /* expect_success */ false); }
+static void CoinSelectionBnBHighFee(benchmark::Bench& bench) { CoinSelectionAtSize(bench, 1000, CFeeRate(50000), /* use_bnb */ true, /* expect_success */ false); }
+
 BENCHMARK(CoinSelection);
+BENCHMARK(CoinSelectionKnapsack100);
+BENCHMARK(CoinSelectionKnapsack1000);
+BENCHMARK(CoinSelectionKnapsack5000);
+BENCHMARK(CoinSelectionBnBLowFee);
+BENCHMARK(CoinSelectionBnBHighFee);
 BENCHMARK(BnBExhaustion);
@@ -90,6 +90,15 @@ static void SipHash_32b(benchmark::Bench& bench)
     });
 }
 
+static void SipHash13_32b(benchmark::Bench& bench)
+{
+    uint256 x;
+    uint64_t k1 = 0;
+    bench.run([&] {
+        *((uint64_t*)x.begin()) = SipHash13Uint256(0, ++k1, x);
+    });
+}
+
 static void FastRandom_32bit(benchmark::Bench& bench)
 {
     FastRandomContext rng(true);
@@ -143,6 +152,23 @@ static void MuHashDiv(benchmark::Bench& bench)
     });
 }
 
+static void MuHashAggregate(benchmark::Bench& bench)
+{
+    // Simulates a gettxoutsetinfo-style audit: hash a coin-sized element into
+    // the set and remove a previously added one, per iteration.
+    MuHash3072 acc;
+    FastRandomContext rng(true);
+    std::vector<unsigned char> added{rng.randbytes(76)};
+    std::vector<unsigned char> removed{rng.randbytes(76)};
+    acc.Insert(removed);
+
+    bench.run([&] {
+        acc.Insert(added);
+        acc.Remove(removed);
+        acc.Insert(removed);
+    });
+}
+
 static void MuHashPrecompute(benchmark::Bench& bench)
 {
     MuHash3072 acc;
@@ -162,6 +188,7 @@ BENCHMARK(SHA3_256_1M);
 
 BENCHMARK(SHA256_32b);
 BENCHMARK(SipHash_32b);
+BENCHMARK(SipHash13_32b);
 BENCHMARK(SHA256D64_1024);
 BENCHMARK(FastRandom_32bit);
 BENCHMARK(FastRandom_1bit);
@@ -169,4 +196,5 @@ BENCHMARK(FastRandom_1bit);
 BENCHMARK(MuHash);
 BENCHMARK(MuHashMul);
 BENCHMARK(MuHashDiv);
+BENCHMARK(MuHashAggregate);
 BENCHMARK(MuHashPrecompute);
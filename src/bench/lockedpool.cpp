@@ -6,6 +6,10 @@
 
 #include <support/lockedpool.h>
 
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <thread>
 #include <vector>
 
 #define ASIZE 2048
@@ -40,3 +44,55 @@ static void BenchLockedPool(benchmark::Bench& bench)
 }
 
 BENCHMARK(BenchLockedPool);
+
+/** Plain heap pages so the benchmark is not at the mercy of RLIMIT_MEMLOCK. */
+class BenchLockedPageAllocator : public LockedPageAllocator
+{
+public:
+    void* AllocateLocked(size_t len, bool* lockingSuccess) override
+    {
+        *lockingSuccess = true;
+        return std::malloc(len);
+    }
+    void FreeLocked(void* addr, size_t len) override { std::free(addr); }
+    size_t GetLimit() override { return std::numeric_limits<size_t>::max(); }
+};
+
+/** Concurrent small alloc/free traffic against one pool, as produced by
+ * loading many wallets at once: every key deserialized takes and later
+ * returns a chunk of secure memory, from several loading threads. */
+static void BenchLockedPoolMultiThread(benchmark::Bench& bench)
+{
+    LockedPool pool(std::make_unique<BenchLockedPageAllocator>());
+    constexpr int THREADS{4};
+    bench.minEpochIterations(5).run([&] {
+        std::vector<std::thread> threads;
+        threads.reserve(THREADS);
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&pool, t] {
+                std::vector<void*> addr(256, nullptr);
+                uint32_t s = 0x12345678 + t;
+                for (int i = 0; i < ASIZE; ++i) {
+                    int idx = s & (addr.size() - 1);
+                    if (s & 0x80000000) {
+                        pool.free(addr[idx]);
+                        addr[idx] = nullptr;
+                    } else if (!addr[idx]) {
+                        // key-sized chunks, 1..256 bytes
+                        addr[idx] = pool.alloc(((s >> 16) & 0xff) + 1);
+                    }
+                    bool lsb = s & 1;
+                    s >>= 1;
+                    if (lsb)
+                        s ^= 0xf00f00f0; // LFSR period 0xf7ffffe0
+                }
+                for (void* ptr : addr)
+                    pool.free(ptr);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+    });
+}
+
+BENCHMARK(BenchLockedPoolMultiThread);
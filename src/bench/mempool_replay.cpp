@@ -0,0 +1,214 @@
+// Copyright (c) 2021 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <clientversion.h>
+#include <random.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <tinyformat.h>
+#include <txmempool.h>
+#include <util/system.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+/**
+ * Replay a recorded stream of transaction arrivals and block connects through
+ * CTxMemPool and report p50/p99 addUnchecked()/removeForBlock() latencies and
+ * the peak mempool memory usage, so mempool data-structure changes can be
+ * evaluated against realistic transaction topology.
+ *
+ * The capture file is taken from the MEMPOOL_REPLAY_CAPTURE environment
+ * variable. Its format, serialized with CAutoFile(SER_DISK, CLIENT_VERSION):
+ *
+ *   uint64_t version (currently 1)
+ *   uint64_t record count
+ *   per record:
+ *     uint8_t type: 0 = transaction arrival, 1 = block connect
+ *     type 0: CTransactionRef tx, int64_t fee
+ *     type 1: std::vector<uint256> txids confirmed by the block, in block order
+ *
+ * Without a capture file a deterministic synthetic stream with multi-parent
+ * packages and periodic block connects is replayed instead, so the benchmark
+ * still produces comparable numbers everywhere.
+ */
+
+static constexpr uint64_t MEMPOOL_REPLAY_CAPTURE_VERSION{1};
+
+namespace {
+struct ReplayEvent {
+    CTransactionRef tx;               //!< set for transaction arrivals
+    CAmount fee{0};                   //!< fee of the arriving transaction
+    std::vector<uint256> block_txids; //!< set for block connects
+};
+} // namespace
+
+static std::optional<std::vector<ReplayEvent>> LoadCapture(const fs::path& path)
+{
+    CAutoFile in(fsbridge::fopen(path, "rb"), SER_DISK, CLIENT_VERSION);
+    if (in.IsNull()) return std::nullopt;
+    std::vector<ReplayEvent> events;
+    try {
+        uint64_t version;
+        in >> version;
+        if (version != MEMPOOL_REPLAY_CAPTURE_VERSION) return std::nullopt;
+        uint64_t num;
+        in >> num;
+        while (num--) {
+            uint8_t type;
+            in >> type;
+            ReplayEvent event;
+            if (type == 0) {
+                in >> event.tx;
+                in >> event.fee;
+            } else if (type == 1) {
+                in >> event.block_txids;
+            } else {
+                return std::nullopt;
+            }
+            events.push_back(std::move(event));
+        }
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+    return events;
+}
+
+//! Deterministic stand-in for a capture: chains of multi-parent packages with
+//! a block connect confirming the oldest half of the backlog every 500
+//! arrivals. Generation order is topological, so every confirmed set contains
+//! parents before children, as a real block would.
+static std::vector<ReplayEvent> SyntheticCapture()
+{
+    FastRandomContext det_rand{true};
+    std::vector<ReplayEvent> events;
+    std::vector<CTransactionRef> unconfirmed;
+    size_t tx_counter{1};
+
+    auto add_tx = [&](const CMutableTransaction& tx, CAmount fee) {
+        ReplayEvent event;
+        event.tx = MakeTransactionRef(tx);
+        event.fee = fee;
+        unconfirmed.push_back(event.tx);
+        events.push_back(std::move(event));
+    };
+
+    // Base transactions with spendable outputs.
+    for (int i = 0; i < 100; ++i) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].scriptSig = CScript() << CScriptNum(static_cast<int64_t>(tx_counter++));
+        tx.vout.resize(det_rand.randrange(4) + 2);
+        for (auto& out : tx.vout) {
+            out.scriptPubKey = CScript() << CScriptNum(static_cast<int64_t>(tx_counter)) << OP_EQUAL;
+            out.nValue = 10 * COIN;
+        }
+        add_tx(tx, 1000);
+    }
+
+    for (int i = 0; i < 5000; ++i) {
+        CMutableTransaction tx;
+        const size_t n_parents{det_rand.randrange(3) + 1};
+        for (size_t p = 0; p < n_parents; ++p) {
+            const CTransactionRef& parent = unconfirmed[unconfirmed.size() - 1 - det_rand.randrange(std::min<size_t>(unconfirmed.size(), 500))];
+            tx.vin.emplace_back();
+            tx.vin.back().prevout = COutPoint(parent->GetHash(), static_cast<uint32_t>(det_rand.randrange(parent->vout.size())));
+            tx.vin.back().scriptSig = CScript() << CScriptNum(static_cast<int64_t>(tx_counter));
+        }
+        tx.vout.resize(det_rand.randrange(3) + 1);
+        for (auto& out : tx.vout) {
+            out.scriptPubKey = CScript() << CScriptNum(static_cast<int64_t>(tx_counter)) << OP_EQUAL;
+            out.nValue = COIN;
+        }
+        ++tx_counter;
+        add_tx(tx, static_cast<CAmount>(det_rand.randrange(10000) + 100));
+
+        if ((i + 1) % 500 == 0) {
+            ReplayEvent block;
+            const size_t n_confirmed{unconfirmed.size() / 2};
+            block.block_txids.reserve(n_confirmed);
+            for (size_t c = 0; c < n_confirmed; ++c) {
+                block.block_txids.push_back(unconfirmed[c]->GetHash());
+            }
+            unconfirmed.erase(unconfirmed.begin(), unconfirmed.begin() + n_confirmed);
+            events.push_back(std::move(block));
+        }
+    }
+    return events;
+}
+
+static std::chrono::nanoseconds Percentile(std::vector<std::chrono::nanoseconds>& samples, double pct)
+{
+    if (samples.empty()) return std::chrono::nanoseconds{0};
+    const size_t idx{std::min(samples.size() - 1, static_cast<size_t>(pct * (samples.size() - 1)))};
+    std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+    return samples[idx];
+}
+
+static void MempoolReplay(benchmark::Bench& bench)
+{
+    std::vector<ReplayEvent> events;
+    bool from_capture{false};
+    if (const char* capture_path = std::getenv("MEMPOOL_REPLAY_CAPTURE")) {
+        if (auto loaded = LoadCapture(fs::path{capture_path})) {
+            events = std::move(*loaded);
+            from_capture = true;
+        } else {
+            std::cout << strprintf("MempoolReplay: could not load capture %s, falling back to the synthetic stream\n", capture_path);
+        }
+    }
+    if (events.empty()) events = SyntheticCapture();
+
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>(CBaseChainParams::MAIN);
+    CTxMemPool pool;
+    LOCK2(cs_main, pool.cs);
+
+    std::vector<std::chrono::nanoseconds> add_latencies;
+    std::vector<std::chrono::nanoseconds> remove_latencies;
+    size_t peak_usage{0};
+    size_t num_arrivals{0};
+    size_t num_blocks{0};
+    LockPoints lp;
+
+    bench.run([&]() NO_THREAD_SAFETY_ANALYSIS {
+        pool.clear();
+        num_arrivals = num_blocks = 0;
+        unsigned int height{1};
+        for (const ReplayEvent& event : events) {
+            if (event.tx) {
+                ++num_arrivals;
+                CTxMemPoolEntry entry(event.tx, event.fee, /* time */ 0, /* entry_height */ 1, /* spends_coinbase */ false, /* sigops_cost */ 4, lp);
+                const auto start{std::chrono::steady_clock::now()};
+                pool.addUnchecked(entry);
+                add_latencies.push_back(std::chrono::steady_clock::now() - start);
+            } else {
+                ++num_blocks;
+                std::vector<CTransactionRef> vtx;
+                vtx.reserve(event.block_txids.size());
+                for (const uint256& txid : event.block_txids) {
+                    if (CTransactionRef tx = pool.get(txid)) vtx.push_back(std::move(tx));
+                }
+                const auto start{std::chrono::steady_clock::now()};
+                pool.removeForBlock(vtx, ++height);
+                remove_latencies.push_back(std::chrono::steady_clock::now() - start);
+            }
+            peak_usage = std::max(peak_usage, pool.DynamicMemoryUsage());
+        }
+    });
+
+    std::cout << strprintf("MempoolReplay (%s): %u tx arrivals, %u block connects per pass\n",
+                           from_capture ? "capture" : "synthetic", num_arrivals, num_blocks)
+              << strprintf("  addUnchecked    p50 %8d ns, p99 %8d ns\n",
+                           Percentile(add_latencies, 0.50).count(), Percentile(add_latencies, 0.99).count())
+              << strprintf("  removeForBlock  p50 %8d ns, p99 %8d ns\n",
+                           Percentile(remove_latencies, 0.50).count(), Percentile(remove_latencies, 0.99).count())
+              << strprintf("  peak DynamicMemoryUsage %u bytes\n", peak_usage);
+}
+
+BENCHMARK(MempoolReplay);
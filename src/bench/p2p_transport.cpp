@@ -0,0 +1,177 @@
+// Copyright (c) 2021 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/data.h>
+
+#include <chainparams.h>
+#include <net.h>
+#include <netmessagemaker.h>
+#include <protocol.h>
+#include <span.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#ifndef WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// These benchmarks cover the relay node hot path between the wire and the
+// message handler: serializing messages for transport and reassembling them
+// out of arbitrarily sized socket reads. Standing up two full CConnman
+// instances is not possible in a bench (CConnman spawns its own threads and
+// needs the whole node context), so the socketpair variant drives the same
+// per-socket receive logic ThreadSocketHandler uses, and handler-side cost is
+// measured separately by the getmsgstats RPC on a live node.
+
+/** Serialize one message (header plus payload) the way SocketSendData puts it
+ * on the wire. */
+static std::vector<uint8_t> SerializeMessage(CSerializedNetMsg&& msg)
+{
+    V1TransportSerializer serializer;
+    std::vector<unsigned char> header;
+    serializer.prepareForTransport(msg, header);
+    std::vector<uint8_t> bytes{header.begin(), header.end()};
+    bytes.insert(bytes.end(), msg.data.begin(), msg.data.end());
+    return bytes;
+}
+
+static std::vector<uint8_t> BuildTxMessage(int lock_height)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(2);
+    tx.vin[0].scriptSig = CScript() << OP_1;
+    tx.vin[0].scriptWitness.stack.push_back({1});
+    tx.vin[1].scriptSig = CScript() << OP_1;
+    tx.vin[1].scriptWitness.stack.push_back({1});
+    tx.vout.resize(2);
+    tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+    tx.vout[0].nValue = 100 * COIN;
+    tx.vout[1].scriptPubKey = CScript() << OP_2 << OP_EQUAL;
+    tx.vout[1].nValue = 200 * COIN;
+    tx.nLockTime = lock_height; // make each tx distinct
+    return SerializeMessage(CNetMsgMaker{PROTOCOL_VERSION}.Make(NetMsgType::TX, *MakeTransactionRef(tx)));
+}
+
+/** Run a byte stream of serialized messages through the deserializer in
+ * socket-buffer sized chunks, consuming each completed message. Returns the
+ * number of messages reassembled. */
+static size_t DeserializeStream(V1TransportDeserializer& deserializer, const std::vector<uint8_t>& stream)
+{
+    size_t num_msgs{0};
+    Span<const uint8_t> remaining{stream.data(), stream.size()};
+    while (remaining.size() > 0) {
+        Span<const uint8_t> chunk{remaining.data(), std::min<size_t>(remaining.size(), 0x10000)};
+        remaining = remaining.subspan(chunk.size());
+        while (chunk.size() > 0) {
+            const int handled = deserializer.Read(chunk);
+            assert(handled >= 0);
+            if (deserializer.Complete()) {
+                uint32_t out_err_raw_size{0};
+                assert(deserializer.GetMessage(GetTime<std::chrono::microseconds>(), out_err_raw_size));
+                ++num_msgs;
+            }
+        }
+    }
+    return num_msgs;
+}
+
+//! Reassembly throughput of a stream of small tx messages (tx relay shape).
+static void P2PTransportTxRelay(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const BasicTestingSetup>(CBaseChainParams::MAIN);
+
+    constexpr size_t NUM_TXS{1000};
+    std::vector<uint8_t> stream;
+    for (size_t i = 0; i < NUM_TXS; ++i) {
+        const std::vector<uint8_t> msg_bytes{BuildTxMessage(i)};
+        stream.insert(stream.end(), msg_bytes.begin(), msg_bytes.end());
+    }
+
+    V1TransportDeserializer deserializer{Params(), /* node_id */ 0, SER_NETWORK, INIT_PROTO_VERSION};
+    bench.batch(stream.size()).unit("byte").run([&] {
+        assert(DeserializeStream(deserializer, stream) == NUM_TXS);
+    });
+}
+
+//! Reassembly throughput of a single full block message (block relay shape).
+static void P2PTransportBlockRelay(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const BasicTestingSetup>(CBaseChainParams::MAIN);
+
+    CSerializedNetMsg msg;
+    msg.m_type = NetMsgType::BLOCK;
+    msg.data = benchmark::data::block413567;
+    const std::vector<uint8_t> stream{SerializeMessage(std::move(msg))};
+
+    V1TransportDeserializer deserializer{Params(), /* node_id */ 0, SER_NETWORK, INIT_PROTO_VERSION};
+    bench.batch(stream.size()).unit("byte").run([&] {
+        assert(DeserializeStream(deserializer, stream) == 1);
+    });
+}
+
+#ifndef WIN32
+//! Tx messages sent through a loopback socketpair and received the way
+//! ThreadSocketHandler does, including the direct-into-message-buffer path.
+static void P2PTransportSocketPairTx(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const BasicTestingSetup>(CBaseChainParams::MAIN);
+
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    // One batch per iteration, small enough to fit in the socket buffer so a
+    // single thread can send it all before draining the other end.
+    constexpr size_t NUM_TXS{100};
+    std::vector<uint8_t> stream;
+    for (size_t i = 0; i < NUM_TXS; ++i) {
+        const std::vector<uint8_t> msg_bytes{BuildTxMessage(i)};
+        stream.insert(stream.end(), msg_bytes.begin(), msg_bytes.end());
+    }
+
+    V1TransportDeserializer deserializer{Params(), /* node_id */ 0, SER_NETWORK, INIT_PROTO_VERSION};
+    std::vector<uint8_t> staging(0x10000);
+    bench.batch(stream.size()).unit("byte").run([&] {
+        size_t sent{0};
+        while (sent < stream.size()) {
+            const ssize_t ret = send(fds[0], stream.data() + sent, stream.size() - sent, MSG_NOSIGNAL);
+            assert(ret > 0);
+            sent += ret;
+        }
+        size_t num_msgs{0};
+        while (num_msgs < NUM_TXS) {
+            // Mirror CConnman::SocketHandler: read straight into the message
+            // buffer when the deserializer exposes one.
+            Span<uint8_t> direct_buf = deserializer.GetReceiveBuffer(staging.size());
+            uint8_t* recv_buf = direct_buf.empty() ? staging.data() : direct_buf.data();
+            const size_t recv_max = direct_buf.empty() ? staging.size() : direct_buf.size();
+            const ssize_t nBytes = recv(fds[1], recv_buf, recv_max, 0);
+            assert(nBytes > 0);
+            Span<const uint8_t> chunk{recv_buf, static_cast<size_t>(nBytes)};
+            while (chunk.size() > 0) {
+                assert(deserializer.Read(chunk) >= 0);
+                if (deserializer.Complete()) {
+                    uint32_t out_err_raw_size{0};
+                    assert(deserializer.GetMessage(GetTime<std::chrono::microseconds>(), out_err_raw_size));
+                    ++num_msgs;
+                }
+            }
+        }
+    });
+
+    close(fds[0]);
+    close(fds[1]);
+}
+#endif // WIN32
+
+BENCHMARK(P2PTransportTxRelay);
+BENCHMARK(P2PTransportBlockRelay);
+#ifndef WIN32
+BENCHMARK(P2PTransportSocketPairTx);
+#endif
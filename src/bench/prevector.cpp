@@ -6,6 +6,7 @@
 #include <serialize.h>
 #include <streams.h>
 #include <type_traits>
+#include <vector>
 
 #include <bench/bench.h>
 
@@ -80,6 +81,29 @@ static void PrevectorDeserialize(benchmark::Bench& bench)
     });
 }
 
+template <typename T>
+static void PrevectorCopy(benchmark::Bench& bench)
+{
+    // Sizes drawn from the realistic on-chain script-size distribution:
+    // P2WPKH (22), P2SH (23), P2PKH (25), P2WSH/P2TR (34) scriptPubKeys, a
+    // DER signature push (72) and a P2PKH scriptSig (107). The last three
+    // spill out of the direct slots, so this exercises both the direct
+    // memcpy path and a heap allocation per copy, like block
+    // deserialization does.
+    static constexpr size_t script_sizes[] = {22, 23, 25, 34, 72, 107};
+    std::vector<prevector<28, T>> src;
+    for (const size_t script_size : script_sizes) {
+        src.emplace_back();
+        src.back().resize(script_size);
+    }
+    bench.batch(src.size()).run([&] {
+        for (const auto& script : src) {
+            prevector<28, T> copy(script);
+            ankerl::nanobench::doNotOptimizeAway(copy);
+        }
+    });
+}
+
 #define PREVECTOR_TEST(name)                                         \
     static void Prevector##name##Nontrivial(benchmark::Bench& bench) \
     {                                                                \
@@ -93,6 +117,7 @@ static void PrevectorDeserialize(benchmark::Bench& bench)
     BENCHMARK(Prevector##name##Trivial);
 
 PREVECTOR_TEST(Clear)
+PREVECTOR_TEST(Copy)
 PREVECTOR_TEST(Destructor)
 PREVECTOR_TEST(Resize)
 PREVECTOR_TEST(Deserialize)
@@ -0,0 +1,37 @@
+// Copyright (c) 2021 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <random.h>
+#include <util/strencodings.h>
+
+#include <string>
+#include <vector>
+
+/** Roughly the serialized size of a full block. */
+static constexpr size_t HEX_BENCH_BYTES{1024 * 1024};
+
+static void HexStrBench(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/* fDeterministic */ true};
+    const std::vector<unsigned char> data{rng.randbytes(HEX_BENCH_BYTES)};
+    bench.batch(data.size()).unit("byte").run([&] {
+        std::string hex = HexStr(data);
+        ankerl::nanobench::doNotOptimizeAway(hex);
+    });
+}
+
+static void ParseHexBench(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/* fDeterministic */ true};
+    const std::string hex{HexStr(rng.randbytes(HEX_BENCH_BYTES))};
+    bench.batch(HEX_BENCH_BYTES).unit("byte").run([&] {
+        std::vector<unsigned char> data = ParseHex(hex);
+        ankerl::nanobench::doNotOptimizeAway(data);
+    });
+}
+
+BENCHMARK(HexStrBench);
+BENCHMARK(ParseHexBench);
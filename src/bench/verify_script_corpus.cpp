@@ -0,0 +1,261 @@
+// Copyright (c) 2021 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <key.h>
+#include <pubkey.h>
+#include <script/interpreter.h>
+#include <script/script.h>
+#include <script/sigcache.h>
+#include <script/standard.h>
+#include <test/util/transaction_utils.h>
+#include <uint256.h>
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Replays a corpus of spends whose script-class mix approximates what block
+// validation actually sees (P2WPKH-dominated, with P2PKH, wrapped segwit,
+// multisig, taproot key path and large-witness P2WSH spends), so interpreter
+// and crypto changes are measured against that mix rather than a single
+// hand-built script. Each class is also reported on its own.
+
+namespace {
+
+//! Flags all corpus spends are verified under.
+constexpr unsigned int CORPUS_FLAGS{SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_DERSIG | SCRIPT_VERIFY_NULLDUMMY | SCRIPT_VERIFY_WITNESS | SCRIPT_VERIFY_TAPROOT};
+
+struct CorpusEntry {
+    CTransaction spend;
+    CTxOut prevout;
+    PrecomputedTransactionData txdata;
+
+    CorpusEntry(CMutableTransaction&& spend_in, CTxOut prevout_in) : spend(spend_in), prevout(std::move(prevout_in))
+    {
+        txdata.Init(spend, {prevout});
+    }
+};
+
+struct ScriptClass {
+    std::string name;
+    std::vector<CorpusEntry> entries;
+};
+
+//! Deterministic distinct keys, so every corpus entry carries its own signature.
+CKey CorpusKey(int n)
+{
+    std::vector<unsigned char> data(32, 0);
+    data[30] = n >> 8;
+    data[31] = (n & 0xff) + 1;
+    CKey key;
+    key.Set(data.begin(), data.end(), true);
+    assert(key.IsValid());
+    return key;
+}
+
+std::vector<unsigned char> SignECDSA(const CKey& key, const uint256& hash)
+{
+    std::vector<unsigned char> sig;
+    const bool ok{key.Sign(hash, sig)};
+    assert(ok);
+    sig.push_back(static_cast<unsigned char>(SIGHASH_ALL));
+    return sig;
+}
+
+CorpusEntry BuildP2PKH(const CKey& key)
+{
+    const CPubKey pubkey{key.GetPubKey()};
+    const CScript script_pubkey{GetScriptForDestination(PKHash(pubkey))};
+    const CMutableTransaction credit{BuildCreditingTransaction(script_pubkey, 1)};
+    CMutableTransaction spend{BuildSpendingTransaction(CScript(), CScriptWitness(), CTransaction(credit))};
+    const auto sig{SignECDSA(key, SignatureHash(script_pubkey, spend, 0, SIGHASH_ALL, credit.vout[0].nValue, SigVersion::BASE))};
+    spend.vin[0].scriptSig = CScript() << sig << ToByteVector(pubkey);
+    return {std::move(spend), credit.vout[0]};
+}
+
+CorpusEntry BuildP2WPKH(const CKey& key, bool p2sh_wrapped)
+{
+    const CPubKey pubkey{key.GetPubKey()};
+    const CScript witness_program{GetScriptForDestination(WitnessV0KeyHash(pubkey))};
+    const CScript script_pubkey{p2sh_wrapped ? GetScriptForDestination(ScriptHash(witness_program)) : witness_program};
+    const CMutableTransaction credit{BuildCreditingTransaction(script_pubkey, 1)};
+    CMutableTransaction spend{BuildSpendingTransaction(CScript(), CScriptWitness(), CTransaction(credit))};
+    const CScript script_code{GetScriptForDestination(PKHash(pubkey))};
+    const auto sig{SignECDSA(key, SignatureHash(script_code, spend, 0, SIGHASH_ALL, credit.vout[0].nValue, SigVersion::WITNESS_V0))};
+    spend.vin[0].scriptWitness.stack = {sig, ToByteVector(pubkey)};
+    if (p2sh_wrapped) spend.vin[0].scriptSig = CScript() << ToByteVector(witness_program);
+    return {std::move(spend), credit.vout[0]};
+}
+
+CorpusEntry BuildP2WSHMultisig(const CKey& key1, const CKey& key2, const CKey& key3)
+{
+    const CScript witness_script{GetScriptForMultisig(2, {key1.GetPubKey(), key2.GetPubKey(), key3.GetPubKey()})};
+    const CScript script_pubkey{GetScriptForDestination(WitnessV0ScriptHash(witness_script))};
+    const CMutableTransaction credit{BuildCreditingTransaction(script_pubkey, 1)};
+    CMutableTransaction spend{BuildSpendingTransaction(CScript(), CScriptWitness(), CTransaction(credit))};
+    const uint256 hash{SignatureHash(witness_script, spend, 0, SIGHASH_ALL, credit.vout[0].nValue, SigVersion::WITNESS_V0)};
+    // Dummy element for the CHECKMULTISIG bug, signatures in pubkey order.
+    spend.vin[0].scriptWitness.stack = {{}, SignECDSA(key1, hash), SignECDSA(key2, hash), ToByteVector(witness_script)};
+    return {std::move(spend), credit.vout[0]};
+}
+
+CorpusEntry BuildP2TRKeyPath(const CKey& key)
+{
+    const CPubKey pubkey{key.GetPubKey()};
+    // Use the untweaked key as the output key; verification does not care
+    // whether it commits to a script tree.
+    const std::vector<unsigned char> xonly{pubkey.begin() + 1, pubkey.begin() + 33};
+    const CScript script_pubkey{CScript() << OP_1 << xonly};
+    const CMutableTransaction credit{BuildCreditingTransaction(script_pubkey, 1)};
+    CMutableTransaction spend{BuildSpendingTransaction(CScript(), CScriptWitness(), CTransaction(credit))};
+    // Install a placeholder signature first: Init() only precomputes the
+    // BIP341 midstates for inputs that carry a witness.
+    spend.vin[0].scriptWitness.stack = {std::vector<unsigned char>(64)};
+    PrecomputedTransactionData txdata;
+    txdata.Init(spend, {credit.vout[0]});
+    ScriptExecutionData execdata;
+    execdata.m_annex_init = true;
+    execdata.m_annex_present = false;
+    uint256 hash;
+    const bool hash_ok{SignatureHashSchnorr(hash, execdata, spend, 0, 0 /* SIGHASH_DEFAULT */, SigVersion::TAPROOT, txdata)};
+    assert(hash_ok);
+    std::vector<unsigned char> sig(64);
+    const bool sign_ok{key.SignSchnorr(hash, sig)};
+    assert(sign_ok);
+    spend.vin[0].scriptWitness.stack = {sig};
+    return {std::move(spend), credit.vout[0]};
+}
+
+CorpusEntry BuildP2WSHLargeWitness(int n)
+{
+    constexpr int NUM_ELEMENTS{8};
+    CScript witness_script;
+    for (int i = 0; i < NUM_ELEMENTS; ++i) witness_script << OP_DROP;
+    witness_script << OP_1;
+    const CScript script_pubkey{GetScriptForDestination(WitnessV0ScriptHash(witness_script))};
+    const CMutableTransaction credit{BuildCreditingTransaction(script_pubkey, 1)};
+    CMutableTransaction spend{BuildSpendingTransaction(CScript(), CScriptWitness(), CTransaction(credit))};
+    for (int i = 0; i < NUM_ELEMENTS; ++i) {
+        spend.vin[0].scriptWitness.stack.emplace_back(480, static_cast<unsigned char>(n + i));
+    }
+    spend.vin[0].scriptWitness.stack.push_back(ToByteVector(witness_script));
+    return {std::move(spend), credit.vout[0]};
+}
+
+std::vector<ScriptClass> BuildCorpus()
+{
+    // Rough per-class weights of recent blocks, scaled down to keep setup fast.
+    std::vector<ScriptClass> corpus;
+    int key{0};
+
+    ScriptClass p2wpkh{"p2wpkh", {}};
+    for (int i = 0; i < 12; ++i) p2wpkh.entries.push_back(BuildP2WPKH(CorpusKey(key++), /* p2sh_wrapped */ false));
+    corpus.push_back(std::move(p2wpkh));
+
+    ScriptClass p2pkh{"p2pkh", {}};
+    for (int i = 0; i < 5; ++i) p2pkh.entries.push_back(BuildP2PKH(CorpusKey(key++)));
+    corpus.push_back(std::move(p2pkh));
+
+    ScriptClass wrapped{"p2sh-p2wpkh", {}};
+    for (int i = 0; i < 3; ++i) wrapped.entries.push_back(BuildP2WPKH(CorpusKey(key++), /* p2sh_wrapped */ true));
+    corpus.push_back(std::move(wrapped));
+
+    ScriptClass multisig{"p2wsh-multisig", {}};
+    for (int i = 0; i < 4; ++i) {
+        multisig.entries.push_back(BuildP2WSHMultisig(CorpusKey(key), CorpusKey(key + 1), CorpusKey(key + 2)));
+        key += 3;
+    }
+    corpus.push_back(std::move(multisig));
+
+    ScriptClass taproot{"p2tr-keypath", {}};
+    for (int i = 0; i < 4; ++i) taproot.entries.push_back(BuildP2TRKeyPath(CorpusKey(key++)));
+    corpus.push_back(std::move(taproot));
+
+    ScriptClass large{"p2wsh-large-witness", {}};
+    for (int i = 0; i < 2; ++i) large.entries.push_back(BuildP2WSHLargeWitness(i));
+    corpus.push_back(std::move(large));
+
+    return corpus;
+}
+
+template <typename Checker>
+void VerifyEntry(CorpusEntry& entry, Checker&& checker)
+{
+    ScriptError err;
+    const bool success{VerifyScript(
+        entry.spend.vin[0].scriptSig,
+        entry.prevout.scriptPubKey,
+        &entry.spend.vin[0].scriptWitness,
+        CORPUS_FLAGS,
+        checker,
+        &err)};
+    assert(err == SCRIPT_ERR_OK);
+    assert(success);
+}
+
+} // namespace
+
+static void VerifyScriptCorpus(benchmark::Bench& bench)
+{
+    const ECCVerifyHandle verify_handle;
+    ECC_Start();
+    auto corpus{BuildCorpus()};
+
+    size_t total{0};
+    for (auto& cls : corpus) {
+        total += cls.entries.size();
+        bench.batch(cls.entries.size()).unit("verify").run("VerifyScriptCorpus[" + cls.name + "]", [&] {
+            for (auto& entry : cls.entries) {
+                VerifyEntry(entry, TransactionSignatureChecker(&entry.spend, 0, entry.prevout.nValue, entry.txdata));
+            }
+        });
+    }
+    bench.batch(total).unit("verify").run("VerifyScriptCorpus[all]", [&] {
+        for (auto& cls : corpus) {
+            for (auto& entry : cls.entries) {
+                VerifyEntry(entry, TransactionSignatureChecker(&entry.spend, 0, entry.prevout.nValue, entry.txdata));
+            }
+        }
+    });
+    ECC_Stop();
+}
+
+static void VerifyScriptCorpusCached(benchmark::Bench& bench)
+{
+    const ECCVerifyHandle verify_handle;
+    ECC_Start();
+    InitSignatureCache();
+    auto corpus{BuildCorpus()};
+
+    // Warm the signature cache, as happens when a block's transactions were
+    // already verified on mempool acceptance.
+    size_t total{0};
+    for (auto& cls : corpus) {
+        total += cls.entries.size();
+        for (auto& entry : cls.entries) {
+            VerifyEntry(entry, CachingTransactionSignatureChecker(&entry.spend, 0, entry.prevout.nValue, /* storeIn */ true, entry.txdata));
+        }
+    }
+    for (auto& cls : corpus) {
+        bench.batch(cls.entries.size()).unit("verify").run("VerifyScriptCorpusCached[" + cls.name + "]", [&] {
+            for (auto& entry : cls.entries) {
+                VerifyEntry(entry, CachingTransactionSignatureChecker(&entry.spend, 0, entry.prevout.nValue, /* storeIn */ false, entry.txdata));
+            }
+        });
+    }
+    bench.batch(total).unit("verify").run("VerifyScriptCorpusCached[all]", [&] {
+        for (auto& cls : corpus) {
+            for (auto& entry : cls.entries) {
+                VerifyEntry(entry, CachingTransactionSignatureChecker(&entry.spend, 0, entry.prevout.nValue, /* storeIn */ false, entry.txdata));
+            }
+        }
+    });
+    ECC_Stop();
+}
+
+BENCHMARK(VerifyScriptCorpus);
+BENCHMARK(VerifyScriptCorpusCached);
@@ -0,0 +1,72 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <interfaces/chain.h>
+#include <node/context.h>
+#include <test/util/setup_common.h>
+#include <util/translation.h>
+#include <wallet/wallet.h>
+#include <wallet/walletdb.h>
+
+#include <cassert>
+#include <memory>
+
+//! Number of synthetic transaction records in the benchmark wallet. Scaled so
+//! the benchmark stays runnable in CI; load time is linear in the record
+//! count, so regressions show up at this size too.
+static constexpr int WALLET_LOAD_TXS{10000};
+
+static std::unique_ptr<WalletDatabase> OpenBenchDatabase(bool create)
+{
+    DatabaseOptions options;
+    options.require_create = create;
+    options.require_existing = !create;
+    DatabaseStatus status;
+    bilingual_str error;
+    std::unique_ptr<WalletDatabase> db = MakeWalletDatabase("wallet_load_bench", options, status, error);
+    assert(db);
+    return db;
+}
+
+/** Benchmark opening a wallet with a large synthetic transaction history.
+ * The records are written once; each iteration then constructs a fresh
+ * CWallet over the same database file and runs the full LoadWallet path,
+ * including the parallel transaction-record deserialization. */
+static void WalletLoad(benchmark::Bench& bench)
+{
+    const auto test_setup = MakeNoLogFileContext<TestingSetup>();
+
+    {
+        CWallet wallet{test_setup->m_node.chain.get(), "", OpenBenchDatabase(/* create */ true)};
+        bool first_run;
+        if (wallet.LoadWallet(first_run) != DBErrors::LOAD_OK) assert(false);
+        wallet.SetupLegacyScriptPubKeyMan();
+
+        LOCK(wallet.cs_wallet);
+        // Group the writes into one database transaction where the backend
+        // supports it, so populating the wallet doesn't dominate setup time.
+        WalletBatch batch{wallet.GetDatabase()};
+        const bool txn_started = batch.TxnBegin();
+        for (int i = 0; i < WALLET_LOAD_TXS; ++i) {
+            CMutableTransaction mtx;
+            mtx.vout.resize(1);
+            mtx.vout[0].nValue = i + 1; // unique value, so every tx gets a different hash
+            mtx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+            wallet.AddToWallet(MakeTransactionRef(mtx), CWalletTx::Confirmation{}, /* update_wtx */ nullptr, /* fFlushOnClose */ false);
+        }
+        if (txn_started) batch.TxnCommit();
+    }
+
+    bench.run([&] {
+        CWallet wallet{test_setup->m_node.chain.get(), "", OpenBenchDatabase(/* create */ false)};
+        bool first_run;
+        bool ok = wallet.LoadWallet(first_run) == DBErrors::LOAD_OK;
+        assert(ok);
+        LOCK(wallet.cs_wallet);
+        assert(wallet.mapWallet.size() == WALLET_LOAD_TXS);
+    });
+}
+
+BENCHMARK(WalletLoad);
@@ -0,0 +1,123 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <interfaces/chain.h>
+#include <key_io.h>
+#include <node/context.h>
+#include <script/standard.h>
+#include <test/util/mining.h>
+#include <test/util/setup_common.h>
+#include <test/util/wallet.h>
+#include <validation.h>
+#include <wallet/wallet.h>
+
+#include <cassert>
+#include <vector>
+
+namespace {
+
+struct BenchWallet {
+    CWallet wallet;
+    //! A scriptPubKey the wallet can spend
+    CScript spk;
+
+    explicit BenchWallet(interfaces::Chain* chain) : wallet{chain, "", CreateMockWalletDatabase()}
+    {
+        wallet.SetupLegacyScriptPubKeyMan();
+        bool first_run;
+        if (wallet.LoadWallet(first_run) != DBErrors::LOAD_OK) assert(false);
+        spk = GetScriptForDestination(DecodeDestination(getnewaddress(wallet)));
+    }
+
+    //! Make a unique transaction with one output paying the wallet
+    CTransactionRef MakeTx(int i) const
+    {
+        CMutableTransaction mtx;
+        mtx.vout.resize(1);
+        mtx.vout[0].nValue = 1000 + i; // unique value, so every tx gets a different hash
+        mtx.vout[0].scriptPubKey = spk;
+        return MakeTransactionRef(mtx);
+    }
+};
+
+} // namespace
+
+/** Benchmark AvailableCoins over a wallet holding n_coins confirmed outputs. */
+static void WalletAvailableCoins(benchmark::Bench& bench, int n_coins)
+{
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
+    BenchWallet bw{test_setup->m_node.chain.get()};
+    CWallet& wallet = bw.wallet;
+
+    LOCK(wallet.cs_wallet);
+    for (int i = 0; i < n_coins; ++i) {
+        wallet.AddToWallet(bw.MakeTx(i), CWalletTx::Confirmation{CWalletTx::Status::CONFIRMED, /* block_height */ 1, uint256::ONE, /* posInBlock */ 0},
+                           /* update_wtx */ nullptr, /* fFlushOnClose */ false);
+    }
+    // Give the confirmed outputs plenty of depth.
+    wallet.SetLastBlockProcessed(101, uint256::ONE);
+
+    bench.run([&] {
+        std::vector<COutput> coins;
+        wallet.AvailableCoins(coins);
+        assert(coins.size() == (size_t)n_coins);
+    });
+}
+
+static void WalletAvailableCoins1000(benchmark::Bench& bench) { WalletAvailableCoins(bench, 1000); }
+static void WalletAvailableCoins10000(benchmark::Bench& bench) { WalletAvailableCoins(bench, 10000); }
+
+/** Benchmark the cost of processing an incoming wallet-relevant transaction
+ * (the AddToWalletIfInvolvingMe path, entered through the mempool
+ * notification). Transactions are pre-built so only wallet work is timed. */
+static void WalletAddTx(benchmark::Bench& bench)
+{
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
+    BenchWallet bw{test_setup->m_node.chain.get()};
+
+    std::vector<CTransactionRef> txs;
+    txs.reserve(20000);
+    for (int i = 0; i < 20000; ++i) {
+        txs.push_back(bw.MakeTx(i));
+    }
+
+    uint64_t mempool_sequence{0};
+    size_t next{0};
+    bench.unit("tx").run([&] {
+        // If the pool wraps, re-added transactions take the cheaper update
+        // path; the pool is large enough that this doesn't dominate.
+        bw.wallet.transactionAddedToMempool(txs[next++ % txs.size()], ++mempool_sequence);
+    });
+}
+
+/** Benchmark rescanning a generated chain that pays the wallet in every
+ * block. Repeat scans find the transactions already known, which keeps the
+ * measurement on the scanning machinery itself. */
+static void WalletRescan(benchmark::Bench& bench)
+{
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
+    BenchWallet bw{test_setup->m_node.chain.get()};
+    CWallet& wallet = bw.wallet;
+
+    const std::string address = getnewaddress(wallet);
+    for (int i = 0; i < 100; ++i) {
+        generatetoaddress(test_setup->m_node, address);
+    }
+
+    const uint256 genesis_hash = Params().GenesisBlock().GetHash();
+    bench.run([&] {
+        WalletRescanReserver reserver(wallet);
+        bool reserved = reserver.reserve();
+        assert(reserved);
+        CWallet::ScanResult result = wallet.ScanForWalletTransactions(genesis_hash, /* start_height */ 0, /* max_height */ {}, reserver, /* fUpdate */ false);
+        assert(result.status == CWallet::ScanResult::SUCCESS);
+    });
+}
+
+BENCHMARK(WalletAvailableCoins1000);
+BENCHMARK(WalletAvailableCoins10000);
+BENCHMARK(WalletAddTx);
+BENCHMARK(WalletRescan);
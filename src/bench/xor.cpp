@@ -0,0 +1,24 @@
+// Copyright (c) 2021 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <clientversion.h>
+#include <random.h>
+#include <streams.h>
+
+#include <vector>
+
+static void Xor(benchmark::Bench& bench)
+{
+    FastRandomContext frc{/* fDeterministic */ true};
+    auto data{frc.randbytes(1024 * 1024)};
+    auto key{frc.randbytes(8)}; // the size of the database obfuscation key
+    CDataStream stream{data, SER_DISK, CLIENT_VERSION};
+
+    bench.batch(data.size()).unit("byte").run([&] {
+        stream.Xor(key);
+    });
+}
+
+BENCHMARK(Xor);
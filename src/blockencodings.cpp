@@ -14,18 +14,34 @@
 #include <validation.h>
 #include <util/system.h>
 
+#include <atomic>
+#include <future>
 #include <unordered_map>
 
 CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, bool fUseWTXID) :
+        CBlockHeaderAndShortTxIDs(block, fUseWTXID, {}) {}
+
+CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, bool fUseWTXID, const std::vector<uint16_t>& extra_prefill) :
         nonce(GetRand(std::numeric_limits<uint64_t>::max())),
-        shorttxids(block.vtx.size() - 1), prefilledtxn(1), header(block) {
+        shorttxids(block.vtx.size() - 1 - extra_prefill.size()), prefilledtxn(1 + extra_prefill.size()), header(block) {
     FillShortTxIDSelector();
-    //TODO: Use our mempool prior to block acceptance to predictively fill more than just the coinbase
     prefilledtxn[0] = {0, block.vtx[0]};
+    // Prefilled indexes are serialized as offsets since the last prefilled
+    // transaction; extra_prefill is sorted so the running difference works.
+    size_t next_extra = 0;
+    size_t last_prefilled_index = 0;
+    size_t shortid_pos = 0;
     for (size_t i = 1; i < block.vtx.size(); i++) {
         const CTransaction& tx = *block.vtx[i];
-        shorttxids[i - 1] = GetShortID(fUseWTXID ? tx.GetWitnessHash() : tx.GetHash());
+        if (next_extra < extra_prefill.size() && extra_prefill[next_extra] == i) {
+            prefilledtxn[1 + next_extra] = {(uint16_t)(i - last_prefilled_index - 1), block.vtx[i]};
+            last_prefilled_index = i;
+            ++next_extra;
+        } else {
+            shorttxids[shortid_pos++] = GetShortID(fUseWTXID ? tx.GetWitnessHash() : tx.GetHash());
+        }
     }
+    assert(next_extra == extra_prefill.size());
 }
 
 void CBlockHeaderAndShortTxIDs::FillShortTxIDSelector() const {
@@ -105,22 +121,66 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     std::vector<bool> have_txn(txn_available.size());
     {
     LOCK(pool->cs);
-    for (size_t i = 0; i < pool->vTxHashes.size(); i++) {
-        uint64_t shortid = cmpctblock.GetShortID(pool->vTxHashes[i].first);
-        std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
-        if (idit != shorttxids.end()) {
-            if (!have_txn[idit->second]) {
-                txn_available[idit->second] = pool->vTxHashes[i].second->GetSharedTx();
-                have_txn[idit->second]  = true;
-                mempool_count++;
-            } else {
-                // If we find two mempool txn that match the short id, just request it.
-                // This should be rare enough that the extra bandwidth doesn't matter,
-                // but eating a round-trip due to FillBlock failure would be annoying
-                if (txn_available[idit->second]) {
-                    txn_available[idit->second].reset();
-                    mempool_count--;
-                }
+    // Candidate (mempool position, block position) matches, in mempool order.
+    // Computing the per-block-salted short id for every mempool transaction
+    // dominates reconstruction cost for large mempools, so the scan is striped
+    // across worker threads; matches are applied serially below to keep the
+    // duplicate-short-id handling identical to a sequential scan.
+    std::vector<std::pair<size_t, uint16_t>> matches;
+    const size_t num_pool_txs = pool->vTxHashes.size();
+    const std::pair<uint256, CTxMemPool::txiter>* tx_hashes = pool->vTxHashes.data();
+    std::atomic<size_t> matches_found{0};
+    auto scan_short_ids = [&](size_t range_begin, size_t range_end, std::vector<std::pair<size_t, uint16_t>>& out) {
+        for (size_t i = range_begin; i < range_end; i++) {
+            // Stop early once every short id has a candidate; duplicates may
+            // make this fire late, never early.
+            if ((i & 0x3ff) == 0 && matches_found.load(std::memory_order_relaxed) >= shorttxids.size()) return;
+            const uint64_t shortid = cmpctblock.GetShortID(tx_hashes[i].first);
+            const auto idit = shorttxids.find(shortid);
+            if (idit != shorttxids.end()) {
+                out.emplace_back(i, idit->second);
+                matches_found.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Only worth spinning up threads when the mempool scan dwarfs the
+    // per-thread startup cost.
+    constexpr size_t MIN_TXS_PER_SHORTID_WORKER{10000};
+    const size_t num_workers = std::clamp<size_t>(num_pool_txs / MIN_TXS_PER_SHORTID_WORKER, 1, std::max(1, GetNumCores() - 1));
+    if (num_workers > 1) {
+        std::vector<std::vector<std::pair<size_t, uint16_t>>> worker_matches(num_workers);
+        std::vector<std::future<void>> futures;
+        futures.reserve(num_workers - 1);
+        for (size_t w = 1; w < num_workers; w++) {
+            futures.emplace_back(std::async(std::launch::async, scan_short_ids,
+                                            w * num_pool_txs / num_workers,
+                                            (w + 1) * num_pool_txs / num_workers,
+                                            std::ref(worker_matches[w])));
+        }
+        scan_short_ids(0, num_pool_txs / num_workers, worker_matches[0]);
+        for (auto& future : futures) future.wait();
+        // Stripes cover ascending ranges, so appending in stripe order keeps
+        // the matches sorted by mempool position.
+        for (auto& stripe : worker_matches) {
+            matches.insert(matches.end(), stripe.begin(), stripe.end());
+        }
+    } else {
+        scan_short_ids(0, num_pool_txs, matches);
+    }
+
+    for (const auto& [pool_idx, block_idx] : matches) {
+        if (!have_txn[block_idx]) {
+            txn_available[block_idx] = tx_hashes[pool_idx].second->GetSharedTx();
+            have_txn[block_idx]  = true;
+            mempool_count++;
+        } else {
+            // If we find two mempool txn that match the short id, just request it.
+            // This should be rare enough that the extra bandwidth doesn't matter,
+            // but eating a round-trip due to FillBlock failure would be annoying
+            if (txn_available[block_idx]) {
+                txn_available[block_idx].reset();
+                mempool_count--;
             }
         }
         // Though ideally we'd continue scanning for the two-txn-match-shortid case,
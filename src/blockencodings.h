@@ -106,6 +106,12 @@ public:
 
     CBlockHeaderAndShortTxIDs(const CBlock& block, bool fUseWTXID);
 
+    /** As above, but additionally prefill the transactions at the given block
+     * positions (sorted, in-range, excluding the coinbase which is always
+     * prefilled). Used by the announcement path to include transactions the
+     * receiver likely does not have, avoiding a getblocktxn round trip. */
+    CBlockHeaderAndShortTxIDs(const CBlock& block, bool fUseWTXID, const std::vector<uint16_t>& extra_prefill);
+
     uint64_t GetShortID(const uint256& txhash) const;
 
     size_t BlockTxCount() const { return shorttxids.size() + prefilledtxn.size(); }
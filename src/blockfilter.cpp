@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <future>
 #include <mutex>
 #include <sstream>
 #include <set>
@@ -63,13 +64,43 @@ uint64_t GCSFilter::HashToRange(const Element& element) const
     return MapIntoRange(hash, m_F);
 }
 
-std::vector<uint64_t> GCSFilter::BuildHashedSet(const ElementSet& elements) const
+std::vector<uint64_t> GCSFilter::BuildHashedSet(const ElementSet& elements, int worker_threads) const
 {
     std::vector<uint64_t> hashed_elements;
-    hashed_elements.reserve(elements.size());
-    for (const Element& element : elements) {
-        hashed_elements.push_back(HashToRange(element));
+
+    // Each element hashes independently, so with enough of them and more than
+    // one thread requested, split the set into contiguous ranges and hash
+    // each range on its own thread before the (serial) sort.
+    constexpr size_t MIN_ELEMENTS_PER_WORKER{4096};
+    if (worker_threads > 1 && elements.size() >= 2 * MIN_ELEMENTS_PER_WORKER) {
+        std::vector<const Element*> element_ptrs;
+        element_ptrs.reserve(elements.size());
+        for (const Element& element : elements) {
+            element_ptrs.push_back(&element);
+        }
+
+        hashed_elements.resize(elements.size());
+        const size_t num_workers = std::min<size_t>(worker_threads, elements.size() / MIN_ELEMENTS_PER_WORKER);
+        const auto hash_range = [this, &element_ptrs, &hashed_elements](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                hashed_elements[i] = HashToRange(*element_ptrs[i]);
+            }
+        };
+        std::vector<std::future<void>> workers;
+        workers.reserve(num_workers - 1);
+        for (size_t w = 1; w < num_workers; ++w) {
+            workers.push_back(std::async(std::launch::async, hash_range,
+                                         w * elements.size() / num_workers, (w + 1) * elements.size() / num_workers));
+        }
+        hash_range(0, elements.size() / num_workers);
+        for (auto& worker : workers) worker.get();
+    } else {
+        hashed_elements.reserve(elements.size());
+        for (const Element& element : elements) {
+            hashed_elements.push_back(HashToRange(element));
+        }
     }
+
     std::sort(hashed_elements.begin(), hashed_elements.end());
     return hashed_elements;
 }
@@ -101,7 +132,7 @@ GCSFilter::GCSFilter(const Params& params, std::vector<unsigned char> encoded_fi
     }
 }
 
-GCSFilter::GCSFilter(const Params& params, const ElementSet& elements)
+GCSFilter::GCSFilter(const Params& params, const ElementSet& elements, int worker_threads)
     : m_params(params)
 {
     size_t N = elements.size();
@@ -122,7 +153,7 @@ GCSFilter::GCSFilter(const Params& params, const ElementSet& elements)
     BitStreamWriter<CVectorWriter> bitwriter(stream);
 
     uint64_t last_value = 0;
-    for (uint64_t value : BuildHashedSet(elements)) {
+    for (uint64_t value : BuildHashedSet(elements, worker_threads)) {
         uint64_t delta = value - last_value;
         GolombRiceEncode(bitwriter, m_params.m_P, delta);
         last_value = value;
@@ -175,6 +206,48 @@ bool GCSFilter::MatchAny(const ElementSet& elements) const
     return MatchInternal(queries.data(), queries.size());
 }
 
+GCSFilter::ElementSet GCSFilter::MatchMany(const ElementSet& elements) const
+{
+    // Sort the query hashes so both they and the filter contents are visited
+    // in increasing order during a single merge pass over the decoded stream.
+    // Keep a pointer back to each element so matches can be reported.
+    std::vector<std::pair<uint64_t, const Element*>> queries;
+    queries.reserve(elements.size());
+    for (const Element& element : elements) {
+        queries.emplace_back(HashToRange(element), &element);
+    }
+    std::sort(queries.begin(), queries.end());
+
+    ElementSet matches;
+    if (queries.empty()) return matches;
+
+    VectorReader stream(GCS_SER_TYPE, GCS_SER_VERSION, m_encoded, 0);
+
+    // Seek forward by size of N
+    uint64_t N = ReadCompactSize(stream);
+    assert(N == m_N);
+
+    BitStreamReader<VectorReader> bitreader(stream);
+
+    uint64_t value = 0;
+    size_t queries_index = 0;
+    for (uint32_t i = 0; i < m_N && queries_index < queries.size(); ++i) {
+        uint64_t delta = GolombRiceDecode(bitreader, m_params.m_P);
+        value += delta;
+
+        while (queries_index < queries.size() && queries[queries_index].first < value) {
+            ++queries_index;
+        }
+        // Distinct elements may hash to the same value; report them all.
+        while (queries_index < queries.size() && queries[queries_index].first == value) {
+            matches.insert(*queries[queries_index].second);
+            ++queries_index;
+        }
+    }
+
+    return matches;
+}
+
 const std::string& BlockFilterTypeName(BlockFilterType filter_type)
 {
     static std::string unknown_retval = "";
@@ -260,14 +333,14 @@ BlockFilter::BlockFilter(BlockFilterType filter_type, const uint256& block_hash,
     m_filter = GCSFilter(params, std::move(filter));
 }
 
-BlockFilter::BlockFilter(BlockFilterType filter_type, const CBlock& block, const CBlockUndo& block_undo)
+BlockFilter::BlockFilter(BlockFilterType filter_type, const CBlock& block, const CBlockUndo& block_undo, int worker_threads)
     : m_filter_type(filter_type), m_block_hash(block.GetHash())
 {
     GCSFilter::Params params;
     if (!BuildParams(params)) {
         throw std::invalid_argument("unknown filter_type");
     }
-    m_filter = GCSFilter(params, BasicFilterElements(block, block_undo));
+    m_filter = GCSFilter(params, BasicFilterElements(block, block_undo), worker_threads);
 }
 
 bool BlockFilter::BuildParams(GCSFilter::Params& params) const
@@ -48,7 +48,7 @@ private:
     /** Hash a data element to an integer in the range [0, N * M). */
     uint64_t HashToRange(const Element& element) const;
 
-    std::vector<uint64_t> BuildHashedSet(const ElementSet& elements) const;
+    std::vector<uint64_t> BuildHashedSet(const ElementSet& elements, int worker_threads = 0) const;
 
     /** Helper method used to implement Match and MatchAny */
     bool MatchInternal(const uint64_t* sorted_element_hashes, size_t size) const;
@@ -61,8 +61,12 @@ public:
     /** Reconstructs an already-created filter from an encoding. */
     GCSFilter(const Params& params, std::vector<unsigned char> encoded_filter);
 
-    /** Builds a new filter from the params and set of elements. */
-    GCSFilter(const Params& params, const ElementSet& elements);
+    /**
+     * Builds a new filter from the params and set of elements. If
+     * worker_threads is greater than 1 and the element set is large enough,
+     * element hashing is spread over that many threads.
+     */
+    GCSFilter(const Params& params, const ElementSet& elements, int worker_threads = 0);
 
     uint32_t GetN() const { return m_N; }
     const Params& GetParams() const { return m_params; }
@@ -80,6 +84,15 @@ public:
      * efficient that checking Match on multiple elements separately.
      */
     bool MatchAny(const ElementSet& elements) const;
+
+    /**
+     * Checks each of the given elements against the set and returns those
+     * that may be in it, decoding the filter stream only once for the whole
+     * query set. False positives are possible with probability 1/M per
+     * element checked. This is more efficient than calling Match on each
+     * element separately.
+     */
+    ElementSet MatchMany(const ElementSet& elements) const;
 };
 
 constexpr uint8_t BASIC_FILTER_P = 19;
@@ -124,8 +137,10 @@ public:
     BlockFilter(BlockFilterType filter_type, const uint256& block_hash,
                 std::vector<unsigned char> filter);
 
-    //! Construct a new BlockFilter of the specified type from a block.
-    BlockFilter(BlockFilterType filter_type, const CBlock& block, const CBlockUndo& block_undo);
+    //! Construct a new BlockFilter of the specified type from a block. If
+    //! worker_threads is greater than 1, element hashing may use that many
+    //! threads.
+    BlockFilter(BlockFilterType filter_type, const CBlock& block, const CBlockUndo& block_undo, int worker_threads = 0);
 
     BlockFilterType GetFilterType() const { return m_filter_type; }
     const uint256& GetBlockHash() const { return m_block_hash; }
@@ -197,9 +197,74 @@ CRollingBloomFilter::CRollingBloomFilter(const unsigned int nElements, const dou
     reset();
 }
 
-/* Similar to CBloomFilter::Hash */
-static inline uint32_t RollingBloomHash(unsigned int nHashNum, uint32_t nTweak, const std::vector<unsigned char>& vDataToHash) {
-    return MurmurHash3(nHashNum * 0xFBA4C795 + nTweak, vDataToHash);
+/**
+ * Compute two MurmurHash3 lanes (differing only in their seed) over the same
+ * data in a single pass. The expensive per-block key mixing is independent of
+ * the seed, so both lanes share it and only the cheap state mixing runs
+ * twice; the compiler keeps the two lanes in flight simultaneously, making
+ * this barely more expensive than one hash. The seeds match what the old
+ * per-probe scheme used for hash numbers 0 and 1.
+ */
+static inline void RollingBloomHash2(uint32_t nTweak, const std::vector<unsigned char>& vDataToHash,
+                                     uint32_t& hash1_out, uint32_t& hash2_out)
+{
+    const uint32_t c1 = 0xcc9e2d51;
+    const uint32_t c2 = 0x1b873593;
+    uint32_t h1 = nTweak;
+    uint32_t h2 = 0xFBA4C795 + nTweak;
+
+    const int nblocks = vDataToHash.size() / 4;
+    const uint8_t* blocks = vDataToHash.data();
+
+    const auto rotl32 = [](uint32_t x, int r) { return (x << r) | (x >> (32 - r)); };
+
+    for (int i = 0; i < nblocks; ++i) {
+        uint32_t k1 = ReadLE32(blocks + i * 4);
+
+        k1 *= c1;
+        k1 = rotl32(k1, 15);
+        k1 *= c2;
+
+        h1 ^= k1;
+        h1 = rotl32(h1, 13);
+        h1 = h1 * 5 + 0xe6546b64;
+        h2 ^= k1;
+        h2 = rotl32(h2, 13);
+        h2 = h2 * 5 + 0xe6546b64;
+    }
+
+    const uint8_t* tail = vDataToHash.data() + nblocks * 4;
+    uint32_t k1 = 0;
+    switch (vDataToHash.size() & 3) {
+        case 3:
+            k1 ^= tail[2] << 16;
+        case 2:
+            k1 ^= tail[1] << 8;
+        case 1:
+            k1 ^= tail[0];
+            k1 *= c1;
+            k1 = rotl32(k1, 15);
+            k1 *= c2;
+            h1 ^= k1;
+            h2 ^= k1;
+    }
+
+    h1 ^= vDataToHash.size();
+    h1 ^= h1 >> 16;
+    h1 *= 0x85ebca6b;
+    h1 ^= h1 >> 13;
+    h1 *= 0xc2b2ae35;
+    h1 ^= h1 >> 16;
+
+    h2 ^= vDataToHash.size();
+    h2 ^= h2 >> 16;
+    h2 *= 0x85ebca6b;
+    h2 ^= h2 >> 13;
+    h2 *= 0xc2b2ae35;
+    h2 ^= h2 >> 16;
+
+    hash1_out = h1;
+    hash2_out = h2;
 }
 
 
@@ -230,8 +295,16 @@ void CRollingBloomFilter::insert(const std::vector<unsigned char>& vKey)
     }
     nEntriesThisGeneration++;
 
+    /* All probe positions are derived from two hash lanes by double hashing
+     * (h1 + n*h2), which is asymptotically equivalent to n independent hash
+     * functions for bloom filters [Kirsch, Mitzenmacher 2006] but hashes the
+     * key once instead of nHashFuncs times. Forcing h2 odd makes the probe
+     * sequence cycle through all 2^32 values. */
+    uint32_t h1, h2;
+    RollingBloomHash2(nTweak, vKey, h1, h2);
+    h2 |= 1;
     for (int n = 0; n < nHashFuncs; n++) {
-        uint32_t h = RollingBloomHash(n, nTweak, vKey);
+        const uint32_t h = h1 + n * h2;
         int bit = h & 0x3F;
         /* FastMod works with the upper bits of h, so it is safe to ignore that the lower bits of h are already used for bit. */
         uint32_t pos = FastMod(h, data.size());
@@ -249,8 +322,11 @@ void CRollingBloomFilter::insert(const uint256& hash)
 
 bool CRollingBloomFilter::contains(const std::vector<unsigned char>& vKey) const
 {
+    uint32_t h1, h2;
+    RollingBloomHash2(nTweak, vKey, h1, h2);
+    h2 |= 1;
     for (int n = 0; n < nHashFuncs; n++) {
-        uint32_t h = RollingBloomHash(n, nTweak, vKey);
+        const uint32_t h = h1 + n * h2;
         int bit = h & 0x3F;
         uint32_t pos = FastMod(h, data.size());
         /* If the relevant bit is not set in either data[pos & ~1] or data[pos | 1], the filter does not contain vKey */
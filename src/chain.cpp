@@ -121,6 +121,17 @@ void CBlockIndex::BuildSkip()
 
 arith_uint256 GetBlockProof(const CBlockIndex& block)
 {
+    // Difficulty changes at most every 2016 blocks, so headers sync and index
+    // load call this with long runs of identical nBits. The 256-bit division
+    // below dominates the per-header cost; memoize the last conversion so a
+    // run costs one division and per-header work reduces to the chainwork
+    // add. thread_local rather than a lock: callers run under different
+    // locks (or none). The initial state {0 -> 0} matches the real mapping,
+    // as a zero target yields zero proof.
+    static thread_local uint32_t cached_bits{0};
+    static thread_local arith_uint256 cached_proof{0};
+    if (block.nBits == cached_bits) return cached_proof;
+
     arith_uint256 bnTarget;
     bool fNegative;
     bool fOverflow;
@@ -131,7 +142,10 @@ arith_uint256 GetBlockProof(const CBlockIndex& block)
     // as it's too large for an arith_uint256. However, as 2**256 is at least as large
     // as bnTarget+1, it is equal to ((2**256 - bnTarget - 1) / (bnTarget+1)) + 1,
     // or ~bnTarget / (bnTarget+1) + 1.
-    return (~bnTarget / (bnTarget + 1)) + 1;
+    arith_uint256 proof{(~bnTarget / (bnTarget + 1)) + 1};
+    cached_bits = block.nBits;
+    cached_proof = proof;
+    return proof;
 }
 
 int64_t GetBlockProofEquivalentTime(const CBlockIndex& to, const CBlockIndex& from, const CBlockIndex& tip, const Consensus::Params& params)
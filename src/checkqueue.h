@@ -10,6 +10,8 @@
 #include <util/threadnames.h>
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <vector>
 
 template <typename T>
@@ -24,6 +26,15 @@ class CCheckQueueControl;
   * onto the queue, where they are processed by N-1 worker threads. When
   * the master is done adding work, it temporarily joins the worker pool
   * as an N'th worker, until all jobs are done.
+  *
+  * Two scheduling modes are supported:
+  * - The classic mode keeps all queued checks in a single vector guarded by
+  *   one mutex, which every worker contends on to refill its local batch.
+  * - The work-stealing mode gives every worker (and the master) its own
+  *   independently locked shard. Batches added by the master are spread
+  *   over the shards round-robin; a worker drains its own shard first and
+  *   only then steals from the others, so workers no longer serialize on a
+  *   single mutex at high thread counts.
   */
 template <typename T>
 class CCheckQueue
@@ -64,6 +75,32 @@ private:
     std::vector<std::thread> m_worker_threads;
     bool m_request_stop GUARDED_BY(m_mutex){false};
 
+    //! Whether checks are scheduled over per-worker shards instead of the
+    //! single shared queue.
+    const bool m_work_stealing;
+
+    //! A per-worker shard of queued checks for the work-stealing mode.
+    struct WorkerShard {
+        Mutex m_shard_mutex;
+        std::vector<T> m_jobs GUARDED_BY(m_shard_mutex);
+    };
+
+    //! Shard 0 belongs to the master; shard n+1 belongs to worker thread n.
+    //! Only resized while no worker threads are running.
+    std::vector<std::unique_ptr<WorkerShard>> m_shards;
+
+    //! Number of verifications that haven't completed yet (work-stealing
+    //! mode). Incremented before jobs become visible in a shard, so it can
+    //! never be observed as zero while grabbable work remains.
+    std::atomic<unsigned int> m_shard_todo{0};
+
+    //! The temporary evaluation result (work-stealing mode).
+    std::atomic<bool> m_shard_all_ok{true};
+
+    //! Next shard to receive a chunk of added checks. Only the master
+    //! (holding m_control_mutex) adds work, so no locking is needed.
+    size_t m_add_shard{0};
+
     /** Internal function that does bulk of the verification work. */
     bool Loop(bool fMaster)
     {
@@ -128,14 +165,89 @@ private:
         } while (true);
     }
 
+    /** Move up to nBatchSize checks into vChecks, preferring the caller's
+     * own shard and falling back to stealing from the other shards.
+     * Returns the number of checks grabbed (0 if all shards are empty). */
+    unsigned int GrabWork(size_t self_shard, std::vector<T>& vChecks)
+    {
+        for (size_t offset = 0; offset < m_shards.size(); ++offset) {
+            WorkerShard& shard = *m_shards[(self_shard + offset) % m_shards.size()];
+            LOCK(shard.m_shard_mutex);
+            if (shard.m_jobs.empty()) continue;
+            // Take at most half of a stolen shard so its owner keeps some
+            // local work; drain the own shard in nBatchSize chunks.
+            const unsigned int available{(unsigned int)shard.m_jobs.size()};
+            const unsigned int nNow{std::max(1U, std::min(nBatchSize, offset == 0 ? available : available / 2))};
+            vChecks.resize(nNow);
+            for (unsigned int i = 0; i < nNow; i++) {
+                vChecks[i].swap(shard.m_jobs.back());
+                shard.m_jobs.pop_back();
+            }
+            return nNow;
+        }
+        return 0;
+    }
+
+    /** Work-stealing counterpart of Loop(). Each iteration grabs a batch
+     * (own shard first, then stealing), runs it, and retires it from
+     * m_shard_todo; m_mutex is only touched to sleep and to hand the final
+     * result back to the master. */
+    bool LoopWorkStealing(bool fMaster, size_t self_shard)
+    {
+        std::vector<T> vChecks;
+        vChecks.reserve(nBatchSize);
+        do {
+            const unsigned int nNow = GrabWork(self_shard, vChecks);
+            if (nNow == 0) {
+                WAIT_LOCK(m_mutex, lock);
+                if (fMaster) {
+                    // All remaining work (if any) sits in other workers'
+                    // local batches; wait for them to retire it.
+                    while (m_shard_todo > 0 && !m_request_stop) {
+                        nIdle++;
+                        m_master_cv.wait(lock);
+                        nIdle--;
+                    }
+                    if (m_request_stop) return false;
+                    // Collect the result and reset the status for new work later
+                    return m_shard_all_ok.exchange(true);
+                }
+                while (m_shard_todo == 0 && !m_request_stop) {
+                    nIdle++;
+                    m_worker_cv.wait(lock);
+                    nIdle--;
+                }
+                if (m_request_stop) return false;
+                continue;
+            }
+            // Once a check has failed there is no point running the rest,
+            // but they still have to be retired from m_shard_todo.
+            if (m_shard_all_ok.load(std::memory_order_relaxed)) {
+                bool fOk = true;
+                for (T& check : vChecks)
+                    if (fOk)
+                        fOk = check();
+                if (!fOk) m_shard_all_ok.store(false, std::memory_order_relaxed);
+            }
+            vChecks.clear();
+            if (m_shard_todo.fetch_sub(nNow) == nNow) {
+                // We retired the last batch; wake the master under m_mutex so
+                // the notification cannot race its sleep/check sequence.
+                LOCK(m_mutex);
+                m_master_cv.notify_one();
+            }
+        } while (true);
+    }
+
 public:
     //! Mutex to ensure only one concurrent CCheckQueueControl
     Mutex m_control_mutex;
 
     //! Create a new check queue
-    explicit CCheckQueue(unsigned int nBatchSizeIn)
-        : nBatchSize(nBatchSizeIn)
+    explicit CCheckQueue(unsigned int nBatchSizeIn, bool work_stealing = false)
+        : nBatchSize(nBatchSizeIn), m_work_stealing(work_stealing)
     {
+        if (m_work_stealing) m_shards.push_back(std::make_unique<WorkerShard>());
     }
 
     //! Create a pool of new worker threads.
@@ -148,10 +260,21 @@ public:
             fAllOk = true;
         }
         assert(m_worker_threads.empty());
+        if (m_work_stealing) {
+            assert(m_shard_todo == 0);
+            m_shards.clear();
+            for (int n = 0; n < threads_num + 1; ++n) {
+                m_shards.push_back(std::make_unique<WorkerShard>());
+            }
+        }
         for (int n = 0; n < threads_num; ++n) {
             m_worker_threads.emplace_back([this, n]() {
                 util::ThreadRename(strprintf("scriptch.%i", n));
-                Loop(false /* worker thread */);
+                if (m_work_stealing) {
+                    LoopWorkStealing(false /* worker thread */, n + 1);
+                } else {
+                    Loop(false /* worker thread */);
+                }
             });
         }
     }
@@ -159,12 +282,36 @@ public:
     //! Wait until execution finishes, and return whether all evaluations were successful.
     bool Wait()
     {
+        if (m_work_stealing) {
+            return LoopWorkStealing(true /* master thread */, 0);
+        }
         return Loop(true /* master thread */);
     }
 
     //! Add a batch of checks to the queue
     void Add(std::vector<T>& vChecks)
     {
+        if (vChecks.empty()) return;
+        if (m_work_stealing) {
+            // Account for the checks before they become grabbable, so a
+            // worker can never drive m_shard_todo below zero.
+            m_shard_todo += vChecks.size();
+            // Spread the batch over the shards in nBatchSize chunks,
+            // round-robin, so work is available to all workers up front.
+            size_t i = 0;
+            while (i < vChecks.size()) {
+                WorkerShard& shard = *m_shards[m_add_shard++ % m_shards.size()];
+                const size_t nChunk = std::min<size_t>(nBatchSize, vChecks.size() - i);
+                LOCK(shard.m_shard_mutex);
+                for (size_t j = 0; j < nChunk; ++j, ++i) {
+                    shard.m_jobs.push_back(T());
+                    vChecks[i].swap(shard.m_jobs.back());
+                }
+            }
+            LOCK(m_mutex);
+            if (nIdle > 0) m_worker_cv.notify_all();
+            return;
+        }
         LOCK(m_mutex);
         for (T& check : vChecks) {
             queue.push_back(T());
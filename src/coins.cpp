@@ -15,6 +15,16 @@ std::vector<uint256> CCoinsView::GetHeadBlocks() const { return std::vector<uint
 bool CCoinsView::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) { return false; }
 CCoinsViewCursor *CCoinsView::Cursor() const { return nullptr; }
 
+bool CCoinsView::BatchWriteShards(std::vector<CCoinsMap> &shards, const uint256 &hashBlock)
+{
+    bool fOk = true;
+    for (CCoinsMap& shard : shards) {
+        fOk = BatchWrite(shard, hashBlock) && fOk;
+    }
+    return fOk;
+}
+bool CCoinsView::BatchWriteIncremental(const CCoinsMap &shard, const uint256 &hashBlock) { return false; }
+
 bool CCoinsView::HaveCoin(const COutPoint &outpoint) const
 {
     Coin coin;
@@ -28,23 +38,34 @@ uint256 CCoinsViewBacked::GetBestBlock() const { return base->GetBestBlock(); }
 std::vector<uint256> CCoinsViewBacked::GetHeadBlocks() const { return base->GetHeadBlocks(); }
 void CCoinsViewBacked::SetBackend(CCoinsView &viewIn) { base = &viewIn; }
 bool CCoinsViewBacked::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) { return base->BatchWrite(mapCoins, hashBlock); }
+bool CCoinsViewBacked::BatchWriteShards(std::vector<CCoinsMap> &shards, const uint256 &hashBlock) { return base->BatchWriteShards(shards, hashBlock); }
+bool CCoinsViewBacked::BatchWriteIncremental(const CCoinsMap &shard, const uint256 &hashBlock) { return base->BatchWriteIncremental(shard, hashBlock); }
 CCoinsViewCursor *CCoinsViewBacked::Cursor() const { return base->Cursor(); }
 size_t CCoinsViewBacked::EstimateSize() const { return base->EstimateSize(); }
 
-CCoinsViewCache::CCoinsViewCache(CCoinsView *baseIn) : CCoinsViewBacked(baseIn), cachedCoinsUsage(0) {}
+CCoinsViewCache::CCoinsViewCache(CCoinsView *baseIn) : CCoinsViewBacked(baseIn), m_shards(COINS_CACHE_SHARDS), cachedCoinsUsage(0) {}
 
 size_t CCoinsViewCache::DynamicMemoryUsage() const {
-    return memusage::DynamicUsage(cacheCoins) + cachedCoinsUsage;
+    size_t ret = cachedCoinsUsage;
+    for (const CCoinsMap& shard : m_shards) {
+        // Both the node chunks and the bucket arrays are obtained through the
+        // shard's pool allocator, which tracks the heap bytes it holds. Note
+        // that a pool does not return chunks until its map is destroyed (see
+        // ReallocateCache), so this reports the high-water mark of the shard.
+        ret += shard.get_allocator().total_allocated_bytes();
+    }
+    return ret;
 }
 
 CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const {
-    CCoinsMap::iterator it = cacheCoins.find(outpoint);
-    if (it != cacheCoins.end())
+    CCoinsMap& map = ShardFor(outpoint);
+    CCoinsMap::iterator it = map.find(outpoint);
+    if (it != map.end())
         return it;
     Coin tmp;
     if (!base->GetCoin(outpoint, tmp))
-        return cacheCoins.end();
-    CCoinsMap::iterator ret = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::forward_as_tuple(std::move(tmp))).first;
+        return map.end();
+    CCoinsMap::iterator ret = map.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::forward_as_tuple(std::move(tmp))).first;
     if (ret->second.coin.IsSpent()) {
         // The parent only has an empty entry for this outpoint; we can consider our
         // version as fresh.
@@ -56,7 +77,7 @@ CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const
 
 bool CCoinsViewCache::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     CCoinsMap::const_iterator it = FetchCoin(outpoint);
-    if (it != cacheCoins.end()) {
+    if (it != ShardFor(outpoint).end()) {
         coin = it->second.coin;
         return !coin.IsSpent();
     }
@@ -68,7 +89,7 @@ void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possi
     if (coin.out.scriptPubKey.IsUnspendable()) return;
     CCoinsMap::iterator it;
     bool inserted;
-    std::tie(it, inserted) = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::tuple<>());
+    std::tie(it, inserted) = ShardFor(outpoint).emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::tuple<>());
     bool fresh = false;
     if (!inserted) {
         cachedCoinsUsage -= it->second.coin.DynamicMemoryUsage();
@@ -99,12 +120,24 @@ void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possi
 
 void CCoinsViewCache::EmplaceCoinInternalDANGER(COutPoint&& outpoint, Coin&& coin) {
     cachedCoinsUsage += coin.DynamicMemoryUsage();
-    cacheCoins.emplace(
+    ShardFor(outpoint).emplace(
         std::piecewise_construct,
         std::forward_as_tuple(std::move(outpoint)),
         std::forward_as_tuple(std::move(coin), CCoinsCacheEntry::DIRTY));
 }
 
+size_t CCoinsViewCache::EmplaceCoinBatchInternalDANGER(std::vector<std::pair<COutPoint, Coin>>&& coins) {
+    size_t usage = 0;
+    for (auto& [outpoint, coin] : coins) {
+        usage += coin.DynamicMemoryUsage();
+        ShardFor(outpoint).emplace(
+            std::piecewise_construct,
+            std::forward_as_tuple(std::move(outpoint)),
+            std::forward_as_tuple(std::move(coin), CCoinsCacheEntry::DIRTY));
+    }
+    return usage;
+}
+
 void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, bool check_for_overwrite) {
     bool fCoinbase = tx.IsCoinBase();
     const uint256& txid = tx.GetHash();
@@ -117,14 +150,15 @@ void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, bool
 }
 
 bool CCoinsViewCache::SpendCoin(const COutPoint &outpoint, Coin* moveout) {
+    CCoinsMap& map = ShardFor(outpoint);
     CCoinsMap::iterator it = FetchCoin(outpoint);
-    if (it == cacheCoins.end()) return false;
+    if (it == map.end()) return false;
     cachedCoinsUsage -= it->second.coin.DynamicMemoryUsage();
     if (moveout) {
         *moveout = std::move(it->second.coin);
     }
     if (it->second.flags & CCoinsCacheEntry::FRESH) {
-        cacheCoins.erase(it);
+        map.erase(it);
     } else {
         it->second.flags |= CCoinsCacheEntry::DIRTY;
         it->second.coin.Clear();
@@ -136,7 +170,7 @@ static const Coin coinEmpty;
 
 const Coin& CCoinsViewCache::AccessCoin(const COutPoint &outpoint) const {
     CCoinsMap::const_iterator it = FetchCoin(outpoint);
-    if (it == cacheCoins.end()) {
+    if (it == ShardFor(outpoint).end()) {
         return coinEmpty;
     } else {
         return it->second.coin;
@@ -145,12 +179,13 @@ const Coin& CCoinsViewCache::AccessCoin(const COutPoint &outpoint) const {
 
 bool CCoinsViewCache::HaveCoin(const COutPoint &outpoint) const {
     CCoinsMap::const_iterator it = FetchCoin(outpoint);
-    return (it != cacheCoins.end() && !it->second.coin.IsSpent());
+    return (it != ShardFor(outpoint).end() && !it->second.coin.IsSpent());
 }
 
 bool CCoinsViewCache::HaveCoinInCache(const COutPoint &outpoint) const {
-    CCoinsMap::const_iterator it = cacheCoins.find(outpoint);
-    return (it != cacheCoins.end() && !it->second.coin.IsSpent());
+    const CCoinsMap& map = ShardFor(outpoint);
+    CCoinsMap::const_iterator it = map.find(outpoint);
+    return (it != map.end() && !it->second.coin.IsSpent());
 }
 
 uint256 CCoinsViewCache::GetBestBlock() const {
@@ -163,80 +198,151 @@ void CCoinsViewCache::SetBestBlock(const uint256 &hashBlockIn) {
     hashBlock = hashBlockIn;
 }
 
+void CCoinsViewCache::MergeCacheEntry(CCoinsMap& map, const COutPoint& outpoint, CCoinsCacheEntry&& entry) {
+    CCoinsMap::iterator itUs = map.find(outpoint);
+    if (itUs == map.end()) {
+        // The parent cache does not have an entry, while the child cache does.
+        // We can ignore it if it's both spent and FRESH in the child
+        if (!(entry.flags & CCoinsCacheEntry::FRESH && entry.coin.IsSpent())) {
+            // Create the coin in the parent cache, move the data up
+            // and mark it as dirty.
+            CCoinsCacheEntry& entryUs = map[outpoint];
+            entryUs.coin = std::move(entry.coin);
+            cachedCoinsUsage += entryUs.coin.DynamicMemoryUsage();
+            entryUs.flags = CCoinsCacheEntry::DIRTY;
+            // We can mark it FRESH in the parent if it was FRESH in the child
+            // Otherwise it might have just been flushed from the parent's cache
+            // and already exist in the grandparent
+            if (entry.flags & CCoinsCacheEntry::FRESH) {
+                entryUs.flags |= CCoinsCacheEntry::FRESH;
+            }
+        }
+    } else {
+        // Found the entry in the parent cache
+        if ((entry.flags & CCoinsCacheEntry::FRESH) && !itUs->second.coin.IsSpent()) {
+            // The coin was marked FRESH in the child cache, but the coin
+            // exists in the parent cache. If this ever happens, it means
+            // the FRESH flag was misapplied and there is a logic error in
+            // the calling code.
+            throw std::logic_error("FRESH flag misapplied to coin that exists in parent cache");
+        }
+
+        if ((itUs->second.flags & CCoinsCacheEntry::FRESH) && entry.coin.IsSpent()) {
+            // The grandparent cache does not have an entry, and the coin
+            // has been spent. We can just delete it from the parent cache.
+            cachedCoinsUsage -= itUs->second.coin.DynamicMemoryUsage();
+            map.erase(itUs);
+        } else {
+            // A normal modification.
+            cachedCoinsUsage -= itUs->second.coin.DynamicMemoryUsage();
+            itUs->second.coin = std::move(entry.coin);
+            cachedCoinsUsage += itUs->second.coin.DynamicMemoryUsage();
+            itUs->second.flags |= CCoinsCacheEntry::DIRTY;
+            // NOTE: It isn't safe to mark the coin as FRESH in the parent
+            // cache. If it already existed and was spent in the parent
+            // cache then marking it FRESH would prevent that spentness
+            // from being flushed to the grandparent.
+        }
+    }
+}
+
 bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn) {
     for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end(); it = mapCoins.erase(it)) {
         // Ignore non-dirty entries (optimization).
         if (!(it->second.flags & CCoinsCacheEntry::DIRTY)) {
             continue;
         }
-        CCoinsMap::iterator itUs = cacheCoins.find(it->first);
-        if (itUs == cacheCoins.end()) {
-            // The parent cache does not have an entry, while the child cache does.
-            // We can ignore it if it's both spent and FRESH in the child
-            if (!(it->second.flags & CCoinsCacheEntry::FRESH && it->second.coin.IsSpent())) {
-                // Create the coin in the parent cache, move the data up
-                // and mark it as dirty.
-                CCoinsCacheEntry& entry = cacheCoins[it->first];
-                entry.coin = std::move(it->second.coin);
-                cachedCoinsUsage += entry.coin.DynamicMemoryUsage();
-                entry.flags = CCoinsCacheEntry::DIRTY;
-                // We can mark it FRESH in the parent if it was FRESH in the child
-                // Otherwise it might have just been flushed from the parent's cache
-                // and already exist in the grandparent
-                if (it->second.flags & CCoinsCacheEntry::FRESH) {
-                    entry.flags |= CCoinsCacheEntry::FRESH;
-                }
-            }
-        } else {
-            // Found the entry in the parent cache
-            if ((it->second.flags & CCoinsCacheEntry::FRESH) && !itUs->second.coin.IsSpent()) {
-                // The coin was marked FRESH in the child cache, but the coin
-                // exists in the parent cache. If this ever happens, it means
-                // the FRESH flag was misapplied and there is a logic error in
-                // the calling code.
-                throw std::logic_error("FRESH flag misapplied to coin that exists in parent cache");
-            }
+        MergeCacheEntry(ShardFor(it->first), it->first, std::move(it->second));
+    }
+    hashBlock = hashBlockIn;
+    return true;
+}
 
-            if ((itUs->second.flags & CCoinsCacheEntry::FRESH) && it->second.coin.IsSpent()) {
-                // The grandparent cache does not have an entry, and the coin
-                // has been spent. We can just delete it from the parent cache.
-                cachedCoinsUsage -= itUs->second.coin.DynamicMemoryUsage();
-                cacheCoins.erase(itUs);
-            } else {
-                // A normal modification.
-                cachedCoinsUsage -= itUs->second.coin.DynamicMemoryUsage();
-                itUs->second.coin = std::move(it->second.coin);
-                cachedCoinsUsage += itUs->second.coin.DynamicMemoryUsage();
-                itUs->second.flags |= CCoinsCacheEntry::DIRTY;
-                // NOTE: It isn't safe to mark the coin as FRESH in the parent
-                // cache. If it already existed and was spent in the parent
-                // cache then marking it FRESH would prevent that spentness
-                // from being flushed to the grandparent.
+bool CCoinsViewCache::BatchWriteShards(std::vector<CCoinsMap> &shards, const uint256 &hashBlockIn) {
+    // Shard selection is deterministic, so when the child uses the same shard
+    // count every entry of its shard i belongs in our shard i.
+    assert(shards.size() == m_shards.size());
+    for (size_t i = 0; i < shards.size(); ++i) {
+        CCoinsMap& shard = shards[i];
+        for (CCoinsMap::iterator it = shard.begin(); it != shard.end(); it = shard.erase(it)) {
+            // Ignore non-dirty entries (optimization).
+            if (!(it->second.flags & CCoinsCacheEntry::DIRTY)) {
+                continue;
             }
+            MergeCacheEntry(m_shards[i], it->first, std::move(it->second));
         }
     }
     hashBlock = hashBlockIn;
     return true;
 }
 
+bool CCoinsViewCache::BatchWriteIncremental(const CCoinsMap &shard, const uint256 &hashBlock) {
+    // Refuse incremental writes into a cache. The CCoinsViewBacked default
+    // would forward the shard past this cache to the base, after which the
+    // child clears its DIRTY flags — leaving this cache disagreeing with both
+    // its child and the base. Only a view directly backed by an
+    // incremental-capable base can trickle.
+    return false;
+}
+
+bool CCoinsViewCache::TrickleFlush() {
+    if (hashBlock.IsNull()) return false;
+    CCoinsMap& shard = m_shards[m_trickle_shard];
+    if (!base->BatchWriteIncremental(shard, hashBlock)) return false;
+    m_trickle_shard = (m_trickle_shard + 1) % m_shards.size();
+    // The base now has the latest state of every DIRTY entry of this shard:
+    // clear the flags so the next full flush only writes the residual set.
+    // Spent entries carry no information once persisted and are dropped;
+    // everything else stays cached (and warm), just no longer DIRTY/FRESH.
+    for (CCoinsMap::iterator it = shard.begin(); it != shard.end();) {
+        if (it->second.coin.IsSpent()) {
+            cachedCoinsUsage -= it->second.coin.DynamicMemoryUsage();
+            it = shard.erase(it);
+            continue;
+        }
+        it->second.flags = 0;
+        ++it;
+    }
+    return true;
+}
+
 bool CCoinsViewCache::Flush() {
-    bool fOk = base->BatchWrite(cacheCoins, hashBlock);
-    cacheCoins.clear();
+    bool fOk = base->BatchWriteShards(m_shards, hashBlock);
+    for (CCoinsMap& shard : m_shards) {
+        shard.clear();
+    }
     cachedCoinsUsage = 0;
     return fOk;
 }
 
 void CCoinsViewCache::Uncache(const COutPoint& hash)
 {
-    CCoinsMap::iterator it = cacheCoins.find(hash);
-    if (it != cacheCoins.end() && it->second.flags == 0) {
+    CCoinsMap& map = ShardFor(hash);
+    CCoinsMap::iterator it = map.find(hash);
+    if (it != map.end() && it->second.flags == 0) {
         cachedCoinsUsage -= it->second.coin.DynamicMemoryUsage();
-        cacheCoins.erase(it);
+        map.erase(it);
     }
 }
 
 unsigned int CCoinsViewCache::GetCacheSize() const {
-    return cacheCoins.size();
+    size_t ret = 0;
+    for (const CCoinsMap& shard : m_shards) {
+        ret += shard.size();
+    }
+    return ret;
+}
+
+std::vector<COutPoint> CCoinsViewCache::GetCachedOutpoints() const
+{
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(GetCacheSize());
+    for (const CCoinsMap& shard : m_shards) {
+        for (const auto& entry : shard) {
+            if (!entry.second.coin.IsSpent()) outpoints.push_back(entry.first);
+        }
+    }
+    return outpoints;
 }
 
 bool CCoinsViewCache::HaveInputs(const CTransaction& tx) const
@@ -254,9 +360,10 @@ bool CCoinsViewCache::HaveInputs(const CTransaction& tx) const
 void CCoinsViewCache::ReallocateCache()
 {
     // Cache should be empty when we're calling this.
-    assert(cacheCoins.size() == 0);
-    cacheCoins.~CCoinsMap();
-    ::new (&cacheCoins) CCoinsMap();
+    assert(GetCacheSize() == 0);
+    m_shards.clear();
+    m_shards.shrink_to_fit();
+    m_shards.resize(COINS_CACHE_SHARDS);
 }
 
 static const size_t MIN_TRANSACTION_OUTPUT_WEIGHT = WITNESS_SCALE_FACTOR * ::GetSerializeSize(CTxOut(), PROTOCOL_VERSION);
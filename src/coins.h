@@ -11,6 +11,7 @@
 #include <memusage.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
+#include <support/allocators/pool.h>
 #include <uint256.h>
 #include <util/hasher.h>
 
@@ -130,7 +131,21 @@ struct CCoinsCacheEntry
     CCoinsCacheEntry(Coin&& coin_, unsigned char flag) : coin(std::move(coin_)), flags(flag) {}
 };
 
-typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
+/**
+ * In-memory cache entries, keyed by outpoint. The map nodes are carved out of
+ * contiguous pool chunks (see pool_allocator) instead of being allocated one
+ * by one: dropping the per-node heap header and rounding shrinks every cached
+ * coin by roughly the size of a small script, so the same -dbcache holds
+ * measurably more coins. Each map owns its pool, and the dominant script
+ * patterns (P2PKH, P2SH, P2WPKH) fit the prevector inside CTxOut, so a whole
+ * entry - key, coin and script - lives in one pooled block.
+ */
+typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher, std::equal_to<COutPoint>,
+                           pool_allocator<std::pair<const COutPoint, CCoinsCacheEntry>>> CCoinsMap;
+
+//! Number of independent segments a CCoinsViewCache splits its map into.
+//! Must be a power of two.
+static constexpr size_t COINS_CACHE_SHARDS{16};
 
 /** Cursor for iterating over CoinsView state */
 class CCoinsViewCursor
@@ -178,6 +193,18 @@ public:
     //! The passed mapCoins can be modified.
     virtual bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock);
 
+    //! Do a bulk modification from a sharded cache. The default implementation
+    //! forwards each shard to BatchWrite() in turn; views that need to commit
+    //! all shards under a single consistency protocol (e.g. CCoinsViewDB)
+    //! override this. The passed shards can be modified.
+    virtual bool BatchWriteShards(std::vector<CCoinsMap> &shards, const uint256 &hashBlock);
+
+    //! Persist the DIRTY entries of one cache segment without consuming them
+    //! and without completing a best-block transition, as an incremental step
+    //! of a larger flush. Returns false if the view does not support
+    //! incremental writes (the default), in which case nothing was written.
+    virtual bool BatchWriteIncremental(const CCoinsMap &shard, const uint256 &hashBlock);
+
     //! Get a cursor to iterate over the whole state
     virtual CCoinsViewCursor *Cursor() const;
 
@@ -203,6 +230,8 @@ public:
     std::vector<uint256> GetHeadBlocks() const override;
     void SetBackend(CCoinsView &viewIn);
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+    bool BatchWriteShards(std::vector<CCoinsMap> &shards, const uint256 &hashBlock) override;
+    bool BatchWriteIncremental(const CCoinsMap &shard, const uint256 &hashBlock) override;
     CCoinsViewCursor *Cursor() const override;
     size_t EstimateSize() const override;
 };
@@ -217,11 +246,28 @@ protected:
      * declared as "const".
      */
     mutable uint256 hashBlock;
-    mutable CCoinsMap cacheCoins;
+
+    /**
+     * The cached coins, sharded by outpoint into COINS_CACHE_SHARDS
+     * independent maps. Keeping the segments separate removes the
+     * single-hashtable bottleneck: parallel input fetching can operate on
+     * disjoint shards, and the flush path consumes them one at a time
+     * instead of walking (and pinning) one giant map.
+     */
+    mutable std::vector<CCoinsMap> m_shards;
 
     /* Cached dynamic memory usage for the inner Coin objects. */
     mutable size_t cachedCoinsUsage;
 
+    //! The next shard TrickleFlush() will push to the base.
+    size_t m_trickle_shard{0};
+
+    //! The shard an outpoint belongs to.
+    CCoinsMap& ShardFor(const COutPoint& outpoint) const
+    {
+        return m_shards[ShardIndexFor(outpoint)];
+    }
+
 public:
     CCoinsViewCache(CCoinsView *baseIn);
 
@@ -236,6 +282,8 @@ public:
     uint256 GetBestBlock() const override;
     void SetBestBlock(const uint256 &hashBlock);
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+    bool BatchWriteShards(std::vector<CCoinsMap> &shards, const uint256 &hashBlock) override;
+    bool BatchWriteIncremental(const CCoinsMap &shard, const uint256 &hashBlock) override;
     CCoinsViewCursor* Cursor() const override {
         throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
     }
@@ -266,7 +314,7 @@ public:
     void AddCoin(const COutPoint& outpoint, Coin&& coin, bool possible_overwrite);
 
     /**
-     * Emplace a coin into cacheCoins without performing any checks, marking
+     * Emplace a coin into the cache without performing any checks, marking
      * the emplaced coin as dirty.
      *
      * NOT FOR GENERAL USE. Used only when loading coins from a UTXO snapshot.
@@ -274,6 +322,34 @@ public:
      */
     void EmplaceCoinInternalDANGER(COutPoint&& outpoint, Coin&& coin);
 
+    /**
+     * Emplace a batch of coins without performing any checks, marking them
+     * DIRTY, and return the dynamic usage of the emplaced coins. Unlike the
+     * rest of this class this may be called from multiple threads at once,
+     * provided no two concurrent calls carry coins of the same shard (route
+     * batches with ShardIndexFor()) and the returned usage is accounted back
+     * via AddCoinsUsageDANGER() before any other use of the cache.
+     *
+     * NOT FOR GENERAL USE. Used only when loading coins from a UTXO snapshot.
+     * @sa ChainstateManager::PopulateAndValidateSnapshot()
+     */
+    size_t EmplaceCoinBatchInternalDANGER(std::vector<std::pair<COutPoint, Coin>>&& coins);
+
+    //! Account the usage returned by EmplaceCoinBatchInternalDANGER().
+    //! NOT FOR GENERAL USE, see above.
+    void AddCoinsUsageDANGER(size_t usage) { cachedCoinsUsage += usage; }
+
+    /**
+     * The index of the shard an outpoint maps to; stable across caches.
+     * Selection uses a raw word of the (uniformly distributed) txid, so all
+     * outputs of a transaction share a shard; bucket placement inside each
+     * shard remains salted.
+     */
+    static size_t ShardIndexFor(const COutPoint& outpoint)
+    {
+        return outpoint.hash.GetUint64(0) & (COINS_CACHE_SHARDS - 1);
+    }
+
     /**
      * Spend a coin. Pass moveto in order to get the deleted data.
      * If no unspent output exists for the passed outpoint, this call
@@ -288,6 +364,16 @@ public:
      */
     bool Flush();
 
+    /**
+     * Push the DIRTY entries of one shard (round-robin across calls) to the
+     * base without evicting them, spreading the cost of a large flush over
+     * many small steps. Flushed entries stay cached (cleared to non-DIRTY);
+     * spent ones are dropped. The base is left mid-transition; a later full
+     * Flush() completes it. Returns false (and changes nothing) if the base
+     * does not support incremental writes.
+     */
+    bool TrickleFlush();
+
     /**
      * Removes the UTXO with the given outpoint from the cache, if it is
      * not modified.
@@ -297,6 +383,11 @@ public:
     //! Calculate the size of the cache (in number of transaction outputs)
     unsigned int GetCacheSize() const;
 
+    //! Collect the outpoints of the unspent coins currently held in the
+    //! cache. Used to persist the hot set at shutdown so the next startup
+    //! can prewarm the cache, see DumpCoinsCacheHotSet().
+    std::vector<COutPoint> GetCachedOutpoints() const;
+
     //! Calculate the size of the cache (in bytes)
     size_t DynamicMemoryUsage() const;
 
@@ -312,10 +403,13 @@ public:
 
 private:
     /**
-     * @note this is marked const, but may actually append to `cacheCoins`, increasing
-     * memory usage.
+     * @note this is marked const, but may actually append to the outpoint's
+     * shard, increasing memory usage.
      */
     CCoinsMap::iterator FetchCoin(const COutPoint &outpoint) const;
+
+    //! Merge a single dirty child entry into the given shard of this cache.
+    void MergeCacheEntry(CCoinsMap& map, const COutPoint& outpoint, CCoinsCacheEntry&& entry);
 };
 
 //! Utility function to add all of a transaction's outputs to a cache.
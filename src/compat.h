@@ -97,6 +97,14 @@ typedef char* sockopt_arg_type;
 #define USE_POLL
 #endif
 
+// Readiness backends whose wait cost is independent of the number of open
+// sockets; preferred over poll/select by the net code when available.
+#if defined(__linux__)
+#define USE_EPOLL
+#elif defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__) || defined(__APPLE__)
+#define USE_KQUEUE
+#endif
+
 bool static inline IsSelectableSocket(const SOCKET& s) {
 #if defined(USE_POLL) || defined(WIN32)
     return true;
@@ -190,3 +190,109 @@ uint64_t DecompressAmount(uint64_t x)
     }
     return n;
 }
+
+namespace {
+
+constexpr size_t LZSS_WINDOW{4096};
+constexpr size_t LZSS_MIN_MATCH{3};
+constexpr size_t LZSS_MAX_MATCH{18};
+constexpr unsigned LZSS_HASH_BITS{13};
+constexpr uint32_t LZSS_NO_POS{0xffffffff};
+
+//! Multiplicative hash of the next three input bytes.
+uint32_t LZSSHash(const unsigned char* p)
+{
+    uint32_t v = p[0] | (uint32_t{p[1]} << 8) | (uint32_t{p[2]} << 16);
+    return (v * 2654435761u) >> (32 - LZSS_HASH_BITS);
+}
+
+} // namespace
+
+std::vector<unsigned char> LZSSCompress(Span<const unsigned char> data)
+{
+    std::vector<unsigned char> out;
+    if (data.empty()) return out;
+    out.reserve(data.size());
+
+    // Most recent position of each three-byte hash; a single probe keeps
+    // compression fast at a small cost in ratio.
+    std::vector<uint32_t> table(size_t{1} << LZSS_HASH_BITS, LZSS_NO_POS);
+
+    const unsigned char* const begin = data.data();
+    size_t pos = 0;
+    size_t flags_at = out.size();
+    out.push_back(0);
+    int ntokens = 0;
+
+    while (pos < data.size()) {
+        if (ntokens == 8) {
+            flags_at = out.size();
+            out.push_back(0);
+            ntokens = 0;
+        }
+
+        size_t match_len = 0;
+        size_t match_dist = 0;
+        if (pos + LZSS_MIN_MATCH <= data.size()) {
+            const uint32_t h = LZSSHash(begin + pos);
+            const uint32_t cand = table[h];
+            table[h] = pos;
+            if (cand != LZSS_NO_POS && pos - cand <= LZSS_WINDOW) {
+                const size_t max_len = std::min(LZSS_MAX_MATCH, data.size() - pos);
+                size_t len = 0;
+                while (len < max_len && begin[cand + len] == begin[pos + len]) ++len;
+                if (len >= LZSS_MIN_MATCH) {
+                    match_len = len;
+                    match_dist = pos - cand;
+                }
+            }
+        }
+
+        if (match_len) {
+            out[flags_at] |= 1 << ntokens;
+            const uint32_t d = match_dist - 1;
+            out.push_back(d & 0xff);
+            out.push_back(((d >> 8) & 0x0f) | ((match_len - LZSS_MIN_MATCH) << 4));
+            // Seed the table with the positions the match skips over.
+            for (size_t k = 1; k < match_len && pos + k + LZSS_MIN_MATCH <= data.size(); ++k) {
+                table[LZSSHash(begin + pos + k)] = pos + k;
+            }
+            pos += match_len;
+        } else {
+            out.push_back(begin[pos]);
+            ++pos;
+        }
+        ++ntokens;
+    }
+    return out;
+}
+
+bool LZSSDecompress(Span<const unsigned char> data, std::vector<unsigned char>& out, size_t max_size)
+{
+    out.clear();
+    size_t pos = 0;
+    while (pos < data.size()) {
+        const unsigned char flags = data[pos++];
+        for (int bit = 0; bit < 8 && pos < data.size(); ++bit) {
+            if (flags & (1 << bit)) {
+                if (pos + 2 > data.size()) return false;
+                const uint32_t b0 = data[pos];
+                const uint32_t b1 = data[pos + 1];
+                pos += 2;
+                const size_t dist = (b0 | ((b1 & 0x0f) << 8)) + 1;
+                const size_t len = (b1 >> 4) + LZSS_MIN_MATCH;
+                if (dist > out.size()) return false;
+                if (out.size() + len > max_size) return false;
+                // Copy byte by byte: matches may overlap their own output.
+                const size_t from = out.size() - dist;
+                for (size_t k = 0; k < len; ++k) {
+                    out.push_back(out[from + k]);
+                }
+            } else {
+                if (out.size() + 1 > max_size) return false;
+                out.push_back(data[pos++]);
+            }
+        }
+    }
+    return true;
+}
@@ -28,6 +28,25 @@ uint64_t CompressAmount(uint64_t nAmount);
 
 uint64_t DecompressAmount(uint64_t nAmount);
 
+/**
+ * Self-contained LZSS byte-stream compression, used for optional undo-data
+ * compression (-compressundo). Deliberately simple so no external
+ * compression library is required.
+ *
+ * Format: groups of up to eight tokens, each group preceded by a flags byte
+ * (LSB first, bit set = back-reference). A literal token is one byte. A
+ * back-reference token is two bytes encoding a distance of 1..4096 and a
+ * length of 3..18: byte0 holds the low bits of distance-1, byte1 holds the
+ * high nibble of distance-1 in its low bits and length-3 in its high bits.
+ */
+std::vector<unsigned char> LZSSCompress(Span<const unsigned char> data);
+
+/**
+ * Inverse of LZSSCompress. Returns false if the stream is malformed or the
+ * output would exceed max_size; out is cleared first.
+ */
+bool LZSSDecompress(Span<const unsigned char> data, std::vector<unsigned char>& out, size_t max_size);
+
 /** Compact serializer for scripts.
  *
  *  It detects common cases and encodes them much more efficiently.
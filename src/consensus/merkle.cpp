@@ -5,6 +5,9 @@
 #include <consensus/merkle.h>
 #include <hash.h>
 
+#include <assert.h>
+#include <future>
+
 /*     WARNING! If you're reading this because you're learning about crypto
        and/or designing a new system that will use merkle trees, keep in mind
        that the following merkle tree algorithm has a serious flaw related to
@@ -42,8 +45,85 @@
 */
 
 
-uint256 ComputeMerkleRoot(std::vector<uint256> hashes, bool* mutated) {
+namespace {
+/** Reduce [hashes, hashes + count) in place through `levels` tree levels,
+ *  using the same per-level rules (including duplication of an odd level's
+ *  last entry) as ComputeMerkleRoot. A partial subtree whose width reaches 1
+ *  early keeps being duplicate-hashed with itself on the remaining levels,
+ *  exactly as the whole tree lifts its (odd) tail node — stopping at the
+ *  first single hash would hand a node from the wrong level to the caller.
+ *  The buffer must have room for one entry past count. If mutation is
+ *  non-null, it is set to true when two identical pre-existing hashes are
+ *  paired. Returns the number of remaining hashes (1, or 0 if count was 0). */
+size_t MerkleReduce(uint256* hashes, size_t count, size_t levels, bool* mutation)
+{
+    for (size_t level = 0; level < levels && count > 0; ++level) {
+        if (mutation) {
+            for (size_t pos = 0; pos + 1 < count; pos += 2) {
+                if (hashes[pos] == hashes[pos + 1]) *mutation = true;
+            }
+        }
+        if (count & 1) {
+            hashes[count] = hashes[count - 1];
+            ++count;
+        }
+        SHA256D64(hashes[0].begin(), hashes[0].begin(), count / 2);
+        count /= 2;
+    }
+    return count;
+}
+} // namespace
+
+uint256 ComputeMerkleRoot(std::vector<uint256> hashes, bool* mutated, int worker_threads) {
     bool mutation = false;
+
+    // With enough leaves and more than one thread requested, split the leaf
+    // array into contiguous subtrees of a power-of-two size and reduce each on
+    // its own thread. Because every subtree but the last is a full power of
+    // two, its root equals the corresponding inner node of the whole tree, and
+    // the last (possibly partial) subtree sees exactly the duplications the
+    // whole tree would perform on its tail. The subtree roots are then
+    // combined serially below.
+    constexpr size_t MIN_SUBTREE_LEAVES{1024};
+    if (worker_threads > 1 && hashes.size() >= 2 * MIN_SUBTREE_LEAVES) {
+        const size_t n_leaves = hashes.size();
+        size_t subtree_size = MIN_SUBTREE_LEAVES;
+        while (subtree_size * 2 * static_cast<size_t>(worker_threads) <= n_leaves) subtree_size *= 2;
+        const size_t num_subtrees = (n_leaves + subtree_size - 1) / subtree_size;
+        size_t subtree_levels{0};
+        while ((subtree_size >> subtree_levels) > 1) ++subtree_levels;
+        // Reducing an odd number of hashes writes one entry past the end of
+        // the range; make room for the last subtree to do so.
+        if (n_leaves % subtree_size) hashes.emplace_back();
+
+        const size_t num_workers = std::min<size_t>(worker_threads, num_subtrees);
+        const auto reduce_subtrees = [&hashes, n_leaves, subtree_size, subtree_levels, mutated](size_t subtree_begin, size_t subtree_end) {
+            bool worker_mutation = false;
+            for (size_t i = subtree_begin; i < subtree_end; ++i) {
+                const size_t offset = i * subtree_size;
+                const size_t count = std::min(subtree_size, n_leaves - offset);
+                size_t reduced = MerkleReduce(&hashes[offset], count, subtree_levels, mutated ? &worker_mutation : nullptr);
+                assert(reduced == 1);
+            }
+            return worker_mutation;
+        };
+        std::vector<std::future<bool>> workers;
+        workers.reserve(num_workers - 1);
+        for (size_t w = 1; w < num_workers; ++w) {
+            workers.push_back(std::async(std::launch::async, reduce_subtrees,
+                                         w * num_subtrees / num_workers, (w + 1) * num_subtrees / num_workers));
+        }
+        mutation |= reduce_subtrees(0, num_subtrees / num_workers);
+        for (auto& worker : workers) mutation |= worker.get();
+
+        // Compact the subtree roots to the front and fall through to the
+        // serial reduction of the remaining levels.
+        for (size_t i = 0; i < num_subtrees; ++i) {
+            hashes[i] = hashes[i * subtree_size];
+        }
+        hashes.resize(num_subtrees);
+    }
+
     while (hashes.size() > 1) {
         if (mutated) {
             for (size_t pos = 0; pos + 1 < hashes.size(); pos += 2) {
@@ -62,17 +142,17 @@ uint256 ComputeMerkleRoot(std::vector<uint256> hashes, bool* mutated) {
 }
 
 
-uint256 BlockMerkleRoot(const CBlock& block, bool* mutated)
+uint256 BlockMerkleRoot(const CBlock& block, bool* mutated, int worker_threads)
 {
     std::vector<uint256> leaves;
     leaves.resize(block.vtx.size());
     for (size_t s = 0; s < block.vtx.size(); s++) {
         leaves[s] = block.vtx[s]->GetHash();
     }
-    return ComputeMerkleRoot(std::move(leaves), mutated);
+    return ComputeMerkleRoot(std::move(leaves), mutated, worker_threads);
 }
 
-uint256 BlockWitnessMerkleRoot(const CBlock& block, bool* mutated)
+uint256 BlockWitnessMerkleRoot(const CBlock& block, bool* mutated, int worker_threads)
 {
     std::vector<uint256> leaves;
     leaves.resize(block.vtx.size());
@@ -80,6 +160,6 @@ uint256 BlockWitnessMerkleRoot(const CBlock& block, bool* mutated)
     for (size_t s = 1; s < block.vtx.size(); s++) {
         leaves[s] = block.vtx[s]->GetWitnessHash();
     }
-    return ComputeMerkleRoot(std::move(leaves), mutated);
+    return ComputeMerkleRoot(std::move(leaves), mutated, worker_threads);
 }
 
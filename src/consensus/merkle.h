@@ -10,18 +10,24 @@
 #include <primitives/block.h>
 #include <uint256.h>
 
-uint256 ComputeMerkleRoot(std::vector<uint256> hashes, bool* mutated = nullptr);
+/*
+ * Compute the Merkle root of the given hashes.
+ * *mutated is set to true if a duplicated subtree was found.
+ * If worker_threads is greater than 1 and there are enough hashes, the leaf
+ * array is split into subtrees that are hashed on that many parallel threads.
+ */
+uint256 ComputeMerkleRoot(std::vector<uint256> hashes, bool* mutated = nullptr, int worker_threads = 0);
 
 /*
  * Compute the Merkle root of the transactions in a block.
  * *mutated is set to true if a duplicated subtree was found.
  */
-uint256 BlockMerkleRoot(const CBlock& block, bool* mutated = nullptr);
+uint256 BlockMerkleRoot(const CBlock& block, bool* mutated = nullptr, int worker_threads = 0);
 
 /*
  * Compute the Merkle root of the witness transactions in a block.
  * *mutated is set to true if a duplicated subtree was found.
  */
-uint256 BlockWitnessMerkleRoot(const CBlock& block, bool* mutated = nullptr);
+uint256 BlockWitnessMerkleRoot(const CBlock& block, bool* mutated = nullptr, int worker_threads = 0);
 
 #endif // BITCOIN_CONSENSUS_MERKLE_H
@@ -7,9 +7,53 @@
 
 #include <crypto/common.h>
 #include <crypto/chacha20.h>
+#include <compat/cpuid.h>
 
 #include <string.h>
 
+#if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
+namespace chacha20_avx2
+{
+void Crypt4(const uint32_t* input, const unsigned char* in, unsigned char* out);
+}
+#endif
+
+namespace
+{
+/** Function to compute 4 consecutive cipher blocks at once, or nullptr if no
+ *  specialized implementation is available. Selected by ChaCha20AutoDetect. */
+typedef void (*Crypt4Type)(const uint32_t* input, const unsigned char* in, unsigned char* out);
+Crypt4Type Crypt4 = nullptr;
+
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+bool AVXEnabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+#endif
+} // namespace
+
+std::string ChaCha20AutoDetect()
+{
+    std::string ret = "standard";
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID) && !defined(BUILD_BITCOIN_INTERNAL)
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    bool have_xsave = (ecx >> 27) & 1;
+    bool have_avx = (ecx >> 28) & 1;
+    if (have_xsave && have_avx && AVXEnabled()) {
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        if ((ebx >> 5) & 1) {
+            Crypt4 = chacha20_avx2::Crypt4;
+            ret = "avx2(4way)";
+        }
+    }
+#endif
+    return ret;
+}
+
 constexpr static inline uint32_t rotl32(uint32_t v, int c) { return (v << c) | (v >> (32 - c)); }
 
 #define QUARTERROUND(a,b,c,d) \
@@ -81,6 +125,15 @@ void ChaCha20::Keystream(unsigned char* c, size_t bytes)
 
     if (!bytes) return;
 
+    while (Crypt4 && bytes >= 256) {
+        Crypt4(input, nullptr, c);
+        input[12] += 4;
+        if (input[12] < 4) ++input[13];
+        c += 256;
+        bytes -= 256;
+    }
+    if (!bytes) return;
+
     j0 = input[0];
     j1 = input[1];
     j2 = input[2];
@@ -189,6 +242,16 @@ void ChaCha20::Crypt(const unsigned char* m, unsigned char* c, size_t bytes)
 
     if (!bytes) return;
 
+    while (Crypt4 && bytes >= 256) {
+        Crypt4(input, m, c);
+        input[12] += 4;
+        if (input[12] < 4) ++input[13];
+        m += 256;
+        c += 256;
+        bytes -= 256;
+    }
+    if (!bytes) return;
+
     j0 = input[0];
     j1 = input[1];
     j2 = input[2];
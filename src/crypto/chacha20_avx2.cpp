@@ -0,0 +1,119 @@
+// Copyright (c) 2021 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace chacha20_avx2 {
+namespace {
+
+// Each __m256i holds one row of the ChaCha20 state matrix for two blocks,
+// one block per 128-bit lane. The quarter rounds act on whole rows, and the
+// diagonalization between column and diagonal rounds is a per-lane word
+// rotation, so the two lanes never interact. Two such block pairs are
+// processed in an interleaved fashion to cover the latency of the
+// add/xor/rotate dependency chain, for four blocks per call.
+
+inline __m256i Add(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+inline __m256i Xor(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+
+inline __m256i Rotl16(__m256i x)
+{
+    const __m256i mask = _mm256_set_epi8(
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+    return _mm256_shuffle_epi8(x, mask);
+}
+
+inline __m256i Rotl8(__m256i x)
+{
+    const __m256i mask = _mm256_set_epi8(
+        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
+    return _mm256_shuffle_epi8(x, mask);
+}
+
+inline __m256i Rotl12(__m256i x) { return _mm256_or_si256(_mm256_slli_epi32(x, 12), _mm256_srli_epi32(x, 20)); }
+inline __m256i Rotl7(__m256i x) { return _mm256_or_si256(_mm256_slli_epi32(x, 7), _mm256_srli_epi32(x, 25)); }
+
+/** Write one block (the requested 128-bit lane of rows r0..r3) to out, xoring with in if non-null. */
+inline void WriteBlock(unsigned char* out, const unsigned char* in, __m128i r0, __m128i r1, __m128i r2, __m128i r3)
+{
+    if (in) {
+        r0 = _mm_xor_si128(r0, _mm_loadu_si128((const __m128i*)(in + 0)));
+        r1 = _mm_xor_si128(r1, _mm_loadu_si128((const __m128i*)(in + 16)));
+        r2 = _mm_xor_si128(r2, _mm_loadu_si128((const __m128i*)(in + 32)));
+        r3 = _mm_xor_si128(r3, _mm_loadu_si128((const __m128i*)(in + 48)));
+    }
+    _mm_storeu_si128((__m128i*)(out + 0), r0);
+    _mm_storeu_si128((__m128i*)(out + 16), r1);
+    _mm_storeu_si128((__m128i*)(out + 32), r2);
+    _mm_storeu_si128((__m128i*)(out + 48), r3);
+}
+
+} // namespace
+
+/** Compute 4 consecutive ChaCha20 blocks for the state in `input` (the block
+ *  counter in words 12/13 is used for the first block and incremented
+ *  internally for the other three; the caller advances its own copy). The 256
+ *  output bytes are written to `out`, xored with `in` unless it is null. */
+void Crypt4(const uint32_t* input, const unsigned char* in, unsigned char* out)
+{
+    const __m256i j0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(input + 0)));
+    const __m256i j1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(input + 4)));
+    const __m256i j2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(input + 8)));
+    const __m256i j3 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(input + 12)));
+
+    // Words 12/13 are a 64-bit little-endian block counter occupying the low
+    // qword of each lane of row 3; bump it per block with a 64-bit add so the
+    // carry into word 13 is handled.
+    const __m256i j3a = _mm256_add_epi64(j3, _mm256_set_epi64x(0, 1, 0, 0)); // blocks +0, +1
+    const __m256i j3b = _mm256_add_epi64(j3, _mm256_set_epi64x(0, 3, 0, 2)); // blocks +2, +3
+
+    __m256i a0 = j0, a1 = j1, a2 = j2, a3 = j3a;
+    __m256i b0 = j0, b1 = j1, b2 = j2, b3 = j3b;
+
+    for (int i = 0; i < 10; ++i) {
+        // Column rounds.
+        a0 = Add(a0, a1); b0 = Add(b0, b1); a3 = Rotl16(Xor(a3, a0)); b3 = Rotl16(Xor(b3, b0));
+        a2 = Add(a2, a3); b2 = Add(b2, b3); a1 = Rotl12(Xor(a1, a2)); b1 = Rotl12(Xor(b1, b2));
+        a0 = Add(a0, a1); b0 = Add(b0, b1); a3 = Rotl8(Xor(a3, a0)); b3 = Rotl8(Xor(b3, b0));
+        a2 = Add(a2, a3); b2 = Add(b2, b3); a1 = Rotl7(Xor(a1, a2)); b1 = Rotl7(Xor(b1, b2));
+        // Diagonalize.
+        a1 = _mm256_shuffle_epi32(a1, 0x39); b1 = _mm256_shuffle_epi32(b1, 0x39);
+        a2 = _mm256_shuffle_epi32(a2, 0x4e); b2 = _mm256_shuffle_epi32(b2, 0x4e);
+        a3 = _mm256_shuffle_epi32(a3, 0x93); b3 = _mm256_shuffle_epi32(b3, 0x93);
+        // Diagonal rounds.
+        a0 = Add(a0, a1); b0 = Add(b0, b1); a3 = Rotl16(Xor(a3, a0)); b3 = Rotl16(Xor(b3, b0));
+        a2 = Add(a2, a3); b2 = Add(b2, b3); a1 = Rotl12(Xor(a1, a2)); b1 = Rotl12(Xor(b1, b2));
+        a0 = Add(a0, a1); b0 = Add(b0, b1); a3 = Rotl8(Xor(a3, a0)); b3 = Rotl8(Xor(b3, b0));
+        a2 = Add(a2, a3); b2 = Add(b2, b3); a1 = Rotl7(Xor(a1, a2)); b1 = Rotl7(Xor(b1, b2));
+        // Undo the diagonalization.
+        a1 = _mm256_shuffle_epi32(a1, 0x93); b1 = _mm256_shuffle_epi32(b1, 0x93);
+        a2 = _mm256_shuffle_epi32(a2, 0x4e); b2 = _mm256_shuffle_epi32(b2, 0x4e);
+        a3 = _mm256_shuffle_epi32(a3, 0x39); b3 = _mm256_shuffle_epi32(b3, 0x39);
+    }
+
+    a0 = Add(a0, j0); a1 = Add(a1, j1); a2 = Add(a2, j2); a3 = Add(a3, j3a);
+    b0 = Add(b0, j0); b1 = Add(b1, j1); b2 = Add(b2, j2); b3 = Add(b3, j3b);
+
+    WriteBlock(out + 0, in ? in + 0 : nullptr,
+               _mm256_castsi256_si128(a0), _mm256_castsi256_si128(a1),
+               _mm256_castsi256_si128(a2), _mm256_castsi256_si128(a3));
+    WriteBlock(out + 64, in ? in + 64 : nullptr,
+               _mm256_extracti128_si256(a0, 1), _mm256_extracti128_si256(a1, 1),
+               _mm256_extracti128_si256(a2, 1), _mm256_extracti128_si256(a3, 1));
+    WriteBlock(out + 128, in ? in + 128 : nullptr,
+               _mm256_castsi256_si128(b0), _mm256_castsi256_si128(b1),
+               _mm256_castsi256_si128(b2), _mm256_castsi256_si128(b3));
+    WriteBlock(out + 192, in ? in + 192 : nullptr,
+               _mm256_extracti128_si256(b0, 1), _mm256_extracti128_si256(b1, 1),
+               _mm256_extracti128_si256(b2, 1), _mm256_extracti128_si256(b3, 1));
+}
+
+} // namespace chacha20_avx2
+
+#endif // ENABLE_AVX2
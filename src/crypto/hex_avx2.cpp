@@ -0,0 +1,48 @@
+// Copyright (c) 2021 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <immintrin.h>
+
+#include <cstddef>
+
+namespace hex_avx2 {
+
+/** Hex-encode `len` bytes from `in` into 2*len characters at `out`.
+ *
+ * Same nibble-shuffle scheme as the SSE4.1 variant but 32 input bytes per
+ * iteration. VPSHUFB and the byte unpacks operate within 128-bit lanes, so
+ * after interleaving the digit pairs the lanes are reordered with two
+ * VPERM2I128 to restore output order.
+ */
+void Encode(const unsigned char* in, size_t len, char* out)
+{
+    const __m256i lut = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                      '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), mask);
+        __m256i lo = _mm256_and_si256(v, mask);
+        __m256i c_hi = _mm256_shuffle_epi8(lut, hi);
+        __m256i c_lo = _mm256_shuffle_epi8(lut, lo);
+        __m256i ilo = _mm256_unpacklo_epi8(c_hi, c_lo);
+        __m256i ihi = _mm256_unpackhi_epi8(c_hi, c_lo);
+        _mm256_storeu_si256((__m256i*)(out + 2 * i), _mm256_permute2x128_si256(ilo, ihi, 0x20));
+        _mm256_storeu_si256((__m256i*)(out + 2 * i + 32), _mm256_permute2x128_si256(ilo, ihi, 0x31));
+    }
+    static constexpr char hexmap[16] = {'0', '1', '2', '3', '4', '5', '6', '7',
+                                        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+    for (; i < len; ++i) {
+        out[2 * i] = hexmap[in[i] >> 4];
+        out[2 * i + 1] = hexmap[in[i] & 15];
+    }
+}
+
+} // namespace hex_avx2
+
+#endif
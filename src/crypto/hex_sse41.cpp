@@ -0,0 +1,45 @@
+// Copyright (c) 2021 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_SSE41
+
+#include <immintrin.h>
+
+#include <cstddef>
+
+namespace hex_sse41 {
+
+/** Hex-encode `len` bytes from `in` into 2*len characters at `out`.
+ *
+ * Sixteen input bytes are expanded per iteration: the high and low nibbles
+ * are split with a shift and mask, mapped to their ASCII digits with a
+ * single PSHUFB each against a 16-entry lookup register, and interleaved
+ * back into output order with byte unpacks.
+ */
+void Encode(const unsigned char* in, size_t len, char* out)
+{
+    const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                      '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+        __m128i lo = _mm_and_si128(v, mask);
+        __m128i c_hi = _mm_shuffle_epi8(lut, hi);
+        __m128i c_lo = _mm_shuffle_epi8(lut, lo);
+        _mm_storeu_si128((__m128i*)(out + 2 * i), _mm_unpacklo_epi8(c_hi, c_lo));
+        _mm_storeu_si128((__m128i*)(out + 2 * i + 16), _mm_unpackhi_epi8(c_hi, c_lo));
+    }
+    static constexpr char hexmap[16] = {'0', '1', '2', '3', '4', '5', '6', '7',
+                                        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+    for (; i < len; ++i) {
+        out[2 * i] = hexmap[in[i] >> 4];
+        out[2 * i + 1] = hexmap[in[i] & 15];
+    }
+}
+
+} // namespace hex_sse41
+
+#endif
@@ -341,6 +341,9 @@ MuHash3072& MuHash3072::Insert(Span<const unsigned char> in) noexcept {
 }
 
 MuHash3072& MuHash3072::Remove(Span<const unsigned char> in) noexcept {
-    m_numerator.Divide(ToNum3072(in));
+    // Rather than computing a modular inverse here (~4500 multiplications via
+    // GetInverse), multiply the removed element into the denominator. The
+    // single division in Finalize resolves all removals at once.
+    m_denominator.Multiply(ToNum3072(in));
     return *this;
 }
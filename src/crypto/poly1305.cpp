@@ -8,6 +8,8 @@
 #include <crypto/common.h>
 #include <crypto/poly1305.h>
 
+#include <support/cleanse.h>
+
 #include <string.h>
 
 #define mul32x32_64(a,b) ((uint64_t)(a) * (b))
@@ -139,3 +141,286 @@ poly1305_donna_finish:
     WriteLE32(&out[ 8], f2); f3 += (f2 >> 32);
     WriteLE32(&out[12], f3);
 }
+
+// Incremental interface. The 64-bit limb variant is based on the public
+// domain poly1305-donna-64.h by Andrew Moon; the fallback uses the same
+// 26-bit radix arithmetic as poly1305_auth above.
+
+#ifdef __SIZEOF_INT128__
+
+Poly1305::Poly1305(const unsigned char key[POLY1305_KEYLEN])
+{
+    uint64_t t0 = ReadLE64(key + 0);
+    uint64_t t1 = ReadLE64(key + 8);
+
+    /* clamp key, 44-bit limbs */
+    m_r[0] = t0 & 0xffc0fffffff;
+    m_r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffff;
+    m_r[2] = (t1 >> 24) & 0x00ffffffc0f;
+
+    m_h[0] = 0;
+    m_h[1] = 0;
+    m_h[2] = 0;
+
+    memcpy(m_pad, key + 16, 16);
+}
+
+void Poly1305::Blocks(const unsigned char* m, size_t len, bool is_final)
+{
+    unsigned __int128 d0, d1, d2;
+    uint64_t c;
+    unsigned char mp[POLY1305_BLOCKLEN];
+
+    const uint64_t r0 = m_r[0], r1 = m_r[1], r2 = m_r[2];
+    const uint64_t s1 = r1 * 20, s2 = r2 * 20;
+    uint64_t h0 = m_h[0], h1 = m_h[1], h2 = m_h[2];
+
+    while (len > 0) {
+        uint64_t hibit = (uint64_t)1 << 40; /* 1 << 128, in the high limb */
+        if (len < POLY1305_BLOCKLEN) {
+            /* only reachable from Finalize: pad the trailing partial block */
+            size_t j = 0;
+            for (; j < len; j++) mp[j] = m[j];
+            mp[j++] = 1;
+            for (; j < POLY1305_BLOCKLEN; j++) mp[j] = 0;
+            m = mp;
+            len = POLY1305_BLOCKLEN;
+            hibit = 0;
+        }
+
+        uint64_t t0 = ReadLE64(m + 0);
+        uint64_t t1 = ReadLE64(m + 8);
+
+        h0 += t0 & 0xfffffffffff;
+        h1 += ((t0 >> 44) | (t1 << 20)) & 0xfffffffffff;
+        h2 += ((t1 >> 24) & 0x3ffffffffff) | hibit;
+
+        /* h *= r, with partial reduction mod 2^130 - 5 */
+        d0 = (unsigned __int128)h0 * r0 + (unsigned __int128)h1 * s2 + (unsigned __int128)h2 * s1;
+        d1 = (unsigned __int128)h0 * r1 + (unsigned __int128)h1 * r0 + (unsigned __int128)h2 * s2;
+        d2 = (unsigned __int128)h0 * r2 + (unsigned __int128)h1 * r1 + (unsigned __int128)h2 * r0;
+
+                 c = (uint64_t)(d0 >> 44); h0 = (uint64_t)d0 & 0xfffffffffff;
+        d1 += c; c = (uint64_t)(d1 >> 44); h1 = (uint64_t)d1 & 0xfffffffffff;
+        d2 += c; c = (uint64_t)(d2 >> 42); h2 = (uint64_t)d2 & 0x3ffffffffff;
+        h0 += c * 5; c = h0 >> 44; h0 &= 0xfffffffffff;
+        h1 += c;
+
+        m += POLY1305_BLOCKLEN;
+        len -= POLY1305_BLOCKLEN;
+    }
+
+    m_h[0] = h0;
+    m_h[1] = h1;
+    m_h[2] = h2;
+}
+
+void Poly1305::Finalize(unsigned char out[POLY1305_TAGLEN])
+{
+    if (m_buf_size > 0) {
+        Blocks(m_buf, m_buf_size, true);
+        m_buf_size = 0;
+    }
+
+    uint64_t h0 = m_h[0], h1 = m_h[1], h2 = m_h[2];
+    uint64_t c, g0, g1, g2;
+
+    /* fully reduce h */
+                 c = h1 >> 44; h1 &= 0xfffffffffff;
+    h2 += c;     c = h2 >> 42; h2 &= 0x3ffffffffff;
+    h0 += c * 5; c = h0 >> 44; h0 &= 0xfffffffffff;
+    h1 += c;     c = h1 >> 44; h1 &= 0xfffffffffff;
+    h2 += c;     c = h2 >> 42; h2 &= 0x3ffffffffff;
+    h0 += c * 5; c = h0 >> 44; h0 &= 0xfffffffffff;
+    h1 += c;
+
+    /* compute h + -p */
+    g0 = h0 + 5; c = g0 >> 44; g0 &= 0xfffffffffff;
+    g1 = h1 + c; c = g1 >> 44; g1 &= 0xfffffffffff;
+    g2 = h2 + c - ((uint64_t)1 << 42);
+
+    /* select h if h < p, h + -p if h >= p */
+    c = (g2 >> 63) - 1;
+    g0 &= c; g1 &= c; g2 &= c;
+    c = ~c;
+    h0 = (h0 & c) | g0;
+    h1 = (h1 & c) | g1;
+    h2 = (h2 & c) | g2;
+
+    /* h = (h + pad) % (2^128) */
+    uint64_t t0 = ReadLE64(m_pad + 0);
+    uint64_t t1 = ReadLE64(m_pad + 8);
+
+    h0 += (t0 & 0xfffffffffff);                                     c = h0 >> 44; h0 &= 0xfffffffffff;
+    h1 += (((t0 >> 44) | (t1 << 20)) & 0xfffffffffff) + c;          c = h1 >> 44; h1 &= 0xfffffffffff;
+    h2 += ((t1 >> 24) & 0x3ffffffffff) + c;                         h2 &= 0x3ffffffffff;
+
+    WriteLE64(out + 0, h0 | (h1 << 44));
+    WriteLE64(out + 8, (h1 >> 20) | (h2 << 24));
+}
+
+#else /* !defined(__SIZEOF_INT128__) */
+
+Poly1305::Poly1305(const unsigned char key[POLY1305_KEYLEN])
+{
+    uint32_t t0 = ReadLE32(key + 0);
+    uint32_t t1 = ReadLE32(key + 4);
+    uint32_t t2 = ReadLE32(key + 8);
+    uint32_t t3 = ReadLE32(key + 12);
+
+    /* clamp key, 26-bit limbs */
+    m_r[0] = t0 & 0x3ffffff; t0 >>= 26; t0 |= t1 << 6;
+    m_r[1] = t0 & 0x3ffff03; t1 >>= 20; t1 |= t2 << 12;
+    m_r[2] = t1 & 0x3ffc0ff; t2 >>= 14; t2 |= t3 << 18;
+    m_r[3] = t2 & 0x3f03fff; t3 >>= 8;
+    m_r[4] = t3 & 0x00fffff;
+
+    m_h[0] = 0;
+    m_h[1] = 0;
+    m_h[2] = 0;
+    m_h[3] = 0;
+    m_h[4] = 0;
+
+    memcpy(m_pad, key + 16, 16);
+}
+
+void Poly1305::Blocks(const unsigned char* m, size_t len, bool is_final)
+{
+    uint64_t t[5];
+    uint64_t c;
+    uint32_t b;
+    unsigned char mp[POLY1305_BLOCKLEN];
+
+    const uint32_t r0 = m_r[0], r1 = m_r[1], r2 = m_r[2], r3 = m_r[3], r4 = m_r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = m_h[0], h1 = m_h[1], h2 = m_h[2], h3 = m_h[3], h4 = m_h[4];
+
+    while (len > 0) {
+        uint32_t hibit = 1 << 24;
+        if (len < POLY1305_BLOCKLEN) {
+            /* only reachable from Finalize: pad the trailing partial block */
+            size_t j = 0;
+            for (; j < len; j++) mp[j] = m[j];
+            mp[j++] = 1;
+            for (; j < POLY1305_BLOCKLEN; j++) mp[j] = 0;
+            m = mp;
+            len = POLY1305_BLOCKLEN;
+            hibit = 0;
+        }
+
+        uint32_t t0 = ReadLE32(m + 0);
+        uint32_t t1 = ReadLE32(m + 4);
+        uint32_t t2 = ReadLE32(m + 8);
+        uint32_t t3 = ReadLE32(m + 12);
+
+        h0 += t0 & 0x3ffffff;
+        h1 += ((((uint64_t)t1 << 32) | t0) >> 26) & 0x3ffffff;
+        h2 += ((((uint64_t)t2 << 32) | t1) >> 20) & 0x3ffffff;
+        h3 += ((((uint64_t)t3 << 32) | t2) >> 14) & 0x3ffffff;
+        h4 += (t3 >> 8) | hibit;
+
+        t[0] = mul32x32_64(h0,r0) + mul32x32_64(h1,s4) + mul32x32_64(h2,s3) + mul32x32_64(h3,s2) + mul32x32_64(h4,s1);
+        t[1] = mul32x32_64(h0,r1) + mul32x32_64(h1,r0) + mul32x32_64(h2,s4) + mul32x32_64(h3,s3) + mul32x32_64(h4,s2);
+        t[2] = mul32x32_64(h0,r2) + mul32x32_64(h1,r1) + mul32x32_64(h2,r0) + mul32x32_64(h3,s4) + mul32x32_64(h4,s3);
+        t[3] = mul32x32_64(h0,r3) + mul32x32_64(h1,r2) + mul32x32_64(h2,r1) + mul32x32_64(h3,r0) + mul32x32_64(h4,s4);
+        t[4] = mul32x32_64(h0,r4) + mul32x32_64(h1,r3) + mul32x32_64(h2,r2) + mul32x32_64(h3,r1) + mul32x32_64(h4,r0);
+
+                        h0 = (uint32_t)t[0] & 0x3ffffff; c =           (t[0] >> 26);
+        t[1] += c;      h1 = (uint32_t)t[1] & 0x3ffffff; b = (uint32_t)(t[1] >> 26);
+        t[2] += b;      h2 = (uint32_t)t[2] & 0x3ffffff; b = (uint32_t)(t[2] >> 26);
+        t[3] += b;      h3 = (uint32_t)t[3] & 0x3ffffff; b = (uint32_t)(t[3] >> 26);
+        t[4] += b;      h4 = (uint32_t)t[4] & 0x3ffffff; b = (uint32_t)(t[4] >> 26);
+        h0 += b * 5;
+
+        m += POLY1305_BLOCKLEN;
+        len -= POLY1305_BLOCKLEN;
+    }
+
+    m_h[0] = h0;
+    m_h[1] = h1;
+    m_h[2] = h2;
+    m_h[3] = h3;
+    m_h[4] = h4;
+}
+
+void Poly1305::Finalize(unsigned char out[POLY1305_TAGLEN])
+{
+    if (m_buf_size > 0) {
+        Blocks(m_buf, m_buf_size, true);
+        m_buf_size = 0;
+    }
+
+    uint32_t h0 = m_h[0], h1 = m_h[1], h2 = m_h[2], h3 = m_h[3], h4 = m_h[4];
+    uint32_t b, nb;
+    uint64_t f0, f1, f2, f3;
+    uint64_t g0, g1, g2, g3, g4;
+
+                 b = h0 >> 26; h0 = h0 & 0x3ffffff;
+    h1 +=     b; b = h1 >> 26; h1 = h1 & 0x3ffffff;
+    h2 +=     b; b = h2 >> 26; h2 = h2 & 0x3ffffff;
+    h3 +=     b; b = h3 >> 26; h3 = h3 & 0x3ffffff;
+    h4 +=     b; b = h4 >> 26; h4 = h4 & 0x3ffffff;
+    h0 += b * 5; b = h0 >> 26; h0 = h0 & 0x3ffffff;
+    h1 +=     b;
+
+    g0 = h0 + 5; b = g0 >> 26; g0 &= 0x3ffffff;
+    g1 = h1 + b; b = g1 >> 26; g1 &= 0x3ffffff;
+    g2 = h2 + b; b = g2 >> 26; g2 &= 0x3ffffff;
+    g3 = h3 + b; b = g3 >> 26; g3 &= 0x3ffffff;
+    g4 = h4 + b - (1 << 26);
+
+    b = (g4 >> 31) - 1;
+    nb = ~b;
+    h0 = (h0 & nb) | (g0 & b);
+    h1 = (h1 & nb) | (g1 & b);
+    h2 = (h2 & nb) | (g2 & b);
+    h3 = (h3 & nb) | (g3 & b);
+    h4 = (h4 & nb) | (g4 & b);
+
+    f0 = ((h0      ) | (h1 << 26)) + (uint64_t)ReadLE32(&m_pad[0]);
+    f1 = ((h1 >>  6) | (h2 << 20)) + (uint64_t)ReadLE32(&m_pad[4]);
+    f2 = ((h2 >> 12) | (h3 << 14)) + (uint64_t)ReadLE32(&m_pad[8]);
+    f3 = ((h3 >> 18) | (h4 <<  8)) + (uint64_t)ReadLE32(&m_pad[12]);
+
+    WriteLE32(&out[ 0], f0); f1 += (f0 >> 32);
+    WriteLE32(&out[ 4], f1); f2 += (f1 >> 32);
+    WriteLE32(&out[ 8], f2); f3 += (f2 >> 32);
+    WriteLE32(&out[12], f3);
+}
+
+#endif /* defined(__SIZEOF_INT128__) */
+
+Poly1305::~Poly1305()
+{
+    memory_cleanse(m_r, sizeof(m_r));
+    memory_cleanse(m_h, sizeof(m_h));
+    memory_cleanse(m_pad, sizeof(m_pad));
+    memory_cleanse(m_buf, sizeof(m_buf));
+}
+
+Poly1305& Poly1305::Update(const unsigned char* m, size_t len)
+{
+    if (m_buf_size > 0) {
+        size_t fill = POLY1305_BLOCKLEN - m_buf_size;
+        if (fill > len) fill = len;
+        memcpy(m_buf + m_buf_size, m, fill);
+        m_buf_size += fill;
+        m += fill;
+        len -= fill;
+        if (m_buf_size == POLY1305_BLOCKLEN) {
+            Blocks(m_buf, POLY1305_BLOCKLEN, false);
+            m_buf_size = 0;
+        }
+    }
+    if (len >= POLY1305_BLOCKLEN) {
+        size_t blocks_len = len - (len % POLY1305_BLOCKLEN);
+        Blocks(m, blocks_len, false);
+        m += blocks_len;
+        len -= blocks_len;
+    }
+    if (len > 0) {
+        memcpy(m_buf, m, len);
+        m_buf_size = len;
+    }
+    return *this;
+}
@@ -10,6 +10,44 @@
 
 #define POLY1305_KEYLEN 32
 #define POLY1305_TAGLEN 16
+#define POLY1305_BLOCKLEN 16
+
+/** Incremental Poly1305 computation, so the MAC can be interleaved with other
+ *  per-chunk work (see ChaCha20Poly1305AEAD::Crypt) instead of needing a
+ *  second pass over the message. Uses 44-bit radix limbs with a 128-bit
+ *  product type where the compiler provides one, 26-bit radix limbs
+ *  otherwise.
+ */
+class Poly1305
+{
+private:
+#ifdef __SIZEOF_INT128__
+    uint64_t m_r[3]; //!< clamped key multiplier
+    uint64_t m_h[3]; //!< accumulator
+#else
+    uint32_t m_r[5];
+    uint32_t m_h[5];
+#endif
+    unsigned char m_pad[16];                //!< s half of the key, added to the final residue
+    unsigned char m_buf[POLY1305_BLOCKLEN]; //!< partial block buffer
+    size_t m_buf_size{0};
+
+    /** Absorb blocks from m. len must be a multiple of POLY1305_BLOCKLEN
+     *  unless is_final is set, in which case the last (partial) block is
+     *  padded. */
+    void Blocks(const unsigned char* m, size_t len, bool is_final);
+
+public:
+    explicit Poly1305(const unsigned char key[POLY1305_KEYLEN]);
+    ~Poly1305();
+
+    /** Absorb more message bytes. */
+    Poly1305& Update(const unsigned char* m, size_t len);
+
+    /** Write the 16-byte tag over all absorbed data to out. No further calls
+     *  are allowed afterwards. */
+    void Finalize(unsigned char out[POLY1305_TAGLEN]);
+};
 
 void poly1305_auth(unsigned char out[POLY1305_TAGLEN], const unsigned char *m, size_t inlen,
     const unsigned char key[POLY1305_KEYLEN]);
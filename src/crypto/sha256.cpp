@@ -29,6 +29,11 @@ namespace sha256d64_avx2
 void Transform_8way(unsigned char* out, const unsigned char* in);
 }
 
+namespace sha256d64_avx512
+{
+void Transform_16way(unsigned char* out, const unsigned char* in);
+}
+
 namespace sha256d64_shani
 {
 void Transform_2way(unsigned char* out, const unsigned char* in);
@@ -461,6 +466,7 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformD64Type TransformD64_16way = nullptr;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -544,6 +550,18 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test TransformD64_16way, if available. The test vector only covers 8
+    // distinct 64-byte messages, so they are replicated into the upper lanes.
+    if (TransformD64_16way) {
+        unsigned char in[1024];
+        std::copy(data + 1, data + 1 + 512, in);
+        std::copy(data + 1, data + 1 + 512, in + 512);
+        unsigned char out[512];
+        TransformD64_16way(out, in);
+        if (!std::equal(out, out + 256, result_d64)) return false;
+        if (!std::equal(out + 256, out + 512, result_d64)) return false;
+    }
+
     return true;
 }
 
@@ -555,6 +573,14 @@ bool AVXEnabled()
     __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
     return (a & 6) == 6;
 }
+
+/** Check whether the OS has additionally enabled the AVX-512 opmask and ZMM registers. */
+bool AVX512Enabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 0xe6) == 0xe6;
+}
 #endif
 } // namespace
 
@@ -567,16 +593,21 @@ std::string SHA256AutoDetect()
     bool have_xsave = false;
     bool have_avx = false;
     bool have_avx2 = false;
+    bool have_avx512 = false;
     bool have_shani = false;
     bool enabled_avx = false;
+    bool enabled_avx512 = false;
 
     (void)AVXEnabled;
+    (void)AVX512Enabled;
     (void)have_sse4;
     (void)have_avx;
     (void)have_xsave;
     (void)have_avx2;
+    (void)have_avx512;
     (void)have_shani;
     (void)enabled_avx;
+    (void)enabled_avx512;
 
     uint32_t eax, ebx, ecx, edx;
     GetCPUID(1, 0, eax, ebx, ecx, edx);
@@ -585,10 +616,13 @@ std::string SHA256AutoDetect()
     have_avx = (ecx >> 28) & 1;
     if (have_xsave && have_avx) {
         enabled_avx = AVXEnabled();
+        enabled_avx512 = AVX512Enabled();
     }
     if (have_sse4) {
         GetCPUID(7, 0, eax, ebx, ecx, edx);
         have_avx2 = (ebx >> 5) & 1;
+        // Both AVX512F and AVX512BW are required (the latter for the 8-bit shuffle).
+        have_avx512 = ((ebx >> 16) & 1) && ((ebx >> 30) & 1);
         have_shani = (ebx >> 29) & 1;
     }
 
@@ -621,6 +655,15 @@ std::string SHA256AutoDetect()
         ret += ",avx2(8way)";
     }
 #endif
+
+#if defined(ENABLE_AVX512) && !defined(BUILD_BITCOIN_INTERNAL)
+    // Registered even when SHA-NI is available: for bulk 64-byte double-SHA256
+    // the 16-way path has higher throughput than repeated 2-way SHA-NI calls.
+    if (have_avx512 && have_avx && enabled_avx && enabled_avx512) {
+        TransformD64_16way = sha256d64_avx512::Transform_16way;
+        ret += ",avx512(16way)";
+    }
+#endif
 #endif
 
     assert(SelfTest());
@@ -684,8 +727,61 @@ CSHA256& CSHA256::Reset()
     return *this;
 }
 
+void SHA256DShort(unsigned char* output, const unsigned char* input, size_t len)
+{
+    assert(len <= 119);
+
+    if (len == 64) {
+        // The merkle-pair case has dedicated (possibly specialized) code.
+        SHA256D64(output, input, 1);
+        return;
+    }
+
+    // First pass: pad the message manually and compress it in one go using
+    // the best available Transform implementation.
+    uint32_t s[8];
+    sha256::Initialize(s);
+    unsigned char buf[128] = {0};
+    memcpy(buf, input, len);
+    buf[len] = 0x80;
+    const size_t blocks = (len + 9 + 63) / 64;
+    WriteBE64(buf + blocks * 64 - 8, len << 3);
+    Transform(s, buf, blocks);
+
+    // Second pass: hash the 32-byte inner digest, whose padding is constant.
+    unsigned char inner[64] = {0};
+    WriteBE32(inner + 0, s[0]);
+    WriteBE32(inner + 4, s[1]);
+    WriteBE32(inner + 8, s[2]);
+    WriteBE32(inner + 12, s[3]);
+    WriteBE32(inner + 16, s[4]);
+    WriteBE32(inner + 20, s[5]);
+    WriteBE32(inner + 24, s[6]);
+    WriteBE32(inner + 28, s[7]);
+    inner[32] = 0x80;
+    WriteBE64(inner + 56, 256);
+    sha256::Initialize(s);
+    Transform(s, inner, 1);
+    WriteBE32(output + 0, s[0]);
+    WriteBE32(output + 4, s[1]);
+    WriteBE32(output + 8, s[2]);
+    WriteBE32(output + 12, s[3]);
+    WriteBE32(output + 16, s[4]);
+    WriteBE32(output + 20, s[5]);
+    WriteBE32(output + 24, s[6]);
+    WriteBE32(output + 28, s[7]);
+}
+
 void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
 {
+    if (TransformD64_16way) {
+        while (blocks >= 16) {
+            TransformD64_16way(out, in);
+            out += 512;
+            in += 1024;
+            blocks -= 16;
+        }
+    }
     if (TransformD64_8way) {
         while (blocks >= 8) {
             TransformD64_8way(out, in);
@@ -38,4 +38,15 @@ std::string SHA256AutoDetect();
  */
 void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
 
+/** Compute the double-SHA256 of a message of at most 119 bytes in one shot,
+ *  without the buffering and state management of the streaming CSHA256
+ *  interface. This covers the dominant fixed sizes: 32-byte hashes and keys,
+ *  64-byte merkle pairs (dispatched to SHA256D64) and 80-byte block headers.
+ *  Uses the same autodetected implementation (SHA-NI, SSE4, ...) as CSHA256.
+ *  output:  pointer to a 32-byte output buffer
+ *  input:   pointer to a len-byte input buffer
+ *  len:     length of the input; must be at most 119 bytes
+ */
+void SHA256DShort(unsigned char* output, const unsigned char* input, size_t len);
+
 #endif // BITCOIN_CRYPTO_SHA256_H
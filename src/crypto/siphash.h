@@ -44,4 +44,12 @@ public:
 uint64_t SipHashUint256(uint64_t k0, uint64_t k1, const uint256& val);
 uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint32_t extra);
 
+/** SipHash-1-3 of a uint256: one compression round per message word and three
+ *  finalization rounds, roughly twice as fast as SipHash-2-4 at a reduced
+ *  (but still keyed) security margin. Suitable only for salted in-process
+ *  hash tables; the output must never leave the process or be compared
+ *  across runs. */
+uint64_t SipHash13Uint256(uint64_t k0, uint64_t k1, const uint256& val);
+uint64_t SipHash13Uint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint32_t extra);
+
 #endif // BITCOIN_CRYPTO_SIPHASH_H
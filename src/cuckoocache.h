@@ -258,6 +258,20 @@ private:
         return ~(uint32_t)0;
     }
 
+    /** prefetch_locs requests the cache lines of all hash locations from the
+     * memory subsystem. The eight locations of an element are uniformly
+     * random, so probing them one after another costs up to eight dependent
+     * cache misses on a table far larger than L2; issuing the loads up front
+     * overlaps them into roughly the latency of one.
+     */
+    inline void prefetch_locs(const std::array<uint32_t, 8>& locs) const
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        for (const uint32_t loc : locs)
+            __builtin_prefetch(&table[loc], /* read */ 0, /* low temporal locality */ 1);
+#endif
+    }
+
     /** allow_erase marks the element at index `n` as discardable. Threadsafe
      * without any concurrent insert.
      * @param n the index to allow erasure of
@@ -331,7 +345,8 @@ public:
     /** setup initializes the container to store no more than new_size
      * elements.
      *
-     * setup should only be called once.
+     * setup should only be called once; use resize to change the capacity of
+     * a cache that is already in use.
      *
      * @param new_size the desired number of elements to store
      * @returns the maximum number of elements storable
@@ -368,6 +383,50 @@ public:
         return setup(bytes/sizeof(Element));
     }
 
+    /** resize changes the capacity of an already set-up cache to new_size
+     * elements, preserving the elements it currently holds. The live elements
+     * are collected, the table is re-initialized at the new size, and the
+     * elements are re-inserted (their hash locations depend on the table size,
+     * so they must be rehashed). Elements that were marked erasable are
+     * dropped, and when shrinking, elements that cannot be placed are evicted
+     * as per insert's usual rules.
+     *
+     * resize requires the same synchronization as insert: no concurrent reads,
+     * writes, or erases.
+     *
+     * @param new_size the desired number of elements to store
+     * @returns the maximum number of elements storable (see setup()
+     * documentation for more detail)
+     */
+    uint32_t resize(uint32_t new_size)
+    {
+        std::vector<Element> live;
+        live.reserve(std::min<uint32_t>(size, std::max<uint32_t>(2, new_size)));
+        for (uint32_t i = 0; i < size; ++i) {
+            if (!collection_flags.bit_is_set(i))
+                live.push_back(std::move(table[i]));
+        }
+        // setup marks every slot as collected, so the re-inserts below see an
+        // empty table.
+        uint32_t ret = setup(new_size);
+        for (Element& e : live)
+            insert(std::move(e));
+        return ret;
+    }
+
+    /** resize_bytes is a convenience function which accounts for internal
+     * memory usage when deciding how many elements to store, with the same
+     * caveats as setup_bytes.
+     *
+     * @param bytes the approximate number of bytes to use for this data
+     * structure
+     * @returns the maximum number of elements storable
+     */
+    uint32_t resize_bytes(size_t bytes)
+    {
+        return resize(bytes / sizeof(Element));
+    }
+
     /** insert loops at most depth_limit times trying to insert a hash
      * at various locations in the table via a variant of the Cuckoo Algorithm
      * with eight hash locations.
@@ -395,6 +454,7 @@ public:
         uint32_t last_loc = invalid();
         bool last_epoch = true;
         std::array<uint32_t, 8> locs = compute_hashes(e);
+        prefetch_locs(locs);
         // Make sure we have not already inserted this element
         // If we have, make sure that it does not get deleted
         for (const uint32_t loc : locs)
@@ -469,6 +529,7 @@ public:
     inline bool contains(const Element& e, const bool erase) const
     {
         std::array<uint32_t, 8> locs = compute_hashes(e);
+        prefetch_locs(locs);
         for (const uint32_t loc : locs)
             if (table[loc] == e) {
                 if (erase)
@@ -477,6 +538,34 @@ public:
             }
         return false;
     }
+
+    /** elements returns a copy of every element currently in the table that
+     * has not been marked erasable, in no particular order. Requires the same
+     * synchronization as insert: no concurrent reads, writes, or erases.
+     *
+     * @returns the live elements
+     */
+    std::vector<Element> elements() const
+    {
+        std::vector<Element> ret;
+        for (uint32_t i = 0; i < size; ++i) {
+            if (!collection_flags.bit_is_set(i)) ret.push_back(table[i]);
+        }
+        return ret;
+    }
+
+    /** prefetch hints the memory subsystem that the hash locations of `e`
+     * are about to be probed, without reading them. A caller that knows a
+     * contains() or insert() for `e` is coming, but has other work to do
+     * first, can issue this early so that the table lines arrive in cache by
+     * the time they are compared. Requires no synchronization.
+     *
+     * @param e the element whose locations should be fetched
+     */
+    inline void prefetch(const Element& e) const
+    {
+        prefetch_locs(compute_hashes(e));
+    }
 };
 } // namespace CuckooCache
 
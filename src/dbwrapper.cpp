@@ -97,12 +97,13 @@ static void SetMaxOpenFiles(leveldb::Options *options) {
              options->max_open_files, default_open_files);
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+static leveldb::Options GetOptions(size_t nCacheSize, const DBTuningOptions& tuning)
 {
     leveldb::Options options;
     options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
     options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
+    const int bloom_bits{tuning.bloom_bits == 0 ? 10 : tuning.bloom_bits};
+    if (bloom_bits > 0) options.filter_policy = leveldb::NewBloomFilterPolicy(bloom_bits);
     options.compression = leveldb::kNoCompression;
     options.info_log = new CBitcoinLevelDBLogger();
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
@@ -111,10 +112,15 @@ static leveldb::Options GetOptions(size_t nCacheSize)
         options.paranoid_checks = true;
     }
     SetMaxOpenFiles(&options);
+    // Per-instance overrides; leveldb's level-0 compaction trigger is a
+    // compile-time constant and cannot be tuned here.
+    if (tuning.write_buffer_size) options.write_buffer_size = tuning.write_buffer_size;
+    if (tuning.max_file_size) options.max_file_size = tuning.max_file_size;
+    if (tuning.block_size) options.block_size = tuning.block_size;
     return options;
 }
 
-CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate)
+CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate, const DBTuningOptions& tuning)
     : m_name{path.stem().string()}
 {
     penv = nullptr;
@@ -122,7 +128,7 @@ CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bo
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
-    options = GetOptions(nCacheSize);
+    options = GetOptions(nCacheSize, tuning);
     options.create_if_missing = true;
     if (fMemory) {
         penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -168,6 +174,13 @@ CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bo
 
 CDBWrapper::~CDBWrapper()
 {
+    {
+        LOCK(m_async_mutex);
+        m_async_stop = true;
+    }
+    m_async_cv.notify_all();
+    if (m_async_writer.joinable()) m_async_writer.join();
+
     delete pdb;
     pdb = nullptr;
     delete options.filter_policy;
@@ -182,6 +195,10 @@ CDBWrapper::~CDBWrapper()
 
 bool CDBWrapper::WriteBatch(CDBBatch& batch, bool fSync)
 {
+    // Preserve commit order with any batches still queued for the background
+    // writer.
+    FlushAsyncWrites();
+
     const bool log_memory = LogAcceptCategory(BCLog::LEVELDB);
     double mem_before = 0;
     if (log_memory) {
@@ -197,6 +214,63 @@ bool CDBWrapper::WriteBatch(CDBBatch& batch, bool fSync)
     return true;
 }
 
+std::future<bool> CDBWrapper::WriteBatchAsync(CDBBatch& batch, bool fSync)
+{
+    AsyncWrite job;
+    job.batch = batch.batch;
+    job.sync = fSync;
+    batch.Clear();
+    std::future<bool> future = job.promise.get_future();
+    {
+        LOCK(m_async_mutex);
+        assert(!m_async_stop);
+        if (!m_async_writer.joinable()) {
+            m_async_writer = std::thread(&TraceThread<std::function<void()>>, "dbwriter", std::function<void()>([this] { AsyncWriteLoop(); }));
+        }
+        m_async_queue.push_back(std::move(job));
+    }
+    m_async_cv.notify_all();
+    return future;
+}
+
+void CDBWrapper::AsyncWriteLoop()
+{
+    while (true) {
+        AsyncWrite job;
+        {
+            WAIT_LOCK(m_async_mutex, lock);
+            m_async_cv.wait(lock, [this]() EXCLUSIVE_LOCKS_REQUIRED(m_async_mutex) { return m_async_stop || !m_async_queue.empty(); });
+            if (m_async_queue.empty()) break; // stop requested and queue drained
+            job = std::move(m_async_queue.front());
+            m_async_queue.pop_front();
+            m_async_busy = true;
+        }
+        leveldb::Status status = pdb->Write(job.sync ? syncoptions : writeoptions, &job.batch);
+        try {
+            dbwrapper_private::HandleError(status);
+            job.promise.set_value(true);
+        } catch (const dbwrapper_error&) {
+            job.promise.set_exception(std::current_exception());
+        }
+        {
+            LOCK(m_async_mutex);
+            m_async_busy = false;
+        }
+        m_async_cv.notify_all();
+    }
+}
+
+void CDBWrapper::FlushAsyncWrites()
+{
+    WAIT_LOCK(m_async_mutex, lock);
+    m_async_cv.wait(lock, [this]() EXCLUSIVE_LOCKS_REQUIRED(m_async_mutex) { return m_async_queue.empty() && !m_async_busy; });
+}
+
+bool CDBWrapper::GetProperty(const std::string& name, std::string& out) const
+{
+    return pdb->GetProperty(name, &out);
+}
+
 size_t CDBWrapper::DynamicMemoryUsage() const {
     std::string memory;
     if (!pdb->GetProperty("leveldb.approximate-memory-usage", &memory)) {
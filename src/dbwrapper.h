@@ -16,9 +16,32 @@
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
 
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <thread>
+
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 
+/**
+ * Per-instance tuning for the underlying leveldb database. A zero field keeps
+ * the value GetOptions() derives from the cache size, or leveldb's own
+ * default.
+ */
+struct DBTuningOptions
+{
+    //! Size the memtable may grow to before it is spilled to a level-0 file.
+    size_t write_buffer_size{0};
+    //! Target size of compacted data files.
+    size_t max_file_size{0};
+    //! Uncompressed size of a table block, the unit reads are served in.
+    size_t block_size{0};
+    //! Bits per key for the bloom filter that short-circuits point lookups
+    //! of absent keys (0 = the default of 10, negative = no filter).
+    int bloom_bits{0};
+};
+
 class dbwrapper_error : public std::runtime_error
 {
 public:
@@ -212,6 +235,26 @@ private:
 
     std::vector<unsigned char> CreateObfuscateKey() const;
 
+    //! A batch handed off to the background writer, with the promise through
+    //! which its durability point is reported.
+    struct AsyncWrite {
+        leveldb::WriteBatch batch;
+        bool sync{false};
+        std::promise<bool> promise;
+    };
+
+    //! Serializes handoff to the background batch writer.
+    Mutex m_async_mutex;
+    std::condition_variable m_async_cv;
+    std::deque<AsyncWrite> m_async_queue GUARDED_BY(m_async_mutex);
+    //! Whether the writer thread is currently committing a dequeued batch.
+    bool m_async_busy GUARDED_BY(m_async_mutex){false};
+    bool m_async_stop GUARDED_BY(m_async_mutex){false};
+    //! Started lazily on the first WriteBatchAsync() call.
+    std::thread m_async_writer;
+
+    void AsyncWriteLoop();
+
 public:
     /**
      * @param[in] path        Location in the filesystem where leveldb data will be stored.
@@ -220,8 +263,9 @@ public:
      * @param[in] fWipe       If true, remove all existing data.
      * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If false, XOR
      *                        with a zero'd byte array.
+     * @param[in] tuning      Optional overrides of the leveldb tunables derived from nCacheSize.
      */
-    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false);
+    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false, const DBTuningOptions& tuning = {});
     ~CDBWrapper();
 
     CDBWrapper(const CDBWrapper&) = delete;
@@ -290,9 +334,28 @@ public:
 
     bool WriteBatch(CDBBatch& batch, bool fSync = false);
 
+    /**
+     * Queue a batch for commit on a dedicated writer thread, leaving the
+     * caller free to build the next batch. The batch is emptied by the call.
+     * The returned future resolves once the commit is durable (throwing
+     * dbwrapper_error on failure, as WriteBatch would); until then reads do
+     * not observe the queued data, so callers must sequence dependent reads
+     * behind the future themselves. Synchronous WriteBatch() calls drain the
+     * queue first, preserving commit order between the two modes.
+     */
+    std::future<bool> WriteBatchAsync(CDBBatch& batch, bool fSync = false);
+
+    /** Block until every queued asynchronous batch has been committed. */
+    void FlushAsyncWrites();
+
     // Get an estimate of LevelDB memory usage (in bytes).
     size_t DynamicMemoryUsage() const;
 
+    //! Fetch one of leveldb's internal property strings, e.g. "leveldb.stats"
+    //! (per-level read/compaction statistics) or
+    //! "leveldb.approximate-memory-usage". Returns false for unknown names.
+    bool GetProperty(const std::string& name, std::string& out) const;
+
     CDBIterator *NewIterator()
     {
         return new CDBIterator(*this, pdb->NewIterator(iteroptions));
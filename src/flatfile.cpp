@@ -10,6 +10,13 @@
 #include <tinyformat.h>
 #include <util/system.h>
 
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 FlatFileSeq::FlatFileSeq(fs::path dir, const char* prefix, size_t chunk_size) :
     m_dir(std::move(dir)),
     m_prefix(prefix),
@@ -52,6 +59,42 @@ FILE* FlatFileSeq::Open(const FlatFilePos& pos, bool read_only)
     return file;
 }
 
+FlatFileMap::~FlatFileMap()
+{
+#ifndef WIN32
+    if (m_data) {
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+#endif
+}
+
+FlatFileMap FlatFileSeq::Map(const FlatFilePos& pos) const
+{
+    FlatFileMap map;
+#ifndef WIN32
+    if (pos.IsNull()) {
+        return map;
+    }
+    int fd = open(FileName(pos).string().c_str(), O_RDONLY);
+    if (fd == -1) {
+        return map;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || sb.st_size <= 0 || pos.nPos >= (uint64_t)sb.st_size) {
+        close(fd);
+        return map;
+    }
+    void* addr = mmap(nullptr, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping holds its own reference to the file
+    if (addr == MAP_FAILED) {
+        return map;
+    }
+    map.m_data = static_cast<const unsigned char*>(addr);
+    map.m_size = sb.st_size;
+#endif
+    return map;
+}
+
 size_t FlatFileSeq::Allocate(const FlatFilePos& pos, size_t add_size, bool& out_of_space)
 {
     out_of_space = false;
@@ -6,10 +6,12 @@
 #ifndef BITCOIN_FLATFILE_H
 #define BITCOIN_FLATFILE_H
 
+#include <cassert>
 #include <string>
 
 #include <fs.h>
 #include <serialize.h>
+#include <span.h>
 
 struct FlatFilePos
 {
@@ -39,6 +41,49 @@ struct FlatFilePos
     std::string ToString() const;
 };
 
+/**
+ * Read-only memory mapping of one file in a FlatFileSeq. Reads through the
+ * mapping are served directly from the page cache, avoiding read syscalls and
+ * intermediate buffer copies for data that is already resident. On platforms
+ * without mmap support the mapping is always null and callers fall back to
+ * buffered reads.
+ */
+class FlatFileMap
+{
+private:
+    const unsigned char* m_data{nullptr};
+    size_t m_size{0};
+
+    friend class FlatFileSeq;
+
+public:
+    FlatFileMap() = default;
+    FlatFileMap(const FlatFileMap&) = delete;
+    FlatFileMap& operator=(const FlatFileMap&) = delete;
+    FlatFileMap(FlatFileMap&& other) noexcept : m_data(other.m_data), m_size(other.m_size)
+    {
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    FlatFileMap& operator=(FlatFileMap&& other) noexcept
+    {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        return *this;
+    }
+    ~FlatFileMap();
+
+    /** Whether the mapping failed to be established. */
+    bool IsNull() const { return m_data == nullptr; }
+
+    /** View of the file contents from the given offset to the end of the file. */
+    Span<const unsigned char> Data(size_t offset) const
+    {
+        assert(offset <= m_size);
+        return {m_data + offset, m_size - offset};
+    }
+};
+
 /**
  * FlatFileSeq represents a sequence of numbered files storing raw data. This class facilitates
  * access to and efficient management of these files.
@@ -66,6 +111,14 @@ public:
     /** Open a handle to the file at the given position. */
     FILE* Open(const FlatFilePos& pos, bool read_only = false);
 
+    /**
+     * Memory map the whole file containing the given position for reading.
+     * Returns a null mapping if the file does not exist, the position lies
+     * beyond its end, or the platform has no mmap support; callers are
+     * expected to fall back to Open() in that case.
+     */
+    FlatFileMap Map(const FlatFilePos& pos) const;
+
     /**
      * Allocate additional space in a file after the given starting position. The amount allocated
      * will be the minimum multiple of the sequence chunk size greater than add_size.
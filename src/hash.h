@@ -15,32 +15,58 @@
 #include <uint256.h>
 #include <version.h>
 
+#include <cstring>
 #include <string>
 #include <vector>
 
 typedef uint256 ChainCode;
 
-/** A hasher class for Bitcoin's 256-bit hash (double SHA-256). */
+/** A hasher class for Bitcoin's 256-bit hash (double SHA-256).
+ *
+ * Input is buffered while it still fits the single-shot SHA256DShort
+ * codepath, so the dominant case of hashing one short message (a block
+ * header, an outpoint, a 32-byte hash) skips the streaming SHA256 state
+ * management entirely.
+ */
 class CHash256 {
 private:
     CSHA256 sha;
+    unsigned char m_buf[119];
+    size_t m_buf_size{0};
+    bool m_direct{false}; //!< whether writes bypass m_buf and go straight to sha
+
 public:
     static const size_t OUTPUT_SIZE = CSHA256::OUTPUT_SIZE;
 
     void Finalize(Span<unsigned char> output) {
         assert(output.size() == OUTPUT_SIZE);
+        if (!m_direct) {
+            SHA256DShort(output.data(), m_buf, m_buf_size);
+            return;
+        }
         unsigned char buf[CSHA256::OUTPUT_SIZE];
         sha.Finalize(buf);
         sha.Reset().Write(buf, CSHA256::OUTPUT_SIZE).Finalize(output.data());
     }
 
     CHash256& Write(Span<const unsigned char> input) {
+        if (!m_direct) {
+            if (m_buf_size + input.size() <= sizeof(m_buf)) {
+                memcpy(m_buf + m_buf_size, input.data(), input.size());
+                m_buf_size += input.size();
+                return *this;
+            }
+            sha.Write(m_buf, m_buf_size);
+            m_direct = true;
+        }
         sha.Write(input.data(), input.size());
         return *this;
     }
 
     CHash256& Reset() {
         sha.Reset();
+        m_buf_size = 0;
+        m_direct = false;
         return *this;
     }
 };
@@ -102,6 +128,14 @@ class CHashWriter
 private:
     CSHA256 ctx;
 
+    //! Serialized data is buffered here while it still fits the single-shot
+    //! SHA256DShort codepath, so that short serializations (block headers,
+    //! outpoints, compact size prefixed hashes) are double-hashed in one
+    //! shot by GetHash().
+    unsigned char m_buf[119];
+    size_t m_buf_size{0};
+    bool m_direct{false}; //!< whether writes bypass m_buf and go straight to ctx
+
     const int nType;
     const int nVersion;
 public:
@@ -112,6 +146,15 @@ public:
     int GetVersion() const { return nVersion; }
 
     void write(const char *pch, size_t size) {
+        if (!m_direct) {
+            if (m_buf_size + size <= sizeof(m_buf)) {
+                memcpy(m_buf + m_buf_size, pch, size);
+                m_buf_size += size;
+                return;
+            }
+            ctx.Write(m_buf, m_buf_size);
+            m_direct = true;
+        }
         ctx.Write((const unsigned char*)pch, size);
     }
 
@@ -121,6 +164,10 @@ public:
      */
     uint256 GetHash() {
         uint256 result;
+        if (!m_direct) {
+            SHA256DShort(result.begin(), m_buf, m_buf_size);
+            return result;
+        }
         ctx.Finalize(result.begin());
         ctx.Reset().Write(result.begin(), CSHA256::OUTPUT_SIZE).Finalize(result.begin());
         return result;
@@ -132,6 +179,10 @@ public:
      */
     uint256 GetSHA256() {
         uint256 result;
+        if (!m_direct) {
+            ctx.Write(m_buf, m_buf_size);
+            m_direct = true;
+        }
         ctx.Finalize(result.begin());
         return result;
     }
@@ -196,6 +247,16 @@ uint256 SerializeHash(const T& obj, int nType=SER_GETHASH, int nVersion=PROTOCOL
     return ss.GetHash();
 }
 
+/** Compute the 256-bit hash of a preserialized object. Equivalent to
+ * SerializeHash(obj) when data holds obj's serialization, but hashes the
+ * existing bytes directly instead of reserializing through a stream. */
+inline uint256 SerializeHashSpan(Span<const unsigned char> data)
+{
+    uint256 result;
+    CHash256().Write(data).Finalize(result);
+    return result;
+}
+
 /** Single-SHA256 a 32-byte input (represented as uint256). */
 [[nodiscard]] uint256 SHA256Uint256(const uint256& input);
 
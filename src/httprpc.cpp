@@ -200,8 +200,16 @@ static bool HTTPReq_JSONRPC(const util::Ref& context, HTTPRequest* req)
             }
             UniValue result = tableRPC.execute(jreq);
 
-            // Send reply
-            strReply = JSONRPCReply(result, NullUniValue, jreq.id);
+            // Stream the reply straight into the output buffer. Responses
+            // like a verbosity-2 getblock run to tens of megabytes, and
+            // assembling them as one string on top of the result tree
+            // doubles the peak allocation per call.
+            req->WriteHeader("Content-Type", "application/json");
+            JSONRPCReplyStreamed(result, NullUniValue, jreq.id, [req](const char* data, size_t size) {
+                req->AppendReplyBody(data, size);
+            });
+            req->WriteReply(HTTP_OK);
+            return true;
 
         // array of requests
         } else if (valRequest.isArray()) {
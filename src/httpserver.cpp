@@ -11,13 +11,16 @@
 #include <rpc/protocol.h> // For HTTP status codes
 #include <shutdown.h>
 #include <sync.h>
+#include <util/gzip.h>
 #include <util/strencodings.h>
+#include <util/string.h>
 #include <util/system.h>
 #include <util/threadnames.h>
 #include <util/translation.h>
 
 #include <deque>
 #include <memory>
+#include <set>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
@@ -35,6 +38,9 @@
 
 /** Maximum size of http request (request line + headers) */
 static const size_t MAX_HEADERS_SIZE = 8192;
+/** Smallest one-shot reply body worth gzip-compressing; anything below this
+ * fits comfortably in a packet anyway. */
+static const size_t MIN_COMPRESSED_REPLY_SIZE = 1024;
 
 /** HTTP request work item */
 class HTTPWorkItem final : public HTTPClosure
@@ -67,6 +73,8 @@ private:
     Mutex cs;
     std::condition_variable cond;
     std::deque<std::unique_ptr<WorkItem>> queue;
+    //! Items that only run on workers not reserved for the normal lane
+    std::deque<std::unique_ptr<WorkItem>> m_low_queue;
     bool running;
     size_t maxDepth;
 
@@ -80,30 +88,45 @@ public:
     ~WorkQueue()
     {
     }
-    /** Enqueue a work item */
-    bool Enqueue(WorkItem* item)
+    /** Enqueue a work item. Each priority lane has its own depth limit, so
+     * a burst of low-priority work cannot occupy all queue slots either. */
+    bool Enqueue(WorkItem* item, bool low_priority = false)
     {
         LOCK(cs);
-        if (queue.size() >= maxDepth) {
+        std::deque<std::unique_ptr<WorkItem>>& lane = low_priority ? m_low_queue : queue;
+        if (lane.size() >= maxDepth) {
             return false;
         }
-        queue.emplace_back(std::unique_ptr<WorkItem>(item));
-        cond.notify_one();
+        lane.emplace_back(std::unique_ptr<WorkItem>(item));
+        if (low_priority) {
+            // notify_one could wake a reserved worker, which would go back
+            // to sleep without another worker ever seeing the item.
+            cond.notify_all();
+        } else {
+            cond.notify_one();
+        }
         return true;
     }
-    /** Thread function */
-    void Run()
+    /** Thread function. Workers started with skip_low_priority only serve
+     * the normal lane, guaranteeing capacity for it; all workers prefer
+     * normal items when both lanes are non-empty. */
+    void Run(bool skip_low_priority)
     {
         while (true) {
             std::unique_ptr<WorkItem> i;
             {
                 WAIT_LOCK(cs, lock);
-                while (running && queue.empty())
+                while (running && queue.empty() && (skip_low_priority || m_low_queue.empty()))
                     cond.wait(lock);
                 if (!running)
                     break;
-                i = std::move(queue.front());
-                queue.pop_front();
+                if (!queue.empty()) {
+                    i = std::move(queue.front());
+                    queue.pop_front();
+                } else {
+                    i = std::move(m_low_queue.front());
+                    m_low_queue.pop_front();
+                }
             }
             (*i)();
         }
@@ -140,6 +163,10 @@ static std::vector<CSubNet> rpc_allow_subnets;
 static WorkQueue<HTTPClosure>* workQueue = nullptr;
 //! Handlers for (sub)paths
 static std::vector<HTTPPathHandler> pathHandlers;
+//! RPC methods served from the low-priority work queue lane
+static std::set<std::string> g_low_priority_methods;
+//! RPC usernames whose requests are served from the low-priority lane
+static std::set<std::string> g_low_priority_users;
 //! Bound listening sockets
 static std::vector<evhttp_bound_socket *> boundSockets;
 
@@ -203,6 +230,51 @@ std::string RequestMethodString(HTTPRequest::RequestMethod m)
     }
 }
 
+/** Extract the JSON-RPC method name from a request body without parsing the
+ * full document. Only the leading part of the body is examined, and for
+ * batch requests only the first method is found; requests whose method
+ * cannot be determined cheaply stay in the normal lane. */
+static std::string ScanRPCMethod(const std::string& body)
+{
+    const size_t pos = body.find("\"method\"");
+    if (pos == std::string::npos) return "";
+    size_t cur = pos + 8;
+    while (cur < body.size() && (IsSpace(body[cur]) || body[cur] == ':')) ++cur;
+    if (cur >= body.size() || body[cur] != '"') return "";
+    ++cur;
+    // Method names contain no escape sequences, so scan to the closing quote
+    const size_t end = body.find('"', cur);
+    if (end == std::string::npos) return "";
+    return body.substr(cur, end - cur);
+}
+
+/** Decode the username from a Basic Authorization header value. */
+static std::string BasicAuthUser(const std::string& auth_header)
+{
+    if (auth_header.substr(0, 6) != "Basic ") return "";
+    const std::string user_pass = DecodeBase64(TrimString(auth_header.substr(6)));
+    return user_pass.substr(0, user_pass.find(':'));
+}
+
+/** Classify a request into a work queue lane. */
+static bool IsLowPriorityRequest(HTTPRequest* req)
+{
+    if (!g_low_priority_users.empty()) {
+        std::pair<bool, std::string> auth_header = req->GetHeader("authorization");
+        if (auth_header.first && g_low_priority_users.count(BasicAuthUser(auth_header.second))) {
+            return true;
+        }
+    }
+    if (!g_low_priority_methods.empty() && req->GetRequestMethod() == HTTPRequest::POST) {
+        //! Bytes of the body examined when looking for the method name
+        constexpr size_t MAX_METHOD_SCAN_SIZE{4096};
+        if (g_low_priority_methods.count(ScanRPCMethod(req->PeekBody(MAX_METHOD_SCAN_SIZE)))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /** HTTP request callback */
 static void http_request_cb(struct evhttp_request* req, void* arg)
 {
@@ -256,9 +328,10 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
 
     // Dispatch to worker thread
     if (i != iend) {
+        const bool low_priority = IsLowPriorityRequest(hreq.get());
         std::unique_ptr<HTTPWorkItem> item(new HTTPWorkItem(std::move(hreq), path, i->handler));
         assert(workQueue);
-        if (workQueue->Enqueue(item.get()))
+        if (workQueue->Enqueue(item.get(), low_priority))
             item.release(); /* if true, queue took ownership */
         else {
             LogPrintf("WARNING: request rejected because http work queue depth exceeded, it can be increased with the -rpcworkqueue= setting\n");
@@ -330,10 +403,10 @@ static bool HTTPBindAddresses(struct evhttp* http)
 }
 
 /** Simple wrapper to set thread name and run work queue */
-static void HTTPWorkQueueRun(WorkQueue<HTTPClosure>* queue, int worker_num)
+static void HTTPWorkQueueRun(WorkQueue<HTTPClosure>* queue, int worker_num, bool skip_low_priority)
 {
     util::ThreadRename(strprintf("httpworker.%i", worker_num));
-    queue->Run();
+    queue->Run(skip_low_priority);
 }
 
 /** libevent event log callback */
@@ -394,6 +467,12 @@ bool InitHTTPServer()
     LogPrintf("HTTP: creating work queue of depth %d\n", workQueueDepth);
 
     workQueue = new WorkQueue<HTTPClosure>(workQueueDepth);
+    for (const std::string& method : gArgs.GetArgs("-rpclowprioritymethod")) {
+        g_low_priority_methods.insert(method);
+    }
+    for (const std::string& user : gArgs.GetArgs("-rpclowpriorityuser")) {
+        g_low_priority_users.insert(user);
+    }
     // transfer ownership to eventBase/HTTP via .release()
     eventBase = base_ctr.release();
     eventHTTP = http_ctr.release();
@@ -421,11 +500,18 @@ void StartHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Starting HTTP server\n");
     int rpcThreads = std::max((long)gArgs.GetArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
-    LogPrintf("HTTP: starting %d worker threads\n", rpcThreads);
+    // Reserve workers for the normal lane only when a low-priority lane is
+    // configured; at least one worker must remain shared so the low lane
+    // cannot stall entirely.
+    int reservedThreads = 0;
+    if (!g_low_priority_methods.empty() || !g_low_priority_users.empty()) {
+        reservedThreads = std::min((long)rpcThreads - 1, std::max((long)gArgs.GetArg("-rpcreservedthreads", DEFAULT_HTTP_RESERVED_THREADS), 0L));
+    }
+    LogPrintf("HTTP: starting %d worker threads (%d reserved for normal-priority requests)\n", rpcThreads, reservedThreads);
     g_thread_http = std::thread(ThreadHTTP, eventBase);
 
     for (int i = 0; i < rpcThreads; i++) {
-        g_thread_http_workers.emplace_back(HTTPWorkQueueRun, workQueue, i);
+        g_thread_http_workers.emplace_back(HTTPWorkQueueRun, workQueue, i, /* skip_low_priority */ i < reservedThreads);
     }
 }
 
@@ -549,6 +635,47 @@ std::string HTTPRequest::ReadBody()
     return rv;
 }
 
+std::string HTTPRequest::PeekBody(size_t max_size)
+{
+    struct evbuffer* buf = evhttp_request_get_input_buffer(req);
+    if (!buf)
+        return "";
+    size_t size = std::min(evbuffer_get_length(buf), max_size);
+    const char* data = (const char*)evbuffer_pullup(buf, size);
+    if (!data) // returns nullptr in case of empty buffer
+        return "";
+    return std::string(data, size);
+}
+
+void HTTPRequest::AppendReplyBodyReference(const void* data, size_t size, std::function<void()> cleanup)
+{
+    assert(!replySent && req);
+    struct evbuffer* evb = evhttp_request_get_output_buffer(req);
+    assert(evb);
+    if (!m_compression_decided) {
+        // Zero-copy replies carry raw file bytes; serve them uncompressed.
+        m_compression_decided = true;
+    }
+    if (m_compressor) {
+        // A compressed reply is already underway; fold the bytes in.
+        m_compressor->Write({(const unsigned char*)data, size});
+        cleanup();
+        return;
+    }
+    auto cleanup_fn = new std::function<void()>(std::move(cleanup));
+    const auto cleanup_cb = [](const void*, size_t, void* extra) {
+        auto fn = static_cast<std::function<void()>*>(extra);
+        (*fn)();
+        delete fn;
+    };
+    if (evbuffer_add_reference(evb, data, size, cleanup_cb, cleanup_fn) != 0) {
+        // Referencing failed; fall back to copying the bytes in.
+        evbuffer_add(evb, data, size);
+        (*cleanup_fn)();
+        delete cleanup_fn;
+    }
+}
+
 void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
 {
     struct evkeyvalq* headers = evhttp_request_get_output_headers(req);
@@ -556,6 +683,54 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
     evhttp_add_header(headers, hdr.c_str(), value.c_str());
 }
 
+bool HTTPRequest::ClientAcceptsGzip() const
+{
+    const std::pair<bool, std::string> accept = GetHeader("accept-encoding");
+    if (!accept.first) return false;
+    // Comma-separated codings, each optionally followed by parameters
+    // (";q=0" disables a coding).
+    size_t start = 0;
+    while (start <= accept.second.size()) {
+        size_t end = accept.second.find(',', start);
+        if (end == std::string::npos) end = accept.second.size();
+        std::string coding = TrimString(accept.second.substr(start, end - start));
+        start = end + 1;
+        bool disabled = false;
+        const size_t params = coding.find(';');
+        if (params != std::string::npos) {
+            disabled = TrimString(coding.substr(params + 1)) == "q=0";
+            coding = TrimString(coding.substr(0, params));
+        }
+        if ((coding == "gzip" || coding == "x-gzip") && !disabled) return true;
+    }
+    return false;
+}
+
+void HTTPRequest::StartCompression()
+{
+    struct evbuffer* evb = evhttp_request_get_output_buffer(req);
+    assert(evb);
+    m_compressor = std::make_unique<GZipEncoder>([evb](const unsigned char* data, size_t size) {
+        evbuffer_add(evb, data, size);
+    });
+}
+
+void HTTPRequest::AppendReplyBody(const char* data, size_t size)
+{
+    assert(!replySent && req);
+    struct evbuffer* evb = evhttp_request_get_output_buffer(req);
+    assert(evb);
+    if (!m_compression_decided) {
+        m_compression_decided = true;
+        if (ClientAcceptsGzip()) StartCompression();
+    }
+    if (m_compressor) {
+        m_compressor->Write({(const unsigned char*)data, size});
+        return;
+    }
+    evbuffer_add(evb, data, size);
+}
+
 /** Closure sent to main thread to request a reply to be sent to
  * a HTTP request.
  * Replies must be sent in the main loop in the main http thread,
@@ -570,7 +745,21 @@ void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
     // Send event to main http thread to send reply message
     struct evbuffer* evb = evhttp_request_get_output_buffer(req);
     assert(evb);
-    evbuffer_add(evb, strReply.data(), strReply.size());
+    // Compress one-shot replies that are worth the effort; streamed replies
+    // made the decision at their first AppendReplyBody call.
+    if (!m_compression_decided && nStatus == HTTP_OK && strReply.size() >= MIN_COMPRESSED_REPLY_SIZE && ClientAcceptsGzip()) {
+        m_compression_decided = true;
+        StartCompression();
+    }
+    if (m_compressor) {
+        m_compressor->Write({(const unsigned char*)strReply.data(), strReply.size()});
+        m_compressor->Finish();
+        m_compressor.reset();
+        WriteHeader("Content-Encoding", "gzip");
+        WriteHeader("Vary", "Accept-Encoding");
+    } else {
+        evbuffer_add(evb, strReply.data(), strReply.size());
+    }
     auto req_copy = req;
     HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
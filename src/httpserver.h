@@ -5,16 +5,19 @@
 #ifndef BITCOIN_HTTPSERVER_H
 #define BITCOIN_HTTPSERVER_H
 
-#include <string>
 #include <functional>
+#include <memory>
+#include <string>
 
 static const int DEFAULT_HTTP_THREADS=4;
 static const int DEFAULT_HTTP_WORKQUEUE=16;
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
+static const int DEFAULT_HTTP_RESERVED_THREADS=1;
 
 struct evhttp_request;
 struct event_base;
 class CService;
+class GZipEncoder;
 class HTTPRequest;
 
 /** Initialize HTTP server.
@@ -58,6 +61,16 @@ class HTTPRequest
 private:
     struct evhttp_request* req;
     bool replySent;
+    //! Streaming compressor, when this reply is being gzipped
+    std::unique_ptr<GZipEncoder> m_compressor;
+    //! Whether the compress-or-not decision for this reply has been made
+    bool m_compression_decided{false};
+
+    /** Whether the client's Accept-Encoding header allows a gzip reply. */
+    bool ClientAcceptsGzip() const;
+    /** Route all further body bytes through a gzip compressor writing into
+     * the output buffer. */
+    void StartCompression();
 
 public:
     explicit HTTPRequest(struct evhttp_request* req, bool replySent = false);
@@ -97,6 +110,13 @@ public:
      */
     std::string ReadBody();
 
+    /**
+     * Peek at the leading part of the request body without consuming it.
+     * At most max_size bytes are returned; a later ReadBody() still sees
+     * the whole body.
+     */
+    std::string PeekBody(size_t max_size);
+
     /**
      * Write output header.
      *
@@ -104,6 +124,24 @@ public:
      */
     void WriteHeader(const std::string& hdr, const std::string& value);
 
+    /**
+     * Append data to the reply body.
+     *
+     * @note Can be called multiple times before WriteReply; the accumulated
+     * body is sent, followed by anything passed to WriteReply, once WriteReply
+     * is called. Lets handlers stream large replies straight into the output
+     * buffer instead of assembling them in one string first.
+     */
+    void AppendReplyBody(const char* data, size_t size);
+
+    /**
+     * Append data to the reply body without copying it. The buffer only
+     * references the bytes; cleanup is invoked once libevent has finished
+     * sending them, and the caller must keep them valid (and unchanged)
+     * until then. Meant for handing out memory-mapped file contents.
+     */
+    void AppendReplyBodyReference(const void* data, size_t size, std::function<void()> cleanup);
+
     /**
      * Write HTTP reply.
      * nStatus is the HTTP status code to send.
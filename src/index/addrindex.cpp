@@ -0,0 +1,267 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <coins.h>
+#include <crypto/sha256.h>
+#include <index/addrindex.h>
+#include <serialize.h>
+#include <undo.h>
+#include <util/system.h>
+#include <validation.h>
+
+#include <map>
+#include <set>
+
+/* The index database stores one record per funding or spending event. Keys
+ * have the type [DB_ADDR_EVENT, script digest, uint32 height (BE), event
+ * type, COutPoint], so all records for one script are adjacent, ordered by
+ * height, with funding events of a height sorting before spending events.
+ * Every record for a script shares a 37-byte key prefix, which leveldb's
+ * block-level prefix compression collapses to a couple of bytes per record.
+ *
+ * For EVENT_FUND the outpoint is the created output and the value is its
+ * amount; for EVENT_SPEND the outpoint is the spent prevout and the value is
+ * the txid of the spending transaction.
+ */
+constexpr char DB_ADDR_EVENT = 'a';
+
+constexpr uint8_t EVENT_FUND{0};
+constexpr uint8_t EVENT_SPEND{1};
+
+namespace {
+
+//! Digest keying all records for one scriptPubKey. Hashing rather than using
+//! the raw script bounds the key size regardless of script size.
+uint256 ScriptId(const CScript& script)
+{
+    uint256 ret;
+    CSHA256().Write(script.data(), script.size()).Finalize(ret.begin());
+    return ret;
+}
+
+//! Seek target positioned just before every event record of one script.
+struct DBPrefixKey {
+    uint256 script_id;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_ADDR_EVENT);
+        script_id.Serialize(s);
+    }
+};
+
+struct DBEventKey {
+    uint256 script_id;
+    uint32_t height;
+    uint8_t event;
+    COutPoint outpoint;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_ADDR_EVENT);
+        script_id.Serialize(s);
+        ser_writedata32be(s, height);
+        ser_writedata8(s, event);
+        outpoint.hash.Serialize(s);
+        ser_writedata32(s, outpoint.n);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const char prefix{static_cast<char>(ser_readdata8(s))};
+        if (prefix != DB_ADDR_EVENT) {
+            throw std::ios_base::failure("Invalid format for addrindex DB event key");
+        }
+        script_id.Unserialize(s);
+        height = ser_readdata32be(s);
+        event = ser_readdata8(s);
+        outpoint.hash.Unserialize(s);
+        outpoint.n = ser_readdata32(s);
+    }
+};
+
+/**
+ * Apply op to every event record a block produces. Shared between WriteBlock
+ * and EraseBlock so that a rewind erases exactly the keys the connect wrote.
+ * For funding events the amount carries the created output's value; for
+ * spending events the spender carries the spending transaction's txid.
+ */
+template <typename Op>
+bool ForEachBlockEvent(const CBlock& block, const CBlockIndex* pindex, Op op)
+{
+    CBlockUndo block_undo;
+
+    // The genesis block has no undo data and its outputs are not spendable.
+    if (pindex->nHeight == 0) return true;
+
+    if (!UndoReadFromDisk(block_undo, pindex)) {
+        return error("%s: could not read undo data for block %s", __func__,
+                     pindex->GetBlockHash().ToString());
+    }
+
+    // TODO: Deduplicate BIP30 related code
+    const bool is_bip30_block{(pindex->nHeight == 91722 && pindex->GetBlockHash() == uint256S("00000000000271a2dc26e7667f8419f2e15416dc6955e5a6c6cdf3f2574dd08e")) ||
+                              (pindex->nHeight == 91812 && pindex->GetBlockHash() == uint256S("00000000000af0aed4792b1acee3d966af36cf5def14935db8de83d6f9306f2f"))};
+
+    const uint32_t height{static_cast<uint32_t>(pindex->nHeight)};
+    for (size_t i = 0; i < block.vtx.size(); ++i) {
+        const auto& tx{block.vtx.at(i)};
+
+        // Skip duplicate txid coinbase transactions (BIP30); their outputs
+        // were overwritten and can never be spent.
+        if (is_bip30_block && tx->IsCoinBase()) {
+            continue;
+        }
+
+        for (size_t j = 0; j < tx->vout.size(); ++j) {
+            const CTxOut& out{tx->vout[j]};
+            if (out.scriptPubKey.IsUnspendable()) continue;
+
+            op(DBEventKey{ScriptId(out.scriptPubKey), height, EVENT_FUND,
+                          COutPoint{tx->GetHash(), static_cast<uint32_t>(j)}},
+               out.nValue, tx->GetHash());
+        }
+
+        // The coinbase tx has no undo data since no former output is spent
+        if (!tx->IsCoinBase()) {
+            const auto& tx_undo{block_undo.vtxundo.at(i - 1)};
+
+            for (size_t j = 0; j < tx_undo.vprevout.size(); ++j) {
+                const Coin& coin{tx_undo.vprevout[j]};
+
+                op(DBEventKey{ScriptId(coin.out.scriptPubKey), height, EVENT_SPEND,
+                              tx->vin[j].prevout},
+                   coin.out.nValue, tx->GetHash());
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::unique_ptr<AddrIndex> g_addr_index;
+
+AddrIndex::AddrIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+{
+    fs::path path{GetDataDir() / "indexes" / "addrindex"};
+    fs::create_directories(path);
+
+    m_db = std::make_unique<BaseIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+}
+
+bool AddrIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    CDBBatch& batch = SyncBatch();
+    return ForEachBlockEvent(block, pindex, [&](const DBEventKey& key, CAmount amount, const uint256& spender) {
+        if (key.event == EVENT_FUND) {
+            batch.Write(key, amount);
+        } else {
+            batch.Write(key, spender);
+        }
+    });
+}
+
+bool AddrIndex::EraseBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    // Staging the erasures makes them land in the same flush as (and after)
+    // any not-yet-flushed writes for these blocks.
+    CDBBatch& batch = SyncBatch();
+    return ForEachBlockEvent(block, pindex, [&](const DBEventKey& key, CAmount, const uint256&) {
+        batch.Erase(key);
+    });
+}
+
+bool AddrIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip)
+{
+    assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
+
+    // Remove the records of the disconnected blocks, recomputed from the
+    // block and its undo data just like they were written.
+    {
+        LOCK(cs_main);
+        const CBlockIndex* iter_tip{g_chainman.m_blockman.LookupBlockIndex(current_tip->GetBlockHash())};
+        const auto& consensus_params{Params().GetConsensus()};
+
+        do {
+            CBlock block;
+
+            if (!ReadBlockFromDisk(block, iter_tip, consensus_params)) {
+                return error("%s: Failed to read block %s from disk",
+                             __func__, iter_tip->GetBlockHash().ToString());
+            }
+
+            if (!EraseBlock(block, iter_tip)) {
+                return false;
+            }
+
+            iter_tip = iter_tip->GetAncestor(iter_tip->nHeight - 1);
+        } while (new_tip != iter_tip);
+    }
+
+    return BaseIndex::Rewind(current_tip, new_tip);
+}
+
+bool AddrIndex::FindTxIds(const CScript& script, std::vector<std::pair<int, uint256>>& result) const
+{
+    const uint256 script_id{ScriptId(script)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+
+    std::set<uint256> seen;
+    db_it->Seek(DBPrefixKey{script_id});
+    for (; db_it->Valid(); db_it->Next()) {
+        DBEventKey key;
+        if (!db_it->GetKey(key) || key.script_id != script_id) break;
+
+        if (key.event == EVENT_FUND) {
+            if (seen.insert(key.outpoint.hash).second) {
+                result.emplace_back(key.height, key.outpoint.hash);
+            }
+        } else {
+            uint256 spender;
+            if (!db_it->GetValue(spender)) {
+                return error("%s: unable to read value in %s", __func__, GetName());
+            }
+            if (seen.insert(spender).second) {
+                result.emplace_back(key.height, spender);
+            }
+        }
+    }
+    return true;
+}
+
+bool AddrIndex::FindUtxos(const CScript& script, std::vector<AddrIndexUtxo>& result) const
+{
+    const uint256 script_id{ScriptId(script)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+
+    // Replay the events in height order: funding events add an output,
+    // spending events remove it again.
+    std::map<COutPoint, AddrIndexUtxo> utxos;
+    db_it->Seek(DBPrefixKey{script_id});
+    for (; db_it->Valid(); db_it->Next()) {
+        DBEventKey key;
+        if (!db_it->GetKey(key) || key.script_id != script_id) break;
+
+        if (key.event == EVENT_FUND) {
+            CAmount amount;
+            if (!db_it->GetValue(amount)) {
+                return error("%s: unable to read value in %s", __func__, GetName());
+            }
+            utxos[key.outpoint] = AddrIndexUtxo{key.outpoint, amount, static_cast<int>(key.height)};
+        } else {
+            utxos.erase(key.outpoint);
+        }
+    }
+
+    result.reserve(utxos.size());
+    for (auto& entry : utxos) {
+        result.push_back(std::move(entry.second));
+    }
+    return true;
+}
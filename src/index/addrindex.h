@@ -0,0 +1,68 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_ADDRINDEX_H
+#define BITCOIN_INDEX_ADDRINDEX_H
+
+#include <amount.h>
+#include <index/base.h>
+#include <primitives/transaction.h>
+
+#include <utility>
+#include <vector>
+
+class CScript;
+
+static constexpr bool DEFAULT_ADDRINDEX{false};
+
+/** One unspent output paying an indexed scriptPubKey. */
+struct AddrIndexUtxo {
+    COutPoint outpoint;
+    CAmount value;
+    int height;
+};
+
+/**
+ * AddrIndex maintains a scriptPubKey -> (txid, vout, height) mapping for the
+ * whole chain. For every block it records which outputs paying a script were
+ * created and which were spent (the latter recovered from the block's undo
+ * data), keyed by a digest of the script so that all records for one script
+ * are adjacent and sorted by height. This answers "which transactions touched
+ * this address" and "which outputs of this address are unspent" without
+ * scanning the chain or the UTXO set.
+ */
+class AddrIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+    bool EraseBlock(const CBlock& block, const CBlockIndex* pindex);
+
+protected:
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip) override;
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+    const char* GetName() const override { return "addrindex"; }
+
+public:
+    // Constructs the index, which becomes available to be queried.
+    explicit AddrIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Get the txid of every confirmed transaction that created or spent an
+    /// output paying the given script, together with the height it confirmed
+    /// at, in chain order.
+    bool FindTxIds(const CScript& script, std::vector<std::pair<int, uint256>>& result) const;
+
+    /// Get all confirmed, unspent outputs paying the given script. The
+    /// mempool is not taken into account.
+    bool FindUtxos(const CScript& script, std::vector<AddrIndexUtxo>& result) const;
+};
+
+/// The global address index. May be null.
+extern std::unique_ptr<AddrIndex> g_addr_index;
+
+#endif // BITCOIN_INDEX_ADDRINDEX_H
@@ -6,17 +6,33 @@
 #include <index/base.h>
 #include <node/ui_interface.h>
 #include <shutdown.h>
+#include <sync.h>
 #include <tinyformat.h>
 #include <util/system.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <warnings.h>
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <thread>
+
 constexpr char DB_BEST_BLOCK = 'B';
 
 constexpr int64_t SYNC_LOG_INTERVAL = 30; // seconds
 constexpr int64_t SYNC_LOCATOR_WRITE_INTERVAL = 30; // seconds
 
+//! Hard cap on -indexworkers.
+constexpr int MAX_INDEX_WORKERS = 16;
+//! Number of blocks the sync worker threads read (and pre-process) ahead of
+//! the block being indexed. Bounds the memory held by blocks in flight.
+constexpr size_t SYNC_LOOKAHEAD = 32;
+//! Approximate size at which the batch of staged index writes is flushed to
+//! the database during the initial sync.
+constexpr size_t SYNC_BATCH_SIZE = 16 << 20; // 16 MiB
+
 template <typename... Args>
 static void FatalError(const char* fmt, const Args&... args)
 {
@@ -105,6 +121,103 @@ bool BaseIndex::Init()
     return true;
 }
 
+namespace {
+
+/**
+ * Reads blocks from disk ahead of the ThreadSync consumer and runs the
+ * index's order-independent pre-processing on them, using a small pool of
+ * worker threads. The consumer retrieves blocks in the order it scheduled
+ * them; reorg handling stays in the consumer, which drains and reschedules
+ * when the chain it scheduled from is no longer active.
+ */
+class BlockFetcher
+{
+public:
+    using PrecomputeFn = std::function<void(const CBlock&, const CBlockIndex*)>;
+
+    BlockFetcher(int num_workers, const Consensus::Params& consensus_params, PrecomputeFn precompute)
+        : m_consensus_params(consensus_params), m_precompute(std::move(precompute))
+    {
+        for (int i = 0; i < num_workers; ++i) {
+            m_workers.emplace_back(&TraceThread<std::function<void()>>, "indexfetch",
+                                   std::function<void()>([this] { WorkerLoop(); }));
+        }
+    }
+
+    ~BlockFetcher()
+    {
+        WITH_LOCK(m_mutex, m_stop = true);
+        m_cv_work.notify_all();
+        for (auto& worker : m_workers) worker.join();
+    }
+
+    //! Queue a block to be read and pre-processed in the background.
+    void Schedule(const CBlockIndex* pindex)
+    {
+        WITH_LOCK(m_mutex, m_work.push_back(pindex));
+        m_cv_work.notify_one();
+    }
+
+    //! Retrieve a previously scheduled block, waiting until it has been read.
+    //! Returns false if the block could not be read from disk.
+    bool Fetch(const CBlockIndex* pindex, CBlock& block)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_cv_done.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_done.count(pindex) > 0; });
+        auto it = m_done.find(pindex);
+        bool ok = it->second.second;
+        block = std::move(it->second.first);
+        m_done.erase(it);
+        return ok;
+    }
+
+private:
+    void WorkerLoop()
+    {
+        while (true) {
+            const CBlockIndex* pindex{nullptr};
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv_work.wait(lock, [this]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || !m_work.empty(); });
+                if (m_stop) return;
+                pindex = m_work.front();
+                m_work.pop_front();
+            }
+
+            CBlock block;
+            bool ok = ReadBlockFromDisk(block, pindex, m_consensus_params);
+            if (ok && m_precompute) m_precompute(block, pindex);
+
+            WITH_LOCK(m_mutex, m_done.emplace(pindex, std::make_pair(std::move(block), ok)));
+            m_cv_done.notify_all();
+        }
+    }
+
+    const Consensus::Params& m_consensus_params;
+    const PrecomputeFn m_precompute;
+
+    Mutex m_mutex;
+    std::condition_variable m_cv_work;
+    std::condition_variable m_cv_done;
+    std::deque<const CBlockIndex*> m_work GUARDED_BY(m_mutex);
+    std::map<const CBlockIndex*, std::pair<CBlock, bool>> m_done GUARDED_BY(m_mutex);
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_workers;
+};
+
+//! Number of sync worker threads to use, from -indexworkers (0 = one per
+//! core, leaving headroom for the consumer and the rest of the node).
+int IndexWorkerCount()
+{
+    int workers = gArgs.GetArg("-indexworkers", DEFAULT_INDEX_WORKERS);
+    if (workers <= 0) {
+        workers = std::max(GetNumCores() - 1, 1);
+    }
+    return std::min(workers, MAX_INDEX_WORKERS);
+}
+
+} // namespace
+
 static const CBlockIndex* NextSyncBlock(const CBlockIndex* pindex_prev) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
 {
     AssertLockHeld(cs_main);
@@ -127,6 +240,11 @@ void BaseIndex::ThreadSync()
     if (!m_synced) {
         auto& consensus_params = Params().GetConsensus();
 
+        BlockFetcher fetcher(IndexWorkerCount(), consensus_params,
+                             [this](const CBlock& block, const CBlockIndex* index) { PrecomputeBlock(block, index); });
+        // Blocks handed to the fetcher but not indexed yet, in chain order.
+        std::deque<const CBlockIndex*> scheduled;
+
         int64_t last_log_time = 0;
         int64_t last_locator_write_time = 0;
         while (true) {
@@ -139,22 +257,70 @@ void BaseIndex::ThreadSync()
                 return;
             }
 
+            std::deque<const CBlockIndex*> stale;
             {
                 LOCK(cs_main);
-                const CBlockIndex* pindex_next = NextSyncBlock(pindex);
-                if (!pindex_next) {
-                    m_best_block_index = pindex;
-                    m_synced = true;
-                    // No need to handle errors in Commit. See rationale above.
-                    Commit();
-                    break;
+                if (!scheduled.empty() && !::ChainActive().Contains(scheduled.front())) {
+                    // The chain was reorganized past blocks that are already
+                    // in the fetch pipeline. Drain them (outside cs_main) and
+                    // reschedule from the new active chain.
+                    stale.swap(scheduled);
+                } else {
+                    const CBlockIndex* pindex_next;
+                    if (scheduled.empty()) {
+                        pindex_next = NextSyncBlock(pindex);
+                        if (!pindex_next) {
+                            m_best_block_index = pindex;
+                            m_synced = true;
+                            // No need to handle errors in Commit. See rationale above.
+                            Commit();
+                            break;
+                        }
+                        fetcher.Schedule(pindex_next);
+                        scheduled.push_back(pindex_next);
+                    } else {
+                        pindex_next = scheduled.front();
+                    }
+                    scheduled.pop_front();
+
+                    if (pindex_next->pprev != pindex && !Rewind(pindex, pindex_next->pprev)) {
+                        FatalError("%s: Failed to rewind index %s to a previous chain tip",
+                                   __func__, GetName());
+                        return;
+                    }
+
+                    // Keep the fetch pipeline topped up along the active chain.
+                    const CBlockIndex* tail = scheduled.empty() ? pindex_next : scheduled.back();
+                    while (scheduled.size() < SYNC_LOOKAHEAD) {
+                        const CBlockIndex* next = ::ChainActive().Next(tail);
+                        if (!next) break;
+                        fetcher.Schedule(next);
+                        scheduled.push_back(next);
+                        tail = next;
+                    }
+
+                    pindex = pindex_next;
                 }
-                if (pindex_next->pprev != pindex && !Rewind(pindex, pindex_next->pprev)) {
-                    FatalError("%s: Failed to rewind index %s to a previous chain tip",
-                               __func__, GetName());
-                    return;
+            }
+
+            if (!stale.empty()) {
+                CBlock dummy;
+                for (const CBlockIndex* stale_index : stale) {
+                    fetcher.Fetch(stale_index, dummy);
                 }
-                pindex = pindex_next;
+                continue;
+            }
+
+            CBlock block;
+            if (!fetcher.Fetch(pindex, block)) {
+                FatalError("%s: Failed to read block %s from disk",
+                           __func__, pindex->GetBlockHash().ToString());
+                return;
+            }
+            if (!WriteBlock(block, pindex)) {
+                FatalError("%s: Failed to write block %s to index database",
+                           __func__, pindex->GetBlockHash().ToString());
+                return;
             }
 
             int64_t current_time = GetTime();
@@ -164,24 +330,17 @@ void BaseIndex::ThreadSync()
                 last_log_time = current_time;
             }
 
-            if (last_locator_write_time + SYNC_LOCATOR_WRITE_INTERVAL < current_time) {
+            // Flush once enough staged writes have accumulated or enough
+            // time has passed. The locator goes into the same atomic write
+            // as the entries it covers, so it acts as the high-water mark of
+            // what is durably indexed.
+            if ((m_sync_batch && m_sync_batch->SizeEstimate() >= SYNC_BATCH_SIZE) ||
+                last_locator_write_time + SYNC_LOCATOR_WRITE_INTERVAL < current_time) {
                 m_best_block_index = pindex;
                 last_locator_write_time = current_time;
                 // No need to handle errors in Commit. See rationale above.
                 Commit();
             }
-
-            CBlock block;
-            if (!ReadBlockFromDisk(block, pindex, consensus_params)) {
-                FatalError("%s: Failed to read block %s from disk",
-                           __func__, pindex->GetBlockHash().ToString());
-                return;
-            }
-            if (!WriteBlock(block, pindex)) {
-                FatalError("%s: Failed to write block %s to index database",
-                           __func__, pindex->GetBlockHash().ToString());
-                return;
-            }
         }
     }
 
@@ -192,10 +351,32 @@ void BaseIndex::ThreadSync()
     }
 }
 
+CDBBatch& BaseIndex::SyncBatch()
+{
+    if (!m_sync_batch) {
+        m_sync_batch = std::make_unique<CDBBatch>(GetDB());
+    }
+    return *m_sync_batch;
+}
+
+bool BaseIndex::FlushSyncBatch()
+{
+    if (!m_sync_batch) return true;
+    if (!GetDB().WriteBatch(*m_sync_batch)) {
+        return error("%s: Failed to write %s index batch", __func__, GetName());
+    }
+    m_sync_batch->Clear();
+    return true;
+}
+
 bool BaseIndex::Commit()
 {
-    CDBBatch batch(GetDB());
-    if (!CommitInternal(batch) || !GetDB().WriteBatch(batch)) {
+    // Committing through the sync batch makes any staged WriteBlock entries
+    // and the locator covering them one atomic database write.
+    CDBBatch& batch = SyncBatch();
+    const bool success = CommitInternal(batch) && GetDB().WriteBatch(batch);
+    batch.Clear();
+    if (!success) {
         return error("%s: Failed to commit latest %s state", __func__, GetName());
     }
     return true;
@@ -261,7 +442,7 @@ void BaseIndex::BlockConnected(const std::shared_ptr<const CBlock>& block, const
         }
     }
 
-    if (WriteBlock(*block, pindex)) {
+    if (WriteBlock(*block, pindex) && FlushSyncBatch()) {
         m_best_block_index = pindex;
     } else {
         FatalError("%s: Failed to write block %s to index",
@@ -369,3 +550,8 @@ IndexSummary BaseIndex::GetSummary() const
     summary.best_block_height = m_best_block_index ? m_best_block_index.load()->nHeight : 0;
     return summary;
 }
+
+bool BaseIndex::GetDBProperty(const std::string& name, std::string& out) const
+{
+    return GetDB().GetProperty(name, out);
+}
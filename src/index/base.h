@@ -13,6 +13,9 @@
 
 class CBlockIndex;
 
+/** Default number of worker threads used for the initial sync of an index (0 = determine automatically). */
+static constexpr int DEFAULT_INDEX_WORKERS{0};
+
 struct IndexSummary {
     std::string name;
     bool synced{false};
@@ -59,6 +62,14 @@ private:
     std::thread m_thread_sync;
     CThreadInterrupt m_interrupt;
 
+    /// Pending database writes staged by WriteBlock implementations through
+    /// SyncBatch(). Created lazily on first use.
+    std::unique_ptr<CDBBatch> m_sync_batch;
+
+    /// Write any staged WriteBlock entries to the database, without updating
+    /// the best block locator.
+    bool FlushSyncBatch();
+
     /// Sync the index with the block index starting from the current best block.
     /// Intended to be run in its own thread, m_thread_sync, and can be
     /// interrupted with m_interrupt. Once the index gets in sync, the m_synced
@@ -87,6 +98,29 @@ protected:
     /// Write update index entries for a newly connected block.
     virtual bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) { return true; }
 
+    /// Batch that WriteBlock (and Rewind) implementations should stage their
+    /// database writes into, instead of writing to the database directly.
+    /// During the initial sync several blocks' worth of writes accumulate in
+    /// it, and it is flushed in one leveldb write together with the best
+    /// block locator covering them, so the persisted locator never runs
+    /// ahead of the persisted entries. Outside the initial sync it is
+    /// flushed after every block.
+    ///
+    /// Only suitable for implementations that never read back another
+    /// block's entries in WriteBlock, since staged writes are not visible to
+    /// reads until the batch is flushed.
+    CDBBatch& SyncBatch();
+
+    /// Optional order-independent part of processing a block. During initial
+    /// sync this is called by the sync worker threads, possibly out of block
+    /// order, some time before WriteBlock is called for the same block.
+    /// Implementations can use it to precompute expensive per-block data and
+    /// cache it (keyed by block hash) for WriteBlock to consume. They must be
+    /// thread-safe and must not assume that WriteBlock gets called for every
+    /// block passed here (blocks can be reorganized out before they are
+    /// indexed).
+    virtual void PrecomputeBlock(const CBlock& block, const CBlockIndex* pindex) {}
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CommitInternal(CDBBatch& batch);
@@ -97,6 +131,14 @@ protected:
 
     virtual DB& GetDB() const = 0;
 
+    /// The last block the index is in sync with, as determined during Init or
+    /// while syncing. May be null if the index is empty.
+    const CBlockIndex* CurrentIndex() const { return m_best_block_index.load(); }
+
+    /// Whether the index has caught up with the chain at least once, after
+    /// which it is updated block by block from validation notifications.
+    bool IsSynced() const { return m_synced.load(); }
+
     /// Get the name of the index for display in logs.
     virtual const char* GetName() const = 0;
 
@@ -122,6 +164,10 @@ public:
 
     /// Get a summary of the index and its state.
     IndexSummary GetSummary() const;
+
+    /// Fetch one of the index database's leveldb property strings (see
+    /// CDBWrapper::GetProperty).
+    bool GetDBProperty(const std::string& name, std::string& out) const;
 };
 
 #endif // BITCOIN_INDEX_BASE_H
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <map>
+#include <optional>
 
 #include <dbwrapper.h>
 #include <index/blockfilterindex.h>
@@ -37,6 +38,18 @@ constexpr unsigned int FLTR_FILE_CHUNK_SIZE = 0x100000; // 1 MiB
  *  is big enough for a 2,000,000 length block chain, which
  *  we should be enough until ~2047. */
 constexpr size_t CF_HEADERS_CACHE_MAX_SZ{2000};
+/** Number of blocks to accumulate in the DB write batch before flushing it
+ *  outside of a regular commit. The rows are small (under 100 bytes), so the
+ *  batch stays modest even at this count. */
+constexpr size_t FILTER_WRITE_BATCH_BLOCKS{1000};
+/** Maximum total size of the encoded filters kept in the served-filter LRU
+ *  cache. At typical mainnet filter sizes this holds on the order of the
+ *  last ~1000 filters, the range light clients request most. */
+constexpr size_t CF_FILTER_CACHE_MAX_BYTES{16 << 20}; // 16 MiB
+/** Maximum number of index rows kept in the entry cache (roughly 80 bytes each). */
+constexpr size_t CF_ENTRY_CACHE_MAX_SZ{20000};
+/** Serialized size of one header chain cache entry (filter hash + header). */
+constexpr size_t HEADER_CHAIN_ENTRY_SIZE{64};
 
 namespace {
 
@@ -89,8 +102,73 @@ struct DBHashKey {
 
 }; // namespace
 
+static bool LookupOne(const CDBWrapper& db, const CBlockIndex* block_index, DBVal& result);
+
 static std::map<BlockFilterType, BlockFilterIndex> g_filter_indexes;
 
+namespace {
+
+/**
+ * Shared per-block undo data for the enabled filter indexes. Every filter
+ * type builds its filter from the same block and prevout data, so when more
+ * than one type is enabled the first index to process a block reads and
+ * parses the undo data and the others reuse it, instead of each type
+ * re-reading it from disk. An entry is dropped once every active index has
+ * consumed it; if the indexes sync at very different heights the cache is
+ * cleared at a size bound and the slower index simply re-reads from disk.
+ */
+class SharedUndoCache
+{
+public:
+    //! Get the undo data for a block, from the cache or from disk. Returns
+    //! null if the undo data could not be read.
+    std::shared_ptr<const CBlockUndo> Get(const CBlockIndex* pindex)
+    {
+        const uint256 block_hash = pindex->GetBlockHash();
+        const size_t consumers = g_filter_indexes.size();
+        {
+            LOCK(m_mutex);
+            auto it = m_cache.find(block_hash);
+            if (it != m_cache.end()) {
+                std::shared_ptr<const CBlockUndo> undo = it->second.undo;
+                if (--it->second.remaining == 0) m_cache.erase(it);
+                return undo;
+            }
+        }
+
+        auto undo = std::make_shared<CBlockUndo>();
+        if (!UndoReadFromDisk(*undo, pindex)) {
+            return nullptr;
+        }
+        if (consumers > 1) {
+            LOCK(m_mutex);
+            if (m_cache.size() >= MAX_ENTRIES) m_cache.clear();
+            // If two indexes raced on the same miss the insert fails and
+            // both just use their own copy; the remaining counts stay
+            // approximate, which the size bound above covers.
+            m_cache.emplace(block_hash, Entry{undo, consumers - 1});
+        }
+        return undo;
+    }
+
+private:
+    //! Twice the sync lookahead per index, so briefly diverging pipelines
+    //! do not thrash the cache.
+    static constexpr size_t MAX_ENTRIES{128};
+
+    struct Entry {
+        std::shared_ptr<const CBlockUndo> undo;
+        size_t remaining;
+    };
+
+    Mutex m_mutex;
+    std::map<uint256, Entry> m_cache GUARDED_BY(m_mutex);
+};
+
+SharedUndoCache g_shared_undo;
+
+} // namespace
+
 BlockFilterIndex::BlockFilterIndex(BlockFilterType filter_type,
                                    size_t n_cache_size, bool f_memory, bool f_wipe)
     : m_filter_type(filter_type)
@@ -103,9 +181,50 @@ BlockFilterIndex::BlockFilterIndex(BlockFilterType filter_type,
 
     m_name = filter_name + " block filter index";
     m_db = std::make_unique<BaseIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+    m_headers_file_path = path / "headers.dat";
     m_filter_fileseq = std::make_unique<FlatFileSeq>(std::move(path), "fltr", FLTR_FILE_CHUNK_SIZE);
 }
 
+BlockFilterIndex::~BlockFilterIndex()
+{
+    // Unflushed rows are simply dropped; they are ahead of the committed best
+    // block and get recomputed when the index next syncs.
+    CloseFilterFile();
+}
+
+FILE* BlockFilterIndex::OpenFilterFile(const FlatFilePos& pos)
+{
+    if (m_filter_file && m_filter_fileno == pos.nFile) {
+        if (fseek(m_filter_file, pos.nPos, SEEK_SET) != 0) {
+            CloseFilterFile();
+            return nullptr;
+        }
+        return m_filter_file;
+    }
+    CloseFilterFile();
+    m_filter_file = m_filter_fileseq->Open(pos);
+    if (m_filter_file) m_filter_fileno = pos.nFile;
+    return m_filter_file;
+}
+
+void BlockFilterIndex::CloseFilterFile()
+{
+    if (m_filter_file) {
+        fclose(m_filter_file);
+        m_filter_file = nullptr;
+        m_filter_fileno = -1;
+    }
+}
+
+bool BlockFilterIndex::FlushDBBatch()
+{
+    if (!m_batch) return true;
+    bool ret = m_db->WriteBatch(*m_batch);
+    m_batch.reset();
+    m_batch_blocks = 0;
+    return ret;
+}
+
 bool BlockFilterIndex::Init()
 {
     if (!m_db->Read(DB_FILTER_POS, m_next_filter_pos)) {
@@ -121,7 +240,97 @@ bool BlockFilterIndex::Init()
         m_next_filter_pos.nFile = 0;
         m_next_filter_pos.nPos = 0;
     }
-    return BaseIndex::Init();
+
+    if (!BaseIndex::Init()) return false;
+
+    // Load the header chain tip, from which WriteBlock chains the next
+    // filter header.
+    const CBlockIndex* pindex = CurrentIndex();
+    if (pindex) {
+        DBVal entry;
+        if (!LookupOne(*m_db, pindex, entry)) {
+            return error("%s: Cannot read last block filter of %s; index may be corrupted",
+                         __func__, GetName());
+        }
+        m_last_header = entry.header;
+    }
+
+    if (!LoadHeaderChain()) return false;
+    return true;
+}
+
+bool BlockFilterIndex::LoadHeaderChain()
+{
+    LOCK(m_cs_header_chain);
+    m_header_chain.clear();
+
+    const CBlockIndex* pindex = CurrentIndex();
+    const size_t expected = pindex ? static_cast<size_t>(pindex->nHeight) + 1 : 0;
+
+    // The headers file may be behind the committed best block (it is only
+    // required to be consistent up to whatever prefix it holds), or hold
+    // stale entries past it from before a crash or reorg. Load at most
+    // `expected` entries and rebuild the rest from the height index.
+    FILE* file = fsbridge::fopen(m_headers_file_path, "rb");
+    if (file) {
+        CAutoFile filein(file, SER_DISK, CLIENT_VERSION);
+        try {
+            while (m_header_chain.size() < expected) {
+                HeaderChainEntry entry;
+                filein >> entry.filter_hash >> entry.header;
+                m_header_chain.push_back(entry);
+            }
+        } catch (const std::exception&) {
+            // Short or torn file; the remainder is rebuilt from the DB below.
+        }
+    }
+    m_headers_file_entries = m_header_chain.size();
+
+    if (m_header_chain.size() < expected) {
+        m_header_chain.reserve(expected);
+        std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+        DBHeightKey key(m_header_chain.size());
+        db_it->Seek(key);
+        for (size_t height = m_header_chain.size(); height < expected; ++height) {
+            std::pair<uint256, DBVal> value;
+            if (!db_it->Valid() || !db_it->GetKey(key) ||
+                key.height != static_cast<int>(height) || !db_it->GetValue(value)) {
+                return error("%s: unable to rebuild %s header chain at height %d",
+                             __func__, GetName(), height);
+            }
+            m_header_chain.push_back({value.second.hash, value.second.header});
+            db_it->Next();
+        }
+    }
+    return true;
+}
+
+bool BlockFilterIndex::FlushHeaderChain()
+{
+    LOCK(m_cs_header_chain);
+    if (m_headers_file_entries == m_header_chain.size()) return true;
+
+    FILE* file = fsbridge::fopen(m_headers_file_path, "rb+");
+    if (!file) {
+        file = fsbridge::fopen(m_headers_file_path, "wb");
+        m_headers_file_entries = 0;
+    }
+    if (!file) {
+        return error("%s: Failed to open %s headers file", __func__, GetName());
+    }
+
+    CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
+    if (fseek(fileout.Get(), m_headers_file_entries * HEADER_CHAIN_ENTRY_SIZE, SEEK_SET) != 0) {
+        return error("%s: Failed to seek in %s headers file", __func__, GetName());
+    }
+    for (size_t i = m_headers_file_entries; i < m_header_chain.size(); ++i) {
+        fileout << m_header_chain[i].filter_hash << m_header_chain[i].header;
+    }
+    if (!FileCommit(fileout.Get())) {
+        return error("%s: Failed to commit %s headers file", __func__, GetName());
+    }
+    m_headers_file_entries = m_header_chain.size();
+    return true;
 }
 
 bool BlockFilterIndex::CommitInternal(CDBBatch& batch)
@@ -129,14 +338,24 @@ bool BlockFilterIndex::CommitInternal(CDBBatch& batch)
     const FlatFilePos& pos = m_next_filter_pos;
 
     // Flush current filter file to disk.
-    CAutoFile file(m_filter_fileseq->Open(pos), SER_DISK, CLIENT_VERSION);
-    if (file.IsNull()) {
+    FILE* file = OpenFilterFile(pos);
+    if (!file) {
         return error("%s: Failed to open filter file %d", __func__, pos.nFile);
     }
-    if (!FileCommit(file.Get())) {
+    if (!FileCommit(file)) {
         return error("%s: Failed to commit filter file %d", __func__, pos.nFile);
     }
 
+    // Write any buffered DB rows before the locator, so that the committed
+    // best block never points past rows that only exist in memory.
+    if (!FlushDBBatch()) {
+        return error("%s: Failed to write batched %s rows", __func__, GetName());
+    }
+
+    // Likewise persist the header chain up to the locator; Init tolerates a
+    // headers file that is behind or ahead of the committed best block.
+    if (!FlushHeaderChain()) return false;
+
     batch.Write(DB_FILTER_POS, pos);
     return BaseIndex::CommitInternal(batch);
 }
@@ -171,6 +390,7 @@ size_t BlockFilterIndex::WriteFilterToDisk(FlatFilePos& pos, const BlockFilter&
 
     // If writing the filter would overflow the file, flush and move to the next one.
     if (pos.nPos + data_size > MAX_FLTR_FILE_SIZE) {
+        CloseFilterFile();
         CAutoFile last_file(m_filter_fileseq->Open(pos), SER_DISK, CLIENT_VERSION);
         if (last_file.IsNull()) {
             LogPrintf("%s: Failed to open filter file %d\n", __func__, pos.nFile);
@@ -197,53 +417,103 @@ size_t BlockFilterIndex::WriteFilterToDisk(FlatFilePos& pos, const BlockFilter&
         return 0;
     }
 
-    CAutoFile fileout(m_filter_fileseq->Open(pos), SER_DISK, CLIENT_VERSION);
-    if (fileout.IsNull()) {
+    FILE* file = OpenFilterFile(pos);
+    if (!file) {
         LogPrintf("%s: Failed to open filter file %d\n", __func__, pos.nFile);
         return 0;
     }
 
+    CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
     fileout << filter.GetBlockHash() << filter.GetEncodedFilter();
+    fileout.release(); // the cached handle stays open for the next append
+    // ReadFilterFromDisk opens its own handle and cannot see bytes still
+    // sitting in this handle's stdio buffer. Once synced the row is flushed
+    // per block and the filter served to peers right away, so push the append
+    // through to the kernel; during initial sync the buffer is left to fill.
+    if (IsSynced() && fflush(file) != 0) {
+        LogPrintf("%s: Failed to flush filter file %d\n", __func__, pos.nFile);
+        return 0;
+    }
     return data_size;
 }
 
-bool BlockFilterIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+void BlockFilterIndex::PrecomputeBlock(const CBlock& block, const CBlockIndex* pindex)
 {
-    CBlockUndo block_undo;
-    uint256 prev_header;
-
+    std::shared_ptr<const CBlockUndo> block_undo;
     if (pindex->nHeight > 0) {
-        if (!UndoReadFromDisk(block_undo, pindex)) {
-            return false;
+        block_undo = g_shared_undo.Get(pindex);
+        if (!block_undo) {
+            // WriteBlock will re-read the undo data and report the error.
+            return;
         }
+    }
 
-        std::pair<uint256, DBVal> read_out;
-        if (!m_db->Read(DBHeightKey(pindex->nHeight - 1), read_out)) {
-            return false;
-        }
+    BlockFilter filter(m_filter_type, block, block_undo ? *block_undo : CBlockUndo{});
 
-        uint256 expected_block_hash = pindex->pprev->GetBlockHash();
-        if (read_out.first != expected_block_hash) {
-            return error("%s: previous block header belongs to unexpected block %s; expected %s",
-                         __func__, read_out.first.ToString(), expected_block_hash.ToString());
-        }
+    LOCK(m_cs_precomputed);
+    // Entries for blocks reorganized out mid-sync are never consumed by
+    // WriteBlock; clearing the cache when it grows well beyond the sync
+    // lookahead window bounds the memory they can occupy. Cleared entries
+    // just get recomputed in WriteBlock.
+    if (m_precomputed.size() >= 256) m_precomputed.clear();
+    m_precomputed.emplace(pindex->GetBlockHash(), std::move(filter));
+}
 
-        prev_header = read_out.second.header;
-    }
+bool BlockFilterIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    // The previous block's row may still be buffered in m_batch, so the
+    // previous filter header is tracked in memory instead of being read back
+    // from the DB. It is (re)loaded from the DB in Init and Rewind.
+    const uint256 prev_header = pindex->nHeight > 0 ? m_last_header : uint256();
 
-    BlockFilter filter(m_filter_type, block, block_undo);
+    std::optional<BlockFilter> filter;
+    {
+        LOCK(m_cs_precomputed);
+        auto it = m_precomputed.find(pindex->GetBlockHash());
+        if (it != m_precomputed.end()) {
+            filter = std::move(it->second);
+            m_precomputed.erase(it);
+        }
+    }
+    if (!filter) {
+        std::shared_ptr<const CBlockUndo> block_undo;
+        if (pindex->nHeight > 0) {
+            block_undo = g_shared_undo.Get(pindex);
+            if (!block_undo) return false;
+        }
+        filter.emplace(m_filter_type, block, block_undo ? *block_undo : CBlockUndo{});
+    }
 
-    size_t bytes_written = WriteFilterToDisk(m_next_filter_pos, filter);
+    size_t bytes_written = WriteFilterToDisk(m_next_filter_pos, *filter);
     if (bytes_written == 0) return false;
 
     std::pair<uint256, DBVal> value;
     value.first = pindex->GetBlockHash();
-    value.second.hash = filter.GetHash();
-    value.second.header = filter.ComputeHeader(prev_header);
+    value.second.hash = filter->GetHash();
+    value.second.header = filter->ComputeHeader(prev_header);
     value.second.pos = m_next_filter_pos;
 
-    if (!m_db->Write(DBHeightKey(pindex->nHeight), value)) {
-        return false;
+    if (!m_batch) m_batch = std::make_unique<CDBBatch>(*m_db);
+    m_batch->Write(DBHeightKey(pindex->nHeight), value);
+    ++m_batch_blocks;
+    m_last_header = value.second.header;
+
+    {
+        // Blocks arrive strictly in height order, so the entry for this
+        // height lands at the end of the chain; anything at or above it is
+        // left over from before a rewind and gets dropped.
+        LOCK(m_cs_header_chain);
+        assert(m_header_chain.size() >= static_cast<size_t>(pindex->nHeight));
+        m_header_chain.resize(pindex->nHeight);
+        m_header_chain.push_back({value.second.hash, value.second.header});
+        m_headers_file_entries = std::min(m_headers_file_entries, static_cast<size_t>(pindex->nHeight));
+    }
+
+    // During initial sync, rows are flushed in batches (and on every commit).
+    // Once synced, flush per block so the filter is immediately available to
+    // peers when the validation interface announces the block.
+    if (m_batch_blocks >= FILTER_WRITE_BATCH_BLOCKS || IsSynced()) {
+        if (!FlushDBBatch()) return false;
     }
 
     m_next_filter_pos.nPos += bytes_written;
@@ -280,6 +550,10 @@ bool BlockFilterIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex*
 {
     assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
 
+    // Write out buffered rows first, so the height index is complete for the
+    // copy below.
+    if (!FlushDBBatch()) return false;
+
     CDBBatch batch(*m_db);
     std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
 
@@ -296,7 +570,15 @@ bool BlockFilterIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex*
     batch.Write(DB_FILTER_POS, m_next_filter_pos);
     if (!m_db->WriteBatch(batch)) return false;
 
-    return BaseIndex::Rewind(current_tip, new_tip);
+    if (!BaseIndex::Rewind(current_tip, new_tip)) return false;
+
+    // Continue the header chain from the new tip.
+    DBVal entry;
+    if (!LookupOne(*m_db, new_tip, entry)) {
+        return error("%s: Cannot read last block filter of %s after rewind", __func__, GetName());
+    }
+    m_last_header = entry.header;
+    return true;
 }
 
 static bool LookupOne(const CDBWrapper& db, const CBlockIndex* block_index, DBVal& result)
@@ -372,6 +654,80 @@ static bool LookupRange(CDBWrapper& db, const std::string& index_name, int start
     return true;
 }
 
+bool BlockFilterIndex::ReadFilterCached(const uint256& block_hash, const FlatFilePos& pos, BlockFilter& filter_out) const
+{
+    {
+        LOCK(m_cs_filter_cache);
+        auto it = m_filter_cache.find(block_hash);
+        if (it != m_filter_cache.end()) {
+            // Move the entry to the front of the LRU list.
+            m_filter_lru.splice(m_filter_lru.begin(), m_filter_lru, it->second);
+            filter_out = BlockFilter(m_filter_type, block_hash, it->second->second);
+            return true;
+        }
+    }
+
+    if (!ReadFilterFromDisk(pos, filter_out)) return false;
+
+    LOCK(m_cs_filter_cache);
+    if (m_filter_cache.count(block_hash) > 0) return true; // raced with another message handler thread
+    m_filter_lru.emplace_front(block_hash, filter_out.GetEncodedFilter());
+    m_filter_cache.emplace(block_hash, m_filter_lru.begin());
+    m_filter_cache_bytes += filter_out.GetEncodedFilter().size();
+    while (m_filter_cache_bytes > CF_FILTER_CACHE_MAX_BYTES && !m_filter_lru.empty()) {
+        m_filter_cache_bytes -= m_filter_lru.back().second.size();
+        m_filter_cache.erase(m_filter_lru.back().first);
+        m_filter_lru.pop_back();
+    }
+    return true;
+}
+
+bool BlockFilterIndex::LookupRangeCached(int start_height, const CBlockIndex* stop_index,
+                                         std::vector<CachedEntry>& results) const
+{
+    if (start_height < 0 || start_height > stop_index->nHeight) {
+        // LookupRange reports the error.
+        std::vector<DBVal> entries;
+        return LookupRange(*m_db, m_name, start_height, stop_index, entries);
+    }
+
+    size_t results_size = static_cast<size_t>(stop_index->nHeight - start_height + 1);
+    std::vector<uint256> block_hashes(results_size);
+    for (const CBlockIndex* block_index = stop_index;
+         block_index && block_index->nHeight >= start_height;
+         block_index = block_index->pprev) {
+        block_hashes[block_index->nHeight - start_height] = block_index->GetBlockHash();
+    }
+
+    results.resize(results_size);
+    bool complete = true;
+    {
+        LOCK(m_cs_entry_cache);
+        for (size_t i = 0; i < results_size; ++i) {
+            auto it = m_entry_cache.find(block_hashes[i]);
+            if (it == m_entry_cache.end()) {
+                complete = false;
+                break;
+            }
+            results[i] = it->second;
+        }
+    }
+    if (complete) return true;
+
+    std::vector<DBVal> entries;
+    if (!LookupRange(*m_db, m_name, start_height, stop_index, entries)) {
+        return false;
+    }
+
+    LOCK(m_cs_entry_cache);
+    if (m_entry_cache.size() + results_size > CF_ENTRY_CACHE_MAX_SZ) m_entry_cache.clear();
+    for (size_t i = 0; i < results_size; ++i) {
+        results[i] = CachedEntry{entries[i].hash, entries[i].header, entries[i].pos};
+        m_entry_cache.emplace(block_hashes[i], results[i]);
+    }
+    return true;
+}
+
 bool BlockFilterIndex::LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const
 {
     DBVal entry;
@@ -379,11 +735,22 @@ bool BlockFilterIndex::LookupFilter(const CBlockIndex* block_index, BlockFilter&
         return false;
     }
 
-    return ReadFilterFromDisk(entry.pos, filter_out);
+    return ReadFilterCached(block_index->GetBlockHash(), entry.pos, filter_out);
 }
 
 bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex* block_index, uint256& header_out)
 {
+    // Serve active-chain blocks straight from the header chain cache.
+    const CBlockIndex* best = CurrentIndex();
+    if (best && block_index->nHeight <= best->nHeight &&
+        best->GetAncestor(block_index->nHeight) == block_index) {
+        LOCK(m_cs_header_chain);
+        if (static_cast<size_t>(block_index->nHeight) < m_header_chain.size()) {
+            header_out = m_header_chain[block_index->nHeight].header;
+            return true;
+        }
+    }
+
     LOCK(m_cs_headers_cache);
 
     bool is_checkpoint{block_index->nHeight % CFCHECKPT_INTERVAL == 0};
@@ -415,15 +782,16 @@ bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex* block_index, uint25
 bool BlockFilterIndex::LookupFilterRange(int start_height, const CBlockIndex* stop_index,
                                          std::vector<BlockFilter>& filters_out) const
 {
-    std::vector<DBVal> entries;
-    if (!LookupRange(*m_db, m_name, start_height, stop_index, entries)) {
+    std::vector<CachedEntry> entries;
+    if (!LookupRangeCached(start_height, stop_index, entries)) {
         return false;
     }
 
     filters_out.resize(entries.size());
     auto filter_pos_it = filters_out.begin();
-    for (const auto& entry : entries) {
-        if (!ReadFilterFromDisk(entry.pos, *filter_pos_it)) {
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const CBlockIndex* block_index = stop_index->GetAncestor(start_height + static_cast<int>(i));
+        if (!ReadFilterCached(block_index->GetBlockHash(), entries[i].pos, *filter_pos_it)) {
             return false;
         }
         ++filter_pos_it;
@@ -436,15 +804,32 @@ bool BlockFilterIndex::LookupFilterHashRange(int start_height, const CBlockIndex
                                              std::vector<uint256>& hashes_out) const
 
 {
-    std::vector<DBVal> entries;
-    if (!LookupRange(*m_db, m_name, start_height, stop_index, entries)) {
+    // Ranges ending on the active chain are copied straight out of the header
+    // chain cache.
+    const CBlockIndex* best = CurrentIndex();
+    if (best && start_height >= 0 && start_height <= stop_index->nHeight &&
+        stop_index->nHeight <= best->nHeight &&
+        best->GetAncestor(stop_index->nHeight) == stop_index) {
+        LOCK(m_cs_header_chain);
+        if (static_cast<size_t>(stop_index->nHeight) < m_header_chain.size()) {
+            hashes_out.clear();
+            hashes_out.reserve(stop_index->nHeight - start_height + 1);
+            for (int height = start_height; height <= stop_index->nHeight; ++height) {
+                hashes_out.push_back(m_header_chain[height].filter_hash);
+            }
+            return true;
+        }
+    }
+
+    std::vector<CachedEntry> entries;
+    if (!LookupRangeCached(start_height, stop_index, entries)) {
         return false;
     }
 
     hashes_out.clear();
     hashes_out.reserve(entries.size());
     for (const auto& entry : entries) {
-        hashes_out.push_back(entry.hash);
+        hashes_out.push_back(entry.filter_hash);
     }
     return true;
 }
@@ -11,6 +11,8 @@
 #include <index/base.h>
 #include <util/hasher.h>
 
+#include <list>
+
 /** Interval between compact filter checkpoints. See BIP 157. */
 static constexpr int CFCHECKPT_INTERVAL = 1000;
 
@@ -24,6 +26,13 @@ static constexpr int CFCHECKPT_INTERVAL = 1000;
 class BlockFilterIndex final : public BaseIndex
 {
 private:
+    /** An index row, as cached in m_entry_cache. */
+    struct CachedEntry {
+        uint256 filter_hash;
+        uint256 header;
+        FlatFilePos pos;
+    };
+
     BlockFilterType m_filter_type;
     std::string m_name;
     std::unique_ptr<BaseIndex::DB> m_db;
@@ -31,13 +40,82 @@ private:
     FlatFilePos m_next_filter_pos;
     std::unique_ptr<FlatFileSeq> m_filter_fileseq;
 
+    /** Cached handle to the filter file currently being appended to, so that
+     *  sequential writes do not pay an open/close per block. Only accessed
+     *  from the thread driving WriteBlock/CommitInternal. */
+    FILE* m_filter_file{nullptr};
+    int m_filter_fileno{-1};
+
+    /** Filter header of the last block passed to WriteBlock, from which the
+     *  next filter header is chained. Tracked in memory because the previous
+     *  block's DB row may still be sitting in m_batch. */
+    uint256 m_last_header{};
+
+    /** DB rows accumulated since the last flush, written as one batch. */
+    std::unique_ptr<CDBBatch> m_batch;
+    size_t m_batch_blocks{0};
+
+    /** One entry per active-chain height in the header chain cache. */
+    struct HeaderChainEntry {
+        uint256 filter_hash;
+        uint256 header;
+    };
+
+    /** Filter hash and header for every active-chain height up to the indexed
+     *  tip, so cfheaders/cfcheckpt ranges are served straight from memory.
+     *  Persisted to a flat headers file in the index directory and reloaded at
+     *  startup, so a freshly restarted node serves header ranges without a
+     *  burst of cold DB reads. */
+    mutable Mutex m_cs_header_chain;
+    std::vector<HeaderChainEntry> m_header_chain GUARDED_BY(m_cs_header_chain);
+    /** Number of m_header_chain entries already persisted to the headers file. */
+    size_t m_headers_file_entries GUARDED_BY(m_cs_header_chain){0};
+    fs::path m_headers_file_path;
+
+    /** Load the header chain from the headers file, rebuilding any entries it
+     *  does not cover from the DB height index. */
+    bool LoadHeaderChain();
+    /** Append entries added since the last flush to the headers file. */
+    bool FlushHeaderChain();
+
     bool ReadFilterFromDisk(const FlatFilePos& pos, BlockFilter& filter) const;
     size_t WriteFilterToDisk(FlatFilePos& pos, const BlockFilter& filter);
 
+    FILE* OpenFilterFile(const FlatFilePos& pos);
+    void CloseFilterFile();
+    bool FlushDBBatch();
+
+    /** Read a filter through the LRU cache, falling back to (and populating it from) disk. */
+    bool ReadFilterCached(const uint256& block_hash, const FlatFilePos& pos, BlockFilter& filter_out) const;
+
+    /** Look up the index rows for a range of blocks through the entry cache. */
+    bool LookupRangeCached(int start_height, const CBlockIndex* stop_index,
+                           std::vector<CachedEntry>& results) const;
+
     Mutex m_cs_headers_cache;
     /** cache of block hash to filter header, to avoid disk access when responding to getcfcheckpt. */
     std::unordered_map<uint256, uint256, FilterHeaderHasher> m_headers_cache GUARDED_BY(m_cs_headers_cache);
 
+    /** LRU cache of encoded filters recently served to peers, keyed by block hash. A filter is a
+     *  pure function of its block, so entries can never go stale -- not even on reorgs. Bounded by
+     *  the total size of the encoded filters it holds. */
+    mutable Mutex m_cs_filter_cache;
+    mutable std::list<std::pair<uint256, std::vector<unsigned char>>> m_filter_lru GUARDED_BY(m_cs_filter_cache);
+    mutable std::unordered_map<uint256, std::list<std::pair<uint256, std::vector<unsigned char>>>::iterator, FilterHeaderHasher> m_filter_cache GUARDED_BY(m_cs_filter_cache);
+    mutable size_t m_filter_cache_bytes GUARDED_BY(m_cs_filter_cache){0};
+
+    /** Cache of index rows for recently served blocks, keyed by block hash, so that hot
+     *  cfheaders/cfilters range requests skip the DB entirely. Emptied when it reaches capacity;
+     *  it re-warms from the very requests it serves. */
+    mutable Mutex m_cs_entry_cache;
+    mutable std::unordered_map<uint256, CachedEntry, FilterHeaderHasher> m_entry_cache GUARDED_BY(m_cs_entry_cache);
+
+    Mutex m_cs_precomputed;
+    /** Filters computed ahead of time by the sync worker threads, keyed by block hash and consumed
+     *  by WriteBlock. Bounded by the sync lookahead window (plus blocks reorganized out mid-sync,
+     *  which WriteBlock never consumes; PrecomputeBlock caps the size to cover that case). */
+    std::map<uint256, BlockFilter> m_precomputed GUARDED_BY(m_cs_precomputed);
+
 protected:
     bool Init() override;
 
@@ -45,6 +123,8 @@ protected:
 
     bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
 
+    void PrecomputeBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
     bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip) override;
 
     BaseIndex::DB& GetDB() const override { return *m_db; }
@@ -56,6 +136,8 @@ public:
     explicit BlockFilterIndex(BlockFilterType filter_type,
                               size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
 
+    virtual ~BlockFilterIndex() override;
+
     BlockFilterType GetFilterType() const { return m_filter_type; }
 
     /** Get a single filter by block. */
@@ -0,0 +1,122 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <index/spentindex.h>
+#include <serialize.h>
+#include <util/system.h>
+#include <validation.h>
+
+/* The index database stores one record per spent output, keyed by
+ * [DB_SPENT, COutPoint]. The value is the spending txid, the index of the
+ * spending input and the height it confirmed at. Both the keys and their
+ * erasure on a reorg are derived from the block's inputs alone, so no undo
+ * data is needed.
+ */
+constexpr char DB_SPENT = 'p';
+
+namespace {
+
+struct DBKey {
+    COutPoint outpoint;
+
+    SERIALIZE_METHODS(DBKey, obj)
+    {
+        char prefix{DB_SPENT};
+        READWRITE(prefix);
+        if (prefix != DB_SPENT) {
+            throw std::ios_base::failure("Invalid format for spentindex DB key");
+        }
+
+        READWRITE(obj.outpoint);
+    }
+};
+
+struct DBVal {
+    uint256 txid;
+    uint32_t input_n;
+    int32_t height;
+
+    SERIALIZE_METHODS(DBVal, obj)
+    {
+        READWRITE(obj.txid);
+        READWRITE(VARINT(obj.input_n));
+        READWRITE(obj.height);
+    }
+};
+
+} // namespace
+
+std::unique_ptr<SpentIndex> g_spent_index;
+
+SpentIndex::SpentIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+{
+    fs::path path{GetDataDir() / "indexes" / "spentindex"};
+    fs::create_directories(path);
+
+    m_db = std::make_unique<BaseIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+}
+
+bool SpentIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    CDBBatch& batch = SyncBatch();
+    for (const auto& tx : block.vtx) {
+        if (tx->IsCoinBase()) continue;
+
+        for (size_t i = 0; i < tx->vin.size(); ++i) {
+            batch.Write(DBKey{tx->vin[i].prevout},
+                        DBVal{tx->GetHash(), static_cast<uint32_t>(i), pindex->nHeight});
+        }
+    }
+    return true;
+}
+
+bool SpentIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip)
+{
+    assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
+
+    // Erase the records of the disconnected blocks; the spent outpoints are
+    // simply the blocks' inputs.
+    {
+        LOCK(cs_main);
+        const CBlockIndex* iter_tip{g_chainman.m_blockman.LookupBlockIndex(current_tip->GetBlockHash())};
+        const auto& consensus_params{Params().GetConsensus()};
+
+        do {
+            CBlock block;
+
+            if (!ReadBlockFromDisk(block, iter_tip, consensus_params)) {
+                return error("%s: Failed to read block %s from disk",
+                             __func__, iter_tip->GetBlockHash().ToString());
+            }
+
+            // Staging the erasures makes them land in the same flush as (and
+            // after) any not-yet-flushed writes for these blocks.
+            CDBBatch& batch = SyncBatch();
+            for (const auto& tx : block.vtx) {
+                if (tx->IsCoinBase()) continue;
+
+                for (const auto& txin : tx->vin) {
+                    batch.Erase(DBKey{txin.prevout});
+                }
+            }
+
+            iter_tip = iter_tip->GetAncestor(iter_tip->nHeight - 1);
+        } while (new_tip != iter_tip);
+    }
+
+    return BaseIndex::Rewind(current_tip, new_tip);
+}
+
+bool SpentIndex::FindSpend(const COutPoint& outpoint, SpentLocation& location) const
+{
+    DBVal val;
+    if (!m_db->Read(DBKey{outpoint}, val)) {
+        return false;
+    }
+    location.txid = val.txid;
+    location.input_n = val.input_n;
+    location.height = val.height;
+    return true;
+}
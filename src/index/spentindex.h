@@ -0,0 +1,52 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SPENTINDEX_H
+#define BITCOIN_INDEX_SPENTINDEX_H
+
+#include <index/base.h>
+#include <primitives/transaction.h>
+
+static constexpr bool DEFAULT_SPENTINDEX{false};
+
+/** Where an output was spent. */
+struct SpentLocation {
+    uint256 txid;     //!< txid of the spending transaction
+    uint32_t input_n; //!< index of the input that spends the output
+    int height;       //!< height of the block containing the spending transaction
+};
+
+/**
+ * SpentIndex maintains a spent outpoint -> (spending txid, input index,
+ * height) mapping for the whole chain. It makes "which transaction spent
+ * this output" a single database read, e.g. to resolve the prevouts of an
+ * arbitrary historical transaction without one lookup per input.
+ */
+class SpentIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+protected:
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip) override;
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+    const char* GetName() const override { return "spentindex"; }
+
+public:
+    // Constructs the index, which becomes available to be queried.
+    explicit SpentIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Look up where the given output was spent. Returns false if it is
+    /// unspent or not indexed.
+    bool FindSpend(const COutPoint& outpoint, SpentLocation& location) const;
+};
+
+/// The global spent-output index. May be null.
+extern std::unique_ptr<SpentIndex> g_spent_index;
+
+#endif // BITCOIN_INDEX_SPENTINDEX_H
@@ -0,0 +1,196 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <consensus/consensus.h>
+#include <consensus/validation.h>
+#include <index/statsindex.h>
+#include <rpc/blockchain.h>
+#include <undo.h>
+#include <util/system.h>
+#include <validation.h>
+
+/* The index database stores one statistics record per block, keyed by height.
+ * A record is only valid for the active chain: the block hash is stored
+ * alongside it and checked on lookup, so entries left behind by a reorg are
+ * never served and simply get overwritten as the replacement branch is
+ * indexed. (Unlike the filter indexes there is no hash-keyed copy for
+ * disconnected blocks, because getblockstats only serves active-chain
+ * blocks.)
+ *
+ * Keys have the type [DB_BLOCK_HEIGHT, uint32 (BE)].
+ */
+constexpr char DB_BLOCK_HEIGHT = 't';
+
+namespace {
+
+struct DBVal {
+    BlockStats stats;
+
+    SERIALIZE_METHODS(DBVal, obj)
+    {
+        READWRITE(obj.stats.txs, obj.stats.ins, obj.stats.outs);
+        READWRITE(obj.stats.totalfee, obj.stats.minfee, obj.stats.maxfee, obj.stats.medianfee);
+        READWRITE(obj.stats.minfeerate, obj.stats.maxfeerate);
+        for (auto& percentile : obj.stats.feerate_percentiles) READWRITE(percentile);
+        READWRITE(obj.stats.total_out, obj.stats.total_size, obj.stats.total_weight);
+        READWRITE(obj.stats.mintxsize, obj.stats.maxtxsize, obj.stats.mediantxsize);
+        READWRITE(obj.stats.swtxs, obj.stats.swtotal_size, obj.stats.swtotal_weight);
+        READWRITE(obj.stats.utxo_size_inc);
+    }
+};
+
+struct DBHeightKey {
+    int height;
+
+    explicit DBHeightKey(int height_in) : height(height_in) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_BLOCK_HEIGHT);
+        ser_writedata32be(s, height);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        char prefix{static_cast<char>(ser_readdata8(s))};
+        if (prefix != DB_BLOCK_HEIGHT) {
+            throw std::ios_base::failure("Invalid format for statsindex DB height key");
+        }
+        height = ser_readdata32be(s);
+    }
+};
+
+}; // namespace
+
+static_assert(std::tuple_size<decltype(BlockStats::feerate_percentiles)>::value == NUM_GETBLOCKSTATS_PERCENTILES,
+              "BlockStats stores one feerate per getblockstats percentile");
+
+std::unique_ptr<StatsIndex> g_stats_index;
+
+StatsIndex::StatsIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+{
+    fs::path path{GetDataDir() / "indexes" / "stats"};
+    fs::create_directories(path);
+
+    m_db = std::make_unique<BaseIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+}
+
+//! Compute the full statistics record for a block, mirroring what
+//! getblockstats computes when it has to fall back to the block data.
+static void ComputeBlockStats(const CBlock& block, const CBlockUndo& block_undo, BlockStats& stats)
+{
+    CAmount maxfee{0};
+    CAmount maxfeerate{0};
+    CAmount minfee{MAX_MONEY};
+    CAmount minfeerate{MAX_MONEY};
+    int64_t maxtxsize{0};
+    int64_t mintxsize{MAX_BLOCK_SERIALIZED_SIZE};
+    std::vector<CAmount> fee_array;
+    std::vector<std::pair<CAmount, int64_t>> feerate_array;
+    std::vector<int64_t> txsize_array;
+
+    for (size_t i = 0; i < block.vtx.size(); ++i) {
+        const auto& tx{block.vtx.at(i)};
+        stats.outs += tx->vout.size();
+
+        CAmount tx_total_out{0};
+        for (const CTxOut& out : tx->vout) {
+            tx_total_out += out.nValue;
+            stats.utxo_size_inc += GetSerializeSize(out, PROTOCOL_VERSION) + PER_UTXO_OVERHEAD;
+        }
+
+        if (tx->IsCoinBase()) {
+            continue;
+        }
+
+        stats.ins += tx->vin.size(); // Don't count coinbase's fake input
+        stats.total_out += tx_total_out; // Don't count coinbase reward
+
+        const int64_t tx_size{tx->GetTotalSize()};
+        txsize_array.push_back(tx_size);
+        maxtxsize = std::max(maxtxsize, tx_size);
+        mintxsize = std::min(mintxsize, tx_size);
+        stats.total_size += tx_size;
+
+        const int64_t weight{GetTransactionWeight(*tx)};
+        stats.total_weight += weight;
+
+        if (tx->HasWitness()) {
+            ++stats.swtxs;
+            stats.swtotal_size += tx_size;
+            stats.swtotal_weight += weight;
+        }
+
+        CAmount tx_total_in{0};
+        const auto& tx_undo{block_undo.vtxundo.at(i - 1)};
+        for (const Coin& coin : tx_undo.vprevout) {
+            tx_total_in += coin.out.nValue;
+            stats.utxo_size_inc -= GetSerializeSize(coin.out, PROTOCOL_VERSION) + PER_UTXO_OVERHEAD;
+        }
+
+        const CAmount txfee{tx_total_in - tx_total_out};
+        fee_array.push_back(txfee);
+        maxfee = std::max(maxfee, txfee);
+        minfee = std::min(minfee, txfee);
+        stats.totalfee += txfee;
+
+        // Feerate in satoshis per virtual byte
+        const CAmount feerate{weight ? (txfee * WITNESS_SCALE_FACTOR) / weight : 0};
+        feerate_array.emplace_back(feerate, weight);
+        maxfeerate = std::max(maxfeerate, feerate);
+        minfeerate = std::min(minfeerate, feerate);
+    }
+
+    CAmount feerate_percentiles[NUM_GETBLOCKSTATS_PERCENTILES] = {0};
+    CalculatePercentilesByWeight(feerate_percentiles, feerate_array, stats.total_weight);
+    for (int64_t i = 0; i < NUM_GETBLOCKSTATS_PERCENTILES; ++i) {
+        stats.feerate_percentiles[i] = feerate_percentiles[i];
+    }
+
+    stats.txs = block.vtx.size();
+    stats.medianfee = CalculateTruncatedMedian(fee_array);
+    stats.mediantxsize = CalculateTruncatedMedian(txsize_array);
+    stats.maxfee = maxfee;
+    stats.maxfeerate = maxfeerate;
+    stats.maxtxsize = maxtxsize;
+    // Empty blocks leave the minimums at their sentinels; store the same
+    // zeros getblockstats reports for them.
+    stats.minfee = (minfee == MAX_MONEY) ? 0 : minfee;
+    stats.minfeerate = (minfeerate == MAX_MONEY) ? 0 : minfeerate;
+    stats.mintxsize = (mintxsize == MAX_BLOCK_SERIALIZED_SIZE) ? 0 : mintxsize;
+}
+
+bool StatsIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    CBlockUndo block_undo;
+
+    // The genesis block has no undo data; its only transaction is the
+    // coinbase, which ComputeBlockStats does not read undo data for.
+    if (pindex->nHeight > 0 && !UndoReadFromDisk(block_undo, pindex)) {
+        return false;
+    }
+
+    std::pair<uint256, DBVal> value;
+    value.first = pindex->GetBlockHash();
+    ComputeBlockStats(block, block_undo, value.second.stats);
+
+    SyncBatch().Write(DBHeightKey(pindex->nHeight), value);
+    return true;
+}
+
+bool StatsIndex::LookupStats(const CBlockIndex* block_index, BlockStats& stats) const
+{
+    std::pair<uint256, DBVal> read_out;
+    if (!m_db->Read(DBHeightKey(block_index->nHeight), read_out)) {
+        return false;
+    }
+    // The height entry may belong to a different branch after a reorg.
+    if (read_out.first != block_index->GetBlockHash()) {
+        return false;
+    }
+    stats = read_out.second.stats;
+    return true;
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_STATSINDEX_H
+#define BITCOIN_INDEX_STATSINDEX_H
+
+#include <amount.h>
+#include <chain.h>
+#include <index/base.h>
+
+static constexpr bool DEFAULT_STATSINDEX{false};
+
+/** Per-block statistics as served by getblockstats. Values derivable from the
+ *  block index itself (height, time, subsidy, block hash) are not stored. */
+struct BlockStats {
+    int64_t txs{0};              //!< Number of transactions (including coinbase)
+    int64_t ins{0};              //!< Number of inputs (excluding coinbase)
+    int64_t outs{0};             //!< Number of outputs
+    CAmount totalfee{0};
+    CAmount minfee{0};
+    CAmount maxfee{0};
+    CAmount medianfee{0};
+    CAmount minfeerate{0};       //!< sat/vbyte
+    CAmount maxfeerate{0};       //!< sat/vbyte
+    //! Feerates at the 10th, 25th, 50th, 75th and 90th percentile weight unit,
+    //! in the order getblockstats reports them.
+    std::array<CAmount, 5> feerate_percentiles{{0, 0, 0, 0, 0}};
+    CAmount total_out{0};        //!< Total output value, excluding coinbase
+    int64_t total_size{0};       //!< Total size of all non-coinbase transactions
+    int64_t total_weight{0};     //!< Total weight of all non-coinbase transactions
+    int64_t mintxsize{0};
+    int64_t maxtxsize{0};
+    int64_t mediantxsize{0};
+    int64_t swtxs{0};            //!< Number of segwit transactions
+    int64_t swtotal_size{0};
+    int64_t swtotal_weight{0};
+    int64_t utxo_size_inc{0};    //!< Change in serialized UTXO set size (may be negative)
+};
+
+/**
+ * StatsIndex stores the getblockstats statistics record for every block as it
+ * is connected, so that repeat queries (dashboards polling the last day of
+ * blocks, say) are single-row lookups instead of re-reading the block and
+ * undo data and recomputing everything.
+ */
+class StatsIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+protected:
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+    const char* GetName() const override { return "statsindex"; }
+
+public:
+    // Constructs the index, which becomes available to be queried.
+    explicit StatsIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /** Look up the stored statistics for a block. Returns false if the block
+     *  has not been indexed (which includes blocks reorganized out of the
+     *  active chain). */
+    bool LookupStats(const CBlockIndex* block_index, BlockStats& stats) const;
+};
+
+/// The global block stats index. May be null.
+extern std::unique_ptr<StatsIndex> g_stats_index;
+
+#endif // BITCOIN_INDEX_STATSINDEX_H
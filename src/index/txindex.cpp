@@ -28,8 +28,8 @@ public:
     /// transaction hash is not indexed.
     bool ReadTxPos(const uint256& txid, CDiskTxPos& pos) const;
 
-    /// Write a batch of transaction positions to the DB.
-    bool WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos);
+    /// Stage a batch of transaction positions for writing to the DB.
+    void WriteTxs(CDBBatch& batch, const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos);
 
     /// Migrate txindex data from the block tree DB, where it may be for older nodes that have not
     /// been upgraded yet to the new database.
@@ -45,13 +45,11 @@ bool TxIndex::DB::ReadTxPos(const uint256 &txid, CDiskTxPos& pos) const
     return Read(std::make_pair(DB_TXINDEX, txid), pos);
 }
 
-bool TxIndex::DB::WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos)
+void TxIndex::DB::WriteTxs(CDBBatch& batch, const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos)
 {
-    CDBBatch batch(*this);
     for (const auto& tuple : v_pos) {
         batch.Write(std::make_pair(DB_TXINDEX, tuple.first), tuple.second);
     }
-    return WriteBatch(batch);
 }
 
 /*
@@ -223,18 +221,15 @@ bool TxIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
         vPos.emplace_back(tx->GetHash(), pos);
         pos.nTxOffset += ::GetSerializeSize(*tx, CLIENT_VERSION);
     }
-    return m_db->WriteTxs(vPos);
+    m_db->WriteTxs(SyncBatch(), vPos);
+    return true;
 }
 
 BaseIndex::DB& TxIndex::GetDB() const { return *m_db; }
 
-bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const
+//! Read a transaction from the given position in the block files.
+static bool ReadTxFromDisk(const CDiskTxPos& postx, const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx)
 {
-    CDiskTxPos postx;
-    if (!m_db->ReadTxPos(tx_hash, postx)) {
-        return false;
-    }
-
     CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
     if (file.IsNull()) {
         return error("%s: OpenBlockFile failed", __func__);
@@ -255,3 +250,35 @@ bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRe
     block_hash = header.GetHash();
     return true;
 }
+
+bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const
+{
+    CDiskTxPos postx;
+    if (!m_db->ReadTxPos(tx_hash, postx)) {
+        return false;
+    }
+    return ReadTxFromDisk(postx, tx_hash, block_hash, tx);
+}
+
+void TxIndex::FindTxs(const std::vector<uint256>& tx_hashes, std::vector<uint256>& block_hashes, std::vector<CTransactionRef>& txs) const
+{
+    assert(block_hashes.size() == tx_hashes.size());
+    assert(txs.size() == tx_hashes.size());
+
+    std::vector<std::pair<CDiskTxPos, size_t>> positions;
+    positions.reserve(tx_hashes.size());
+    for (size_t i = 0; i < tx_hashes.size(); ++i) {
+        CDiskTxPos postx;
+        if (m_db->ReadTxPos(tx_hashes[i], postx)) {
+            positions.emplace_back(postx, i);
+        }
+    }
+    // Visit the block files in offset order so the reads are sequential.
+    std::sort(positions.begin(), positions.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.first.nFile, a.first.nPos, a.first.nTxOffset) <
+               std::tie(b.first.nFile, b.first.nPos, b.first.nTxOffset);
+    });
+    for (const auto& [postx, i] : positions) {
+        ReadTxFromDisk(postx, tx_hashes[i], block_hashes[i], txs[i]);
+    }
+}
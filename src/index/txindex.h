@@ -46,6 +46,19 @@ public:
     /// @param[out]  tx  The transaction itself.
     /// @return  true if transaction is found, false otherwise
     bool FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const;
+
+    /// Look up many transactions at once. Their positions are fetched from
+    /// the index first and the disk reads then performed in file-offset
+    /// order, so a large batch becomes near-sequential I/O instead of random
+    /// seeks.
+    ///
+    /// @param[in]   tx_hashes  The hashes of the transactions to be returned.
+    /// @param[out]  block_hashes  Per transaction, the hash of the containing
+    ///                            block; entries for unknown or unreadable
+    ///                            transactions are left untouched.
+    /// @param[out]  txs  The transactions, in the order of tx_hashes; null
+    ///                   for unknown or unreadable transactions.
+    void FindTxs(const std::vector<uint256>& tx_hashes, std::vector<uint256>& block_hashes, std::vector<CTransactionRef>& txs) const;
 };
 
 /// The global transaction index, used in GetTransaction. May be null.
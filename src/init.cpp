@@ -16,12 +16,17 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <compat/sanity.h>
+#include <crypto/chacha20.h>
 #include <consensus/validation.h>
 #include <fs.h>
 #include <hash.h>
 #include <httprpc.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
+#include <index/addrindex.h>
+#include <index/coinstatsindex.h>
+#include <index/spentindex.h>
+#include <index/statsindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <interfaces/node.h>
@@ -33,6 +38,7 @@
 #include <net_processing.h>
 #include <netbase.h>
 #include <node/context.h>
+#include <node/headerstore.h>
 #include <node/ui_interface.h>
 #include <policy/feerate.h>
 #include <policy/fees.h>
@@ -40,6 +46,7 @@
 #include <policy/settings.h>
 #include <protocol.h>
 #include <rpc/blockchain.h>
+#include <rpc/mining.h>
 #include <rpc/register.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
@@ -65,6 +72,7 @@
 #include <validationinterface.h>
 #include <walletinitinterface.h>
 
+#include <atomic>
 #include <functional>
 #include <set>
 #include <stdint.h>
@@ -170,6 +178,18 @@ void Interrupt(NodeContext& node)
     if (g_txindex) {
         g_txindex->Interrupt();
     }
+    if (g_coin_stats_index) {
+        g_coin_stats_index->Interrupt();
+    }
+    if (g_addr_index) {
+        g_addr_index->Interrupt();
+    }
+    if (g_spent_index) {
+        g_spent_index->Interrupt();
+    }
+    if (g_stats_index) {
+        g_stats_index->Interrupt();
+    }
     ForEachBlockFilterIndex([](BlockFilterIndex& index) { index.Interrupt(); });
 }
 
@@ -186,12 +206,22 @@ void Shutdown(NodeContext& node)
     /// Be sure that anything that writes files or flushes caches only does this if the respective
     /// module was initialized.
     util::ThreadRename("shutoff");
+
+    // Write the shutdown sequence's log records synchronously, so none are
+    // lost if the process is killed before the async writer gets to them.
+    LogInstance().StopAsyncLogging();
+
     if (node.mempool) node.mempool->AddTransactionsUpdated(1);
 
     StopHTTPRPC();
     StopREST();
     StopRPC();
     StopHTTPServer();
+    // No new submissions can arrive now; wait for background block
+    // activations so they cannot outlive the chainstate.
+    WaitForAsyncBlockSubmissions();
+    g_async_verify_db.Interrupt();
+    g_headers_store.Close();
     for (const auto& client : node.chain_clients) {
         client->flush();
     }
@@ -229,13 +259,35 @@ void Shutdown(NodeContext& node)
     node.connman.reset();
     node.banman.reset();
 
+    // Serializing a large mempool can take several seconds; do it on a
+    // background thread so it overlaps with the chainstate flushes and index
+    // shutdown below. DumpMempool copies the mempool contents under its lock
+    // and serializes from the copy, so it does not interfere with them. The
+    // thread is joined before the mempool is destroyed.
+    std::thread dump_mempool_thread;
     if (node.mempool && node.mempool->IsLoaded() && node.args->GetArg("-persistmempool", DEFAULT_PERSIST_MEMPOOL)) {
-        DumpMempool(*node.mempool);
+        dump_mempool_thread = std::thread([&node] {
+            util::ThreadRename("dumpmempool");
+            DumpMempool(*node.mempool);
+        });
+    }
+
+    if (node.args->GetBoolArg("-persistscriptcache", DEFAULT_PERSIST_SCRIPT_CACHE)) {
+        DumpScriptExecutionCache();
     }
 
     // Drop transactions we were still watching, and record fee estimations.
     if (node.fee_estimator) node.fee_estimator->Flush();
 
+    // Record the coins cache hot set before the flush below empties the
+    // cache, so the next startup can prewarm it.
+    if (node.chainman && node.args->GetBoolArg("-warmcoinscache", DEFAULT_WARM_COINS_CACHE)) {
+        CChainState& chainstate = node.chainman->ActiveChainstate();
+        if (WITH_LOCK(cs_main, return chainstate.CanFlushToDisk())) {
+            DumpCoinsCacheHotSet(chainstate);
+        }
+    }
+
     // FlushStateToDisk generates a ChainStateFlushed callback, which we should avoid missing
     if (node.chainman) {
         LOCK(cs_main);
@@ -255,6 +307,22 @@ void Shutdown(NodeContext& node)
         g_txindex->Stop();
         g_txindex.reset();
     }
+    if (g_coin_stats_index) {
+        g_coin_stats_index->Stop();
+        g_coin_stats_index.reset();
+    }
+    if (g_addr_index) {
+        g_addr_index->Stop();
+        g_addr_index.reset();
+    }
+    if (g_spent_index) {
+        g_spent_index->Stop();
+        g_spent_index.reset();
+    }
+    if (g_stats_index) {
+        g_stats_index->Stop();
+        g_stats_index.reset();
+    }
     ForEachBlockFilterIndex([](BlockFilterIndex& index) { index.Stop(); });
     DestroyAllBlockFilterIndexes();
 
@@ -291,6 +359,7 @@ void Shutdown(NodeContext& node)
     GetMainSignals().UnregisterBackgroundSignalScheduler();
     globalVerifyHandle.reset();
     ECC_Stop();
+    if (dump_mempool_thread.joinable()) dump_mempool_thread.join();
     node.mempool.reset();
     node.fee_estimator.reset();
     node.chainman = nullptr;
@@ -397,17 +466,24 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-datadir=<dir>", "Specify data directory", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-dbcache=<n>", strprintf("Maximum database cache size <n> MiB (%d to %d, default: %d). In addition, unused mempool memory is shared for this cache (see -maxmempool).", nMinDbCache, nMaxDbCache, nDefaultDbCache), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-compressundo", strprintf("Compress newly written block undo data, trading some reorg CPU for smaller rev*.dat files (default: %u). Previously written undo data is unaffected", DEFAULT_COMPRESS_UNDO), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-dbgroupedcoins", "Create new chainstate databases with all unspent outputs of a txid grouped under one key, reducing read amplification for same-transaction spends (default: 0). Existing databases keep the layout they were created with", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-debuglogfile=<file>", strprintf("Specify location of debug log file. Relative paths will be prefixed by a net-specific datadir location. (-nodebuglogfile to disable; default: %s)", DEFAULT_DEBUGLOGFILE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-feefilter", strprintf("Tell other nodes to filter invs to us by our mempool min fee (default: %u)", DEFAULT_FEEFILTER), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-includeconf=<file>", "Specify additional configuration file, relative to the -datadir path (only useable from configuration file, not command line)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-loadblock=<file>", "Imports blocks from external file on startup", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-maxmempool=<n>", strprintf("Keep the transaction memory pool below <n> megabytes (default: %u)", DEFAULT_MAX_MEMPOOL_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-maxorphantx=<n>", strprintf("Keep at most <n> unconnectable transactions in memory (default: %u)", DEFAULT_MAX_ORPHAN_TRANSACTIONS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-mempoolbgtrim", strprintf("Evict transactions over the -maxmempool limit from a periodic background task instead of inline during transaction processing, allowing usage to briefly overshoot the limit by up to 10%% (default: %u)", DEFAULT_MEMPOOL_BG_TRIM), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-mempoolexpiry=<n>", strprintf("Do not keep transactions in the mempool longer than <n> hours (default: %u)", DEFAULT_MEMPOOL_EXPIRY), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet: %s, signet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex(), signetChainParams->GetConsensus().nMinimumChainWork.GetHex()), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-par=<n>", strprintf("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)",
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-optimisticconnect", strprintf("Periodically assemble the expected next block from the mempool in the background and test-connect it, so that connecting the real block mostly hits the script validation caches (default: %u)", DEFAULT_OPTIMISTIC_CONNECT), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-persistmempool", strprintf("Whether to save the mempool on shutdown and load on restart (default: %u)", DEFAULT_PERSIST_MEMPOOL), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-persistmempoolinterval=<n>", strprintf("If -persistmempool is set, additionally save the mempool every <n> minutes so that a crash loses at most that much mempool history (default: %u, 0 to only save on shutdown)", DEFAULT_PERSIST_MEMPOOL_INTERVAL), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-persistscriptcache", strprintf("Whether to save the script execution cache on shutdown and load on restart, so the first blocks connected after a restart skip script verification for transactions the node already validated (default: %u)", DEFAULT_PERSIST_SCRIPT_CACHE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-warmcoinscache", strprintf("Save the set of outpoints held in the coins cache on shutdown and use it to prewarm the cache on the next startup (default: %u)", DEFAULT_WARM_COINS_CACHE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-pid=<file>", strprintf("Specify pid file. Relative paths will be prefixed by a net-specific datadir location. (default: %s)", BITCOIN_PID_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-prune=<n>", strprintf("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks, and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex and -rescan. "
             "Warning: Reverting this setting requires re-downloading the entire blockchain. "
@@ -424,6 +500,11 @@ void SetupServerArgs(NodeContext& node)
     hidden_args.emplace_back("-sysperms");
 #endif
     argsman.AddArg("-txindex", strprintf("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)", DEFAULT_TXINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-coinstatsindex", strprintf("Maintain coinstats index used by the gettxoutsetinfo RPC (default: %u)", DEFAULT_COINSTATSINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-addressindex", strprintf("Maintain a full address index, used by the getaddresstxids and getaddressutxos RPCs (default: %u)", DEFAULT_ADDRINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-spentindex", strprintf("Maintain a full spent-output index, used by the getspentinfo RPC (default: %u)", DEFAULT_SPENTINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-statsindex", strprintf("Maintain an index of per-block statistics, used by the getblockstats RPC (default: %u)", DEFAULT_STATSINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-indexworkers=<n>", strprintf("Number of worker threads used to read and pre-process blocks during the initial sync of enabled indexes (0 = auto, default: %d)", DEFAULT_INDEX_WORKERS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blockfilterindex=<type>",
                  strprintf("Maintain an index of compact filters by block (default: %s, values: %s).", DEFAULT_BLOCKFILTERINDEX, ListBlockFilterTypes()) +
                  " If <type> is not supplied or if <type> = 1, indexes for all known types are enabled.",
@@ -461,6 +542,7 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-networkactive", "Enable all P2P network activity (default: 1). Can be changed by the setnetworkactive RPC command", ArgsManager::ALLOW_BOOL, OptionsCategory::CONNECTION);
     argsman.AddArg("-timeout=<n>", strprintf("Specify socket connection timeout in milliseconds. If an initial attempt to connect is unsuccessful after this amount of time, drop it (minimum: 1, default: %d)", DEFAULT_CONNECT_TIMEOUT), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-peertimeout=<n>", strprintf("Specify a p2p connection timeout delay in seconds. After connecting to a peer, wait this amount of time before considering disconnection based on inactivity (minimum: 1, default: %d)", DEFAULT_PEER_CONNECT_TIMEOUT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::CONNECTION);
+    argsman.AddArg("-msghandlerthreads=<n>", strprintf("Number of p2p message handling threads. Peers are processed concurrently while any single peer's messages are handled in order (minimum: 1, default: %d)", DEFAULT_MSGHANDLER_THREADS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::CONNECTION);
     argsman.AddArg("-torcontrol=<ip>:<port>", strprintf("Tor control port to use if onion listening enabled (default: %s)", DEFAULT_TOR_CONTROL), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     argsman.AddArg("-torpassword=<pass>", "Tor control port password (default: empty)", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::CONNECTION);
 #ifdef USE_UPNP
@@ -492,22 +574,26 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-zmqpubhashtx=<address>", "Enable publish hash transaction in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawblock=<address>", "Enable publish raw block in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawtx=<address>", "Enable publish raw transaction in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubrawtemplate=<address>", "Enable publish raw block template in <address> whenever one is assembled", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubsequence=<address>", "Enable publish hash block and tx sequence in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubhashblockhwm=<n>", strprintf("Set publish hash block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubhashtxhwm=<n>", strprintf("Set publish hash transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawblockhwm=<n>", strprintf("Set publish raw block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubrawtxhwm=<n>", strprintf("Set publish raw transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    argsman.AddArg("-zmqpubrawtemplatehwm=<n>", strprintf("Set publish raw block template outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     argsman.AddArg("-zmqpubsequencehwm=<n>", strprintf("Set publish hash sequence message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
 #else
     hidden_args.emplace_back("-zmqpubhashblock=<address>");
     hidden_args.emplace_back("-zmqpubhashtx=<address>");
     hidden_args.emplace_back("-zmqpubrawblock=<address>");
     hidden_args.emplace_back("-zmqpubrawtx=<address>");
+    hidden_args.emplace_back("-zmqpubrawtemplate=<address>");
     hidden_args.emplace_back("-zmqpubsequence=<n>");
     hidden_args.emplace_back("-zmqpubhashblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubhashtxhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawtxhwm=<n>");
+    hidden_args.emplace_back("-zmqpubrawtemplatehwm=<n>");
     hidden_args.emplace_back("-zmqpubsequencehwm=<n>");
 #endif
 
@@ -525,6 +611,11 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-limitdescendantsize=<n>", strprintf("Do not accept transactions if any ancestor would have more than <n> kilobytes of in-mempool descendants (default: %u).", DEFAULT_DESCENDANT_SIZE_LIMIT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-addrmantest", "Allows to test address relay on localhost", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-capturemessages", "Capture all P2P messages to disk", ArgsManager::ALLOW_BOOL | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-txrequestnonprefdelay=<ms>", "Delay before requesting announced transactions from non-preferred (inbound) peers (default: 2000)", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-txrequesttxiddelay=<ms>", "Delay before requesting transactions announced by txid while wtxid-relaying peers are available (default: 2000)", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-txrequestoverloadeddelay=<ms>", "Delay before requesting transactions from peers exceeding -txrequestmaxinflight (default: 2000)", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-txrequestgetdatainterval=<ms>", "Time to wait for a response before requesting a transaction from an additional peer (default: 60000)", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-txrequestmaxinflight=<n>", "Number of in-flight transaction requests to a peer above which further requests are delayed (default: 100)", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-debug=<category>", "Output debugging information (default: -nodebug, supplying <category> is optional). "
         "If <category> is not supplied or if <category> = 1, output all debugging information. <category> can be: " + LogInstance().LogCategoriesString() + ". This option can be specified multiple times to output multiple categories.",
         ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
@@ -537,6 +628,8 @@ void SetupServerArgs(NodeContext& node)
     hidden_args.emplace_back("-logthreadnames");
 #endif
     argsman.AddArg("-logsourcelocations", strprintf("Prepend debug output with name of the originating source location (source file, line number and function name) (default: %u)", DEFAULT_LOGSOURCELOCATIONS), ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-schedulerthreads=<n>", strprintf("Number of background scheduler threads. Tasks marked exclusive still run alone (default: %u)", DEFAULT_SCHEDULER_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-logasync", strprintf("Write log records from a dedicated thread instead of on the logging caller, so heavy -debug categories do not slow down the node (default: %u)", DEFAULT_LOGASYNC), ArgsManager::ALLOW_ANY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-logtimemicros", strprintf("Add microsecond precision to debug timestamps (default: %u)", DEFAULT_LOGTIMEMICROS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-mocktime=<n>", "Replace actual time with " + UNIX_EPOCH_TIME + " (default: 0)", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-maxsigcachesize=<n>", strprintf("Limit sum of signature cache and script execution cache sizes to <n> MiB (default: %u)", DEFAULT_MAX_SIG_CACHE_SIZE), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
@@ -577,6 +670,10 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-rpcuser=<user>", "Username for JSON-RPC connections", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
     argsman.AddArg("-rpcwhitelist=<whitelist>", "Set a whitelist to filter incoming RPC calls for a specific user. The field <whitelist> comes in the format: <USERNAME>:<rpc 1>,<rpc 2>,...,<rpc n>. If multiple whitelists are set for a given user, they are set-intersected. See -rpcwhitelistdefault documentation for information on default whitelist behavior.", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcwhitelistdefault", "Sets default behavior for rpc whitelisting. Unless rpcwhitelistdefault is set to 0, if any -rpcwhitelist is set, the rpc server acts as if all rpc users are subject to empty-unless-otherwise-specified whitelists. If rpcwhitelistdefault is set to 1 and no -rpcwhitelist is set, rpc server acts as if all rpc users are subject to empty whitelists.", ArgsManager::ALLOW_BOOL, OptionsCategory::RPC);
+    argsman.AddArg("-rpcbatchconcurrency=<n>", strprintf("Maximum number of threads used to execute the members of a single JSON-RPC batch request in parallel (default: %d)", DEFAULT_RPC_BATCH_CONCURRENCY), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::RPC);
+    argsman.AddArg("-rpclowprioritymethod=<method>", "Serve the given RPC method from a low-priority lane of the HTTP work queue. Low-priority requests never run on worker threads reserved via -rpcreservedthreads, so bursts of them cannot starve other RPCs. This option can be specified multiple times", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpclowpriorityuser=<user>", "Serve all RPC requests authenticated as the given username from the low-priority lane (see -rpclowprioritymethod). This option can be specified multiple times", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcreservedthreads=<n>", strprintf("Number of RPC worker threads that never serve low-priority requests. Only meaningful when low-priority lanes are configured, and capped at -rpcthreads minus one (default: %d)", DEFAULT_HTTP_RESERVED_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcworkqueue=<n>", strprintf("Set the depth of the work queue to service RPC calls (default: %d)", DEFAULT_HTTP_WORKQUEUE), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::RPC);
     argsman.AddArg("-server", "Accept command line and JSON-RPC commands", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
 
@@ -697,26 +794,52 @@ static void ThreadImport(ChainstateManager& chainman, std::vector<fs::path> vImp
     const CChainParams& chainparams = Params();
     ScheduleBatchPriority();
 
+    // Restore the script execution cache (and its salt) before any block is
+    // connected, so both the import below and the first blocks after startup
+    // hit entries validated before the restart.
+    if (args.GetBoolArg("-persistscriptcache", DEFAULT_PERSIST_SCRIPT_CACHE)) {
+        LoadScriptExecutionCache();
+    }
+
     {
     CImportingNow imp;
 
     // -reindex
     if (fReindex) {
-        int nFile = 0;
-        while (true) {
-            FlatFilePos pos(nFile, 0);
-            if (!fs::exists(GetBlockPosFilename(pos)))
-                break; // No block files left to reindex
-            FILE *file = OpenBlockFile(pos, true);
-            if (!file)
-                break; // This error is logged in OpenBlockFile
-            LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
-            ::ChainstateActive().LoadExternalBlockFile(chainparams, file, &pos);
-            if (ShutdownRequested()) {
-                LogPrintf("Shutdown requested. Exit %s\n", __func__);
-                return;
+        // Scan several block files concurrently. Block acceptance serializes
+        // on cs_main, but the magic-byte scan, deserialization and block
+        // hashing — the bulk of the scan phase — parallelize across files.
+        // Out-of-order blocks (including whole files scanned ahead of their
+        // parents) are handled by the unknown-parent tracking inside
+        // LoadExternalBlockFile, the same way they always were within a file.
+        const int num_workers = std::clamp(GetNumCores(), 1, 8);
+        std::atomic<int> next_file{0};
+        std::atomic<bool> files_exhausted{false};
+        auto scan_files = [&] {
+            while (!files_exhausted && !ShutdownRequested()) {
+                const int nFile = next_file.fetch_add(1);
+                FlatFilePos pos(nFile, 0);
+                if (!fs::exists(GetBlockPosFilename(pos))) {
+                    files_exhausted = true; // No block files left to reindex
+                    break;
+                }
+                FILE *file = OpenBlockFile(pos, true);
+                if (!file) {
+                    files_exhausted = true; // This error is logged in OpenBlockFile
+                    break;
+                }
+                LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
+                ::ChainstateActive().LoadExternalBlockFile(chainparams, file, &pos);
             }
-            nFile++;
+        };
+        std::vector<std::thread> scan_threads;
+        scan_threads.reserve(num_workers - 1);
+        for (int i = 1; i < num_workers; ++i) scan_threads.emplace_back(scan_files);
+        scan_files();
+        for (auto& thread : scan_threads) thread.join();
+        if (ShutdownRequested()) {
+            LogPrintf("Shutdown requested. Exit %s\n", __func__);
+            return;
         }
         pblocktree->WriteReindexing(false);
         fReindex = false;
@@ -760,6 +883,15 @@ static void ThreadImport(ChainstateManager& chainman, std::vector<fs::path> vImp
         return;
     }
     } // End scope of CImportingNow
+
+    // Prewarm the coins cache with the hot set recorded at the last
+    // shutdown, so block connection (and the mempool load below, which
+    // fetches the inputs of every mempool transaction) starts out with warm
+    // caches instead of paying a leveldb miss per coin for hours.
+    if (args.GetBoolArg("-warmcoinscache", DEFAULT_WARM_COINS_CACHE)) {
+        WarmCoinsCache(chainman.ActiveChainstate());
+    }
+
     chainman.ActiveChainstate().LoadMempool(args);
 }
 
@@ -1035,10 +1167,18 @@ bool AppInitParameterInteraction(const ArgsManager& args)
         nLocalServices = ServiceFlags(nLocalServices | NODE_COMPACT_FILTERS);
     }
 
-    // if using block pruning, then disallow txindex
+    // if using block pruning, then disallow txindex and coinstatsindex
     if (args.GetArg("-prune", 0)) {
         if (args.GetBoolArg("-txindex", DEFAULT_TXINDEX))
             return InitError(_("Prune mode is incompatible with -txindex."));
+        if (args.GetBoolArg("-coinstatsindex", DEFAULT_COINSTATSINDEX))
+            return InitError(_("Prune mode is incompatible with -coinstatsindex."));
+        if (args.GetBoolArg("-addressindex", DEFAULT_ADDRINDEX))
+            return InitError(_("Prune mode is incompatible with -addressindex."));
+        if (args.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX))
+            return InitError(_("Prune mode is incompatible with -spentindex."));
+        if (args.GetBoolArg("-statsindex", DEFAULT_STATSINDEX))
+            return InitError(_("Prune mode is incompatible with -statsindex."));
     }
 
     // -bind and -whitebind can't be set when not listening
@@ -1239,6 +1379,8 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string chacha20_algo = ChaCha20AutoDetect();
+    LogPrintf("Using the '%s' ChaCha20 implementation\n", chacha20_algo);
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1296,6 +1438,9 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
             return InitError(strprintf(Untranslated("Could not open debug log file %s"),
                 LogInstance().m_file_path.string()));
     }
+    if (args.GetBoolArg("-logasync", DEFAULT_LOGASYNC)) {
+        LogInstance().StartAsyncLogging();
+    }
 
     if (!LogInstance().m_log_timestamps)
         LogPrintf("Startup time: %s\n", FormatISO8601DateTime(GetTime()));
@@ -1356,6 +1501,15 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
     // Start the lightweight task scheduler thread
     node.scheduler->m_service_thread = std::thread([&] { TraceThread("scheduler", [&] { node.scheduler->serviceQueue(); }); });
 
+    // Optional extra workers, so one slow maintenance task (a peers.dat dump,
+    // a wallet flush) cannot head-of-line block the tasks queued behind it.
+    // Validation interface callbacks stay serialized regardless, via
+    // SingleThreadedSchedulerClient.
+    const int scheduler_threads = args.GetArg("-schedulerthreads", DEFAULT_SCHEDULER_THREADS);
+    if (scheduler_threads > 1) {
+        node.scheduler->StartWorkers(scheduler_threads - 1);
+    }
+
     // Gather some entropy once per minute.
     node.scheduler->scheduleEvery([]{
         RandAddPeriodic();
@@ -1410,7 +1564,14 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
     assert(!node.fee_estimator);
     // Don't initialize fee estimation with old data if we don't relay transactions,
     // as they would never get updated.
-    if (!ignores_incoming_txs) node.fee_estimator = std::make_unique<CBlockPolicyEstimator>();
+    if (!ignores_incoming_txs) {
+        node.fee_estimator = std::make_unique<CBlockPolicyEstimator>();
+
+        // Flush estimates to disk periodically, so an unclean shutdown loses
+        // at most an interval's worth of estimation data.
+        CBlockPolicyEstimator* fee_estimator = node.fee_estimator.get();
+        node.scheduler->scheduleEvery([fee_estimator] { fee_estimator->FlushFeeEstimates(); }, FEE_FLUSH_INTERVAL);
+    }
 
     assert(!node.mempool);
     int check_ratio = std::min<int>(std::max<int>(args.GetArg("-checkmempool", chainparams.DefaultConsistencyChecks() ? 1 : 0), 0), 1000000);
@@ -1536,6 +1697,11 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
 
     if (g_zmq_notification_interface) {
         RegisterValidationInterface(g_zmq_notification_interface);
+        // Template assembly is not a validation event, so feed freshly built
+        // templates to the rawtemplate publisher directly.
+        BlockAssembler::m_template_publisher = [](const CBlock& block) {
+            if (g_zmq_notification_interface) g_zmq_notification_interface->BlockTemplate(block);
+        };
     }
 #endif
 
@@ -1768,6 +1934,12 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
             if (!failed_verification) {
                 fLoaded = true;
                 LogPrintf(" block index %15dms\n", GetTimeMillis() - load_block_index_start_time);
+                // Bring the flat headers file in line with the loaded chain
+                // so header responses can be served from it.
+                if (g_headers_store.Open(GetBlocksDir() / "headers.dat")) {
+                    LOCK(cs_main);
+                    g_headers_store.SyncToChain(chainman.ActiveChain());
+                }
             }
         } while(false);
 
@@ -1805,6 +1977,26 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
         g_txindex->Start();
     }
 
+    if (args.GetBoolArg("-coinstatsindex", DEFAULT_COINSTATSINDEX)) {
+        g_coin_stats_index = std::make_unique<CoinStatsIndex>(/* cache size */ 0, false, fReindex);
+        g_coin_stats_index->Start();
+    }
+
+    if (args.GetBoolArg("-addressindex", DEFAULT_ADDRINDEX)) {
+        g_addr_index = std::make_unique<AddrIndex>(/* cache size */ 0, false, fReindex);
+        g_addr_index->Start();
+    }
+
+    if (args.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX)) {
+        g_spent_index = std::make_unique<SpentIndex>(/* cache size */ 0, false, fReindex);
+        g_spent_index->Start();
+    }
+
+    if (args.GetBoolArg("-statsindex", DEFAULT_STATSINDEX)) {
+        g_stats_index = std::make_unique<StatsIndex>(/* cache size */ 0, false, fReindex);
+        g_stats_index->Start();
+    }
+
     for (const auto& filter_type : g_enabled_filter_types) {
         InitBlockFilterIndex(filter_type, filter_index_cache, false, fReindex);
         GetBlockFilterIndex(filter_type)->Start();
@@ -1940,6 +2132,7 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
 
     connOptions.nMaxOutboundLimit = 1024 * 1024 * args.GetArg("-maxuploadtarget", DEFAULT_MAX_UPLOAD_TARGET);
     connOptions.m_peer_connect_timeout = peer_connect_timeout;
+    connOptions.m_msgproc_threads = std::max<int64_t>(1, args.GetArg("-msghandlerthreads", DEFAULT_MSGHANDLER_THREADS));
 
     for (const std::string& bind_arg : args.GetArgs("-bind")) {
         CService bind_addr;
@@ -2031,6 +2224,30 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
         banman->DumpBanlist();
     }, DUMP_BANS_INTERVAL);
 
+    // Optionally snapshot the mempool to disk periodically, so a crash loses
+    // at most an interval's worth of mempool transactions. Only the brief
+    // copy of the mempool contents happens under the mempool lock; the file
+    // is written from the copy.
+    if (args.GetArg("-persistmempool", DEFAULT_PERSIST_MEMPOOL)) {
+        const std::chrono::minutes persist_interval{args.GetArg("-persistmempoolinterval", DEFAULT_PERSIST_MEMPOOL_INTERVAL)};
+        if (persist_interval > std::chrono::minutes::zero()) {
+            CTxMemPool* mempool = node.mempool.get();
+            node.scheduler->scheduleEvery([mempool] {
+                if (mempool->IsLoaded()) DumpMempool(*mempool);
+            }, persist_interval);
+        }
+    }
+
+    if (args.GetBoolArg("-optimisticconnect", DEFAULT_OPTIMISTIC_CONNECT)) {
+        // Speculatively test-connect the expected next block between blocks
+        // so the real connect mostly hits the script validation caches. Low
+        // priority: a falling-behind scheduler queue should drop this first.
+        CTxMemPool* mempool = node.mempool.get();
+        node.scheduler->scheduleEvery([mempool] {
+            PrevalidateNextBlockTemplate(*mempool, Params(), ::ChainstateActive());
+        }, OPTIMISTIC_CONNECT_INTERVAL, CScheduler::Priority::LOW);
+    }
+
 #if HAVE_SYSTEM
     StartupNotify(args);
 #endif
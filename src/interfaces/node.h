@@ -95,6 +95,14 @@ public:
     using NodesStats = std::vector<std::tuple<CNodeStats, bool, CNodeStateStats>>;
     virtual bool getNodesStats(NodesStats& stats) = 0;
 
+    //! Get stats only for peers that changed since the caller's last poll.
+    //! `known` maps node ids the caller already has data for to the total
+    //! traffic (sent plus received bytes) it last saw for them; peers whose
+    //! totals are unchanged are omitted from `stats` (all observable peer
+    //! activity moves these counters). Ids in `known` that are no longer
+    //! connected are returned in `disconnected`.
+    virtual bool getNodesStatsDelta(const std::map<NodeId, uint64_t>& known, NodesStats& stats, std::vector<NodeId>& disconnected) = 0;
+
     //! Get ban map entries.
     virtual bool getBanned(banmap_t& banmap) = 0;
 
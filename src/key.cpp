@@ -7,10 +7,14 @@
 
 #include <crypto/common.h>
 #include <crypto/hmac_sha512.h>
+#include <hash.h>
 #include <random.h>
+#include <support/cleanse.h>
 
 #include <secp256k1.h>
+#include <secp256k1_extrakeys.h>
 #include <secp256k1_recovery.h>
+#include <secp256k1_schnorrsig.h>
 
 static secp256k1_context* secp256k1_context_sign = nullptr;
 
@@ -258,6 +262,30 @@ bool CKey::SignCompact(const uint256 &hash, std::vector<unsigned char>& vchSig)
     return true;
 }
 
+bool CKey::SignSchnorr(const uint256& hash, Span<unsigned char> sig, const uint256* merkle_root) const
+{
+    assert(sig.size() == 64);
+    if (!fValid) return false;
+    secp256k1_keypair keypair;
+    if (!secp256k1_keypair_create(secp256k1_context_sign, &keypair, begin())) return false;
+    if (merkle_root) {
+        secp256k1_xonly_pubkey pubkey;
+        if (!secp256k1_keypair_xonly_pub(secp256k1_context_sign, &pubkey, nullptr, &keypair)) return false;
+        unsigned char pubkey_bytes[32];
+        if (!secp256k1_xonly_pubkey_serialize(secp256k1_context_sign, pubkey_bytes, &pubkey)) return false;
+        // BIP341 tweak: t = H_TapTweak(xonly_pubkey || merkle_root), where the
+        // Merkle root is omitted when committing to an empty script tree.
+        CHashWriter ss = TaggedHash("TapTweak");
+        ss.write((const char*)pubkey_bytes, 32);
+        if (!merkle_root->IsNull()) ss << *merkle_root;
+        const uint256 tweak = ss.GetSHA256();
+        if (!secp256k1_keypair_xonly_tweak_add(secp256k1_context_sign, &keypair, tweak.data())) return false;
+    }
+    const bool ret = secp256k1_schnorrsig_sign(secp256k1_context_sign, sig.data(), hash.begin(), &keypair, nullptr, nullptr);
+    memory_cleanse(&keypair, sizeof(keypair));
+    return ret;
+}
+
 bool CKey::Load(const CPrivKey &seckey, const CPubKey &vchPubKey, bool fSkipCheck=false) {
     if (!ec_seckey_import_der(secp256k1_context_sign, (unsigned char*)begin(), seckey.data(), seckey.size()))
         return false;
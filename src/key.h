@@ -128,6 +128,16 @@ public:
      */
     bool SignCompact(const uint256& hash, std::vector<unsigned char>& vchSig) const;
 
+    /**
+     * Create a BIP-340 Schnorr signature, for the x-only public key corresponding
+     * to this key, optionally tweaked by the Merkle root of a BIP341 script tree.
+     *
+     * merkle_root: the Merkle root of the script tree to commit to. nullptr to
+     *              sign with the untweaked key (e.g. within tapscript), uint256()
+     *              to commit to an empty tree (key path only spending).
+     */
+    bool SignSchnorr(const uint256& hash, Span<unsigned char> sig, const uint256* merkle_root = nullptr) const;
+
     //! Derive BIP32 child key.
     bool Derive(CKey& keyChild, ChainCode &ccChild, unsigned int nChild, const ChainCode& cc) const;
 
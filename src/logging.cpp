@@ -8,6 +8,7 @@
 #include <util/string.h>
 #include <util/time.h>
 
+#include <chrono>
 #include <mutex>
 
 const char * const DEFAULT_DEBUGLOGFILE = "debug.log";
@@ -238,9 +239,8 @@ namespace BCLog {
     }
 }
 
-void BCLog::Logger::LogPrintStr(const std::string& str, const std::string& logging_function, const std::string& source_file, const int source_line)
+std::string BCLog::Logger::FormatLogStr(const std::string& str, const std::string& logging_function, const std::string& source_file, const int source_line)
 {
-    StdLockGuard scoped_lock(m_cs);
     std::string str_prefixed = LogEscapeMessage(str);
 
     if (m_log_sourcelocations && m_started_new_line) {
@@ -255,19 +255,18 @@ void BCLog::Logger::LogPrintStr(const std::string& str, const std::string& loggi
 
     m_started_new_line = !str.empty() && str[str.size()-1] == '\n';
 
-    if (m_buffering) {
-        // buffer if we haven't started logging yet
-        m_msgs_before_open.push_back(str_prefixed);
-        return;
-    }
+    return str_prefixed;
+}
 
+void BCLog::Logger::WriteStr(const std::string& str)
+{
     if (m_print_to_console) {
         // print to console
-        fwrite(str_prefixed.data(), 1, str_prefixed.size(), stdout);
+        fwrite(str.data(), 1, str.size(), stdout);
         fflush(stdout);
     }
     for (const auto& cb : m_print_callbacks) {
-        cb(str_prefixed);
+        cb(str);
     }
     if (m_print_to_file) {
         assert(m_fileout != nullptr);
@@ -282,7 +281,141 @@ void BCLog::Logger::LogPrintStr(const std::string& str, const std::string& loggi
                 m_fileout = new_fileout;
             }
         }
-        FileWriteStr(str_prefixed, m_fileout);
+        FileWriteStr(str, m_fileout);
+    }
+}
+
+void BCLog::Logger::LogPrintStr(const std::string& str, const std::string& logging_function, const std::string& source_file, const int source_line)
+{
+    if (m_async.load(std::memory_order_acquire)) {
+        // Format on the calling thread (cheap) and hand the record to the
+        // writer thread; the caller never touches m_cs or the log file.
+        std::string str_prefixed = FormatLogStr(str, logging_function, source_file, source_line);
+        if (!EnqueueAsync(std::move(str_prefixed))) {
+            m_async_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    StdLockGuard scoped_lock(m_cs);
+    std::string str_prefixed = FormatLogStr(str, logging_function, source_file, source_line);
+
+    if (m_buffering) {
+        // buffer if we haven't started logging yet
+        m_msgs_before_open.push_back(str_prefixed);
+        return;
+    }
+
+    WriteStr(str_prefixed);
+}
+
+//! Capacity of the asynchronous logging ring buffer. Must be a power of two.
+static constexpr uint64_t ASYNC_LOG_BUFFER_SIZE{8192};
+
+bool BCLog::Logger::EnqueueAsync(std::string&& str)
+{
+    uint64_t ticket = m_async_head.load(std::memory_order_relaxed);
+    for (;;) {
+        AsyncLogSlot& slot = m_async_buffer[ticket & (ASYNC_LOG_BUFFER_SIZE - 1)];
+        const uint64_t seq = slot.m_seq.load(std::memory_order_acquire);
+        const int64_t diff = (int64_t)(seq - ticket);
+        if (diff == 0) {
+            // The slot is free for this ticket; claim it.
+            if (m_async_head.compare_exchange_weak(ticket, ticket + 1, std::memory_order_relaxed)) {
+                slot.m_msg = std::move(str);
+                slot.m_seq.store(ticket + 1, std::memory_order_release);
+                m_async_cv.notify_one();
+                return true;
+            }
+        } else if (diff < 0) {
+            // The writer has not consumed this slot's previous record yet:
+            // the buffer is full.
+            return false;
+        } else {
+            // Another producer claimed the slot; reload and retry.
+            ticket = m_async_head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void BCLog::Logger::AsyncWriterThread()
+{
+    util::ThreadRename("logwriter");
+
+    std::string batch;
+    for (;;) {
+        // Drain every published record into one buffer so the batch hits the
+        // (unbuffered) log file with a single write.
+        batch.clear();
+        for (;;) {
+            AsyncLogSlot& slot = m_async_buffer[m_async_tail & (ASYNC_LOG_BUFFER_SIZE - 1)];
+            if (slot.m_seq.load(std::memory_order_acquire) != m_async_tail + 1) break;
+            batch += slot.m_msg;
+            slot.m_msg.clear();
+            slot.m_msg.shrink_to_fit();
+            slot.m_seq.store(m_async_tail + ASYNC_LOG_BUFFER_SIZE, std::memory_order_release);
+            ++m_async_tail;
+        }
+
+        const uint64_t dropped = m_async_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            batch += LogTimestampStr(strprintf("Async logging overflow: %d log records dropped\n", dropped));
+        }
+
+        if (!batch.empty()) {
+            StdLockGuard scoped_lock(m_cs);
+            WriteStr(batch);
+            continue;
+        }
+
+        if (m_async_interrupt.load(std::memory_order_acquire)) break;
+
+        // Producers notify without holding m_async_mutex, so a wakeup can be
+        // missed; bound the added latency with a timed wait.
+        std::unique_lock<std::mutex> lock(m_async_mutex);
+        m_async_cv.wait_for(lock, std::chrono::milliseconds{50});
+    }
+}
+
+void BCLog::Logger::StartAsyncLogging()
+{
+    assert(!m_async);
+    assert(!m_async_writer.joinable());
+
+    m_async_buffer = std::vector<AsyncLogSlot>(ASYNC_LOG_BUFFER_SIZE);
+    for (uint64_t i = 0; i < ASYNC_LOG_BUFFER_SIZE; ++i) {
+        m_async_buffer[i].m_seq.store(i, std::memory_order_relaxed);
+    }
+    m_async_head = 0;
+    m_async_tail = 0;
+    m_async_interrupt = false;
+    m_async_writer = std::thread(&BCLog::Logger::AsyncWriterThread, this);
+    m_async.store(true, std::memory_order_release);
+}
+
+void BCLog::Logger::StopAsyncLogging()
+{
+    // Route new records back to the synchronous path first, then let the
+    // writer drain whatever is still queued before it exits.
+    if (!m_async.exchange(false)) return;
+    m_async_interrupt.store(true, std::memory_order_release);
+    m_async_cv.notify_one();
+    if (m_async_writer.joinable()) m_async_writer.join();
+
+    // A producer that saw the async flag just before it was cleared may have
+    // published a record after the writer's final drain; flush any leftovers
+    // inline.
+    std::string leftovers;
+    for (;;) {
+        AsyncLogSlot& slot = m_async_buffer[m_async_tail & (ASYNC_LOG_BUFFER_SIZE - 1)];
+        if (slot.m_seq.load(std::memory_order_acquire) != m_async_tail + 1) break;
+        leftovers += slot.m_msg;
+        slot.m_msg.clear();
+        ++m_async_tail;
+    }
+    if (!leftovers.empty()) {
+        StdLockGuard scoped_lock(m_cs);
+        WriteStr(leftovers);
     }
 }
 
@@ -12,10 +12,12 @@
 #include <util/string.h>
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <list>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 static const bool DEFAULT_LOGTIMEMICROS = false;
@@ -23,6 +25,7 @@ static const bool DEFAULT_LOGIPS        = false;
 static const bool DEFAULT_LOGTIMESTAMPS = true;
 static const bool DEFAULT_LOGTHREADNAMES = false;
 static const bool DEFAULT_LOGSOURCELOCATIONS = false;
+static const bool DEFAULT_LOGASYNC = false;
 extern const char * const DEFAULT_DEBUGLOGFILE;
 
 extern bool fLogIPs;
@@ -82,9 +85,46 @@ namespace BCLog {
 
         std::string LogTimestampStr(const std::string& str);
 
+        /** Apply escaping, source location, thread name and timestamp prefixes. */
+        std::string FormatLogStr(const std::string& str, const std::string& logging_function, const std::string& source_file, int source_line);
+
+        /** Write a formatted record to the console, print callbacks and log file. */
+        void WriteStr(const std::string& str) EXCLUSIVE_LOCKS_REQUIRED(m_cs);
+
         /** Slots that connect to the print signal */
         std::list<std::function<void(const std::string&)>> m_print_callbacks GUARDED_BY(m_cs) {};
 
+        /**
+         * Asynchronous backend: a bounded multi-producer single-consumer ring
+         * buffer of preformatted records (Vyukov bounded queue), drained by a
+         * dedicated writer thread that writes each batch with a single call.
+         * Producers enqueue lock-free; on overflow the record is dropped and
+         * counted, and the writer reports the drops in-line.
+         */
+        struct AsyncLogSlot {
+            //! Turn indicator: equals the slot's claim ticket when free, the
+            //! ticket + 1 once a record has been published into it.
+            std::atomic<uint64_t> m_seq{0};
+            std::string m_msg;
+        };
+        std::vector<AsyncLogSlot> m_async_buffer;
+        //! Next ticket producers claim.
+        std::atomic<uint64_t> m_async_head{0};
+        //! Next ticket the writer consumes. Writer thread only.
+        uint64_t m_async_tail{0};
+        //! Records dropped on overflow since the writer last reported them.
+        std::atomic<uint64_t> m_async_dropped{0};
+        //! Route new records through the ring buffer instead of writing inline.
+        std::atomic<bool> m_async{false};
+        std::atomic<bool> m_async_interrupt{false};
+        std::thread m_async_writer;
+        std::mutex m_async_mutex;
+        std::condition_variable m_async_cv;
+
+        //! Publish a record into the ring buffer; false if it is full.
+        bool EnqueueAsync(std::string&& str);
+        void AsyncWriterThread();
+
     public:
         bool m_print_to_console = false;
         bool m_print_to_file = false;
@@ -127,6 +167,19 @@ namespace BCLog {
         /** Only for testing */
         void DisconnectTestLogger();
 
+        /**
+         * Hand subsequent records to a dedicated writer thread, so logging
+         * callers only pay for formatting and a lock-free enqueue. Must be
+         * called after StartLogging().
+         */
+        void StartAsyncLogging();
+        /**
+         * Drain the ring buffer, stop the writer thread and return to
+         * synchronous writes. Called early in shutdown so the remaining
+         * messages cannot be lost to an interrupted writer.
+         */
+        void StopAsyncLogging();
+
         void ShrinkDebugFile();
 
         uint32_t GetCategoryMask() const { return m_categories.load(); }
@@ -22,6 +22,7 @@
 #include <util/system.h>
 
 #include <algorithm>
+#include <future>
 #include <utility>
 
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev)
@@ -47,7 +48,7 @@ void RegenerateCommitments(CBlock& block, BlockManager& blockman)
 
     GenerateCoinbaseCommitment(block, WITH_LOCK(::cs_main, assert(std::addressof(g_chainman.m_blockman) == std::addressof(blockman)); return blockman.LookupBlockIndex(block.hashPrevBlock)), Params().GetConsensus());
 
-    block.hashMerkleRoot = BlockMerkleRoot(block);
+    block.hashMerkleRoot = BlockMerkleRoot(block, /* mutated */ nullptr, GetNumCores());
 }
 
 BlockAssembler::Options::Options() {
@@ -82,6 +83,16 @@ static BlockAssembler::Options DefaultOptions()
 BlockAssembler::BlockAssembler(const CTxMemPool& mempool, const CChainParams& params)
     : BlockAssembler(mempool, params, DefaultOptions()) {}
 
+Mutex BlockAssembler::m_template_mutex;
+std::unique_ptr<CBlockTemplate> BlockAssembler::m_cached_template GUARDED_BY(BlockAssembler::m_template_mutex);
+uint256 BlockAssembler::m_cached_template_tip GUARDED_BY(BlockAssembler::m_template_mutex);
+unsigned int BlockAssembler::m_cached_template_updates GUARDED_BY(BlockAssembler::m_template_mutex){0};
+const CTxMemPool* BlockAssembler::m_cached_template_mempool GUARDED_BY(BlockAssembler::m_template_mutex){nullptr};
+size_t BlockAssembler::m_cached_template_max_weight GUARDED_BY(BlockAssembler::m_template_mutex){0};
+CFeeRate BlockAssembler::m_cached_template_min_feerate GUARDED_BY(BlockAssembler::m_template_mutex);
+int BlockAssembler::m_cached_template_height GUARDED_BY(BlockAssembler::m_template_mutex){0};
+int64_t BlockAssembler::m_cached_template_locktime_cutoff GUARDED_BY(BlockAssembler::m_template_mutex){0};
+
 void BlockAssembler::resetBlock()
 {
     inBlock.clear();
@@ -132,6 +143,38 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(CChainState& chai
                        ? nMedianTimePast
                        : pblock->GetBlockTime();
 
+    // Serve the standing template if nothing feeding the selection changed
+    // since it was assembled: same tip, no mempool adds or removes (we hold
+    // m_mempool.cs, so the update count cannot move under us), same mempool
+    // instance, same weight/feerate options and the same lock-time inputs
+    // (height and lock-time cutoff; a moving median-time-past can make
+    // previously non-final transactions eligible without any mempool churn).
+    // Only the coinbase payout script, the times and the merkle root need
+    // refreshing on a hit.
+    const unsigned int transactions_updated{m_mempool.GetTransactionsUpdated()};
+    {
+        LOCK(m_template_mutex);
+        if (m_cached_template &&
+            m_cached_template_tip == pindexPrev->GetBlockHash() &&
+            m_cached_template_updates == transactions_updated &&
+            m_cached_template_mempool == &m_mempool &&
+            m_cached_template_max_weight == nBlockMaxWeight &&
+            m_cached_template_min_feerate == blockMinFeeRate &&
+            m_cached_template_height == nHeight &&
+            m_cached_template_locktime_cutoff == nLockTimeCutoff) {
+            auto copy = std::make_unique<CBlockTemplate>(*m_cached_template);
+            CBlock* const cached_block = &copy->block;
+            if (cached_block->vtx[0]->vout[0].scriptPubKey != scriptPubKeyIn) {
+                CMutableTransaction coinbaseTx{*cached_block->vtx[0]};
+                coinbaseTx.vout[0].scriptPubKey = scriptPubKeyIn;
+                cached_block->vtx[0] = MakeTransactionRef(std::move(coinbaseTx));
+            }
+            UpdateTime(cached_block, chainparams.GetConsensus(), pindexPrev);
+            cached_block->hashMerkleRoot = BlockMerkleRoot(*cached_block, /* mutated */ nullptr, GetNumCores());
+            return copy;
+        }
+    }
+
     // Decide whether to include witness transactions
     // This is only needed in case the witness softfork activation is reverted
     // (which would require a very deep reorganization).
@@ -175,13 +218,30 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(CChainState& chai
 
     BlockValidationState state;
     assert(std::addressof(::ChainstateActive()) == std::addressof(chainstate));
-    if (!TestBlockValidity(state, chainparams, chainstate, *pblock, pindexPrev, false, false)) {
+    if (!TestBlockValidity(state, chainparams, chainstate, *pblock, pindexPrev, false, false, &m_mempool)) {
         throw std::runtime_error(strprintf("%s: TestBlockValidity failed: %s", __func__, state.ToString()));
     }
     int64_t nTime2 = GetTimeMicros();
 
     LogPrint(BCLog::BENCH, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
 
+    // Refresh the standing template for subsequent calls.
+    {
+        LOCK(m_template_mutex);
+        m_cached_template = std::make_unique<CBlockTemplate>(*pblocktemplate);
+        m_cached_template_tip = pindexPrev->GetBlockHash();
+        m_cached_template_updates = transactions_updated;
+        m_cached_template_mempool = &m_mempool;
+        m_cached_template_max_weight = nBlockMaxWeight;
+        m_cached_template_min_feerate = blockMinFeeRate;
+        m_cached_template_height = nHeight;
+        m_cached_template_locktime_cutoff = nLockTimeCutoff;
+    }
+
+    // Publish the fresh template; pub sockets drop rather than block when a
+    // consumer falls behind, so this is safe to call with locks held.
+    if (m_template_publisher) m_template_publisher(*pblock);
+
     return std::move(pblocktemplate);
 }
 
@@ -317,6 +377,50 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
     // and modifying them for their already included ancestors
     UpdatePackagesForAdded(inBlock, mapModifiedTx);
 
+    // Ancestor sets depend only on mempool topology, which is frozen while we
+    // hold m_mempool.cs - not on the evolving selection state - so they can
+    // be computed in parallel. Precompute them for the top of the
+    // ancestor-score index (more candidates than usually fit a block) on
+    // worker threads and feed the sequential selection below from the
+    // results; candidates past the precomputed window fall back to computing
+    // inline, as before.
+    std::map<CTxMemPool::txiter, CTxMemPool::setEntries, CompareIteratorByHash> precomputed_ancestors;
+    {
+        constexpr size_t PRECOMPUTE_CANDIDATES{2048};
+        const size_t n_workers{static_cast<size_t>(std::max(1, GetNumCores() - 1))};
+        if (n_workers > 1 && m_mempool.size() > 1) {
+            std::vector<CTxMemPool::txiter> candidates;
+            candidates.reserve(PRECOMPUTE_CANDIDATES);
+            for (auto it = m_mempool.mapTx.get<ancestor_score>().begin();
+                 it != m_mempool.mapTx.get<ancestor_score>().end() && candidates.size() < PRECOMPUTE_CANDIDATES; ++it) {
+                candidates.push_back(m_mempool.mapTx.project<0>(it));
+            }
+            using AncestorSets = std::vector<std::pair<CTxMemPool::txiter, CTxMemPool::setEntries>>;
+            std::vector<std::future<AncestorSets>> workers;
+            const size_t per_worker{(candidates.size() + n_workers - 1) / n_workers};
+            for (size_t begin = 0; begin < candidates.size(); begin += per_worker) {
+                const size_t end{std::min(begin + per_worker, candidates.size())};
+                workers.push_back(std::async(std::launch::async, [this, &candidates, begin, end]() NO_THREAD_SAFETY_ANALYSIS {
+                    AncestorSets out;
+                    out.reserve(end - begin);
+                    uint64_t nNoLimit = std::numeric_limits<uint64_t>::max();
+                    std::string dummy;
+                    for (size_t i = begin; i < end; ++i) {
+                        CTxMemPool::setEntries ancestors;
+                        m_mempool.CalculateMemPoolAncestors(*candidates[i], ancestors, nNoLimit, nNoLimit, nNoLimit, nNoLimit, dummy, false);
+                        out.emplace_back(candidates[i], std::move(ancestors));
+                    }
+                    return out;
+                }));
+            }
+            for (auto& worker : workers) {
+                for (auto& entry : worker.get()) {
+                    precomputed_ancestors.emplace(entry.first, std::move(entry.second));
+                }
+            }
+        }
+    }
+
     CTxMemPool::indexed_transaction_set::index<ancestor_score>::type::iterator mi = m_mempool.mapTx.get<ancestor_score>().begin();
     CTxMemPool::txiter iter;
 
@@ -398,9 +502,14 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
         }
 
         CTxMemPool::setEntries ancestors;
-        uint64_t nNoLimit = std::numeric_limits<uint64_t>::max();
-        std::string dummy;
-        m_mempool.CalculateMemPoolAncestors(*iter, ancestors, nNoLimit, nNoLimit, nNoLimit, nNoLimit, dummy, false);
+        if (const auto pre = precomputed_ancestors.find(iter); pre != precomputed_ancestors.end()) {
+            ancestors = std::move(pre->second);
+            precomputed_ancestors.erase(pre);
+        } else {
+            uint64_t nNoLimit = std::numeric_limits<uint64_t>::max();
+            std::string dummy;
+            m_mempool.CalculateMemPoolAncestors(*iter, ancestors, nNoLimit, nNoLimit, nNoLimit, nNoLimit, dummy, false);
+        }
 
         onlyUnconfirmed(ancestors);
         ancestors.insert(iter);
@@ -450,5 +559,41 @@ void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned
     assert(txCoinbase.vin[0].scriptSig.size() <= 100);
 
     pblock->vtx[0] = MakeTransactionRef(std::move(txCoinbase));
-    pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
+    pblock->hashMerkleRoot = BlockMerkleRoot(*pblock, /* mutated */ nullptr, GetNumCores());
+}
+
+void PrevalidateNextBlockTemplate(const CTxMemPool& mempool, const CChainParams& chainparams, CChainState& chainstate)
+{
+    // Nothing worth speculating on until the chain has caught up.
+    if (chainstate.IsInitialBlockDownload()) return;
+
+    // Reassembling the same template is pure waste; only run when the tip or
+    // the mempool has changed since the last call.
+    static uint256 last_tip;
+    static unsigned int last_transactions_updated{0};
+    uint256 tip;
+    {
+        LOCK(cs_main);
+        const CBlockIndex* pindex = chainstate.m_chain.Tip();
+        if (pindex == nullptr) return;
+        tip = pindex->GetBlockHash();
+    }
+    const unsigned int transactions_updated{mempool.GetTransactionsUpdated()};
+    if (tip == last_tip && transactions_updated == last_transactions_updated) return;
+    last_tip = tip;
+    last_transactions_updated = transactions_updated;
+
+    const int64_t nTimeStart = GetTimeMicros();
+    try {
+        // The coinbase payout script is irrelevant: the template is thrown
+        // away, only the cache entries written while test-connecting it
+        // survive.
+        BlockAssembler(mempool, chainparams).CreateNewBlock(chainstate, CScript() << OP_TRUE);
+    } catch (const std::runtime_error& e) {
+        // Not an error condition: the template may simply have raced with a
+        // reorg or a mempool removal.
+        LogPrint(BCLog::BENCH, "PrevalidateNextBlockTemplate failed: %s\n", e.what());
+        return;
+    }
+    LogPrint(BCLog::BENCH, "PrevalidateNextBlockTemplate: %.2fms\n", 0.001 * (GetTimeMicros() - nTimeStart));
 }
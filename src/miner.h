@@ -10,6 +10,8 @@
 #include <txmempool.h>
 #include <validation.h>
 
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <stdint.h>
@@ -24,6 +26,9 @@ class CScript;
 namespace Consensus { struct Params; };
 
 static const bool DEFAULT_PRINTPRIORITY = false;
+static const bool DEFAULT_OPTIMISTIC_CONNECT = false;
+/** How often the speculative next-block template is reassembled, see PrevalidateNextBlockTemplate. */
+static constexpr std::chrono::seconds OPTIMISTIC_CONNECT_INTERVAL{30};
 
 struct CBlockTemplate
 {
@@ -163,7 +168,30 @@ public:
     inline static std::optional<int64_t> m_last_block_num_txs{};
     inline static std::optional<int64_t> m_last_block_weight{};
 
+    /** Invoked with the assembled block whenever a template is built from
+     * scratch (standing-template cache hits are repeats, not changes). Wired
+     * up by init to the ZMQ rawtemplate publisher when one is configured, so
+     * co-located consumers get a binary copy of every new template without
+     * going through JSON-RPC. */
+    inline static std::function<void(const CBlock&)> m_template_publisher{};
+
 private:
+    /** Standing template: the last fully assembled template, shared across
+     * BlockAssembler instances. CreateNewBlock serves a copy of it (with the
+     * coinbase payout, times and merkle root refreshed) whenever the chain
+     * tip, the mempool and the assembly options are unchanged since it was
+     * built - template polls arrive far more often than any of those change,
+     * and a hit costs a copy instead of a full selection pass over the
+     * mempool. */
+    static Mutex m_template_mutex;
+    static std::unique_ptr<CBlockTemplate> m_cached_template GUARDED_BY(m_template_mutex);
+    static uint256 m_cached_template_tip GUARDED_BY(m_template_mutex);
+    static unsigned int m_cached_template_updates GUARDED_BY(m_template_mutex);
+    static const CTxMemPool* m_cached_template_mempool GUARDED_BY(m_template_mutex);
+    static size_t m_cached_template_max_weight GUARDED_BY(m_template_mutex);
+    static CFeeRate m_cached_template_min_feerate GUARDED_BY(m_template_mutex);
+    static int m_cached_template_height GUARDED_BY(m_template_mutex);
+    static int64_t m_cached_template_locktime_cutoff GUARDED_BY(m_template_mutex);
     // utility functions
     /** Clear the block's state and prepare for assembling a new block */
     void resetBlock();
@@ -204,4 +232,13 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
 /** Update an old GenerateCoinbaseCommitment from CreateNewBlock after the block txs have changed */
 void RegenerateCommitments(CBlock& block, BlockManager& blockman);
 
+/** Speculatively assemble the expected next block from the mempool and
+ * test-connect it against a scratch view of the current tip (optimistic
+ * connect). The template itself is discarded; the point is the side effect:
+ * TestBlockValidity runs every input script with result caching enabled, so
+ * when the real block arrives ConnectBlock only has to validate the delta
+ * between it and the speculation. Does nothing if the tip and mempool are
+ * unchanged since the last call, or during initial block download. */
+void PrevalidateNextBlockTemplate(const CTxMemPool& mempool, const CChainParams& chainparams, CChainState& chainstate);
+
 #endif // BITCOIN_MINER_H
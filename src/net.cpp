@@ -35,9 +35,19 @@
 #include <poll.h>
 #endif
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#ifdef USE_KQUEUE
+#include <sys/event.h>
+#endif
+
 #include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <future>
+#include <list>
 #include <optional>
 #include <unordered_map>
 
@@ -52,6 +62,9 @@ const char* const ANCHORS_DATABASE_FILENAME = "anchors.dat";
 // How often to dump addresses to peers.dat
 static constexpr std::chrono::minutes DUMP_PEERS_INTERVAL{15};
 
+/** Interval between appends of pending addrman mutations to peers.journal. */
+static constexpr std::chrono::minutes FLUSH_ADDR_JOURNAL_INTERVAL{1};
+
 /** Number of DNS seeds to query when the number of connections is low. */
 static constexpr int DNSSEEDS_TO_QUERY_AT_ONCE = 3;
 
@@ -74,6 +87,11 @@ static constexpr std::chrono::seconds MAX_UPLOAD_TIMEFRAME{60 * 60 * 24};
 // We add a random period time (0 to 1 seconds) to feeler connections to prevent synchronization.
 #define FEELER_SLEEP_WINDOW 1
 
+// Arguments polled per message or per connection, read through lock-free
+// handles instead of GetArg's map-under-mutex lookup.
+static const CachedArg<bool> g_arg_addrman_test{"-addrmantest", false};
+static const CachedArg<bool> g_arg_capture_messages{"-capturemessages", false};
+
 /** Used to pass flags to the Bind() function */
 enum BindFlags {
     BF_NONE         = 0,
@@ -196,7 +214,7 @@ bool IsPeerAddrLocalGood(CNode *pnode)
 std::optional<CAddress> GetLocalAddrForPeer(CNode *pnode)
 {
     CAddress addrLocal = GetLocalAddress(&pnode->addr, pnode->GetLocalServices());
-    if (gArgs.GetBoolArg("-addrmantest", false)) {
+    if (g_arg_addrman_test.Get()) {
         // use IPv4 loopback during addrmantest
         addrLocal = CAddress(CService(LookupNumeric("127.0.0.1", GetListenPort())), pnode->GetLocalServices());
     }
@@ -209,7 +227,7 @@ std::optional<CAddress> GetLocalAddrForPeer(CNode *pnode)
     {
         addrLocal.SetIP(pnode->GetAddrLocal());
     }
-    if (addrLocal.IsRoutable() || gArgs.GetBoolArg("-addrmantest", false))
+    if (addrLocal.IsRoutable() || g_arg_addrman_test.Get())
     {
         LogPrint(BCLog::NET, "Advertising address %s to peer=%d\n", addrLocal.ToString(), pnode->GetId());
         return addrLocal;
@@ -565,12 +583,7 @@ void CNode::copyStats(CNodeStats &stats, const std::vector<bool> &m_asmap)
     X(addrBind);
     stats.m_network = ConnectedThroughNetwork();
     stats.m_mapped_as = addr.GetMappedAS(m_asmap);
-    if (m_tx_relay != nullptr) {
-        LOCK(m_tx_relay->cs_filter);
-        stats.fRelayTxes = m_tx_relay->fRelayTxes;
-    } else {
-        stats.fRelayTxes = false;
-    }
+    stats.fRelayTxes = m_tx_relay != nullptr && m_tx_relay->fRelayTxes;
     X(nLastSend);
     X(nLastRecv);
     X(nLastTXTime);
@@ -586,16 +599,16 @@ void CNode::copyStats(CNodeStats &stats, const std::vector<bool> &m_asmap)
     stats.fInbound = IsInboundConn();
     X(m_bip152_highbandwidth_to);
     X(m_bip152_highbandwidth_from);
-    {
-        LOCK(cs_vSend);
-        X(mapSendBytesPerMsgCmd);
-        X(nSendBytes);
+    // The byte counters have atomic values and a fixed key set, so no lock
+    // is needed; stats collection must not contend with the data path.
+    for (const auto& [command, bytes] : mapSendBytesPerMsgCmd) {
+        stats.mapSendBytesPerMsgCmd[command] = bytes.load(std::memory_order_relaxed);
     }
-    {
-        LOCK(cs_vRecv);
-        X(mapRecvBytesPerMsgCmd);
-        X(nRecvBytes);
+    X(nSendBytes);
+    for (const auto& [command, bytes] : mapRecvBytesPerMsgCmd) {
+        stats.mapRecvBytesPerMsgCmd[command] = bytes.load(std::memory_order_relaxed);
     }
+    X(nRecvBytes);
     X(m_permissionFlags);
     if (m_tx_relay != nullptr) {
         stats.minFeeFilter = m_tx_relay->minFeeFilter;
@@ -614,11 +627,31 @@ void CNode::copyStats(CNodeStats &stats, const std::vector<bool> &m_asmap)
 }
 #undef X
 
+//! Max number of receive buffers pooled per node. Larger buffers (e.g. from
+//! block messages) are better returned to the allocator than hoarded.
+static constexpr size_t RECV_BUF_POOL_SIZE{2};
+static constexpr size_t RECV_BUF_POOL_MAX_CAPACITY{512 * 1024};
+
+void CNode::ReturnRecvBuffer(CDataStream&& buf)
+{
+    if (buf.capacity() == 0 || buf.capacity() > RECV_BUF_POOL_MAX_CAPACITY) return;
+    buf.clear();
+    LOCK(m_recv_buf_pool_mutex);
+    if (m_recv_buf_pool.size() < RECV_BUF_POOL_SIZE) m_recv_buf_pool.push_back(std::move(buf));
+}
+
 bool CNode::ReceiveMsgBytes(Span<const uint8_t> msg_bytes, bool& complete)
 {
     complete = false;
     const auto time = GetTime<std::chrono::microseconds>();
     LOCK(cs_vRecv);
+    {
+        // Offer a recycled buffer for the next message before absorbing data.
+        LOCK(m_recv_buf_pool_mutex);
+        if (!m_recv_buf_pool.empty() && m_deserializer->RecycleBuffer(std::move(m_recv_buf_pool.back()))) {
+            m_recv_buf_pool.pop_back();
+        }
+    }
     nLastRecv = std::chrono::duration_cast<std::chrono::seconds>(time).count();
     nRecvBytes += msg_bytes.size();
     while (msg_bytes.size() > 0) {
@@ -642,7 +675,7 @@ bool CNode::ReceiveMsgBytes(Span<const uint8_t> msg_bytes, bool& complete)
 
             //store received bytes per message command
             //to prevent a memory DOS, only allow valid commands
-            mapMsgCmdSize::iterator i = mapRecvBytesPerMsgCmd.find(result->m_command);
+            mapMsgCmdSizeAtomic::iterator i = mapRecvBytesPerMsgCmd.find(result->m_command);
             if (i == mapRecvBytesPerMsgCmd.end())
                 i = mapRecvBytesPerMsgCmd.find(NET_MESSAGE_COMMAND_OTHER);
             assert(i != mapRecvBytesPerMsgCmd.end());
@@ -698,6 +731,23 @@ int V1TransportDeserializer::readHeader(Span<const uint8_t> msg_bytes)
     return nCopy;
 }
 
+Span<uint8_t> V1TransportDeserializer::GetReceiveBuffer(size_t max_bytes)
+{
+    // Only the message payload can be received in place; headers go through
+    // the fixed-size hdrbuf.
+    if (!in_data || nDataPos >= hdr.nMessageSize) return {};
+
+    const unsigned int nRemaining = hdr.nMessageSize - nDataPos;
+    const unsigned int nBytes = std::min<size_t>(nRemaining, max_bytes);
+
+    if (vRecv.size() < nDataPos + nBytes) {
+        // Allocate up to 256 KiB ahead, but never more than the total message size.
+        vRecv.resize(std::min(hdr.nMessageSize, nDataPos + nBytes + 256 * 1024));
+    }
+
+    return {reinterpret_cast<uint8_t*>(&vRecv[nDataPos]), nBytes};
+}
+
 int V1TransportDeserializer::readData(Span<const uint8_t> msg_bytes)
 {
     unsigned int nRemaining = hdr.nMessageSize - nDataPos;
@@ -709,7 +759,11 @@ int V1TransportDeserializer::readData(Span<const uint8_t> msg_bytes)
     }
 
     hasher.Write(msg_bytes.first(nCopy));
-    memcpy(&vRecv[nDataPos], msg_bytes.data(), nCopy);
+    if (msg_bytes.data() != reinterpret_cast<const uint8_t*>(&vRecv[nDataPos])) {
+        // Skip the copy when the socket was read directly into vRecv via
+        // GetReceiveBuffer().
+        memcpy(&vRecv[nDataPos], msg_bytes.data(), nCopy);
+    }
     nDataPos += nCopy;
 
     return nCopy;
@@ -778,6 +832,75 @@ size_t CConnman::SocketSendData(CNode& node) const
     auto it = node.vSendMsg.begin();
     size_t nSentSize = 0;
 
+#ifndef WIN32
+    // Gather consecutive queued messages into a single sendmsg() call. This
+    // coalesces each message's separately-queued header and payload, and
+    // batches small messages (invs, pings) that would otherwise cost one
+    // syscall apiece.
+    constexpr size_t MAX_SEND_IOVS{64};
+
+    while (it != node.vSendMsg.end()) {
+        assert(it->size() > node.nSendOffset);
+        iovec iovs[MAX_SEND_IOVS];
+        size_t num_iovs{0};
+        size_t gathered{0};
+        size_t offset = node.nSendOffset;
+        for (auto gather_it = it; gather_it != node.vSendMsg.end() && num_iovs < MAX_SEND_IOVS; ++gather_it) {
+            iovs[num_iovs].iov_base = gather_it->data() + offset;
+            iovs[num_iovs].iov_len = gather_it->size() - offset;
+            gathered += iovs[num_iovs].iov_len;
+            ++num_iovs;
+            offset = 0;
+        }
+        msghdr msg{};
+        msg.msg_iov = iovs;
+        msg.msg_iovlen = num_iovs;
+
+        ssize_t nBytes = 0;
+        {
+            LOCK(node.cs_hSocket);
+            if (node.hSocket == INVALID_SOCKET)
+                break;
+            nBytes = sendmsg(node.hSocket, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        }
+        if (nBytes > 0) {
+            node.nLastSend = GetSystemTimeInSeconds();
+            node.nSendBytes += nBytes;
+            nSentSize += nBytes;
+            // Advance past fully-sent messages; remember the offset into a
+            // partially-sent one.
+            size_t remaining = nBytes;
+            while (it != node.vSendMsg.end() && remaining > 0) {
+                const size_t msg_left = it->size() - node.nSendOffset;
+                if (remaining >= msg_left) {
+                    remaining -= msg_left;
+                    node.nSendOffset = 0;
+                    node.nSendSize -= it->size();
+                    ++it;
+                } else {
+                    node.nSendOffset += remaining;
+                    remaining = 0;
+                }
+            }
+            node.fPauseSend = node.nSendSize > nSendBufferMaxSize;
+            if (static_cast<size_t>(nBytes) < gathered) {
+                // could not send everything that was gathered; stop sending more
+                break;
+            }
+        } else {
+            if (nBytes < 0) {
+                // error
+                int nErr = WSAGetLastError();
+                if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS) {
+                    LogPrint(BCLog::NET, "socket send error for peer=%d: %s\n", node.GetId(), NetworkErrorString(nErr));
+                    node.CloseSocketDisconnect();
+                }
+            }
+            // couldn't send anything at all
+            break;
+        }
+    }
+#else
     while (it != node.vSendMsg.end()) {
         const auto& data = *it;
         assert(data.size() > node.nSendOffset);
@@ -815,6 +938,7 @@ size_t CConnman::SocketSendData(CNode& node) const
             break;
         }
     }
+#endif
 
     if (it == node.vSendMsg.end()) {
         assert(node.nSendOffset == 0);
@@ -977,8 +1101,8 @@ bool CConnman::AttemptToEvictConnection()
             bool peer_relay_txes = false;
             bool peer_filter_not_null = false;
             if (node->m_tx_relay != nullptr) {
-                LOCK(node->m_tx_relay->cs_filter);
                 peer_relay_txes = node->m_tx_relay->fRelayTxes;
+                LOCK(node->m_tx_relay->cs_filter);
                 peer_filter_not_null = node->m_tx_relay->pfilter != nullptr;
             }
             NodeEvictionCandidate candidate = {node->GetId(), node->nTimeConnected, node->m_min_ping_time,
@@ -1230,6 +1354,11 @@ bool CConnman::InactivityCheck(const CNode& node) const
     // use setmocktime in the tests).
     int64_t now = GetSystemTimeInSeconds();
 
+    // Skip the full check until the earliest deadline computed last time
+    // could have passed. The deadlines below only move forward as the peer
+    // sends and receives, so rechecking at the cached time is sufficient.
+    if (now < node.m_next_inactivity_check.load(std::memory_order_relaxed)) return false;
+
     if (node.nLastRecv == 0 || node.nLastSend == 0) {
         LogPrint(BCLog::NET, "socket no message in first %i seconds, %d %d peer=%d\n", m_peer_connect_timeout, node.nLastRecv != 0, node.nLastSend != 0, node.GetId());
         return true;
@@ -1250,6 +1379,9 @@ bool CConnman::InactivityCheck(const CNode& node) const
         return true;
     }
 
+    node.m_next_inactivity_check.store(
+        std::min(node.nLastSend.load(), node.nLastRecv.load()) + TIMEOUT_INTERVAL,
+        std::memory_order_relaxed);
     return false;
 }
 
@@ -1299,7 +1431,167 @@ bool CConnman::GenerateSelectSet(std::set<SOCKET> &recv_set, std::set<SOCKET> &s
     return !recv_set.empty() || !send_set.empty() || !error_set.empty();
 }
 
-#ifdef USE_POLL
+#ifdef USE_EPOLL
+void CConnman::SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
+{
+    std::set<SOCKET> recv_select_set, send_select_set, error_select_set;
+    if (!GenerateSelectSet(recv_select_set, send_select_set, error_select_set)) {
+        interruptNet.sleep_for(std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS));
+        return;
+    }
+
+    if (m_epoll_fd == -1) {
+        m_epoll_fd = epoll_create1(0);
+        if (m_epoll_fd == -1) {
+            LogPrintf("epoll_create1 failed: %s\n", NetworkErrorString(errno));
+            interruptNet.sleep_for(std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS));
+            return;
+        }
+    }
+
+    // Compute the interest each socket should currently have. Sockets we only
+    // want error notifications for are registered with no event bits set;
+    // EPOLLERR and EPOLLHUP are always reported. We use level-triggered mode,
+    // as the socket handler reads bounded chunks per pass and relies on being
+    // re-notified while data remains buffered.
+    std::unordered_map<SOCKET, uint32_t> desired;
+    for (SOCKET hSocket : error_select_set) desired[hSocket] = 0;
+    for (SOCKET hSocket : recv_select_set) desired[hSocket] |= EPOLLIN;
+    for (SOCKET hSocket : send_select_set) desired[hSocket] |= EPOLLOUT;
+
+    // Sync the kernel's interest list with the desired one, issuing epoll_ctl
+    // only for sockets whose interest actually changed since the last pass.
+    for (auto it = m_epoll_registered.begin(); it != m_epoll_registered.end();) {
+        if (desired.count(it->first)) {
+            ++it;
+        } else {
+            epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, it->first, nullptr);
+            it = m_epoll_registered.erase(it);
+        }
+    }
+    for (const auto& [hSocket, events] : desired) {
+        auto registered = m_epoll_registered.find(hSocket);
+        if (registered != m_epoll_registered.end() && registered->second == events) continue;
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = hSocket;
+        int op = registered == m_epoll_registered.end() ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+        if (epoll_ctl(m_epoll_fd, op, hSocket, &ev) != 0) {
+            // Our bookkeeping can disagree with the kernel if a socket was
+            // closed and its fd number reused; retry with the other op.
+            op = op == EPOLL_CTL_ADD ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+            if (epoll_ctl(m_epoll_fd, op, hSocket, &ev) != 0) {
+                LogPrint(BCLog::NET, "epoll_ctl failed for socket %d: %s\n", hSocket, NetworkErrorString(errno));
+                m_epoll_registered.erase(hSocket);
+                continue;
+            }
+        }
+        m_epoll_registered[hSocket] = events;
+    }
+
+    epoll_event events[64];
+    int n = epoll_wait(m_epoll_fd, events, 64, SELECT_TIMEOUT_MILLISECONDS);
+
+    if (interruptNet) return;
+
+    if (n == -1) {
+        if (errno != EINTR) LogPrintf("epoll_wait error %s\n", NetworkErrorString(errno));
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (events[i].events & EPOLLIN) recv_set.insert(events[i].data.fd);
+        if (events[i].events & EPOLLOUT) send_set.insert(events[i].data.fd);
+        if (events[i].events & (EPOLLERR | EPOLLHUP)) error_set.insert(events[i].data.fd);
+    }
+}
+#elif defined(USE_KQUEUE)
+void CConnman::SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
+{
+    std::set<SOCKET> recv_select_set, send_select_set, error_select_set;
+    if (!GenerateSelectSet(recv_select_set, send_select_set, error_select_set)) {
+        interruptNet.sleep_for(std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS));
+        return;
+    }
+
+    if (m_kqueue_fd == -1) {
+        m_kqueue_fd = kqueue();
+        if (m_kqueue_fd == -1) {
+            LogPrintf("kqueue failed: %s\n", NetworkErrorString(errno));
+            interruptNet.sleep_for(std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS));
+            return;
+        }
+    }
+
+    // Compute the <read, write> interest each socket should currently have.
+    // Unlike epoll there is no error-only registration: kqueue reports
+    // disconnects via EV_EOF on the read filter, so sockets we'd otherwise
+    // only watch for errors keep their read filter enabled.
+    std::unordered_map<SOCKET, std::pair<bool, bool>> desired;
+    for (SOCKET hSocket : error_select_set) desired[hSocket] = {true, false};
+    for (SOCKET hSocket : recv_select_set) desired[hSocket].first = true;
+    for (SOCKET hSocket : send_select_set) desired[hSocket].second = true;
+
+    // Sync the kernel's interest list with the desired one, issuing kevent
+    // changes only for sockets whose interest actually changed.
+    std::vector<struct kevent> changes;
+    for (auto it = m_kqueue_registered.begin(); it != m_kqueue_registered.end();) {
+        if (desired.count(it->first)) {
+            ++it;
+        } else {
+            struct kevent change;
+            if (it->second.first) {
+                EV_SET(&change, it->first, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+                changes.push_back(change);
+            }
+            if (it->second.second) {
+                EV_SET(&change, it->first, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+                changes.push_back(change);
+            }
+            it = m_kqueue_registered.erase(it);
+        }
+    }
+    for (const auto& [hSocket, interest] : desired) {
+        const auto registered = m_kqueue_registered.find(hSocket);
+        const std::pair<bool, bool> prev = registered == m_kqueue_registered.end() ?
+            std::pair<bool, bool>{false, false} : registered->second;
+        if (interest.first != prev.first) {
+            struct kevent change;
+            EV_SET(&change, hSocket, EVFILT_READ, interest.first ? EV_ADD : EV_DELETE, 0, 0, nullptr);
+            changes.push_back(change);
+        }
+        if (interest.second != prev.second) {
+            struct kevent change;
+            EV_SET(&change, hSocket, EVFILT_WRITE, interest.second ? EV_ADD : EV_DELETE, 0, 0, nullptr);
+            changes.push_back(change);
+        }
+        m_kqueue_registered[hSocket] = interest;
+    }
+
+    struct kevent events[64];
+    struct timespec timeout;
+    timeout.tv_sec = SELECT_TIMEOUT_MILLISECONDS / 1000;
+    timeout.tv_nsec = (SELECT_TIMEOUT_MILLISECONDS % 1000) * 1000000;
+    int n = kevent(m_kqueue_fd, changes.data(), changes.size(), events, 64, &timeout);
+
+    if (interruptNet) return;
+
+    if (n == -1) {
+        if (errno != EINTR) LogPrintf("kevent error %s\n", NetworkErrorString(errno));
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (events[i].flags & EV_ERROR) {
+            error_set.insert(events[i].ident);
+            continue;
+        }
+        if (events[i].filter == EVFILT_READ) recv_set.insert(events[i].ident);
+        if (events[i].filter == EVFILT_WRITE) send_set.insert(events[i].ident);
+        if (events[i].flags & EV_EOF) error_set.insert(events[i].ident);
+    }
+}
+#elif defined(USE_POLL)
 void CConnman::SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
 {
     std::set<SOCKET> recv_select_set, send_select_set, error_select_set;
@@ -1468,17 +1760,22 @@ void CConnman::SocketHandler()
         {
             // typical socket buffer is 8K-64K
             uint8_t pchBuf[0x10000];
+            // Receive mid-message payload bytes directly into the message's
+            // own buffer where possible, avoiding the staging-buffer copy.
+            Span<uint8_t> direct_buf = pnode->m_deserializer->GetReceiveBuffer(sizeof(pchBuf));
+            uint8_t* recv_buf = direct_buf.empty() ? pchBuf : direct_buf.data();
+            const size_t recv_buf_size = direct_buf.empty() ? sizeof(pchBuf) : direct_buf.size();
             int nBytes = 0;
             {
                 LOCK(pnode->cs_hSocket);
                 if (pnode->hSocket == INVALID_SOCKET)
                     continue;
-                nBytes = recv(pnode->hSocket, (char*)pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
+                nBytes = recv(pnode->hSocket, (char*)recv_buf, recv_buf_size, MSG_DONTWAIT);
             }
             if (nBytes > 0)
             {
                 bool notify = false;
-                if (!pnode->ReceiveMsgBytes(Span<const uint8_t>(pchBuf, nBytes), notify))
+                if (!pnode->ReceiveMsgBytes(Span<const uint8_t>(recv_buf, nBytes), notify))
                     pnode->CloseSocketDisconnect();
                 RecordBytesRecv(nBytes);
                 if (notify) {
@@ -1551,7 +1848,7 @@ void CConnman::WakeMessageHandler()
         LOCK(mutexMsgProc);
         fMsgProcWake = true;
     }
-    condMsgProc.notify_one();
+    condMsgProc.notify_all();
 }
 
 void CConnman::ThreadDNSAddressSeed()
@@ -1586,8 +1883,61 @@ void CConnman::ThreadDNSAddressSeed()
     //   (done in ThreadOpenConnections)
     const std::chrono::seconds seeds_wait_time = (addrman.size() >= DNSSEEDS_DELAY_PEER_THRESHOLD ? DNSSEEDS_DELAY_MANY_PEERS : DNSSEEDS_DELAY_FEW_PEERS);
 
+    // Seed lookups resolving in the background, so the seeds in a batch are
+    // queried concurrently and a slow resolver doesn't serialize them.
+    struct PendingSeed {
+        std::string seed;
+        CNetAddr resolve_source;
+        ServiceFlags required_service_bits;
+        std::future<std::vector<CNetAddr>> ips;
+    };
+    std::list<PendingSeed> pending_seeds;
+
+    auto process_resolved = [&](PendingSeed& pending) {
+        const std::vector<CNetAddr> vIPs{pending.ips.get()};
+        if (!vIPs.empty()) {
+            std::vector<CAddress> vAdd;
+            for (const CNetAddr& ip : vIPs) {
+                int nOneDay = 24*3600;
+                CAddress addr = CAddress(CService(ip, Params().GetDefaultPort()), pending.required_service_bits);
+                addr.nTime = GetTime() - 3*nOneDay - rng.randrange(4*nOneDay); // use a random age between 3 and 7 days old
+                vAdd.push_back(addr);
+                found++;
+            }
+            addrman.Add(vAdd, pending.resolve_source);
+        } else {
+            // We now avoid directly using results from DNS Seeds which do not support service bit filtering,
+            // instead using them as a addrfetch to get nodes with our desired service bits.
+            AddAddrFetch(pending.seed);
+        }
+    };
+
+    // Collect finished lookups; when wait_for_all is set, block (remaining
+    // interruptible) until every outstanding lookup has been processed.
+    // Returns false if interrupted.
+    auto drain_pending = [&](bool wait_for_all) -> bool {
+        for (auto it = pending_seeds.begin(); it != pending_seeds.end();) {
+            std::future_status status;
+            do {
+                status = it->ips.wait_for(std::chrono::milliseconds{wait_for_all ? 100 : 0});
+                if (status != std::future_status::ready && interruptNet) return false;
+            } while (wait_for_all && status != std::future_status::ready);
+            if (status == std::future_status::ready) {
+                process_resolved(*it);
+                it = pending_seeds.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return true;
+    };
+
     for (const std::string& seed : seeds) {
         if (seeds_right_now == 0) {
+            // Collect the previous batch's results before deciding whether
+            // more seeds are needed.
+            if (!drain_pending(/* wait_for_all */ true)) return;
+
             seeds_right_now += DNSSEEDS_TO_QUERY_AT_ONCE;
 
             if (addrman.size() > 0) {
@@ -1635,8 +1985,6 @@ void CConnman::ThreadDNSAddressSeed()
         if (HaveNameProxy()) {
             AddAddrFetch(seed);
         } else {
-            std::vector<CNetAddr> vIPs;
-            std::vector<CAddress> vAdd;
             ServiceFlags requiredServiceBits = GetDesirableServiceFlags(NODE_NONE);
             std::string host = strprintf("x%x.%s", requiredServiceBits, seed);
             CNetAddr resolveSource;
@@ -1644,23 +1992,13 @@ void CConnman::ThreadDNSAddressSeed()
                 continue;
             }
             unsigned int nMaxIPs = 256; // Limits number of IPs learned from a DNS seed
-            if (LookupHost(host, vIPs, nMaxIPs, true)) {
-                for (const CNetAddr& ip : vIPs) {
-                    int nOneDay = 24*3600;
-                    CAddress addr = CAddress(CService(ip, Params().GetDefaultPort()), requiredServiceBits);
-                    addr.nTime = GetTime() - 3*nOneDay - rng.randrange(4*nOneDay); // use a random age between 3 and 7 days old
-                    vAdd.push_back(addr);
-                    found++;
-                }
-                addrman.Add(vAdd, resolveSource);
-            } else {
-                // We now avoid directly using results from DNS Seeds which do not support service bit filtering,
-                // instead using them as a addrfetch to get nodes with our desired service bits.
-                AddAddrFetch(seed);
-            }
+            pending_seeds.push_back({seed, resolveSource, requiredServiceBits, LookupHostAsync(host, nMaxIPs, true)});
+            // Harvest whatever has already resolved without blocking.
+            if (!drain_pending(/* wait_for_all */ false)) return;
         }
         --seeds_right_now;
     }
+    if (!drain_pending(/* wait_for_all */ true)) return;
     LogPrintf("%d addresses found from DNS seeds\n", found);
 }
 
@@ -1668,6 +2006,13 @@ void CConnman::DumpAddresses()
 {
     int64_t nStart = GetTimeMillis();
 
+    // The full snapshot below captures all pending journaled mutations, so
+    // drop them; Write() removes the now-superseded journal file. Mutations
+    // applied while the snapshot is being written stay journaled and are at
+    // worst replayed redundantly.
+    bool overflowed;
+    addrman.TakeDeltas(overflowed);
+
     CAddrDB adb;
     adb.Write(addrman);
 
@@ -1675,6 +2020,25 @@ void CConnman::DumpAddresses()
            addrman.size(), GetTimeMillis() - nStart);
 }
 
+void CConnman::FlushAddressJournal()
+{
+    bool overflowed;
+    std::vector<AddrManDelta> deltas = addrman.TakeDeltas(overflowed);
+    if (overflowed) {
+        // Deltas were dropped, so the journal cannot represent all changes;
+        // compact with a full write instead.
+        DumpAddresses();
+        return;
+    }
+    if (deltas.empty()) return;
+
+    int64_t nStart = GetTimeMillis();
+    CAddrDB adb;
+    adb.AppendJournal(deltas);
+    LogPrint(BCLog::NET, "Appended %d entries to peers.journal  %dms\n",
+           deltas.size(), GetTimeMillis() - nStart);
+}
+
 void CConnman::ProcessAddrFetch()
 {
     std::string strDest;
@@ -1737,6 +2101,9 @@ int CConnman::GetExtraBlockRelayCount()
     return std::max(block_relay_peers - m_max_outbound_block_relay, 0);
 }
 
+/** Maximum number of automatic outbound connection attempts in flight at once. */
+static constexpr size_t MAX_PARALLEL_OUTBOUND_ATTEMPTS{4};
+
 void CConnman::ThreadOpenConnections(const std::vector<std::string> connect)
 {
     // Connect to specific addresses
@@ -1780,6 +2147,13 @@ void CConnman::ThreadOpenConnections(const std::vector<std::string> connect)
         if (!interruptNet.sleep_for(std::chrono::milliseconds(500)))
             return;
 
+        // Reap finished async connection attempts, and don't start more than
+        // the budget allows; slots free up as soon as a connect completes.
+        m_outbound_attempts.remove_if([](std::future<void>& f) {
+            return f.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+        });
+        if (m_outbound_attempts.size() >= MAX_PARALLEL_OUTBOUND_ATTEMPTS) continue;
+
         CSemaphoreGrant grant(*semOutbound);
         if (interruptNet)
             return;
@@ -1819,8 +2193,9 @@ void CConnman::ThreadOpenConnections(const std::vector<std::string> connect)
         CAddress addrConnect;
 
         // Only connect out to one peer per network group (/16 for IPv4).
-        int nOutboundFullRelay = 0;
-        int nOutboundBlockRelay = 0;
+        // Attempts still in flight already count toward the targets.
+        int nOutboundFullRelay = m_inflight_full_relay.load();
+        int nOutboundBlockRelay = m_inflight_block_relay.load();
         std::set<std::vector<unsigned char> > setConnected;
 
         {
@@ -1994,16 +2369,25 @@ void CConnman::ThreadOpenConnections(const std::vector<std::string> connect)
         }
 
         if (addrConnect.IsValid()) {
-
-            if (fFeeler) {
-                // Add small amount of random noise before connection to avoid synchronization.
-                int randsleep = GetRandInt(FEELER_SLEEP_WINDOW * 1000);
-                if (!interruptNet.sleep_for(std::chrono::milliseconds(randsleep)))
-                    return;
-                LogPrint(BCLog::NET, "Making feeler connection to %s\n", addrConnect.ToString());
-            }
-
-            OpenNetworkConnection(addrConnect, (int)setConnected.size() >= std::min(nMaxConnections - 1, 2), &grant, nullptr, conn_type);
+            if (conn_type == ConnectionType::OUTBOUND_FULL_RELAY) ++m_inflight_full_relay;
+            if (conn_type == ConnectionType::BLOCK_RELAY) ++m_inflight_block_relay;
+
+            const bool count_failure = (int)setConnected.size() >= std::min(nMaxConnections - 1, 2);
+            // Hand the semaphore grant to the attempt; it moves into the node
+            // on success and is released when the attempt finishes otherwise.
+            auto attempt_grant = std::make_shared<CSemaphoreGrant>();
+            grant.MoveTo(*attempt_grant);
+            m_outbound_attempts.push_back(std::async(std::launch::async, [this, addrConnect, count_failure, attempt_grant, conn_type, fFeeler] {
+                if (fFeeler) {
+                    // Add small amount of random noise before connection to avoid synchronization.
+                    int randsleep = GetRandInt(FEELER_SLEEP_WINDOW * 1000);
+                    if (!interruptNet.sleep_for(std::chrono::milliseconds(randsleep))) return;
+                    LogPrint(BCLog::NET, "Making feeler connection to %s\n", addrConnect.ToString());
+                }
+                OpenNetworkConnection(addrConnect, count_failure, attempt_grant.get(), nullptr, conn_type);
+                if (conn_type == ConnectionType::OUTBOUND_FULL_RELAY) --m_inflight_full_relay;
+                if (conn_type == ConnectionType::BLOCK_RELAY) --m_inflight_block_relay;
+            }));
         }
     }
 }
@@ -2158,17 +2542,27 @@ void CConnman::ThreadMessageHandler()
             if (pnode->fDisconnect)
                 continue;
 
+            // Claim the peer so that only one handler thread processes it at
+            // a time; a peer's messages stay in order because they are all
+            // handled by whichever thread holds the claim.
+            if (pnode->m_msg_handler_claimed.exchange(true))
+                continue;
+
             // Receive messages
             bool fMoreNodeWork = m_msgproc->ProcessMessages(pnode, flagInterruptMsgProc);
             fMoreWork |= (fMoreNodeWork && !pnode->fPauseSend);
-            if (flagInterruptMsgProc)
+            if (flagInterruptMsgProc) {
+                pnode->m_msg_handler_claimed = false;
                 return;
+            }
             // Send messages
             {
                 LOCK(pnode->cs_sendProcessing);
                 m_msgproc->SendMessages(pnode);
             }
 
+            pnode->m_msg_handler_claimed = false;
+
             if (flagInterruptMsgProc)
                 return;
         }
@@ -2442,9 +2836,11 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
     int64_t nStart = GetTimeMillis();
     {
         CAddrDB adb;
-        if (adb.Read(addrman))
+        if (adb.Read(addrman)) {
+            // Apply any mutations journaled since the snapshot was written.
+            adb.ReadJournal(addrman);
             LogPrintf("Loaded %i addresses from peers.dat  %dms\n", addrman.size(), GetTimeMillis() - nStart);
-        else {
+        } else {
             addrman.Clear(); // Addrman can be in an inconsistent state after failure, reset it
             LogPrintf("Recreating peers.dat\n");
             DumpAddresses();
@@ -2508,8 +2904,12 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
     if (connOptions.m_use_addrman_outgoing || !connOptions.m_specified_outgoing.empty())
         threadOpenConnections = std::thread(&TraceThread<std::function<void()> >, "opencon", std::function<void()>(std::bind(&CConnman::ThreadOpenConnections, this, connOptions.m_specified_outgoing)));
 
-    // Process messages
-    threadMessageHandler = std::thread(&TraceThread<std::function<void()> >, "msghand", std::function<void()>(std::bind(&CConnman::ThreadMessageHandler, this)));
+    // Process messages. Several handler threads may run; each claims one peer
+    // at a time, so different peers are processed concurrently while any
+    // single peer's messages are handled in order.
+    for (int i = 0; i < m_msgproc_threads; i++) {
+        m_msghandler_threads.emplace_back(&TraceThread<std::function<void()> >, "msghand", std::function<void()>(std::bind(&CConnman::ThreadMessageHandler, this)));
+    }
 
     if (connOptions.m_i2p_accept_incoming && m_i2p_sam_session.get() != nullptr) {
         threadI2PAcceptIncoming =
@@ -2520,6 +2920,9 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
     // Dump network addresses
     scheduler.scheduleEvery([this] { DumpAddresses(); }, DUMP_PEERS_INTERVAL);
 
+    // Persist addrman changes incrementally between full dumps
+    scheduler.scheduleEvery([this] { FlushAddressJournal(); }, FLUSH_ADDR_JOURNAL_INTERVAL);
+
     return true;
 }
 
@@ -2567,8 +2970,10 @@ void CConnman::StopThreads()
     if (threadI2PAcceptIncoming.joinable()) {
         threadI2PAcceptIncoming.join();
     }
-    if (threadMessageHandler.joinable())
-        threadMessageHandler.join();
+    for (std::thread& handler_thread : m_msghandler_threads) {
+        if (handler_thread.joinable()) handler_thread.join();
+    }
+    m_msghandler_threads.clear();
     if (threadOpenConnections.joinable())
         threadOpenConnections.join();
     if (threadOpenAddedConnections.joinable())
@@ -2581,6 +2986,11 @@ void CConnman::StopThreads()
 
 void CConnman::StopNodes()
 {
+    // Wait for any in-flight outbound connection attempts; interruptNet is
+    // already set, so they abort quickly. This must happen before nodes are
+    // deleted, as an attempt may still add one to vNodes.
+    m_outbound_attempts.clear();
+
     if (fAddressesInitialized) {
         DumpAddresses();
         fAddressesInitialized = false;
@@ -2633,6 +3043,11 @@ CConnman::~CConnman()
 {
     Interrupt();
     Stop();
+#ifdef USE_EPOLL
+    if (m_epoll_fd != -1) close(m_epoll_fd);
+#elif defined(USE_KQUEUE)
+    if (m_kqueue_fd != -1) close(m_kqueue_fd);
+#endif
 }
 
 void CConnman::SetServices(const CService &addr, ServiceFlags nServices)
@@ -2742,13 +3157,46 @@ size_t CConnman::GetNodeCount(ConnectionDirection flags)
 }
 
 void CConnman::GetNodeStats(std::vector<CNodeStats>& vstats)
+{
+    std::vector<NodeId> disconnected_dummy;
+    GetNodeStats(vstats, /* known */ {}, disconnected_dummy);
+}
+
+void CConnman::GetNodeStats(std::vector<CNodeStats>& vstats, const std::map<NodeId, uint64_t>& known, std::vector<NodeId>& disconnected)
 {
     vstats.clear();
-    LOCK(cs_vNodes);
-    vstats.reserve(vNodes.size());
-    for (CNode* pnode : vNodes) {
-        vstats.emplace_back();
-        pnode->copyStats(vstats.back(), addrman.m_asmap);
+    disconnected.clear();
+    // Snapshot the node list so stats collection does not hold cs_vNodes
+    // while copying per-peer data.
+    std::vector<CNode*> vNodesCopy;
+    {
+        LOCK(cs_vNodes);
+        vNodesCopy = vNodes;
+        for (CNode* pnode : vNodesCopy) {
+            pnode->AddRef();
+        }
+    }
+    std::vector<NodeId> connected_ids;
+    connected_ids.reserve(vNodesCopy.size());
+    vstats.reserve(vNodesCopy.size());
+    for (CNode* pnode : vNodesCopy) {
+        connected_ids.push_back(pnode->GetId());
+        const uint64_t traffic{pnode->nSendBytes.load(std::memory_order_relaxed) +
+                               pnode->nRecvBytes.load(std::memory_order_relaxed)};
+        const auto it = known.find(pnode->GetId());
+        if (it == known.end() || it->second != traffic) {
+            vstats.emplace_back();
+            pnode->copyStats(vstats.back(), addrman.m_asmap);
+        }
+        pnode->Release();
+    }
+    if (!known.empty()) {
+        std::sort(connected_ids.begin(), connected_ids.end());
+        for (const auto& entry : known) {
+            if (!std::binary_search(connected_ids.begin(), connected_ids.end(), entry.first)) {
+                disconnected.push_back(entry.first);
+            }
+        }
     }
 }
 
@@ -2797,31 +3245,33 @@ bool CConnman::DisconnectNode(NodeId id)
 
 void CConnman::RecordBytesRecv(uint64_t bytes)
 {
-    LOCK(cs_totalBytesRecv);
-    nTotalBytesRecv += bytes;
+    nTotalBytesRecv.fetch_add(bytes, std::memory_order_relaxed);
 }
 
 void CConnman::RecordBytesSent(uint64_t bytes)
 {
-    LOCK(cs_totalBytesSent);
-    nTotalBytesSent += bytes;
+    nTotalBytesSent.fetch_add(bytes, std::memory_order_relaxed);
 
     const auto now = GetTime<std::chrono::seconds>();
-    if (nMaxOutboundCycleStartTime + MAX_UPLOAD_TIMEFRAME < now)
-    {
-        // timeframe expired, reset cycle
-        nMaxOutboundCycleStartTime = now;
-        nMaxOutboundTotalBytesSentInCycle = 0;
+    if (m_max_outbound_cycle_start.load(std::memory_order_relaxed) + MAX_UPLOAD_TIMEFRAME.count() < now.count()) {
+        // Timeframe expired: reset the cycle. Only one thread performs the
+        // reset; a concurrent sender racing the rollover may have its bytes
+        // attributed to either side of the boundary, which is acceptable for
+        // rate limiting purposes.
+        LOCK(m_outbound_cycle_mutex);
+        if (m_max_outbound_cycle_start.load(std::memory_order_relaxed) + MAX_UPLOAD_TIMEFRAME.count() < now.count()) {
+            m_max_outbound_cycle_start.store(now.count(), std::memory_order_relaxed);
+            nMaxOutboundTotalBytesSentInCycle.store(0, std::memory_order_relaxed);
+        }
     }
 
     // TODO, exclude peers with download permission
-    nMaxOutboundTotalBytesSentInCycle += bytes;
+    nMaxOutboundTotalBytesSentInCycle.fetch_add(bytes, std::memory_order_relaxed);
 }
 
 uint64_t CConnman::GetMaxOutboundTarget()
 {
-    LOCK(cs_totalBytesSent);
-    return nMaxOutboundLimit;
+    return nMaxOutboundLimit.load(std::memory_order_relaxed);
 }
 
 std::chrono::seconds CConnman::GetMaxOutboundTimeframe()
@@ -2831,33 +3281,34 @@ std::chrono::seconds CConnman::GetMaxOutboundTimeframe()
 
 std::chrono::seconds CConnman::GetMaxOutboundTimeLeftInCycle()
 {
-    LOCK(cs_totalBytesSent);
-    if (nMaxOutboundLimit == 0)
+    if (nMaxOutboundLimit.load(std::memory_order_relaxed) == 0)
         return 0s;
 
-    if (nMaxOutboundCycleStartTime.count() == 0)
+    const std::chrono::seconds cycle_start{m_max_outbound_cycle_start.load(std::memory_order_relaxed)};
+    if (cycle_start.count() == 0)
         return MAX_UPLOAD_TIMEFRAME;
 
-    const std::chrono::seconds cycleEndTime = nMaxOutboundCycleStartTime + MAX_UPLOAD_TIMEFRAME;
+    const std::chrono::seconds cycleEndTime = cycle_start + MAX_UPLOAD_TIMEFRAME;
     const auto now = GetTime<std::chrono::seconds>();
     return (cycleEndTime < now) ? 0s : cycleEndTime - now;
 }
 
 bool CConnman::OutboundTargetReached(bool historicalBlockServingLimit)
 {
-    LOCK(cs_totalBytesSent);
-    if (nMaxOutboundLimit == 0)
+    const uint64_t limit = nMaxOutboundLimit.load(std::memory_order_relaxed);
+    if (limit == 0)
         return false;
 
+    const uint64_t sent_in_cycle = nMaxOutboundTotalBytesSentInCycle.load(std::memory_order_relaxed);
     if (historicalBlockServingLimit)
     {
         // keep a large enough buffer to at least relay each block once
         const std::chrono::seconds timeLeftInCycle = GetMaxOutboundTimeLeftInCycle();
         const uint64_t buffer = timeLeftInCycle / std::chrono::minutes{10} * MAX_BLOCK_SERIALIZED_SIZE;
-        if (buffer >= nMaxOutboundLimit || nMaxOutboundTotalBytesSentInCycle >= nMaxOutboundLimit - buffer)
+        if (buffer >= limit || sent_in_cycle >= limit - buffer)
             return true;
     }
-    else if (nMaxOutboundTotalBytesSentInCycle >= nMaxOutboundLimit)
+    else if (sent_in_cycle >= limit)
         return true;
 
     return false;
@@ -2865,23 +3316,22 @@ bool CConnman::OutboundTargetReached(bool historicalBlockServingLimit)
 
 uint64_t CConnman::GetOutboundTargetBytesLeft()
 {
-    LOCK(cs_totalBytesSent);
-    if (nMaxOutboundLimit == 0)
+    const uint64_t limit = nMaxOutboundLimit.load(std::memory_order_relaxed);
+    if (limit == 0)
         return 0;
 
-    return (nMaxOutboundTotalBytesSentInCycle >= nMaxOutboundLimit) ? 0 : nMaxOutboundLimit - nMaxOutboundTotalBytesSentInCycle;
+    const uint64_t sent_in_cycle = nMaxOutboundTotalBytesSentInCycle.load(std::memory_order_relaxed);
+    return (sent_in_cycle >= limit) ? 0 : limit - sent_in_cycle;
 }
 
 uint64_t CConnman::GetTotalBytesRecv()
 {
-    LOCK(cs_totalBytesRecv);
-    return nTotalBytesRecv;
+    return nTotalBytesRecv.load(std::memory_order_relaxed);
 }
 
 uint64_t CConnman::GetTotalBytesSent()
 {
-    LOCK(cs_totalBytesSent);
-    return nTotalBytesSent;
+    return nTotalBytesSent.load(std::memory_order_relaxed);
 }
 
 ServiceFlags CConnman::GetLocalServices() const
@@ -2910,12 +3360,16 @@ CNode::CNode(NodeId idIn, ServiceFlags nLocalServicesIn, SOCKET hSocketIn, const
     }
 
     if (RelayAddrsWithConn()) {
+        LOCK(m_addr_send_mutex);
         m_addr_known = std::make_unique<CRollingBloomFilter>(5000, 0.001);
     }
 
-    for (const std::string &msg : getAllNetMessageTypes())
+    for (const std::string &msg : getAllNetMessageTypes()) {
         mapRecvBytesPerMsgCmd[msg] = 0;
+        mapSendBytesPerMsgCmd[msg] = 0;
+    }
     mapRecvBytesPerMsgCmd[NET_MESSAGE_COMMAND_OTHER] = 0;
+    mapSendBytesPerMsgCmd[NET_MESSAGE_COMMAND_OTHER] = 0;
 
     if (fLogIPs) {
         LogPrint(BCLog::NET, "Added connection to %s peer=%d\n", addrName, id);
@@ -2941,7 +3395,7 @@ void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
 {
     size_t nMessageSize = msg.data.size();
     LogPrint(BCLog::NET, "sending %s (%d bytes) peer=%d\n",  SanitizeString(msg.m_type), nMessageSize, pnode->GetId());
-    if (gArgs.GetBoolArg("-capturemessages", false)) {
+    if (g_arg_capture_messages.Get()) {
         CaptureMessage(pnode->addr, msg.m_type, msg.data, /* incoming */ false);
     }
 
@@ -2956,7 +3410,11 @@ void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
         bool optimisticSend(pnode->vSendMsg.empty());
 
         //log total amount of bytes per message type
-        pnode->mapSendBytesPerMsgCmd[msg.m_type] += nTotalSize;
+        // Only commands prepopulated at construction may be counted, so that
+        // lock-free readers never race a map insertion.
+        auto size_it = pnode->mapSendBytesPerMsgCmd.find(msg.m_type);
+        if (size_it == pnode->mapSendBytesPerMsgCmd.end()) size_it = pnode->mapSendBytesPerMsgCmd.find(NET_MESSAGE_COMMAND_OTHER);
+        size_it->second += nTotalSize;
         pnode->nSendSize += nTotalSize;
 
         if (pnode->nSendSize > nSendBufferMaxSize) pnode->fPauseSend = true;
@@ -2995,7 +3453,7 @@ std::chrono::microseconds CConnman::PoissonNextSendInbound(std::chrono::microsec
 
 std::chrono::microseconds PoissonNextSend(std::chrono::microseconds now, std::chrono::seconds average_interval)
 {
-    double unscaled = -log1p(GetRand(1ULL << 48) * -0.0000000000000035527136788 /* -1/2^48 */);
+    double unscaled = -log1p(ThreadLocalRng().randbits(48) * -0.0000000000000035527136788 /* -1/2^48 */);
     return now + std::chrono::duration_cast<std::chrono::microseconds>(unscaled * average_interval + 0.5us);
 }
 
@@ -32,10 +32,14 @@
 #include <condition_variable>
 #include <cstdint>
 #include <deque>
+#include <future>
+#include <list>
 #include <map>
 #include <memory>
 #include <optional>
 #include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 class CScheduler;
@@ -78,6 +82,8 @@ static constexpr uint64_t DEFAULT_MAX_UPLOAD_TARGET = 0;
 static const bool DEFAULT_BLOCKSONLY = false;
 /** -peertimeout default */
 static const int64_t DEFAULT_PEER_CONNECT_TIMEOUT = 60;
+/** -msghandlerthreads default */
+static const int DEFAULT_MSGHANDLER_THREADS = 2;
 /** Number of file descriptors required for message capture **/
 static const int NUM_FDS_MESSAGE_CAPTURE = 1;
 
@@ -237,6 +243,10 @@ extern std::map<CNetAddr, LocalServiceInfo> mapLocalHost GUARDED_BY(cs_mapLocalH
 
 extern const std::string NET_MESSAGE_COMMAND_OTHER;
 typedef std::map<std::string, uint64_t> mapMsgCmdSize; //command, total bytes
+//! Per-command byte counters with atomic values. The key set is fixed at
+//! CNode construction, so readers may iterate without a lock while the
+//! owning threads bump the counters.
+typedef std::map<std::string, std::atomic<uint64_t>> mapMsgCmdSizeAtomic;
 
 class CNodeStats
 {
@@ -308,6 +318,17 @@ public:
     virtual bool Complete() const = 0;
     // set the serialization context version
     virtual void SetVersion(int version) = 0;
+    /** Writable view into the in-progress message's own buffer, so the socket
+     * can be read directly into it instead of through a staging buffer. May
+     * return an empty span (e.g. while a header is being parsed), in which
+     * case the caller must fall back to its own buffer. Bytes received this
+     * way must still be passed to Read() for accounting and hashing; Read()
+     * detects in-place data and skips the copy. */
+    virtual Span<uint8_t> GetReceiveBuffer(size_t max_bytes) { return {}; }
+    /** Offer an empty buffer (retaining its capacity) to be used for the next
+     * message instead of allocating a fresh one. Returns true if the
+     * deserializer took ownership of the buffer. */
+    virtual bool RecycleBuffer(CDataStream&& buf) { return false; }
     /** read and deserialize data, advances msg_bytes data pointer */
     virtual int Read(Span<const uint8_t>& msg_bytes) = 0;
     // decomposes a message from the context
@@ -365,6 +386,20 @@ public:
         hdrbuf.SetVersion(nVersionIn);
         vRecv.SetVersion(nVersionIn);
     }
+    Span<uint8_t> GetReceiveBuffer(size_t max_bytes) override;
+    bool RecycleBuffer(CDataStream&& buf) override
+    {
+        // Only take the buffer while no message payload is in progress and it
+        // actually improves on what we have.
+        if (in_data || vRecv.capacity() >= buf.capacity()) return false;
+        const int type = vRecv.GetType();
+        const int version = vRecv.GetVersion();
+        buf.clear();
+        vRecv = std::move(buf);
+        vRecv.SetType(type);
+        vRecv.SetVersion(version);
+        return true;
+    }
     int Read(Span<const uint8_t>& msg_bytes) override
     {
         int ret = in_data ? readData(msg_bytes) : readHeader(msg_bytes);
@@ -409,7 +444,7 @@ public:
     size_t nSendSize GUARDED_BY(cs_vSend){0};
     /** Offset inside the first vSendMsg already sent */
     size_t nSendOffset GUARDED_BY(cs_vSend){0};
-    uint64_t nSendBytes GUARDED_BY(cs_vSend){0};
+    std::atomic<uint64_t> nSendBytes{0};
     std::deque<std::vector<unsigned char>> vSendMsg GUARDED_BY(cs_vSend);
     Mutex cs_vSend;
     Mutex cs_hSocket;
@@ -417,14 +452,27 @@ public:
 
     RecursiveMutex cs_vProcessMsg;
     std::list<CNetMessage> vProcessMsg GUARDED_BY(cs_vProcessMsg);
+
+    //! Small pool of receive buffers recycled from fully processed messages,
+    //! so steady-state message receipt does not allocate. Filled by the
+    //! message processing threads, drained by the socket thread.
+    Mutex m_recv_buf_pool_mutex;
+    std::vector<CDataStream> m_recv_buf_pool GUARDED_BY(m_recv_buf_pool_mutex);
+
+    //! Return a processed message's buffer to the receive-buffer pool.
+    void ReturnRecvBuffer(CDataStream&& buf);
     size_t nProcessQueueSize{0};
 
     RecursiveMutex cs_sendProcessing;
 
-    uint64_t nRecvBytes GUARDED_BY(cs_vRecv){0};
+    std::atomic<uint64_t> nRecvBytes{0};
 
     std::atomic<int64_t> nLastSend{0};
     std::atomic<int64_t> nLastRecv{0};
+    //! Earliest (non-mockable system) time at which InactivityCheck() could
+    //! next fire for this peer; the socket thread skips the full check until
+    //! then. Mutable because the check itself is const. 0 forces a check.
+    mutable std::atomic<int64_t> m_next_inactivity_check{0};
     const int64_t nTimeConnected;
     std::atomic<int64_t> nTimeOffset{0};
     // Address of this peer
@@ -463,6 +511,10 @@ public:
     const uint64_t nKeyedNetGroup;
     std::atomic_bool fPauseRecv{false};
     std::atomic_bool fPauseSend{false};
+    /** Claim flag ensuring at most one message handler thread processes this
+     *  peer at a time, which keeps per-peer message order intact while
+     *  different peers are handled concurrently. */
+    std::atomic_bool m_msg_handler_claimed{false};
 
     bool IsOutboundOrBlockRelayConn() const {
         switch (m_conn_type) {
@@ -545,8 +597,14 @@ public:
     std::atomic<bool> m_bip152_highbandwidth_from{false};
 
     // flood relay
-    std::vector<CAddress> vAddrToSend;
-    std::unique_ptr<CRollingBloomFilter> m_addr_known{nullptr};
+    /** Guards the address send queue and known-address filter. Both are
+     * written not only by this peer's own message handler (ADDR/GETADDR
+     * processing, SendMessages) but also, via RelayAddresses, by whichever
+     * message handler thread is processing some other peer's ADDR message,
+     * so with more than one message handler thread they need a lock. */
+    mutable Mutex m_addr_send_mutex;
+    std::vector<CAddress> vAddrToSend GUARDED_BY(m_addr_send_mutex);
+    std::unique_ptr<CRollingBloomFilter> m_addr_known GUARDED_BY(m_addr_send_mutex){nullptr};
     bool fGetAddr{false};
     std::chrono::microseconds m_next_addr_send GUARDED_BY(cs_sendProcessing){0};
     std::chrono::microseconds m_next_local_addr_send GUARDED_BY(cs_sendProcessing){0};
@@ -557,7 +615,7 @@ public:
         // a) it allows us to not relay tx invs before receiving the peer's version message
         // b) the peer may tell us in its version message that we should not relay tx invs
         //    unless it loads a bloom filter.
-        bool fRelayTxes GUARDED_BY(cs_filter){false};
+        std::atomic<bool> fRelayTxes{false};
         std::unique_ptr<CBloomFilter> pfilter PT_GUARDED_BY(cs_filter) GUARDED_BY(cs_filter){nullptr};
 
         mutable RecursiveMutex cs_tx_inventory;
@@ -657,6 +715,7 @@ public:
 
     void AddAddressKnown(const CAddress& _addr)
     {
+        LOCK(m_addr_send_mutex);
         assert(m_addr_known);
         m_addr_known->insert(_addr.GetKey());
     }
@@ -676,6 +735,7 @@ public:
         // Known checking here is only to save space from duplicates.
         // SendMessages will filter it again for knowns that were added
         // after addresses were pushed.
+        LOCK(m_addr_send_mutex);
         assert(m_addr_known);
         if (_addr.IsValid() && !m_addr_known->contains(_addr.GetKey()) && IsAddrCompatible(_addr)) {
             if (vAddrToSend.size() >= MAX_ADDR_TO_SEND) {
@@ -756,8 +816,8 @@ private:
     CService addrLocal GUARDED_BY(cs_addrLocal);
     mutable RecursiveMutex cs_addrLocal;
 
-    mapMsgCmdSize mapSendBytesPerMsgCmd GUARDED_BY(cs_vSend);
-    mapMsgCmdSize mapRecvBytesPerMsgCmd GUARDED_BY(cs_vRecv);
+    mapMsgCmdSizeAtomic mapSendBytesPerMsgCmd;
+    mapMsgCmdSizeAtomic mapRecvBytesPerMsgCmd;
 };
 
 /**
@@ -827,6 +887,7 @@ public:
         std::vector<std::string> m_added_nodes;
         std::vector<bool> m_asmap;
         bool m_i2p_accept_incoming;
+        int m_msgproc_threads = DEFAULT_MSGHANDLER_THREADS;
     };
 
     void Init(const Options& connOptions) {
@@ -844,10 +905,8 @@ public:
         nSendBufferMaxSize = connOptions.nSendBufferMaxSize;
         nReceiveFloodSize = connOptions.nReceiveFloodSize;
         m_peer_connect_timeout = connOptions.m_peer_connect_timeout;
-        {
-            LOCK(cs_totalBytesSent);
-            nMaxOutboundLimit = connOptions.nMaxOutboundLimit;
-        }
+        m_msgproc_threads = std::max(1, connOptions.m_msgproc_threads);
+        nMaxOutboundLimit = connOptions.nMaxOutboundLimit;
         vWhitelistedRange = connOptions.vWhitelistedRange;
         {
             LOCK(cs_vAddedNodes);
@@ -972,6 +1031,10 @@ public:
 
     size_t GetNodeCount(ConnectionDirection);
     void GetNodeStats(std::vector<CNodeStats>& vstats);
+    /** As above, but only for peers not in `known` or whose total traffic
+     * differs from the value recorded there; ids in `known` with no current
+     * connection are returned in `disconnected`. */
+    void GetNodeStats(std::vector<CNodeStats>& vstats, const std::map<NodeId, uint64_t>& known, std::vector<NodeId>& disconnected);
     bool DisconnectNode(const std::string& node);
     bool DisconnectNode(const CSubNet& subnet);
     bool DisconnectNode(const CNetAddr& addr);
@@ -1022,6 +1085,15 @@ public:
     /** Return true if the peer has been connected for long enough to do inactivity checks. */
     bool RunInactivityChecks(const CNode& node) const;
 
+    //! Automatic outbound connection attempts running asynchronously, so a
+    //! single slow connect (unresponsive address, Tor latency) cannot stall
+    //! anchor, feeler and full-relay pacing in ThreadOpenConnections.
+    std::list<std::future<void>> m_outbound_attempts;
+    //! In-flight automatic attempts per type, counted toward the outbound
+    //! targets while the connect is still in progress.
+    std::atomic<int> m_inflight_full_relay{0};
+    std::atomic<int> m_inflight_block_relay{0};
+
 private:
     struct ListenSocket {
     public:
@@ -1068,6 +1140,22 @@ private:
     void SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set);
     void SocketHandler();
     void ThreadSocketHandler();
+#ifdef USE_EPOLL
+    /** Kernel event instance used by SocketEvents; created lazily on the
+     *  socket handler thread and closed in the destructor. */
+    int m_epoll_fd{-1};
+    /** Event mask currently registered with the kernel per socket, so that
+     *  epoll_ctl is only issued when a socket's interest actually changes.
+     *  Only touched by the socket handler thread. */
+    std::unordered_map<SOCKET, uint32_t> m_epoll_registered;
+#elif defined(USE_KQUEUE)
+    /** Kernel event instance used by SocketEvents; created lazily on the
+     *  socket handler thread and closed in the destructor. */
+    int m_kqueue_fd{-1};
+    /** (read interest, write interest) currently registered with the kernel
+     *  per socket. Only touched by the socket handler thread. */
+    std::unordered_map<SOCKET, std::pair<bool, bool>> m_kqueue_registered;
+#endif
     void ThreadDNSAddressSeed();
 
     uint64_t CalculateKeyedNetGroup(const CAddress& ad) const;
@@ -1093,6 +1181,9 @@ private:
 
     size_t SocketSendData(CNode& node) const EXCLUSIVE_LOCKS_REQUIRED(node.cs_vSend);
     void DumpAddresses();
+    //! Append addrman mutations since the last flush to peers.journal, or
+    //! fall back to a full dump when the in-memory journal overflowed.
+    void FlushAddressJournal();
 
     // Network stats
     void RecordBytesRecv(uint64_t bytes);
@@ -1106,16 +1197,21 @@ private:
     // Whether the node should be passed out in ForEach* callbacks
     static bool NodeFullyConnected(const CNode* pnode);
 
-    // Network usage totals
-    RecursiveMutex cs_totalBytesRecv;
-    RecursiveMutex cs_totalBytesSent;
-    uint64_t nTotalBytesRecv GUARDED_BY(cs_totalBytesRecv) {0};
-    uint64_t nTotalBytesSent GUARDED_BY(cs_totalBytesSent) {0};
+    // Network usage totals. Updated with relaxed atomics on every socket
+    // event; exact cross-counter consistency is not needed for stats or for
+    // rate limiting.
+    std::atomic<uint64_t> nTotalBytesRecv{0};
+    std::atomic<uint64_t> nTotalBytesSent{0};
 
     // outbound limit & stats
-    uint64_t nMaxOutboundTotalBytesSentInCycle GUARDED_BY(cs_totalBytesSent) {0};
-    std::chrono::seconds nMaxOutboundCycleStartTime GUARDED_BY(cs_totalBytesSent) {0};
-    uint64_t nMaxOutboundLimit GUARDED_BY(cs_totalBytesSent);
+    std::atomic<uint64_t> nMaxOutboundTotalBytesSentInCycle{0};
+    //! Start of the current upload cycle in seconds since epoch; 0 until the
+    //! first byte is sent. Readers use relaxed loads; only the cycle rollover
+    //! (once per MAX_UPLOAD_TIMEFRAME) takes m_outbound_cycle_mutex.
+    std::atomic<int64_t> m_max_outbound_cycle_start{0};
+    //! Serializes cycle rollovers so only one thread resets the counters.
+    Mutex m_outbound_cycle_mutex;
+    std::atomic<uint64_t> nMaxOutboundLimit{0};
 
     // P2P timeout in seconds
     int64_t m_peer_connect_timeout;
@@ -1126,6 +1222,7 @@ private:
 
     unsigned int nSendBufferMaxSize{0};
     unsigned int nReceiveFloodSize{0};
+    int m_msgproc_threads{DEFAULT_MSGHANDLER_THREADS};
 
     std::vector<ListenSocket> vhListenSocket;
     std::atomic<bool> fNetworkActive{true};
@@ -1236,7 +1333,10 @@ private:
     std::thread threadSocketHandler;
     std::thread threadOpenAddedConnections;
     std::thread threadOpenConnections;
-    std::thread threadMessageHandler;
+    /** Pool of message handler threads; each claims one peer at a time, so
+     *  peers are processed concurrently while any single peer's messages are
+     *  handled in order by one thread. */
+    std::vector<std::thread> m_msghandler_threads;
     std::thread threadI2PAcceptIncoming;
 
     /** flag for deciding to connect to an extra outbound peer,
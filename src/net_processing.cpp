@@ -16,6 +16,7 @@
 #include <merkleblock.h>
 #include <netbase.h>
 #include <netmessagemaker.h>
+#include <node/headerstore.h>
 #include <policy/fees.h>
 #include <policy/policy.h>
 #include <primitives/block.h>
@@ -31,15 +32,16 @@
 #include <util/check.h> // For NDEBUG compile time check
 #include <util/strencodings.h>
 #include <util/system.h>
+#include <util/trace.h>
 #include <validation.h>
 
 #include <memory>
 #include <optional>
 #include <typeinfo>
 
-/** How long to cache transactions in mapRelay for normal relay */
+/** How long to keep relayed transactions available for getdata in the recently-seen store */
 static constexpr auto RELAY_TX_CACHE_TIME = 15min;
-/** How long a transaction has to be in the mempool before it can unconditionally be relayed (even when not in mapRelay). */
+/** How long a transaction has to be in the mempool before it can unconditionally be relayed (even when no longer in the recently-seen store). */
 static constexpr auto UNCONDITIONAL_RELAY_DELAY = 2min;
 /** Headers download timeout.
  *  Timeout = base + per_header * (expected number of headers) */
@@ -93,6 +95,12 @@ static const unsigned int MAX_GETDATA_SZ = 1000;
 static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 16;
 /** Time during which a peer must stall block download progress before being disconnected. */
 static constexpr auto BLOCK_STALLING_TIMEOUT = 2s;
+/** Mempool transactions younger than this when a block arrives are assumed not to have
+ *  propagated to our peers yet and are prefilled in compact block announcements. */
+static constexpr int64_t PREFILL_RECENT_TX_SECONDS = 10;
+/** Cap on the serialized size of predicted-missing transactions prefilled per compact block
+ *  announcement, bounding the bandwidth overhead when the prediction is wrong. */
+static constexpr size_t MAX_PREDICTED_PREFILL_BYTES = 10000;
 /** Number of headers sent in one getheaders result. We rely on the assumption that if a peer sends
  *  less than this number, we reached its tip. Changing this value is a protocol upgrade. */
 static const unsigned int MAX_HEADERS_RESULTS = 2000;
@@ -132,6 +140,9 @@ static constexpr auto OUTBOUND_INVENTORY_BROADCAST_INTERVAL = 2s;
 static constexpr unsigned int INVENTORY_BROADCAST_PER_SECOND = 7;
 /** Maximum number of inventory items to send per transmission. */
 static constexpr unsigned int INVENTORY_BROADCAST_MAX = INVENTORY_BROADCAST_PER_SECOND * count_seconds(INBOUND_INVENTORY_BROADCAST_INTERVAL);
+/** How long the shared relay-order rank cache may serve INV trickles before
+ *  being rebuilt from the mempool. */
+static constexpr auto RELAY_RANK_CACHE_LIFETIME = 1s;
 /** The number of most recently announced transactions a peer can request. */
 static constexpr unsigned int INVENTORY_MAX_RECENT_RELAY = 3500;
 /** Verify that INVENTORY_MAX_RECENT_RELAY is enough to cache everything typically
@@ -150,6 +161,15 @@ static constexpr uint32_t MAX_GETCFHEADERS_SIZE = 2000;
 /** the maximum percentage of addresses from our addrman to return in response to a getaddr message. */
 static constexpr size_t MAX_PCT_ADDR_TO_SEND = 23;
 
+// Arguments polled on hot paths (per message or per transaction), read
+// through lock-free handles instead of GetArg's map-under-mutex lookup.
+static const CachedArg<int64_t> g_arg_max_mempool{"-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE};
+static const CachedArg<int64_t> g_arg_mempool_expiry{"-mempoolexpiry", DEFAULT_MEMPOOL_EXPIRY};
+static const CachedArg<int64_t> g_arg_block_reconstruction_extra_txn{"-blockreconstructionextratxn", DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN};
+static const CachedArg<int64_t> g_arg_max_orphan_tx{"-maxorphantx", DEFAULT_MAX_ORPHAN_TRANSACTIONS};
+static const CachedArg<bool> g_arg_capture_messages{"-capturemessages", false};
+static const CachedArg<bool> g_arg_feefilter{"-feefilter", DEFAULT_FEEFILTER};
+
 // Internal stuff
 namespace {
 /** Blocks that are in flight, and that are in the queue to be downloaded. */
@@ -245,6 +265,7 @@ public:
     /** Implement PeerManager */
     void CheckForStaleTipAndEvictPeers() override;
     bool GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) override;
+    std::map<std::string, MsgTypeStats> GetMessageTypeStats() const override;
     bool IgnoresIncomingTxs() override { return m_ignore_incoming_txs; }
     void SendPings() override;
     void RelayTransaction(const uint256& txid, const uint256& wtxid) override;
@@ -263,6 +284,10 @@ private:
     /** Retrieve unbroadcast transactions from the mempool and reattempt sending to peers */
     void ReattemptInitialBroadcast(CScheduler& scheduler);
 
+    /** Trim the mempool to -maxmempool if it has grown over the limit; only
+     *  scheduled when -mempoolbgtrim is enabled */
+    void TrimMempoolExcess();
+
     /** Get a shared pointer to the Peer object.
      *  May return an empty shared_ptr if the Peer object can't be found. */
     PeerRef GetPeerRef(NodeId id) const;
@@ -328,11 +353,32 @@ private:
     CTxMemPool& m_mempool;
     TxRequestTracker m_txrequest GUARDED_BY(::cs_main);
 
+    /** Tx request timing knobs, runtime-configurable via the -txrequest* debug
+     *  options so acquisition latency can be tuned against bandwidth on nodes
+     *  whose role is fast transaction acquisition. */
+    const std::chrono::microseconds m_nonpref_peer_tx_delay;
+    const std::chrono::microseconds m_txid_relay_delay;
+    const std::chrono::microseconds m_overloaded_peer_tx_delay;
+    const std::chrono::microseconds m_getdata_tx_interval;
+    const size_t m_max_peer_tx_in_flight;
+
     /** The height of the best chain */
     std::atomic<int> m_best_height{-1};
 
     int64_t m_stale_tip_check_time; //!< Next time to check for stale tip
 
+    /** Relay-order ranks (depth-and-score position, keyed by both txid and
+     *  wtxid) for the mempool, shared by all peers' INV trickles so the
+     *  feerate ordering is computed once per refresh instead of once per
+     *  peer per trickle. Lazily rebuilt by UpdateRelayRankCache(). */
+    std::unordered_map<uint256, uint64_t, SaltedTxidHasher> m_relay_rank GUARDED_BY(cs_main);
+    /** When m_relay_rank was last rebuilt. */
+    std::chrono::microseconds m_relay_rank_built GUARDED_BY(cs_main){0};
+
+    /** Rebuild m_relay_rank from the mempool if it is older than
+     *  RELAY_RANK_CACHE_LIFETIME. */
+    void UpdateRelayRankCache(std::chrono::microseconds now) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     /** Whether this node is running in blocks only mode */
     const bool m_ignore_incoming_txs;
 
@@ -340,6 +386,11 @@ private:
       * on extra block-relay-only peers. */
     bool m_initial_sync_finished{false};
 
+    /** Protects m_msg_type_stats */
+    mutable Mutex m_msg_stats_mutex;
+    /** Cumulative per-message-type processing cost, keyed by message type */
+    std::map<std::string, MsgTypeStats> m_msg_type_stats GUARDED_BY(m_msg_stats_mutex);
+
     /** Protects m_peer_map. This mutex must not be locked while holding a lock
      *  on any of the mutexes inside a Peer object. */
     mutable Mutex m_peer_mutex;
@@ -443,11 +494,130 @@ private:
 
     void ProcessGetData(CNode& pfrom, Peer& peer, const std::atomic<bool>& interruptMsgProc) EXCLUSIVE_LOCKS_REQUIRED(!cs_main, peer.m_getdata_requests_mutex);
 
-    /** Relay map (txid or wtxid -> CTransactionRef) */
-    typedef std::map<uint256, CTransactionRef> MapRelay;
-    MapRelay mapRelay GUARDED_BY(cs_main);
-    /** Expiration-time ordered list of (expire time, relay map entry) pairs. */
-    std::deque<std::pair<std::chrono::microseconds, MapRelay::iterator>> g_relay_expiration GUARDED_BY(cs_main);
+    /** Single reference-counted store of recently-seen transactions, serving
+     *  both getdata relay lookups (formerly mapRelay) and compact block
+     *  reconstruction extras (formerly vExtraTxnForCompact). A transaction
+     *  filling both roles is stored once; each role only pins it for as long
+     *  as that role needs it. Internally synchronized, so it can be consulted
+     *  without taking cs_main or g_cs_orphans. */
+    class RecentTxStore {
+    private:
+        struct Entry {
+            CTransactionRef tx;
+            //! Relay expiry; zero when the entry is not (or no longer) relay-eligible.
+            std::chrono::microseconds m_expiry{0};
+            //! Whether the entry currently occupies a compact-extra ring slot.
+            bool m_extra{false};
+        };
+        mutable Mutex m_mutex;
+        //! Entries keyed by wtxid.
+        std::map<uint256, Entry> m_entries GUARDED_BY(m_mutex);
+        //! txid -> wtxid, for entries whose txid differs from their wtxid.
+        std::map<uint256, uint256> m_txid_index GUARDED_BY(m_mutex);
+        //! Expiration-time ordered wtxids of relay-eligible entries.
+        std::deque<std::pair<std::chrono::microseconds, uint256>> m_expiration GUARDED_BY(m_mutex);
+        //! Ring buffer of wtxids kept for compact block reconstruction.
+        std::vector<uint256> m_extra_ring GUARDED_BY(m_mutex);
+        size_t m_extra_pos GUARDED_BY(m_mutex){0};
+
+        //! Remove an entry (and its txid index) once neither role needs it.
+        void MaybeErase(std::map<uint256, Entry>::iterator it) EXCLUSIVE_LOCKS_REQUIRED(m_mutex)
+        {
+            if (it->second.m_extra || it->second.m_expiry.count() > 0) return;
+            const CTransactionRef& tx = it->second.tx;
+            if (tx->GetHash() != tx->GetWitnessHash()) m_txid_index.erase(tx->GetHash());
+            m_entries.erase(it);
+        }
+
+        std::map<uint256, Entry>::iterator GetOrCreate(const CTransactionRef& tx) EXCLUSIVE_LOCKS_REQUIRED(m_mutex)
+        {
+            auto ret = m_entries.emplace(tx->GetWitnessHash(), Entry{});
+            if (ret.second) {
+                ret.first->second.tx = tx;
+                if (tx->GetHash() != tx->GetWitnessHash()) m_txid_index.emplace(tx->GetHash(), tx->GetWitnessHash());
+            }
+            return ret.first;
+        }
+
+    public:
+        //! Keep a transaction we announced available for getdata until expiry.
+        //! A pre-existing expiry is not extended, matching the old mapRelay behavior.
+        void InsertRelay(const CTransactionRef& tx, std::chrono::microseconds expiry)
+        {
+            LOCK(m_mutex);
+            auto it = GetOrCreate(tx);
+            if (it->second.m_expiry.count() == 0) {
+                it->second.m_expiry = expiry;
+                m_expiration.emplace_back(expiry, it->first);
+            }
+        }
+
+        //! Keep a transaction as a compact block reconstruction extra, in a
+        //! ring of the most recent max_extra such transactions.
+        void InsertExtra(const CTransactionRef& tx, size_t max_extra)
+        {
+            if (max_extra == 0) return;
+            LOCK(m_mutex);
+            if (m_extra_ring.empty()) m_extra_ring.resize(max_extra);
+            const uint256& evicted = m_extra_ring[m_extra_pos];
+            if (!evicted.IsNull()) {
+                auto it = m_entries.find(evicted);
+                if (it != m_entries.end()) {
+                    it->second.m_extra = false;
+                    MaybeErase(it);
+                }
+            }
+            auto it = GetOrCreate(tx);
+            it->second.m_extra = true;
+            m_extra_ring[m_extra_pos] = it->first;
+            m_extra_pos = (m_extra_pos + 1) % max_extra;
+        }
+
+        //! Look up by txid or wtxid. Serving extras-only entries here is safe:
+        //! getdata responses are additionally gated on the per-peer
+        //! recently-announced filter, which such entries never entered.
+        CTransactionRef Find(const uint256& hash) const
+        {
+            LOCK(m_mutex);
+            auto it = m_entries.find(hash);
+            if (it == m_entries.end()) {
+                auto txid_it = m_txid_index.find(hash);
+                if (txid_it == m_txid_index.end()) return {};
+                it = m_entries.find(txid_it->second);
+                if (it == m_entries.end()) return {};
+            }
+            return it->second.tx;
+        }
+
+        //! Snapshot of the compact-block extras for PartiallyDownloadedBlock::InitData.
+        std::vector<std::pair<uint256, CTransactionRef>> GetExtras() const
+        {
+            LOCK(m_mutex);
+            std::vector<std::pair<uint256, CTransactionRef>> ret;
+            ret.reserve(m_extra_ring.size());
+            for (const uint256& wtxid : m_extra_ring) {
+                if (wtxid.IsNull()) continue;
+                auto it = m_entries.find(wtxid);
+                if (it != m_entries.end()) ret.emplace_back(wtxid, it->second.tx);
+            }
+            return ret;
+        }
+
+        //! Drop relay eligibility from entries whose expiry has passed.
+        void Expire(std::chrono::microseconds now)
+        {
+            LOCK(m_mutex);
+            while (!m_expiration.empty() && m_expiration.front().first < now) {
+                auto it = m_entries.find(m_expiration.front().second);
+                if (it != m_entries.end()) {
+                    it->second.m_expiry = std::chrono::microseconds{0};
+                    MaybeErase(it);
+                }
+                m_expiration.pop_front();
+            }
+        }
+    };
+    RecentTxStore m_recent_tx_store;
 
     /**
      * When a peer sends us a valid block, instruct it to announce blocks to us
@@ -466,14 +636,8 @@ private:
     /** Storage for orphan information */
     TxOrphanage m_orphanage;
 
-    void AddToCompactExtraTransactions(const CTransactionRef& tx) EXCLUSIVE_LOCKS_REQUIRED(g_cs_orphans);
-
-    /** Orphan/conflicted/etc transactions that are kept for compact block reconstruction.
-     *  The last -blockreconstructionextratxn/DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN of
-     *  these are kept in a ring buffer */
-    std::vector<std::pair<uint256, CTransactionRef>> vExtraTxnForCompact GUARDED_BY(g_cs_orphans);
-    /** Offset into vExtraTxnForCompact to insert the next tx */
-    size_t vExtraTxnForCompactIt GUARDED_BY(g_cs_orphans) = 0;
+    /** Keep an orphan/conflicted/etc transaction for compact block reconstruction, see RecentTxStore. */
+    void AddToCompactExtraTransactions(const CTransactionRef& tx);
 
     void ProcessBlockAvailability(NodeId nodeid) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     void UpdateBlockAvailability(NodeId nodeid, const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -521,6 +685,10 @@ struct CNodeState {
     std::chrono::microseconds m_headers_sync_timeout{0us};
     //! Since when we're stalling block download progress (in microseconds), or 0.
     std::chrono::microseconds m_stalling_since{0us};
+    //! Number of compact blocks from this peer reconstructed without a getblocktxn round trip.
+    uint64_t m_cmpctblock_no_roundtrip{0};
+    //! Number of compact blocks from this peer that needed a getblocktxn round trip.
+    uint64_t m_cmpctblock_roundtrip{0};
     std::list<QueuedBlock> vBlocksInFlight;
     //! When the first entry in vBlocksInFlight started downloading. Don't care when vBlocksInFlight is empty.
     std::chrono::microseconds m_downloading_since{0us};
@@ -912,11 +1080,11 @@ void PeerManagerImpl::AddTxAnnouncement(const CNode& node, const GenTxid& gtxid,
     //     MAX_PEER_TX_REQUEST_IN_FLIGHT requests in flight (and don't have PF_RELAY).
     auto delay = std::chrono::microseconds{0};
     const bool preferred = state->fPreferredDownload;
-    if (!preferred) delay += NONPREF_PEER_TX_DELAY;
-    if (!gtxid.IsWtxid() && m_wtxid_relay_peers > 0) delay += TXID_RELAY_DELAY;
+    if (!preferred) delay += m_nonpref_peer_tx_delay;
+    if (!gtxid.IsWtxid() && m_wtxid_relay_peers > 0) delay += m_txid_relay_delay;
     const bool overloaded = !node.HasPermission(PF_RELAY) &&
-        m_txrequest.CountInFlight(nodeid) >= MAX_PEER_TX_REQUEST_IN_FLIGHT;
-    if (overloaded) delay += OVERLOADED_PEER_TX_DELAY;
+        m_txrequest.CountInFlight(nodeid) >= m_max_peer_tx_in_flight;
+    if (overloaded) delay += m_overloaded_peer_tx_delay;
     m_txrequest.ReceivedInv(nodeid, gtxid, preferred, current_time + delay);
 }
 
@@ -968,6 +1136,15 @@ void PeerManagerImpl::ReattemptInitialBroadcast(CScheduler& scheduler)
     scheduler.scheduleFromNow([&] { ReattemptInitialBroadcast(scheduler); }, delta);
 }
 
+void PeerManagerImpl::TrimMempoolExcess()
+{
+    const size_t limit = g_arg_max_mempool.Get() * 1000000;
+    LOCK2(cs_main, m_mempool.cs);
+    if (m_mempool.DynamicMemoryUsage() <= limit) return;
+    LimitMempoolSize(m_mempool, m_chainman.ActiveChainstate().CoinsTip(), limit,
+                     std::chrono::hours{g_arg_mempool_expiry.Get()});
+}
+
 void PeerManagerImpl::FinalizeNode(const CNode& node, bool& fUpdateConnectionTime)
 {
     NodeId nodeid = node.GetId();
@@ -1042,6 +1219,12 @@ PeerRef PeerManagerImpl::RemovePeer(NodeId id)
     return ret;
 }
 
+std::map<std::string, MsgTypeStats> PeerManagerImpl::GetMessageTypeStats() const
+{
+    LOCK(m_msg_stats_mutex);
+    return m_msg_type_stats;
+}
+
 bool PeerManagerImpl::GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats)
 {
     {
@@ -1055,6 +1238,9 @@ bool PeerManagerImpl::GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats)
             if (queue.pindex)
                 stats.vHeightInFlight.push_back(queue.pindex->nHeight);
         }
+        stats.m_cmpctblock_no_roundtrip = state->m_cmpctblock_no_roundtrip;
+        stats.m_cmpctblock_roundtrip = state->m_cmpctblock_roundtrip;
+        stats.m_txrequest = m_txrequest.GetPeerStats(nodeid);
     }
 
     PeerRef peer = GetPeerRef(nodeid);
@@ -1078,13 +1264,7 @@ bool PeerManagerImpl::GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats)
 
 void PeerManagerImpl::AddToCompactExtraTransactions(const CTransactionRef& tx)
 {
-    size_t max_extra_txn = gArgs.GetArg("-blockreconstructionextratxn", DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN);
-    if (max_extra_txn <= 0)
-        return;
-    if (!vExtraTxnForCompact.size())
-        vExtraTxnForCompact.resize(max_extra_txn);
-    vExtraTxnForCompact[vExtraTxnForCompactIt] = std::make_pair(tx->GetWitnessHash(), tx);
-    vExtraTxnForCompactIt = (vExtraTxnForCompactIt + 1) % max_extra_txn;
+    m_recent_tx_store.InsertExtra(tx, g_arg_block_reconstruction_extra_txn.Get());
 }
 
 void PeerManagerImpl::Misbehaving(const NodeId pnode, const int howmuch, const std::string& message)
@@ -1216,6 +1396,11 @@ PeerManagerImpl::PeerManagerImpl(const CChainParams& chainparams, CConnman& conn
       m_banman(banman),
       m_chainman(chainman),
       m_mempool(pool),
+      m_nonpref_peer_tx_delay{std::chrono::milliseconds{gArgs.GetArg("-txrequestnonprefdelay", std::chrono::duration_cast<std::chrono::milliseconds>(NONPREF_PEER_TX_DELAY).count())}},
+      m_txid_relay_delay{std::chrono::milliseconds{gArgs.GetArg("-txrequesttxiddelay", std::chrono::duration_cast<std::chrono::milliseconds>(TXID_RELAY_DELAY).count())}},
+      m_overloaded_peer_tx_delay{std::chrono::milliseconds{gArgs.GetArg("-txrequestoverloadeddelay", std::chrono::duration_cast<std::chrono::milliseconds>(OVERLOADED_PEER_TX_DELAY).count())}},
+      m_getdata_tx_interval{std::chrono::milliseconds{gArgs.GetArg("-txrequestgetdatainterval", std::chrono::duration_cast<std::chrono::milliseconds>(GETDATA_TX_INTERVAL).count())}},
+      m_max_peer_tx_in_flight{static_cast<size_t>(gArgs.GetArg("-txrequestmaxinflight", MAX_PEER_TX_REQUEST_IN_FLIGHT))},
       m_stale_tip_check_time(0),
       m_ignore_incoming_txs(ignore_incoming_txs)
 {
@@ -1244,6 +1429,13 @@ PeerManagerImpl::PeerManagerImpl(const CChainParams& chainparams, CConnman& conn
     // schedule next run for 10-15 minutes in the future
     const std::chrono::milliseconds delta = std::chrono::minutes{10} + GetRandMillis(std::chrono::minutes{5});
     scheduler.scheduleFromNow([&] { ReattemptInitialBroadcast(scheduler); }, delta);
+
+    if (gArgs.GetBoolArg("-mempoolbgtrim", DEFAULT_MEMPOOL_BG_TRIM)) {
+        // Eviction from AcceptToMemoryPool is deferred (up to a small
+        // overshoot of -maxmempool), so run it periodically off the message
+        // handler's critical path instead.
+        scheduler.scheduleEvery([this] { this->TrimMempoolExcess(); }, std::chrono::seconds{1});
+    }
 }
 
 /**
@@ -1288,8 +1480,10 @@ void PeerManagerImpl::BlockDisconnected(const std::shared_ptr<const CBlock> &blo
     m_recent_confirmed_transactions->reset();
 }
 
-// All of the following cache a recent block, and are protected by cs_most_recent_block
-static RecursiveMutex cs_most_recent_block;
+// All of the following cache a recent block, and are protected by cs_most_recent_block.
+// Written once per block (in NewPoWValidBlock) but read by every peer thread serving
+// getdata/getblocktxn, so readers take the lock in shared mode.
+static SharedMutex cs_most_recent_block;
 static std::shared_ptr<const CBlock> most_recent_block GUARDED_BY(cs_most_recent_block);
 static std::shared_ptr<const CBlockHeaderAndShortTxIDs> most_recent_compact_block GUARDED_BY(cs_most_recent_block);
 static uint256 most_recent_block_hash GUARDED_BY(cs_most_recent_block);
@@ -1301,7 +1495,47 @@ static bool fWitnessesPresentInMostRecentCompactBlock GUARDED_BY(cs_most_recent_
  */
 void PeerManagerImpl::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& pblock)
 {
-    std::shared_ptr<const CBlockHeaderAndShortTxIDs> pcmpctblock = std::make_shared<const CBlockHeaderAndShortTxIDs> (*pblock, true);
+    // Predict which of the block's transactions our peers are likely missing
+    // and prefill them alongside the coinbase: anything absent from our own
+    // mempool (we fetched it via getblocktxn ourselves, or it replaced or
+    // conflicted with what we relayed), anything that arrived too recently to
+    // have propagated, and anything a connected peer's feefilter would have
+    // suppressed. Each prefill that lands saves the receiver a getblocktxn
+    // round trip, i.e. a full network RTT of relay latency, for a bounded
+    // amount of extra announce bandwidth.
+    std::vector<uint16_t> extra_prefill;
+    if (pblock->vtx.size() > 1) {
+        CAmount max_fee_filter{0};
+        m_connman.ForEachNode([&max_fee_filter](CNode* pnode) {
+            if (pnode->m_tx_relay == nullptr) return;
+            max_fee_filter = std::max(max_fee_filter, pnode->m_tx_relay->minFeeFilter.load());
+        });
+        const int64_t now{GetTime()};
+        size_t prefill_bytes{0};
+        LOCK(m_mempool.cs);
+        for (size_t i = 1; i < pblock->vtx.size() && i <= std::numeric_limits<uint16_t>::max(); i++) {
+            const CTransactionRef& tx = pblock->vtx[i];
+            bool predict_missing{false};
+            const auto it = m_mempool.GetIter(tx->GetHash());
+            if (!it) {
+                predict_missing = true;
+            } else if (now - count_seconds((*it)->GetTime()) < PREFILL_RECENT_TX_SECONDS) {
+                predict_missing = true;
+            } else if (max_fee_filter > 0 && (*it)->GetModifiedFee() < CFeeRate{max_fee_filter}.GetFee((*it)->GetTxSize())) {
+                predict_missing = true;
+            }
+            if (!predict_missing) continue;
+            const size_t tx_bytes{GetSerializeSize(*tx, PROTOCOL_VERSION)};
+            if (prefill_bytes + tx_bytes > MAX_PREDICTED_PREFILL_BYTES) continue;
+            prefill_bytes += tx_bytes;
+            extra_prefill.push_back(i);
+        }
+        if (!extra_prefill.empty()) {
+            LogPrint(BCLog::NET, "PeerManager::NewPoWValidBlock prefilling %u predicted-missing txs (%u bytes) for %s\n",
+                     extra_prefill.size(), prefill_bytes, pblock->GetHash().ToString());
+        }
+    }
+    std::shared_ptr<const CBlockHeaderAndShortTxIDs> pcmpctblock = std::make_shared<const CBlockHeaderAndShortTxIDs> (*pblock, true, extra_prefill);
     const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
 
     LOCK(cs_main);
@@ -1474,54 +1708,74 @@ void PeerManagerImpl::RelayTransaction(const uint256& txid, const uint256& wtxid
 }
 
 /**
- * Relay (gossip) an address to a few randomly chosen nodes.
+ * Relay (gossip) a batch of addresses, each to a few randomly chosen nodes.
  * We choose the same nodes within a given 24h window (if the list of connected
  * nodes does not change) and we don't relay to nodes that already know an
  * address. So within 24h we will likely relay a given address once. This is to
  * prevent a peer from unjustly giving their address better propagation by sending
  * it to us repeatedly.
- * @param[in] originator The peer that sent us the address. We don't want to relay it back.
- * @param[in] addr Address to relay.
- * @param[in] fReachable Whether the address' network is reachable. We relay unreachable
- * addresses less.
+ *
+ * Taking the whole batch at once means the node list is traversed (and its
+ * lock taken) once per ADDR message instead of once per address, keeping addr
+ * gossip cheap relative to tx/block work on the same handler thread.
+ * @param[in] originator The peer that sent us the addresses. We don't want to relay them back.
+ * @param[in] addrs Addresses to relay, each paired with whether its network is
+ * reachable. We relay unreachable addresses less.
  * @param[in] connman Connection manager to choose nodes to relay to.
  */
-static void RelayAddress(const CNode& originator,
-                         const CAddress& addr,
-                         bool fReachable,
-                         const CConnman& connman)
+static void RelayAddresses(const CNode& originator,
+                           const std::vector<std::pair<CAddress, bool>>& addrs,
+                           const CConnman& connman)
 {
-    if (!fReachable && !addr.IsRelayable()) return;
-
-    // Relay to a limited number of other nodes
-    // Use deterministic randomness to send to the same nodes for 24 hours
-    // at a time so the m_addr_knowns of the chosen nodes prevent repeats
-    uint64_t hashAddr = addr.GetHash();
-    const CSipHasher hasher = connman.GetDeterministicRandomizer(RANDOMIZER_ID_ADDRESS_RELAY).Write(hashAddr << 32).Write((GetTime() + hashAddr) / (24 * 60 * 60));
-    FastRandomContext insecure_rand;
-
-    // Relay reachable addresses to 2 peers. Unreachable addresses are relayed randomly to 1 or 2 peers.
-    unsigned int nRelayNodes = (fReachable || (hasher.Finalize() & 1)) ? 2 : 1;
-
-    std::array<std::pair<uint64_t, CNode*>,2> best{{{0, nullptr}, {0, nullptr}}};
-    assert(nRelayNodes <= best.size());
-
-    auto sortfunc = [&best, &hasher, nRelayNodes, &originator, &addr](CNode* pnode) {
-        if (pnode->RelayAddrsWithConn() && pnode != &originator && pnode->IsAddrCompatible(addr)) {
-            uint64_t hashKey = CSipHasher(hasher).Write(pnode->GetId()).Finalize();
-            for (unsigned int i = 0; i < nRelayNodes; i++) {
-                 if (hashKey > best[i].first) {
-                     std::copy(best.begin() + i, best.begin() + nRelayNodes - 1, best.begin() + i + 1);
-                     best[i] = std::make_pair(hashKey, pnode);
+    // Per-address relay state: the deterministic hasher and the best
+    // candidate peers found so far.
+    struct Candidate {
+        const CAddress* addr;
+        CSipHasher hasher;
+        unsigned int nRelayNodes;
+        std::array<std::pair<uint64_t, CNode*>, 2> best{{{0, nullptr}, {0, nullptr}}};
+    };
+
+    const CSipHasher base_hasher = connman.GetDeterministicRandomizer(RANDOMIZER_ID_ADDRESS_RELAY);
+    const int64_t now = GetTime();
+
+    std::vector<Candidate> candidates;
+    candidates.reserve(addrs.size());
+    for (const auto& [addr, fReachable] : addrs) {
+        if (!fReachable && !addr.IsRelayable()) continue;
+
+        // Use deterministic randomness to send to the same nodes for 24 hours
+        // at a time so the m_addr_knowns of the chosen nodes prevent repeats
+        uint64_t hashAddr = addr.GetHash();
+        CSipHasher hasher = CSipHasher(base_hasher).Write(hashAddr << 32).Write((now + hashAddr) / (24 * 60 * 60));
+
+        // Relay reachable addresses to 2 peers. Unreachable addresses are relayed randomly to 1 or 2 peers.
+        const unsigned int nRelayNodes = (fReachable || (hasher.Finalize() & 1)) ? 2 : 1;
+        candidates.push_back(Candidate{&addr, hasher, nRelayNodes});
+    }
+    if (candidates.empty()) return;
+
+    auto sortfunc = [&candidates, &originator](CNode* pnode) {
+        if (!pnode->RelayAddrsWithConn() || pnode == &originator) return;
+        for (Candidate& cand : candidates) {
+            if (!pnode->IsAddrCompatible(*cand.addr)) continue;
+            uint64_t hashKey = CSipHasher(cand.hasher).Write(pnode->GetId()).Finalize();
+            for (unsigned int i = 0; i < cand.nRelayNodes; i++) {
+                 if (hashKey > cand.best[i].first) {
+                     std::copy(cand.best.begin() + i, cand.best.begin() + cand.nRelayNodes - 1, cand.best.begin() + i + 1);
+                     cand.best[i] = std::make_pair(hashKey, pnode);
                      break;
                  }
             }
         }
     };
 
-    auto pushfunc = [&addr, &best, nRelayNodes, &insecure_rand] {
-        for (unsigned int i = 0; i < nRelayNodes && best[i].first != 0; i++) {
-            best[i].second->PushAddress(addr, insecure_rand);
+    auto pushfunc = [&candidates] {
+        FastRandomContext& insecure_rand{ThreadLocalRng()};
+        for (const Candidate& cand : candidates) {
+            for (unsigned int i = 0; i < cand.nRelayNodes && cand.best[i].first != 0; i++) {
+                cand.best[i].second->PushAddress(*cand.addr, insecure_rand);
+            }
         }
     };
 
@@ -1534,7 +1788,7 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
     std::shared_ptr<const CBlockHeaderAndShortTxIDs> a_recent_compact_block;
     bool fWitnessesPresentInARecentCompactBlock;
     {
-        LOCK(cs_most_recent_block);
+        LOCK_SHARED(cs_most_recent_block);
         a_recent_block = most_recent_block;
         a_recent_compact_block = most_recent_compact_block;
         fWitnessesPresentInARecentCompactBlock = fWitnessesPresentInMostRecentCompactBlock;
@@ -1610,7 +1864,7 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
         // Don't set pblock as we've sent the block
     } else {
         // Send block from disk
-        std::shared_ptr<CBlock> pblockRead = std::make_shared<CBlock>();
+        std::shared_ptr<CBlock> pblockRead = GetRecycledBlock();
         if (!ReadBlockFromDisk(*pblockRead, pindex, m_chainparams.GetConsensus())) {
             assert(!"cannot load block from disk");
         }
@@ -1698,9 +1952,8 @@ CTransactionRef PeerManagerImpl::FindTxForGetData(const CNode& peer, const GenTx
         if (State(peer.GetId())->m_recently_announced_invs.contains(gtxid.GetHash())) {
             // If it was, it can be relayed from either the mempool...
             if (txinfo.tx) return std::move(txinfo.tx);
-            // ... or the relay pool.
-            auto mi = mapRelay.find(gtxid.GetHash());
-            if (mi != mapRelay.end()) return mi->second;
+            // ... or the recently-seen store.
+            return m_recent_tx_store.Find(gtxid.GetHash());
         }
     }
 
@@ -2442,7 +2695,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             if (fListen && !m_chainman.ActiveChainstate().IsInitialBlockDownload())
             {
                 CAddress addr = GetLocalAddress(&pfrom.addr, pfrom.GetLocalServices());
-                FastRandomContext insecure_rand;
+                FastRandomContext& insecure_rand{ThreadLocalRng()};
                 if (addr.IsRoutable())
                 {
                     LogPrint(BCLog::NET, "ProcessMessages: advertising address %s\n", addr.ToString());
@@ -2649,6 +2902,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
 
         // Store the new addresses
         std::vector<CAddress> vAddrOk;
+        std::vector<std::pair<CAddress, bool>> addrs_to_relay;
         int64_t nNow = GetAdjustedTime();
         int64_t nSince = nNow - 10 * 60;
         for (CAddress& addr : vAddr)
@@ -2672,13 +2926,15 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             bool fReachable = IsReachable(addr);
             if (addr.nTime > nSince && !pfrom.fGetAddr && vAddr.size() <= 10 && addr.IsRoutable())
             {
-                // Relay to a limited number of other nodes
-                RelayAddress(pfrom, addr, fReachable, m_connman);
+                // Relay to a limited number of other nodes, in one batched
+                // pass over the node list after this loop.
+                addrs_to_relay.emplace_back(addr, fReachable);
             }
             // Do not store addresses outside our network
             if (fReachable)
                 vAddrOk.push_back(addr);
         }
+        RelayAddresses(pfrom, addrs_to_relay, m_connman);
         m_connman.AddNewAddresses(vAddrOk, pfrom.addr, 2 * 60 * 60);
         if (vAddr.size() < 1000)
             pfrom.fGetAddr = false;
@@ -2808,7 +3064,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         {
             std::shared_ptr<const CBlock> a_recent_block;
             {
-                LOCK(cs_most_recent_block);
+                LOCK_SHARED(cs_most_recent_block);
                 a_recent_block = most_recent_block;
             }
             BlockValidationState state;
@@ -2860,7 +3116,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
 
         std::shared_ptr<const CBlock> recent_block;
         {
-            LOCK(cs_most_recent_block);
+            LOCK_SHARED(cs_most_recent_block);
             if (most_recent_block_hash == req.blockhash)
                 recent_block = most_recent_block;
             // Unlock cs_most_recent_block to avoid cs_main lock inversion
@@ -2945,10 +3201,35 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 pindex = m_chainman.ActiveChain().Next(pindex);
         }
 
+        LogPrint(BCLog::NET, "getheaders %d to %s from peer=%d\n", (pindex ? pindex->nHeight : -1), hashStop.IsNull() ? "end" : hashStop.ToString(), pfrom.GetId());
+
+        // Locator-based requests without a stop hash (the common case) ask
+        // for a contiguous active-chain range, which the flat headers file
+        // can provide as raw bytes: the response is then assembled with one
+        // bulk copy instead of re-serializing each header.
+        if (pindex && hashStop.IsNull() && m_chainman.ActiveChain().Contains(pindex)) {
+            const int start_height = pindex->nHeight;
+            const int count = std::min<int>(MAX_HEADERS_RESULTS, m_chainman.ActiveChain().Height() - start_height + 1);
+            std::vector<unsigned char> raw_headers;
+            if (g_headers_store.ReadRange(start_height, count, raw_headers)) {
+                nodestate->pindexBestHeaderSent = m_chainman.ActiveChain()[start_height + count - 1];
+                CSerializedNetMsg msg;
+                msg.m_type = NetMsgType::HEADERS;
+                CVectorWriter writer{SER_NETWORK, PROTOCOL_VERSION, msg.data, 0};
+                WriteCompactSize(writer, count);
+                for (int i = 0; i < count; ++i) {
+                    // each header is followed by the 0x00 nTx count
+                    writer.write((const char*)raw_headers.data() + i * FlatHeadersStore::HEADER_SIZE, FlatHeadersStore::HEADER_SIZE);
+                    writer << uint8_t{0};
+                }
+                m_connman.PushMessage(&pfrom, std::move(msg));
+                return;
+            }
+        }
+
         // we must use CBlocks, as CBlockHeaders won't include the 0x00 nTx count at the end
         std::vector<CBlock> vHeaders;
         int nLimit = MAX_HEADERS_RESULTS;
-        LogPrint(BCLog::NET, "getheaders %d to %s from peer=%d\n", (pindex ? pindex->nHeight : -1), hashStop.IsNull() ? "end" : hashStop.ToString(), pfrom.GetId());
         for (; pindex; pindex = m_chainman.ActiveChain().Next(pindex))
         {
             vHeaders.push_back(pindex->GetBlockHeader());
@@ -2983,8 +3264,13 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             return;
         }
 
-        CTransactionRef ptx;
-        vRecv >> ptx;
+        // The message payload is the serialized transaction; hash the bytes
+        // the deserializer consumes to obtain the witness hash directly,
+        // instead of reserializing the transaction through a stream.
+        const Span<const unsigned char> tx_bytes{MakeUCharSpan(vRecv)};
+        CMutableTransaction mtx(deserialize, vRecv);
+        const uint256 hash_from_wire{SerializeHashSpan(tx_bytes.first(tx_bytes.size() - vRecv.size()))};
+        const CTransactionRef ptx = std::make_shared<const CTransaction>(std::move(mtx), hash_from_wire);
         const CTransaction& tx = *ptx;
 
         const uint256& txid = ptx->GetHash();
@@ -3005,8 +3291,9 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             pfrom.AddKnownTx(txid);
         }
 
-        m_txrequest.ReceivedResponse(pfrom.GetId(), txid);
-        if (tx.HasWitness()) m_txrequest.ReceivedResponse(pfrom.GetId(), wtxid);
+        const auto tx_response_time = GetTime<std::chrono::microseconds>();
+        m_txrequest.ReceivedResponse(pfrom.GetId(), txid, tx_response_time);
+        if (tx.HasWitness()) m_txrequest.ReceivedResponse(pfrom.GetId(), wtxid, tx_response_time);
 
         // We do the AlreadyHaveTx() check using wtxid, rather than txid - in the
         // absence of witness malleation, this is strictly better, because the
@@ -3104,7 +3391,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 m_txrequest.ForgetTxHash(tx.GetWitnessHash());
 
                 // DoS prevention: do not allow m_orphanage to grow unbounded (see CVE-2012-3789)
-                unsigned int nMaxOrphanTx = (unsigned int)std::max((int64_t)0, gArgs.GetArg("-maxorphantx", DEFAULT_MAX_ORPHAN_TRANSACTIONS));
+                unsigned int nMaxOrphanTx = (unsigned int)std::max((int64_t)0, g_arg_max_orphan_tx.Get());
                 unsigned int nEvicted = m_orphanage.LimitOrphans(nMaxOrphanTx);
                 if (nEvicted > 0) {
                     LogPrint(BCLog::MEMPOOL, "orphanage overflow, removed %u tx\n", nEvicted);
@@ -3234,7 +3521,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
 
         // Keep a CBlock for "optimistic" compactblock reconstructions (see
         // below)
-        std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+        std::shared_ptr<CBlock> pblock = GetRecycledBlock();
         bool fBlockReconstructed = false;
 
         {
@@ -3297,7 +3584,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 }
 
                 PartiallyDownloadedBlock& partialBlock = *(*queuedBlockIt)->partialBlock;
-                ReadStatus status = partialBlock.InitData(cmpctblock, vExtraTxnForCompact);
+                ReadStatus status = partialBlock.InitData(cmpctblock, m_recent_tx_store.GetExtras());
                 if (status == READ_STATUS_INVALID) {
                     MarkBlockAsReceived(pindex->GetBlockHash()); // Reset in-flight state in case Misbehaving does not result in a disconnect
                     Misbehaving(pfrom.GetId(), 100, "invalid compact block");
@@ -3316,12 +3603,14 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                         req.indexes.push_back(i);
                 }
                 if (req.indexes.empty()) {
+                    ++nodestate->m_cmpctblock_no_roundtrip;
                     // Dirty hack to jump to BLOCKTXN code (TODO: move message handling into their own functions)
                     BlockTransactions txn;
                     txn.blockhash = cmpctblock.header.GetHash();
                     blockTxnMsg << txn;
                     fProcessBLOCKTXN = true;
                 } else {
+                    ++nodestate->m_cmpctblock_roundtrip;
                     req.blockhash = pindex->GetBlockHash();
                     m_connman.PushMessage(&pfrom, msgMaker.Make(NetMsgType::GETBLOCKTXN, req));
                 }
@@ -3332,7 +3621,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 // Optimistically try to reconstruct anyway since we might be
                 // able to without any round trips.
                 PartiallyDownloadedBlock tempBlock(&m_mempool);
-                ReadStatus status = tempBlock.InitData(cmpctblock, vExtraTxnForCompact);
+                ReadStatus status = tempBlock.InitData(cmpctblock, m_recent_tx_store.GetExtras());
                 if (status != READ_STATUS_OK) {
                     // TODO: don't ignore failures
                     return;
@@ -3340,7 +3629,13 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 std::vector<CTransactionRef> dummy;
                 status = tempBlock.FillBlock(*pblock, dummy);
                 if (status == READ_STATUS_OK) {
+                    ++nodestate->m_cmpctblock_no_roundtrip;
                     fBlockReconstructed = true;
+                    TRACE4(net, cmpctblock_reconstructed,
+                           pblock->GetHash().begin(),
+                           pfrom.GetId(),
+                           (uint64_t)pblock->vtx.size(),
+                           (uint64_t)0); // no round trip needed
                 }
             }
         } else {
@@ -3418,7 +3713,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         BlockTransactions resp;
         vRecv >> resp;
 
-        std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+        std::shared_ptr<CBlock> pblock = GetRecycledBlock();
         bool fBlockRead = false;
         {
             LOCK(cs_main);
@@ -3461,6 +3756,11 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 // updated, etc.
                 MarkBlockAsReceived(resp.blockhash); // it is now an empty pointer
                 fBlockRead = true;
+                TRACE4(net, cmpctblock_reconstructed,
+                       resp.blockhash.begin(),
+                       pfrom.GetId(),
+                       (uint64_t)pblock->vtx.size(),
+                       (uint64_t)resp.txn.size()); // transactions fetched via getblocktxn
                 // mapBlockSource is used for potentially punishing peers and
                 // updating which peers send us compact blocks, so the race
                 // between here and cs_main in ProcessNewBlock is fine.
@@ -3522,7 +3822,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             return;
         }
 
-        std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+        std::shared_ptr<CBlock> pblock = GetRecycledBlock();
         vRecv >> *pblock;
 
         LogPrint(BCLog::NET, "received block %s peer=%d\n", pblock->GetHash().ToString(), pfrom.GetId());
@@ -3569,14 +3869,14 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         }
         pfrom.fSentAddr = true;
 
-        pfrom.vAddrToSend.clear();
+        WITH_LOCK(pfrom.m_addr_send_mutex, pfrom.vAddrToSend.clear());
         std::vector<CAddress> vAddr;
         if (pfrom.HasPermission(PF_ADDR)) {
             vAddr = m_connman.GetAddresses(MAX_ADDR_TO_SEND, MAX_PCT_ADDR_TO_SEND);
         } else {
             vAddr = m_connman.GetAddresses(pfrom, MAX_ADDR_TO_SEND, MAX_PCT_ADDR_TO_SEND);
         }
-        FastRandomContext insecure_rand;
+        FastRandomContext& insecure_rand{ThreadLocalRng()};
         for (const CAddress &addr : vAddr) {
             pfrom.PushAddress(addr, insecure_rand);
         }
@@ -3788,7 +4088,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 if (inv.IsGenTxMsg()) {
                     // If we receive a NOTFOUND message for a tx we requested, mark the announcement for it as
                     // completed in TxRequestTracker.
-                    m_txrequest.ReceivedResponse(pfrom.GetId(), inv.hash);
+                    m_txrequest.ReceivedResponse(pfrom.GetId(), inv.hash, GetTime<std::chrono::microseconds>());
                 }
             }
         }
@@ -3890,7 +4190,7 @@ bool PeerManagerImpl::ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt
     }
     CNetMessage& msg(msgs.front());
 
-    if (gArgs.GetBoolArg("-capturemessages", false)) {
+    if (g_arg_capture_messages.Get()) {
         CaptureMessage(pfrom->addr, msg.m_command, MakeUCharSpan(msg.m_recv), /* incoming */ true);
     }
 
@@ -3901,12 +4201,30 @@ bool PeerManagerImpl::ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt
     unsigned int nMessageSize = msg.m_message_size;
 
     try {
+        const auto processing_start{std::chrono::steady_clock::now()};
         ProcessMessage(*pfrom, msg_type, msg.m_recv, msg.m_time, interruptMsgProc);
+        const auto duration{std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - processing_start)};
+        TRACE4(net, process_message,
+               pfrom->GetId(),
+               msg_type.c_str(),
+               static_cast<uint64_t>(msg.m_raw_message_size),
+               static_cast<uint64_t>(duration.count()));
+        {
+            LOCK(m_msg_stats_mutex);
+            MsgTypeStats& stats = m_msg_type_stats[msg_type];
+            stats.count++;
+            stats.bytes += msg.m_raw_message_size;
+            stats.total_time += duration;
+            stats.max_time = std::max(stats.max_time, duration);
+        }
         if (interruptMsgProc) return false;
         {
             LOCK(peer->m_getdata_requests_mutex);
             if (!peer->m_getdata_requests.empty()) fMoreWork = true;
         }
+        // The message has been fully handled; recycle its buffer for the
+        // next message received from this peer.
+        pfrom->ReturnRecvBuffer(std::move(msg.m_recv));
     } catch (const std::exception& e) {
         LogPrint(BCLog::NET, "%s(%s, %u bytes): Exception '%s' (%s) caught\n", __func__, SanitizeString(msg_type), nMessageSize, e.what(), typeid(e).name());
     } catch (...) {
@@ -4140,23 +4458,49 @@ void PeerManagerImpl::MaybeSendPing(CNode& node_to, Peer& peer)
     }
 }
 
+void PeerManagerImpl::UpdateRelayRankCache(std::chrono::microseconds now)
+{
+    AssertLockHeld(cs_main);
+    if (now < m_relay_rank_built + RELAY_RANK_CACHE_LIFETIME) return;
+
+    m_relay_rank.clear();
+    const auto ordered_hashes = m_mempool.GetRelayOrderedHashes();
+    m_relay_rank.reserve(2 * ordered_hashes.size());
+    uint64_t rank = 0;
+    for (const auto& [txid, wtxid] : ordered_hashes) {
+        // Key by both hashes so lookups work for txid and wtxid relay peers.
+        m_relay_rank.emplace(txid, rank);
+        m_relay_rank.emplace(wtxid, rank);
+        ++rank;
+    }
+    m_relay_rank_built = now;
+}
+
 namespace {
-class CompareInvMempoolOrder
+/** Orders announcement candidates for the trickle heap using the shared
+ *  relay-order rank cache: entries with the fewest ancestors/highest fee
+ *  (lowest rank) sort later, so std::make_heap pops them first. Hashes
+ *  absent from the cache (e.g. transactions accepted since the last rebuild,
+ *  or no longer in the mempool) are announced last, ordered by hash. */
+class CompareInvRank
 {
-    CTxMemPool *mp;
-    bool m_wtxid_relay;
-public:
-    explicit CompareInvMempoolOrder(CTxMemPool *_mempool, bool use_wtxid)
+    const std::unordered_map<uint256, uint64_t, SaltedTxidHasher>& m_rank;
+
+    uint64_t RankOf(const uint256& hash) const
     {
-        mp = _mempool;
-        m_wtxid_relay = use_wtxid;
+        const auto it = m_rank.find(hash);
+        return it == m_rank.end() ? std::numeric_limits<uint64_t>::max() : it->second;
     }
 
-    bool operator()(std::set<uint256>::iterator a, std::set<uint256>::iterator b)
+public:
+    explicit CompareInvRank(const std::unordered_map<uint256, uint64_t, SaltedTxidHasher>& rank) : m_rank(rank) {}
+
+    bool operator()(std::set<uint256>::iterator a, std::set<uint256>::iterator b) const
     {
-        /* As std::make_heap produces a max-heap, we want the entries with the
-         * fewest ancestors/highest fee to sort later. */
-        return mp->CompareDepthAndScore(*b, *a, m_wtxid_relay);
+        const uint64_t rank_a{RankOf(*a)};
+        const uint64_t rank_b{RankOf(*b)};
+        if (rank_a != rank_b) return rank_a > rank_b;
+        return *a < *b;
     }
 };
 }
@@ -4201,10 +4545,10 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
             // bandwidth cost that we can incur by doing this (which happens
             // once a day on average).
             if (pto->m_next_local_addr_send != 0us) {
-                pto->m_addr_known->reset();
+                WITH_LOCK(pto->m_addr_send_mutex, pto->m_addr_known->reset());
             }
             if (std::optional<CAddress> local_addr = GetLocalAddrForPeer(pto)) {
-                FastRandomContext insecure_rand;
+                FastRandomContext& insecure_rand{ThreadLocalRng()};
                 pto->PushAddress(*local_addr, insecure_rand);
             }
             pto->m_next_local_addr_send = PoissonNextSend(current_time, AVG_LOCAL_ADDRESS_BROADCAST_INTERVAL);
@@ -4215,6 +4559,9 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
         //
         if (pto->RelayAddrsWithConn() && pto->m_next_addr_send < current_time) {
             pto->m_next_addr_send = PoissonNextSend(current_time, AVG_ADDRESS_BROADCAST_INTERVAL);
+            // Hold the addr send lock for the whole drain: RelayAddresses may
+            // be pushing into vAddrToSend from another message handler thread.
+            LOCK(pto->m_addr_send_mutex);
             std::vector<CAddress> vAddr;
             vAddr.reserve(pto->vAddrToSend.size());
             assert(pto->m_addr_known);
@@ -4359,7 +4706,7 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
 
                     bool fGotBlockFromCache = false;
                     {
-                        LOCK(cs_most_recent_block);
+                        LOCK_SHARED(cs_most_recent_block);
                         if (most_recent_block_hash == pBestIndex->GetBlockHash()) {
                             if (state.fWantsCmpctWitness || !fWitnessesPresentInMostRecentCompactBlock)
                                 m_connman.PushMessage(pto, msgMaker.Make(nSendFlags, NetMsgType::CMPCTBLOCK, *most_recent_compact_block));
@@ -4499,7 +4846,11 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                     const CFeeRate filterrate{pto->m_tx_relay->minFeeFilter.load()};
                     // Topologically and fee-rate sort the inventory we send for privacy and priority reasons.
                     // A heap is used so that not all items need sorting if only a few are being sent.
-                    CompareInvMempoolOrder compareInvMempoolOrder(&m_mempool, state.m_wtxid_relay);
+                    // The ordering comes from the shared rank cache, so the
+                    // mempool-wide sort is computed once per refresh rather
+                    // than once per peer per trickle.
+                    UpdateRelayRankCache(current_time);
+                    const CompareInvRank compareInvMempoolOrder(m_relay_rank);
                     std::make_heap(vInvTx.begin(), vInvTx.end(), compareInvMempoolOrder);
                     // No reason to drain out at many times the network's capacity,
                     // especially since we have many peers and some will draw much shorter delays.
@@ -4524,7 +4875,6 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                             continue;
                         }
                         auto txid = txinfo.tx->GetHash();
-                        auto wtxid = txinfo.tx->GetWitnessHash();
                         // Peer told you to not send transactions at that feerate? Don't bother sending it.
                         if (txinfo.fee < filterrate.GetFee(txinfo.vsize)) {
                             continue;
@@ -4535,22 +4885,11 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                         vInv.push_back(inv);
                         nRelayedTransactions++;
                         {
-                            // Expire old relay messages
-                            while (!g_relay_expiration.empty() && g_relay_expiration.front().first < current_time)
-                            {
-                                mapRelay.erase(g_relay_expiration.front().second);
-                                g_relay_expiration.pop_front();
-                            }
-
-                            auto ret = mapRelay.emplace(txid, std::move(txinfo.tx));
-                            if (ret.second) {
-                                g_relay_expiration.emplace_back(current_time + RELAY_TX_CACHE_TIME, ret.first);
-                            }
-                            // Add wtxid-based lookup into mapRelay as well, so that peers can request by wtxid
-                            auto ret2 = mapRelay.emplace(wtxid, ret.first->second);
-                            if (ret2.second) {
-                                g_relay_expiration.emplace_back(current_time + RELAY_TX_CACHE_TIME, ret2.first);
-                            }
+                            // Expire old relay entries, then keep this one
+                            // available for getdata (by txid or wtxid) even if
+                            // it leaves the mempool in the meantime.
+                            m_recent_tx_store.Expire(current_time);
+                            m_recent_tx_store.InsertRelay(txinfo.tx, current_time + RELAY_TX_CACHE_TIME);
                         }
                         if (vInv.size() == MAX_INV_SZ) {
                             m_connman.PushMessage(pto, msgMaker.Make(NetMsgType::INV, vInv));
@@ -4674,7 +5013,7 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                     m_connman.PushMessage(pto, msgMaker.Make(NetMsgType::GETDATA, vGetData));
                     vGetData.clear();
                 }
-                m_txrequest.RequestedTx(pto->GetId(), gtxid.GetHash(), current_time + GETDATA_TX_INTERVAL);
+                m_txrequest.RequestedTx(pto->GetId(), gtxid.GetHash(), current_time + m_getdata_tx_interval, current_time);
             } else {
                 // We have already seen this transaction, no need to download. This is just a belt-and-suspenders, as
                 // this should already be called whenever a transaction becomes AlreadyHaveTx().
@@ -4689,10 +5028,10 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
         //
         // Message: feefilter
         //
-        if (pto->m_tx_relay != nullptr && pto->GetCommonVersion() >= FEEFILTER_VERSION && gArgs.GetBoolArg("-feefilter", DEFAULT_FEEFILTER) &&
+        if (pto->m_tx_relay != nullptr && pto->GetCommonVersion() >= FEEFILTER_VERSION && g_arg_feefilter.Get() &&
             !pto->HasPermission(PF_FORCERELAY) // peers with the forcerelay permission should not filter txs to us
         ) {
-            CAmount currentFilter = m_mempool.GetMinFee(gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000).GetFeePerK();
+            CAmount currentFilter = m_mempool.GetMinFee(g_arg_max_mempool.Get() * 1000000).GetFeePerK();
             static FeeFilterRounder g_filter_rounder{CFeeRate{DEFAULT_MIN_RELAY_TX_FEE}};
             if (m_chainman.ActiveChainstate().IsInitialBlockDownload()) {
                 // Received tx-inv messages are discarded when the active
@@ -8,6 +8,7 @@
 
 #include <net.h>
 #include <sync.h>
+#include <txrequest.h>
 #include <validationinterface.h>
 
 class CChainParams;
@@ -31,6 +32,22 @@ struct CNodeStateStats {
     int m_starting_height = -1;
     std::chrono::microseconds m_ping_wait;
     std::vector<int> vHeightInFlight;
+    //! Compact blocks from this peer we reconstructed without a getblocktxn round trip.
+    uint64_t m_cmpctblock_no_roundtrip = 0;
+    //! Compact blocks from this peer that needed a getblocktxn round trip.
+    uint64_t m_cmpctblock_roundtrip = 0;
+    //! Transaction request tracker statistics for this peer.
+    TxRequestTracker::PeerStats m_txrequest;
+};
+
+/** Cumulative cost of processing one P2P message type */
+struct MsgTypeStats {
+    uint64_t count{0};
+    //! Wire bytes of processed messages, including header and checksum
+    uint64_t bytes{0};
+    std::chrono::microseconds total_time{0};
+    //! Largest single-message processing time
+    std::chrono::microseconds max_time{0};
 };
 
 class PeerManager : public CValidationInterface, public NetEventsInterface
@@ -44,6 +61,9 @@ public:
     /** Get statistics from node state */
     virtual bool GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) = 0;
 
+    /** Get cumulative per-message-type processing statistics, keyed by message type */
+    virtual std::map<std::string, MsgTypeStats> GetMessageTypeStats() const = 0;
+
     /** Whether this node ignores txs received over p2p. */
     virtual bool IgnoresIncomingTxs() = 0;
 
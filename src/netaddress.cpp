@@ -1196,6 +1196,18 @@ std::string CSubNet::ToString() const
     return network.ToString() + suffix;
 }
 
+bool CSubNet::IsSingleIP() const
+{
+    if (!valid) return false;
+    // Non-IP networks (Tor, I2P, CJDNS) can only be constructed as
+    // single-host subnets.
+    if (!network.IsIPv4() && !network.IsIPv6()) return true;
+    for (size_t i = 0; i < network.m_addr.size(); ++i) {
+        if (netmask[i] != 0xFF) return false;
+    }
+    return true;
+}
+
 bool CSubNet::IsValid() const
 {
     return valid;
@@ -523,6 +523,8 @@ class CSubNet
 
         std::string ToString() const;
         bool IsValid() const;
+        /** Whether this subnet contains exactly one address. */
+        bool IsSingleIP() const;
 
         friend bool operator==(const CSubNet& a, const CSubNet& b);
         friend bool operator!=(const CSubNet& a, const CSubNet& b) { return !(a == b); }
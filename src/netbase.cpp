@@ -12,12 +12,14 @@
 #include <util/strencodings.h>
 #include <util/string.h>
 #include <util/system.h>
+#include <util/threadnames.h>
 #include <util/time.h>
 
 #include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <limits>
 #include <memory>
 
@@ -194,6 +196,18 @@ bool LookupHost(const std::string& name, CNetAddr& addr, bool fAllowLookup, DNSL
     return true;
 }
 
+std::future<std::vector<CNetAddr>> LookupHostAsync(const std::string& name, unsigned int nMaxSolutions, bool fAllowLookup, DNSLookupFn dns_lookup_function)
+{
+    return std::async(std::launch::async, [name, nMaxSolutions, fAllowLookup, dns_lookup_function] {
+        util::ThreadRename("dnsres");
+        std::vector<CNetAddr> ips;
+        if (!LookupHost(name, ips, nMaxSolutions, fAllowLookup, dns_lookup_function)) {
+            ips.clear();
+        }
+        return ips;
+    });
+}
+
 bool Lookup(const std::string& name, std::vector<CService>& vAddr, uint16_t portDefault, bool fAllowLookup, unsigned int nMaxSolutions, DNSLookupFn dns_lookup_function)
 {
     if (name.empty() || !ValidAsCString(name)) {
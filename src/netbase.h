@@ -15,6 +15,7 @@
 #include <util/sock.h>
 
 #include <functional>
+#include <future>
 #include <memory>
 #include <stdint.h>
 #include <string>
@@ -124,6 +125,17 @@ bool LookupHost(const std::string& name, std::vector<CNetAddr>& vIP, unsigned in
  */
 bool LookupHost(const std::string& name, CNetAddr& addr, bool fAllowLookup, DNSLookupFn dns_lookup_function = g_dns_lookup);
 
+/**
+ * Resolve a host string on a background thread, so callers can issue several
+ * lookups concurrently or keep working while a slow resolver responds.
+ *
+ * @returns A future yielding the resolved addresses; empty on failure.
+ *
+ * @see LookupHost(const std::string&, std::vector<CNetAddr>&, uint16_t, bool, DNSLookupFn)
+ *      for parameter descriptions.
+ */
+std::future<std::vector<CNetAddr>> LookupHostAsync(const std::string& name, unsigned int nMaxSolutions, bool fAllowLookup, DNSLookupFn dns_lookup_function = g_dns_lookup);
+
 /**
  * Resolve a service string to its corresponding service.
  *
@@ -8,6 +8,7 @@
 #include <coins.h>
 #include <crypto/muhash.h>
 #include <hash.h>
+#include <index/coinstatsindex.h>
 #include <serialize.h>
 #include <uint256.h>
 #include <util/system.h>
@@ -15,7 +16,7 @@
 
 #include <map>
 
-static uint64_t GetBogoSize(const CScript& scriptPubKey)
+uint64_t GetBogoSize(const CScript& scriptPubKey)
 {
     return 32 /* txid */ +
            4 /* vout index */ +
@@ -25,6 +26,14 @@ static uint64_t GetBogoSize(const CScript& scriptPubKey)
            scriptPubKey.size() /* scriptPubKey */;
 }
 
+CDataStream TxOutSer(const COutPoint& outpoint, const Coin& coin) {
+    CDataStream ss(SER_DISK, PROTOCOL_VERSION);
+    ss << outpoint;
+    ss << static_cast<uint32_t>(coin.nHeight * 2 + coin.fCoinBase);
+    ss << coin.out;
+    return ss;
+}
+
 static void ApplyHash(CCoinsStats& stats, CHashWriter& ss, const uint256& hash, const std::map<uint32_t, Coin>& outputs, std::map<uint32_t, Coin>::const_iterator it)
 {
     if (it == outputs.begin()) {
@@ -47,12 +56,7 @@ static void ApplyHash(CCoinsStats& stats, MuHash3072& muhash, const uint256& has
 {
     COutPoint outpoint = COutPoint(hash, it->first);
     Coin coin = it->second;
-
-    CDataStream ss(SER_DISK, PROTOCOL_VERSION);
-    ss << outpoint;
-    ss << static_cast<uint32_t>(coin.nHeight * 2 + coin.fCoinBase);
-    ss << coin.out;
-    muhash.Insert(MakeUCharSpan(ss));
+    muhash.Insert(MakeUCharSpan(TxOutSer(outpoint, coin)));
 }
 
 //! Warning: be very careful when changing this! assumeutxo and UTXO snapshot
@@ -129,6 +133,19 @@ static bool GetUTXOStats(CCoinsView* view, BlockManager& blockman, CCoinsStats&
 
 bool GetUTXOStats(CCoinsView* view, BlockManager& blockman, CCoinsStats& stats, CoinStatsHashType hash_type, const std::function<void()>& interruption_point)
 {
+    // If the coinstats index is available and caught up, the muhash and the
+    // aggregate totals can be looked up in O(1) instead of scanning the
+    // entire chainstate. Fall through to the scan if the index cannot serve
+    // the request (e.g. while it is still syncing).
+    if (hash_type == CoinStatsHashType::MUHASH && g_coin_stats_index && g_coin_stats_index->BlockUntilSyncedToCurrentChain()) {
+        stats = CCoinsStats();
+        const CBlockIndex* pindex = WITH_LOCK(cs_main, return blockman.LookupBlockIndex(view->GetBestBlock()));
+        if (pindex && g_coin_stats_index->LookUpStats(pindex, stats)) {
+            stats.index_used = true;
+            return true;
+        }
+    }
+
     switch (hash_type) {
     case(CoinStatsHashType::HASH_SERIALIZED): {
         CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
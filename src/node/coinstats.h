@@ -7,6 +7,7 @@
 #define BITCOIN_NODE_COINSTATS_H
 
 #include <amount.h>
+#include <streams.h>
 #include <uint256.h>
 #include <validation.h>
 
@@ -14,6 +15,9 @@
 #include <functional>
 
 class CCoinsView;
+class Coin;
+class COutPoint;
+class CScript;
 
 enum class CoinStatsHashType {
     HASH_SERIALIZED,
@@ -34,9 +38,16 @@ struct CCoinsStats
 
     //! The number of coins contained.
     uint64_t coins_count{0};
+
+    //! Signals if the coinstatsindex was used to retrieve the statistics.
+    bool index_used{false};
 };
 
 //! Calculate statistics about the unspent transaction output set
 bool GetUTXOStats(CCoinsView* view, BlockManager& blockman, CCoinsStats& stats, const CoinStatsHashType hash_type, const std::function<void()>& interruption_point = {});
 
+uint64_t GetBogoSize(const CScript& script_pub_key);
+
+CDataStream TxOutSer(const COutPoint& outpoint, const Coin& coin);
+
 #endif // BITCOIN_NODE_COINSTATS_H
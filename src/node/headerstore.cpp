@@ -0,0 +1,135 @@
+// Copyright (c) 2021 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/headerstore.h>
+
+#include <chain.h>
+#include <clientversion.h>
+#include <logging.h>
+#include <streams.h>
+#include <util/system.h>
+#include <version.h>
+
+FlatHeadersStore g_headers_store;
+
+FlatHeadersStore::~FlatHeadersStore()
+{
+    Close();
+}
+
+bool FlatHeadersStore::Open(const fs::path& path)
+{
+    LOCK(m_mutex);
+    assert(!m_file);
+    m_file = fsbridge::fopen(path, "rb+");
+    if (!m_file) m_file = fsbridge::fopen(path, "wb+");
+    if (!m_file) {
+        LogPrintf("Unable to open headers file %s; continuing without it\n", path.string());
+        return false;
+    }
+    if (fseek(m_file, 0, SEEK_END) != 0) {
+        fclose(m_file);
+        m_file = nullptr;
+        return false;
+    }
+    m_count = ftell(m_file) / HEADER_SIZE;
+    return true;
+}
+
+void FlatHeadersStore::Close()
+{
+    LOCK(m_mutex);
+    if (m_file) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+    m_count = 0;
+}
+
+bool FlatHeadersStore::WriteAt(int64_t index, const CBlockHeader& header)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << header;
+    assert(ss.size() == HEADER_SIZE);
+    if (fseek(m_file, index * HEADER_SIZE, SEEK_SET) != 0) return false;
+    return fwrite(ss.data(), HEADER_SIZE, 1, m_file) == 1;
+}
+
+void FlatHeadersStore::SyncToChain(const CChain& chain)
+{
+    LOCK(m_mutex);
+    if (!m_file) return;
+    const int chain_height = chain.Height();
+
+    // One sequential pass over the file: each record must link to the
+    // previous one by hashPrevBlock, and the last one must be the tip.
+    bool matches = chain_height >= 0 && m_count == chain_height + 1;
+    if (matches) {
+        fseek(m_file, 0, SEEK_SET);
+        uint256 prev_hash; // null, matched by the genesis header
+        std::vector<unsigned char> buf(HEADER_SIZE);
+        for (int64_t i = 0; i < m_count; ++i) {
+            if (fread(buf.data(), HEADER_SIZE, 1, m_file) != 1) {
+                matches = false;
+                break;
+            }
+            CBlockHeader header;
+            VectorReader(SER_DISK, CLIENT_VERSION, buf, 0) >> header;
+            if (header.hashPrevBlock != prev_hash) {
+                matches = false;
+                break;
+            }
+            prev_hash = header.GetHash();
+        }
+        if (matches && prev_hash != chain.Tip()->GetBlockHash()) matches = false;
+    }
+    if (matches) {
+        LogPrintf("Verified %d headers in flat headers file\n", (int)m_count);
+        return;
+    }
+
+    LogPrintf("Rebuilding flat headers file for %d blocks\n", chain_height + 1);
+    TruncateFile(m_file, 0);
+    m_count = 0;
+    for (int height = 0; height <= chain_height; ++height) {
+        if (!WriteAt(height, chain[height]->GetBlockHeader())) {
+            LogPrintf("Failed to write headers file; continuing without it\n");
+            fclose(m_file);
+            m_file = nullptr;
+            m_count = 0;
+            return;
+        }
+        m_count = height + 1;
+    }
+    fflush(m_file);
+}
+
+void FlatHeadersStore::Append(int height, const CBlockHeader& header)
+{
+    LOCK(m_mutex);
+    if (!m_file) return;
+    if (height < 0 || height > m_count) return; // would leave a gap; startup sync will repair
+    if (height < m_count) {
+        if (!TruncateFile(m_file, height * HEADER_SIZE)) return;
+        m_count = height;
+    }
+    if (WriteAt(height, header)) m_count = height + 1;
+}
+
+void FlatHeadersStore::TruncateTo(int64_t count)
+{
+    LOCK(m_mutex);
+    if (!m_file || count < 0 || count >= m_count) return;
+    if (TruncateFile(m_file, count * HEADER_SIZE)) m_count = count;
+}
+
+bool FlatHeadersStore::ReadRange(int start_height, int count, std::vector<unsigned char>& out) const
+{
+    LOCK(m_mutex);
+    if (!m_file || start_height < 0 || count <= 0) return false;
+    if (start_height + (int64_t)count > m_count) return false;
+    out.resize(count * HEADER_SIZE);
+    if (fseek(m_file, start_height * (int64_t)HEADER_SIZE, SEEK_SET) != 0) return false;
+    return fread(out.data(), HEADER_SIZE, count, m_file) == (size_t)count;
+}
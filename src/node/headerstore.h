@@ -0,0 +1,75 @@
+// Copyright (c) 2021 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_HEADERSTORE_H
+#define BITCOIN_NODE_HEADERSTORE_H
+
+#include <fs.h>
+#include <primitives/block.h>
+#include <sync.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+class CChain;
+
+/**
+ * Flat append-only file of the active chain's block headers.
+ *
+ * The file holds one 80-byte serialized header per height, nothing else, so
+ * a contiguous range of headers is a contiguous range of bytes: serving a
+ * 2000-header getheaders response becomes a bounds-checked bulk read instead
+ * of reconstructing and re-serializing each header from the block index.
+ *
+ * The file is maintained as the active tip moves (appended on connect,
+ * truncated on disconnect) and verified against the active chain in one
+ * sequential pass at startup, rebuilding it when it does not match. The
+ * block tree database remains the authoritative store; losing or corrupting
+ * this file only costs the rebuild.
+ *
+ * All methods are no-ops until Open() has succeeded, so callers need not
+ * care whether the store is available.
+ */
+class FlatHeadersStore
+{
+private:
+    mutable Mutex m_mutex;
+    FILE* m_file GUARDED_BY(m_mutex){nullptr};
+    //! Number of headers in the file; the file is exactly m_count * 80 bytes.
+    int64_t m_count GUARDED_BY(m_mutex){0};
+
+    bool WriteAt(int64_t index, const CBlockHeader& header) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+public:
+    //! Serialized size of a block header, in the file and on the wire.
+    static constexpr size_t HEADER_SIZE{80};
+
+    ~FlatHeadersStore();
+
+    //! Open or create the file. Returns false (leaving the store disabled)
+    //! if the file cannot be opened.
+    bool Open(const fs::path& path);
+    void Close();
+
+    //! Verify the file against the active chain by walking it once, checking
+    //! prev-hash linkage and that it ends at the chain tip; rebuild it from
+    //! the chain when it does not match.
+    void SyncToChain(const CChain& chain);
+
+    //! Record the header at the given height, dropping any stale entries
+    //! above it first. Ignored if it would leave a gap below.
+    void Append(int height, const CBlockHeader& header);
+
+    //! Drop all headers at height >= count (tip disconnected).
+    void TruncateTo(int64_t count);
+
+    //! Copy the raw bytes of count consecutive headers starting at
+    //! start_height into out. Fails unless the whole range is present.
+    bool ReadRange(int start_height, int count, std::vector<unsigned char>& out) const;
+};
+
+extern FlatHeadersStore g_headers_store;
+
+#endif // BITCOIN_NODE_HEADERSTORE_H
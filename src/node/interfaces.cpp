@@ -128,6 +128,33 @@ public:
         }
         return false;
     }
+    bool getNodesStatsDelta(const std::map<NodeId, uint64_t>& known, NodesStats& stats, std::vector<NodeId>& disconnected) override
+    {
+        stats.clear();
+        disconnected.clear();
+
+        if (!m_context->connman) return false;
+
+        std::vector<CNodeStats> stats_temp;
+        m_context->connman->GetNodeStats(stats_temp, known, disconnected);
+
+        stats.reserve(stats_temp.size());
+        for (auto& node_stats_temp : stats_temp) {
+            stats.emplace_back(std::move(node_stats_temp), false, CNodeStateStats());
+        }
+
+        // Try to retrieve the CNodeStateStats for each node.
+        if (m_context->peerman) {
+            TRY_LOCK(::cs_main, lockMain);
+            if (lockMain) {
+                for (auto& node_stats : stats) {
+                    std::get<1>(node_stats) =
+                        m_context->peerman->GetNodeStateStats(std::get<0>(node_stats).nodeid, std::get<2>(node_stats));
+                }
+            }
+        }
+        return true;
+    }
     bool getBanned(banmap_t& banmap) override
     {
         if (m_context->banman) {
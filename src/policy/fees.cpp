@@ -479,6 +479,7 @@ bool CBlockPolicyEstimator::removeTx(uint256 hash, bool inBlock)
         shortStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         longStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         mapMemPoolTxs.erase(hash);
+        m_data_epoch.fetch_add(1, std::memory_order_release);
         return true;
     } else {
         return false;
@@ -552,6 +553,7 @@ void CBlockPolicyEstimator::processTransaction(const CTxMemPoolEntry& entry, boo
     assert(bucketIndex == bucketIndex2);
     unsigned int bucketIndex3 = longStats->NewTx(txHeight, (double)feeRate.GetFeePerK());
     assert(bucketIndex == bucketIndex3);
+    m_data_epoch.fetch_add(1, std::memory_order_release);
 }
 
 bool CBlockPolicyEstimator::processBlockTx(unsigned int nBlockHeight, const CTxMemPoolEntry* entry)
@@ -628,6 +630,7 @@ void CBlockPolicyEstimator::processBlock(unsigned int nBlockHeight,
 
     trackedTxs = 0;
     untrackedTxs = 0;
+    m_data_epoch.fetch_add(1, std::memory_order_release);
 }
 
 CFeeRate CBlockPolicyEstimator::estimateFee(int confTarget) const
@@ -785,6 +788,26 @@ double CBlockPolicyEstimator::estimateConservativeFee(unsigned int doubleTarget,
  */
 CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
 {
+    // Estimates only change when the underlying data does, so answers are
+    // cached per target and tagged with the data epoch they were computed
+    // at. Steady-state queries (no detailed calculation requested, data
+    // unchanged) are a single lock-free read. The epoch is sampled before
+    // any computation, so an entry stored after a concurrent mutation is
+    // tagged stale and recomputed on the next query.
+    constexpr uint64_t RATE_MASK = (uint64_t{1} << SMARTFEE_CACHE_RATE_BITS) - 1;
+    constexpr uint64_t EPOCH_MASK = (uint64_t{1} << (64 - SMARTFEE_CACHE_RATE_BITS)) - 1;
+
+    std::atomic<uint64_t>* cache_entry{nullptr};
+    const uint64_t epoch = m_data_epoch.load(std::memory_order_acquire);
+    if (feeCalc == nullptr && confTarget >= 1 && confTarget <= MAX_CACHED_SMARTFEE_TARGET) {
+        cache_entry = &m_smart_fee_cache[2 * confTarget + (conservative ? 1 : 0)];
+        const uint64_t packed = cache_entry->load(std::memory_order_acquire);
+        if (packed != 0 && (packed >> SMARTFEE_CACHE_RATE_BITS) == (epoch & EPOCH_MASK)) {
+            return CFeeRate(static_cast<CAmount>(packed & RATE_MASK));
+        }
+    }
+
+    const CFeeRate ret = [&]() -> CFeeRate {
     LOCK(m_cs_fee_estimator);
 
     if (feeCalc) {
@@ -859,15 +882,39 @@ CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation
     if (median < 0) return CFeeRate(0); // error condition
 
     return CFeeRate(llround(median));
+    }();
+
+    if (cache_entry) {
+        const CAmount rate = ret.GetFeePerK();
+        if (rate >= 0 && static_cast<uint64_t>(rate) <= RATE_MASK) {
+            cache_entry->store(((epoch & EPOCH_MASK) << SMARTFEE_CACHE_RATE_BITS) | static_cast<uint64_t>(rate),
+                               std::memory_order_release);
+        }
+    }
+    return ret;
 }
 
 void CBlockPolicyEstimator::Flush() {
     FlushUnconfirmed();
+    FlushFeeEstimates();
+}
 
+void CBlockPolicyEstimator::FlushFeeEstimates()
+{
+    // Write to a temporary file and rename it over the previous one, so that
+    // a crash mid-write cannot destroy the last good estimates.
     fs::path est_filepath = GetDataDir() / FEE_ESTIMATES_FILENAME;
-    CAutoFile est_file(fsbridge::fopen(est_filepath, "wb"), SER_DISK, CLIENT_VERSION);
-    if (est_file.IsNull() || !Write(est_file)) {
-        LogPrintf("Failed to write fee estimates to %s. Continue anyway.\n", est_filepath.string());
+    fs::path tmp_filepath = est_filepath;
+    tmp_filepath += ".new";
+    {
+        CAutoFile est_file(fsbridge::fopen(tmp_filepath, "wb"), SER_DISK, CLIENT_VERSION);
+        if (est_file.IsNull() || !Write(est_file) || !FileCommit(est_file.Get())) {
+            LogPrintf("Failed to write fee estimates to %s. Continue anyway.\n", tmp_filepath.string());
+            return;
+        }
+    }
+    if (!RenameOver(tmp_filepath, est_filepath)) {
+        LogPrintf("Failed to rename %s to %s. Continue anyway.\n", tmp_filepath.string(), est_filepath.string());
     }
 }
 
@@ -949,6 +996,7 @@ bool CBlockPolicyEstimator::Read(CAutoFile& filein)
             nBestSeenHeight = nFileBestSeenHeight;
             historicalFirst = nFileHistoricalFirst;
             historicalBest = nFileHistoricalBest;
+            m_data_epoch.fetch_add(1, std::memory_order_release);
         }
     }
     catch (const std::exception& e) {
@@ -12,12 +12,17 @@
 #include <sync.h>
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 class CAutoFile;
+
+/** Interval between scheduled flushes of the fee estimates file. */
+static constexpr std::chrono::hours FEE_FLUSH_INTERVAL{1};
 class CFeeRate;
 class CTxMemPoolEntry;
 class CTxMemPool;
@@ -225,6 +230,12 @@ public:
     /** Drop still unconfirmed transactions and record current estimations, if the fee estimation file is present. */
     void Flush();
 
+    /** Record current fee estimations to the fee estimation file, without
+     * touching the still unconfirmed transactions. Cheap enough to run
+     * periodically from the scheduler so estimates survive an unclean
+     * shutdown and the next start is warm. */
+    void FlushFeeEstimates();
+
 private:
     mutable RecursiveMutex m_cs_fee_estimator;
 
@@ -254,6 +265,22 @@ private:
     std::vector<double> buckets GUARDED_BY(m_cs_fee_estimator); // The upper-bound of the range for the bucket (inclusive)
     std::map<double, unsigned int> bucketMap GUARDED_BY(m_cs_fee_estimator); // Map of bucket upper-bound to index into all vectors by bucket
 
+    /** Highest confirmation target estimateSmartFee caches answers for. */
+    static constexpr int MAX_CACHED_SMARTFEE_TARGET{1008};
+    /** Bits of a cache entry holding the feerate (in sat/kvB); the remaining
+     *  high bits hold the epoch the entry was computed at. */
+    static constexpr int SMARTFEE_CACHE_RATE_BITS{40};
+
+    /** Generation counter of the estimation data, bumped by every mutation
+     *  (new transaction, removal, connected block, loaded file). Cache
+     *  entries tagged with an older epoch are recomputed. */
+    mutable std::atomic<uint64_t> m_data_epoch{1};
+
+    /** Per-(target, conservative) estimateSmartFee answers, packed as
+     *  [epoch | feerate] in a single word so steady-state queries are
+     *  lock-free reads. Zero means empty. */
+    mutable std::array<std::atomic<uint64_t>, 2 * (MAX_CACHED_SMARTFEE_TARGET + 1)> m_smart_fee_cache{};
+
     /** Process a transaction confirmed in a block*/
     bool processBlockTx(unsigned int nBlockHeight, const CTxMemPoolEntry* entry) EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
 
@@ -52,6 +52,21 @@ bool IsDust(const CTxOut& txout, const CFeeRate& dustRelayFeeIn)
 
 bool IsStandard(const CScript& scriptPubKey, TxoutType& whichType)
 {
+    // The canonical output types settle without materializing solver
+    // solutions: of the types the fast classifier can return, only NULL_DATA
+    // needs a further (size) check here, since bare multisig is never
+    // canonical.
+    if (const auto quick_type = ClassifyCanonicalOutput(scriptPubKey)) {
+        whichType = *quick_type;
+        if (whichType == TxoutType::NONSTANDARD) {
+            return false;
+        } else if (whichType == TxoutType::NULL_DATA &&
+                   (!fAcceptDatacarrier || scriptPubKey.size() > nMaxDatacarrierBytes)) {
+            return false;
+        }
+        return true;
+    }
+
     std::vector<std::vector<unsigned char> > vSolutions;
     whichType = Solver(scriptPubKey, vSolutions);
 
@@ -161,12 +176,26 @@ bool AreInputsStandard(const CTransaction& tx, const CCoinsViewCache& mapInputs,
     if (tx.IsCoinBase())
         return true; // Coinbases don't use vin normally
 
+    // Gather the prevouts in one pass over the view before inspecting any of
+    // them, then classify with the solutions-free fast path; only P2SH spends
+    // need the scriptSig evaluated.
+    std::vector<const CTxOut*> prevouts;
+    prevouts.reserve(tx.vin.size());
+    for (const CTxIn& txin : tx.vin) {
+        prevouts.push_back(&mapInputs.AccessCoin(txin.prevout).out);
+    }
+
     for (unsigned int i = 0; i < tx.vin.size(); i++)
     {
-        const CTxOut& prev = mapInputs.AccessCoin(tx.vin[i].prevout).out;
-
-        std::vector<std::vector<unsigned char> > vSolutions;
-        TxoutType whichType = Solver(prev.scriptPubKey, vSolutions);
+        const CTxOut& prev = *prevouts[i];
+
+        TxoutType whichType;
+        if (const auto quick_type = ClassifyCanonicalOutput(prev.scriptPubKey)) {
+            whichType = *quick_type;
+        } else {
+            std::vector<std::vector<unsigned char> > vSolutions;
+            whichType = Solver(prev.scriptPubKey, vSolutions);
+        }
         if (whichType == TxoutType::NONSTANDARD || whichType == TxoutType::WITNESS_UNKNOWN) {
             // WITNESS_UNKNOWN failures are typically also caught with a policy
             // flag in the script interpreter, but it can be helpful to catch
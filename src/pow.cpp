@@ -73,19 +73,63 @@ unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nF
 
 bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params& params)
 {
-    bool fNegative;
-    bool fOverflow;
-    arith_uint256 bnTarget;
-
-    bnTarget.SetCompact(nBits, &fNegative, &fOverflow);
-
-    // Check range
-    if (fNegative || bnTarget == 0 || fOverflow || bnTarget > UintToArith256(params.powLimit))
-        return false;
+    // nBits is constant across each 2016-block retarget period, so cache the
+    // expanded and range-checked target of the last valid nBits seen; header
+    // validation then reduces to a single 256-bit compare in the common
+    // case. Keyed on the PoW limit as well because unit tests check headers
+    // against several chains from one thread. Invalid nBits are never
+    // cached.
+    static thread_local unsigned int cached_bits;
+    static thread_local uint256 cached_pow_limit;
+    static thread_local arith_uint256 cached_target;
+    static thread_local bool have_cached{false};
+
+    if (!have_cached || nBits != cached_bits || params.powLimit != cached_pow_limit) {
+        bool fNegative;
+        bool fOverflow;
+        arith_uint256 bnTarget;
+
+        bnTarget.SetCompact(nBits, &fNegative, &fOverflow);
+
+        // Check range
+        if (fNegative || bnTarget == 0 || fOverflow || bnTarget > UintToArith256(params.powLimit))
+            return false;
+
+        cached_bits = nBits;
+        cached_pow_limit = params.powLimit;
+        cached_target = bnTarget;
+        have_cached = true;
+    }
 
     // Check proof of work matches claimed amount
-    if (UintToArith256(hash) > bnTarget)
+    if (UintToArith256(hash) > cached_target)
         return false;
 
     return true;
 }
+
+bool CheckHeadersProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params& params)
+{
+    bool fNegative;
+    bool fOverflow;
+    arith_uint256 bnTarget;
+    const arith_uint256 bnPowLimit = UintToArith256(params.powLimit);
+    // Within a retarget period all headers carry the same nBits, so a full
+    // 2000-header message needs at most two compact expansions.
+    unsigned int nBitsCached{0};
+    bool fHaveCached{false};
+
+    for (const CBlockHeader& header : headers) {
+        if (!fHaveCached || header.nBits != nBitsCached) {
+            bnTarget.SetCompact(header.nBits, &fNegative, &fOverflow);
+            if (fNegative || bnTarget == 0 || fOverflow || bnTarget > bnPowLimit)
+                return false;
+            nBitsCached = header.nBits;
+            fHaveCached = true;
+        }
+        if (UintToArith256(header.GetHash()) > bnTarget)
+            return false;
+    }
+
+    return true;
+}
@@ -9,6 +9,7 @@
 #include <consensus/params.h>
 
 #include <stdint.h>
+#include <vector>
 
 class CBlockHeader;
 class CBlockIndex;
@@ -20,4 +21,12 @@ unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nF
 /** Check whether a block hash satisfies the proof-of-work requirement specified by nBits */
 bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params&);
 
+/**
+ * Check the proof-of-work of a batch of headers at once, expanding each
+ * distinct compact target only once. This does not check that the nBits
+ * values themselves are the consensus-correct ones (that requires the block
+ * index and is done contextually per header).
+ */
+bool CheckHeadersProofOfWork(const std::vector<CBlockHeader>& headers, const Consensus::Params&);
+
 #endif // BITCOIN_POW_H
@@ -198,6 +198,20 @@ private:
         }
     }
 
+    //! Capacity to allocate when growing to hold new_size elements. Grows
+    //! geometrically (x1.5), but the first heap allocation jumps straight to
+    //! a 64-byte allocator bucket: the dominant prevector user is CScript
+    //! (N=28, T=unsigned char), and nearly all scripts that outgrow the
+    //! direct slots fit in 64 bytes, so this saves a realloc per script
+    //! while requesting no more than the allocator would round up to anyway.
+    size_type grown_capacity(size_type new_size) const {
+        size_type new_capacity = new_size + (new_size >> 1);
+        if (sizeof(T) * new_capacity < 64) {
+            new_capacity = 64 / sizeof(T);
+        }
+        return new_capacity;
+    }
+
     T* item_ptr(difference_type pos) { return is_direct() ? direct_ptr(pos) : indirect_ptr(pos); }
     const T* item_ptr(difference_type pos) const { return is_direct() ? direct_ptr(pos) : indirect_ptr(pos); }
 
@@ -214,6 +228,20 @@ private:
         }
     }
 
+    //! Overload picked for prevector's own contiguous iterators (copy
+    //! construction and assignment): for trivially copyable T the
+    //! element-wise loop collapses into one memcpy, which the compiler
+    //! expands to vectorized bulk moves.
+    void fill(T* dst, const_iterator first, const_iterator last) {
+        const ptrdiff_t count = last - first;
+        if (count <= 0) return;
+        if (std::is_trivially_copyable<T>::value) {
+            memcpy(dst, &*first, count * sizeof(T));
+        } else {
+            fill(dst, &*first, &*first + count);
+        }
+    }
+
 public:
     void assign(size_type n, const T& val) {
         clear();
@@ -348,7 +376,7 @@ public:
         size_type p = pos - begin();
         size_type new_size = size() + 1;
         if (capacity() < new_size) {
-            change_capacity(new_size + (new_size >> 1));
+            change_capacity(grown_capacity(new_size));
         }
         T* ptr = item_ptr(p);
         memmove(ptr + 1, ptr, (size() - p) * sizeof(T));
@@ -361,7 +389,7 @@ public:
         size_type p = pos - begin();
         size_type new_size = size() + count;
         if (capacity() < new_size) {
-            change_capacity(new_size + (new_size >> 1));
+            change_capacity(grown_capacity(new_size));
         }
         T* ptr = item_ptr(p);
         memmove(ptr + count, ptr, (size() - p) * sizeof(T));
@@ -375,7 +403,7 @@ public:
         difference_type count = last - first;
         size_type new_size = size() + count;
         if (capacity() < new_size) {
-            change_capacity(new_size + (new_size >> 1));
+            change_capacity(grown_capacity(new_size));
         }
         T* ptr = item_ptr(p);
         memmove(ptr + count, ptr, (size() - p) * sizeof(T));
@@ -428,7 +456,7 @@ public:
     void emplace_back(Args&&... args) {
         size_type new_size = size() + 1;
         if (capacity() < new_size) {
-            change_capacity(new_size + (new_size >> 1));
+            change_capacity(grown_capacity(new_size));
         }
         new(item_ptr(size())) T(std::forward<Args>(args)...);
         _size++;
@@ -10,6 +10,7 @@
 #include <amount.h>
 #include <script/script.h>
 #include <serialize.h>
+#include <support/allocators/pool.h>
 #include <uint256.h>
 
 #include <tuple>
@@ -284,6 +285,13 @@ public:
     /** Convert a CMutableTransaction into a CTransaction. */
     explicit CTransaction(const CMutableTransaction& tx);
     CTransaction(CMutableTransaction&& tx);
+    /** Convert a deserialized CMutableTransaction into a CTransaction, given
+     *  the hash of the bytes it was deserialized from (which equals the
+     *  witness hash, as successfully deserialized transactions reserialize
+     *  identically). Avoids reserializing the transaction to compute its
+     *  hashes; only transactions with a witness still need a pass for the
+     *  witness-stripped txid. */
+    CTransaction(CMutableTransaction&& tx, const uint256& witness_hash);
 
     template <typename Stream>
     inline void Serialize(Stream& s) const {
@@ -384,7 +392,21 @@ struct CMutableTransaction
 };
 
 typedef std::shared_ptr<const CTransaction> CTransactionRef;
-template <typename Tx> static inline CTransactionRef MakeTransactionRef(Tx&& txIn) { return std::make_shared<const CTransaction>(std::forward<Tx>(txIn)); }
+
+/** Transactions are allocated and freed at relay rate, so their combined
+ *  control-block-plus-object allocation comes from the thread-aware shared
+ *  pool instead of the general-purpose heap (see shared_pool_allocator). */
+template <typename Tx> static inline CTransactionRef MakeTransactionRef(Tx&& txIn) { return std::allocate_shared<const CTransaction>(shared_pool_allocator<const CTransaction>{}, std::forward<Tx>(txIn)); }
+
+/** Deserialize a CTransactionRef through the shared transaction pool. This
+ *  overload is more specialized than the generic shared_ptr<const T>
+ *  deserializer in serialize.h, so it covers transactions arriving inside
+ *  blocks and P2P messages as well. */
+template <typename Stream>
+void Unserialize(Stream& is, CTransactionRef& p)
+{
+    p = std::allocate_shared<const CTransaction>(shared_pool_allocator<const CTransaction>{}, deserialize, is);
+}
 
 /** A generic txid reference (txid or wtxid). */
 class GenTxid
@@ -37,6 +37,24 @@ bool PartiallySignedTransaction::Merge(const PartiallySignedTransaction& psbt)
     return true;
 }
 
+bool PartiallySignedTransaction::Merge(PartiallySignedTransaction&& psbt)
+{
+    // Prohibited to merge two PSBTs over different transactions
+    if (tx->GetHash() != psbt.tx->GetHash()) {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < inputs.size(); ++i) {
+        inputs[i].Merge(std::move(psbt.inputs[i]));
+    }
+    for (unsigned int i = 0; i < outputs.size(); ++i) {
+        outputs[i].Merge(std::move(psbt.outputs[i]));
+    }
+    unknown.merge(psbt.unknown);
+
+    return true;
+}
+
 bool PartiallySignedTransaction::AddInput(const CTxIn& txin, PSBTInput& psbtin)
 {
     if (std::find(tx->vin.begin(), tx->vin.end(), txin) != tx->vin.end()) {
@@ -152,6 +170,27 @@ void PSBTInput::Merge(const PSBTInput& input)
     if (final_script_witness.IsNull() && !input.final_script_witness.IsNull()) final_script_witness = input.final_script_witness;
 }
 
+void PSBTInput::Merge(PSBTInput&& input)
+{
+    if (!non_witness_utxo && input.non_witness_utxo) non_witness_utxo = std::move(input.non_witness_utxo);
+    if (witness_utxo.IsNull() && !input.witness_utxo.IsNull()) {
+        // TODO: For segwit v1, we will want to clear out the non-witness utxo when setting a witness one. For v0 and non-segwit, this is not safe
+        witness_utxo = std::move(input.witness_utxo);
+    }
+
+    // merge() splices map nodes that do not collide with an existing key, so
+    // the common case (disjoint signature sets from different signers) does
+    // not allocate or copy at all.
+    partial_sigs.merge(input.partial_sigs);
+    hd_keypaths.merge(input.hd_keypaths);
+    unknown.merge(input.unknown);
+
+    if (redeem_script.empty() && !input.redeem_script.empty()) redeem_script = std::move(input.redeem_script);
+    if (witness_script.empty() && !input.witness_script.empty()) witness_script = std::move(input.witness_script);
+    if (final_script_sig.empty() && !input.final_script_sig.empty()) final_script_sig = std::move(input.final_script_sig);
+    if (final_script_witness.IsNull() && !input.final_script_witness.IsNull()) final_script_witness = std::move(input.final_script_witness);
+}
+
 void PSBTOutput::FillSignatureData(SignatureData& sigdata) const
 {
     if (!redeem_script.empty()) {
@@ -191,6 +230,15 @@ void PSBTOutput::Merge(const PSBTOutput& output)
     if (redeem_script.empty() && !output.redeem_script.empty()) redeem_script = output.redeem_script;
     if (witness_script.empty() && !output.witness_script.empty()) witness_script = output.witness_script;
 }
+
+void PSBTOutput::Merge(PSBTOutput&& output)
+{
+    hd_keypaths.merge(output.hd_keypaths);
+    unknown.merge(output.unknown);
+
+    if (redeem_script.empty() && !output.redeem_script.empty()) redeem_script = std::move(output.redeem_script);
+    if (witness_script.empty() && !output.witness_script.empty()) witness_script = std::move(output.witness_script);
+}
 bool PSBTInputSigned(const PSBTInput& input)
 {
     return !input.final_script_sig.empty() || !input.final_script_witness.IsNull();
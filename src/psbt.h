@@ -63,6 +63,9 @@ struct PSBTInput
     void FillSignatureData(SignatureData& sigdata) const;
     void FromSignatureData(const SignatureData& sigdata);
     void Merge(const PSBTInput& input);
+    /** As above, but splice map nodes and move scripts out of the source
+     * instead of copying, leaving it in an unspecified state. */
+    void Merge(PSBTInput&& input);
     PSBTInput() {}
 
     template <typename Stream>
@@ -284,6 +287,7 @@ struct PSBTOutput
     void FillSignatureData(SignatureData& sigdata) const;
     void FromSignatureData(const SignatureData& sigdata);
     void Merge(const PSBTOutput& output);
+    void Merge(PSBTOutput&& output);
     PSBTOutput() {}
 
     template <typename Stream>
@@ -400,6 +404,10 @@ struct PartiallySignedTransaction
     /** Merge psbt into this. The two psbts must have the same underlying CTransaction (i.e. the
       * same actual Bitcoin transaction.) Returns true if the merge succeeded, false otherwise. */
     [[nodiscard]] bool Merge(const PartiallySignedTransaction& psbt);
+    /** As above, but consumes the source: map entries are spliced and scripts
+      * moved rather than copied, which matters when combining many
+      * multi-hundred-input PSBTs. */
+    [[nodiscard]] bool Merge(PartiallySignedTransaction&& psbt);
     bool AddInput(const CTxIn& txin, PSBTInput& psbtin);
     bool AddOutput(const CTxOut& txout, const PSBTOutput& psbtout);
     PartiallySignedTransaction() {}
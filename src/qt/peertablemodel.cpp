@@ -48,6 +48,13 @@ bool NodeLessThan::operator()(const CNodeCombinedStats &left, const CNodeCombine
 class PeerTablePriv
 {
 public:
+    explicit PeerTablePriv(PeerTableModel *_parent) :
+        parent(_parent)
+    {
+    }
+
+    PeerTableModel *parent;
+
     /** Local cache of peer information */
     QList<CNodeCombinedStats> cachedNodeStats;
     /** Column to sort nodes by (default to unsorted) */
@@ -80,13 +87,72 @@ public:
             // sort cacheNodeStats (use stable sort to prevent rows jumping around unnecessarily)
             std::stable_sort(cachedNodeStats.begin(), cachedNodeStats.end(), NodeLessThan(sortColumn, sortOrder));
 
-        // build index map
+        rebuildIndex();
+    }
+
+    /** Rebuild the node id to row index */
+    void rebuildIndex()
+    {
         mapNodeRows.clear();
         int row = 0;
         for (const CNodeCombinedStats& stats : cachedNodeStats)
             mapNodeRows.insert(std::pair<NodeId, int>(stats.nodeStats.nodeid, row++));
     }
 
+    /** Apply only the changes since the last poll to the cache, emitting
+        row-level model updates instead of resetting the whole table. Rows
+        keep their positions, so this must not be used while a model-level
+        sort is active. */
+    void updatePeers(interfaces::Node& node)
+    {
+        std::map<NodeId, uint64_t> known;
+        for (const CNodeCombinedStats& stats : cachedNodeStats) {
+            known.emplace(stats.nodeStats.nodeid, stats.nodeStats.nSendBytes + stats.nodeStats.nRecvBytes);
+        }
+
+        interfaces::Node::NodesStats nodes_stats;
+        std::vector<NodeId> disconnected;
+        node.getNodesStatsDelta(known, nodes_stats, disconnected);
+
+        // Drop rows for peers that went away, from the bottom up so row
+        // numbers stay valid while removing.
+        std::vector<int> rows_to_remove;
+        rows_to_remove.reserve(disconnected.size());
+        for (NodeId id : disconnected) {
+            const auto it = mapNodeRows.find(id);
+            if (it != mapNodeRows.end()) rows_to_remove.push_back(it->second);
+        }
+        std::sort(rows_to_remove.rbegin(), rows_to_remove.rend());
+        for (int row : rows_to_remove) {
+            parent->beginRemoveRows(QModelIndex(), row, row);
+            cachedNodeStats.removeAt(row);
+            parent->endRemoveRows();
+        }
+        if (!rows_to_remove.empty()) rebuildIndex();
+
+        for (auto& node_stats : nodes_stats) {
+            CNodeCombinedStats stats;
+            stats.nodeStats = std::move(std::get<0>(node_stats));
+            stats.fNodeStateStatsAvailable = std::get<1>(node_stats);
+            stats.nodeStateStats = std::get<2>(node_stats);
+            const auto it = mapNodeRows.find(stats.nodeStats.nodeid);
+            if (it != mapNodeRows.end()) {
+                // Changed peer: update the row in place.
+                cachedNodeStats[it->second] = stats;
+                Q_EMIT parent->dataChanged(parent->index(it->second, 0, QModelIndex()),
+                                           parent->index(it->second, parent->columnCount(QModelIndex()) - 1, QModelIndex()));
+            } else {
+                // New peer: node ids are assigned in increasing order, so
+                // appending keeps the unsorted view in connection order.
+                const int row = cachedNodeStats.size();
+                parent->beginInsertRows(QModelIndex(), row, row);
+                cachedNodeStats.append(stats);
+                parent->endInsertRows();
+                mapNodeRows.insert(std::pair<NodeId, int>(stats.nodeStats.nodeid, row));
+            }
+        }
+    }
+
     int size() const
     {
         return cachedNodeStats.size();
@@ -106,7 +172,7 @@ PeerTableModel::PeerTableModel(interfaces::Node& node, QObject* parent) :
     m_node(node),
     timer(nullptr)
 {
-    priv.reset(new PeerTablePriv());
+    priv.reset(new PeerTablePriv(this));
 
     // set up timer for auto refresh
     timer = new QTimer(this);
@@ -235,9 +301,15 @@ QModelIndex PeerTableModel::index(int row, int column, const QModelIndex &parent
 
 void PeerTableModel::refresh()
 {
-    Q_EMIT layoutAboutToBeChanged();
-    priv->refreshPeers(m_node);
-    Q_EMIT layoutChanged();
+    if (priv->sortColumn >= 0) {
+        // With a model-level sort active, row positions can change on every
+        // poll, so rebuild the whole table.
+        Q_EMIT layoutAboutToBeChanged();
+        priv->refreshPeers(m_node);
+        Q_EMIT layoutChanged();
+        return;
+    }
+    priv->updatePeers(m_node);
 }
 
 int PeerTableModel::getRowByNodeId(NodeId nodeid)
@@ -91,6 +91,8 @@ private:
     const QStringList columns{tr("Peer Id"), tr("Address"), tr("Type"), tr("Network"), tr("Ping"), tr("Sent"), tr("Received"), tr("User Agent")};
     std::unique_ptr<PeerTablePriv> priv;
     QTimer *timer;
+
+    friend class PeerTablePriv;
 };
 
 #endif // BITCOIN_QT_PEERTABLEMODEL_H
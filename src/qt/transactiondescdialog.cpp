@@ -8,6 +8,7 @@
 #include <qt/guiutil.h>
 #include <qt/transactiontablemodel.h>
 
+#include <QAbstractProxyModel>
 #include <QModelIndex>
 
 TransactionDescDialog::TransactionDescDialog(const QModelIndex &idx, QWidget *parent) :
@@ -15,13 +16,33 @@ TransactionDescDialog::TransactionDescDialog(const QModelIndex &idx, QWidget *pa
     ui(new Ui::TransactionDescDialog)
 {
     ui->setupUi(this);
-    setWindowTitle(tr("Details for %1").arg(idx.data(TransactionTableModel::TxHashRole).toString()));
-    QString desc = idx.data(TransactionTableModel::LongDescriptionRole).toString();
-    ui->detailText->setHtml(desc);
+    m_tx_hash = idx.data(TransactionTableModel::TxHashRole).toString();
+    setWindowTitle(tr("Details for %1").arg(m_tx_hash));
+
+    // Build the description on a background thread: it can block on wallet
+    // and validation locks (e.g. during a block connect), which would freeze
+    // the whole window if done here.
+    QModelIndex source_idx = idx;
+    while (auto proxy = qobject_cast<const QAbstractProxyModel*>(source_idx.model())) {
+        source_idx = proxy->mapToSource(source_idx);
+    }
+    if (auto ttm = qobject_cast<const TransactionTableModel*>(source_idx.model())) {
+        ui->detailText->setHtml(tr("Loading…"));
+        connect(ttm, &TransactionTableModel::descriptionReady, this, &TransactionDescDialog::setDescription);
+        ttm->describeAsync(source_idx);
+    } else {
+        ui->detailText->setHtml(idx.data(TransactionTableModel::LongDescriptionRole).toString());
+    }
 
     GUIUtil::handleCloseWindowShortcut(this);
 }
 
+void TransactionDescDialog::setDescription(const QString& tx_hash, const QString& description)
+{
+    if (tx_hash != m_tx_hash) return;
+    ui->detailText->setHtml(description);
+}
+
 TransactionDescDialog::~TransactionDescDialog()
 {
     delete ui;
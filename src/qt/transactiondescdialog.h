@@ -24,8 +24,13 @@ public:
     explicit TransactionDescDialog(const QModelIndex &idx, QWidget *parent = nullptr);
     ~TransactionDescDialog();
 
+private Q_SLOTS:
+    /** Receives the description from TransactionTableModel::describeAsync */
+    void setDescription(const QString& tx_hash, const QString& description);
+
 private:
     Ui::TransactionDescDialog *ui;
+    QString m_tx_hash;
 };
 
 #endif // BITCOIN_QT_TRANSACTIONDESCDIALOG_H
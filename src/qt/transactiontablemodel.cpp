@@ -19,6 +19,7 @@
 #include <uint256.h>
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
 
 #include <QColor>
@@ -99,6 +100,13 @@ public:
     bool fQueueNotifications = false;
     std::vector< TransactionNotification > vQueueNotifications;
 
+    /* Replaying queued notifications applies them one at a time, and every
+       insert shifts the sorted cache, which is quadratic overall. Past this
+       many queued notifications (e.g. after a rescan of a large wallet) it is
+       much cheaper to rebuild the whole cache once.
+     */
+    static constexpr size_t MAX_INCREMENTAL_UPDATES{1000};
+
     void NotifyTransactionChanged(const uint256 &hash, ChangeType status);
     void ShowProgress(const std::string &title, int nProgress);
 
@@ -109,7 +117,9 @@ public:
         qDebug() << "TransactionTablePriv::refreshWallet";
         cachedWallet.clear();
         {
-            for (const auto& wtx : wallet.getWalletTxs()) {
+            const auto vWtx = wallet.getWalletTxs();
+            cachedWallet.reserve(vWtx.size());
+            for (const auto& wtx : vWtx) {
                 if (TransactionRecord::showTransaction()) {
                     cachedWallet.append(TransactionRecord::decomposeTransaction(wtx));
                 }
@@ -278,6 +288,42 @@ void TransactionTableModel::updateTransaction(const QString &hash, int status, b
     priv->updateWallet(walletModel->wallet(), updated, status, showTransaction);
 }
 
+void TransactionTableModel::describeAsync(const QModelIndex& index) const
+{
+    TransactionRecord* rec = static_cast<TransactionRecord*>(index.internalPointer());
+    if (!rec) return;
+
+    // Copy everything the worker needs: the record may be erased from the
+    // cache while the worker runs, and the display unit may change.
+    const QString tx_hash = rec->getTxHash();
+    interfaces::Node& node = walletModel->node();
+    interfaces::Wallet& wallet = walletModel->wallet();
+    const int unit = walletModel->getOptionsModel()->getDisplayUnit();
+
+    m_desc_futures.remove_if([](std::future<void>& f) {
+        return f.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+    });
+    m_desc_futures.push_back(std::async(std::launch::async, [this, rec_copy = *rec, tx_hash, &node, &wallet, unit]() mutable {
+        const QString desc = TransactionDesc::toHTML(node, wallet, &rec_copy, unit);
+        // Deliver on the GUI thread; if the model is being destroyed the
+        // queued event is discarded with it.
+        bool invoked = QMetaObject::invokeMethod(const_cast<TransactionTableModel*>(this), "descriptionReady", Qt::QueuedConnection,
+                                                 Q_ARG(QString, tx_hash),
+                                                 Q_ARG(QString, desc));
+        assert(invoked);
+    }));
+}
+
+void TransactionTableModel::refreshWallet()
+{
+    // Rebuild the whole record cache in one pass. Used instead of replaying
+    // queued per-transaction notifications when there are too many of them
+    // for incremental updates to be worthwhile.
+    beginResetModel();
+    priv->refreshWallet(walletModel->wallet());
+    endResetModel();
+}
+
 void TransactionTableModel::updateConfirmations()
 {
     // Blocks came in since last poll.
@@ -735,6 +781,15 @@ void TransactionTablePriv::ShowProgress(const std::string &title, int nProgress)
     if (nProgress == 100)
     {
         fQueueNotifications = false;
+        if (vQueueNotifications.size() > MAX_INCREMENTAL_UPDATES) {
+            // Applying this many updates one by one would freeze the GUI for
+            // a large wallet; drop them and rebuild the cache from the wallet
+            // in a single pass instead.
+            vQueueNotifications.clear();
+            bool invoked = QMetaObject::invokeMethod(parent, "refreshWallet", Qt::QueuedConnection);
+            assert(invoked);
+            return;
+        }
         if (vQueueNotifications.size() > 10) { // prevent balloon spam, show maximum 10 balloons
             bool invoked = QMetaObject::invokeMethod(parent, "setProcessingQueuedTransactions", Qt::QueuedConnection, Q_ARG(bool, true));
             assert(invoked);
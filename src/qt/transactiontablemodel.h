@@ -10,6 +10,8 @@
 #include <QAbstractTableModel>
 #include <QStringList>
 
+#include <future>
+#include <list>
 #include <memory>
 
 namespace interfaces {
@@ -83,6 +85,16 @@ public:
     QModelIndex index(int row, int column, const QModelIndex & parent = QModelIndex()) const override;
     bool processingQueuedTransactions() const { return fProcessingQueuedTransactions; }
 
+    /** Compute the long description (HTML) of a row on a background thread;
+        descriptionReady is emitted on the GUI thread when done. Building the
+        description can block on wallet and validation locks (e.g. during a
+        block connect), so it must not run synchronously on the GUI thread. */
+    void describeAsync(const QModelIndex& index) const;
+
+Q_SIGNALS:
+    /** Result of describeAsync, identified by transaction hash. */
+    void descriptionReady(const QString& tx_hash, const QString& description);
+
 private:
     WalletModel *walletModel;
     std::unique_ptr<interfaces::Handler> m_handler_transaction_changed;
@@ -91,6 +103,9 @@ private:
     TransactionTablePriv *priv;
     bool fProcessingQueuedTransactions;
     const PlatformStyle *platformStyle;
+    /** Outstanding describeAsync workers; pruned as they finish and drained
+        on destruction so no worker outlives the wallet interface. */
+    mutable std::list<std::future<void>> m_desc_futures;
 
     void subscribeToCoreSignals();
     void unsubscribeFromCoreSignals();
@@ -110,6 +125,9 @@ private:
 public Q_SLOTS:
     /* New transaction, or transaction changed status */
     void updateTransaction(const QString &hash, int status, bool showTransaction);
+    /* Rebuild the whole record cache from the wallet (cheaper than replaying
+       a large backlog of per-transaction updates) */
+    void refreshWallet();
     void updateConfirmations();
     void updateDisplayUnit();
     /** Updates the column title to "Amount (DisplayUnit)" and emits headerDataChanged() signal for table headers to react. */
@@ -273,7 +273,12 @@ WalletModel::SendCoinsReturn WalletModel::sendCoins(WalletModelTransaction &tran
         Q_EMIT coinsSent(this, rcp, transaction_array);
     }
 
-    checkBalanceChanged(m_wallet->getBalances()); // update balance immediately, otherwise there could be a short noticeable delay until pollBalanceChanged hits
+    // Update the balance immediately if the locks are uncontended; otherwise
+    // the regular poll picks the change up shortly. Blocking on getBalances
+    // here can freeze the GUI right after sending (e.g. during a block
+    // connect).
+    fForceCheckBalanceChanged = true;
+    pollBalanceChanged();
 
     return SendCoinsReturn(OK);
 }
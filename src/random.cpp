@@ -605,6 +605,23 @@ uint256 GetRandHash() noexcept
     return hash;
 }
 
+/** Number of ThreadLocalRng() calls between reseedings from the global RNG. */
+static constexpr int THREAD_RNG_RESEED_INTERVAL{100000};
+
+FastRandomContext& ThreadLocalRng() noexcept
+{
+    static thread_local FastRandomContext rng{g_mock_deterministic_tests};
+    static thread_local int calls_until_reseed{THREAD_RNG_RESEED_INTERVAL};
+    if (--calls_until_reseed <= 0 && !g_mock_deterministic_tests) {
+        // Periodically refresh the context from the global RNG state so that
+        // a thread's output does not stay predictable indefinitely if its
+        // context state ever leaks.
+        rng = FastRandomContext();
+        calls_until_reseed = THREAD_RNG_RESEED_INTERVAL;
+    }
+    return rng;
+}
+
 void FastRandomContext::RandomSeed()
 {
     uint256 seed = GetRandHash();
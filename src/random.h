@@ -85,6 +85,22 @@ constexpr auto GetRandMillis = GetRandomDuration<std::chrono::milliseconds>;
 int GetRandInt(int nMax) noexcept;
 uint256 GetRandHash() noexcept;
 
+class FastRandomContext;
+
+/**
+ * Return the calling thread's FastRandomContext.
+ *
+ * Unlike the GetRand*() functions above, this does not take the global RNG
+ * lock on every call: the context is seeded from the global RNG on first use
+ * and periodically reseeded from it thereafter. Intended for non-cryptographic
+ * randomness on hot paths (relay scheduling, cache eviction, load balancing).
+ * Do not use it for key-grade entropy; use GetStrongRandBytes for that.
+ *
+ * The returned reference is only valid on the calling thread, and must not be
+ * retained across points where the thread may exit.
+ */
+FastRandomContext& ThreadLocalRng() noexcept;
+
 /**
  * Gather entropy from various sources, feed it into the internal PRNG, and
  * generate random data using it.
@@ -242,7 +242,6 @@ static bool rest_block(HTTPRequest* req,
     if (!ParseHashStr(hashStr, hash))
         return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
 
-    CBlock block;
     CBlockIndex* pblockindex = nullptr;
     CBlockIndex* tip = nullptr;
     {
@@ -255,7 +254,28 @@ static bool rest_block(HTTPRequest* req,
 
         if (IsBlockPruned(pblockindex))
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not available (pruned data)");
+    }
+
+    if (rf == RetFormat::BINARY && RPCSerializationFlags() == 0) {
+        // The on-disk bytes are exactly the requested serialization (witness
+        // included), so skip deserializing the block and hand the
+        // memory-mapped file contents to libevent by reference; the mapping
+        // is released once the reply has been sent. Falls through to the
+        // buffered path if the block file cannot be mapped.
+        auto map = std::make_unique<FlatFileMap>();
+        const std::optional<Span<const uint8_t>> raw = MapRawBlockFromDisk(*map, pblockindex, Params().MessageStart());
+        if (raw) {
+            req->WriteHeader("Content-Type", "application/octet-stream");
+            FlatFileMap* map_ptr = map.release();
+            req->AppendReplyBodyReference(raw->data(), raw->size(), [map_ptr] { delete map_ptr; });
+            req->WriteReply(HTTP_OK);
+            return true;
+        }
+    }
 
+    CBlock block;
+    {
+        LOCK(cs_main);
         if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
     }
@@ -280,7 +300,7 @@ static bool rest_block(HTTPRequest* req,
     }
 
     case RetFormat::JSON: {
-        UniValue objBlock = blockToJSON(block, tip, pblockindex, showTxDetails);
+        UniValue objBlock = blockToJSON(block, tip, pblockindex, showTxDetails ? 2 : 1);
         std::string strJSON = objBlock.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(HTTP_OK, strJSON);
@@ -14,6 +14,8 @@
 #include <core_io.h>
 #include <hash.h>
 #include <index/blockfilterindex.h>
+#include <index/statsindex.h>
+#include <index/txindex.h>
 #include <node/coinstats.h>
 #include <node/context.h>
 #include <node/utxo_snapshot.h>
@@ -45,6 +47,7 @@
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <thread>
 
 struct CUpdatedBlock
 {
@@ -154,7 +157,7 @@ UniValue blockheaderToJSON(const CBlockIndex* tip, const CBlockIndex* blockindex
     return result;
 }
 
-UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, bool txDetails)
+UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, int verbosity)
 {
     UniValue result = blockheaderToJSON(tip, blockindex);
 
@@ -162,7 +165,7 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIn
     result.pushKV("size", (int)::GetSerializeSize(block, PROTOCOL_VERSION));
     result.pushKV("weight", (int)::GetBlockWeight(block));
     UniValue txs(UniValue::VARR);
-    if (txDetails) {
+    if (verbosity >= 2) {
         CBlockUndo blockUndo;
         const bool have_undo = !IsBlockPruned(blockindex) && UndoReadFromDisk(blockUndo, blockindex);
         for (size_t i = 0; i < block.vtx.size(); ++i) {
@@ -170,7 +173,7 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIn
             // coinbase transaction (i == 0) doesn't have undo data
             const CTxUndo* txundo = (have_undo && i) ? &blockUndo.vtxundo.at(i - 1) : nullptr;
             UniValue objTx(UniValue::VOBJ);
-            TxToUniv(*tx, uint256(), objTx, true, RPCSerializationFlags(), txundo);
+            TxToUniv(*tx, uint256(), objTx, true, RPCSerializationFlags(), txundo, /* include_prevouts */ verbosity >= 3);
             txs.push_back(objTx);
         }
     } else {
@@ -500,17 +503,40 @@ UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempoo
         if (include_mempool_sequence) {
             throw JSONRPCError(RPC_INVALID_PARAMETER, "Verbose results cannot contain mempool sequence values.");
         }
-        LOCK(pool.cs);
+        // Monitoring tools tend to poll the verbose dump aggressively, and
+        // each rebuild walks every entry under pool.cs. Cache the snapshot
+        // keyed by the mempool's transactions-updated counter, so repeat
+        // calls against an unchanged pool are served without touching
+        // pool.cs at all. The counter also advances on descendant-state and
+        // priority changes, so entry fields stay current; only unbroadcast
+        // flags can go briefly stale. Holding the cache mutex while
+        // rebuilding makes concurrent callers wait for one rebuild instead
+        // of racing their own.
+        static Mutex g_mempool_json_mutex;
+        static unsigned int g_mempool_json_updates GUARDED_BY(g_mempool_json_mutex){0};
+        static UniValue g_mempool_json_snapshot GUARDED_BY(g_mempool_json_mutex);
+
+        LOCK(g_mempool_json_mutex);
+        if (!g_mempool_json_snapshot.isNull() && pool.GetTransactionsUpdated() == g_mempool_json_updates) {
+            return g_mempool_json_snapshot;
+        }
         UniValue o(UniValue::VOBJ);
-        for (const CTxMemPoolEntry& e : pool.mapTx) {
-            const uint256& hash = e.GetTx().GetHash();
-            UniValue info(UniValue::VOBJ);
-            entryToJSON(pool, info, e);
-            // Mempool has unique entries so there is no advantage in using
-            // UniValue::pushKV, which checks if the key already exists in O(N).
-            // UniValue::__pushKV is used instead which currently is O(1).
-            o.__pushKV(hash.ToString(), info);
+        {
+            LOCK(pool.cs);
+            // Read the counter under pool.cs so it matches the snapshot
+            // exactly; changes racing the rebuild force the next rebuild.
+            g_mempool_json_updates = pool.GetTransactionsUpdated();
+            for (const CTxMemPoolEntry& e : pool.mapTx) {
+                const uint256& hash = e.GetTx().GetHash();
+                UniValue info(UniValue::VOBJ);
+                entryToJSON(pool, info, e);
+                // Mempool has unique entries so there is no advantage in using
+                // UniValue::pushKV, which checks if the key already exists in O(N).
+                // UniValue::__pushKV is used instead which currently is O(1).
+                o.__pushKV(hash.ToString(), info);
+            }
         }
+        g_mempool_json_snapshot = o;
         return o;
     } else {
         uint64_t mempool_sequence;
@@ -879,10 +905,11 @@ static RPCHelpMan getblock()
     return RPCHelpMan{"getblock",
                 "\nIf verbosity is 0, returns a string that is serialized, hex-encoded data for block 'hash'.\n"
                 "If verbosity is 1, returns an Object with information about block <hash>.\n"
-                "If verbosity is 2, returns an Object with information about block <hash> and information about each transaction. \n",
+                "If verbosity is 2, returns an Object with information about block <hash> and information about each transaction. \n"
+                "If verbosity is 3, returns an Object with information about block <hash> and information about each transaction, including the prevout of each input, so fees and flows can be computed without further lookups.\n",
                 {
                     {"blockhash", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The block hash"},
-                    {"verbosity|verbose", RPCArg::Type::NUM, /* default */ "1", "0 for hex-encoded data, 1 for a json object, and 2 for json object with transaction data"},
+                    {"verbosity|verbose", RPCArg::Type::NUM, /* default */ "1", "0 for hex-encoded data, 1 for a json object, 2 for json object with transaction data, and 3 for json object with transaction data including prevouts"},
                 },
                 {
                     RPCResult{"for verbosity = 0",
@@ -924,6 +951,36 @@ static RPCHelpMan getblock()
                         }},
                     }},
                 }},
+                    RPCResult{"for verbosity = 3",
+                RPCResult::Type::OBJ, "", "",
+                {
+                    {RPCResult::Type::ELISION, "", "Same output as verbosity = 2"},
+                    {RPCResult::Type::ARR, "tx", "",
+                    {
+                        {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::ARR, "vin", "",
+                            {
+                                {RPCResult::Type::OBJ, "", "",
+                                {
+                                    {RPCResult::Type::ELISION, "", "The same output as verbosity = 2"},
+                                    {RPCResult::Type::OBJ, "prevout", "(Only if undo information is available)",
+                                    {
+                                        {RPCResult::Type::BOOL, "generated", "Coinbase or not"},
+                                        {RPCResult::Type::NUM, "height", "The height of the prevout"},
+                                        {RPCResult::Type::NUM, "value", "The value in " + CURRENCY_UNIT},
+                                        {RPCResult::Type::OBJ, "scriptPubKey", "",
+                                        {
+                                            {RPCResult::Type::STR, "asm", "the asm"},
+                                            {RPCResult::Type::STR, "hex", "the hex"},
+                                            {RPCResult::Type::STR, "type", "The type, eg 'pubkeyhash'"},
+                                        }},
+                                    }},
+                                }},
+                            }},
+                        }},
+                    }},
+                }},
         },
                 RPCExamples{
                     HelpExampleCli("getblock", "\"00000000c937983704a73af28acdec37b049d214adbda81d7e2a3dd146f6ed09\"")
@@ -964,7 +1021,7 @@ static RPCHelpMan getblock()
         return strHex;
     }
 
-    return blockToJSON(block, tip, pblockindex, verbosity >= 2);
+    return blockToJSON(block, tip, pblockindex, verbosity);
 },
     };
 }
@@ -1043,7 +1100,7 @@ static RPCHelpMan gettxoutsetinfo()
 {
     return RPCHelpMan{"gettxoutsetinfo",
                 "\nReturns statistics about the unspent transaction output set.\n"
-                "Note this call may take some time.\n",
+                "Note this call may take some time if you are not using coinstatsindex.\n",
                 {
                     {"hash_type", RPCArg::Type::STR, /* default */ "hash_serialized_2", "Which UTXO set hash should be calculated. Options: 'hash_serialized_2' (the legacy algorithm), 'muhash', 'none'."},
                 },
@@ -1052,12 +1109,12 @@ static RPCHelpMan gettxoutsetinfo()
                     {
                         {RPCResult::Type::NUM, "height", "The current block height (index)"},
                         {RPCResult::Type::STR_HEX, "bestblock", "The hash of the block at the tip of the chain"},
-                        {RPCResult::Type::NUM, "transactions", "The number of transactions with unspent outputs"},
+                        {RPCResult::Type::NUM, "transactions", /* optional */ true, "The number of transactions with unspent outputs (not available when coinstatsindex is used)"},
                         {RPCResult::Type::NUM, "txouts", "The number of unspent transaction outputs"},
                         {RPCResult::Type::NUM, "bogosize", "A meaningless metric for UTXO set size"},
                         {RPCResult::Type::STR_HEX, "hash_serialized_2", /* optional */ true, "The serialized hash (only present if 'hash_serialized_2' hash_type is chosen)"},
                         {RPCResult::Type::STR_HEX, "muhash", /* optional */ true, "The serialized hash (only present if 'muhash' hash_type is chosen)"},
-                        {RPCResult::Type::NUM, "disk_size", "The estimated size of the chainstate on disk"},
+                        {RPCResult::Type::NUM, "disk_size", /* optional */ true, "The estimated size of the chainstate on disk (not available when coinstatsindex is used)"},
                         {RPCResult::Type::STR_AMOUNT, "total_amount", "The total amount"},
                     }},
                 RPCExamples{
@@ -1078,7 +1135,9 @@ static RPCHelpMan gettxoutsetinfo()
     if (GetUTXOStats(coins_view, WITH_LOCK(::cs_main, return std::ref(g_chainman.m_blockman)), stats, hash_type, node.rpc_interruption_point)) {
         ret.pushKV("height", (int64_t)stats.nHeight);
         ret.pushKV("bestblock", stats.hashBlock.GetHex());
-        ret.pushKV("transactions", (int64_t)stats.nTransactions);
+        if (!stats.index_used) {
+            ret.pushKV("transactions", (int64_t)stats.nTransactions);
+        }
         ret.pushKV("txouts", (int64_t)stats.nTransactionOutputs);
         ret.pushKV("bogosize", (int64_t)stats.nBogoSize);
         if (hash_type == CoinStatsHashType::HASH_SERIALIZED) {
@@ -1087,7 +1146,9 @@ static RPCHelpMan gettxoutsetinfo()
         if (hash_type == CoinStatsHashType::MUHASH) {
               ret.pushKV("muhash", stats.hashSerialized.GetHex());
         }
-        ret.pushKV("disk_size", stats.nDiskSize);
+        if (!stats.index_used) {
+            ret.pushKV("disk_size", stats.nDiskSize);
+        }
         ret.pushKV("total_amount", ValueFromAmount(stats.nTotalAmount));
     } else {
         throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
@@ -1097,6 +1158,53 @@ static RPCHelpMan gettxoutsetinfo()
     };
 }
 
+static RPCHelpMan getdbstats()
+{
+    const std::vector<RPCResult> db_result{
+        {RPCResult::Type::STR, "stats", "leveldb's per-level statistics: file counts, sizes, and cumulative read/write volume"},
+        {RPCResult::Type::NUM, "approximate_memory_usage", "approximate memory used by the instance (memtable and table cache), in bytes"},
+    };
+    return RPCHelpMan{"getdbstats",
+        "\nReturns internal statistics of the node's leveldb databases.\n"
+        "Useful for judging read amplification and cache effectiveness of the\n"
+        "chainstate and index databases.\n",
+        {},
+        RPCResult{RPCResult::Type::OBJ, "", "",
+        {
+            {RPCResult::Type::OBJ, "chainstate", "the UTXO set database", db_result},
+            {RPCResult::Type::OBJ, "block_index", "the block tree database", db_result},
+            {RPCResult::Type::OBJ, "txindex", /* optional */ true, "the transaction index database, if -txindex is enabled", db_result},
+        }},
+        RPCExamples{
+            HelpExampleCli("getdbstats", "")
+            + HelpExampleRpc("getdbstats", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const auto db_to_json = [](const std::function<bool(const std::string&, std::string&)>& get_property) {
+        UniValue obj(UniValue::VOBJ);
+        std::string stats;
+        if (get_property("leveldb.stats", stats)) obj.pushKV("stats", stats);
+        std::string memory;
+        if (get_property("leveldb.approximate-memory-usage", memory)) obj.pushKV("approximate_memory_usage", atoi64(memory));
+        return obj;
+    };
+
+    UniValue ret(UniValue::VOBJ);
+    {
+        LOCK(cs_main);
+        CCoinsViewDB& coins_db = ::ChainstateActive().CoinsDB();
+        ret.pushKV("chainstate", db_to_json([&](const std::string& name, std::string& out) { return coins_db.GetDBProperty(name, out); }));
+        ret.pushKV("block_index", db_to_json([&](const std::string& name, std::string& out) { return pblocktree->GetProperty(name, out); }));
+    }
+    if (g_txindex) {
+        ret.pushKV("txindex", db_to_json([&](const std::string& name, std::string& out) { return g_txindex->GetDBProperty(name, out); }));
+    }
+    return ret;
+},
+    };
+}
+
 static RPCHelpMan gettxout()
 {
     return RPCHelpMan{"gettxout",
@@ -1204,6 +1312,76 @@ static RPCHelpMan verifychain()
     };
 }
 
+static RPCHelpMan verifychainasync()
+{
+    return RPCHelpMan{"verifychainasync",
+                "\nStarts verifying the blockchain database in the background.\n"
+                "Blocks are verified in small batches with the main lock released in\n"
+                "between, so the node keeps serving requests during the audit. Only\n"
+                "check levels 0-2 are supported: the level 3-4 checks need a coins view\n"
+                "that stays consistent with the tip for the whole run, which requires\n"
+                "the blocking verifychain call. Query progress with verifychainstatus.\n",
+                {
+                    {"checklevel", RPCArg::Type::NUM, /* default */ "2, range=0-2",
+                        strprintf("How thorough the block verification is:\n - %s", Join(CHECKLEVEL_DOC, "\n- "))},
+                    {"nblocks", RPCArg::Type::NUM, /* default */ "0=all", "The number of blocks to check."},
+                },
+                RPCResult{
+                    RPCResult::Type::BOOL, "", "Whether verification was started (false if a run is already in progress)"},
+                RPCExamples{
+                    HelpExampleCli("verifychainasync", "")
+            + HelpExampleRpc("verifychainasync", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const int check_level(request.params[0].isNull() ? 2 : request.params[0].get_int());
+    const int check_depth{request.params[1].isNull() ? 0 : request.params[1].get_int()};
+
+    if (check_level < 0 || check_level > 2) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "checklevel must be 0-2 for background verification; use verifychain for levels 3-4");
+    }
+
+    return g_async_verify_db.Start(Params(), ::ChainstateActive(), check_level, check_depth);
+},
+    };
+}
+
+static RPCHelpMan verifychainstatus()
+{
+    return RPCHelpMan{"verifychainstatus",
+                "\nReturns the progress of the current or last verifychainasync run.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::BOOL, "started", "whether a background verification has ever been started"},
+                        {RPCResult::Type::BOOL, "running", "whether one is in progress"},
+                        {RPCResult::Type::NUM, "checklevel", "the check level of the run"},
+                        {RPCResult::Type::NUM, "blocks_checked", "blocks verified so far"},
+                        {RPCResult::Type::NUM, "blocks_total", "blocks the run will verify"},
+                        {RPCResult::Type::BOOL, "success", "whether the run finished without finding problems (false while running)"},
+                        {RPCResult::Type::STR, "error", "description of the failure, if any"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("verifychainstatus", "")
+            + HelpExampleRpc("verifychainstatus", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const AsyncVerifyDB::Progress progress{g_async_verify_db.GetProgress()};
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("started", progress.started);
+    ret.pushKV("running", progress.running);
+    ret.pushKV("checklevel", progress.check_level);
+    ret.pushKV("blocks_checked", progress.blocks_checked);
+    ret.pushKV("blocks_total", progress.blocks_total);
+    ret.pushKV("success", progress.success);
+    ret.pushKV("error", progress.error);
+    return ret;
+},
+    };
+}
+
 static void BuriedForkDescPushBack(UniValue& softforks, const std::string &name, int height) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
 {
     // For buried deployments.
@@ -1374,6 +1552,52 @@ RPCHelpMan getblockchaininfo()
     };
 }
 
+static RPCHelpMan getvalidationinfo()
+{
+    return RPCHelpMan{"getvalidationinfo",
+                "Returns per-phase block-connect timing statistics over a sliding window of recently connected blocks.\n"
+                "These are the same measurements the -debug=bench log prints, in a machine-readable form.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "window", "number of recently connected blocks the percentiles cover"},
+                        {RPCResult::Type::OBJ_DYN, "phases", "timing statistics per validation phase",
+                        {
+                            {RPCResult::Type::OBJ, "xxxx", "name of the phase",
+                            {
+                                {RPCResult::Type::NUM, "count", "number of times the phase ran since startup"},
+                                {RPCResult::Type::NUM, "p50_ms", "median duration over the window, in milliseconds"},
+                                {RPCResult::Type::NUM, "p95_ms", "95th percentile duration over the window, in milliseconds"},
+                                {RPCResult::Type::NUM, "max_ms", "maximum duration over the window, in milliseconds"},
+                            }},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getvalidationinfo", "")
+            + HelpExampleRpc("getvalidationinfo", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    UniValue obj(UniValue::VOBJ);
+    UniValue phases(UniValue::VOBJ);
+    uint64_t window{0};
+    for (const ValidationBenchStats& stats : GetValidationBenchStats()) {
+        window = std::max<uint64_t>(window, stats.window);
+        UniValue phase(UniValue::VOBJ);
+        phase.pushKV("count", stats.count);
+        phase.pushKV("p50_ms", stats.p50_ms);
+        phase.pushKV("p95_ms", stats.p95_ms);
+        phase.pushKV("max_ms", stats.max_ms);
+        phases.pushKV(stats.name, phase);
+    }
+    obj.pushKV("window", window);
+    obj.pushKV("phases", phases);
+    return obj;
+},
+    };
+}
+
 /** Comparison function for sorting the getchaintips heads.  */
 struct CompareBlocksByHeight
 {
@@ -1501,6 +1725,17 @@ UniValue MempoolInfoToJSON(const CTxMemPool& pool)
     ret.pushKV("mempoolminfee", ValueFromAmount(std::max(pool.GetMinFee(maxmempool), ::minRelayTxFee).GetFeePerK()));
     ret.pushKV("minrelaytxfee", ValueFromAmount(::minRelayTxFee.GetFeePerK()));
     ret.pushKV("unbroadcastcount", uint64_t{pool.GetUnbroadcastTxs().size()});
+    UniValue fee_histogram(UniValue::VARR);
+    const CTxMemPool::FeeHistogram histogram{pool.GetFeeHistogram()};
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        UniValue bucket(UniValue::VOBJ);
+        bucket.pushKV("feerate", CTxMemPool::FEE_HISTOGRAM_BUCKET_BOUNDS[i]);
+        bucket.pushKV("count", histogram[i].count);
+        bucket.pushKV("vsize", histogram[i].vsize);
+        bucket.pushKV("fees", ValueFromAmount(histogram[i].fees));
+        fee_histogram.push_back(bucket);
+    }
+    ret.pushKV("fee_histogram", fee_histogram);
     return ret;
 }
 
@@ -1520,7 +1755,17 @@ static RPCHelpMan getmempoolinfo()
                         {RPCResult::Type::NUM, "maxmempool", "Maximum memory usage for the mempool"},
                         {RPCResult::Type::STR_AMOUNT, "mempoolminfee", "Minimum fee rate in " + CURRENCY_UNIT + "/kB for tx to be accepted. Is the maximum of minrelaytxfee and minimum mempool fee"},
                         {RPCResult::Type::STR_AMOUNT, "minrelaytxfee", "Current minimum relay fee for transactions"},
-                        {RPCResult::Type::NUM, "unbroadcastcount", "Current number of transactions that haven't passed initial broadcast yet"}
+                        {RPCResult::Type::NUM, "unbroadcastcount", "Current number of transactions that haven't passed initial broadcast yet"},
+                        {RPCResult::Type::ARR, "fee_histogram", "Histogram of mempool transactions grouped by modified feerate",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::NUM, "feerate", "Lower bound of the bucket's feerate range in satoshis per virtual byte (the upper bound is the next bucket's lower bound)"},
+                                {RPCResult::Type::NUM, "count", "Number of transactions in the bucket"},
+                                {RPCResult::Type::NUM, "vsize", "Sum of the transactions' virtual sizes as defined in BIP 141"},
+                                {RPCResult::Type::STR_AMOUNT, "fees", "Sum of the transactions' modified fees in " + CURRENCY_UNIT},
+                            }},
+                        }},
                     }},
                 RPCExamples{
                     HelpExampleCli("getmempoolinfo", "")
@@ -1730,22 +1975,6 @@ static RPCHelpMan getchaintxstats()
     };
 }
 
-template<typename T>
-static T CalculateTruncatedMedian(std::vector<T>& scores)
-{
-    size_t size = scores.size();
-    if (size == 0) {
-        return 0;
-    }
-
-    std::sort(scores.begin(), scores.end());
-    if (size % 2 == 0) {
-        return (scores[size / 2 - 1] + scores[size / 2]) / 2;
-    } else {
-        return scores[size / 2];
-    }
-}
-
 void CalculatePercentilesByWeight(CAmount result[NUM_GETBLOCKSTATS_PERCENTILES], std::vector<std::pair<CAmount, int64_t>>& scores, int64_t total_weight)
 {
     if (scores.empty()) {
@@ -1783,9 +2012,6 @@ static inline bool SetHasKeys(const std::set<T>& set, const Tk& key, const Args&
     return (set.count(key) != 0) || SetHasKeys(set, args...);
 }
 
-// outpoint (needed for the utxo index) + nHeight + fCoinBase
-static constexpr size_t PER_UTXO_OVERHEAD = sizeof(COutPoint) + sizeof(uint32_t) + sizeof(bool);
-
 static RPCHelpMan getblockstats()
 {
     return RPCHelpMan{"getblockstats",
@@ -1884,151 +2110,181 @@ static RPCHelpMan getblockstats()
         }
     }
 
-    const CBlock block = GetBlockChecked(pindex);
-    const CBlockUndo blockUndo = GetUndoChecked(pindex);
-
     const bool do_all = stats.size() == 0; // Calculate everything if nothing selected (default)
-    const bool do_mediantxsize = do_all || stats.count("mediantxsize") != 0;
-    const bool do_medianfee = do_all || stats.count("medianfee") != 0;
-    const bool do_feerate_percentiles = do_all || stats.count("feerate_percentiles") != 0;
-    const bool loop_inputs = do_all || do_medianfee || do_feerate_percentiles ||
-        SetHasKeys(stats, "utxo_size_inc", "totalfee", "avgfee", "avgfeerate", "minfee", "maxfee", "minfeerate", "maxfeerate");
-    const bool loop_outputs = do_all || loop_inputs || stats.count("total_out");
-    const bool do_calculate_size = do_mediantxsize ||
-        SetHasKeys(stats, "total_size", "avgtxsize", "mintxsize", "maxtxsize", "swtotal_size");
-    const bool do_calculate_weight = do_all || SetHasKeys(stats, "total_weight", "avgfeerate", "swtotal_weight", "avgfeerate", "feerate_percentiles", "minfeerate", "maxfeerate");
-    const bool do_calculate_sw = do_all || SetHasKeys(stats, "swtxs", "swtotal_size", "swtotal_weight");
-
-    CAmount maxfee = 0;
-    CAmount maxfeerate = 0;
-    CAmount minfee = MAX_MONEY;
-    CAmount minfeerate = MAX_MONEY;
-    CAmount total_out = 0;
-    CAmount totalfee = 0;
-    int64_t inputs = 0;
-    int64_t maxtxsize = 0;
-    int64_t mintxsize = MAX_BLOCK_SERIALIZED_SIZE;
-    int64_t outputs = 0;
-    int64_t swtotal_size = 0;
-    int64_t swtotal_weight = 0;
-    int64_t swtxs = 0;
-    int64_t total_size = 0;
-    int64_t total_weight = 0;
-    int64_t utxo_size_inc = 0;
-    std::vector<CAmount> fee_array;
-    std::vector<std::pair<CAmount, int64_t>> feerate_array;
-    std::vector<int64_t> txsize_array;
-
-    for (size_t i = 0; i < block.vtx.size(); ++i) {
-        const auto& tx = block.vtx.at(i);
-        outputs += tx->vout.size();
-
-        CAmount tx_total_out = 0;
-        if (loop_outputs) {
-            for (const CTxOut& out : tx->vout) {
-                tx_total_out += out.nValue;
-                utxo_size_inc += GetSerializeSize(out, PROTOCOL_VERSION) + PER_UTXO_OVERHEAD;
-            }
-        }
-
-        if (tx->IsCoinBase()) {
-            continue;
-        }
 
-        inputs += tx->vin.size(); // Don't count coinbase's fake input
-        total_out += tx_total_out; // Don't count coinbase reward
+    BlockStats block_stats;
+    if (!g_stats_index || !g_stats_index->LookupStats(pindex, block_stats)) {
+        const CBlock block = GetBlockChecked(pindex);
+        const CBlockUndo blockUndo = GetUndoChecked(pindex);
+
+        const bool do_mediantxsize = do_all || stats.count("mediantxsize") != 0;
+        const bool do_medianfee = do_all || stats.count("medianfee") != 0;
+        const bool do_feerate_percentiles = do_all || stats.count("feerate_percentiles") != 0;
+        const bool loop_inputs = do_all || do_medianfee || do_feerate_percentiles ||
+            SetHasKeys(stats, "utxo_size_inc", "totalfee", "avgfee", "avgfeerate", "minfee", "maxfee", "minfeerate", "maxfeerate");
+        const bool loop_outputs = do_all || loop_inputs || stats.count("total_out");
+        const bool do_calculate_size = do_mediantxsize ||
+            SetHasKeys(stats, "total_size", "avgtxsize", "mintxsize", "maxtxsize", "swtotal_size");
+        const bool do_calculate_weight = do_all || SetHasKeys(stats, "total_weight", "avgfeerate", "swtotal_weight", "avgfeerate", "feerate_percentiles", "minfeerate", "maxfeerate");
+        const bool do_calculate_sw = do_all || SetHasKeys(stats, "swtxs", "swtotal_size", "swtotal_weight");
+
+        CAmount maxfee = 0;
+        CAmount maxfeerate = 0;
+        CAmount minfee = MAX_MONEY;
+        CAmount minfeerate = MAX_MONEY;
+        CAmount total_out = 0;
+        CAmount totalfee = 0;
+        int64_t inputs = 0;
+        int64_t maxtxsize = 0;
+        int64_t mintxsize = MAX_BLOCK_SERIALIZED_SIZE;
+        int64_t outputs = 0;
+        int64_t swtotal_size = 0;
+        int64_t swtotal_weight = 0;
+        int64_t swtxs = 0;
+        int64_t total_size = 0;
+        int64_t total_weight = 0;
+        int64_t utxo_size_inc = 0;
+        std::vector<CAmount> fee_array;
+        std::vector<std::pair<CAmount, int64_t>> feerate_array;
+        std::vector<int64_t> txsize_array;
 
-        int64_t tx_size = 0;
-        if (do_calculate_size) {
+        for (size_t i = 0; i < block.vtx.size(); ++i) {
+            const auto& tx = block.vtx.at(i);
+            outputs += tx->vout.size();
+
+            CAmount tx_total_out = 0;
+            if (loop_outputs) {
+                for (const CTxOut& out : tx->vout) {
+                    tx_total_out += out.nValue;
+                    utxo_size_inc += GetSerializeSize(out, PROTOCOL_VERSION) + PER_UTXO_OVERHEAD;
+                }
+            }
 
-            tx_size = tx->GetTotalSize();
-            if (do_mediantxsize) {
-                txsize_array.push_back(tx_size);
+            if (tx->IsCoinBase()) {
+                continue;
             }
-            maxtxsize = std::max(maxtxsize, tx_size);
-            mintxsize = std::min(mintxsize, tx_size);
-            total_size += tx_size;
-        }
 
-        int64_t weight = 0;
-        if (do_calculate_weight) {
-            weight = GetTransactionWeight(*tx);
-            total_weight += weight;
-        }
+            inputs += tx->vin.size(); // Don't count coinbase's fake input
+            total_out += tx_total_out; // Don't count coinbase reward
 
-        if (do_calculate_sw && tx->HasWitness()) {
-            ++swtxs;
-            swtotal_size += tx_size;
-            swtotal_weight += weight;
-        }
+            int64_t tx_size = 0;
+            if (do_calculate_size) {
 
-        if (loop_inputs) {
-            CAmount tx_total_in = 0;
-            const auto& txundo = blockUndo.vtxundo.at(i - 1);
-            for (const Coin& coin: txundo.vprevout) {
-                const CTxOut& prevoutput = coin.out;
+                tx_size = tx->GetTotalSize();
+                if (do_mediantxsize) {
+                    txsize_array.push_back(tx_size);
+                }
+                maxtxsize = std::max(maxtxsize, tx_size);
+                mintxsize = std::min(mintxsize, tx_size);
+                total_size += tx_size;
+            }
 
-                tx_total_in += prevoutput.nValue;
-                utxo_size_inc -= GetSerializeSize(prevoutput, PROTOCOL_VERSION) + PER_UTXO_OVERHEAD;
+            int64_t weight = 0;
+            if (do_calculate_weight) {
+                weight = GetTransactionWeight(*tx);
+                total_weight += weight;
             }
 
-            CAmount txfee = tx_total_in - tx_total_out;
-            CHECK_NONFATAL(MoneyRange(txfee));
-            if (do_medianfee) {
-                fee_array.push_back(txfee);
+            if (do_calculate_sw && tx->HasWitness()) {
+                ++swtxs;
+                swtotal_size += tx_size;
+                swtotal_weight += weight;
             }
-            maxfee = std::max(maxfee, txfee);
-            minfee = std::min(minfee, txfee);
-            totalfee += txfee;
-
-            // New feerate uses satoshis per virtual byte instead of per serialized byte
-            CAmount feerate = weight ? (txfee * WITNESS_SCALE_FACTOR) / weight : 0;
-            if (do_feerate_percentiles) {
-                feerate_array.emplace_back(std::make_pair(feerate, weight));
+
+            if (loop_inputs) {
+                CAmount tx_total_in = 0;
+                const auto& txundo = blockUndo.vtxundo.at(i - 1);
+                for (const Coin& coin: txundo.vprevout) {
+                    const CTxOut& prevoutput = coin.out;
+
+                    tx_total_in += prevoutput.nValue;
+                    utxo_size_inc -= GetSerializeSize(prevoutput, PROTOCOL_VERSION) + PER_UTXO_OVERHEAD;
+                }
+
+                CAmount txfee = tx_total_in - tx_total_out;
+                CHECK_NONFATAL(MoneyRange(txfee));
+                if (do_medianfee) {
+                    fee_array.push_back(txfee);
+                }
+                maxfee = std::max(maxfee, txfee);
+                minfee = std::min(minfee, txfee);
+                totalfee += txfee;
+
+                // New feerate uses satoshis per virtual byte instead of per serialized byte
+                CAmount feerate = weight ? (txfee * WITNESS_SCALE_FACTOR) / weight : 0;
+                if (do_feerate_percentiles) {
+                    feerate_array.emplace_back(std::make_pair(feerate, weight));
+                }
+                maxfeerate = std::max(maxfeerate, feerate);
+                minfeerate = std::min(minfeerate, feerate);
             }
-            maxfeerate = std::max(maxfeerate, feerate);
-            minfeerate = std::min(minfeerate, feerate);
         }
-    }
 
-    CAmount feerate_percentiles[NUM_GETBLOCKSTATS_PERCENTILES] = { 0 };
-    CalculatePercentilesByWeight(feerate_percentiles, feerate_array, total_weight);
+        CAmount feerate_percentiles[NUM_GETBLOCKSTATS_PERCENTILES] = { 0 };
+        CalculatePercentilesByWeight(feerate_percentiles, feerate_array, total_weight);
+
+        // Fill the stats record from the locals so the response is built the same
+        // way whether or not the record came from the stats index. Fields whose
+        // computation was skipped above stay zero; they are never selected.
+        for (int64_t i = 0; i < NUM_GETBLOCKSTATS_PERCENTILES; i++) {
+            block_stats.feerate_percentiles[i] = feerate_percentiles[i];
+        }
+        block_stats.txs = block.vtx.size();
+        block_stats.ins = inputs;
+        block_stats.outs = outputs;
+        block_stats.totalfee = totalfee;
+        block_stats.minfee = (minfee == MAX_MONEY) ? 0 : minfee;
+        block_stats.maxfee = maxfee;
+        block_stats.medianfee = CalculateTruncatedMedian(fee_array);
+        block_stats.minfeerate = (minfeerate == MAX_MONEY) ? 0 : minfeerate;
+        block_stats.maxfeerate = maxfeerate;
+        block_stats.total_out = total_out;
+        block_stats.total_size = total_size;
+        block_stats.total_weight = total_weight;
+        block_stats.mintxsize = mintxsize == MAX_BLOCK_SERIALIZED_SIZE ? 0 : mintxsize;
+        block_stats.maxtxsize = maxtxsize;
+        block_stats.mediantxsize = CalculateTruncatedMedian(txsize_array);
+        block_stats.swtxs = swtxs;
+        block_stats.swtotal_size = swtotal_size;
+        block_stats.swtotal_weight = swtotal_weight;
+        block_stats.utxo_size_inc = utxo_size_inc;
+    }
 
     UniValue feerates_res(UniValue::VARR);
     for (int64_t i = 0; i < NUM_GETBLOCKSTATS_PERCENTILES; i++) {
-        feerates_res.push_back(feerate_percentiles[i]);
+        feerates_res.push_back(block_stats.feerate_percentiles[i]);
     }
 
     UniValue ret_all(UniValue::VOBJ);
-    ret_all.pushKV("avgfee", (block.vtx.size() > 1) ? totalfee / (block.vtx.size() - 1) : 0);
-    ret_all.pushKV("avgfeerate", total_weight ? (totalfee * WITNESS_SCALE_FACTOR) / total_weight : 0); // Unit: sat/vbyte
-    ret_all.pushKV("avgtxsize", (block.vtx.size() > 1) ? total_size / (block.vtx.size() - 1) : 0);
+    ret_all.pushKV("avgfee", (block_stats.txs > 1) ? block_stats.totalfee / (block_stats.txs - 1) : 0);
+    ret_all.pushKV("avgfeerate", block_stats.total_weight ? (block_stats.totalfee * WITNESS_SCALE_FACTOR) / block_stats.total_weight : 0); // Unit: sat/vbyte
+    ret_all.pushKV("avgtxsize", (block_stats.txs > 1) ? block_stats.total_size / (block_stats.txs - 1) : 0);
     ret_all.pushKV("blockhash", pindex->GetBlockHash().GetHex());
     ret_all.pushKV("feerate_percentiles", feerates_res);
     ret_all.pushKV("height", (int64_t)pindex->nHeight);
-    ret_all.pushKV("ins", inputs);
-    ret_all.pushKV("maxfee", maxfee);
-    ret_all.pushKV("maxfeerate", maxfeerate);
-    ret_all.pushKV("maxtxsize", maxtxsize);
-    ret_all.pushKV("medianfee", CalculateTruncatedMedian(fee_array));
+    ret_all.pushKV("ins", block_stats.ins);
+    ret_all.pushKV("maxfee", block_stats.maxfee);
+    ret_all.pushKV("maxfeerate", block_stats.maxfeerate);
+    ret_all.pushKV("maxtxsize", block_stats.maxtxsize);
+    ret_all.pushKV("medianfee", block_stats.medianfee);
     ret_all.pushKV("mediantime", pindex->GetMedianTimePast());
-    ret_all.pushKV("mediantxsize", CalculateTruncatedMedian(txsize_array));
-    ret_all.pushKV("minfee", (minfee == MAX_MONEY) ? 0 : minfee);
-    ret_all.pushKV("minfeerate", (minfeerate == MAX_MONEY) ? 0 : minfeerate);
-    ret_all.pushKV("mintxsize", mintxsize == MAX_BLOCK_SERIALIZED_SIZE ? 0 : mintxsize);
-    ret_all.pushKV("outs", outputs);
+    ret_all.pushKV("mediantxsize", block_stats.mediantxsize);
+    ret_all.pushKV("minfee", block_stats.minfee);
+    ret_all.pushKV("minfeerate", block_stats.minfeerate);
+    ret_all.pushKV("mintxsize", block_stats.mintxsize);
+    ret_all.pushKV("outs", block_stats.outs);
     ret_all.pushKV("subsidy", GetBlockSubsidy(pindex->nHeight, Params().GetConsensus()));
-    ret_all.pushKV("swtotal_size", swtotal_size);
-    ret_all.pushKV("swtotal_weight", swtotal_weight);
-    ret_all.pushKV("swtxs", swtxs);
+    ret_all.pushKV("swtotal_size", block_stats.swtotal_size);
+    ret_all.pushKV("swtotal_weight", block_stats.swtotal_weight);
+    ret_all.pushKV("swtxs", block_stats.swtxs);
     ret_all.pushKV("time", pindex->GetBlockTime());
-    ret_all.pushKV("total_out", total_out);
-    ret_all.pushKV("total_size", total_size);
-    ret_all.pushKV("total_weight", total_weight);
-    ret_all.pushKV("totalfee", totalfee);
-    ret_all.pushKV("txs", (int64_t)block.vtx.size());
-    ret_all.pushKV("utxo_increase", outputs - inputs);
-    ret_all.pushKV("utxo_size_inc", utxo_size_inc);
+    ret_all.pushKV("total_out", block_stats.total_out);
+    ret_all.pushKV("total_size", block_stats.total_size);
+    ret_all.pushKV("total_weight", block_stats.total_weight);
+    ret_all.pushKV("totalfee", block_stats.totalfee);
+    ret_all.pushKV("txs", block_stats.txs);
+    ret_all.pushKV("utxo_increase", block_stats.outs - block_stats.ins);
+    ret_all.pushKV("utxo_size_inc", block_stats.utxo_size_inc);
 
     if (do_all) {
         return ret_all;
@@ -2075,15 +2331,15 @@ static RPCHelpMan savemempool()
 }
 
 namespace {
-//! Search for a given set of pubkey scripts
-bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, CCoinsViewCursor* cursor, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
+//! Search one slice of the keyspace (the coins whose txid starts with the
+//! given byte) for the given pubkey scripts
+bool ScanTxOutSetSlice(const std::atomic<bool>& should_abort, int64_t& count, CCoinsViewCursor* cursor, uint8_t first_byte, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
 {
-    scan_progress = 0;
-    count = 0;
     while (cursor->Valid()) {
         COutPoint key;
         Coin coin;
         if (!cursor->GetKey(key) || !cursor->GetValue(coin)) return false;
+        if (*key.hash.begin() != first_byte) break; // end of this slice
         if (++count % 8192 == 0) {
             interruption_point();
             if (should_abort) {
@@ -2091,16 +2347,68 @@ bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>&
                 return false;
             }
         }
-        if (count % 256 == 0) {
-            // update progress reference every 256 item
-            uint32_t high = 0x100 * *key.hash.begin() + *(key.hash.begin() + 1);
-            scan_progress = (int)(high * 100.0 / 65536.0 + 0.5);
-        }
         if (needles.count(coin.out.scriptPubKey)) {
             out_results.emplace(key, coin);
         }
         cursor->Next();
     }
+    return true;
+}
+
+//! Search for a given set of pubkey scripts. The keyspace is split into 256
+//! slices by leading txid byte, scanned by worker threads pulling slices
+//! from a shared counter; entries are independent, so the only merge step is
+//! concatenating the per-slice results in key order. The cursors are created
+//! by the caller so they share one consistent database snapshot.
+bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
+{
+    scan_progress = 0;
+    count = 0;
+    CHECK_NONFATAL(cursors.size() == 256);
+
+    std::vector<int64_t> slice_counts(cursors.size(), 0);
+    std::vector<std::map<COutPoint, Coin>> slice_results(cursors.size());
+    std::atomic<size_t> next_slice{0};
+    std::atomic<unsigned int> slices_done{0};
+    std::atomic<bool> failed{false};
+    // The first exception thrown by any worker (e.g. by interruption_point
+    // when the node shuts down); rethrown on the RPC thread after the join.
+    std::exception_ptr exception;
+    Mutex exception_mutex;
+
+    auto scan_worker = [&] {
+        try {
+            for (size_t slice = next_slice.fetch_add(1); slice < cursors.size(); slice = next_slice.fetch_add(1)) {
+                if (failed || should_abort) return;
+                if (!ScanTxOutSetSlice(should_abort, slice_counts[slice], cursors[slice].get(), (uint8_t)slice, needles, slice_results[slice], interruption_point)) {
+                    failed = true;
+                    return;
+                }
+                scan_progress = (int)(++slices_done * 100 / cursors.size());
+            }
+        } catch (...) {
+            LOCK(exception_mutex);
+            if (!exception) exception = std::current_exception();
+            failed = true;
+        }
+    };
+
+    const size_t n_workers = std::max<size_t>(GetNumCores(), 1);
+    std::vector<std::thread> threads;
+    threads.reserve(n_workers - 1);
+    for (size_t i = 1; i < n_workers; ++i) {
+        threads.emplace_back(scan_worker);
+    }
+    scan_worker();
+    for (std::thread& t : threads) t.join();
+
+    if (exception) std::rethrow_exception(exception);
+
+    for (size_t slice = 0; slice < cursors.size(); ++slice) {
+        count += slice_counts[slice];
+        out_results.insert(slice_results[slice].begin(), slice_results[slice].end());
+    }
+    if (failed || should_abort) return false;
     scan_progress = 100;
     return true;
 }
@@ -2247,18 +2555,23 @@ static RPCHelpMan scantxoutset()
         g_should_abort_scan = false;
         g_scan_progress = 0;
         int64_t count = 0;
-        std::unique_ptr<CCoinsViewCursor> pcursor;
+        std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
         CBlockIndex* tip;
         {
             LOCK(cs_main);
             ::ChainstateActive().ForceFlushStateToDisk();
-            pcursor = std::unique_ptr<CCoinsViewCursor>(::ChainstateActive().CoinsDB().Cursor());
-            CHECK_NONFATAL(pcursor);
+            // One cursor per keyspace slice, all created here so the worker
+            // threads scan a single consistent snapshot of the chainstate.
+            cursors.reserve(256);
+            for (int slice = 0; slice < 256; ++slice) {
+                cursors.emplace_back(::ChainstateActive().CoinsDB().Cursor((uint8_t)slice));
+                CHECK_NONFATAL(cursors.back());
+            }
             tip = ::ChainActive().Tip();
             CHECK_NONFATAL(tip);
         }
         NodeContext& node = EnsureNodeContext(request.context);
-        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, pcursor.get(), needles, coins, node.rpc_interruption_point);
+        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, cursors, needles, coins, node.rpc_interruption_point);
         result.pushKV("success", res);
         result.pushKV("txouts", count);
         result.pushKV("height", tip->nHeight);
@@ -2493,6 +2806,7 @@ static const CRPCCommand commands[] =
   //  --------------------- ------------------------
     { "blockchain",         &getblockchaininfo,                  },
     { "blockchain",         &getchaintxstats,                    },
+    { "blockchain",         &getvalidationinfo,                  },
     { "blockchain",         &getblockstats,                      },
     { "blockchain",         &getbestblockhash,                   },
     { "blockchain",         &getblockcount,                      },
@@ -2500,6 +2814,7 @@ static const CRPCCommand commands[] =
     { "blockchain",         &getblockhash,                       },
     { "blockchain",         &getblockheader,                     },
     { "blockchain",         &getchaintips,                       },
+    { "blockchain",         &getdbstats,                         },
     { "blockchain",         &getdifficulty,                      },
     { "blockchain",         &getmempoolancestors,                },
     { "blockchain",         &getmempooldescendants,              },
@@ -2511,6 +2826,8 @@ static const CRPCCommand commands[] =
     { "blockchain",         &pruneblockchain,                    },
     { "blockchain",         &savemempool,                        },
     { "blockchain",         &verifychain,                        },
+    { "blockchain",         &verifychainasync,                   },
+    { "blockchain",         &verifychainstatus,                  },
 
     { "blockchain",         &preciousblock,                      },
     { "blockchain",         &scantxoutset,                       },
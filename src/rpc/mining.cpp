@@ -33,6 +33,9 @@
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
+
+#include <deque>
+#include <future>
 #include <versionbitsinfo.h>
 #include <warnings.h>
 
@@ -525,6 +528,7 @@ static RPCHelpMan getblocktemplate()
                     {"segwit", RPCArg::Type::STR, RPCArg::Optional::NO, "(literal) indicates client side segwit support"},
                     {"str", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "other client side supported softfork deployment"},
                 }},
+                {"deltatoken", RPCArg::Type::STR, /* treat as named arg */ RPCArg::Optional::OMITTED_NAMED_ARG, "Opaque client-chosen id enabling delta replies. The node remembers the transaction set last served for this id; while the chain tip is unchanged, later calls with the same id get 'addedtxids'/'removedtxids' instead of the full 'transactions' list. Use a fresh id (or omit it) to get a full template again"},
             },
                         "\"template_request\""},
         },
@@ -544,7 +548,15 @@ static RPCHelpMan getblocktemplate()
                 }},
                 {RPCResult::Type::NUM, "vbrequired", "bit mask of versionbits the server requires set in submissions"},
                 {RPCResult::Type::STR, "previousblockhash", "The hash of current highest block"},
-                {RPCResult::Type::ARR, "transactions", "contents of non-coinbase transactions that should be included in the next block",
+                {RPCResult::Type::ARR, "addedtxids", /* optional */ true, "only in delta replies (see 'deltatoken'): txids to add to the previously served transaction set",
+                {
+                    {RPCResult::Type::STR_HEX, "", "transaction id encoded in little-endian hexadecimal"},
+                }},
+                {RPCResult::Type::ARR, "removedtxids", /* optional */ true, "only in delta replies (see 'deltatoken'): txids to remove from the previously served transaction set",
+                {
+                    {RPCResult::Type::STR_HEX, "", "transaction id encoded in little-endian hexadecimal"},
+                }},
+                {RPCResult::Type::ARR, "transactions", "contents of non-coinbase transactions that should be included in the next block (omitted from delta replies)",
                 {
                     {RPCResult::Type::OBJ, "", "",
                     {
@@ -592,6 +604,7 @@ static RPCHelpMan getblocktemplate()
 
     std::string strMode = "template";
     UniValue lpval = NullUniValue;
+    std::string delta_token;
     std::set<std::string> setClientRules;
     int64_t nMaxVersionPreVB = -1;
     if (!request.params[0].isNull())
@@ -607,6 +620,8 @@ static RPCHelpMan getblocktemplate()
         else
             throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid mode");
         lpval = find_value(oparam, "longpollid");
+        const UniValue& dtval = find_value(oparam, "deltatoken");
+        if (dtval.isStr()) delta_token = dtval.get_str();
 
         if (strMode == "proposal")
         {
@@ -767,6 +782,36 @@ static RPCHelpMan getblocktemplate()
 
     UniValue aCaps(UniValue::VARR); aCaps.push_back("proposal");
 
+    // Per-token state for delta replies: the non-coinbase txids served last
+    // time, and the tip they were served on. Like the cached template above,
+    // this is only accessed under cs_main. Stale tokens are pruned so
+    // clients that vanish do not leak memory.
+    struct GBTDeltaState {
+        uint256 prev_block;
+        std::set<uint256> txids;
+        int64_t last_seen{0};
+    };
+    static std::map<std::string, GBTDeltaState> delta_states;
+    GBTDeltaState* delta_state = nullptr;
+    bool serve_delta = false;
+    if (!delta_token.empty() && strMode == "template") {
+        const int64_t now = GetTime();
+        for (auto it = delta_states.begin(); it != delta_states.end();) {
+            if (it->first != delta_token && now - it->second.last_seen > 3600) {
+                it = delta_states.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        const auto ins = delta_states.try_emplace(delta_token);
+        delta_state = &ins.first->second;
+        // A delta is only meaningful against the same tip; after a new block
+        // the client gets a full template again.
+        serve_delta = !ins.second && delta_state->prev_block == pblock->hashPrevBlock;
+        delta_state->last_seen = now;
+    }
+    std::set<uint256> cur_txids;
+
     UniValue transactions(UniValue::VARR);
     std::map<uint256, int64_t> setTxIndex;
     int i = 0;
@@ -778,6 +823,9 @@ static RPCHelpMan getblocktemplate()
         if (tx.IsCoinBase())
             continue;
 
+        if (delta_state) cur_txids.insert(txHash);
+        if (serve_delta) continue; // delta replies carry no full entries
+
         UniValue entry(UniValue::VOBJ);
 
         entry.pushKV("data", EncodeHexTx(tx));
@@ -881,7 +929,24 @@ static RPCHelpMan getblocktemplate()
     }
 
     result.pushKV("previousblockhash", pblock->hashPrevBlock.GetHex());
-    result.pushKV("transactions", transactions);
+    if (serve_delta) {
+        UniValue added(UniValue::VARR);
+        UniValue removed(UniValue::VARR);
+        for (const uint256& txid : cur_txids) {
+            if (!delta_state->txids.count(txid)) added.push_back(txid.GetHex());
+        }
+        for (const uint256& txid : delta_state->txids) {
+            if (!cur_txids.count(txid)) removed.push_back(txid.GetHex());
+        }
+        result.pushKV("addedtxids", added);
+        result.pushKV("removedtxids", removed);
+    } else {
+        result.pushKV("transactions", transactions);
+    }
+    if (delta_state) {
+        delta_state->prev_block = pblock->hashPrevBlock;
+        delta_state->txids = std::move(cur_txids);
+    }
     result.pushKV("coinbaseaux", aux);
     result.pushKV("coinbasevalue", (int64_t)pblock->vtx[0]->vout[0].nValue);
     result.pushKV("longpollid", ::ChainActive().Tip()->GetBlockHash().GetHex() + ToString(nTransactionsUpdatedLast));
@@ -1005,6 +1070,150 @@ static RPCHelpMan submitblock()
     };
 }
 
+//! Completed or in-flight asynchronous block submissions, by block hash. An
+//! empty result string means the block was fully accepted; other values are
+//! BIP22 rejection reasons. Entries are pruned oldest-first once their
+//! activation has finished.
+static Mutex g_async_submit_mutex;
+static std::map<uint256, std::shared_future<std::string>> g_async_submits GUARDED_BY(g_async_submit_mutex);
+static std::deque<uint256> g_async_submit_order GUARDED_BY(g_async_submit_mutex);
+static constexpr size_t MAX_ASYNC_SUBMIT_RESULTS{16};
+
+void WaitForAsyncBlockSubmissions()
+{
+    LOCK(g_async_submit_mutex);
+    for (const auto& entry : g_async_submits) {
+        entry.second.wait();
+    }
+}
+
+static RPCHelpMan submitblockasync()
+{
+    return RPCHelpMan{"submitblockasync",
+        "\nAttempts to submit new block to network without waiting for full validation.\n"
+        "Cheap contextless checks (block structure, proof of work, merkle root) run\n"
+        "synchronously and reject obviously bad blocks immediately. The block then\n"
+        "begins relaying to peers while chain activation completes in the background;\n"
+        "query the final BIP22 result with submitblockresult.\n",
+        {
+            {"hexdata", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "the hex-encoded block data to submit"},
+        },
+        {
+            RPCResult{"If the block failed the synchronous checks or is already known", RPCResult::Type::STR, "", "According to BIP22"},
+            RPCResult{"Otherwise", RPCResult::Type::STR, "", "\"pending\""},
+        },
+        RPCExamples{
+                    HelpExampleCli("submitblockasync", "\"mydata\"")
+            + HelpExampleRpc("submitblockasync", "\"mydata\"")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    std::shared_ptr<CBlock> blockptr = std::make_shared<CBlock>();
+    CBlock& block = *blockptr;
+    if (!DecodeHexBlk(block, request.params[0].get_str())) {
+        throw JSONRPCError(RPC_DESERIALIZATION_ERROR, "Block decode failed");
+    }
+
+    if (block.vtx.empty() || !block.vtx[0]->IsCoinBase()) {
+        throw JSONRPCError(RPC_DESERIALIZATION_ERROR, "Block does not start with a coinbase");
+    }
+
+    uint256 hash = block.GetHash();
+    {
+        LOCK(cs_main);
+        const CBlockIndex* pindex = g_chainman.m_blockman.LookupBlockIndex(hash);
+        if (pindex) {
+            if (pindex->IsValid(BLOCK_VALID_SCRIPTS)) {
+                return "duplicate";
+            }
+            if (pindex->nStatus & BLOCK_FAILED_MASK) {
+                return "duplicate-invalid";
+            }
+        }
+        const CBlockIndex* pindexPrev = g_chainman.m_blockman.LookupBlockIndex(block.hashPrevBlock);
+        if (pindexPrev) {
+            UpdateUncommittedBlockStructures(block, pindexPrev, Params().GetConsensus());
+        }
+    }
+
+    // Reject garbage before acknowledging: these checks are contextless and
+    // cheap relative to connecting the block.
+    {
+        BlockValidationState state;
+        if (!CheckBlock(block, state, Params().GetConsensus())) {
+            return BIP22ValidationResult(state);
+        }
+    }
+
+    ChainstateManager& chainman = EnsureChainman(request.context);
+    LOCK(g_async_submit_mutex);
+    const auto existing = g_async_submits.find(hash);
+    if (existing != g_async_submits.end()) {
+        // Already submitted; report its status like submitblockresult would.
+        if (existing->second.wait_for(std::chrono::seconds{0}) != std::future_status::ready) return "pending";
+        const std::string& result = existing->second.get();
+        return result.empty() ? NullUniValue : UniValue{result};
+    }
+
+    // Relay starts as soon as ProcessNewBlock has validated the header
+    // (NewPoWValidBlock fires before the block is connected), so peers see
+    // the compact block announcement without waiting for ConnectBlock.
+    std::shared_future<std::string> fut = std::async(std::launch::async, [&chainman, blockptr, hash]() -> std::string {
+        bool new_block;
+        auto sc = std::make_shared<submitblock_StateCatcher>(hash);
+        RegisterSharedValidationInterface(sc);
+        bool accepted = chainman.ProcessNewBlock(Params(), blockptr, /* fForceProcessing */ true, /* fNewBlock */ &new_block);
+        UnregisterSharedValidationInterface(sc);
+        if (!new_block && accepted) return "duplicate";
+        if (!sc->found) return "inconclusive";
+        const UniValue result = BIP22ValidationResult(sc->state);
+        return result.isNull() ? "" : result.get_str();
+    }).share();
+
+    // Keep a bounded history of finished submissions for submitblockresult.
+    while (g_async_submit_order.size() >= MAX_ASYNC_SUBMIT_RESULTS) {
+        const auto oldest = g_async_submits.find(g_async_submit_order.front());
+        if (oldest != g_async_submits.end() && oldest->second.wait_for(std::chrono::seconds{0}) != std::future_status::ready) break;
+        if (oldest != g_async_submits.end()) g_async_submits.erase(oldest);
+        g_async_submit_order.pop_front();
+    }
+    g_async_submits.emplace(hash, fut);
+    g_async_submit_order.push_back(hash);
+    return "pending";
+},
+    };
+}
+
+static RPCHelpMan submitblockresult()
+{
+    return RPCHelpMan{"submitblockresult",
+        "\nReturns the outcome of a previous submitblockasync call.\n",
+        {
+            {"blockhash", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "hash of the block that was submitted"},
+        },
+        {
+            RPCResult{"If the block was accepted", RPCResult::Type::NONE, "", ""},
+            RPCResult{"If activation has not finished", RPCResult::Type::STR, "", "\"pending\""},
+            RPCResult{"If the block hash is not a tracked submission", RPCResult::Type::STR, "", "\"unknown\""},
+            RPCResult{"Otherwise", RPCResult::Type::STR, "", "According to BIP22"},
+        },
+        RPCExamples{
+                    HelpExampleCli("submitblockresult", "\"myblockhash\"")
+            + HelpExampleRpc("submitblockresult", "\"myblockhash\"")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const uint256 hash{ParseHashV(request.params[0], "blockhash")};
+    LOCK(g_async_submit_mutex);
+    const auto it = g_async_submits.find(hash);
+    if (it == g_async_submits.end()) return "unknown";
+    if (it->second.wait_for(std::chrono::seconds{0}) != std::future_status::ready) return "pending";
+    const std::string& result = it->second.get();
+    return result.empty() ? NullUniValue : UniValue{result};
+},
+    };
+}
+
 static RPCHelpMan submitheader()
 {
     return RPCHelpMan{"submitheader",
@@ -1243,6 +1452,8 @@ static const CRPCCommand commands[] =
     { "mining",              &prioritisetransaction,   },
     { "mining",              &getblocktemplate,        },
     { "mining",              &submitblock,             },
+    { "mining",              &submitblockasync,        },
+    { "mining",              &submitblockresult,       },
     { "mining",              &submitheader,            },
 
 
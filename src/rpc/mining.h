@@ -8,4 +8,9 @@
 /** Default max iterations to try in RPC generatetodescriptor, generatetoaddress, and generateblock. */
 static const uint64_t DEFAULT_MAX_TRIES{1000000};
 
+/** Block until all submitblockasync activations have finished. Called during
+ * shutdown, after the RPC server has stopped, so no background submission can
+ * outlive the chainstate. */
+void WaitForAsyncBlockSubmissions();
+
 #endif // BITCOIN_RPC_MINING_H
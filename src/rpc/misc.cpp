@@ -3,8 +3,12 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <core_io.h>
 #include <httpserver.h>
+#include <index/addrindex.h>
 #include <index/blockfilterindex.h>
+#include <index/spentindex.h>
+#include <index/statsindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <key_io.h>
@@ -15,6 +19,8 @@
 #include <rpc/util.h>
 #include <scheduler.h>
 #include <script/descriptor.h>
+#include <script/sigcache.h>
+#include <support/allocators/pool.h>
 #include <util/check.h>
 #include <util/message.h> // For MessageSign(), MessageVerify()
 #include <util/ref.h>
@@ -244,12 +250,16 @@ static RPCHelpMan deriveaddresses()
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Range must be specified for a ranged descriptor");
     }
 
+    // Expand through the shared cache, so repeated calls for the same ranged
+    // descriptor do not re-derive the BIP32 children each time.
+    std::shared_ptr<CachedDescriptor> cached_desc = GetCachedDescriptor(std::move(desc));
+
     UniValue addresses(UniValue::VARR);
 
     for (int i = range_begin; i <= range_end; ++i) {
         FlatSigningProvider provider;
         std::vector<CScript> scripts;
-        if (!desc->Expand(i, key_provider, scripts, provider)) {
+        if (!cached_desc->Expand(i, key_provider, scripts, provider)) {
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, strprintf("Cannot derive script without private keys"));
         }
 
@@ -435,6 +445,17 @@ static RPCHelpMan mockscheduler()
     };
 }
 
+static UniValue RPCTransactionArenaInfo()
+{
+    const auto stats = pool_allocator_detail::SharedPool::Instance().GetStats();
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("used", stats.used_bytes);
+    obj.pushKV("free", stats.reserved_bytes - std::min(stats.used_bytes, stats.reserved_bytes));
+    obj.pushKV("total", stats.reserved_bytes);
+    obj.pushKV("chunks", stats.chunks);
+    return obj;
+}
+
 static UniValue RPCLockedMemoryInfo()
 {
     LockedPool::Stats stats = LockedPoolManager::Instance().stats();
@@ -445,6 +466,16 @@ static UniValue RPCLockedMemoryInfo()
     obj.pushKV("locked", uint64_t(stats.locked));
     obj.pushKV("chunks_used", uint64_t(stats.chunks_used));
     obj.pushKV("chunks_free", uint64_t(stats.chunks_free));
+    UniValue arenas(UniValue::VARR);
+    for (const auto& arena : LockedPoolManager::Instance().arena_stats()) {
+        UniValue arena_obj(UniValue::VOBJ);
+        arena_obj.pushKV("used", uint64_t(arena.used));
+        arena_obj.pushKV("free", uint64_t(arena.free));
+        arena_obj.pushKV("total", uint64_t(arena.total));
+        arena_obj.pushKV("locked", arena.locked);
+        arenas.push_back(arena_obj);
+    }
+    obj.pushKV("arenas", arenas);
     return obj;
 }
 
@@ -491,6 +522,23 @@ static RPCHelpMan getmemoryinfo()
                                 {RPCResult::Type::NUM, "locked", "Amount of bytes that succeeded locking. If this number is smaller than total, locking pages failed at some point and key data could be swapped to disk."},
                                 {RPCResult::Type::NUM, "chunks_used", "Number allocated chunks"},
                                 {RPCResult::Type::NUM, "chunks_free", "Number unused chunks"},
+                                {RPCResult::Type::ARR, "arenas", "Per-arena usage, in creation order",
+                                {
+                                    {RPCResult::Type::OBJ, "", "",
+                                    {
+                                        {RPCResult::Type::NUM, "used", "Number of bytes used"},
+                                        {RPCResult::Type::NUM, "free", "Number of bytes available"},
+                                        {RPCResult::Type::NUM, "total", "Number of bytes managed by this arena"},
+                                        {RPCResult::Type::BOOL, "locked", "Whether this arena's pages are locked in memory"},
+                                    }},
+                                }},
+                            }},
+                            {RPCResult::Type::OBJ, "transaction_arena", "Information about the shared transaction arena",
+                            {
+                                {RPCResult::Type::NUM, "used", "Number of bytes in blocks currently handed out"},
+                                {RPCResult::Type::NUM, "free", "Number of bytes reserved but not handed out"},
+                                {RPCResult::Type::NUM, "total", "Total number of bytes reserved from the heap"},
+                                {RPCResult::Type::NUM, "chunks", "Number of chunks reserved"},
                             }},
                         }
                     },
@@ -508,6 +556,7 @@ static RPCHelpMan getmemoryinfo()
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        obj.pushKV("transaction_arena", RPCTransactionArenaInfo());
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -522,6 +571,94 @@ static RPCHelpMan getmemoryinfo()
     };
 }
 
+static RPCHelpMan setsigcachesize()
+{
+    return RPCHelpMan{"setsigcachesize",
+                "\nResize the signature cache without restarting the node.\n"
+                "Entries already in the cache are preserved. This can be used to grow the\n"
+                "cache on a node being promoted to validation duty, where cache misses\n"
+                "during traffic bursts directly increase transaction acceptance latency.\n",
+                {
+                    {"size", RPCArg::Type::NUM, RPCArg::Optional::NO, "The new signature cache size in MiB (up to " + ToString(MAX_MAX_SIG_CACHE_SIZE) + ")"},
+                },
+                RPCResult{
+                    RPCResult::Type::NUM, "elements", "The number of entries the resized cache can store"
+                },
+                RPCExamples{
+                    HelpExampleCli("setsigcachesize", "256")
+            + HelpExampleRpc("setsigcachesize", "256")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const int64_t size_mib = request.params[0].get_int64();
+    if (size_mib < 0 || size_mib > MAX_MAX_SIG_CACHE_SIZE) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("size must be between 0 and %d MiB", MAX_MAX_SIG_CACHE_SIZE));
+    }
+    return (uint64_t)ResizeSignatureCache(size_mib * ((size_t)1 << 20));
+},
+    };
+}
+
+static RPCHelpMan setcachesizes()
+{
+    return RPCHelpMan{"setcachesizes",
+                "\nResize the coins caches without restarting the node.\n"
+                "Useful on hosts shared with other services: shrink the caches while the\n"
+                "memory is needed elsewhere and grow them again for overnight catch-up.\n"
+                "Shrinking flushes the chainstate to disk and may take a while for a\n"
+                "large dirty cache. Index caches are fixed at startup and not affected.\n"
+                "With no arguments, only reports the current sizes and utilization.\n",
+                {
+                    {"coinstip", RPCArg::Type::NUM, RPCArg::Optional::OMITTED_NAMED_ARG, "The new size of the in-memory coins cache in MiB"},
+                    {"coinsdb", RPCArg::Type::NUM, RPCArg::Optional::OMITTED_NAMED_ARG, "The new size of the coins database cache in MiB"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "coinstip_size", "Size of the in-memory coins cache in bytes"},
+                        {RPCResult::Type::NUM, "coinstip_usage", "Bytes currently used by the in-memory coins cache"},
+                        {RPCResult::Type::NUM, "coinsdb_size", "Size of the coins database cache in bytes"},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("setcachesizes", "4096 64")
+            + HelpExampleRpc("setcachesizes", "4096, 64")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureChainman(request.context);
+
+    LOCK(cs_main);
+
+    if (!request.params[0].isNull()) {
+        const int64_t size_mib = request.params[0].get_int64();
+        if (size_mib < 1) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "coinstip must be at least 1 MiB");
+        }
+        chainman.m_total_coinstip_cache = size_mib << 20;
+    }
+    if (!request.params[1].isNull()) {
+        const int64_t size_mib = request.params[1].get_int64();
+        if (size_mib < 1) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "coinsdb must be at least 1 MiB");
+        }
+        chainman.m_total_coinsdb_cache = size_mib << 20;
+    }
+
+    // Re-split the new totals across the chainstates and apply them; resizing
+    // is a no-op for chainstates whose share is unchanged.
+    chainman.MaybeRebalanceCaches();
+
+    CChainState& chainstate = chainman.ActiveChainstate();
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("coinstip_size", (int64_t)chainstate.m_coinstip_cache_size_bytes);
+    ret.pushKV("coinstip_usage", (int64_t)(chainstate.CanFlushToDisk() ? chainstate.CoinsTip().DynamicMemoryUsage() : 0));
+    ret.pushKV("coinsdb_size", (int64_t)chainstate.m_coinsdb_cache_size_bytes);
+    return ret;
+},
+    };
+}
+
 static void EnableOrDisableLogCategories(UniValue cats, bool enable) {
     cats = cats.get_array();
     for (unsigned int i = 0; i < cats.size(); ++i) {
@@ -656,6 +793,155 @@ static UniValue SummaryToJSON(const IndexSummary&& summary, std::string index_na
     return ret_summary;
 }
 
+//! Shared lookup preamble of the address index RPCs.
+static CScript AddressToIndexedScript(const JSONRPCRequest& request)
+{
+    if (!g_addr_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Address index is not enabled");
+    }
+
+    const CTxDestination dest = DecodeDestination(request.params[0].get_str());
+    if (!IsValidDestination(dest)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+    }
+
+    g_addr_index->BlockUntilSyncedToCurrentChain();
+
+    return GetScriptForDestination(dest);
+}
+
+static RPCHelpMan getaddresstxids()
+{
+    return RPCHelpMan{"getaddresstxids",
+                "\nReturns the txids of all confirmed transactions that created or spent an output paying the given address.\n"
+                "Requires the -addressindex option to be enabled.\n",
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The bitcoin address"},
+                },
+                RPCResult{
+                    RPCResult::Type::ARR, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "txid", "The transaction id, in chain order"},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getaddresstxids", "\"1F1tAaz5x1HUXrCNLbtMDqcw6o5GNn4xqX\"")
+                  + HelpExampleRpc("getaddresstxids", "\"1F1tAaz5x1HUXrCNLbtMDqcw6o5GNn4xqX\"")
+                },
+                [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScript script = AddressToIndexedScript(request);
+
+    std::vector<std::pair<int, uint256>> txids;
+    if (!g_addr_index->FindTxIds(script, txids)) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Address index lookup failed");
+    }
+
+    UniValue result(UniValue::VARR);
+    for (const auto& entry : txids) {
+        result.push_back(entry.second.GetHex());
+    }
+    return result;
+},
+    };
+}
+
+static RPCHelpMan getaddressutxos()
+{
+    return RPCHelpMan{"getaddressutxos",
+                "\nReturns all confirmed unspent outputs paying the given address. The mempool is not taken into account.\n"
+                "Requires the -addressindex option to be enabled.\n",
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The bitcoin address"},
+                },
+                RPCResult{
+                    RPCResult::Type::ARR, "", "",
+                    {
+                        {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR_HEX, "txid", "The transaction id of the output"},
+                            {RPCResult::Type::NUM, "vout", "The output number"},
+                            {RPCResult::Type::STR_AMOUNT, "amount", "The output amount in " + CURRENCY_UNIT},
+                            {RPCResult::Type::NUM, "height", "The height of the block the output was created in"},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getaddressutxos", "\"1F1tAaz5x1HUXrCNLbtMDqcw6o5GNn4xqX\"")
+                  + HelpExampleRpc("getaddressutxos", "\"1F1tAaz5x1HUXrCNLbtMDqcw6o5GNn4xqX\"")
+                },
+                [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScript script = AddressToIndexedScript(request);
+
+    std::vector<AddrIndexUtxo> utxos;
+    if (!g_addr_index->FindUtxos(script, utxos)) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Address index lookup failed");
+    }
+
+    UniValue result(UniValue::VARR);
+    for (const auto& utxo : utxos) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("txid", utxo.outpoint.hash.GetHex());
+        obj.pushKV("vout", (int64_t)utxo.outpoint.n);
+        obj.pushKV("amount", ValueFromAmount(utxo.value));
+        obj.pushKV("height", utxo.height);
+        result.push_back(obj);
+    }
+    return result;
+},
+    };
+}
+
+static RPCHelpMan getspentinfo()
+{
+    return RPCHelpMan{"getspentinfo",
+                "\nReturns where a transaction output was spent.\n"
+                "Requires the -spentindex option to be enabled.\n",
+                {
+                    {"txid", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The transaction id of the output"},
+                    {"vout", RPCArg::Type::NUM, RPCArg::Optional::NO, "The output number"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "txid", "The transaction id spending the output"},
+                        {RPCResult::Type::NUM, "index", "The index of the spending input"},
+                        {RPCResult::Type::NUM, "height", "The height of the block containing the spending transaction"},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getspentinfo", "\"0e3e2357e806b6cdb1f70b54c3a3a17b6714ee1f0e68bebb44a74b1efd512098\" 0")
+                  + HelpExampleRpc("getspentinfo", "\"0e3e2357e806b6cdb1f70b54c3a3a17b6714ee1f0e68bebb44a74b1efd512098\", 0")
+                },
+                [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    if (!g_spent_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Spent index is not enabled");
+    }
+
+    const uint256 txid(ParseHashV(request.params[0], "txid"));
+    const int vout{request.params[1].get_int()};
+    if (vout < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid output number");
+    }
+
+    g_spent_index->BlockUntilSyncedToCurrentChain();
+
+    SpentLocation location;
+    if (!g_spent_index->FindSpend(COutPoint{txid, static_cast<uint32_t>(vout)}, location)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unable to get spent info");
+    }
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("txid", location.txid.GetHex());
+    result.pushKV("index", (int64_t)location.input_n);
+    result.pushKV("height", location.height);
+    return result;
+},
+    };
+}
+
 static RPCHelpMan getindexinfo()
 {
     return RPCHelpMan{"getindexinfo",
@@ -689,6 +975,18 @@ static RPCHelpMan getindexinfo()
         result.pushKVs(SummaryToJSON(g_txindex->GetSummary(), index_name));
     }
 
+    if (g_addr_index) {
+        result.pushKVs(SummaryToJSON(g_addr_index->GetSummary(), index_name));
+    }
+
+    if (g_spent_index) {
+        result.pushKVs(SummaryToJSON(g_spent_index->GetSummary(), index_name));
+    }
+
+    if (g_stats_index) {
+        result.pushKVs(SummaryToJSON(g_stats_index->GetSummary(), index_name));
+    }
+
     ForEachBlockFilterIndex([&result, &index_name](const BlockFilterIndex& index) {
         result.pushKVs(SummaryToJSON(index.GetSummary(), index_name));
     });
@@ -706,6 +1004,8 @@ static const CRPCCommand commands[] =
   //  --------------------- ------------------------
     { "control",            &getmemoryinfo,           },
     { "control",            &logging,                 },
+    { "control",            &setcachesizes,           },
+    { "control",            &setsigcachesize,         },
     { "util",               &validateaddress,         },
     { "util",               &createmultisig,          },
     { "util",               &deriveaddresses,         },
@@ -713,6 +1013,9 @@ static const CRPCCommand commands[] =
     { "util",               &verifymessage,           },
     { "util",               &signmessagewithprivkey,  },
     { "util",               &getindexinfo,            },
+    { "blockchain",         &getaddresstxids,         },
+    { "blockchain",         &getaddressutxos,         },
+    { "blockchain",         &getspentinfo,            },
 
     /* Not shown in help */
     { "hidden",             &setmocktime,             },
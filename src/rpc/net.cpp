@@ -135,6 +135,16 @@ static RPCHelpMan getpeerinfo()
                             {
                                 {RPCResult::Type::NUM, "n", "The heights of blocks we're currently asking from this peer"},
                             }},
+                            {RPCResult::Type::NUM, "cmpctblocks_reconstructed", "The number of compact blocks from this peer reconstructed without a getblocktxn round trip"},
+                            {RPCResult::Type::NUM, "cmpctblocks_roundtrips", "The number of compact blocks from this peer that needed a getblocktxn round trip"},
+                            {RPCResult::Type::OBJ, "txrequest", "Transaction request tracker state for this peer",
+                            {
+                                {RPCResult::Type::NUM, "candidates", "Announcements from this peer that are candidates for requesting"},
+                                {RPCResult::Type::NUM, "inflight", "Requests to this peer awaiting a response"},
+                                {RPCResult::Type::NUM, "responses", "Requests this peer has responded to since connecting"},
+                                {RPCResult::Type::NUM, "avg_latency", /* optional */ true, "Mean request-to-response latency in seconds"},
+                                {RPCResult::Type::NUM, "max_latency", /* optional */ true, "Largest request-to-response latency in seconds"},
+                            }},
                             {RPCResult::Type::ARR, "permissions", "Any special permissions that have been granted to this peer",
                             {
                                 {RPCResult::Type::STR, "permission_type", Join(NET_PERMISSIONS_DOC, ",\n") + ".\n"},
@@ -228,6 +238,17 @@ static RPCHelpMan getpeerinfo()
                 heights.push_back(height);
             }
             obj.pushKV("inflight", heights);
+            obj.pushKV("cmpctblocks_reconstructed", statestats.m_cmpctblock_no_roundtrip);
+            obj.pushKV("cmpctblocks_roundtrips", statestats.m_cmpctblock_roundtrip);
+            UniValue txreq(UniValue::VOBJ);
+            txreq.pushKV("candidates", (uint64_t)statestats.m_txrequest.m_candidates);
+            txreq.pushKV("inflight", (uint64_t)statestats.m_txrequest.m_in_flight);
+            txreq.pushKV("responses", statestats.m_txrequest.m_responses);
+            if (statestats.m_txrequest.m_responses > 0) {
+                txreq.pushKV("avg_latency", (statestats.m_txrequest.m_latency_total.count() / statestats.m_txrequest.m_responses) * 0.000001);
+                txreq.pushKV("max_latency", statestats.m_txrequest.m_latency_max.count() * 0.000001);
+            }
+            obj.pushKV("txrequest", txreq);
         }
         UniValue permissions(UniValue::VARR);
         for (const auto& permission : NetPermissions::ToStrings(stats.m_permissionFlags)) {
@@ -490,6 +511,49 @@ static RPCHelpMan getaddednodeinfo()
     };
 }
 
+static RPCHelpMan getmsgstats()
+{
+    return RPCHelpMan{"getmsgstats",
+                "\nReturns cumulative processing statistics for each P2P message type,\n"
+                "measured around message handling since startup.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ_DYN, "", "",
+                    {
+                        {RPCResult::Type::OBJ, "msgtype", "Statistics for this message type",
+                        {
+                            {RPCResult::Type::NUM, "count", "Number of messages processed"},
+                            {RPCResult::Type::NUM, "bytes", "Total wire bytes of processed messages, including header and checksum"},
+                            {RPCResult::Type::NUM, "total_time", "Total processing time in microseconds"},
+                            {RPCResult::Type::NUM, "max_time", "Largest single-message processing time in microseconds"},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getmsgstats", "")
+            + HelpExampleRpc("getmsgstats", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    NodeContext& node = EnsureNodeContext(request.context);
+    if (!node.peerman) {
+        throw JSONRPCError(RPC_CLIENT_P2P_DISABLED, "Error: Peer-to-peer functionality missing or disabled");
+    }
+
+    UniValue obj(UniValue::VOBJ);
+    for (const auto& [msg_type, stats] : node.peerman->GetMessageTypeStats()) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("count", stats.count);
+        entry.pushKV("bytes", stats.bytes);
+        entry.pushKV("total_time", count_microseconds(stats.total_time));
+        entry.pushKV("max_time", count_microseconds(stats.max_time));
+        obj.pushKV(msg_type, entry);
+    }
+    return obj;
+},
+    };
+}
+
 static RPCHelpMan getnettotals()
 {
     return RPCHelpMan{"getnettotals",
@@ -949,6 +1013,7 @@ static const CRPCCommand commands[] =
     { "network",             &disconnectnode,          },
     { "network",             &getaddednodeinfo,        },
     { "network",             &getnettotals,            },
+    { "network",             &getmsgstats,             },
     { "network",             &getnetworkinfo,          },
     { "network",             &setban,                  },
     { "network",             &listbanned,              },
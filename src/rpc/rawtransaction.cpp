@@ -221,6 +221,71 @@ static RPCHelpMan getrawtransaction()
     };
 }
 
+static RPCHelpMan getrawtransactions()
+{
+    return RPCHelpMan{
+                "getrawtransactions",
+                "\nReturn the raw transaction data for an array of txids.\n"
+                "Requires -txindex. Lookups are batched: the disk positions are\n"
+                "sorted first so the block file reads are near-sequential, which is\n"
+                "much faster than repeated getrawtransaction calls for large batches.\n"
+                "Transactions that cannot be found are returned as null; unconfirmed\n"
+                "mempool transactions are included.\n",
+                {
+                    {"txids", RPCArg::Type::ARR, RPCArg::Optional::NO, "The transaction ids",
+                        {
+                            {"txid", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED, "A transaction id"},
+                        },
+                    },
+                },
+                RPCResult{
+                    RPCResult::Type::ARR, "", "serialized transactions in the order of the request",
+                    {
+                        {RPCResult::Type::STR_HEX, "data", "the serialized transaction, or null if not found"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getrawtransactions", "'[\"mytxid1\", \"mytxid2\"]'")
+            + HelpExampleRpc("getrawtransactions", "[\"mytxid1\", \"mytxid2\"]")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    if (!g_txindex) {
+        throw JSONRPCError(RPC_MISC_ERROR, "getrawtransactions requires -txindex");
+    }
+
+    const UniValue& txids = request.params[0].get_array();
+    std::vector<uint256> tx_hashes;
+    tx_hashes.reserve(txids.size());
+    for (size_t i = 0; i < txids.size(); ++i) {
+        tx_hashes.push_back(ParseHashV(txids[i], "txid"));
+    }
+
+    g_txindex->BlockUntilSyncedToCurrentChain();
+
+    std::vector<uint256> block_hashes(tx_hashes.size());
+    std::vector<CTransactionRef> txs(tx_hashes.size());
+    g_txindex->FindTxs(tx_hashes, block_hashes, txs);
+
+    // The index only covers confirmed transactions; pick up any misses from
+    // the mempool.
+    const CTxMemPool& mempool = EnsureMemPool(request.context);
+    for (size_t i = 0; i < txs.size(); ++i) {
+        if (!txs[i]) txs[i] = mempool.get(tx_hashes[i]);
+    }
+
+    UniValue result(UniValue::VARR);
+    for (const CTransactionRef& tx : txs) {
+        if (tx) {
+            result.push_back(EncodeHexTx(*tx, RPCSerializationFlags()));
+        } else {
+            result.push_back(NullUniValue);
+        }
+    }
+    return result;
+},
+    };
+}
+
 static RPCHelpMan gettxoutproof()
 {
     return RPCHelpMan{"gettxoutproof",
@@ -1313,25 +1378,25 @@ static RPCHelpMan combinepsbt()
 {
     RPCTypeCheck(request.params, {UniValue::VARR}, true);
 
-    // Unserialize the transactions
-    std::vector<PartiallySignedTransaction> psbtxs;
+    // Decode and merge the transactions one at a time, so that only one
+    // decoded copy is held in addition to the running result. The merge
+    // consumes each decoded PSBT, splicing its maps instead of copying them.
     UniValue txs = request.params[0].get_array();
     if (txs.empty()) {
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Parameter 'txs' cannot be empty");
     }
+    PartiallySignedTransaction merged_psbt;
     for (unsigned int i = 0; i < txs.size(); ++i) {
         PartiallySignedTransaction psbtx;
         std::string error;
         if (!DecodeBase64PSBT(psbtx, txs[i].get_str(), error)) {
             throw JSONRPCError(RPC_DESERIALIZATION_ERROR, strprintf("TX decode failed %s", error));
         }
-        psbtxs.push_back(psbtx);
-    }
-
-    PartiallySignedTransaction merged_psbt;
-    const TransactionError error = CombinePSBTs(merged_psbt, psbtxs);
-    if (error != TransactionError::OK) {
-        throw JSONRPCTransactionError(error);
+        if (i == 0) {
+            merged_psbt = std::move(psbtx);
+        } else if (!merged_psbt.Merge(std::move(psbtx))) {
+            throw JSONRPCTransactionError(TransactionError::PSBT_MISMATCH);
+        }
     }
 
     CDataStream ssTx(SER_NETWORK, PROTOCOL_VERSION);
@@ -1854,6 +1919,7 @@ static const CRPCCommand commands[] =
 { //  category               actor (function)
   //  ---------------------  -----------------------
     { "rawtransactions",     &getrawtransaction,          },
+    { "rawtransactions",     &getrawtransactions,         },
     { "rawtransactions",     &createrawtransaction,       },
     { "rawtransactions",     &decoderawtransaction,       },
     { "rawtransactions",     &decodescript,               },
@@ -42,6 +42,98 @@ UniValue JSONRPCReplyObj(const UniValue& result, const UniValue& error, const Un
     return reply;
 }
 
+namespace {
+//! Flush threshold for the streaming JSON writer; large replies reach the
+//! sink in chunks of roughly this size.
+constexpr size_t JSON_STREAM_CHUNK_SIZE{65536};
+
+void StreamJSONEscaped(const std::string& in, std::string& buf)
+{
+    for (const char c : in) {
+        const unsigned char uc = c;
+        switch (c) {
+        case '"': buf += "\\\""; break;
+        case '\\': buf += "\\\\"; break;
+        case '\b': buf += "\\b"; break;
+        case '\f': buf += "\\f"; break;
+        case '\n': buf += "\\n"; break;
+        case '\r': buf += "\\r"; break;
+        case '\t': buf += "\\t"; break;
+        default:
+            if (uc < 0x20 || uc == 0x7f) {
+                buf += strprintf("\\u%04x", uc);
+            } else {
+                buf += c;
+            }
+        }
+    }
+}
+
+void StreamJSONValue(const UniValue& val, std::string& buf, const std::function<void(const char*, size_t)>& sink)
+{
+    if (buf.size() >= JSON_STREAM_CHUNK_SIZE) {
+        sink(buf.data(), buf.size());
+        buf.clear();
+    }
+    switch (val.getType()) {
+    case UniValue::VNULL:
+        buf += "null";
+        break;
+    case UniValue::VBOOL:
+        buf += val.getBool() ? "true" : "false";
+        break;
+    case UniValue::VNUM:
+        buf += val.getValStr();
+        break;
+    case UniValue::VSTR:
+        buf += '"';
+        StreamJSONEscaped(val.getValStr(), buf);
+        buf += '"';
+        break;
+    case UniValue::VARR: {
+        buf += '[';
+        const std::vector<UniValue>& values = val.getValues();
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i > 0) buf += ',';
+            StreamJSONValue(values[i], buf, sink);
+        }
+        buf += ']';
+        break;
+    }
+    case UniValue::VOBJ: {
+        buf += '{';
+        const std::vector<std::string>& keys = val.getKeys();
+        const std::vector<UniValue>& values = val.getValues();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (i > 0) buf += ',';
+            buf += '"';
+            StreamJSONEscaped(keys[i], buf);
+            buf += "\":";
+            StreamJSONValue(values[i], buf, sink);
+        }
+        buf += '}';
+        break;
+    }
+    }
+}
+} // namespace
+
+void JSONRPCReplyStreamed(const UniValue& result, const UniValue& error, const UniValue& id, const std::function<void(const char*, size_t)>& sink)
+{
+    std::string buf;
+    buf.reserve(JSON_STREAM_CHUNK_SIZE + 1024);
+    // Same shape as JSONRPCReplyObj, but the result is serialized in place
+    // instead of being copied into an envelope object first.
+    buf += "{\"result\":";
+    StreamJSONValue(error.isNull() ? result : NullUniValue, buf, sink);
+    buf += ",\"error\":";
+    StreamJSONValue(error, buf, sink);
+    buf += ",\"id\":";
+    StreamJSONValue(id, buf, sink);
+    buf += "}\n";
+    sink(buf.data(), buf.size());
+}
+
 std::string JSONRPCReply(const UniValue& result, const UniValue& error, const UniValue& id)
 {
     UniValue reply = JSONRPCReplyObj(result, error, id);
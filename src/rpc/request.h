@@ -6,6 +6,7 @@
 #ifndef BITCOIN_RPC_REQUEST_H
 #define BITCOIN_RPC_REQUEST_H
 
+#include <functional>
 #include <string>
 
 #include <univalue.h>
@@ -17,6 +18,10 @@ class Ref;
 UniValue JSONRPCRequestObj(const std::string& strMethod, const UniValue& params, const UniValue& id);
 UniValue JSONRPCReplyObj(const UniValue& result, const UniValue& error, const UniValue& id);
 std::string JSONRPCReply(const UniValue& result, const UniValue& error, const UniValue& id);
+/** Serialize a JSON-RPC reply in chunks through sink, producing the same
+ * bytes as JSONRPCReply without ever materializing the reply (or the result
+ * value) as a single string. */
+void JSONRPCReplyStreamed(const UniValue& result, const UniValue& error, const UniValue& id, const std::function<void(const char*, size_t)>& sink);
 UniValue JSONRPCError(int code, const std::string& message);
 
 /** Generate a new RPC authentication cookie and write it to disk */
@@ -18,6 +18,7 @@
 #include <cassert>
 #include <memory> // for unique_ptr
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 
 static Mutex g_rpc_warmup_mutex;
@@ -380,9 +381,36 @@ static UniValue JSONRPCExecOne(JSONRPCRequest jreq, const UniValue& req)
 
 std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq)
 {
+    std::vector<UniValue> replies(vReq.size());
+
+    // Batch members are independent requests, and RPC handlers already run
+    // concurrently on the -rpcthreads workers, so members can safely be
+    // executed in parallel. Each batch spawns its own bounded set of worker
+    // threads rather than re-entering the HTTP work queue, which could
+    // deadlock once every queue worker is itself waiting on a batch.
+    size_t concurrency = (size_t)std::max(gArgs.GetArg("-rpcbatchconcurrency", DEFAULT_RPC_BATCH_CONCURRENCY), (int64_t)1);
+    concurrency = std::min(concurrency, (size_t)vReq.size());
+
+    std::atomic<size_t> next_req{0};
+    auto exec_worker = [&] {
+        for (size_t reqIdx = next_req.fetch_add(1); reqIdx < vReq.size(); reqIdx = next_req.fetch_add(1)) {
+            // JSONRPCExecOne catches all errors, turning them into error
+            // replies, so workers never throw.
+            replies[reqIdx] = JSONRPCExecOne(jreq, vReq[reqIdx]);
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(concurrency - 1);
+    for (size_t i = 1; i < concurrency; ++i) {
+        threads.emplace_back(exec_worker);
+    }
+    exec_worker();
+    for (std::thread& t : threads) t.join();
+
+    // Replies are assembled in request order, regardless of completion order.
     UniValue ret(UniValue::VARR);
     for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
-        ret.push_back(JSONRPCExecOne(jreq, vReq[reqIdx]));
+        ret.push_back(replies[reqIdx]);
 
     return ret.write() + "\n";
 }
@@ -18,6 +18,8 @@
 #include <univalue.h>
 
 static const unsigned int DEFAULT_RPC_SERIALIZE_VERSION = 1;
+//! Default -rpcbatchconcurrency: maximum threads executing one JSON-RPC batch
+static const int DEFAULT_RPC_BATCH_CONCURRENCY = 4;
 
 class CRPCCommand;
 
@@ -103,13 +105,13 @@ public:
     }
 
     //! Simplified constructor taking plain RpcMethodFnType function pointer.
+    //! The RPCHelpMan — including every parameter and result doc string — is
+    //! built once here and shared by all invocations, instead of being
+    //! reconstructed on each call. It is immutable after construction, so
+    //! concurrent requests can dispatch through the same instance; the
+    //! expensive help text itself is only rendered when help is requested.
     CRPCCommand(std::string category, RpcMethodFnType fn)
-        : CRPCCommand(
-              category,
-              fn().m_name,
-              [fn](const JSONRPCRequest& request, UniValue& result, bool) { result = fn().HandleRequest(request); return true; },
-              fn().GetArgNames(),
-              intptr_t(fn))
+        : CRPCCommand(std::move(category), std::make_shared<const RPCHelpMan>(fn()), intptr_t(fn))
     {
     }
 
@@ -118,6 +120,17 @@ public:
     Actor actor;
     std::vector<std::string> argNames;
     intptr_t unique_id;
+
+private:
+    CRPCCommand(std::string category, std::shared_ptr<const RPCHelpMan> command, intptr_t unique_id)
+        : CRPCCommand(
+              std::move(category),
+              command->m_name,
+              [command](const JSONRPCRequest& request, UniValue& result, bool) { result = command->HandleRequest(request); return true; },
+              command->GetArgNames(),
+              unique_id)
+    {
+    }
 };
 
 /**
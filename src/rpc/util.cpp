@@ -459,7 +459,7 @@ std::string RPCExamples::ToDescriptionString() const
     return m_examples.empty() ? m_examples : "\nExamples:\n" + m_examples;
 }
 
-UniValue RPCHelpMan::HandleRequest(const JSONRPCRequest& request)
+UniValue RPCHelpMan::HandleRequest(const JSONRPCRequest& request) const
 {
     if (request.mode == JSONRPCRequest::GET_ARGS) {
         return GetArgMap();
@@ -871,10 +871,13 @@ std::vector<CScript> EvalDescriptorStringOrObject(const UniValue& scanobject, Fl
         range.first = 0;
         range.second = 0;
     }
+    // Expand through the shared cache, so repeated scans of the same ranged
+    // descriptor do not re-derive the BIP32 children each time.
+    std::shared_ptr<CachedDescriptor> cached_desc = GetCachedDescriptor(std::move(desc));
     std::vector<CScript> ret;
     for (int i = range.first; i <= range.second; ++i) {
         std::vector<CScript> scripts;
-        if (!desc->Expand(i, provider, scripts, provider)) {
+        if (!cached_desc->Expand(i, provider, scripts, provider)) {
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, strprintf("Cannot derive script without private keys: '%s'", desc_str));
         }
         std::move(scripts.begin(), scripts.end(), std::back_inserter(ret));
@@ -5,6 +5,7 @@
 #include <scheduler.h>
 
 #include <random.h>
+#include <util/threadnames.h>
 
 #include <assert.h>
 #include <functional>
@@ -17,7 +18,7 @@ CScheduler::CScheduler()
 CScheduler::~CScheduler()
 {
     assert(nThreadsServicingQueue == 0);
-    if (stopWhenEmpty) assert(taskQueue.empty());
+    if (stopWhenEmpty) assert(queuesEmpty());
 }
 
 
@@ -31,16 +32,18 @@ void CScheduler::serviceQueue()
     // is called.
     while (!shouldStop()) {
         try {
-            while (!shouldStop() && taskQueue.empty()) {
+            while (!shouldStop() && queuesEmpty()) {
                 // Wait until there is something to do.
                 newTaskScheduled.wait(lock);
             }
 
             // Wait until either there is a new task, or until
-            // the time of the first item on the queue:
+            // the time of the earliest item on either queue:
 
-            while (!shouldStop() && !taskQueue.empty()) {
-                std::chrono::system_clock::time_point timeToWaitFor = taskQueue.begin()->first;
+            while (!shouldStop() && !queuesEmpty()) {
+                std::chrono::system_clock::time_point timeToWaitFor = m_queue_high.empty() ? m_queue_low.begin()->first :
+                    m_queue_low.empty() ? m_queue_high.begin()->first :
+                    std::min(m_queue_high.begin()->first, m_queue_low.begin()->first);
                 if (newTaskScheduled.wait_until(lock, timeToWaitFor) == std::cv_status::timeout) {
                     break; // Exit loop after timeout, it means we reached the time of the event
                 }
@@ -48,18 +51,49 @@ void CScheduler::serviceQueue()
 
             // If there are multiple threads, the queue can empty while we're waiting (another
             // thread may service the task we were waiting on).
-            if (shouldStop() || taskQueue.empty())
+            if (shouldStop() || queuesEmpty())
                 continue;
 
-            Function f = taskQueue.begin()->second;
-            taskQueue.erase(taskQueue.begin());
+            // Prefer a due HIGH task over a due LOW one; if neither is due
+            // yet we were woken for a task further in the future, so go back
+            // to waiting.
+            const auto now{std::chrono::system_clock::now()};
+            TaskQueue* queue{nullptr};
+            if (!m_queue_high.empty() && m_queue_high.begin()->first <= now) {
+                queue = &m_queue_high;
+            } else if (!m_queue_low.empty() && m_queue_low.begin()->first <= now) {
+                queue = &m_queue_low;
+            }
+            if (!queue) continue;
+
+            Task task = std::move(queue->begin()->second);
+            queue->erase(queue->begin());
+
+            if (task.m_exclusive) {
+                // Wait for the running tasks to drain. New tasks (on other
+                // threads) wait below until the exclusive task has finished,
+                // so the drain cannot starve.
+                ++m_exclusive_waiting;
+                while (m_tasks_running > 0) newTaskScheduled.wait(lock);
+                --m_exclusive_waiting;
+                m_exclusive_running = true;
+            } else {
+                while (!stopRequested && (m_exclusive_running || m_exclusive_waiting > 0)) {
+                    newTaskScheduled.wait(lock);
+                }
+            }
+            ++m_tasks_running;
 
             {
-                // Unlock before calling f, so it can reschedule itself or another task
+                // Unlock before calling the task, so it can reschedule itself or another task
                 // without deadlocking:
                 REVERSE_LOCK(lock);
-                f();
+                task.m_func();
             }
+
+            --m_tasks_running;
+            if (task.m_exclusive) m_exclusive_running = false;
+            newTaskScheduled.notify_all();
         } catch (...) {
             --nThreadsServicingQueue;
             throw;
@@ -69,15 +103,26 @@ void CScheduler::serviceQueue()
     newTaskScheduled.notify_one();
 }
 
-void CScheduler::schedule(CScheduler::Function f, std::chrono::system_clock::time_point t)
+void CScheduler::schedule(CScheduler::Function f, std::chrono::system_clock::time_point t, Priority priority, bool exclusive)
 {
     {
         LOCK(newTaskMutex);
-        taskQueue.insert(std::make_pair(t, f));
+        TaskQueue& queue = (priority == Priority::HIGH) ? m_queue_high : m_queue_low;
+        queue.insert(std::make_pair(t, Task{std::move(f), exclusive}));
     }
     newTaskScheduled.notify_one();
 }
 
+void CScheduler::StartWorkers(int num_threads)
+{
+    for (int i = 0; i < num_threads; ++i) {
+        m_worker_threads.emplace_back([this] {
+            util::ThreadRename("schedworker");
+            serviceQueue();
+        });
+    }
+}
+
 void CScheduler::MockForward(std::chrono::seconds delta_seconds)
 {
     assert(delta_seconds.count() > 0 && delta_seconds < std::chrono::hours{1});
@@ -85,40 +130,41 @@ void CScheduler::MockForward(std::chrono::seconds delta_seconds)
     {
         LOCK(newTaskMutex);
 
-        // use temp_queue to maintain updated schedule
-        std::multimap<std::chrono::system_clock::time_point, Function> temp_queue;
-
-        for (const auto& element : taskQueue) {
-            temp_queue.emplace_hint(temp_queue.cend(), element.first - delta_seconds, element.second);
+        // use a temporary to maintain the updated schedule
+        for (TaskQueue* queue : {&m_queue_high, &m_queue_low}) {
+            TaskQueue temp_queue;
+            for (auto& element : *queue) {
+                temp_queue.emplace_hint(temp_queue.cend(), element.first - delta_seconds, std::move(element.second));
+            }
+            *queue = std::move(temp_queue);
         }
-
-        // point taskQueue to temp_queue
-        taskQueue = std::move(temp_queue);
     }
 
     // notify that the taskQueue needs to be processed
     newTaskScheduled.notify_one();
 }
 
-static void Repeat(CScheduler& s, CScheduler::Function f, std::chrono::milliseconds delta)
+static void Repeat(CScheduler& s, CScheduler::Function f, std::chrono::milliseconds delta, CScheduler::Priority priority, bool exclusive)
 {
     f();
-    s.scheduleFromNow([=, &s] { Repeat(s, f, delta); }, delta);
+    s.scheduleFromNow([=, &s] { Repeat(s, f, delta, priority, exclusive); }, delta, priority, exclusive);
 }
 
-void CScheduler::scheduleEvery(CScheduler::Function f, std::chrono::milliseconds delta)
+void CScheduler::scheduleEvery(CScheduler::Function f, std::chrono::milliseconds delta, Priority priority, bool exclusive)
 {
-    scheduleFromNow([=] { Repeat(*this, f, delta); }, delta);
+    scheduleFromNow([=] { Repeat(*this, f, delta, priority, exclusive); }, delta, priority, exclusive);
 }
 
 size_t CScheduler::getQueueInfo(std::chrono::system_clock::time_point& first,
                                 std::chrono::system_clock::time_point& last) const
 {
     LOCK(newTaskMutex);
-    size_t result = taskQueue.size();
-    if (!taskQueue.empty()) {
-        first = taskQueue.begin()->first;
-        last = taskQueue.rbegin()->first;
+    size_t result = m_queue_high.size() + m_queue_low.size();
+    if (!queuesEmpty()) {
+        first = std::min(m_queue_high.empty() ? m_queue_low.begin()->first : m_queue_high.begin()->first,
+                         m_queue_low.empty() ? m_queue_high.begin()->first : m_queue_low.begin()->first);
+        last = std::max(m_queue_high.empty() ? m_queue_low.rbegin()->first : m_queue_high.rbegin()->first,
+                        m_queue_low.empty() ? m_queue_high.rbegin()->first : m_queue_low.rbegin()->first);
     }
     return result;
 }
@@ -140,7 +186,9 @@ void SingleThreadedSchedulerClient::MaybeScheduleProcessQueue()
         if (m_are_callbacks_running) return;
         if (m_callbacks_pending.empty()) return;
     }
-    m_pscheduler->schedule(std::bind(&SingleThreadedSchedulerClient::ProcessQueue, this), std::chrono::system_clock::now());
+    // HIGH priority: validation interface callbacks must not wait behind
+    // slow background maintenance tasks.
+    m_pscheduler->schedule(std::bind(&SingleThreadedSchedulerClient::ProcessQueue, this), std::chrono::system_clock::now(), CScheduler::Priority::HIGH);
 }
 
 void SingleThreadedSchedulerClient::ProcessQueue()
@@ -10,9 +10,13 @@
 #include <list>
 #include <map>
 #include <thread>
+#include <vector>
 
 #include <sync.h>
 
+/** Default for -schedulerthreads */
+static const int DEFAULT_SCHEDULER_THREADS = 1;
+
 /**
  * Simple class for background tasks that should be run
  * periodically or once "after a while"
@@ -40,13 +44,31 @@ public:
 
     typedef std::function<void()> Function;
 
-    /** Call func at/after time t */
-    void schedule(Function f, std::chrono::system_clock::time_point t);
+    /**
+     * Scheduling priority. When several tasks are due, HIGH tasks are always
+     * picked before LOW ones; within a priority tasks run in time order.
+     * Validation interface callbacks are scheduled HIGH so that slow
+     * maintenance tasks cannot head-of-line block notifications.
+     */
+    enum class Priority {
+        HIGH,
+        LOW,
+    };
+
+    /**
+     * Call func at/after time t.
+     *
+     * With multiple worker threads (see StartWorkers), tasks may run
+     * concurrently. A task scheduled with exclusive=true waits for running
+     * tasks to drain and blocks new ones while it runs, restoring the
+     * single-thread semantics for tasks that need them.
+     */
+    void schedule(Function f, std::chrono::system_clock::time_point t, Priority priority = Priority::LOW, bool exclusive = false);
 
     /** Call f once after the delta has passed */
-    void scheduleFromNow(Function f, std::chrono::milliseconds delta)
+    void scheduleFromNow(Function f, std::chrono::milliseconds delta, Priority priority = Priority::LOW, bool exclusive = false)
     {
-        schedule(std::move(f), std::chrono::system_clock::now() + delta);
+        schedule(std::move(f), std::chrono::system_clock::now() + delta, priority, exclusive);
     }
 
     /**
@@ -55,7 +77,14 @@ public:
      * The timing is not exact: Every time f is finished, it is rescheduled to run again after delta. If you need more
      * accurate scheduling, don't use this method.
      */
-    void scheduleEvery(Function f, std::chrono::milliseconds delta);
+    void scheduleEvery(Function f, std::chrono::milliseconds delta, Priority priority = Priority::LOW, bool exclusive = false);
+
+    /**
+     * Spawn additional serviceQueue worker threads (beyond m_service_thread),
+     * so one slow task does not delay every task queued behind it. Joined by
+     * stop()/StopWhenDrained().
+     */
+    void StartWorkers(int num_threads);
 
     /**
      * Mock the scheduler to fast forward in time.
@@ -75,6 +104,7 @@ public:
         WITH_LOCK(newTaskMutex, stopRequested = true);
         newTaskScheduled.notify_all();
         if (m_service_thread.joinable()) m_service_thread.join();
+        JoinWorkers();
     }
     /** Tell any threads running serviceQueue to stop when there is no work left to be done */
     void StopWhenDrained()
@@ -82,6 +112,7 @@ public:
         WITH_LOCK(newTaskMutex, stopWhenEmpty = true);
         newTaskScheduled.notify_all();
         if (m_service_thread.joinable()) m_service_thread.join();
+        JoinWorkers();
     }
 
     /**
@@ -95,13 +126,35 @@ public:
     bool AreThreadsServicingQueue() const;
 
 private:
+    struct Task {
+        Function m_func;
+        bool m_exclusive{false};
+    };
+    typedef std::multimap<std::chrono::system_clock::time_point, Task> TaskQueue;
+
     mutable Mutex newTaskMutex;
     std::condition_variable newTaskScheduled;
-    std::multimap<std::chrono::system_clock::time_point, Function> taskQueue GUARDED_BY(newTaskMutex);
+    //! Pending tasks, one queue per priority.
+    TaskQueue m_queue_high GUARDED_BY(newTaskMutex);
+    TaskQueue m_queue_low GUARDED_BY(newTaskMutex);
+    std::vector<std::thread> m_worker_threads;
     int nThreadsServicingQueue GUARDED_BY(newTaskMutex){0};
+    //! Tasks currently executing on serviceQueue threads.
+    int m_tasks_running GUARDED_BY(newTaskMutex){0};
+    //! Threads that have picked an exclusive task and wait for running tasks to drain.
+    int m_exclusive_waiting GUARDED_BY(newTaskMutex){0};
+    bool m_exclusive_running GUARDED_BY(newTaskMutex){false};
     bool stopRequested GUARDED_BY(newTaskMutex){false};
     bool stopWhenEmpty GUARDED_BY(newTaskMutex){false};
-    bool shouldStop() const EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex) { return stopRequested || (stopWhenEmpty && taskQueue.empty()); }
+    bool queuesEmpty() const EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex) { return m_queue_high.empty() && m_queue_low.empty(); }
+    bool shouldStop() const EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex) { return stopRequested || (stopWhenEmpty && queuesEmpty()); }
+    void JoinWorkers()
+    {
+        for (std::thread& thread : m_worker_threads) {
+            if (thread.joinable()) thread.join();
+        }
+        m_worker_threads.clear();
+    }
 };
 
 /**
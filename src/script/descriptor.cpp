@@ -1231,3 +1231,57 @@ const std::unordered_map<uint32_t, ExtPubKeyMap> DescriptorCache::GetCachedDeriv
 {
     return m_derived_xpubs;
 }
+
+bool CachedDescriptor::Expand(int pos, const SigningProvider& provider, std::vector<CScript>& output_scripts, FlatSigningProvider& out) const
+{
+    if (!m_descriptor->IsRange()) pos = 0;
+    LOCK(m_mutex);
+    auto it = m_expansions.find(pos);
+    if (it == m_expansions.end()) {
+        std::vector<CScript> scripts;
+        FlatSigningProvider expansion;
+        // Try the key cache first; only fall back to full BIP32 derivation
+        // for positions no caller has expanded yet.
+        if (!m_descriptor->ExpandFromCache(pos, m_cache, scripts, expansion) &&
+            !m_descriptor->Expand(pos, provider, scripts, expansion, &m_cache)) {
+            return false;
+        }
+        if (m_expansions.size() >= MAX_CACHED_EXPANSIONS) {
+            it = m_expansions.end();
+            output_scripts = std::move(scripts);
+            out.scripts.insert(expansion.scripts.begin(), expansion.scripts.end());
+            out.pubkeys.insert(expansion.pubkeys.begin(), expansion.pubkeys.end());
+            out.origins.insert(expansion.origins.begin(), expansion.origins.end());
+            out.keys.insert(expansion.keys.begin(), expansion.keys.end());
+            return true;
+        }
+        it = m_expansions.emplace(pos, std::make_pair(std::move(scripts), std::move(expansion))).first;
+    }
+    output_scripts = it->second.first;
+    const FlatSigningProvider& expansion = it->second.second;
+    out.scripts.insert(expansion.scripts.begin(), expansion.scripts.end());
+    out.pubkeys.insert(expansion.pubkeys.begin(), expansion.pubkeys.end());
+    out.origins.insert(expansion.origins.begin(), expansion.origins.end());
+    out.keys.insert(expansion.keys.begin(), expansion.keys.end());
+    return true;
+}
+
+std::shared_ptr<CachedDescriptor> GetCachedDescriptor(std::unique_ptr<Descriptor> descriptor)
+{
+    //! Process-wide registry of descriptor caches, keyed by descriptor string.
+    static Mutex g_cached_descriptors_mutex;
+    static std::map<std::string, std::shared_ptr<CachedDescriptor>> g_cached_descriptors GUARDED_BY(g_cached_descriptors_mutex);
+    //! Bound on distinct descriptors remembered; the registry is emptied when
+    //! it fills up, on the assumption that a workload which expands millions
+    //! of descriptors rotates through a small working set of them.
+    static constexpr size_t MAX_CACHED_DESCRIPTORS{1000};
+
+    const std::string key = descriptor->ToString();
+    LOCK(g_cached_descriptors_mutex);
+    auto it = g_cached_descriptors.find(key);
+    if (it != g_cached_descriptors.end()) return it->second;
+    if (g_cached_descriptors.size() >= MAX_CACHED_DESCRIPTORS) g_cached_descriptors.clear();
+    auto handle = std::make_shared<CachedDescriptor>(std::move(descriptor));
+    g_cached_descriptors.emplace(key, handle);
+    return handle;
+}
@@ -9,7 +9,10 @@
 #include <script/script.h>
 #include <script/sign.h>
 #include <script/signingprovider.h>
+#include <sync.h>
 
+#include <map>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -127,6 +130,52 @@ struct Descriptor {
     virtual std::optional<OutputType> GetOutputType() const = 0;
 };
 
+/** A parsed descriptor paired with a persistent, thread-safe expansion cache.
+ *
+ * Expanding a ranged descriptor derives BIP32 children through
+ * CExtPubKey::Derive for every key expression, which dominates the cost of
+ * repeated expansions. CachedDescriptor remembers the derived xpubs in a
+ * DescriptorCache and the complete expansion (scriptPubKeys plus the solving
+ * data that accompanies them) per derivation index, so expanding the same
+ * position again is a map lookup. All methods are thread-safe.
+ */
+class CachedDescriptor
+{
+private:
+    //! Cap on the number of per-index expansions kept, so a scan over a huge
+    //! range cannot pin an unbounded amount of memory.
+    static constexpr size_t MAX_CACHED_EXPANSIONS{100000};
+
+    const std::shared_ptr<const Descriptor> m_descriptor;
+
+    mutable Mutex m_mutex;
+    //! Derived xpubs, shared by all positions.
+    mutable DescriptorCache m_cache GUARDED_BY(m_mutex);
+    //! Fully expanded scriptPubKeys and their solving data, by derivation index.
+    mutable std::map<int, std::pair<std::vector<CScript>, FlatSigningProvider>> m_expansions GUARDED_BY(m_mutex);
+
+public:
+    explicit CachedDescriptor(std::unique_ptr<Descriptor> descriptor) : m_descriptor(std::move(descriptor)) {}
+
+    const Descriptor& GetDescriptor() const { return *m_descriptor; }
+
+    /** Expand the descriptor at the specified position, through the cache.
+     *
+     * Same semantics as Descriptor::Expand, except that the derived keys and
+     * the expansion itself are remembered across calls (and across callers
+     * sharing this handle). Solving data for the position is merged into `out`.
+     */
+    bool Expand(int pos, const SigningProvider& provider, std::vector<CScript>& output_scripts, FlatSigningProvider& out) const;
+};
+
+/** Get a shared CachedDescriptor handle for a parsed descriptor.
+ *
+ * Handles are kept in a process-wide registry keyed by the descriptor's
+ * string form, so that different callers (scantxoutset, deriveaddresses, ...)
+ * expanding the same descriptor share one derivation cache.
+ */
+std::shared_ptr<CachedDescriptor> GetCachedDescriptor(std::unique_ptr<Descriptor> descriptor);
+
 /** Parse a `descriptor` string. Included private keys are put in `out`.
  *
  * If the descriptor has a checksum, it must be valid. If `require_checksum`
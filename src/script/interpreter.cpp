@@ -53,13 +53,76 @@ bool CastToBool(const valtype& vch)
  */
 #define stacktop(i)  (stack.at(stack.size()+(i)))
 #define altstacktop(i)  (altstack.at(altstack.size()+(i)))
+
+namespace {
+/** Recycled storage for script stack elements.
+ *
+ * Nearly every push in EvalScript copies a value into a freshly allocated
+ * element vector, and nearly every pop frees one again; over a block's worth
+ * of script checks that is millions of small heap allocations. Instead of
+ * freeing popped elements, park their buffers here with capacity intact and
+ * hand them back out on the next push, so a thread's working set of buffers
+ * is allocated once and then recycled. Script checks run concurrently on the
+ * scriptcheck threads, so the pool is per thread.
+ */
+class StackBufferPool
+{
+private:
+    std::vector<valtype> m_buffers;
+
+public:
+    //! Get a cleared buffer, reusing a parked one when available.
+    valtype Take()
+    {
+        if (m_buffers.empty()) return valtype();
+        valtype buf{std::move(m_buffers.back())};
+        m_buffers.pop_back();
+        buf.clear();
+        return buf;
+    }
+
+    //! Get a buffer holding a copy of value.
+    valtype Take(const valtype& value)
+    {
+        valtype buf{Take()};
+        buf.assign(value.begin(), value.end());
+        return buf;
+    }
+
+    //! Park a no longer needed buffer for reuse. Oversized or excess buffers
+    //! are dropped so the pool stays bounded: at most the deepest possible
+    //! stack plus altstack of maximum-size elements (roughly 1 MiB).
+    void Give(valtype&& buf)
+    {
+        if (buf.capacity() > MAX_SCRIPT_ELEMENT_SIZE) return;
+        if (m_buffers.size() >= 2 * size_t{MAX_STACK_SIZE}) return;
+        m_buffers.push_back(std::move(buf));
+    }
+};
+thread_local StackBufferPool g_stack_buffers;
+} // namespace
+
 static inline void popstack(std::vector<valtype>& stack)
 {
     if (stack.empty())
         throw std::runtime_error("popstack(): stack empty");
+    g_stack_buffers.Give(std::move(stack.back()));
     stack.pop_back();
 }
 
+//! Push a copy of value, backed by a recycled buffer when one is available.
+//! The value may alias an element of stack: the copy is taken before the
+//! stack itself is touched.
+static inline void pushstack(std::vector<valtype>& stack, const valtype& value)
+{
+    stack.push_back(g_stack_buffers.Take(value));
+}
+
+static inline void pushstack(std::vector<valtype>& stack, valtype&& value)
+{
+    stack.push_back(std::move(value));
+}
+
 bool static IsCompressedOrUncompressedPubKey(const valtype &vchPubKey) {
     if (vchPubKey.size() < CPubKey::COMPRESSED_SIZE) {
         //  Non-canonical public key: too short
@@ -503,7 +566,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                 if (fRequireMinimal && !CheckMinimalPush(vchPushValue, opcode)) {
                     return set_error(serror, SCRIPT_ERR_MINIMALDATA);
                 }
-                stack.push_back(vchPushValue);
+                pushstack(stack, vchPushValue);
             } else if (fExec || (OP_IF <= opcode && opcode <= OP_ENDIF))
             switch (opcode)
             {
@@ -530,7 +593,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                 {
                     // ( -- value)
                     CScriptNum bn((int)opcode - (int)(OP_1 - 1));
-                    stack.push_back(bn.getvch());
+                    pushstack(stack, bn.getvch());
                     // The result of these opcodes should always be the minimal way to push the data
                     // they push, so no need for a CheckMinimalPush here.
                 }
@@ -702,8 +765,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                 {
                     if (stack.size() < 1)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    altstack.push_back(stacktop(-1));
-                    popstack(stack);
+                    altstack.push_back(std::move(stacktop(-1)));
+                    stack.pop_back();
                 }
                 break;
 
@@ -711,8 +774,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                 {
                     if (altstack.size() < 1)
                         return set_error(serror, SCRIPT_ERR_INVALID_ALTSTACK_OPERATION);
-                    stack.push_back(altstacktop(-1));
-                    popstack(altstack);
+                    stack.push_back(std::move(altstacktop(-1)));
+                    altstack.pop_back();
                 }
                 break;
 
@@ -731,10 +794,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x1 x2 -- x1 x2 x1 x2)
                     if (stack.size() < 2)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch1 = stacktop(-2);
-                    valtype vch2 = stacktop(-1);
-                    stack.push_back(vch1);
-                    stack.push_back(vch2);
+                    pushstack(stack, stacktop(-2));
+                    pushstack(stack, stacktop(-2));
                 }
                 break;
 
@@ -743,12 +804,9 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x1 x2 x3 -- x1 x2 x3 x1 x2 x3)
                     if (stack.size() < 3)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch1 = stacktop(-3);
-                    valtype vch2 = stacktop(-2);
-                    valtype vch3 = stacktop(-1);
-                    stack.push_back(vch1);
-                    stack.push_back(vch2);
-                    stack.push_back(vch3);
+                    pushstack(stack, stacktop(-3));
+                    pushstack(stack, stacktop(-3));
+                    pushstack(stack, stacktop(-3));
                 }
                 break;
 
@@ -757,10 +815,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x1 x2 x3 x4 -- x1 x2 x3 x4 x1 x2)
                     if (stack.size() < 4)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch1 = stacktop(-4);
-                    valtype vch2 = stacktop(-3);
-                    stack.push_back(vch1);
-                    stack.push_back(vch2);
+                    pushstack(stack, stacktop(-4));
+                    pushstack(stack, stacktop(-4));
                 }
                 break;
 
@@ -769,11 +825,11 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x1 x2 x3 x4 x5 x6 -- x3 x4 x5 x6 x1 x2)
                     if (stack.size() < 6)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch1 = stacktop(-6);
-                    valtype vch2 = stacktop(-5);
+                    valtype vch1 = std::move(stacktop(-6));
+                    valtype vch2 = std::move(stacktop(-5));
                     stack.erase(stack.end()-6, stack.end()-4);
-                    stack.push_back(vch1);
-                    stack.push_back(vch2);
+                    stack.push_back(std::move(vch1));
+                    stack.push_back(std::move(vch2));
                 }
                 break;
 
@@ -792,9 +848,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x - 0 | x x)
                     if (stack.size() < 1)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch = stacktop(-1);
-                    if (CastToBool(vch))
-                        stack.push_back(vch);
+                    if (CastToBool(stacktop(-1)))
+                        pushstack(stack, stacktop(-1));
                 }
                 break;
 
@@ -802,7 +857,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                 {
                     // -- stacksize
                     CScriptNum bn(stack.size());
-                    stack.push_back(bn.getvch());
+                    pushstack(stack, bn.getvch());
                 }
                 break;
 
@@ -820,8 +875,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x -- x x)
                     if (stack.size() < 1)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch = stacktop(-1);
-                    stack.push_back(vch);
+                    pushstack(stack, stacktop(-1));
                 }
                 break;
 
@@ -839,8 +893,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x1 x2 -- x1 x2 x1)
                     if (stack.size() < 2)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch = stacktop(-2);
-                    stack.push_back(vch);
+                    pushstack(stack, stacktop(-2));
                 }
                 break;
 
@@ -855,10 +908,13 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     popstack(stack);
                     if (n < 0 || n >= (int)stack.size())
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch = stacktop(-n-1);
-                    if (opcode == OP_ROLL)
+                    if (opcode == OP_ROLL) {
+                        valtype vch = std::move(stacktop(-n-1));
                         stack.erase(stack.end()-n-1);
-                    stack.push_back(vch);
+                        stack.push_back(std::move(vch));
+                    } else {
+                        pushstack(stack, stacktop(-n-1));
+                    }
                 }
                 break;
 
@@ -888,8 +944,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     // (x1 x2 -- x2 x1 x2)
                     if (stack.size() < 2)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
-                    valtype vch = stacktop(-1);
-                    stack.insert(stack.end()-2, vch);
+                    stack.insert(stack.end()-2, g_stack_buffers.Take(stacktop(-1)));
                 }
                 break;
 
@@ -900,7 +955,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     if (stack.size() < 1)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
                     CScriptNum bn(stacktop(-1).size());
-                    stack.push_back(bn.getvch());
+                    pushstack(stack, bn.getvch());
                 }
                 break;
 
@@ -925,7 +980,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     //    fEqual = !fEqual;
                     popstack(stack);
                     popstack(stack);
-                    stack.push_back(fEqual ? vchTrue : vchFalse);
+                    pushstack(stack, fEqual ? vchTrue : vchFalse);
                     if (opcode == OP_EQUALVERIFY)
                     {
                         if (fEqual)
@@ -962,7 +1017,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     default:            assert(!"invalid opcode"); break;
                     }
                     popstack(stack);
-                    stack.push_back(bn.getvch());
+                    pushstack(stack, bn.getvch());
                 }
                 break;
 
@@ -1011,7 +1066,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     }
                     popstack(stack);
                     popstack(stack);
-                    stack.push_back(bn.getvch());
+                    pushstack(stack, bn.getvch());
 
                     if (opcode == OP_NUMEQUALVERIFY)
                     {
@@ -1035,7 +1090,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     popstack(stack);
                     popstack(stack);
                     popstack(stack);
-                    stack.push_back(fValue ? vchTrue : vchFalse);
+                    pushstack(stack, fValue ? vchTrue : vchFalse);
                 }
                 break;
 
@@ -1053,7 +1108,8 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     if (stack.size() < 1)
                         return set_error(serror, SCRIPT_ERR_INVALID_STACK_OPERATION);
                     valtype& vch = stacktop(-1);
-                    valtype vchHash((opcode == OP_RIPEMD160 || opcode == OP_SHA1 || opcode == OP_HASH160) ? 20 : 32);
+                    valtype vchHash{g_stack_buffers.Take()};
+                    vchHash.resize((opcode == OP_RIPEMD160 || opcode == OP_SHA1 || opcode == OP_HASH160) ? 20 : 32);
                     if (opcode == OP_RIPEMD160)
                         CRIPEMD160().Write(vch.data(), vch.size()).Finalize(vchHash.data());
                     else if (opcode == OP_SHA1)
@@ -1065,7 +1121,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     else if (opcode == OP_HASH256)
                         CHash256().Write(vch).Finalize(vchHash);
                     popstack(stack);
-                    stack.push_back(vchHash);
+                    stack.push_back(std::move(vchHash));
                 }
                 break;
 
@@ -1094,7 +1150,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     if (!EvalChecksig(vchSig, vchPubKey, pbegincodehash, pend, execdata, flags, checker, sigversion, serror, fSuccess)) return false;
                     popstack(stack);
                     popstack(stack);
-                    stack.push_back(fSuccess ? vchTrue : vchFalse);
+                    pushstack(stack, fSuccess ? vchTrue : vchFalse);
                     if (opcode == OP_CHECKSIGVERIFY)
                     {
                         if (fSuccess)
@@ -1122,7 +1178,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                     popstack(stack);
                     popstack(stack);
                     popstack(stack);
-                    stack.push_back((num + (success ? 1 : 0)).getvch());
+                    pushstack(stack, (num + (success ? 1 : 0)).getvch());
                 }
                 break;
 
@@ -1226,7 +1282,7 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
                         return set_error(serror, SCRIPT_ERR_SIG_NULLDUMMY);
                     popstack(stack);
 
-                    stack.push_back(fSuccess ? vchTrue : vchFalse);
+                    pushstack(stack, fSuccess ? vchTrue : vchFalse);
 
                     if (opcode == OP_CHECKMULTISIGVERIFY)
                     {
@@ -1573,6 +1629,10 @@ bool SignatureHashSchnorr(uint256& hash_out, const ScriptExecutionData& execdata
     return true;
 }
 
+// explicit instantiation
+template bool SignatureHashSchnorr(uint256& hash_out, const ScriptExecutionData& execdata, const CTransaction& tx_to, uint32_t in_pos, uint8_t hash_type, SigVersion sigversion, const PrecomputedTransactionData& cache);
+template bool SignatureHashSchnorr(uint256& hash_out, const ScriptExecutionData& execdata, const CMutableTransaction& tx_to, uint32_t in_pos, uint8_t hash_type, SigVersion sigversion, const PrecomputedTransactionData& cache);
+
 template <class T>
 uint256 SignatureHash(const CScript& scriptCode, const T& txTo, unsigned int nIn, int nHashType, const CAmount& amount, SigVersion sigversion, const PrecomputedTransactionData* cache)
 {
@@ -1940,6 +2000,83 @@ static bool VerifyWitnessProgram(const CScriptWitness& witness, int witversion,
     // There is intentionally no return statement here, to be able to use "control reaches end of non-void function" warnings to detect gaps in the logic above.
 }
 
+/** Byte-pattern matchers for the canonical single-key output forms (the same
+ * patterns Solver() recognizes, matched directly on the raw script). */
+static bool IsCanonicalP2PKH(const CScript& script)
+{
+    return script.size() == 25 && script[0] == OP_DUP && script[1] == OP_HASH160 && script[2] == 0x14 &&
+           script[23] == OP_EQUALVERIFY && script[24] == OP_CHECKSIG;
+}
+static bool IsCanonicalP2WPKH(const CScript& script)
+{
+    return script.size() == 22 && script[0] == OP_0 && script[1] == 0x14;
+}
+static bool IsCanonicalP2TR(const CScript& script)
+{
+    return script.size() == 34 && script[0] == OP_1 && script[1] == 0x20;
+}
+
+/** Straight-line verification of exact P2PKH, P2WPKH and P2TR key path
+ * spends: parse the key material, check the committed key hash, check the
+ * signature. Applies the same encoding and flag checks the interpreter would,
+ * in the same order, so it may return true only when the general path would.
+ * Returns false both for invalid spends and for anything outside the exact
+ * patterns; the caller then runs the general interpreter, which reproduces
+ * the precise error. P2WSH and taproot script paths always take the general
+ * path since they execute an arbitrary inner script anyway.
+ */
+static bool TryVerifyCanonicalSpend(const CScript& scriptSig, const CScript& scriptPubKey, const CScriptWitness& witness, unsigned int flags, const BaseSignatureChecker& checker)
+{
+    ScriptError discard;
+    if (IsCanonicalP2PKH(scriptPubKey)) {
+        if (!witness.IsNull()) return false;
+        // scriptSig must be exactly <sig> <pubkey>, minimally pushed (if it
+        // is valid but not minimal, the general path handles it).
+        valtype sig, pubkey;
+        CScript::const_iterator pc = scriptSig.begin();
+        opcodetype opcode;
+        if (!scriptSig.GetOp(pc, opcode, sig) || opcode > OP_PUSHDATA4 || !CheckMinimalPush(sig, opcode)) return false;
+        if (!scriptSig.GetOp(pc, opcode, pubkey) || opcode > OP_PUSHDATA4 || !CheckMinimalPush(pubkey, opcode)) return false;
+        if (pc != scriptSig.end()) return false;
+        if (sig.empty() || sig.size() > MAX_SCRIPT_ELEMENT_SIZE || pubkey.size() > MAX_SCRIPT_ELEMENT_SIZE) return false;
+        unsigned char keyhash[20];
+        CHash160().Write(pubkey).Finalize(keyhash);
+        if (!std::equal(keyhash, keyhash + 20, scriptPubKey.begin() + 3)) return false;
+        if (!CheckSignatureEncoding(sig, flags, &discard) || !CheckPubKeyEncoding(pubkey, flags, SigVersion::BASE, &discard)) return false;
+        // The signature cannot appear inside the 25-byte scriptPubKey, so
+        // FindAndDelete is a no-op and the script code is the scriptPubKey.
+        return checker.CheckECDSASignature(sig, pubkey, scriptPubKey, SigVersion::BASE);
+    }
+    if (!(flags & SCRIPT_VERIFY_WITNESS)) return false;
+    if (!scriptSig.empty()) return false;
+    if (IsCanonicalP2WPKH(scriptPubKey)) {
+        if (witness.stack.size() != 2) return false;
+        const valtype& sig = witness.stack[0];
+        const valtype& pubkey = witness.stack[1];
+        if (sig.empty() || sig.size() > MAX_SCRIPT_ELEMENT_SIZE || pubkey.size() > MAX_SCRIPT_ELEMENT_SIZE) return false;
+        const valtype program(scriptPubKey.begin() + 2, scriptPubKey.begin() + 22);
+        unsigned char keyhash[20];
+        CHash160().Write(pubkey).Finalize(keyhash);
+        if (!std::equal(keyhash, keyhash + 20, program.begin())) return false;
+        if (!CheckSignatureEncoding(sig, flags, &discard) || !CheckPubKeyEncoding(pubkey, flags, SigVersion::WITNESS_V0, &discard)) return false;
+        // BIP143: the script code is the P2PKH script for the program.
+        CScript script_code;
+        script_code << OP_DUP << OP_HASH160 << program << OP_EQUALVERIFY << OP_CHECKSIG;
+        return checker.CheckECDSASignature(sig, pubkey, script_code, SigVersion::WITNESS_V0);
+    }
+    if (IsCanonicalP2TR(scriptPubKey)) {
+        if (!(flags & SCRIPT_VERIFY_TAPROOT)) return false;
+        // A single witness element is a key path signature; annexes and
+        // script paths go through the general path.
+        if (witness.stack.size() != 1) return false;
+        ScriptExecutionData execdata;
+        execdata.m_annex_init = true;
+        execdata.m_annex_present = false;
+        return checker.CheckSchnorrSignature(witness.stack[0], Span<const unsigned char>{scriptPubKey.data() + 2, 32}, SigVersion::TAPROOT, execdata, &discard);
+    }
+    return false;
+}
+
 bool VerifyScript(const CScript& scriptSig, const CScript& scriptPubKey, const CScriptWitness* witness, unsigned int flags, const BaseSignatureChecker& checker, ScriptError* serror)
 {
     static const CScriptWitness emptyWitness;
@@ -1950,6 +2087,13 @@ bool VerifyScript(const CScript& scriptSig, const CScript& scriptPubKey, const C
 
     set_error(serror, SCRIPT_ERR_UNKNOWN_ERROR);
 
+    // The common case by far is a spend of one of the canonical single-key
+    // output forms; dispatch those to a specialized routine that skips the
+    // opcode loop entirely.
+    if (TryVerifyCanonicalSpend(scriptSig, scriptPubKey, *witness, flags, checker)) {
+        return set_success(serror);
+    }
+
     if ((flags & SCRIPT_VERIFY_SIGPUSHONLY) != 0 && !scriptSig.IsPushOnly()) {
         return set_error(serror, SCRIPT_ERR_SIG_PUSHONLY);
     }
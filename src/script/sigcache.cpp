@@ -5,6 +5,8 @@
 
 #include <script/sigcache.h>
 
+#include <crypto/common.h>
+#include <crypto/siphash.h>
 #include <pubkey.h>
 #include <random.h>
 #include <uint256.h>
@@ -26,41 +28,55 @@ namespace {
 class CSignatureCache
 {
 private:
-     //! Entries are SHA256(nonce || 'E' or 'S' || 31 zero bytes || signature hash || public key || signature):
-    CSHA256 m_salted_hasher_ecdsa;
-    CSHA256 m_salted_hasher_schnorr;
+    //! Entries are derived with a keyed SipHash-2-4 over
+    //! ('E' or 'S' || signature hash || public key || signature). The key is a
+    //! random per-process nonce, so an attacker cannot construct colliding
+    //! entries. A single 64-bit SipHash output is too narrow to compare cache
+    //! entries with (a chance collision would make an invalid signature pass),
+    //! so the 256-bit entry is built from four finalizations of the same
+    //! absorbed message, each distinguished by a one-byte lane tag. This also
+    //! keeps all 32 bytes high-entropy for the cuckoo table's slot selection.
+    CSipHasher m_hasher_ecdsa;
+    CSipHasher m_hasher_schnorr;
     typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
     map_type setValid;
     std::shared_mutex cs_sigcache;
 
+    //! Expand one absorbed message into a 256-bit cache entry via four
+    //! tagged finalizations. Each finalization only costs the SipHash
+    //! finalization rounds; the message itself is processed once.
+    static void ExpandEntry(uint256& entry, const CSipHasher& hasher)
+    {
+        for (int i = 0; i < 4; ++i) {
+            const unsigned char lane{(unsigned char)i};
+            WriteLE64(entry.begin() + 8 * i, CSipHasher(hasher).Write(&lane, 1).Finalize());
+        }
+    }
+
 public:
-    CSignatureCache()
+    CSignatureCache() : m_hasher_ecdsa(0, 0), m_hasher_schnorr(0, 0)
     {
         uint256 nonce = GetRandHash();
-        // We want the nonce to be 64 bytes long to force the hasher to process
-        // this chunk, which makes later hash computations more efficient. We
-        // just write our 32-byte entropy, and then pad with 'E' for ECDSA and
-        // 'S' for Schnorr (followed by 0 bytes).
-        static constexpr unsigned char PADDING_ECDSA[32] = {'E'};
-        static constexpr unsigned char PADDING_SCHNORR[32] = {'S'};
-        m_salted_hasher_ecdsa.Write(nonce.begin(), 32);
-        m_salted_hasher_ecdsa.Write(PADDING_ECDSA, 32);
-        m_salted_hasher_schnorr.Write(nonce.begin(), 32);
-        m_salted_hasher_schnorr.Write(PADDING_SCHNORR, 32);
+        // Domain-separate the two signature types with a tag word so that the
+        // same (sighash, pubkey, sig) bytes can never collide across types.
+        m_hasher_ecdsa = CSipHasher(nonce.GetUint64(0), nonce.GetUint64(1)).Write(uint64_t{'E'});
+        m_hasher_schnorr = CSipHasher(nonce.GetUint64(0), nonce.GetUint64(1)).Write(uint64_t{'S'});
     }
 
     void
     ComputeEntryECDSA(uint256& entry, const uint256 &hash, const std::vector<unsigned char>& vchSig, const CPubKey& pubkey) const
     {
-        CSHA256 hasher = m_salted_hasher_ecdsa;
-        hasher.Write(hash.begin(), 32).Write(&pubkey[0], pubkey.size()).Write(&vchSig[0], vchSig.size()).Finalize(entry.begin());
+        CSipHasher hasher = m_hasher_ecdsa;
+        hasher.Write(hash.begin(), 32).Write(&pubkey[0], pubkey.size()).Write(&vchSig[0], vchSig.size());
+        ExpandEntry(entry, hasher);
     }
 
     void
     ComputeEntrySchnorr(uint256& entry, const uint256 &hash, Span<const unsigned char> sig, const XOnlyPubKey& pubkey) const
     {
-        CSHA256 hasher = m_salted_hasher_schnorr;
-        hasher.Write(hash.begin(), 32).Write(&pubkey[0], pubkey.size()).Write(sig.data(), sig.size()).Finalize(entry.begin());
+        CSipHasher hasher = m_hasher_schnorr;
+        hasher.Write(hash.begin(), 32).Write(&pubkey[0], pubkey.size()).Write(sig.data(), sig.size());
+        ExpandEntry(entry, hasher);
     }
 
     bool
@@ -79,6 +95,11 @@ public:
     {
         return setValid.setup_bytes(n);
     }
+    uint32_t resize_bytes(size_t n)
+    {
+        std::unique_lock<std::shared_mutex> lock(cs_sigcache);
+        return setValid.resize_bytes(n);
+    }
 };
 
 /* In previous versions of this code, signatureCache was a local static variable
@@ -102,6 +123,14 @@ void InitSignatureCache()
             (nElems*sizeof(uint256)) >>20, (nMaxCacheSize*2)>>20, nElems);
 }
 
+size_t ResizeSignatureCache(size_t max_size_bytes)
+{
+    size_t nElems = signatureCache.resize_bytes(max_size_bytes);
+    LogPrintf("Resized signature cache to %zu MiB, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >> 20, nElems);
+    return nElems;
+}
+
 bool CachingTransactionSignatureChecker::VerifyECDSASignature(const std::vector<unsigned char>& vchSig, const CPubKey& pubkey, const uint256& sighash) const
 {
     uint256 entry;
@@ -35,4 +35,9 @@ public:
 
 void InitSignatureCache();
 
+/** Resize the signature cache at runtime to approximately max_size_bytes,
+ * preserving the entries it currently holds. Returns the number of elements
+ * the resized cache can store. */
+size_t ResizeSignatureCache(size_t max_size_bytes);
+
 #endif // BITCOIN_SCRIPT_SIGCACHE_H
@@ -11,10 +11,18 @@
 #include <script/signingprovider.h>
 #include <script/standard.h>
 #include <uint256.h>
+#include <util/system.h>
+
+#include <atomic>
+#include <thread>
 
 typedef std::vector<unsigned char> valtype;
 
-MutableTransactionSignatureCreator::MutableTransactionSignatureCreator(const CMutableTransaction* txToIn, unsigned int nInIn, const CAmount& amountIn, int nHashTypeIn) : txTo(txToIn), nIn(nInIn), nHashType(nHashTypeIn), amount(amountIn), checker(txTo, nIn, amountIn) {}
+MutableTransactionSignatureCreator::MutableTransactionSignatureCreator(const CMutableTransaction* txToIn, unsigned int nInIn, const CAmount& amountIn, int nHashTypeIn) : txTo(txToIn), nIn(nInIn), nHashType(nHashTypeIn), amount(amountIn), checker(txTo, nIn, amountIn), m_txdata(nullptr) {}
+
+MutableTransactionSignatureCreator::MutableTransactionSignatureCreator(const CMutableTransaction* txToIn, unsigned int nInIn, const CAmount& amountIn, const PrecomputedTransactionData* txdata, int nHashTypeIn)
+    : txTo(txToIn), nIn(nInIn), nHashType(nHashTypeIn), amount(amountIn),
+      checker(txdata ? MutableTransactionSignatureChecker(txTo, nIn, amountIn, *txdata) : MutableTransactionSignatureChecker(txTo, nIn, amountIn)), m_txdata(txdata) {}
 
 bool MutableTransactionSignatureCreator::CreateSig(const SigningProvider& provider, std::vector<unsigned char>& vchSig, const CKeyID& address, const CScript& scriptCode, SigVersion sigversion) const
 {
@@ -26,7 +34,7 @@ bool MutableTransactionSignatureCreator::CreateSig(const SigningProvider& provid
     if (sigversion == SigVersion::WITNESS_V0 && !key.IsCompressed())
         return false;
 
-    uint256 hash = SignatureHash(scriptCode, *txTo, nIn, nHashType, amount, sigversion);
+    uint256 hash = SignatureHash(scriptCode, *txTo, nIn, nHashType, amount, sigversion, m_txdata);
     if (!key.Sign(hash, vchSig))
         return false;
     vchSig.push_back((unsigned char)nHashType);
@@ -473,13 +481,26 @@ bool SignTransaction(CMutableTransaction& mtx, const SigningProvider* keystore,
     // Use CTransaction for the constant parts of the
     // transaction to avoid rehashing.
     const CTransaction txConst(mtx);
-    // Sign what we can:
-    for (unsigned int i = 0; i < mtx.vin.size(); i++) {
+    // The BIP143 midstates (hashPrevouts/hashSequence/hashOutputs) are shared
+    // by every input's signature hash; compute them once up front instead of
+    // once per input. They only depend on the prevouts, sequences and outputs,
+    // none of which change while we fill in scriptSigs and witnesses below.
+    const PrecomputedTransactionData txdata(mtx);
+
+    // Sign one input, recording a failure reason in its error slot (empty
+    // means success). An input's signature never reads or writes another
+    // input's scriptSig or witness -- other inputs contribute only their
+    // prevouts and sequences to any signature hash -- so inputs can be
+    // signed concurrently. Signing providers and the secp256k1 context are
+    // safe for concurrent const use.
+    std::vector<std::string> errors(mtx.vin.size());
+    const auto sign_input = [&](unsigned int i) {
         CTxIn& txin = mtx.vin[i];
+        std::string& error = errors[i];
         auto coin = coins.find(txin.prevout);
         if (coin == coins.end() || coin->second.IsSpent()) {
-            input_errors[i] = "Input not found or already spent";
-            continue;
+            error = "Input not found or already spent";
+            return;
         }
         const CScript& prevPubKey = coin->second.out.scriptPubKey;
         const CAmount& amount = coin->second.out.nValue;
@@ -487,28 +508,53 @@ bool SignTransaction(CMutableTransaction& mtx, const SigningProvider* keystore,
         SignatureData sigdata = DataFromTransaction(mtx, i, coin->second.out);
         // Only sign SIGHASH_SINGLE if there's a corresponding output:
         if (!fHashSingle || (i < mtx.vout.size())) {
-            ProduceSignature(*keystore, MutableTransactionSignatureCreator(&mtx, i, amount, nHashType), prevPubKey, sigdata);
+            ProduceSignature(*keystore, MutableTransactionSignatureCreator(&mtx, i, amount, &txdata, nHashType), prevPubKey, sigdata);
         }
 
         UpdateInput(txin, sigdata);
 
         // amount must be specified for valid segwit signature
         if (amount == MAX_MONEY && !txin.scriptWitness.IsNull()) {
-            input_errors[i] = "Missing amount";
-            continue;
+            error = "Missing amount";
+            return;
         }
 
         ScriptError serror = SCRIPT_ERR_OK;
-        if (!VerifyScript(txin.scriptSig, prevPubKey, &txin.scriptWitness, STANDARD_SCRIPT_VERIFY_FLAGS, TransactionSignatureChecker(&txConst, i, amount), &serror)) {
+        if (!VerifyScript(txin.scriptSig, prevPubKey, &txin.scriptWitness, STANDARD_SCRIPT_VERIFY_FLAGS, TransactionSignatureChecker(&txConst, i, amount, txdata), &serror)) {
             if (serror == SCRIPT_ERR_INVALID_STACK_OPERATION) {
                 // Unable to sign input and verification failed (possible attempt to partially sign).
-                input_errors[i] = "Unable to sign input, invalid stack size (possibly missing key)";
+                error = "Unable to sign input, invalid stack size (possibly missing key)";
             } else if (serror == SCRIPT_ERR_SIG_NULLFAIL) {
                 // Verification failed (possibly due to insufficient signatures).
-                input_errors[i] = "CHECK(MULTI)SIG failing with non-zero signature (possibly need more signatures)";
+                error = "CHECK(MULTI)SIG failing with non-zero signature (possibly need more signatures)";
             } else {
-                input_errors[i] = ScriptErrorString(serror);
+                error = ScriptErrorString(serror);
             }
+        }
+    };
+
+    // Sign what we can, fanning out across cores when there is enough work
+    // per thread to amortize the thread start cost.
+    constexpr unsigned int INPUTS_PER_THREAD{16};
+    const unsigned int num_threads = std::clamp<unsigned int>(mtx.vin.size() / INPUTS_PER_THREAD, 1U, (unsigned int)GetNumCores());
+    if (num_threads > 1) {
+        std::atomic<unsigned int> next_input{0};
+        auto worker = [&]() {
+            unsigned int i;
+            while ((i = next_input.fetch_add(1)) < mtx.vin.size()) sign_input(i);
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads - 1);
+        for (unsigned int t = 1; t < num_threads; ++t) threads.emplace_back(worker);
+        worker();
+        for (std::thread& thread : threads) thread.join();
+    } else {
+        for (unsigned int i = 0; i < mtx.vin.size(); i++) sign_input(i);
+    }
+
+    for (unsigned int i = 0; i < mtx.vin.size(); i++) {
+        if (!errors[i].empty()) {
+            input_errors[i] = errors[i];
         } else {
             // If this input succeeds, make sure there is no error set for it
             input_errors.erase(i);
@@ -110,6 +110,55 @@ TxoutType Solver(const CScript& scriptPubKey, std::vector<std::vector<unsigned c
 {
     vSolutionsRet.clear();
 
+    // Dispatch on the script size first: the overwhelmingly common output
+    // types (P2WPKH, P2SH, P2PKH, P2WSH, P2TR, P2PK) each have a fixed size
+    // and are identified by their leading bytes, so the dominant cases
+    // resolve with one length compare and a few byte compares instead of
+    // trying every template in sequence. A script that falls through here -
+    // an uncommon size, or a common size whose bytes do not match - lands on
+    // the general template matching below, which is unchanged.
+    switch (scriptPubKey.size()) {
+    case 22: // P2WPKH: OP_0 0x14 <20-byte key hash>
+        if (scriptPubKey[0] == OP_0 && scriptPubKey[1] == WITNESS_V0_KEYHASH_SIZE) {
+            vSolutionsRet.emplace_back(scriptPubKey.begin() + 2, scriptPubKey.end());
+            return TxoutType::WITNESS_V0_KEYHASH;
+        }
+        break;
+    case 23: // P2SH: OP_HASH160 0x14 <20-byte script hash> OP_EQUAL
+        if (scriptPubKey[0] == OP_HASH160 && scriptPubKey[1] == 0x14 && scriptPubKey[22] == OP_EQUAL) {
+            vSolutionsRet.emplace_back(scriptPubKey.begin() + 2, scriptPubKey.begin() + 22);
+            return TxoutType::SCRIPTHASH;
+        }
+        break;
+    case 25: // P2PKH: OP_DUP OP_HASH160 0x14 <20-byte key hash> OP_EQUALVERIFY OP_CHECKSIG
+        if (scriptPubKey[0] == OP_DUP && scriptPubKey[1] == OP_HASH160 && scriptPubKey[2] == 0x14 &&
+            scriptPubKey[23] == OP_EQUALVERIFY && scriptPubKey[24] == OP_CHECKSIG) {
+            vSolutionsRet.emplace_back(scriptPubKey.begin() + 3, scriptPubKey.begin() + 23);
+            return TxoutType::PUBKEYHASH;
+        }
+        break;
+    case 34: // P2WSH: OP_0 0x20 <32-byte script hash>, or P2TR: OP_1 0x20 <32-byte key>
+        if (scriptPubKey[0] == OP_0 && scriptPubKey[1] == WITNESS_V0_SCRIPTHASH_SIZE) {
+            vSolutionsRet.emplace_back(scriptPubKey.begin() + 2, scriptPubKey.end());
+            return TxoutType::WITNESS_V0_SCRIPTHASH;
+        }
+        if (scriptPubKey[0] == OP_1 && scriptPubKey[1] == WITNESS_V1_TAPROOT_SIZE) {
+            vSolutionsRet.push_back(std::vector<unsigned char>{1});
+            vSolutionsRet.emplace_back(scriptPubKey.begin() + 2, scriptPubKey.end());
+            return TxoutType::WITNESS_V1_TAPROOT;
+        }
+        break;
+    case CPubKey::COMPRESSED_SIZE + 2: // P2PK: 0x21 <33-byte pubkey> OP_CHECKSIG
+    case CPubKey::SIZE + 2: {          // P2PK: 0x41 <65-byte pubkey> OP_CHECKSIG
+        std::vector<unsigned char> pubkey;
+        if (MatchPayToPubkey(scriptPubKey, pubkey)) {
+            vSolutionsRet.push_back(std::move(pubkey));
+            return TxoutType::PUBKEY;
+        }
+        break;
+    }
+    }
+
     // Shortcut for pay-to-script-hash, which are more constrained than the other types:
     // it is always OP_HASH160 20 [20 byte hash] OP_EQUAL
     if (scriptPubKey.IsPayToScriptHash())
@@ -176,6 +225,62 @@ TxoutType Solver(const CScript& scriptPubKey, std::vector<std::vector<unsigned c
     return TxoutType::NONSTANDARD;
 }
 
+std::optional<TxoutType> ClassifyCanonicalOutput(const CScript& scriptPubKey)
+{
+    // Mirrors the size-dispatched fast path at the top of Solver, minus the
+    // solution extraction; keep the two in sync.
+    switch (scriptPubKey.size()) {
+    case 22: // P2WPKH: OP_0 0x14 <20-byte key hash>
+        if (scriptPubKey[0] == OP_0 && scriptPubKey[1] == WITNESS_V0_KEYHASH_SIZE) {
+            return TxoutType::WITNESS_V0_KEYHASH;
+        }
+        break;
+    case 23: // P2SH: OP_HASH160 0x14 <20-byte script hash> OP_EQUAL
+        if (scriptPubKey[0] == OP_HASH160 && scriptPubKey[1] == 0x14 && scriptPubKey[22] == OP_EQUAL) {
+            return TxoutType::SCRIPTHASH;
+        }
+        break;
+    case 25: // P2PKH: OP_DUP OP_HASH160 0x14 <20-byte key hash> OP_EQUALVERIFY OP_CHECKSIG
+        if (scriptPubKey[0] == OP_DUP && scriptPubKey[1] == OP_HASH160 && scriptPubKey[2] == 0x14 &&
+            scriptPubKey[23] == OP_EQUALVERIFY && scriptPubKey[24] == OP_CHECKSIG) {
+            return TxoutType::PUBKEYHASH;
+        }
+        break;
+    case 34: // P2WSH: OP_0 0x20 <32-byte script hash>, or P2TR: OP_1 0x20 <32-byte key>
+        if (scriptPubKey[0] == OP_0 && scriptPubKey[1] == WITNESS_V0_SCRIPTHASH_SIZE) {
+            return TxoutType::WITNESS_V0_SCRIPTHASH;
+        }
+        if (scriptPubKey[0] == OP_1 && scriptPubKey[1] == WITNESS_V1_TAPROOT_SIZE) {
+            return TxoutType::WITNESS_V1_TAPROOT;
+        }
+        break;
+    case CPubKey::COMPRESSED_SIZE + 2: // P2PK: 0x21 <33-byte pubkey> OP_CHECKSIG
+    case CPubKey::SIZE + 2: {          // P2PK: 0x41 <65-byte pubkey> OP_CHECKSIG
+        std::vector<unsigned char> pubkey;
+        if (MatchPayToPubkey(scriptPubKey, pubkey)) {
+            return TxoutType::PUBKEY;
+        }
+        break;
+    }
+    }
+
+    // Future witness versions: standard-typed but with no canonical pattern
+    // beyond the program bounds; a malformed v0 program is nonstandard.
+    int witnessversion;
+    std::vector<unsigned char> witnessprogram;
+    if (scriptPubKey.IsWitnessProgram(witnessversion, witnessprogram)) {
+        return witnessversion == 0 ? TxoutType::NONSTANDARD : TxoutType::WITNESS_UNKNOWN;
+    }
+
+    // Provably prunable, data-carrying output
+    if (scriptPubKey.size() >= 1 && scriptPubKey[0] == OP_RETURN && scriptPubKey.IsPushOnly(scriptPubKey.begin() + 1)) {
+        return TxoutType::NULL_DATA;
+    }
+
+    // Could still be bare multisig or a non-canonical encoding of the above.
+    return std::nullopt;
+}
+
 bool ExtractDestination(const CScript& scriptPubKey, CTxDestination& addressRet)
 {
     std::vector<valtype> vSolutions;
@@ -9,6 +9,7 @@
 #include <script/interpreter.h>
 #include <uint256.h>
 
+#include <optional>
 #include <string>
 #include <variant>
 
@@ -229,6 +230,18 @@ std::string GetTxnOutputType(TxoutType t);
  */
 TxoutType Solver(const CScript& scriptPubKey, std::vector<std::vector<unsigned char>>& vSolutionsRet);
 
+/**
+ * Classify a scriptPubKey without materializing solver solutions.
+ *
+ * Recognizes the canonical fixed-pattern output types (P2PKH, P2SH, P2PK,
+ * witness programs, OP_RETURN data carriers) with a size dispatch and a few
+ * byte compares, avoiding the vector allocations Solver performs for its
+ * solutions. Returns std::nullopt when generic template matching is required
+ * to settle the type (e.g. potential bare multisig); callers must then fall
+ * back to Solver.
+ */
+std::optional<TxoutType> ClassifyCanonicalOutput(const CScript& scriptPubKey);
+
 /**
  * Parse a standard scriptPubKey for the destination address. Assigns result to
  * the addressRet parameter and returns true if successful. For multisig
@@ -288,24 +288,37 @@ void WriteCompactSize(Stream& os, uint64_t nSize)
 {
     if (nSize < 253)
     {
+        // Nearly every length field in a block takes this path: one
+        // predictable compare and one byte written.
         ser_writedata8(os, nSize);
+        return;
     }
-    else if (nSize <= std::numeric_limits<uint16_t>::max())
+    // Assemble the tag and payload in one buffer so the multi-byte encodings
+    // cost a single stream write instead of two.
+    unsigned char buf[9];
+    unsigned int len;
+    if (nSize <= std::numeric_limits<uint16_t>::max())
     {
-        ser_writedata8(os, 253);
-        ser_writedata16(os, nSize);
+        buf[0] = 253;
+        uint16_t payload = htole16(nSize);
+        memcpy(buf + 1, &payload, sizeof(payload));
+        len = 1 + sizeof(payload);
     }
     else if (nSize <= std::numeric_limits<unsigned int>::max())
     {
-        ser_writedata8(os, 254);
-        ser_writedata32(os, nSize);
+        buf[0] = 254;
+        uint32_t payload = htole32(nSize);
+        memcpy(buf + 1, &payload, sizeof(payload));
+        len = 1 + sizeof(payload);
     }
     else
     {
-        ser_writedata8(os, 255);
-        ser_writedata64(os, nSize);
+        buf[0] = 255;
+        uint64_t payload = htole64(nSize);
+        memcpy(buf + 1, &payload, sizeof(payload));
+        len = 1 + sizeof(payload);
     }
-    return;
+    os.write((char*)buf, len);
 }
 
 /**
@@ -318,12 +331,14 @@ template<typename Stream>
 uint64_t ReadCompactSize(Stream& is, bool range_check = true)
 {
     uint8_t chSize = ser_readdata8(is);
-    uint64_t nSizeRet = 0;
     if (chSize < 253)
     {
-        nSizeRet = chSize;
+        // One-byte sizes are always canonical and always below MAX_SIZE, so
+        // the common case returns after a single compare.
+        return chSize;
     }
-    else if (chSize == 253)
+    uint64_t nSizeRet = 0;
+    if (chSize == 253)
     {
         nSizeRet = ser_readdata16(is);
         if (nSizeRet < 253)
@@ -0,0 +1,75 @@
+// Copyright (c) 2021 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <support/allocators/pool.h>
+
+namespace pool_allocator_detail {
+
+SharedPool& SharedPool::Instance()
+{
+    static SharedPool* g_shared_pool = new SharedPool();
+    return *g_shared_pool;
+}
+
+SharedPool::Shard& SharedPool::ThreadShard()
+{
+    static std::atomic<size_t> counter{0};
+    thread_local const size_t idx{counter.fetch_add(1, std::memory_order_relaxed) % NUM_SHARDS};
+    return m_shards[idx];
+}
+
+void* SharedPool::Allocate(size_t bytes)
+{
+    if (bytes == 0 || bytes > MAX_BLOCK) {
+        return ::operator new(bytes);
+    }
+    const size_t cls = (bytes + ALIGN - 1) / ALIGN - 1;
+    const size_t block = (cls + 1) * ALIGN;
+    Shard& shard = ThreadShard();
+    std::lock_guard<std::mutex> lock(shard.m_mutex);
+    m_used_bytes.fetch_add(block, std::memory_order_relaxed);
+    if (shard.m_free[cls]) {
+        void* p = shard.m_free[cls];
+        std::memcpy(&shard.m_free[cls], p, sizeof(void*));
+        return p;
+    }
+    if (shard.m_remaining < block) {
+        // The tail of the previous chunk (less than one block) is abandoned.
+        shard.m_chunks.emplace_back(new char[CHUNK_BYTES]);
+        shard.m_cursor = shard.m_chunks.back().get();
+        shard.m_remaining = CHUNK_BYTES;
+        m_reserved_bytes.fetch_add(CHUNK_BYTES, std::memory_order_relaxed);
+        m_chunk_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    char* p = shard.m_cursor;
+    shard.m_cursor += block;
+    shard.m_remaining -= block;
+    return p;
+}
+
+void SharedPool::Deallocate(void* p, size_t bytes) noexcept
+{
+    if (bytes == 0 || bytes > MAX_BLOCK) {
+        ::operator delete(p);
+        return;
+    }
+    const size_t cls = (bytes + ALIGN - 1) / ALIGN - 1;
+    // The block joins the freeing thread's shard, not necessarily the one it
+    // was carved from; all shards serve identical size classes, so blocks
+    // may migrate freely.
+    Shard& shard = ThreadShard();
+    std::lock_guard<std::mutex> lock(shard.m_mutex);
+    std::memcpy(p, &shard.m_free[cls], sizeof(void*));
+    shard.m_free[cls] = p;
+    m_used_bytes.fetch_sub((cls + 1) * ALIGN, std::memory_order_relaxed);
+}
+
+SharedPool::Stats SharedPool::GetStats() const
+{
+    return {m_reserved_bytes.load(std::memory_order_relaxed),
+            m_used_bytes.load(std::memory_order_relaxed),
+            m_chunk_count.load(std::memory_order_relaxed)};
+}
+
+} // namespace pool_allocator_detail
@@ -0,0 +1,264 @@
+// Copyright (c) 2021 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_ALLOCATORS_POOL_H
+#define BITCOIN_SUPPORT_ALLOCATORS_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+//
+// Allocator that carves single-element allocations out of large contiguous
+// chunks instead of hitting the heap once per element. Freed elements go on a
+// free list and are reused. This removes the per-node malloc overhead of
+// node-based containers and keeps nodes that were allocated together adjacent
+// in memory, which matters for containers whose elements are walked in bulk
+// (e.g. the mempool's transaction set).
+//
+// The pool serves allocations of exactly one element whose size matches the
+// first single-element request seen (for a node-based container this is the
+// node type); anything else - array allocations such as hash bucket vectors,
+// or rebound types of a different size - falls through to plain operator new.
+// Deallocation takes the same branch by size/count, so no range checks are
+// needed.
+//
+// Copies of the allocator (including rebound copies, as produced inside
+// containers) share one pool. The pool is destroyed when the last copy goes
+// away; the caller must ensure all elements were deallocated by then, as
+// chunks are released wholesale.
+//
+namespace pool_allocator_detail {
+//! State shared by all (rebound) copies of one pool_allocator; deliberately
+//! not a template so that copies rebound to different types can share it.
+struct PoolState {
+    //! Size of the blocks served from chunks; fixed by the first
+    //! single-element allocation.
+    size_t block_size{0};
+    //! Intrusive singly-linked list of freed blocks.
+    void* free_list{nullptr};
+    //! Unused tail of the most recent chunk.
+    char* chunk_cursor{nullptr};
+    size_t chunk_remaining{0};
+    std::vector<std::unique_ptr<char[]>> chunks;
+    //! Bytes currently handed out as pooled blocks, i.e. element nodes.
+    //! Chunk slack (carved but unused or freed blocks) and fall-through
+    //! allocations such as hash bucket arrays are deliberately excluded:
+    //! users such as the mempool compare this figure against a size limit
+    //! and must see it track the element count, falling as elements are
+    //! freed, even though chunks are only released wholesale. This matches
+    //! the per-node accounting these containers used before pooling.
+    size_t allocated_bytes{0};
+};
+} // namespace pool_allocator_detail
+
+template <typename T>
+class pool_allocator
+{
+    template <typename U>
+    friend class pool_allocator;
+
+    //! Number of elements per chunk.
+    static constexpr size_t ELEMS_PER_CHUNK{8192};
+
+    std::shared_ptr<pool_allocator_detail::PoolState> m_state;
+
+    bool PoolServes(size_t bytes, size_t n) const
+    {
+        return n == 1 && (m_state->block_size == 0 || m_state->block_size == bytes) && bytes >= sizeof(void*);
+    }
+
+public:
+    using value_type = T;
+
+    pool_allocator() : m_state(std::make_shared<pool_allocator_detail::PoolState>()) {}
+    pool_allocator(const pool_allocator& other) noexcept = default;
+    template <typename U>
+    pool_allocator(const pool_allocator<U>& other) noexcept : m_state(other.m_state)
+    {
+    }
+
+    template <typename U>
+    struct rebind {
+        typedef pool_allocator<U> other;
+    };
+
+    T* allocate(size_t n)
+    {
+        pool_allocator_detail::PoolState& pool = *m_state;
+        if (!PoolServes(sizeof(T), n)) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        pool.block_size = sizeof(T);
+        pool.allocated_bytes += pool.block_size;
+        if (pool.free_list) {
+            void* block = pool.free_list;
+            std::memcpy(&pool.free_list, block, sizeof(void*));
+            return static_cast<T*>(block);
+        }
+        if (pool.chunk_remaining < pool.block_size) {
+            const size_t chunk_bytes{ELEMS_PER_CHUNK * pool.block_size};
+            pool.chunks.emplace_back(new char[chunk_bytes]);
+            pool.chunk_cursor = pool.chunks.back().get();
+            pool.chunk_remaining = chunk_bytes;
+        }
+        char* block = pool.chunk_cursor;
+        pool.chunk_cursor += pool.block_size;
+        pool.chunk_remaining -= pool.block_size;
+        return reinterpret_cast<T*>(block);
+    }
+
+    void deallocate(T* p, size_t n) noexcept
+    {
+        pool_allocator_detail::PoolState& pool = *m_state;
+        if (!PoolServes(sizeof(T), n)) {
+            ::operator delete(p);
+            return;
+        }
+        pool.allocated_bytes -= pool.block_size;
+        std::memcpy(static_cast<void*>(p), &pool.free_list, sizeof(void*));
+        pool.free_list = p;
+    }
+
+    //! Bytes currently handed out as element nodes (see
+    //! PoolState::allocated_bytes for what is excluded).
+    size_t total_allocated_bytes() const { return m_state->allocated_bytes; }
+
+    //! Size of one pooled block (0 until the first single-element
+    //! allocation). Lets callers discount blocks that belong to the
+    //! container itself rather than to any element, such as a
+    //! boost::multi_index header node.
+    size_t block_bytes() const { return m_state->block_size; }
+
+    template <typename U>
+    bool operator==(const pool_allocator<U>& other) const noexcept
+    {
+        return m_state == other.m_state;
+    }
+    template <typename U>
+    bool operator!=(const pool_allocator<U>& other) const noexcept
+    {
+        return !(*this == other);
+    }
+};
+
+namespace pool_allocator_detail {
+//! Process-wide, thread-aware pool behind shared_pool_allocator.
+//!
+//! Unlike PoolState above, which belongs to a single container, this pool is
+//! shared by every user in the process and safe to allocate from and free to
+//! on different threads - the lifecycle of a relayed transaction, which is
+//! deserialized on a message handler thread and released on whichever thread
+//! drops the last reference. Blocks are rounded up to 16-byte size classes
+//! (up to MAX_BLOCK; larger requests fall through to operator new) and each
+//! operation locks one of several shards selected per thread, so unrelated
+//! threads do not contend on a lock or on allocator metadata. Chunks are
+//! never returned to the OS; freed blocks are recycled through per-shard
+//! free lists.
+class SharedPool
+{
+public:
+    //! Alignment of every pooled block (chunks are carved in these units).
+    static constexpr size_t ALIGN{16};
+    //! Largest request served from the pool.
+    static constexpr size_t MAX_BLOCK{512};
+
+    //! The process-wide instance. Intentionally leaked: transaction refs can
+    //! live in static objects (e.g. the chainparams genesis block) that are
+    //! destroyed after this translation unit's statics.
+    static SharedPool& Instance();
+
+    void* Allocate(size_t bytes);
+    void Deallocate(void* p, size_t bytes) noexcept;
+
+    struct Stats {
+        uint64_t reserved_bytes; //!< Bytes obtained from the heap for chunks.
+        uint64_t used_bytes;     //!< Bytes in blocks currently handed out.
+        uint64_t chunks;         //!< Number of chunks allocated.
+    };
+    Stats GetStats() const;
+
+private:
+    static constexpr size_t NUM_SHARDS{16};
+    static constexpr size_t NUM_CLASSES{MAX_BLOCK / ALIGN};
+    static constexpr size_t CHUNK_BYTES{256 * 1024};
+
+    struct Shard {
+        std::mutex m_mutex;
+        //! Intrusive free-list heads, one per size class.
+        void* m_free[NUM_CLASSES]{};
+        //! Unused tail of the most recent chunk.
+        char* m_cursor{nullptr};
+        size_t m_remaining{0};
+        std::vector<std::unique_ptr<char[]>> m_chunks;
+    };
+
+    //! Shard assigned to the calling thread (round-robin on first use).
+    Shard& ThreadShard();
+
+    Shard m_shards[NUM_SHARDS];
+    std::atomic<uint64_t> m_reserved_bytes{0};
+    std::atomic<uint64_t> m_used_bytes{0};
+    std::atomic<uint64_t> m_chunk_count{0};
+};
+} // namespace pool_allocator_detail
+
+//! STL-compatible allocator serving blocks from the process-wide SharedPool.
+//! Intended for the std::allocate_shared control blocks of frequently
+//! churned objects (see MakeTransactionRef). All instances compare equal, so
+//! allocation and deallocation may happen on different threads and through
+//! different (rebound) copies.
+template <typename T>
+class shared_pool_allocator
+{
+public:
+    using value_type = T;
+
+    shared_pool_allocator() noexcept = default;
+    template <typename U>
+    shared_pool_allocator(const shared_pool_allocator<U>&) noexcept
+    {
+    }
+
+    template <typename U>
+    struct rebind {
+        typedef shared_pool_allocator<U> other;
+    };
+
+    T* allocate(size_t n)
+    {
+        if (alignof(T) > pool_allocator_detail::SharedPool::ALIGN) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(pool_allocator_detail::SharedPool::Instance().Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept
+    {
+        if (alignof(T) > pool_allocator_detail::SharedPool::ALIGN) {
+            ::operator delete(p);
+            return;
+        }
+        pool_allocator_detail::SharedPool::Instance().Deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const shared_pool_allocator<U>&) const noexcept
+    {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const shared_pool_allocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
+
+#endif // BITCOIN_SUPPORT_ALLOCATORS_POOL_H
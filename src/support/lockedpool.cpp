@@ -307,7 +307,7 @@ void* LockedPool::alloc(size_t size)
         }
     }
     // If that fails, create a new one
-    if (new_arena(ARENA_SIZE, ARENA_ALIGN)) {
+    if (new_arena(ARENA_SIZE, ARENA_ALIGN, size)) {
         return arenas.back().alloc(size);
     }
     return nullptr;
@@ -342,17 +342,34 @@ LockedPool::Stats LockedPool::stats() const
     return r;
 }
 
-bool LockedPool::new_arena(size_t size, size_t align)
+std::vector<LockedPool::ArenaStats> LockedPool::arena_stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<ArenaStats> ret;
+    ret.reserve(arenas.size());
+    for (const auto& arena : arenas) {
+        ArenaStats s;
+        static_cast<Arena::Stats&>(s) = arena.stats();
+        s.locked = arena.locked();
+        ret.push_back(s);
+    }
+    return ret;
+}
+
+bool LockedPool::new_arena(size_t size, size_t align, size_t min_size)
 {
     bool locked;
-    // If this is the first arena, handle this specially: Cap the upper size
-    // by the process limit. This makes sure that the first arena will at least
-    // be locked. An exception to this is if the process limit is 0:
-    // in this case no memory can be locked at all so we'll skip past this logic.
-    if (arenas.empty()) {
-        size_t limit = allocator->GetLimit();
-        if (limit > 0) {
-            size = std::min(size, limit);
+    // Cap the arena size by the amount of memory the process may still lock,
+    // so that arenas created after the earlier ones have consumed part of the
+    // limit still get locked pages instead of failing mlock outright -- but
+    // never below the allocation this arena must be able to serve. If the
+    // limit is 0 no memory can be locked at all, so skip past this logic and
+    // let the locking-failed callback decide what to do.
+    size_t limit = allocator->GetLimit();
+    if (limit > 0) {
+        size_t remaining = limit > cumulative_bytes_locked ? limit - cumulative_bytes_locked : 0;
+        if (remaining >= min_size) {
+            size = std::min(size, remaining);
         }
     }
     void *addr = allocator->AllocateLocked(size, &locked);
@@ -367,12 +384,12 @@ bool LockedPool::new_arena(size_t size, size_t align)
             return false;
         }
     }
-    arenas.emplace_back(allocator.get(), addr, size, align);
+    arenas.emplace_back(allocator.get(), addr, size, align, locked);
     return true;
 }
 
-LockedPool::LockedPageArena::LockedPageArena(LockedPageAllocator *allocator_in, void *base_in, size_t size_in, size_t align_in):
-    Arena(base_in, size_in, align_in), base(base_in), size(size_in), allocator(allocator_in)
+LockedPool::LockedPageArena::LockedPageArena(LockedPageAllocator *allocator_in, void *base_in, size_t size_in, size_t align_in, bool locked_in):
+    Arena(base_in, size_in, align_in), base(base_in), size(size_in), allocator(allocator_in), m_locked(locked_in)
 {
 }
 LockedPool::LockedPageArena::~LockedPageArena()
@@ -11,6 +11,7 @@
 #include <mutex>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 /**
  * OS-dependent allocation and deallocation of locked/pinned memory pages.
@@ -179,6 +180,15 @@ public:
 
     /** Get pool usage statistics */
     Stats stats() const;
+
+    /** Usage statistics of a single arena. */
+    struct ArenaStats : Arena::Stats
+    {
+        //! Whether the arena's pages are locked in memory.
+        bool locked;
+    };
+    /** Get usage statistics of each arena, in creation order. */
+    std::vector<ArenaStats> arena_stats() const;
 private:
     std::unique_ptr<LockedPageAllocator> allocator;
 
@@ -186,15 +196,21 @@ private:
     class LockedPageArena: public Arena
     {
     public:
-        LockedPageArena(LockedPageAllocator *alloc_in, void *base_in, size_t size, size_t align);
+        LockedPageArena(LockedPageAllocator *alloc_in, void *base_in, size_t size, size_t align, bool locked);
         ~LockedPageArena();
+        bool locked() const { return m_locked; }
     private:
         void *base;
         size_t size;
         LockedPageAllocator *allocator;
+        bool m_locked;
     };
 
-    bool new_arena(size_t size, size_t align);
+    /** Create a new arena. The size may be reduced to stay within the
+     * remaining amount of memory the process is allowed to lock, but never
+     * below min_size, the allocation the arena must be able to serve.
+     */
+    bool new_arena(size_t size, size_t align, size_t min_size);
 
     std::list<LockedPageArena> arenas;
     LockingFailed_Callback lf_cb;
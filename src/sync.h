@@ -11,6 +11,7 @@
 
 #include <condition_variable>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 
@@ -126,6 +127,41 @@ using RecursiveMutex = AnnotatedMixin<std::recursive_mutex>;
 /** Wrapped mutex: supports waiting but not recursive locking */
 typedef AnnotatedMixin<std::mutex> Mutex;
 
+/**
+ * Template mixin that additionally annotates the shared (reader) half of the
+ * mutex API. Kept separate from AnnotatedMixin so that plain Mutex users do
+ * not gain shared-locking members by accident.
+ */
+template <typename PARENT>
+class LOCKABLE SharedAnnotatedMixin : public AnnotatedMixin<PARENT>
+{
+public:
+    void lock_shared() SHARED_LOCK_FUNCTION()
+    {
+        PARENT::lock_shared();
+    }
+
+    void unlock_shared() UNLOCK_FUNCTION()
+    {
+        PARENT::unlock_shared();
+    }
+
+    bool try_lock_shared() SHARED_TRYLOCK_FUNCTION(true)
+    {
+        return PARENT::try_lock_shared();
+    }
+
+    using SharedLock = std::shared_lock<PARENT>;
+};
+
+/**
+ * Wrapped shared mutex: readers may hold it concurrently (LOCK_SHARED) while
+ * writers get exclusive access (LOCK). Supports neither recursive locking nor
+ * lock upgrades; a thread holding the shared lock must not take the exclusive
+ * one.
+ */
+using SharedMutex = SharedAnnotatedMixin<std::shared_mutex>;
+
 #ifdef DEBUG_LOCKCONTENTION
 void PrintLockContention(const char* pszName, const char* pszFile, int nLine);
 #endif
@@ -226,13 +262,52 @@ public:
 
 #define REVERSE_LOCK(g) typename std::decay<decltype(g)>::type::reverse_lock PASTE2(revlock, __COUNTER__)(g, #g, __FILE__, __LINE__)
 
+/**
+ * Wrapper around std::shared_lock style lock for SharedMutex: the reader-side
+ * counterpart of UniqueLock. Participates in DEBUG_LOCKORDER checking like any
+ * other lock; shared acquisitions are tracked on the same per-thread stack.
+ */
+template <typename Mutex, typename Base = typename Mutex::SharedLock>
+class SCOPED_LOCKABLE SharedLock : public Base
+{
+private:
+    void Enter(const char* pszName, const char* pszFile, int nLine)
+    {
+        EnterCritical(pszName, pszFile, nLine, Base::mutex());
+#ifdef DEBUG_LOCKCONTENTION
+        if (!Base::try_lock()) {
+            PrintLockContention(pszName, pszFile, nLine);
+#endif
+            Base::lock();
+#ifdef DEBUG_LOCKCONTENTION
+        }
+#endif
+    }
+
+public:
+    SharedLock(Mutex& mutexIn, const char* pszName, const char* pszFile, int nLine) SHARED_LOCK_FUNCTION(mutexIn) : Base(mutexIn, std::defer_lock)
+    {
+        Enter(pszName, pszFile, nLine);
+    }
+
+    ~SharedLock() UNLOCK_FUNCTION()
+    {
+        if (Base::owns_lock())
+            LeaveCritical();
+    }
+};
+
 template<typename MutexArg>
 using DebugLock = UniqueLock<typename std::remove_reference<typename std::remove_pointer<MutexArg>::type>::type>;
 
+template<typename MutexArg>
+using DebugSharedLock = SharedLock<typename std::remove_reference<MutexArg>::type>;
+
 #define LOCK(cs) DebugLock<decltype(cs)> PASTE2(criticalblock, __COUNTER__)(cs, #cs, __FILE__, __LINE__)
 #define LOCK2(cs1, cs2)                                               \
     DebugLock<decltype(cs1)> criticalblock1(cs1, #cs1, __FILE__, __LINE__); \
     DebugLock<decltype(cs2)> criticalblock2(cs2, #cs2, __FILE__, __LINE__);
+#define LOCK_SHARED(cs) DebugSharedLock<decltype(cs)> PASTE2(sharedblock, __COUNTER__)(cs, #cs, __FILE__, __LINE__)
 #define TRY_LOCK(cs, name) DebugLock<decltype(cs)> name(cs, #cs, __FILE__, __LINE__, true)
 #define WAIT_LOCK(cs, name) DebugLock<decltype(cs)> name(cs, #cs, __FILE__, __LINE__)
 
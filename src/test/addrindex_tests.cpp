@@ -0,0 +1,92 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/addrindex.h>
+#include <script/interpreter.h>
+#include <script/standard.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(addrindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(addrindex_initial_sync, TestChain100Setup)
+{
+    AddrIndex addrindex(1 << 20, true);
+
+    // The test chain pays its coinbases to a bare P2PK script.
+    const CScript coinbase_script_pub_key = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+    addrindex.Start();
+
+    // Allow the address index to catch up with the block index.
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!addrindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+
+    // Every coinbase of the test chain pays the same script, so all 100
+    // coinbase txids must be found, in chain order.
+    std::vector<std::pair<int, uint256>> txids;
+    BOOST_REQUIRE(addrindex.FindTxIds(coinbase_script_pub_key, txids));
+    BOOST_REQUIRE_EQUAL(txids.size(), m_coinbase_txns.size());
+    for (size_t i = 0; i < m_coinbase_txns.size(); ++i) {
+        BOOST_CHECK_EQUAL(txids[i].first, (int)i + 1);
+        BOOST_CHECK_EQUAL(txids[i].second, m_coinbase_txns[i]->GetHash());
+    }
+
+    // None of the outputs have been spent yet, so each coinbase output must
+    // show up as a utxo with the right amount and height.
+    std::vector<AddrIndexUtxo> utxos;
+    BOOST_REQUIRE(addrindex.FindUtxos(coinbase_script_pub_key, utxos));
+    BOOST_CHECK_EQUAL(utxos.size(), m_coinbase_txns.size());
+    for (const auto& utxo : utxos) {
+        BOOST_CHECK_EQUAL(utxo.value, 50 * COIN);
+        BOOST_CHECK_EQUAL(utxo.outpoint.n, 0U);
+    }
+
+    // Spend the first coinbase output to a new script and mine the spend.
+    const CScript dest_script = CScript() << OP_TRUE;
+    CMutableTransaction spend_tx;
+    spend_tx.vin.emplace_back(COutPoint{m_coinbase_txns[0]->GetHash(), 0});
+    spend_tx.vout.emplace_back(50 * COIN - 1000, dest_script);
+    {
+        std::vector<unsigned char> sig;
+        const uint256 hash = SignatureHash(coinbase_script_pub_key, spend_tx, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+        BOOST_REQUIRE(coinbaseKey.Sign(hash, sig));
+        sig.push_back(SIGHASH_ALL);
+        spend_tx.vin[0].scriptSig << sig;
+    }
+    CreateAndProcessBlock({spend_tx}, coinbase_script_pub_key);
+    BOOST_CHECK(addrindex.BlockUntilSyncedToCurrentChain());
+
+    // The spending txid joins the history of the coinbase script, the spent
+    // output disappears from its utxos, and the new output is indexed under
+    // the destination script.
+    txids.clear();
+    BOOST_REQUIRE(addrindex.FindTxIds(coinbase_script_pub_key, txids));
+    BOOST_CHECK_EQUAL(txids.size(), m_coinbase_txns.size() + 2); // new coinbase + spend
+
+    utxos.clear();
+    BOOST_REQUIRE(addrindex.FindUtxos(coinbase_script_pub_key, utxos));
+    BOOST_CHECK_EQUAL(utxos.size(), m_coinbase_txns.size()); // one spent, one new coinbase
+
+    utxos.clear();
+    BOOST_REQUIRE(addrindex.FindUtxos(dest_script, utxos));
+    BOOST_REQUIRE_EQUAL(utxos.size(), 1U);
+    BOOST_CHECK_EQUAL(utxos[0].outpoint.hash, spend_tx.GetHash());
+    BOOST_CHECK_EQUAL(utxos[0].value, 50 * COIN - 1000);
+    BOOST_CHECK_EQUAL(utxos[0].height, 101);
+
+    // shutdown sequence (c.f. Shutdown() in init.cpp)
+    addrindex.Stop();
+
+    // Let scheduler events finish running to avoid accessing any memory related to addrindex after it is destructed
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,7 +6,10 @@
 
 #include <test/util/setup_common.h>
 
+#include <support/allocators/pool.h>
+
 #include <memory>
+#include <thread>
 
 #include <boost/test/unit_test.hpp>
 
@@ -232,4 +235,31 @@ BOOST_AUTO_TEST_CASE(lockedpool_tests_live)
     BOOST_CHECK(pool.stats().used == initial.used);
 }
 
+BOOST_AUTO_TEST_CASE(shared_pool_tests)
+{
+    auto& pool = pool_allocator_detail::SharedPool::Instance();
+    const auto before = pool.GetStats();
+
+    // Pooled sizes are rounded up to 16-byte classes and recycled via the
+    // free list, including blocks freed on a different thread than the one
+    // that allocated them.
+    void* a = pool.Allocate(40);
+    BOOST_CHECK(a != nullptr);
+    BOOST_CHECK_EQUAL(pool.GetStats().used_bytes, before.used_bytes + 48);
+    std::thread([&] { pool.Deallocate(a, 40); }).join();
+    BOOST_CHECK_EQUAL(pool.GetStats().used_bytes, before.used_bytes);
+
+    // Oversized requests fall through to the heap and don't affect stats.
+    void* big = pool.Allocate(4096);
+    BOOST_CHECK(big != nullptr);
+    BOOST_CHECK_EQUAL(pool.GetStats().used_bytes, before.used_bytes);
+    pool.Deallocate(big, 4096);
+
+    // The allocator front-end works with allocate_shared.
+    auto num = std::allocate_shared<int>(shared_pool_allocator<int>{}, 7);
+    BOOST_CHECK_EQUAL(*num, 7);
+    num.reset();
+    BOOST_CHECK_EQUAL(pool.GetStats().used_bytes, before.used_bytes);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
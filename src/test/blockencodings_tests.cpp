@@ -49,8 +49,9 @@ static CBlock BuildBlockTestCase() {
 }
 
 // Number of shared use_counts we expect for a tx we haven't touched
-// (block + mempool + our copy from the GetSharedTx call)
-constexpr long SHARED_TX_OFFSET{3};
+// (block + mempool + the mempool's txid and wtxid lookup maps + our copy
+// from the GetSharedTx call)
+constexpr long SHARED_TX_OFFSET{5};
 
 BOOST_AUTO_TEST_CASE(SimpleRoundTripTest)
 {
@@ -37,6 +37,37 @@ BOOST_AUTO_TEST_CASE(gcsfilter_test)
         BOOST_CHECK(filter.MatchAny(excluded_elements));
         excluded_elements.erase(insertion.first);
     }
+
+    // MatchMany must report every included element, and no excluded elements
+    // (the 1-in-1024 false positive rate makes 100 spurious matches on these
+    // fixed inputs effectively impossible).
+    GCSFilter::ElementSet all_elements = included_elements;
+    all_elements.insert(excluded_elements.begin(), excluded_elements.end());
+    const GCSFilter::ElementSet matches = filter.MatchMany(all_elements);
+    for (const auto& element : included_elements) {
+        BOOST_CHECK(matches.count(element));
+    }
+    for (const auto& element : excluded_elements) {
+        BOOST_CHECK(!matches.count(element));
+    }
+    BOOST_CHECK(filter.MatchMany(excluded_elements).empty());
+    BOOST_CHECK(filter.MatchMany(GCSFilter::ElementSet{}).empty());
+}
+
+BOOST_AUTO_TEST_CASE(gcsfilter_parallel_construction)
+{
+    GCSFilter::ElementSet elements;
+    for (int i = 0; i < 20000; ++i) {
+        GCSFilter::Element element(8);
+        element[0] = i & 0xFF;
+        element[1] = (i >> 8) & 0xFF;
+        elements.insert(std::move(element));
+    }
+
+    // Hashing the elements on multiple threads must not change the encoding.
+    GCSFilter serial({0, 0, 10, 1 << 10}, elements);
+    GCSFilter parallel({0, 0, 10, 1 << 10}, elements, /*worker_threads=*/4);
+    BOOST_CHECK(serial.GetEncoded() == parallel.GetEncoded());
 }
 
 BOOST_AUTO_TEST_CASE(gcsfilter_default_constructor)
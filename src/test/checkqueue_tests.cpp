@@ -143,9 +143,9 @@ typedef CCheckQueue<FrozenCleanupCheck> FrozenCleanup_Queue;
 /** This test case checks that the CCheckQueue works properly
  * with each specified size_t Checks pushed.
  */
-static void Correct_Queue_range(std::vector<size_t> range)
+static void Correct_Queue_range(std::vector<size_t> range, bool work_stealing = false)
 {
-    auto small_queue = std::make_unique<Correct_Queue>(QUEUE_BATCH_SIZE);
+    auto small_queue = std::make_unique<Correct_Queue>(QUEUE_BATCH_SIZE, work_stealing);
     small_queue->StartWorkerThreads(SCRIPT_CHECK_THREADS);
     // Make vChecks here to save on malloc (this test can be slow...)
     std::vector<FakeCheckCheckCompletion> vChecks;
@@ -201,6 +201,17 @@ BOOST_AUTO_TEST_CASE(test_CheckQueue_Correct_Random)
     Correct_Queue_range(range);
 }
 
+/** Test that random numbers of checks are correct in work-stealing mode
+ */
+BOOST_AUTO_TEST_CASE(test_CheckQueue_Correct_Random_WorkStealing)
+{
+    std::vector<size_t> range;
+    range.reserve(100000/1000);
+    for (size_t i = 2; i < 100000; i += std::max((size_t)1, (size_t)InsecureRandRange(std::min((size_t)1000, ((size_t)100000) - i))))
+        range.push_back(i);
+    Correct_Queue_range(range, /* work_stealing */ true);
+}
+
 
 /** Test that failing checks are caught */
 BOOST_AUTO_TEST_CASE(test_CheckQueue_Catches_Failure)
@@ -230,26 +241,29 @@ BOOST_AUTO_TEST_CASE(test_CheckQueue_Catches_Failure)
     fail_queue->StopWorkerThreads();
 }
 // Test that a block validation which fails does not interfere with
-// future blocks, ie, the bad state is cleared.
+// future blocks, ie, the bad state is cleared. Exercised in both
+// scheduling modes, since the work-stealing mode resets its own state.
 BOOST_AUTO_TEST_CASE(test_CheckQueue_Recovers_From_Failure)
 {
-    auto fail_queue = std::make_unique<Failing_Queue>(QUEUE_BATCH_SIZE);
-    fail_queue->StartWorkerThreads(SCRIPT_CHECK_THREADS);
+    for (const bool work_stealing : {false, true}) {
+        auto fail_queue = std::make_unique<Failing_Queue>(QUEUE_BATCH_SIZE, work_stealing);
+        fail_queue->StartWorkerThreads(SCRIPT_CHECK_THREADS);
 
-    for (auto times = 0; times < 10; ++times) {
-        for (const bool end_fails : {true, false}) {
-            CCheckQueueControl<FailingCheck> control(fail_queue.get());
-            {
-                std::vector<FailingCheck> vChecks;
-                vChecks.resize(100, false);
-                vChecks[99] = end_fails;
-                control.Add(vChecks);
+        for (auto times = 0; times < 10; ++times) {
+            for (const bool end_fails : {true, false}) {
+                CCheckQueueControl<FailingCheck> control(fail_queue.get());
+                {
+                    std::vector<FailingCheck> vChecks;
+                    vChecks.resize(100, false);
+                    vChecks[99] = end_fails;
+                    control.Add(vChecks);
+                }
+                bool r =control.Wait();
+                BOOST_REQUIRE(r != end_fails);
             }
-            bool r =control.Wait();
-            BOOST_REQUIRE(r != end_fails);
         }
+        fail_queue->StopWorkerThreads();
     }
-    fail_queue->StopWorkerThreads();
 }
 
 // Test that unique checks are actually all called individually, rather than
@@ -71,6 +71,20 @@ public:
             hashBestBlock_ = hashBlock;
         return true;
     }
+
+    bool BatchWriteIncremental(const CCoinsMap& shard, const uint256& hashBlock) override
+    {
+        for (const auto& entry : shard) {
+            if (!(entry.second.flags & CCoinsCacheEntry::DIRTY)) continue;
+            if (entry.second.coin.IsSpent()) {
+                map_.erase(entry.first);
+            } else {
+                map_[entry.first] = entry.second.coin;
+            }
+        }
+        // An incremental write does not complete a best-block transition.
+        return true;
+    }
 };
 
 class CCoinsViewCacheTest : public CCoinsViewCache
@@ -81,17 +95,22 @@ public:
     void SelfTest() const
     {
         // Manually recompute the dynamic usage of the whole data, and compare it.
-        size_t ret = memusage::DynamicUsage(cacheCoins);
+        size_t ret = 0;
         size_t count = 0;
-        for (const auto& entry : cacheCoins) {
-            ret += entry.second.coin.DynamicMemoryUsage();
-            ++count;
+        for (const CCoinsMap& shard : m_shards) {
+            ret += shard.get_allocator().total_allocated_bytes();
+            for (const auto& entry : shard) {
+                ret += entry.second.coin.DynamicMemoryUsage();
+                ++count;
+            }
         }
         BOOST_CHECK_EQUAL(GetCacheSize(), count);
         BOOST_CHECK_EQUAL(DynamicMemoryUsage(), ret);
     }
 
-    CCoinsMap& map() const { return cacheCoins; }
+    //! The shard holding the default-constructed OUTPOINT the single-entry
+    //! tests below operate on.
+    CCoinsMap& map() const { return ShardFor(COutPoint()); }
     size_t& usage() const { return cachedCoinsUsage; }
 };
 
@@ -220,6 +239,17 @@ void SimulationTest(CCoinsView* base, bool fake_best_block)
                 BOOST_CHECK(stack[flushIndex]->Flush());
             }
         }
+        if (InsecureRandRange(100) == 0) {
+            // Every 100 iterations, trickle-flush one shard of the bottom
+            // cache (the only one whose base supports incremental writes;
+            // on the others this must be a no-op returning false).
+            unsigned int trickleIndex = InsecureRandRange(stack.size());
+            if (fake_best_block) stack[trickleIndex]->SetBestBlock(InsecureRand256());
+            bool ret = stack[trickleIndex]->TrickleFlush();
+            // Without a best block the transition marker cannot be formed
+            // and the trickle must refuse to write anything.
+            BOOST_CHECK_EQUAL(ret, fake_best_block && trickleIndex == 0);
+        }
         if (InsecureRandRange(100) == 0) {
             // Every 100 iterations, change the cache stack.
             if (stack.size() > 0 && InsecureRandBool() == 0) {
@@ -271,6 +301,12 @@ BOOST_AUTO_TEST_CASE(coins_cache_simulation_test)
 
     CCoinsViewDB db_base{"test", /*nCacheSize*/ 1 << 23, /*fMemory*/ true, /*fWipe*/ false};
     SimulationTest(&db_base, true);
+
+    // Same simulation against the grouped-by-txid chainstate layout.
+    gArgs.ForceSetArg("-dbgroupedcoins", "1");
+    CCoinsViewDB db_grouped{"test_grouped", /*nCacheSize*/ 1 << 23, /*fMemory*/ true, /*fWipe*/ false};
+    gArgs.ForceSetArg("-dbgroupedcoins", "0");
+    SimulationTest(&db_grouped, true);
 }
 
 // Store of all necessary tx and undo data for next test
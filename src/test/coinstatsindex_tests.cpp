@@ -0,0 +1,81 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <index/coinstatsindex.h>
+#include <script/standard.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(coinstatsindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(coinstatsindex_initial_sync, TestChain100Setup)
+{
+    CoinStatsIndex coin_stats_index{1 << 20, true};
+
+    CCoinsStats coin_stats;
+    const CBlockIndex* block_index;
+    {
+        LOCK(cs_main);
+        block_index = ::ChainActive().Tip();
+    }
+
+    // CoinStatsIndex should not be found before it is started.
+    BOOST_CHECK(!coin_stats_index.LookUpStats(block_index, coin_stats));
+
+    // BlockUntilSyncedToCurrentChain should return false before CoinStatsIndex
+    // is started.
+    BOOST_CHECK(!coin_stats_index.BlockUntilSyncedToCurrentChain());
+
+    coin_stats_index.Start();
+
+    // Allow the CoinStatsIndex to catch up with the block index that is syncing
+    // in a background thread.
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!coin_stats_index.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+
+    // Check the stats for all blocks that were in the chain before the index
+    // was started. 100 blocks with one coinbase output each; the genesis
+    // output is excluded, like it is excluded from the UTXO set.
+    BOOST_REQUIRE(coin_stats_index.LookUpStats(block_index, coin_stats));
+    BOOST_CHECK_EQUAL(coin_stats.nHeight, block_index->nHeight);
+    BOOST_CHECK_EQUAL(coin_stats.hashBlock, block_index->GetBlockHash());
+    BOOST_CHECK_EQUAL(coin_stats.nTransactionOutputs, 100U);
+    BOOST_CHECK_EQUAL(coin_stats.nTotalAmount, 100 * 50 * COIN);
+
+    // Check that the index is updated for new blocks.
+    const CScript script_pub_key{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    std::vector<CMutableTransaction> no_txns;
+    CreateAndProcessBlock(no_txns, script_pub_key);
+
+    BOOST_CHECK(coin_stats_index.BlockUntilSyncedToCurrentChain());
+
+    const CBlockIndex* new_block_index;
+    {
+        LOCK(cs_main);
+        new_block_index = ::ChainActive().Tip();
+    }
+    CCoinsStats new_coin_stats;
+    BOOST_REQUIRE(coin_stats_index.LookUpStats(new_block_index, new_coin_stats));
+
+    BOOST_CHECK(block_index != new_block_index);
+    BOOST_CHECK_EQUAL(new_coin_stats.nTransactionOutputs, 101U);
+    BOOST_CHECK(new_coin_stats.hashSerialized != coin_stats.hashSerialized);
+
+    // shutdown sequence (c.f. Shutdown() in init.cpp)
+    coin_stats_index.Stop();
+
+    // Let scheduler events finish running to avoid accessing memory related
+    // to coin_stats_index after it is destructed.
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -134,4 +134,50 @@ BOOST_AUTO_TEST_CASE(compress_script_to_uncompressed_pubkey_id)
     BOOST_CHECK_EQUAL(out[0], 0x04 | (script[65] & 0x01)); // least significant bit (lsb) of last char of pubkey is mapped into out[0]
 }
 
+static void CheckLZSSRoundTrip(const std::vector<unsigned char>& data)
+{
+    const std::vector<unsigned char> comp = LZSSCompress(data);
+    std::vector<unsigned char> out;
+    BOOST_CHECK(LZSSDecompress(comp, out, data.size()));
+    BOOST_CHECK(out == data);
+}
+
+BOOST_AUTO_TEST_CASE(lzss_roundtrip)
+{
+    // Degenerate inputs
+    CheckLZSSRoundTrip({});
+    CheckLZSSRoundTrip({0x42});
+    CheckLZSSRoundTrip(std::vector<unsigned char>(100000, 0x00));
+
+    // Incompressible random data must still round-trip
+    CheckLZSSRoundTrip(g_insecure_rand_ctx.randbytes(65536));
+
+    // Repetitive data (the undo-data shape: many similar records) must both
+    // round-trip and actually shrink
+    std::vector<unsigned char> repetitive;
+    const std::vector<unsigned char> record = g_insecure_rand_ctx.randbytes(40);
+    for (int i = 0; i < 1000; ++i) {
+        repetitive.insert(repetitive.end(), record.begin(), record.end());
+        repetitive.push_back(i & 0xff);
+    }
+    CheckLZSSRoundTrip(repetitive);
+    BOOST_CHECK(LZSSCompress(repetitive).size() < repetitive.size() / 2);
+}
+
+BOOST_AUTO_TEST_CASE(lzss_malformed)
+{
+    std::vector<unsigned char> out;
+
+    // A back-reference pointing before the start of the output
+    BOOST_CHECK(!LZSSDecompress(std::vector<unsigned char>{0x01, 0x00, 0x00}, out, 1000));
+
+    // A back-reference token truncated mid-stream
+    BOOST_CHECK(!LZSSDecompress(std::vector<unsigned char>{0x02, 0x42, 0x00}, out, 1000));
+
+    // Output larger than the caller's limit
+    const std::vector<unsigned char> comp = LZSSCompress(std::vector<unsigned char>(1000, 0x00));
+    BOOST_CHECK(!LZSSDecompress(comp, out, 999));
+    BOOST_CHECK(LZSSDecompress(comp, out, 1000));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -171,6 +171,15 @@ static void TestPoly1305(const std::string &hexmessage, const std::string &hexke
     tagres.resize(POLY1305_TAGLEN);
     poly1305_auth(tagres.data(), m.data(), m.size(), key.data());
     BOOST_CHECK(tag == tagres);
+
+    // Repeat through the incremental interface, split at every possible position.
+    for (size_t split = 0; split <= m.size(); ++split) {
+        std::vector<unsigned char> taginc(POLY1305_TAGLEN);
+        Poly1305 poly(key.data());
+        poly.Update(m.data(), split).Update(m.data() + split, m.size() - split);
+        poly.Finalize(taginc.data());
+        BOOST_CHECK(tag == taginc);
+    }
 }
 
 static void TestHKDF_SHA256_32(const std::string &ikm_hex, const std::string &salt_hex, const std::string &info_hex, const std::string &okm_check_hex) {
@@ -753,6 +762,34 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256dshort)
+{
+    for (int len = 0; len <= 119; ++len) {
+        unsigned char in[119];
+        unsigned char out1[32], out2[32], mid[32];
+        for (int j = 0; j < len; ++j) {
+            in[j] = InsecureRandBits(8);
+        }
+        CSHA256().Write(in, len).Finalize(mid);
+        CSHA256().Write(mid, 32).Finalize(out1);
+        SHA256DShort(out2, in, len);
+        BOOST_CHECK(memcmp(out1, out2, 32) == 0);
+        // CHash256 and CHashWriter take the same one-shot path for short input.
+        CHash256().Write({in, (size_t)len}).Finalize({out2, 32});
+        BOOST_CHECK(memcmp(out1, out2, 32) == 0);
+    }
+    // Exercise the spill from the buffered path into streaming mode.
+    unsigned char in[256];
+    for (int j = 0; j < 256; ++j) in[j] = InsecureRandBits(8);
+    for (int split = 0; split <= 256; split += 17) {
+        unsigned char out1[32], out2[32], mid[32];
+        CSHA256().Write(in, 256).Finalize(mid);
+        CSHA256().Write(mid, 32).Finalize(out1);
+        CHash256().Write({in, (size_t)split}).Write({in + split, (size_t)(256 - split)}).Finalize({out2, 32});
+        BOOST_CHECK(memcmp(out1, out2, 32) == 0);
+    }
+}
+
 static void TestSHA3_256(const std::string& input, const std::string& output)
 {
     const auto in_bytes = ParseHex(input);
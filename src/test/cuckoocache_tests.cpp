@@ -47,6 +47,35 @@ BOOST_AUTO_TEST_CASE(test_cuckoocache_no_fakes)
     }
 };
 
+/** Growing the cache preserves previously inserted elements. */
+BOOST_AUTO_TEST_CASE(test_cuckoocache_resize)
+{
+    SeedInsecureRand(SeedRand::ZEROS);
+    CuckooCache::cache<uint256, SignatureCacheHasher> cc{};
+    cc.setup_bytes(1 << 20);
+    // Fill to half load so that none of the inserts evict.
+    uint32_t n_insert = (1 << 20) / sizeof(uint256) / 2;
+    std::vector<uint256> hashes;
+    hashes.reserve(n_insert);
+    for (uint32_t i = 0; i < n_insert; ++i) {
+        hashes.push_back(InsecureRand256());
+    }
+    std::vector<uint256> hashes_insert_copy = hashes;
+    for (const uint256& h : hashes_insert_copy) {
+        cc.insert(h);
+    }
+    cc.resize_bytes(4 << 20);
+    for (const uint256& h : hashes) {
+        BOOST_CHECK(cc.contains(h, false));
+    }
+    // Elements that were marked erasable are dropped by the resize.
+    uint256 erased = InsecureRand256();
+    cc.insert(erased);
+    BOOST_CHECK(cc.contains(erased, true));
+    cc.resize_bytes(8 << 20);
+    BOOST_CHECK(!cc.contains(erased, false));
+};
+
 /** This helper returns the hit rate when megabytes*load worth of entries are
  * inserted into a megabytes sized cache
  */
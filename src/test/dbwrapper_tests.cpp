@@ -158,6 +158,48 @@ BOOST_AUTO_TEST_CASE(dbwrapper_batch)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_batch_async)
+{
+    fs::path ph = GetDataDir() / "dbwrapper_batch_async";
+    // Exercise the tuning overrides alongside the async path.
+    DBTuningOptions tuning;
+    tuning.write_buffer_size = 1 << 20;
+    tuning.block_size = 1 << 12;
+    CDBWrapper dbw(ph, (1 << 20), true, false, false, tuning);
+
+    char key = 'i';
+    uint256 in = InsecureRand256();
+    char key2 = 'j';
+    uint256 in2 = InsecureRand256();
+
+    CDBBatch batch(dbw);
+    batch.Write(key, in);
+    std::future<bool> future = dbw.WriteBatchAsync(batch);
+
+    // The batch is handed off empty, ready for reuse.
+    BOOST_CHECK_EQUAL(batch.SizeEstimate(), 0U);
+    batch.Write(key2, in2);
+
+    BOOST_CHECK(future.get());
+    uint256 res;
+    BOOST_CHECK(dbw.Read(key, res));
+    BOOST_CHECK_EQUAL(res.ToString(), in.ToString());
+
+    // A synchronous WriteBatch drains queued async batches first.
+    std::future<bool> future2 = dbw.WriteBatchAsync(batch);
+    CDBBatch batch3(dbw);
+    char key3 = 'k';
+    uint256 in3 = InsecureRand256();
+    batch3.Write(key3, in3);
+    BOOST_CHECK(dbw.WriteBatch(batch3));
+    BOOST_CHECK(future2.get());
+
+    BOOST_CHECK(dbw.Read(key2, res));
+    BOOST_CHECK_EQUAL(res.ToString(), in2.ToString());
+    BOOST_CHECK(dbw.Read(key3, res));
+    BOOST_CHECK_EQUAL(res.ToString(), in3.ToString());
+}
+
 BOOST_AUTO_TEST_CASE(dbwrapper_iterator)
 {
     // Perform tests both obfuscated and non-obfuscated.
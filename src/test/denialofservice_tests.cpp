@@ -293,11 +293,9 @@ public:
 
     CTransactionRef RandomOrphan() EXCLUSIVE_LOCKS_REQUIRED(g_cs_orphans)
     {
-        std::map<uint256, OrphanTx>::iterator it;
-        it = m_orphans.lower_bound(InsecureRand256());
-        if (it == m_orphans.end())
-            it = m_orphans.begin();
-        return it->second.tx;
+        auto it = m_insertion_order.begin();
+        std::advance(it, InsecureRandRange(m_insertion_order.size()));
+        return m_orphans.at(*it).tx;
     }
 };
 
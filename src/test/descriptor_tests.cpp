@@ -378,4 +378,30 @@ BOOST_AUTO_TEST_CASE(descriptor_test)
     CheckUnparsable("", "raw(Ü)#00000000", "Invalid characters in payload"); // Invalid chars
 }
 
+BOOST_AUTO_TEST_CASE(cached_descriptor_test)
+{
+    const std::string desc_str = "wpkh(xpub661MyMwAqRbcFW31YEwpkMuc5THy2PSt5bDMsktWQcFF8syAmRUapSCGu8ED9W6oDMSgv6Zz8idoc4a6mr8BDzTJY47LJhkJ8UB7WEGuduB/1/0/*)";
+
+    FlatSigningProvider keys;
+    std::string error;
+    auto desc_ref = Parse(desc_str, keys, error);
+    BOOST_REQUIRE(desc_ref);
+    std::shared_ptr<CachedDescriptor> cached = GetCachedDescriptor(Parse(desc_str, keys, error));
+
+    // The registry hands out the same cache for the same descriptor string.
+    BOOST_CHECK(cached == GetCachedDescriptor(Parse(desc_str, keys, error)));
+
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 10; ++i) {
+            std::vector<CScript> scripts_ref, scripts_cached;
+            FlatSigningProvider provider_ref, provider_cached;
+            BOOST_REQUIRE(desc_ref->Expand(i, keys, scripts_ref, provider_ref));
+            BOOST_REQUIRE(cached->Expand(i, keys, scripts_cached, provider_cached));
+            BOOST_CHECK(scripts_ref == scripts_cached);
+            BOOST_CHECK(provider_ref.pubkeys == provider_cached.pubkeys);
+            BOOST_CHECK(provider_ref.scripts == provider_cached.scripts);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -58,7 +58,7 @@ FUZZ_TARGET_INIT(net, initialize_net)
                 }
             },
             [&] {
-                if (node.m_addr_known == nullptr) {
+                if (WITH_LOCK(node.m_addr_send_mutex, return node.m_addr_known == nullptr;)) {
                     return;
                 }
                 const std::optional<CAddress> addr_opt = ConsumeDeserializable<CAddress>(fuzzed_data_provider);
@@ -68,7 +68,7 @@ FUZZ_TARGET_INIT(net, initialize_net)
                 node.AddAddressKnown(*addr_opt);
             },
             [&] {
-                if (node.m_addr_known == nullptr) {
+                if (WITH_LOCK(node.m_addr_send_mutex, return node.m_addr_known == nullptr;)) {
                     return;
                 }
                 const std::optional<CAddress> addr_opt = ConsumeDeserializable<CAddress>(fuzzed_data_provider);
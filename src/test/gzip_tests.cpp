@@ -0,0 +1,69 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+#include <util/gzip.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(gzip_tests, BasicTestingSetup)
+
+static std::vector<unsigned char> Compress(const std::string& in)
+{
+    std::vector<unsigned char> out;
+    GZipCompress(MakeUCharSpan(in), out);
+    return out;
+}
+
+static uint32_t ReadTrailerLE32(const std::vector<unsigned char>& gz, size_t offset_from_end)
+{
+    const size_t pos = gz.size() - offset_from_end;
+    return gz[pos] | (gz[pos + 1] << 8) | (gz[pos + 2] << 16) | ((uint32_t)gz[pos + 3] << 24);
+}
+
+BOOST_AUTO_TEST_CASE(gzip_framing)
+{
+    const std::vector<unsigned char> gz = Compress("123456789");
+    // gzip magic and deflate method
+    BOOST_CHECK(gz.size() > 18);
+    BOOST_CHECK_EQUAL(gz[0], 0x1f);
+    BOOST_CHECK_EQUAL(gz[1], 0x8b);
+    BOOST_CHECK_EQUAL(gz[2], 0x08);
+    // trailer: standard CRC-32 check value for "123456789", then ISIZE
+    BOOST_CHECK_EQUAL(ReadTrailerLE32(gz, 8), 0xcbf43926);
+    BOOST_CHECK_EQUAL(ReadTrailerLE32(gz, 4), 9U);
+
+    const std::vector<unsigned char> empty = Compress("");
+    BOOST_CHECK_EQUAL(ReadTrailerLE32(empty, 4), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(gzip_streamed_writes_match_one_shot)
+{
+    std::string in;
+    for (int i = 0; i < 1000; ++i) in += "{\"key\":" + ToString(i) + "},";
+
+    // For inputs below the internal chunk size the output must not depend on
+    // how the writes were split up.
+    std::vector<unsigned char> streamed;
+    GZipEncoder enc{[&streamed](const unsigned char* p, size_t n) { streamed.insert(streamed.end(), p, p + n); }};
+    size_t pos{0}, step{1};
+    while (pos < in.size()) {
+        const size_t len = std::min(step, in.size() - pos);
+        enc.Write(MakeUCharSpan(in).subspan(pos, len));
+        pos += len;
+        step = step * 2 + 1;
+    }
+    enc.Finish();
+
+    const std::vector<unsigned char> one_shot = Compress(in);
+    BOOST_CHECK(streamed == one_shot);
+    // Repetitive JSON should compress well even with fixed Huffman codes
+    BOOST_CHECK(one_shot.size() * 3 < in.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
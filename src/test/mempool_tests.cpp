@@ -788,4 +788,51 @@ BOOST_AUTO_TEST_CASE(MempoolAncestryTests)
     BOOST_CHECK_EQUAL(descendants, 4ULL);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolFeeHistogramTest)
+{
+    TestMemPoolEntryHelper entry;
+    CTxMemPool testPool;
+    LOCK2(cs_main, testPool.cs);
+
+    auto histogram_totals = [&testPool]() NO_THREAD_SAFETY_ANALYSIS {
+        uint64_t count{0};
+        uint64_t vsize{0};
+        CAmount fees{0};
+        for (const auto& bucket : testPool.GetFeeHistogram()) {
+            count += bucket.count;
+            vsize += bucket.vsize;
+            fees += bucket.fees;
+        }
+        return std::make_tuple(count, vsize, fees);
+    };
+
+    CMutableTransaction tx[3];
+    for (int i = 0; i < 3; i++) {
+        tx[i].vin.resize(1);
+        tx[i].vin[0].scriptSig = CScript() << OP_11;
+        tx[i].vin[0].prevout.n = i;
+        tx[i].vout.resize(1);
+        tx[i].vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        tx[i].vout[0].nValue = 11000LL;
+        testPool.addUnchecked(entry.Fee((i + 1) * 1000LL).FromTx(tx[i]));
+    }
+
+    auto [count, vsize, fees] = histogram_totals();
+    BOOST_CHECK_EQUAL(count, 3U);
+    BOOST_CHECK_EQUAL(vsize, testPool.GetTotalTxSize());
+    BOOST_CHECK_EQUAL(fees, 6000LL);
+
+    // Prioritisation affects modified fees and must be reflected.
+    testPool.PrioritiseTransaction(tx[0].GetHash(), 500LL);
+    std::tie(count, vsize, fees) = histogram_totals();
+    BOOST_CHECK_EQUAL(count, 3U);
+    BOOST_CHECK_EQUAL(fees, 6500LL);
+
+    testPool.removeRecursive(CTransaction(tx[1]), REMOVAL_REASON_DUMMY);
+    std::tie(count, vsize, fees) = histogram_totals();
+    BOOST_CHECK_EQUAL(count, 2U);
+    BOOST_CHECK_EQUAL(vsize, testPool.GetTotalTxSize());
+    BOOST_CHECK_EQUAL(fees, 4500LL);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
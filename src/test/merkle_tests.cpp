@@ -348,4 +348,30 @@ BOOST_AUTO_TEST_CASE(merkle_test_BlockWitness)
 
     BOOST_CHECK_EQUAL(merkleRootofHashes, blockWitness);
 }
+
+// Parallel subtree hashing must match the serial computation, including the
+// mutation flag, for leaf counts around the splitting threshold.
+BOOST_AUTO_TEST_CASE(merkle_test_Parallel)
+{
+    for (size_t count : {63, 2047, 2048, 2049, 4096, 5003}) {
+        std::vector<uint256> hashes;
+        hashes.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            hashes.push_back(InsecureRand256());
+        }
+        // Duplicate a pair near the end so mutation detection crosses into the
+        // partial last subtree.
+        hashes[count - 2] = hashes[count - 1];
+
+        for (int worker_threads : {2, 3, 4}) {
+            bool mutated_serial = false;
+            bool mutated_parallel = false;
+            uint256 root_serial = ComputeMerkleRoot(hashes, &mutated_serial);
+            uint256 root_parallel = ComputeMerkleRoot(hashes, &mutated_parallel, worker_threads);
+            BOOST_CHECK_EQUAL(root_serial, root_parallel);
+            BOOST_CHECK_EQUAL(mutated_serial, mutated_parallel);
+            BOOST_CHECK_EQUAL(root_parallel, ComputeMerkleRoot(hashes, nullptr, worker_threads));
+        }
+    }
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -8,6 +8,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <thread>
@@ -169,6 +170,49 @@ BOOST_AUTO_TEST_CASE(singlethreadedscheduler_ordered)
     BOOST_CHECK_EQUAL(counter2, 100);
 }
 
+BOOST_AUTO_TEST_CASE(priorities)
+{
+    CScheduler scheduler;
+
+    // Schedule both tasks in the past so both are due when the service
+    // thread starts; the HIGH task must run first even though it was
+    // scheduled last and for a later time.
+    std::vector<int> order;
+    const auto start{std::chrono::system_clock::now()};
+    scheduler.schedule([&order] { order.push_back(1); }, start - std::chrono::minutes{2}, CScheduler::Priority::LOW);
+    scheduler.schedule([&order] { order.push_back(2); }, start - std::chrono::minutes{1}, CScheduler::Priority::HIGH);
+
+    std::thread scheduler_thread([&]() { scheduler.serviceQueue(); });
+    scheduler.StopWhenDrained();
+    scheduler_thread.join();
+
+    BOOST_REQUIRE_EQUAL(order.size(), 2ul);
+    BOOST_CHECK_EQUAL(order[0], 2);
+    BOOST_CHECK_EQUAL(order[1], 1);
+}
+
+BOOST_AUTO_TEST_CASE(exclusive_tasks)
+{
+    CScheduler scheduler;
+    scheduler.m_service_thread = std::thread([&]() { scheduler.serviceQueue(); });
+    scheduler.StartWorkers(3);
+
+    // An exclusive task must never overlap with any other task.
+    std::atomic<int> running{0};
+    std::atomic<bool> overlap{false};
+    const auto now{std::chrono::system_clock::now()};
+    for (int i = 0; i < 20; ++i) {
+        scheduler.schedule([&] {
+            if (++running > 1) overlap = true;
+            UninterruptibleSleep(std::chrono::milliseconds{1});
+            --running;
+        }, now, CScheduler::Priority::LOW, /* exclusive */ true);
+    }
+    scheduler.StopWhenDrained();
+
+    BOOST_CHECK(!overlap);
+}
+
 BOOST_AUTO_TEST_CASE(mockforward)
 {
     CScheduler scheduler;
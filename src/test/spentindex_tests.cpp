@@ -0,0 +1,62 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/spentindex.h>
+#include <script/interpreter.h>
+#include <script/standard.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(spentindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(spentindex_initial_sync, TestChain100Setup)
+{
+    SpentIndex spentindex(1 << 20, true);
+    spentindex.Start();
+
+    // Allow the spent index to catch up with the block index.
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!spentindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+
+    // All coinbase outputs of the test chain are unspent.
+    SpentLocation location;
+    const COutPoint unspent{m_coinbase_txns[0]->GetHash(), 0};
+    BOOST_CHECK(!spentindex.FindSpend(unspent, location));
+
+    // Spend the first coinbase output and mine the spend. The test chain pays
+    // its coinbases to a bare P2PK script.
+    const CScript coinbase_script_pub_key = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    CMutableTransaction spend_tx;
+    spend_tx.vin.emplace_back(unspent);
+    spend_tx.vout.emplace_back(50 * COIN - 1000, CScript() << OP_TRUE);
+    {
+        std::vector<unsigned char> sig;
+        const uint256 hash = SignatureHash(coinbase_script_pub_key, spend_tx, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+        BOOST_REQUIRE(coinbaseKey.Sign(hash, sig));
+        sig.push_back(SIGHASH_ALL);
+        spend_tx.vin[0].scriptSig << sig;
+    }
+    CreateAndProcessBlock({spend_tx}, coinbase_script_pub_key);
+    BOOST_CHECK(spentindex.BlockUntilSyncedToCurrentChain());
+
+    // The spend is now a single read away.
+    BOOST_REQUIRE(spentindex.FindSpend(unspent, location));
+    BOOST_CHECK_EQUAL(location.txid, spend_tx.GetHash());
+    BOOST_CHECK_EQUAL(location.input_n, 0U);
+    BOOST_CHECK_EQUAL(location.height, 101);
+
+    // shutdown sequence (c.f. Shutdown() in init.cpp)
+    spentindex.Stop();
+
+    // Let scheduler events finish running to avoid accessing any memory related to spentindex after it is destructed
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
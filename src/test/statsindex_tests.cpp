@@ -0,0 +1,80 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <index/statsindex.h>
+#include <script/interpreter.h>
+#include <script/standard.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(statsindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(statsindex_initial_sync, TestChain100Setup)
+{
+    StatsIndex statsindex(1 << 20, true);
+    statsindex.Start();
+
+    // Allow the stats index to catch up with the block index.
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!statsindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+
+    // Coinbase-only blocks have one transaction and no fees.
+    BlockStats stats;
+    {
+        LOCK(cs_main);
+        BOOST_REQUIRE(statsindex.LookupStats(::ChainActive()[50], stats));
+    }
+    BOOST_CHECK_EQUAL(stats.txs, 1);
+    BOOST_CHECK_EQUAL(stats.ins, 0);
+    // Payout plus the segwit commitment output (segwit is always active on
+    // regtest, so every coinbase carries one).
+    BOOST_CHECK_EQUAL(stats.outs, 2);
+    BOOST_CHECK_EQUAL(stats.totalfee, 0);
+
+    // Spend the first coinbase output with a 1000 satoshi fee and mine it.
+    // The test chain pays its coinbases to a bare P2PK script.
+    const CScript coinbase_script_pub_key = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    CMutableTransaction spend_tx;
+    spend_tx.vin.emplace_back(COutPoint{m_coinbase_txns[0]->GetHash(), 0});
+    spend_tx.vout.emplace_back(50 * COIN - 1000, CScript() << OP_TRUE);
+    {
+        std::vector<unsigned char> sig;
+        const uint256 hash = SignatureHash(coinbase_script_pub_key, spend_tx, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+        BOOST_REQUIRE(coinbaseKey.Sign(hash, sig));
+        sig.push_back(SIGHASH_ALL);
+        spend_tx.vin[0].scriptSig << sig;
+    }
+    CreateAndProcessBlock({spend_tx}, coinbase_script_pub_key);
+    BOOST_CHECK(statsindex.BlockUntilSyncedToCurrentChain());
+
+    {
+        LOCK(cs_main);
+        BOOST_REQUIRE(statsindex.LookupStats(::ChainActive().Tip(), stats));
+    }
+    BOOST_CHECK_EQUAL(stats.txs, 2);
+    BOOST_CHECK_EQUAL(stats.ins, 1);
+    BOOST_CHECK_EQUAL(stats.outs, 3);
+    BOOST_CHECK_EQUAL(stats.totalfee, 1000);
+    BOOST_CHECK_EQUAL(stats.minfee, 1000);
+    BOOST_CHECK_EQUAL(stats.maxfee, 1000);
+    BOOST_CHECK_EQUAL(stats.total_out, 50 * COIN - 1000);
+    BOOST_CHECK(stats.total_size > 0);
+    BOOST_CHECK(stats.total_weight > 0);
+
+    // shutdown sequence (c.f. Shutdown() in init.cpp)
+    statsindex.Stop();
+
+    // Let scheduler events finish running to avoid accessing any memory related to statsindex after it is destructed
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -9,6 +9,7 @@
 #include <consensus/consensus.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
+#include <crypto/chacha20.h>
 #include <crypto/sha256.h>
 #include <init.h>
 #include <interfaces/chain.h>
@@ -102,6 +103,7 @@ BasicTestingSetup::BasicTestingSetup(const std::string& chainName, const std::ve
     AppInitParameterInteraction(*m_node.args);
     LogInstance().StartLogging();
     SHA256AutoDetect();
+    ChaCha20AutoDetect();
     ECC_Start();
     SetupEnvironment();
     SetupNetworking();
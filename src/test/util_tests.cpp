@@ -760,6 +760,23 @@ BOOST_AUTO_TEST_CASE(util_GetArg)
     BOOST_CHECK_EQUAL(testArgs.GetArg("pritest4", "default"), "b");
 }
 
+BOOST_AUTO_TEST_CASE(util_CachedArg)
+{
+    const CachedArg<int64_t> cached_int{"-cachedargtest", 11};
+    const CachedArg<bool> cached_bool{"-cachedargtestbool", false};
+
+    // Unset arguments resolve to their defaults.
+    BOOST_CHECK_EQUAL(cached_int.Get(), 11);
+    BOOST_CHECK_EQUAL(cached_bool.Get(), false);
+
+    // ForceSetArg bumps the args revision, so handles that have already
+    // resolved pick up the new values on their next read.
+    gArgs.ForceSetArg("-cachedargtest", "42");
+    gArgs.ForceSetArg("-cachedargtestbool", "1");
+    BOOST_CHECK_EQUAL(cached_int.Get(), 42);
+    BOOST_CHECK_EQUAL(cached_bool.Get(), true);
+}
+
 BOOST_AUTO_TEST_CASE(util_GetChainName)
 {
     TestArgsManager test_args;
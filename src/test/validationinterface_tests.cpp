@@ -7,6 +7,7 @@
 #include <primitives/block.h>
 #include <scheduler.h>
 #include <test/util/setup_common.h>
+#include <txmempool.h>
 #include <util/check.h>
 #include <validationinterface.h>
 
@@ -91,4 +92,40 @@ BOOST_AUTO_TEST_CASE(unregister_all_during_call)
     BOOST_CHECK(destroyed);
 }
 
+// Mempool notifications are coalesced into batches; both the batch-aware
+// callback and the default per-transaction replay must observe the events in
+// generation order.
+BOOST_AUTO_TEST_CASE(batched_mempool_events)
+{
+    struct BatchSubscriber final : public CValidationInterface {
+        std::vector<bool> m_added;
+        void MempoolTransactionsChanged(const std::vector<MempoolTxEvent>& events) override
+        {
+            for (const MempoolTxEvent& event : events) m_added.push_back(event.added);
+        }
+    };
+    struct ReplaySubscriber final : public CValidationInterface {
+        std::vector<bool> m_added;
+        void TransactionAddedToMempool(const CTransactionRef&, uint64_t) override { m_added.push_back(true); }
+        void TransactionRemovedFromMempool(const CTransactionRef&, MemPoolRemovalReason, uint64_t) override { m_added.push_back(false); }
+    };
+    auto batch_sub = std::make_shared<BatchSubscriber>();
+    auto replay_sub = std::make_shared<ReplaySubscriber>();
+    RegisterSharedValidationInterface(batch_sub);
+    RegisterSharedValidationInterface(replay_sub);
+
+    const CTransactionRef tx = MakeTransactionRef(CMutableTransaction{});
+    GetMainSignals().TransactionAddedToMempool(tx, /* mempool_sequence */ 1);
+    GetMainSignals().TransactionAddedToMempool(tx, 2);
+    GetMainSignals().TransactionRemovedFromMempool(tx, MemPoolRemovalReason::EXPIRY, 3);
+    SyncWithValidationInterfaceQueue();
+
+    const std::vector<bool> expected{true, true, false};
+    BOOST_CHECK(batch_sub->m_added == expected);
+    BOOST_CHECK(replay_sub->m_added == expected);
+
+    UnregisterSharedValidationInterface(replay_sub);
+    UnregisterSharedValidationInterface(batch_sub);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
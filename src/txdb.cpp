@@ -14,10 +14,15 @@
 #include <util/translation.h>
 #include <util/vector.h>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <stdint.h>
 
 static const char DB_COIN = 'C';
 static const char DB_COINS = 'c';
+static const char DB_TXCOINS = 'T';
+static const char DB_COINS_LAYOUT = 'G';
 static const char DB_BLOCK_FILES = 'f';
 static const char DB_BLOCK_INDEX = 'b';
 
@@ -37,12 +42,63 @@ struct CoinEntry {
     SERIALIZE_METHODS(CoinEntry, obj) { READWRITE(obj.key, obj.outpoint->hash, VARINT(obj.outpoint->n)); }
 };
 
+struct TxCoinsEntry {
+    uint256* txid;
+    char key;
+    explicit TxCoinsEntry(const uint256* ptr) : txid(const_cast<uint256*>(ptr)), key(DB_TXCOINS) {}
+
+    SERIALIZE_METHODS(TxCoinsEntry, obj) { READWRITE(obj.key, *obj.txid); }
+};
+
+/** All unspent outputs of one txid, sorted by output index. */
+struct TxCoins {
+    std::vector<std::pair<uint32_t, Coin>> coins;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        WriteCompactSize(s, coins.size());
+        for (const auto& [n, coin] : coins) {
+            ::Serialize(s, VARINT(n));
+            ::Serialize(s, coin);
+        }
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        coins.resize(ReadCompactSize(s));
+        for (auto& [n, coin] : coins) {
+            ::Unserialize(s, VARINT(n));
+            ::Unserialize(s, coin);
+        }
+    }
+};
+
+//! Find the position of output index n in a group record (or its insertion point).
+static std::vector<std::pair<uint32_t, Coin>>::iterator FindOutput(std::vector<std::pair<uint32_t, Coin>>& coins, uint32_t n)
+{
+    return std::lower_bound(coins.begin(), coins.end(), n,
+                            [](const std::pair<uint32_t, Coin>& a, uint32_t b) { return a.first < b; });
+}
+
 }
 
 CCoinsViewDB::CCoinsViewDB(fs::path ldb_path, size_t nCacheSize, bool fMemory, bool fWipe) :
     m_db(std::make_unique<CDBWrapper>(ldb_path, nCacheSize, fMemory, fWipe, true)),
     m_ldb_path(ldb_path),
-    m_is_memory(fMemory) { }
+    m_is_memory(fMemory)
+{
+    // The layout is a per-database property: it is chosen when the database
+    // is created and recorded in it, so an existing chainstate keeps its
+    // layout regardless of the current -dbgroupedcoins setting.
+    if (m_db->Exists(DB_COINS_LAYOUT)) {
+        m_group_by_txid = true;
+    } else if (gArgs.GetBoolArg("-dbgroupedcoins", false) && GetBestBlock().IsNull() && GetHeadBlocks().empty()) {
+        m_db->Write(DB_COINS_LAYOUT, uint8_t{1});
+        m_group_by_txid = true;
+    }
+}
 
 void CCoinsViewDB::ResizeCache(size_t new_cache_size)
 {
@@ -58,10 +114,22 @@ void CCoinsViewDB::ResizeCache(size_t new_cache_size)
 }
 
 bool CCoinsViewDB::GetCoin(const COutPoint &outpoint, Coin &coin) const {
+    if (m_group_by_txid) {
+        TxCoins group;
+        if (!m_db->Read(TxCoinsEntry(&outpoint.hash), group)) return false;
+        auto it = FindOutput(group.coins, outpoint.n);
+        if (it == group.coins.end() || it->first != outpoint.n) return false;
+        coin = std::move(it->second);
+        return true;
+    }
     return m_db->Read(CoinEntry(&outpoint), coin);
 }
 
 bool CCoinsViewDB::HaveCoin(const COutPoint &outpoint) const {
+    if (m_group_by_txid) {
+        Coin coin;
+        return GetCoin(outpoint, coin);
+    }
     return m_db->Exists(CoinEntry(&outpoint));
 }
 
@@ -81,6 +149,80 @@ std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
 }
 
 bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
+    // Route through the sharded implementation so there is a single copy of
+    // the head-blocks crash-consistency protocol.
+    std::vector<CCoinsMap*> shards{&mapCoins};
+    return BatchWriteInternal(shards, hashBlock);
+}
+
+bool CCoinsViewDB::BatchWriteShards(std::vector<CCoinsMap> &shards, const uint256 &hashBlock) {
+    std::vector<CCoinsMap*> shard_ptrs;
+    shard_ptrs.reserve(shards.size());
+    for (CCoinsMap& shard : shards) shard_ptrs.push_back(&shard);
+    return BatchWriteInternal(shard_ptrs, hashBlock);
+}
+
+bool CCoinsViewDB::BatchWriteIncremental(const CCoinsMap &shard, const uint256 &hashBlock) {
+    CDBBatch batch(*m_db);
+    size_t batch_size = (size_t)gArgs.GetArg("-dbbatchsize", nDefaultDbBatchSize);
+    assert(!hashBlock.IsNull());
+
+    uint256 old_tip = GetBestBlock();
+    if (old_tip.IsNull()) {
+        // An earlier incremental write (or an interrupted flush) already put
+        // us mid-transition; keep the original old tip as the replay base. On
+        // a fresh database there are no head blocks either and the replay
+        // base stays null, as in a full flush.
+        std::vector<uint256> old_heads = GetHeadBlocks();
+        if (old_heads.size() == 2) {
+            old_tip = old_heads[1];
+        }
+    }
+
+    // Mark the database as being in the middle of a transition from old_tip
+    // to hashBlock. Deliberately no DB_BEST_BLOCK write at the end: the
+    // database stays mid-transition until the next full flush completes it,
+    // and a crash before then replays from old_tip.
+    batch.Erase(DB_BEST_BLOCK);
+    batch.Write(DB_HEAD_BLOCKS, Vector(hashBlock, old_tip));
+
+    size_t changed = 0;
+    if (m_group_by_txid) {
+        TxCoinUpdates updates;
+        for (const auto& [outpoint, entry] : shard) {
+            if (!(entry.flags & CCoinsCacheEntry::DIRTY)) continue;
+            auto& ops = updates[outpoint.hash];
+            if (entry.coin.IsSpent()) {
+                ops.emplace_back(outpoint.n, std::nullopt);
+            } else {
+                ops.emplace_back(outpoint.n, entry.coin);
+            }
+            changed++;
+        }
+        if (!BatchWriteGroupedCoins(updates, batch, batch_size, /* crash_simulate */ 0)) return false;
+    } else {
+        for (CCoinsMap::const_iterator it = shard.begin(); it != shard.end(); ++it) {
+            if (!(it->second.flags & CCoinsCacheEntry::DIRTY)) continue;
+            CoinEntry entry(&it->first);
+            if (it->second.coin.IsSpent())
+                batch.Erase(entry);
+            else
+                batch.Write(entry, it->second.coin);
+            changed++;
+            if (batch.SizeEstimate() > batch_size) {
+                LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.SizeEstimate() * (1.0 / 1048576.0));
+                m_db->WriteBatch(batch);
+                batch.Clear();
+            }
+        }
+    }
+
+    bool ret = m_db->WriteBatch(batch);
+    LogPrint(BCLog::COINDB, "Incrementally committed %u changed transaction outputs (out of %u) to coin database...\n", (unsigned int)changed, (unsigned int)shard.size());
+    return ret;
+}
+
+bool CCoinsViewDB::BatchWriteInternal(std::vector<CCoinsMap*> &shards, const uint256 &hashBlock) {
     CDBBatch batch(*m_db);
     size_t count = 0;
     size_t changed = 0;
@@ -90,10 +232,12 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
 
     uint256 old_tip = GetBestBlock();
     if (old_tip.IsNull()) {
-        // We may be in the middle of replaying.
+        // We may be in the middle of replaying, or an incremental write may
+        // have left us mid-transition (in which case the head has typically
+        // advanced past old_heads[0] since); either way the original old tip
+        // stays the replay base.
         std::vector<uint256> old_heads = GetHeadBlocks();
         if (old_heads.size() == 2) {
-            assert(old_heads[0] == hashBlock);
             old_tip = old_heads[1];
         }
     }
@@ -105,27 +249,58 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     batch.Erase(DB_BEST_BLOCK);
     batch.Write(DB_HEAD_BLOCKS, Vector(hashBlock, old_tip));
 
-    for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
-        if (it->second.flags & CCoinsCacheEntry::DIRTY) {
-            CoinEntry entry(&it->first);
-            if (it->second.coin.IsSpent())
-                batch.Erase(entry);
-            else
-                batch.Write(entry, it->second.coin);
-            changed++;
+    // The shards are consumed one at a time; all of them are committed under
+    // the same head-blocks marker, so a crash at any point replays the whole
+    // transition.
+    if (m_group_by_txid) {
+        // Coalesce the dirty entries of all shards by txid (outputs of one
+        // txid may be spread across shards), then merge each group into its
+        // stored record with one read and one write.
+        TxCoinUpdates updates;
+        for (CCoinsMap* shard : shards) {
+            CCoinsMap& mapCoins = *shard;
+            for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
+                if (it->second.flags & CCoinsCacheEntry::DIRTY) {
+                    auto& ops = updates[it->first.hash];
+                    if (it->second.coin.IsSpent()) {
+                        ops.emplace_back(it->first.n, std::nullopt);
+                    } else {
+                        ops.emplace_back(it->first.n, std::move(it->second.coin));
+                    }
+                    changed++;
+                }
+                count++;
+                CCoinsMap::iterator itOld = it++;
+                mapCoins.erase(itOld);
+            }
         }
-        count++;
-        CCoinsMap::iterator itOld = it++;
-        mapCoins.erase(itOld);
-        if (batch.SizeEstimate() > batch_size) {
-            LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.SizeEstimate() * (1.0 / 1048576.0));
-            m_db->WriteBatch(batch);
-            batch.Clear();
-            if (crash_simulate) {
-                static FastRandomContext rng;
-                if (rng.randrange(crash_simulate) == 0) {
-                    LogPrintf("Simulating a crash. Goodbye.\n");
-                    _Exit(0);
+        if (!BatchWriteGroupedCoins(updates, batch, batch_size, crash_simulate)) return false;
+    } else {
+        for (CCoinsMap* shard : shards) {
+            CCoinsMap& mapCoins = *shard;
+            for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
+                if (it->second.flags & CCoinsCacheEntry::DIRTY) {
+                    CoinEntry entry(&it->first);
+                    if (it->second.coin.IsSpent())
+                        batch.Erase(entry);
+                    else
+                        batch.Write(entry, it->second.coin);
+                    changed++;
+                }
+                count++;
+                CCoinsMap::iterator itOld = it++;
+                mapCoins.erase(itOld);
+                if (batch.SizeEstimate() > batch_size) {
+                    LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.SizeEstimate() * (1.0 / 1048576.0));
+                    m_db->WriteBatch(batch);
+                    batch.Clear();
+                    if (crash_simulate) {
+                        static FastRandomContext rng;
+                        if (rng.randrange(crash_simulate) == 0) {
+                            LogPrintf("Simulating a crash. Goodbye.\n");
+                            _Exit(0);
+                        }
+                    }
                 }
             }
         }
@@ -141,8 +316,50 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     return ret;
 }
 
+bool CCoinsViewDB::BatchWriteGroupedCoins(TxCoinUpdates& updates, CDBBatch& batch, size_t batch_size, int crash_simulate)
+{
+    for (auto& [txid, ops] : updates) {
+        TxCoinsEntry entry(&txid);
+        TxCoins group;
+        m_db->Read(entry, group); // a missing record merges as an empty group
+        for (auto& [n, coin] : ops) {
+            auto it = FindOutput(group.coins, n);
+            if (coin) {
+                if (it != group.coins.end() && it->first == n) {
+                    it->second = std::move(*coin);
+                } else {
+                    group.coins.emplace(it, n, std::move(*coin));
+                }
+            } else if (it != group.coins.end() && it->first == n) {
+                group.coins.erase(it);
+            }
+        }
+        if (group.coins.empty()) {
+            batch.Erase(entry);
+        } else {
+            batch.Write(entry, group);
+        }
+        if (batch.SizeEstimate() > batch_size) {
+            LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.SizeEstimate() * (1.0 / 1048576.0));
+            if (!m_db->WriteBatch(batch)) return false;
+            batch.Clear();
+            if (crash_simulate) {
+                static FastRandomContext rng;
+                if (rng.randrange(crash_simulate) == 0) {
+                    LogPrintf("Simulating a crash. Goodbye.\n");
+                    _Exit(0);
+                }
+            }
+        }
+    }
+    return true;
+}
+
 size_t CCoinsViewDB::EstimateSize() const
 {
+    if (m_group_by_txid) {
+        return m_db->EstimateSize(DB_TXCOINS, (char)(DB_TXCOINS+1));
+    }
     return m_db->EstimateSize(DB_COIN, (char)(DB_COIN+1));
 }
 
@@ -170,11 +387,28 @@ bool CBlockTreeDB::ReadLastBlockFile(int &nFile) {
 
 CCoinsViewCursor *CCoinsViewDB::Cursor() const
 {
-    CCoinsViewDBCursor *i = new CCoinsViewDBCursor(const_cast<CDBWrapper&>(*m_db).NewIterator(), GetBestBlock());
+    return Cursor(0);
+}
+
+CCoinsViewCursor *CCoinsViewDB::Cursor(uint8_t txid_first_byte) const
+{
+    CCoinsViewDBCursor *i = new CCoinsViewDBCursor(const_cast<CDBWrapper&>(*m_db).NewIterator(), GetBestBlock(), m_group_by_txid);
     /* It seems that there are no "const iterators" for LevelDB.  Since we
        only need read operations on it, use a const-cast to get around
        that restriction.  */
-    i->pcursor->Seek(DB_COIN);
+    // Database keys order txids by their serialized bytes, so the first coin
+    // of the slice is the smallest txid with the given leading byte.
+    uint256 start_txid;
+    *start_txid.begin() = txid_first_byte;
+    if (m_group_by_txid) {
+        TxCoinsEntry start_entry(&start_txid);
+        i->pcursor->Seek(start_entry);
+        i->LoadCurrentGroup();
+        return i;
+    }
+    const COutPoint start_outpoint{start_txid, 0};
+    CoinEntry start_entry(&start_outpoint);
+    i->pcursor->Seek(start_entry);
     // Cache key of first record
     if (i->pcursor->Valid()) {
         CoinEntry entry(&i->keyTmp.second);
@@ -186,10 +420,29 @@ CCoinsViewCursor *CCoinsViewDB::Cursor() const
     return i;
 }
 
+void CCoinsViewDBCursor::LoadCurrentGroup()
+{
+    m_group.clear();
+    m_group_pos = 0;
+    uint256 txid;
+    TxCoinsEntry entry(&txid);
+    while (pcursor->Valid() && pcursor->GetKey(entry) && entry.key == DB_TXCOINS) {
+        TxCoins group;
+        if (pcursor->GetValue(group) && !group.coins.empty()) {
+            m_group = std::move(group.coins);
+            keyTmp.first = DB_TXCOINS;
+            keyTmp.second = COutPoint(txid, m_group[0].first);
+            return;
+        }
+        pcursor->Next();
+    }
+    keyTmp.first = 0; // Make sure Valid() and GetKey() return false
+}
+
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
 {
     // Return cached key
-    if (keyTmp.first == DB_COIN) {
+    if (Valid()) {
         key = keyTmp.second;
         return true;
     }
@@ -198,21 +451,40 @@ bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
 
 bool CCoinsViewDBCursor::GetValue(Coin &coin) const
 {
+    if (m_grouped) {
+        if (!Valid()) return false;
+        coin = m_group[m_group_pos].second;
+        return true;
+    }
     return pcursor->GetValue(coin);
 }
 
 unsigned int CCoinsViewDBCursor::GetValueSize() const
 {
+    if (m_grouped) {
+        // Approximate the per-outpoint share; the group record stores its
+        // outpoints' coins back to back.
+        return ::GetSerializeSize(m_group[m_group_pos].second, CLIENT_VERSION);
+    }
     return pcursor->GetValueSize();
 }
 
 bool CCoinsViewDBCursor::Valid() const
 {
-    return keyTmp.first == DB_COIN;
+    return keyTmp.first == (m_grouped ? DB_TXCOINS : DB_COIN);
 }
 
 void CCoinsViewDBCursor::Next()
 {
+    if (m_grouped) {
+        if (++m_group_pos < m_group.size()) {
+            keyTmp.second.n = m_group[m_group_pos].first;
+            return;
+        }
+        pcursor->Next();
+        LoadCurrentGroup();
+        return;
+    }
     pcursor->Next();
     CoinEntry entry(&keyTmp.second);
     if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
@@ -248,41 +520,84 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
 
 bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex)
 {
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-
-    pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
+    // Loading the block index is split into two phases. The first phase reads,
+    // deserializes and proof-of-work-checks the entries, which is where nearly
+    // all the time goes (each entry hashes its header to recover the block
+    // hash). The entries are keyed by block hash, so the keyspace is uniformly
+    // distributed and can be sharded by the leading hash byte, with each shard
+    // scanned on its own thread through its own iterator. The second phase
+    // inserts the entries into the block map on the calling thread, keeping
+    // the cs_main contract of the insertBlockIndex callback unchanged.
+    struct LoadedEntry {
+        uint256 hash;
+        CDiskBlockIndex index;
+    };
+
+    const int num_workers = std::clamp(GetNumCores(), 1, 8);
+    std::vector<std::vector<LoadedEntry>> shards(num_workers);
+    std::atomic<bool> interrupted{false};
+
+    const auto load_shard = [&](int worker) {
+        const unsigned int first_byte = (worker * 256) / num_workers;
+        const unsigned int end_byte = ((worker + 1) * 256) / num_workers;
+
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        uint256 start_hash;
+        *start_hash.begin() = static_cast<unsigned char>(first_byte);
+        pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, start_hash));
+
+        while (pcursor->Valid()) {
+            if (ShutdownRequested()) {
+                interrupted = true;
+                return false;
+            }
+            std::pair<char, uint256> key;
+            if (!pcursor->GetKey(key) || key.first != DB_BLOCK_INDEX) break;
+            if (static_cast<unsigned int>(*key.second.begin()) >= end_byte) break;
 
-    // Load m_block_index
-    while (pcursor->Valid()) {
-        if (ShutdownRequested()) return false;
-        std::pair<char, uint256> key;
-        if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
-            CDiskBlockIndex diskindex;
-            if (pcursor->GetValue(diskindex)) {
-                // Construct block index object
-                CBlockIndex* pindexNew = insertBlockIndex(diskindex.GetBlockHash());
-                pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
-                pindexNew->nHeight        = diskindex.nHeight;
-                pindexNew->nFile          = diskindex.nFile;
-                pindexNew->nDataPos       = diskindex.nDataPos;
-                pindexNew->nUndoPos       = diskindex.nUndoPos;
-                pindexNew->nVersion       = diskindex.nVersion;
-                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-                pindexNew->nTime          = diskindex.nTime;
-                pindexNew->nBits          = diskindex.nBits;
-                pindexNew->nNonce         = diskindex.nNonce;
-                pindexNew->nStatus        = diskindex.nStatus;
-                pindexNew->nTx            = diskindex.nTx;
-
-                if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams))
-                    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
-
-                pcursor->Next();
-            } else {
+            LoadedEntry entry;
+            if (!pcursor->GetValue(entry.index)) {
                 return error("%s: failed to read value", __func__);
             }
-        } else {
-            break;
+            entry.hash = entry.index.GetBlockHash();
+
+            if (!CheckProofOfWork(entry.hash, entry.index.nBits, consensusParams)) {
+                return error("%s: CheckProofOfWork failed: %s", __func__, entry.hash.ToString());
+            }
+
+            shards[worker].push_back(std::move(entry));
+            pcursor->Next();
+        }
+        return true;
+    };
+
+    bool ok = true;
+    std::vector<std::future<bool>> workers;
+    workers.reserve(num_workers - 1);
+    for (int w = 1; w < num_workers; ++w) {
+        workers.push_back(std::async(std::launch::async, load_shard, w));
+    }
+    ok &= load_shard(0);
+    for (auto& worker : workers) ok &= worker.get();
+    if (!ok || interrupted) return false;
+
+    // Construct the block index objects
+    for (const auto& shard : shards) {
+        for (const LoadedEntry& entry : shard) {
+            const CDiskBlockIndex& diskindex = entry.index;
+            CBlockIndex* pindexNew = insertBlockIndex(entry.hash);
+            pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
+            pindexNew->nHeight        = diskindex.nHeight;
+            pindexNew->nFile          = diskindex.nFile;
+            pindexNew->nDataPos       = diskindex.nDataPos;
+            pindexNew->nUndoPos       = diskindex.nUndoPos;
+            pindexNew->nVersion       = diskindex.nVersion;
+            pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+            pindexNew->nTime          = diskindex.nTime;
+            pindexNew->nBits          = diskindex.nBits;
+            pindexNew->nNonce         = diskindex.nNonce;
+            pindexNew->nStatus        = diskindex.nStatus;
+            pindexNew->nTx            = diskindex.nTx;
         }
     }
 
@@ -11,7 +11,9 @@
 #include <chain.h>
 #include <primitives/block.h>
 
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -49,6 +51,10 @@ protected:
     std::unique_ptr<CDBWrapper> m_db;
     fs::path m_ldb_path;
     bool m_is_memory;
+    //! Whether this database groups all unspent outputs of a txid under one
+    //! key instead of storing one entry per outpoint. Chosen at database
+    //! creation (see -dbgroupedcoins) and recorded in the database itself.
+    bool m_group_by_txid{false};
 public:
     /**
      * @param[in] ldb_path    Location in the filesystem where leveldb data will be stored.
@@ -60,14 +66,40 @@ public:
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+    bool BatchWriteShards(std::vector<CCoinsMap> &shards, const uint256 &hashBlock) override;
+    bool BatchWriteIncremental(const CCoinsMap &shard, const uint256 &hashBlock) override;
     CCoinsViewCursor *Cursor() const override;
+    //! Cursor positioned at the first coin whose txid starts at or after the
+    //! given leading byte (in database key order). Together with a caller-side
+    //! stop bound this allows scanning a slice of the keyspace, so the UTXO
+    //! set can be walked by several threads at once.
+    CCoinsViewCursor *Cursor(uint8_t txid_first_byte) const;
 
     //! Attempt to update from an older database format. Returns whether an error occurred.
     bool Upgrade();
     size_t EstimateSize() const override;
 
+    //! Fetch one of the database's leveldb property strings (see
+    //! CDBWrapper::GetProperty).
+    bool GetDBProperty(const std::string& name, std::string& out) const { return m_db->GetProperty(name, out); }
+
     //! Dynamically alter the underlying leveldb cache size.
     void ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+private:
+    //! Shared implementation of the two BatchWrite variants: commits all
+    //! passed shards within a single head-blocks transition.
+    bool BatchWriteInternal(std::vector<CCoinsMap*> &shards, const uint256 &hashBlock);
+
+    //! Pending per-output changes of one flush, grouped by txid. A nullopt
+    //! coin erases that output index from the txid's group record.
+    using TxCoinUpdates = std::map<uint256, std::vector<std::pair<uint32_t, std::optional<Coin>>>>;
+
+    //! Merge the updates into their per-txid group records, appending the
+    //! resulting writes to batch and committing partial batches along the
+    //! way. Reads go against committed state; each txid is touched exactly
+    //! once per flush, so partial commits are never read back.
+    bool BatchWriteGroupedCoins(TxCoinUpdates& updates, CDBBatch& batch, size_t batch_size, int crash_simulate);
 };
 
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
@@ -84,10 +116,21 @@ public:
     void Next() override;
 
 private:
-    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256 &hashBlockIn):
-        CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn) {}
+    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256 &hashBlockIn, bool grouped):
+        CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn), m_grouped(grouped) {}
+
+    //! Position on the first outpoint of the next non-empty group record, or
+    //! invalidate the cursor if there is none. Grouped layout only.
+    void LoadCurrentGroup();
+
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
+    //! Whether the underlying database uses the grouped-by-txid layout.
+    bool m_grouped;
+    //! Grouped layout: the group record currently being expanded into
+    //! per-outpoint entries, and the position within it.
+    std::vector<std::pair<uint32_t, Coin>> m_group;
+    size_t m_group_pos{0};
 
     friend class CCoinsViewDB;
 };
@@ -12,6 +12,7 @@
 #include <policy/policy.h>
 #include <policy/settings.h>
 #include <reverse_iterator.h>
+#include <script/interpreter.h>
 #include <util/moneystr.h>
 #include <util/system.h>
 #include <util/time.h>
@@ -50,6 +51,19 @@ void CTxMemPoolEntry::UpdateLockPoints(const LockPoints& lp)
     lockPoints = lp;
 }
 
+void CTxMemPoolEntry::SetValidationArtifacts(std::shared_ptr<const PrecomputedTransactionData> txdata, uint32_t script_flags)
+{
+    m_precomputed_txdata = std::move(txdata);
+    m_validated_script_flags = script_flags;
+    if (m_precomputed_txdata) {
+        nUsageSize += memusage::MallocUsage(sizeof(PrecomputedTransactionData)) +
+                      memusage::DynamicUsage(m_precomputed_txdata->m_spent_outputs);
+        for (const CTxOut& txout : m_precomputed_txdata->m_spent_outputs) {
+            nUsageSize += RecursiveDynamicUsage(txout.scriptPubKey);
+        }
+    }
+}
+
 size_t CTxMemPoolEntry::GetTxSize() const
 {
     return GetVirtualTransactionSize(nTxWeight, sigOpCost);
@@ -152,17 +166,19 @@ void CTxMemPool::UpdateTransactionsFromBlock(const std::vector<uint256> &vHashes
 
 bool CTxMemPool::CalculateMemPoolAncestors(const CTxMemPoolEntry &entry, setEntries &setAncestors, uint64_t limitAncestorCount, uint64_t limitAncestorSize, uint64_t limitDescendantCount, uint64_t limitDescendantSize, std::string &errString, bool fSearchForParents /* = true */) const
 {
-    CTxMemPoolEntry::Parents staged_ancestors;
+    std::vector<txiter> staged_ancestors;
     const CTransaction &tx = entry.GetTx();
 
+    WITH_FRESH_EPOCH(m_epoch);
+
     if (fSearchForParents) {
         // Get parents of this transaction that are in the mempool
         // GetMemPoolParents() is only valid for entries in the mempool, so we
         // iterate mapTx to find parents.
         for (unsigned int i = 0; i < tx.vin.size(); i++) {
             std::optional<txiter> piter = GetIter(tx.vin[i].prevout.hash);
-            if (piter) {
-                staged_ancestors.insert(**piter);
+            if (piter && !visited(*piter)) {
+                staged_ancestors.push_back(*piter);
                 if (staged_ancestors.size() + 1 > limitAncestorCount) {
                     errString = strprintf("too many unconfirmed parents [limit: %u]", limitAncestorCount);
                     return false;
@@ -173,17 +189,34 @@ bool CTxMemPool::CalculateMemPoolAncestors(const CTxMemPoolEntry &entry, setEntr
         // If we're not searching for parents, we require this to be an
         // entry in the mempool already.
         txiter it = mapTx.iterator_to(entry);
-        staged_ancestors = it->GetMemPoolParentsConst();
+        for (const CTxMemPoolEntry& parent : it->GetMemPoolParentsConst()) {
+            txiter parent_it = mapTx.iterator_to(parent);
+            if (!visited(parent_it)) staged_ancestors.push_back(parent_it);
+        }
+    }
+
+    // Quick rejection using the ancestor aggregates that are maintained
+    // incrementally on every entry: the true ancestor set is a superset of any
+    // single parent's, so a limit already exceeded there cannot be satisfied,
+    // and we can fail without walking the cluster at all.
+    for (txiter parent_it : staged_ancestors) {
+        if (parent_it->GetCountWithAncestors() + 1 > limitAncestorCount) {
+            errString = strprintf("too many unconfirmed ancestors [limit: %u]", limitAncestorCount);
+            return false;
+        }
+        if (parent_it->GetSizeWithAncestors() + entry.GetTxSize() > limitAncestorSize) {
+            errString = strprintf("exceeds ancestor size limit [limit: %u]", limitAncestorSize);
+            return false;
+        }
     }
 
     size_t totalSizeWithAncestors = entry.GetTxSize();
 
     while (!staged_ancestors.empty()) {
-        const CTxMemPoolEntry& stage = staged_ancestors.begin()->get();
-        txiter stageit = mapTx.iterator_to(stage);
+        txiter stageit = staged_ancestors.back();
+        staged_ancestors.pop_back();
 
         setAncestors.insert(stageit);
-        staged_ancestors.erase(stage);
         totalSizeWithAncestors += stageit->GetTxSize();
 
         if (stageit->GetSizeWithDescendants() + entry.GetTxSize() > limitDescendantSize) {
@@ -202,8 +235,8 @@ bool CTxMemPool::CalculateMemPoolAncestors(const CTxMemPoolEntry &entry, setEntr
             txiter parent_it = mapTx.iterator_to(parent);
 
             // If this is a new ancestor, add it.
-            if (setAncestors.count(parent_it) == 0) {
-                staged_ancestors.insert(parent);
+            if (!visited(parent_it)) {
+                staged_ancestors.push_back(parent_it);
             }
             if (staged_ancestors.size() + setAncestors.size() + 1 > limitAncestorCount) {
                 errString = strprintf("too many unconfirmed ancestors [limit: %u]", limitAncestorCount);
@@ -264,6 +297,18 @@ void CTxMemPool::UpdateForRemoveFromMempool(const setEntries &entriesToRemove, b
         // Here we only update statistics and not data in CTxMemPool::Parents
         // and CTxMemPoolEntry::Children (which we need to preserve until we're
         // finished with all operations that need to traverse the mempool).
+        // Aggregate the adjustments across the whole batch before applying
+        // them, so that each surviving descendant is modified (and thus
+        // reindexed) at most once no matter how many of its ancestors are
+        // being removed. Entries that are themselves being removed need no
+        // fixup, as their state is about to be discarded.
+        struct AncestorDelta {
+            int64_t size{0};
+            CAmount fee{0};
+            int64_t count{0};
+            int64_t sigOps{0};
+        };
+        std::map<txiter, AncestorDelta, CompareIteratorByHash> descendant_updates;
         for (txiter removeIt : entriesToRemove) {
             setEntries setDescendants;
             CalculateDescendants(removeIt, setDescendants);
@@ -272,9 +317,18 @@ void CTxMemPool::UpdateForRemoveFromMempool(const setEntries &entriesToRemove, b
             CAmount modifyFee = -removeIt->GetModifiedFee();
             int modifySigOps = -removeIt->GetSigOpCost();
             for (txiter dit : setDescendants) {
-                mapTx.modify(dit, update_ancestor_state(modifySize, modifyFee, -1, modifySigOps));
+                if (entriesToRemove.count(dit)) continue;
+                AncestorDelta& delta = descendant_updates[dit];
+                delta.size += modifySize;
+                delta.fee += modifyFee;
+                delta.count -= 1;
+                delta.sigOps += modifySigOps;
             }
         }
+        for (const auto& update : descendant_updates) {
+            const AncestorDelta& delta = update.second;
+            mapTx.modify(update.first, update_ancestor_state(delta.size, delta.fee, delta.count, delta.sigOps));
+        }
     }
     for (txiter removeIt : entriesToRemove) {
         setEntries setAncestors;
@@ -398,12 +452,20 @@ void CTxMemPool::addUnchecked(const CTxMemPoolEntry &entry, setEntries &setAnces
     nTransactionsUpdated++;
     totalTxSize += entry.GetTxSize();
     m_total_fee += entry.GetFee();
+    UpdateFeeHistogram(*newit, /* sign */ 1);
     if (minerPolicyEstimator) {
         minerPolicyEstimator->processTransaction(entry, validFeeEstimate);
     }
 
     vTxHashes.emplace_back(tx.GetWitnessHash(), newit);
     newit->vTxHashesIdx = vTxHashes.size() - 1;
+
+    {
+        LOCK(m_lookup_mutex);
+        m_lookup_txid.emplace(tx.GetHash(), newit->GetSharedTx());
+        m_lookup_wtxid.emplace(tx.GetWitnessHash(), newit->GetSharedTx());
+        UpdateLookupUsage();
+    }
 }
 
 void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
@@ -435,6 +497,14 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
     } else
         vTxHashes.clear();
 
+    {
+        LOCK(m_lookup_mutex);
+        m_lookup_txid.erase(hash);
+        m_lookup_wtxid.erase(it->GetTx().GetWitnessHash());
+        UpdateLookupUsage();
+    }
+
+    UpdateFeeHistogram(*it, /* sign */ -1);
     totalTxSize -= it->GetTxSize();
     m_total_fee -= it->GetFee();
     cachedInnerUsage -= it->DynamicMemoryUsage();
@@ -567,24 +637,25 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
 {
     AssertLockHeld(cs);
     std::vector<const CTxMemPoolEntry*> entries;
+    setEntries in_block;
     for (const auto& tx : vtx)
     {
         uint256 hash = tx->GetHash();
 
         indexed_transaction_set::iterator i = mapTx.find(hash);
-        if (i != mapTx.end())
+        if (i != mapTx.end()) {
             entries.push_back(&*i);
+            in_block.insert(i);
+        }
     }
     // Before the txs in the new block have been removed from the mempool, update policy estimates
     if (minerPolicyEstimator) {minerPolicyEstimator->processBlock(nBlockHeight, entries);}
+    // Remove all confirmed transactions as a single batch, so that the
+    // descendant state fixups in UpdateForRemoveFromMempool are aggregated
+    // across the block rather than repeated per transaction.
+    RemoveStaged(in_block, true, MemPoolRemovalReason::BLOCK);
     for (const auto& tx : vtx)
     {
-        txiter it = mapTx.find(tx->GetHash());
-        if (it != mapTx.end()) {
-            setEntries stage;
-            stage.insert(it);
-            RemoveStaged(stage, true, MemPoolRemovalReason::BLOCK);
-        }
         removeConflicts(*tx);
         ClearPrioritisation(tx->GetHash());
     }
@@ -594,8 +665,15 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
 
 void CTxMemPool::_clear()
 {
+    {
+        LOCK(m_lookup_mutex);
+        m_lookup_txid.clear();
+        m_lookup_wtxid.clear();
+        UpdateLookupUsage();
+    }
     mapTx.clear();
     mapNextTx.clear();
+    m_fee_histogram.fill(FeeHistogramBucket{});
     totalTxSize = 0;
     m_total_fee = 0;
     cachedInnerUsage = 0;
@@ -624,12 +702,22 @@ void CTxMemPool::check(CChainState& active_chainstate) const
 {
     if (m_check_ratio == 0) return;
 
-    if (GetRand(m_check_ratio) >= 1) return;
+    if (ThreadLocalRng().randrange(m_check_ratio) >= 1) return;
 
     AssertLockHeld(::cs_main);
     LOCK(cs);
     LogPrint(BCLog::MEMPOOL, "Checking mempool with %u transactions and %u inputs\n", (unsigned int)mapTx.size(), (unsigned int)mapNextTx.size());
 
+    {
+        LOCK(m_lookup_mutex);
+        assert(m_lookup_txid.size() == mapTx.size());
+        assert(m_lookup_wtxid.size() == mapTx.size());
+        for (const auto& [txid, tx] : m_lookup_txid) {
+            assert(mapTx.count(txid));
+            assert(m_lookup_wtxid.count(tx->GetWitnessHash()));
+        }
+    }
+
     uint64_t checkTotal = 0;
     CAmount check_total_fee{0};
     uint64_t innerUsage = 0;
@@ -738,6 +826,15 @@ void CTxMemPool::check(CChainState& active_chainstate) const
         assert(&tx == it->second);
     }
 
+    uint64_t histogram_count{0};
+    uint64_t histogram_vsize{0};
+    for (const FeeHistogramBucket& bucket : m_fee_histogram) {
+        histogram_count += bucket.count;
+        histogram_vsize += bucket.vsize;
+    }
+    assert(histogram_count == mapTx.size());
+    assert(histogram_vsize == checkTotal);
+
     assert(totalTxSize == checkTotal);
     assert(m_total_fee == check_total_fee);
     assert(innerUsage == cachedInnerUsage);
@@ -801,6 +898,20 @@ void CTxMemPool::queryHashes(std::vector<uint256>& vtxid) const
     }
 }
 
+std::vector<std::pair<uint256, uint256>> CTxMemPool::GetRelayOrderedHashes() const
+{
+    LOCK(cs);
+    auto iters = GetSortedDepthAndScore();
+
+    std::vector<std::pair<uint256, uint256>> hashes;
+    hashes.reserve(iters.size());
+
+    for (auto it : iters) {
+        hashes.emplace_back(it->GetTx().GetHash(), it->GetTx().GetWitnessHash());
+    }
+    return hashes;
+}
+
 static TxMempoolInfo GetInfo(CTxMemPool::indexed_transaction_set::const_iterator it) {
     return TxMempoolInfo{it->GetSharedTx(), it->GetTime(), it->GetFee(), it->GetTxSize(), it->GetModifiedFee() - it->GetFee()};
 }
@@ -821,11 +932,11 @@ std::vector<TxMempoolInfo> CTxMemPool::infoAll() const
 
 CTransactionRef CTxMemPool::get(const uint256& hash) const
 {
-    LOCK(cs);
-    indexed_transaction_set::const_iterator i = mapTx.find(hash);
-    if (i == mapTx.end())
+    LOCK(m_lookup_mutex);
+    auto it = m_lookup_txid.find(hash);
+    if (it == m_lookup_txid.end())
         return nullptr;
-    return i->GetSharedTx();
+    return it->second;
 }
 
 TxMempoolInfo CTxMemPool::info(const GenTxid& gtxid) const
@@ -847,7 +958,9 @@ void CTxMemPool::PrioritiseTransaction(const uint256& hash, const CAmount& nFeeD
         delta += nFeeDelta;
         txiter it = mapTx.find(hash);
         if (it != mapTx.end()) {
+            UpdateFeeHistogram(*it, /* sign */ -1);
             mapTx.modify(it, update_fee_delta(delta));
+            UpdateFeeHistogram(*it, /* sign */ 1);
             // Now update all ancestors' modified fees with descendants
             setEntries setAncestors;
             uint64_t nNoLimit = std::numeric_limits<uint64_t>::max();
@@ -869,10 +982,27 @@ void CTxMemPool::PrioritiseTransaction(const uint256& hash, const CAmount& nFeeD
     LogPrintf("PrioritiseTransaction: %s feerate += %s\n", hash.ToString(), FormatMoney(nFeeDelta));
 }
 
+size_t CTxMemPool::FeeHistogramBucketIndex(CAmount modified_fee, size_t vsize)
+{
+    const CAmount feerate_per_vb{modified_fee / static_cast<CAmount>(vsize)};
+    size_t bucket{FEE_HISTOGRAM_BUCKET_BOUNDS.size() - 1};
+    while (bucket > 0 && FEE_HISTOGRAM_BUCKET_BOUNDS[bucket] > feerate_per_vb) --bucket;
+    return bucket;
+}
+
+void CTxMemPool::UpdateFeeHistogram(const CTxMemPoolEntry& entry, int sign)
+{
+    AssertLockHeld(cs);
+    FeeHistogramBucket& bucket = m_fee_histogram[FeeHistogramBucketIndex(entry.GetModifiedFee(), entry.GetTxSize())];
+    bucket.count += sign;
+    bucket.vsize += static_cast<uint64_t>(sign * static_cast<int64_t>(entry.GetTxSize()));
+    bucket.fees += sign * entry.GetModifiedFee();
+}
+
 void CTxMemPool::ApplyDelta(const uint256& hash, CAmount &nFeeDelta) const
 {
     AssertLockHeld(cs);
-    std::map<uint256, CAmount>::const_iterator pos = mapDeltas.find(hash);
+    const auto pos = mapDeltas.find(hash);
     if (pos == mapDeltas.end())
         return;
     const CAmount &delta = pos->second;
@@ -936,8 +1066,11 @@ bool CCoinsViewMemPool::GetCoin(const COutPoint &outpoint, Coin &coin) const {
 
 size_t CTxMemPool::DynamicMemoryUsage() const {
     LOCK(cs);
-    // Estimate the overhead of mapTx to be 15 pointers + an allocation, as no exact formula for boost::multi_index_contained is implemented.
-    return memusage::MallocUsage(sizeof(CTxMemPoolEntry) + 15 * sizeof(void*)) * mapTx.size() + memusage::DynamicUsage(mapNextTx) + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(vTxHashes) + cachedInnerUsage;
+    // mapTx's nodes are carved out of pool chunks; count the blocks handed
+    // out per entry, minus the container's own header node, so the figure
+    // tracks the entries alone and TrimToSize sees it fall proportionally
+    // as entries are evicted.
+    return mapTx.get_allocator().total_allocated_bytes() - mapTx.get_allocator().block_bytes() + memusage::DynamicUsage(mapNextTx) + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(vTxHashes) + m_lookup_usage.load(std::memory_order_relaxed) + cachedInnerUsage;
 }
 
 void CTxMemPool::RemoveUnbroadcastTx(const uint256& txid, const bool unchecked) {
@@ -1043,6 +1176,11 @@ void CTxMemPool::TrimToSize(size_t sizelimit, std::vector<COutPoint>* pvNoSpends
     unsigned nTxnRemoved = 0;
     CFeeRate maxFeeRateRemoved(0);
     while (!mapTx.empty() && DynamicMemoryUsage() > sizelimit) {
+        // One package per iteration: removing a package changes the
+        // descendant state (and thus the descendant-score order) of the
+        // entries it leaves behind, so the worst package must be re-read
+        // from the index after every removal. Selecting a whole batch from
+        // a frozen view of the index picks stale victims and over-evicts.
         indexed_transaction_set::index<descendant_score>::type::iterator it = mapTx.get<descendant_score>().begin();
 
         // We set the new mempool min fee to the feerate of the removed set, plus the
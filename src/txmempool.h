@@ -6,11 +6,13 @@
 #ifndef BITCOIN_TXMEMPOOL_H
 #define BITCOIN_TXMEMPOOL_H
 
+#include <array>
 #include <atomic>
 #include <map>
 #include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -20,6 +22,7 @@
 #include <policy/feerate.h>
 #include <primitives/transaction.h>
 #include <random.h>
+#include <support/allocators/pool.h>
 #include <sync.h>
 #include <util/epochguard.h>
 #include <util/hasher.h>
@@ -30,6 +33,7 @@
 #include <boost/multi_index/sequenced_index.hpp>
 
 class CBlockIndex;
+struct PrecomputedTransactionData;
 class CChainState;
 extern RecursiveMutex cs_main;
 
@@ -92,7 +96,7 @@ private:
     mutable Children m_children;
     const CAmount nFee;             //!< Cached to avoid expensive parent-transaction lookups
     const size_t nTxWeight;         //!< ... and avoid recomputing tx weight (also used for GetTxSize())
-    const size_t nUsageSize;        //!< ... and total memory usage
+    size_t nUsageSize;              //!< ... and total memory usage (non-const: grows if validation artifacts are attached)
     const int64_t nTime;            //!< Local time when entering the mempool
     const unsigned int entryHeight; //!< Chain height when entering the mempool
     const bool spendsCoinbase;      //!< keep track of transactions that spend a coinbase
@@ -100,6 +104,11 @@ private:
     int64_t feeDelta;          //!< Used for determining the priority of the transaction for mining in a block
     LockPoints lockPoints;     //!< Track the height and time at which tx was final
 
+    //! Sighash midstates computed during mempool acceptance, for ConnectBlock to reuse.
+    std::shared_ptr<const PrecomputedTransactionData> m_precomputed_txdata;
+    //! Script verify flags the inputs were checked under during acceptance.
+    uint32_t m_validated_script_flags{0};
+
     // Information about descendants of this transaction that are in the
     // mempool; if we remove this transaction we must remove all of these
     // descendants as well.
@@ -141,6 +150,17 @@ public:
     // Update the LockPoints after a reorg
     void UpdateLockPoints(const LockPoints& lp);
 
+    /** Attach script-validation artifacts from mempool acceptance: the
+     * precomputed sighash data and the script verify flags the input scripts
+     * were checked under. Must be called before the entry is added to the
+     * pool, as it adjusts the entry's memory usage. */
+    void SetValidationArtifacts(std::shared_ptr<const PrecomputedTransactionData> txdata, uint32_t script_flags);
+    /** Precomputed transaction data from mempool acceptance, or nullptr if none was attached. */
+    std::shared_ptr<const PrecomputedTransactionData> GetPrecomputedTxData() const { return m_precomputed_txdata; }
+    /** Script verify flags the input scripts were checked under (only meaningful
+     * if GetPrecomputedTxData() is non-null). */
+    uint32_t GetValidatedScriptFlags() const { return m_validated_script_flags; }
+
     uint64_t GetCountWithDescendants() const { return nCountWithDescendants; }
     uint64_t GetSizeWithDescendants() const { return nSizeWithDescendants; }
     CAmount GetModFeesWithDescendants() const { return nModFeesWithDescendants; }
@@ -476,6 +496,23 @@ enum class MemPoolRemovalReason {
  */
 class CTxMemPool
 {
+public:
+    //! Inclusive lower bounds, in satoshis per virtual byte, of the feerate
+    //! histogram buckets. The first bucket also collects any transactions
+    //! below it; the last bucket is unbounded above.
+    static constexpr std::array<CAmount, 35> FEE_HISTOGRAM_BUCKET_BOUNDS{
+        0, 1, 2, 3, 4, 5, 6, 8, 10, 12, 15, 20, 25, 30, 40, 50, 60, 70, 80,
+        100, 125, 150, 175, 200, 250, 300, 400, 500, 600, 700, 800, 1000,
+        1200, 1500, 2000};
+
+    //! One bucket of the feerate histogram.
+    struct FeeHistogramBucket {
+        uint64_t count{0};  //!< number of transactions in the bucket
+        uint64_t vsize{0};  //!< sum of the transactions' virtual sizes
+        CAmount fees{0};    //!< sum of the transactions' modified fees
+    };
+    using FeeHistogram = std::array<FeeHistogramBucket, FEE_HISTOGRAM_BUCKET_BOUNDS.size()>;
+
 private:
     const int m_check_ratio; //!< Value n means that 1 times in n we check.
     std::atomic<unsigned int> nTransactionsUpdated{0}; //!< Used by getblocktemplate to trigger CreateNewBlock() invocation
@@ -497,6 +534,18 @@ private:
 
     void trackPackageRemoved(const CFeeRate& rate) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
+    //! Per-bucket totals over the modified feerates of all mempool
+    //! transactions; kept in sync by addUnchecked(), removeUnchecked() and
+    //! PrioritiseTransaction().
+    FeeHistogram m_fee_histogram GUARDED_BY(cs){};
+
+    //! Bucket of the feerate histogram covering the given modified fee and vsize.
+    static size_t FeeHistogramBucketIndex(CAmount modified_fee, size_t vsize);
+
+    //! Add (sign == 1) or subtract (sign == -1) a transaction's contribution
+    //! to the feerate histogram.
+    void UpdateFeeHistogram(const CTxMemPoolEntry& entry, int sign) EXCLUSIVE_LOCKS_REQUIRED(cs);
+
     bool m_is_loaded GUARDED_BY(cs){false};
 
 public:
@@ -532,7 +581,12 @@ public:
                 boost::multi_index::identity<CTxMemPoolEntry>,
                 CompareTxMemPoolEntryByAncestorFee
             >
-        >
+        >,
+        // The nodes of all five indexes live in one entry, allocated out of
+        // contiguous pool chunks: this avoids a heap allocation (and its
+        // overhead) per transaction and keeps entries added together adjacent
+        // in memory for the bulk walks in block assembly and eviction.
+        pool_allocator<CTxMemPoolEntry>
     > indexed_transaction_set;
 
     /**
@@ -568,6 +622,36 @@ public:
     using txiter = indexed_transaction_set::nth_index<0>::type::const_iterator;
     std::vector<std::pair<uint256, txiter>> vTxHashes GUARDED_BY(cs); //!< All tx witness hashes/entries in mapTx, in random order
 
+    /**
+     * Read-mostly mirrors of the txid->tx and wtxid->tx mappings in mapTx, so
+     * that existence and transaction lookups (net relay's AlreadyHaveTx,
+     * RPC readers) don't contend on `cs` with long-running writers. They are
+     * kept in sync by addUnchecked()/removeUnchecked()/_clear() while `cs` is
+     * held; m_lookup_mutex is only ever held for O(1) operations, so readers
+     * never block behind mempool mutations. Lock order: `cs` before
+     * m_lookup_mutex.
+     */
+    mutable Mutex m_lookup_mutex;
+    std::unordered_map<uint256, CTransactionRef, SaltedTxidHasher> m_lookup_txid GUARDED_BY(m_lookup_mutex);
+    std::unordered_map<uint256, CTransactionRef, SaltedTxidHasher> m_lookup_wtxid GUARDED_BY(m_lookup_mutex);
+    /**
+     * Memory usage of the two lookup maps, recomputed (an O(1) formula) by
+     * the mutation sites above while m_lookup_mutex is held. Kept separately
+     * so DynamicMemoryUsage(), which runs on every TrimToSize check during
+     * transaction acceptance, does not take the lookup lock just to read map
+     * sizes.
+     */
+    mutable std::atomic<uint64_t> m_lookup_usage{0};
+    void UpdateLookupUsage() EXCLUSIVE_LOCKS_REQUIRED(m_lookup_mutex)
+    {
+        // Per-node only: the bucket arrays are overhead that eviction cannot
+        // free, and counting them would make TrimToSize chase bytes that no
+        // amount of entry removal gives back.
+        using LookupNode = memusage::unordered_node<std::pair<const uint256, CTransactionRef>>;
+        m_lookup_usage.store(memusage::MallocUsage(sizeof(LookupNode)) * (m_lookup_txid.size() + m_lookup_wtxid.size()),
+                             std::memory_order_relaxed);
+    }
+
     typedef std::set<txiter, CompareIteratorByHash> setEntries;
 
     uint64_t CalculateDescendantMaximum(txiter entry) const EXCLUSIVE_LOCKS_REQUIRED(cs);
@@ -587,7 +671,7 @@ private:
 
 public:
     indirectmap<COutPoint, const CTransaction*> mapNextTx GUARDED_BY(cs);
-    std::map<uint256, CAmount> mapDeltas;
+    std::unordered_map<uint256, CAmount, SaltedTxidHasher> mapDeltas;
 
     /** Create a new CTxMemPool.
      * Sanity checks will be off by default for performance, because otherwise
@@ -626,6 +710,9 @@ public:
     void _clear() EXCLUSIVE_LOCKS_REQUIRED(cs); //lock free
     bool CompareDepthAndScore(const uint256& hasha, const uint256& hashb, bool wtxid=false);
     void queryHashes(std::vector<uint256>& vtxid) const;
+    /** Txid/wtxid pairs for all mempool entries, in the same depth-and-score
+     *  order as queryHashes(). */
+    std::vector<std::pair<uint256, uint256>> GetRelayOrderedHashes() const;
     bool isSpent(const COutPoint& outpoint) const;
     unsigned int GetTransactionsUpdated() const;
     void AddTransactionsUpdated(unsigned int n);
@@ -733,13 +820,22 @@ public:
         return m_total_fee;
     }
 
-    bool exists(const GenTxid& gtxid) const
+    //! Snapshot of the feerate histogram. Bucket i covers transactions whose
+    //! modified feerate, in satoshis per virtual byte, is at least
+    //! FEE_HISTOGRAM_BUCKET_BOUNDS[i] and below the next bound.
+    FeeHistogram GetFeeHistogram() const
     {
         LOCK(cs);
+        return m_fee_histogram;
+    }
+
+    bool exists(const GenTxid& gtxid) const
+    {
+        LOCK(m_lookup_mutex);
         if (gtxid.IsWtxid()) {
-            return (mapTx.get<index_by_wtxid>().count(gtxid.GetHash()) != 0);
+            return (m_lookup_wtxid.count(gtxid.GetHash()) != 0);
         }
-        return (mapTx.count(gtxid.GetHash()) != 0);
+        return (m_lookup_txid.count(gtxid.GetHash()) != 0);
     }
     bool exists(const uint256& txid) const { return exists(GenTxid{false, txid}); }
 
@@ -5,6 +5,7 @@
 #include <txorphanage.h>
 
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <logging.h>
 #include <policy/policy.h>
 
@@ -39,47 +40,40 @@ bool TxOrphanage::AddTx(const CTransactionRef& tx, NodeId peer)
         return false;
     }
 
-    auto ret = m_orphans.emplace(hash, OrphanTx{tx, peer, GetTime() + ORPHAN_TX_EXPIRE_TIME, m_orphan_list.size()});
+    auto ret = m_orphans.emplace(hash, OrphanTx{tx, peer, GetTime() + ORPHAN_TX_EXPIRE_TIME, {}});
     assert(ret.second);
-    m_orphan_list.push_back(ret.first);
+    ret.first->second.insertion_pos = m_insertion_order.insert(m_insertion_order.end(), hash);
     // Allow for lookups in the orphan pool by wtxid, as well as txid
-    m_wtxid_to_orphan_it.emplace(tx->GetWitnessHash(), ret.first);
+    m_wtxid_to_txid.emplace(tx->GetWitnessHash(), hash);
     for (const CTxIn& txin : tx->vin) {
-        m_outpoint_to_orphan_it[txin.prevout].insert(ret.first);
+        m_outpoint_to_orphans[txin.prevout].insert(hash);
     }
+    m_total_orphan_usage += RecursiveDynamicUsage(tx);
 
-    LogPrint(BCLog::MEMPOOL, "stored orphan tx %s (mapsz %u outsz %u)\n", hash.ToString(),
-             m_orphans.size(), m_outpoint_to_orphan_it.size());
+    LogPrint(BCLog::MEMPOOL, "stored orphan tx %s (mapsz %u outsz %u usage %u)\n", hash.ToString(),
+             m_orphans.size(), m_outpoint_to_orphans.size(), m_total_orphan_usage);
     return true;
 }
 
 int TxOrphanage::EraseTx(const uint256& txid)
 {
     AssertLockHeld(g_cs_orphans);
-    std::map<uint256, OrphanTx>::iterator it = m_orphans.find(txid);
+    auto it = m_orphans.find(txid);
     if (it == m_orphans.end())
         return 0;
     for (const CTxIn& txin : it->second.tx->vin)
     {
-        auto itPrev = m_outpoint_to_orphan_it.find(txin.prevout);
-        if (itPrev == m_outpoint_to_orphan_it.end())
+        auto itPrev = m_outpoint_to_orphans.find(txin.prevout);
+        if (itPrev == m_outpoint_to_orphans.end())
             continue;
-        itPrev->second.erase(it);
+        itPrev->second.erase(txid);
         if (itPrev->second.empty())
-            m_outpoint_to_orphan_it.erase(itPrev);
+            m_outpoint_to_orphans.erase(itPrev);
     }
 
-    size_t old_pos = it->second.list_pos;
-    assert(m_orphan_list[old_pos] == it);
-    if (old_pos + 1 != m_orphan_list.size()) {
-        // Unless we're deleting the last entry in m_orphan_list, move the last
-        // entry to the position we're deleting.
-        auto it_last = m_orphan_list.back();
-        m_orphan_list[old_pos] = it_last;
-        it_last->second.list_pos = old_pos;
-    }
-    m_orphan_list.pop_back();
-    m_wtxid_to_orphan_it.erase(it->second.tx->GetWitnessHash());
+    m_insertion_order.erase(it->second.insertion_pos);
+    m_wtxid_to_txid.erase(it->second.tx->GetWitnessHash());
+    m_total_orphan_usage -= RecursiveDynamicUsage(it->second.tx);
 
     m_orphans.erase(it);
     return 1;
@@ -90,10 +84,10 @@ void TxOrphanage::EraseForPeer(NodeId peer)
     AssertLockHeld(g_cs_orphans);
 
     int nErased = 0;
-    std::map<uint256, OrphanTx>::iterator iter = m_orphans.begin();
+    OrphanMap::iterator iter = m_orphans.begin();
     while (iter != m_orphans.end())
     {
-        std::map<uint256, OrphanTx>::iterator maybeErase = iter++; // increment to avoid iterator becoming invalid
+        OrphanMap::iterator maybeErase = iter++; // increment to avoid iterator becoming invalid
         if (maybeErase->second.fromPeer == peer)
         {
             nErased += EraseTx(maybeErase->second.tx->GetHash());
@@ -113,10 +107,10 @@ unsigned int TxOrphanage::LimitOrphans(unsigned int max_orphans)
         // Sweep out expired orphan pool entries:
         int nErased = 0;
         int64_t nMinExpTime = nNow + ORPHAN_TX_EXPIRE_TIME - ORPHAN_TX_EXPIRE_INTERVAL;
-        std::map<uint256, OrphanTx>::iterator iter = m_orphans.begin();
+        OrphanMap::iterator iter = m_orphans.begin();
         while (iter != m_orphans.end())
         {
-            std::map<uint256, OrphanTx>::iterator maybeErase = iter++;
+            OrphanMap::iterator maybeErase = iter++;
             if (maybeErase->second.nTimeExpire <= nNow) {
                 nErased += EraseTx(maybeErase->second.tx->GetHash());
             } else {
@@ -127,13 +121,10 @@ unsigned int TxOrphanage::LimitOrphans(unsigned int max_orphans)
         nNextSweep = nMinExpTime + ORPHAN_TX_EXPIRE_INTERVAL;
         if (nErased > 0) LogPrint(BCLog::MEMPOOL, "Erased %d orphan tx due to expiration\n", nErased);
     }
-    FastRandomContext rng;
     while (m_orphans.size() > max_orphans)
     {
-        // Evict a random orphan:
-        size_t randompos = rng.randrange(m_orphan_list.size());
-        EraseTx(m_orphan_list[randompos]->first);
-        ++nEvicted;
+        // Evict the oldest orphan:
+        nEvicted += EraseTx(m_insertion_order.front());
     }
     return nEvicted;
 }
@@ -142,10 +133,10 @@ void TxOrphanage::AddChildrenToWorkSet(const CTransaction& tx, std::set<uint256>
 {
     AssertLockHeld(g_cs_orphans);
     for (unsigned int i = 0; i < tx.vout.size(); i++) {
-        const auto it_by_prev = m_outpoint_to_orphan_it.find(COutPoint(tx.GetHash(), i));
-        if (it_by_prev != m_outpoint_to_orphan_it.end()) {
-            for (const auto& elem : it_by_prev->second) {
-                orphan_work_set.insert(elem->first);
+        const auto it_by_prev = m_outpoint_to_orphans.find(COutPoint(tx.GetHash(), i));
+        if (it_by_prev != m_outpoint_to_orphans.end()) {
+            for (const uint256& orphan_txid : it_by_prev->second) {
+                orphan_work_set.insert(orphan_txid);
             }
         }
     }
@@ -155,7 +146,7 @@ bool TxOrphanage::HaveTx(const GenTxid& gtxid) const
 {
     LOCK(g_cs_orphans);
     if (gtxid.IsWtxid()) {
-        return m_wtxid_to_orphan_it.count(gtxid.GetHash());
+        return m_wtxid_to_txid.count(gtxid.GetHash());
     } else {
         return m_orphans.count(gtxid.GetHash());
     }
@@ -181,12 +172,10 @@ void TxOrphanage::EraseForBlock(const CBlock& block)
 
         // Which orphan pool entries must we evict?
         for (const auto& txin : tx.vin) {
-            auto itByPrev = m_outpoint_to_orphan_it.find(txin.prevout);
-            if (itByPrev == m_outpoint_to_orphan_it.end()) continue;
-            for (auto mi = itByPrev->second.begin(); mi != itByPrev->second.end(); ++mi) {
-                const CTransaction& orphanTx = *(*mi)->second.tx;
-                const uint256& orphanHash = orphanTx.GetHash();
-                vOrphanErase.push_back(orphanHash);
+            auto itByPrev = m_outpoint_to_orphans.find(txin.prevout);
+            if (itByPrev == m_outpoint_to_orphans.end()) continue;
+            for (const uint256& orphan_txid : itByPrev->second) {
+                vOrphanErase.push_back(orphan_txid);
             }
         }
     }
@@ -8,7 +8,13 @@
 #include <net.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
+#include <support/allocators/pool.h>
 #include <sync.h>
+#include <util/hasher.h>
+
+#include <list>
+#include <set>
+#include <unordered_map>
 
 /** Guards orphan transactions and extra txs for compact blocks */
 extern RecursiveMutex g_cs_orphans;
@@ -47,39 +53,45 @@ public:
      * (ie orphans that may have found their final missing parent, and so should be reconsidered for the mempool) */
     void AddChildrenToWorkSet(const CTransaction& tx, std::set<uint256>& orphan_work_set) const EXCLUSIVE_LOCKS_REQUIRED(g_cs_orphans);
 
+    /** Total dynamic memory used by the orphan transactions in the pool */
+    size_t TotalOrphanUsage() const EXCLUSIVE_LOCKS_REQUIRED(!g_cs_orphans)
+    {
+        LOCK(g_cs_orphans);
+        return m_total_orphan_usage;
+    }
+
 protected:
     struct OrphanTx {
         CTransactionRef tx;
         NodeId fromPeer;
         int64_t nTimeExpire;
-        size_t list_pos;
+        //! Position in m_insertion_order; the front of that list is the
+        //! eviction candidate.
+        std::list<uint256>::iterator insertion_pos;
     };
 
-    /** Map from txid to orphan transaction record. Limited by
+    /** Map from txid to orphan transaction record, with the nodes carved out
+     *  of pooled arena chunks rather than allocated individually. Limited by
      *  -maxorphantx/DEFAULT_MAX_ORPHAN_TRANSACTIONS */
-    std::map<uint256, OrphanTx> m_orphans GUARDED_BY(g_cs_orphans);
+    std::unordered_map<uint256, OrphanTx, SaltedTxidHasher, std::equal_to<uint256>,
+                       pool_allocator<std::pair<const uint256, OrphanTx>>> m_orphans GUARDED_BY(g_cs_orphans);
 
     using OrphanMap = decltype(m_orphans);
 
-    struct IteratorComparator
-    {
-        template<typename I>
-        bool operator()(const I& a, const I& b) const
-        {
-            return &(*a) < &(*b);
-        }
-    };
-
-    /** Index from the parents' COutPoint into the m_orphans. Used
-     *  to remove orphan transactions from the m_orphans */
-    std::map<COutPoint, std::set<OrphanMap::iterator, IteratorComparator>> m_outpoint_to_orphan_it GUARDED_BY(g_cs_orphans);
+    /** Index from the parents' COutPoint into m_orphans. Answers "which
+     *  orphans does this transaction unblock" in constant time per outpoint,
+     *  and is used to erase orphans by spent outpoint. */
+    std::unordered_map<COutPoint, std::set<uint256>, SaltedOutpointHasher> m_outpoint_to_orphans GUARDED_BY(g_cs_orphans);
 
-    /** Orphan transactions in vector for quick random eviction */
-    std::vector<OrphanMap::iterator> m_orphan_list GUARDED_BY(g_cs_orphans);
+    /** Orphan txids in insertion order, oldest first, for O(1) eviction */
+    std::list<uint256> m_insertion_order GUARDED_BY(g_cs_orphans);
 
     /** Index from wtxid into the m_orphans to lookup orphan
      *  transactions using their witness ids. */
-    std::map<uint256, OrphanMap::iterator> m_wtxid_to_orphan_it GUARDED_BY(g_cs_orphans);
+    std::unordered_map<uint256, uint256, SaltedTxidHasher> m_wtxid_to_txid GUARDED_BY(g_cs_orphans);
+
+    /** Sum of the orphan transactions' dynamic memory usage */
+    size_t m_total_orphan_usage GUARDED_BY(g_cs_orphans){0};
 };
 
 #endif // BITCOIN_TXORPHANAGE_H
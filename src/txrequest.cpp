@@ -4,6 +4,8 @@
 
 #include <txrequest.h>
 
+#include <util/trace.h>
+
 #include <crypto/siphash.h>
 #include <net.h>
 #include <primitives/transaction.h>
@@ -59,6 +61,8 @@ struct Announcement {
     const uint256 m_txhash;
     /** For CANDIDATE_{DELAYED,BEST,READY} the reqtime; for REQUESTED the expiry. */
     std::chrono::microseconds m_time;
+    /** For REQUESTED announcements, when the request was sent (used for latency accounting); zero otherwise. */
+    std::chrono::microseconds m_req_time{0};
     /** What peer the request was from. */
     const NodeId m_peer;
     /** What sequence number this announcement has. */
@@ -320,6 +324,16 @@ class TxRequestTracker::Impl {
     //! Map with this tracker's per-peer statistics.
     std::unordered_map<NodeId, PeerInfo> m_peerinfo;
 
+    /** Cumulative response counters per peer. Kept outside m_peerinfo because that map is
+     *  erased whenever a peer's announcement count drops to zero, while these survive until
+     *  the peer disconnects. */
+    struct ResponseStats {
+        uint64_t m_responses{0};
+        std::chrono::microseconds m_latency_total{0};
+        std::chrono::microseconds m_latency_max{0};
+    };
+    std::unordered_map<NodeId, ResponseStats> m_response_stats;
+
 public:
     void SanityCheck() const
     {
@@ -501,6 +515,7 @@ private:
                 PromoteCandidateReady(m_index.project<ByTxHash>(it));
             } else if (it->GetState() == State::REQUESTED && it->m_time <= now) {
                 if (expired) expired->emplace_back(it->m_peer, ToGenTxid(*it));
+                TRACE2(txrequest, expired, it->m_peer, it->m_txhash.begin());
                 MakeCompleted(m_index.project<ByTxHash>(it));
             } else {
                 break;
@@ -536,6 +551,7 @@ public:
 
     void DisconnectedPeer(NodeId peer)
     {
+        m_response_stats.erase(peer);
         auto& index = m_index.get<ByPeer>();
         auto it = index.lower_bound(ByPeerView{peer, false, uint256::ZERO});
         while (it != index.end() && it->m_peer == peer) {
@@ -590,6 +606,7 @@ public:
         // Update accounting metadata.
         ++m_peerinfo[peer].m_total;
         ++m_current_sequence;
+        TRACE4(txrequest, announcement_added, peer, gtxid.GetHash().begin(), gtxid.IsWtxid(), preferred);
     }
 
     //! Find the GenTxids to request now from peer.
@@ -622,7 +639,7 @@ public:
         return ret;
     }
 
-    void RequestedTx(NodeId peer, const uint256& txhash, std::chrono::microseconds expiry)
+    void RequestedTx(NodeId peer, const uint256& txhash, std::chrono::microseconds expiry, std::chrono::microseconds now)
     {
         auto it = m_index.get<ByPeer>().find(ByPeerView{peer, true, txhash});
         if (it == m_index.get<ByPeer>().end()) {
@@ -661,20 +678,33 @@ public:
             }
         }
 
-        Modify<ByPeer>(it, [expiry](Announcement& ann) {
+        Modify<ByPeer>(it, [expiry, now](Announcement& ann) {
             ann.SetState(State::REQUESTED);
             ann.m_time = expiry;
+            ann.m_req_time = now;
         });
+        TRACE3(txrequest, requested, peer, txhash.begin(), it->m_is_wtxid);
     }
 
-    void ReceivedResponse(NodeId peer, const uint256& txhash)
+    void ReceivedResponse(NodeId peer, const uint256& txhash, std::chrono::microseconds now)
     {
         // We need to search the ByPeer index for both (peer, false, txhash) and (peer, true, txhash).
         auto it = m_index.get<ByPeer>().find(ByPeerView{peer, false, txhash});
         if (it == m_index.get<ByPeer>().end()) {
             it = m_index.get<ByPeer>().find(ByPeerView{peer, true, txhash});
         }
-        if (it != m_index.get<ByPeer>().end()) MakeCompleted(m_index.project<ByTxHash>(it));
+        if (it != m_index.get<ByPeer>().end()) {
+            if (it->GetState() == State::REQUESTED && now.count() > 0 && it->m_req_time.count() > 0) {
+                // This is the response to an outstanding request: account its latency.
+                const auto latency = now - it->m_req_time;
+                ResponseStats& stats = m_response_stats[peer];
+                ++stats.m_responses;
+                stats.m_latency_total += latency;
+                stats.m_latency_max = std::max(stats.m_latency_max, latency);
+                TRACE3(txrequest, completed, peer, txhash.begin(), (uint64_t)latency.count());
+            }
+            MakeCompleted(m_index.project<ByTxHash>(it));
+        }
     }
 
     size_t CountInFlight(NodeId peer) const
@@ -698,6 +728,20 @@ public:
         return 0;
     }
 
+    TxRequestTracker::PeerStats GetPeerStats(NodeId peer) const
+    {
+        TxRequestTracker::PeerStats stats;
+        stats.m_candidates = CountCandidates(peer);
+        stats.m_in_flight = CountInFlight(peer);
+        auto it = m_response_stats.find(peer);
+        if (it != m_response_stats.end()) {
+            stats.m_responses = it->second.m_responses;
+            stats.m_latency_total = it->second.m_latency_total;
+            stats.m_latency_max = it->second.m_latency_max;
+        }
+        return stats;
+    }
+
     //! Count how many announcements are being tracked in total across all peers and transactions.
     size_t Size() const { return m_index.size(); }
 
@@ -733,14 +777,19 @@ void TxRequestTracker::ReceivedInv(NodeId peer, const GenTxid& gtxid, bool prefe
     m_impl->ReceivedInv(peer, gtxid, preferred, reqtime);
 }
 
-void TxRequestTracker::RequestedTx(NodeId peer, const uint256& txhash, std::chrono::microseconds expiry)
+void TxRequestTracker::RequestedTx(NodeId peer, const uint256& txhash, std::chrono::microseconds expiry, std::chrono::microseconds now)
+{
+    m_impl->RequestedTx(peer, txhash, expiry, now);
+}
+
+void TxRequestTracker::ReceivedResponse(NodeId peer, const uint256& txhash, std::chrono::microseconds now)
 {
-    m_impl->RequestedTx(peer, txhash, expiry);
+    m_impl->ReceivedResponse(peer, txhash, now);
 }
 
-void TxRequestTracker::ReceivedResponse(NodeId peer, const uint256& txhash)
+TxRequestTracker::PeerStats TxRequestTracker::GetPeerStats(NodeId peer) const
 {
-    m_impl->ReceivedResponse(peer, txhash);
+    return m_impl->GetPeerStats(peer);
 }
 
 std::vector<GenTxid> TxRequestTracker::GetRequestable(NodeId peer, std::chrono::microseconds now,
@@ -171,7 +171,7 @@ public:
      *    was made (GetRequestable will never advise doing so). In this case it is converted to COMPLETED, as we're
      *    no longer waiting for a response to it.
      */
-    void RequestedTx(NodeId peer, const uint256& txhash, std::chrono::microseconds expiry);
+    void RequestedTx(NodeId peer, const uint256& txhash, std::chrono::microseconds expiry, std::chrono::microseconds now = std::chrono::microseconds{0});
 
     /** Converts a CANDIDATE or REQUESTED announcement to a COMPLETED one. If no such announcement exists for the
      *  provided peer and txhash, nothing happens.
@@ -179,10 +179,28 @@ public:
      * It should be called whenever a transaction or NOTFOUND was received from a peer. When the transaction is
      * not needed entirely anymore, ForgetTxhash should be called instead of, or in addition to, this call.
      */
-    void ReceivedResponse(NodeId peer, const uint256& txhash);
+    void ReceivedResponse(NodeId peer, const uint256& txhash, std::chrono::microseconds now = std::chrono::microseconds{0});
 
     // The operations below inspect the data structure.
 
+    /** Per-peer request statistics, cumulative since the peer connected. */
+    struct PeerStats {
+        //! Number of CANDIDATE announcements currently tracked.
+        size_t m_candidates{0};
+        //! Number of REQUESTED announcements currently tracked.
+        size_t m_in_flight{0};
+        //! Number of requests this peer responded to (tx or notfound).
+        uint64_t m_responses{0};
+        //! Sum of request-to-response latencies over all counted responses.
+        std::chrono::microseconds m_latency_total{0};
+        //! Largest single request-to-response latency observed.
+        std::chrono::microseconds m_latency_max{0};
+    };
+
+    /** Get the request statistics for a peer. Latencies are only accumulated
+     *  for ReceivedResponse calls that pass a nonzero now. */
+    PeerStats GetPeerStats(NodeId peer) const;
+
     /** Count how many REQUESTED announcements a peer has. */
     size_t CountInFlight(NodeId peer) const;
 
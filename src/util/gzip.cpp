@@ -0,0 +1,287 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/gzip.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace {
+
+//! Sliding window size fixed by the DEFLATE format.
+constexpr size_t WINDOW_SIZE{32768};
+//! Longest match the format can encode.
+constexpr size_t MAX_MATCH{258};
+constexpr size_t MIN_MATCH{3};
+//! Hash-chain positions examined per match attempt.
+constexpr int MAX_CHAIN_LENGTH{48};
+//! Staging-buffer size that triggers a sink flush.
+constexpr size_t OUT_CHUNK_SIZE{65536};
+
+//! Standard (reflected, polynomial 0xedb88320) CRC-32 as required by the
+//! gzip trailer. Note this is not the Castagnoli variant used elsewhere in
+//! the codebase.
+uint32_t CRC32Update(uint32_t crc, const unsigned char* data, size_t size)
+{
+    static const uint32_t* table = [] {
+        static uint32_t t[256];
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+//! Reverse the low count bits of code. Huffman codes are packed into the
+//! bitstream most-significant-bit first, while everything else is packed
+//! least-significant-bit first.
+uint32_t ReverseBits(uint32_t code, int count)
+{
+    uint32_t out = 0;
+    for (int i = 0; i < count; ++i) {
+        out = (out << 1) | ((code >> i) & 1);
+    }
+    return out;
+}
+
+//! Length symbol table (RFC 1951, 3.2.5): base length and extra bits for
+//! symbols 257..285.
+struct LengthCode { uint16_t base; uint8_t extra; };
+const LengthCode LENGTH_CODES[29] = {
+    {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0}, {8, 0}, {9, 0}, {10, 0},
+    {11, 1}, {13, 1}, {15, 1}, {17, 1}, {19, 2}, {23, 2}, {27, 2}, {31, 2},
+    {35, 3}, {43, 3}, {51, 3}, {59, 3}, {67, 4}, {83, 4}, {99, 4}, {115, 4},
+    {131, 5}, {163, 5}, {195, 5}, {227, 5}, {258, 0},
+};
+
+//! Distance symbol table: base distance and extra bits for symbols 0..29.
+struct DistCode { uint32_t base; uint8_t extra; };
+const DistCode DIST_CODES[30] = {
+    {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 1}, {7, 1}, {9, 2}, {13, 2},
+    {17, 3}, {25, 3}, {33, 4}, {49, 4}, {65, 5}, {97, 5}, {129, 6}, {193, 6},
+    {257, 7}, {385, 7}, {513, 8}, {769, 8}, {1025, 9}, {1537, 9},
+    {2049, 10}, {3073, 10}, {4097, 11}, {6145, 11}, {8193, 12}, {12289, 12},
+    {16385, 13}, {24577, 13},
+};
+
+int LengthSymbol(size_t length)
+{
+    // 29 entries: linear scan from the back is fine for our rates, but a
+    // precomputed direct-lookup table keeps this off the profile entirely.
+    static const uint8_t* lut = [] {
+        static uint8_t t[MAX_MATCH + 1];
+        for (int sym = 0; sym < 29; ++sym) {
+            const size_t hi = (sym == 28) ? MAX_MATCH : LENGTH_CODES[sym + 1].base - 1;
+            for (size_t len = LENGTH_CODES[sym].base; len <= hi; ++len) t[len] = sym;
+        }
+        // Length 258 has a dedicated zero-extra-bits symbol.
+        t[MAX_MATCH] = 28;
+        return t;
+    }();
+    assert(length >= MIN_MATCH && length <= MAX_MATCH);
+    return lut[length];
+}
+
+int DistSymbol(size_t distance)
+{
+    assert(distance >= 1 && distance <= WINDOW_SIZE);
+    int sym = 29;
+    while (DIST_CODES[sym].base > distance) --sym;
+    return sym;
+}
+
+uint32_t Hash3(const unsigned char* p)
+{
+    const uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16);
+    return (v * 0x9e3779b1) >> 17; // 15-bit hash
+}
+
+} // namespace
+
+GZipEncoder::GZipEncoder(Sink sink) : m_sink(std::move(sink))
+{
+    m_out.reserve(OUT_CHUNK_SIZE + 1024);
+    // gzip member header: magic, deflate, no flags, no mtime, unknown OS
+    static const unsigned char header[10] = {0x1f, 0x8b, 0x08, 0, 0, 0, 0, 0, 0, 0xff};
+    m_out.insert(m_out.end(), header, header + sizeof(header));
+    // One fixed-Huffman block (BFINAL=0, BTYPE=01) carries the entire
+    // payload; Finish() closes it and appends an empty final block.
+    WriteBits(0, 1);
+    WriteBits(1, 2);
+}
+
+void GZipEncoder::WriteBits(uint32_t bits, int count)
+{
+    m_bitbuf |= (uint64_t)bits << m_bitcount;
+    m_bitcount += count;
+    while (m_bitcount >= 8) {
+        m_out.push_back(m_bitbuf & 0xff);
+        m_bitbuf >>= 8;
+        m_bitcount -= 8;
+    }
+}
+
+void GZipEncoder::WriteHuffman(uint32_t code, int count)
+{
+    WriteBits(ReverseBits(code, count), count);
+}
+
+void GZipEncoder::EmitLiteral(unsigned char byte)
+{
+    // Fixed literal/length code (RFC 1951, 3.2.6)
+    if (byte < 144) {
+        WriteHuffman(0x30 + byte, 8);
+    } else {
+        WriteHuffman(0x190 + byte - 144, 9);
+    }
+}
+
+void GZipEncoder::EmitMatch(size_t length, size_t distance)
+{
+    const int lsym = LengthSymbol(length);
+    const int sym = 257 + lsym;
+    if (sym < 280) {
+        WriteHuffman(sym - 256, 7);
+    } else {
+        WriteHuffman(0xc0 + sym - 280, 8);
+    }
+    if (LENGTH_CODES[lsym].extra) {
+        WriteBits(length - LENGTH_CODES[lsym].base, LENGTH_CODES[lsym].extra);
+    }
+
+    const int dsym = DistSymbol(distance);
+    WriteHuffman(dsym, 5);
+    if (DIST_CODES[dsym].extra) {
+        WriteBits(distance - DIST_CODES[dsym].base, DIST_CODES[dsym].extra);
+    }
+}
+
+void GZipEncoder::MaybeFlushOut()
+{
+    if (m_out.size() >= OUT_CHUNK_SIZE) {
+        m_sink(m_out.data(), m_out.size());
+        m_out.clear();
+    }
+}
+
+void GZipEncoder::CompressPending()
+{
+    const unsigned char* buf = m_buf.data();
+    const size_t size = m_buf.size();
+
+    // Hash chains over the whole retained buffer (history plus new chunk).
+    // Rebuilt per chunk; chunks are large enough that this is noise.
+    std::vector<int32_t> head(1 << 15, -1);
+    std::vector<int32_t> prev(size, -1);
+    for (size_t i = 0; i + MIN_MATCH <= size && i < m_history; ++i) {
+        const uint32_t h = Hash3(buf + i);
+        prev[i] = head[h];
+        head[h] = i;
+    }
+
+    size_t pos = m_history;
+    while (pos < size) {
+        size_t best_len = 0;
+        size_t best_dist = 0;
+        if (pos + MIN_MATCH <= size) {
+            const size_t max_len = std::min(MAX_MATCH, size - pos);
+            const uint32_t h = Hash3(buf + pos);
+            int32_t cand = head[h];
+            int chain = MAX_CHAIN_LENGTH;
+            while (cand >= 0 && chain-- > 0) {
+                const size_t dist = pos - cand;
+                if (dist > WINDOW_SIZE) break;
+                if (buf[cand + best_len] == buf[pos + best_len]) {
+                    size_t len = 0;
+                    while (len < max_len && buf[cand + len] == buf[pos + len]) ++len;
+                    if (len > best_len) {
+                        best_len = len;
+                        best_dist = dist;
+                        if (len >= max_len) break;
+                    }
+                }
+                cand = prev[cand];
+            }
+            prev[pos] = head[h];
+            head[h] = pos;
+        }
+
+        if (best_len >= MIN_MATCH) {
+            EmitMatch(best_len, best_dist);
+            // Insert the skipped positions into the chains so later matches
+            // can point into this run.
+            for (size_t i = pos + 1; i < pos + best_len && i + MIN_MATCH <= size; ++i) {
+                const uint32_t h = Hash3(buf + i);
+                prev[i] = head[h];
+                head[h] = i;
+            }
+            pos += best_len;
+        } else {
+            EmitLiteral(buf[pos]);
+            ++pos;
+        }
+        MaybeFlushOut();
+    }
+
+    // Keep the last window of input as history for the next chunk.
+    if (size > WINDOW_SIZE) {
+        m_buf.erase(m_buf.begin(), m_buf.end() - WINDOW_SIZE);
+    }
+    m_history = m_buf.size();
+}
+
+void GZipEncoder::Write(Span<const unsigned char> data)
+{
+    assert(!m_finished);
+    if (data.empty()) return;
+    m_crc = CRC32Update(m_crc, data.data(), data.size());
+    m_total_in += data.size();
+    m_buf.insert(m_buf.end(), data.begin(), data.end());
+    // Compress once a decent chunk has accumulated, so tiny writes are
+    // batched but memory stays bounded.
+    if (m_buf.size() - m_history >= OUT_CHUNK_SIZE) {
+        CompressPending();
+    }
+}
+
+void GZipEncoder::Finish()
+{
+    assert(!m_finished);
+    m_finished = true;
+    CompressPending();
+    // Close the payload block, then an empty final block (BFINAL=1,
+    // BTYPE=01) so the stream terminates regardless of payload size.
+    WriteHuffman(0, 7); // end-of-block symbol 256
+    WriteBits(1, 1);
+    WriteBits(1, 2);
+    WriteHuffman(0, 7);
+    // Byte-align before the trailer
+    if (m_bitcount > 0) {
+        m_out.push_back(m_bitbuf & 0xff);
+        m_bitbuf = 0;
+        m_bitcount = 0;
+    }
+    const uint32_t crc = m_crc ^ 0xffffffff;
+    const uint32_t isize = (uint32_t)m_total_in;
+    for (int i = 0; i < 4; ++i) m_out.push_back((crc >> (8 * i)) & 0xff);
+    for (int i = 0; i < 4; ++i) m_out.push_back((isize >> (8 * i)) & 0xff);
+    m_sink(m_out.data(), m_out.size());
+    m_out.clear();
+}
+
+void GZipCompress(Span<const unsigned char> data, std::vector<unsigned char>& out)
+{
+    GZipEncoder enc{[&out](const unsigned char* p, size_t n) { out.insert(out.end(), p, p + n); }};
+    enc.Write(data);
+    enc.Finish();
+}
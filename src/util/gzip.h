@@ -0,0 +1,67 @@
+// Copyright (c) 2020 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_GZIP_H
+#define BITCOIN_UTIL_GZIP_H
+
+#include <span.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * Streaming gzip (RFC 1952) encoder producing DEFLATE (RFC 1951) output with
+ * fixed Huffman codes and an LZ77 matcher over the standard 32KiB window.
+ * Self-contained, so no external compression library is required; any
+ * standard gzip decoder can read the output. Intended for compressing large
+ * HTTP replies, where fixed codes on highly repetitive JSON already get most
+ * of the win of a full encoder.
+ *
+ * Compressed bytes are handed to the sink incrementally, so neither the full
+ * input nor the full output ever needs to sit in one buffer.
+ */
+class GZipEncoder
+{
+public:
+    using Sink = std::function<void(const unsigned char* data, size_t size)>;
+
+    explicit GZipEncoder(Sink sink);
+
+    /** Compress more input. May be called any number of times before Finish(). */
+    void Write(Span<const unsigned char> data);
+
+    /** Terminate the deflate stream and write the gzip trailer. Must be
+     * called exactly once; no Write() may follow. */
+    void Finish();
+
+private:
+    Sink m_sink;
+    //! Staging buffer handed to the sink whenever it grows past a chunk.
+    std::vector<unsigned char> m_out;
+    //! Retained input history plus the chunk being compressed. The last
+    //! window's worth carries over between Write() calls so back-references
+    //! can cross chunk boundaries.
+    std::vector<unsigned char> m_buf;
+    //! Number of leading bytes of m_buf that are already-compressed history.
+    size_t m_history{0};
+
+    uint32_t m_crc{0xffffffff};
+    uint64_t m_total_in{0};
+    uint64_t m_bitbuf{0};
+    int m_bitcount{0};
+    bool m_finished{false};
+
+    void WriteBits(uint32_t bits, int count);
+    void WriteHuffman(uint32_t code, int count);
+    void EmitLiteral(unsigned char byte);
+    void EmitMatch(size_t length, size_t distance);
+    void CompressPending();
+    void MaybeFlushOut();
+};
+
+/** Convenience wrapper: gzip data in one shot, appending to out. */
+void GZipCompress(Span<const unsigned char> data, std::vector<unsigned char>& out);
+
+#endif // BITCOIN_UTIL_GZIP_H
@@ -18,8 +18,15 @@ private:
 public:
     SaltedTxidHasher();
 
+    /**
+     * These salted hashers key in-process-only tables (the coins cache, the
+     * mempool lookup maps), whose contents never leave the process, so the
+     * reduced-round SipHash-1-3 variant is used: it keeps the keyed
+     * protection against collision flooding while spending roughly half the
+     * cycles of SipHash-2-4 on the single most-executed hash in the node.
+     */
     size_t operator()(const uint256& txid) const {
-        return SipHashUint256(k0, k1, txid);
+        return SipHash13Uint256(k0, k1, txid);
     }
 };
 
@@ -46,7 +53,7 @@ public:
      * @see https://gcc.gnu.org/onlinedocs/gcc-9.2.0/libstdc++/manual/manual/unordered_associative.html
      */
     size_t operator()(const COutPoint& id) const noexcept {
-        return SipHashUint256Extra(k0, k1, id.hash, id.n);
+        return SipHash13Uint256Extra(k0, k1, id.hash, id.n);
     }
 };
 
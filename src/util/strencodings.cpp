@@ -3,9 +3,14 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#if defined(HAVE_CONFIG_H)
+#include <config/bitcoin-config.h>
+#endif
+
 #include <util/strencodings.h>
 #include <util/string.h>
 
+#include <compat/cpuid.h>
 #include <tinyformat.h>
 
 #include <algorithm>
@@ -591,15 +596,74 @@ std::string Capitalize(std::string str)
     return str;
 }
 
-std::string HexStr(const Span<const uint8_t> s)
+#if defined(ENABLE_SSE41) && !defined(BUILD_BITCOIN_INTERNAL)
+namespace hex_sse41
+{
+void Encode(const unsigned char* in, size_t len, char* out);
+}
+#endif
+
+#if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
+namespace hex_avx2
+{
+void Encode(const unsigned char* in, size_t len, char* out);
+}
+#endif
+
+namespace {
+
+void HexEncodeScalar(const unsigned char* in, size_t len, char* out)
 {
-    std::string rv;
     static constexpr char hexmap[16] = { '0', '1', '2', '3', '4', '5', '6', '7',
                                          '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
-    rv.reserve(s.size() * 2);
-    for (uint8_t v: s) {
-        rv.push_back(hexmap[v >> 4]);
-        rv.push_back(hexmap[v & 15]);
+    for (size_t i = 0; i < len; ++i) {
+        out[2 * i] = hexmap[in[i] >> 4];
+        out[2 * i + 1] = hexmap[in[i] & 15];
     }
+}
+
+typedef void (*HexEncodeType)(const unsigned char* in, size_t len, char* out);
+
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+bool AVXEnabledForHex()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+#endif
+
+/** Pick the widest hex encoder the CPU supports. Run from a static
+ * initializer rather than an AutoDetect call from init, so that the tools
+ * that never run node init (bitcoin-cli, bitcoin-tx) dispatch too. */
+HexEncodeType HexEncodeAutoDetect()
+{
+#if defined(HAVE_GETCPUID) && !defined(BUILD_BITCOIN_INTERNAL) && (defined(ENABLE_SSE41) || defined(ENABLE_AVX2))
+    uint32_t eax, ebx, ecx, edx;
+#if defined(ENABLE_AVX2)
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    bool have_xsave = (ecx >> 27) & 1;
+    bool have_avx = (ecx >> 28) & 1;
+    if (have_xsave && have_avx && AVXEnabledForHex()) {
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        if ((ebx >> 5) & 1) return hex_avx2::Encode;
+    }
+#endif
+#if defined(ENABLE_SSE41)
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    if ((ecx >> 19) & 1) return hex_sse41::Encode;
+#endif
+#endif
+    return HexEncodeScalar;
+}
+
+const HexEncodeType g_hex_encode{HexEncodeAutoDetect()};
+
+} // namespace
+
+std::string HexStr(const Span<const uint8_t> s)
+{
+    std::string rv(s.size() * 2, '\0');
+    g_hex_encode(s.data(), s.size(), &rv[0]);
     return rv;
 }
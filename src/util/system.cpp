@@ -78,6 +78,8 @@ const char * const BITCOIN_SETTINGS_FILENAME = "settings.json";
 
 ArgsManager gArgs;
 
+std::atomic<uint32_t> ArgsManager::m_args_revision{0};
+
 /** Mutex to protect dir_locks. */
 static Mutex cs_dir_locks;
 /** A map that contains all the currently held directory locks. After
@@ -281,11 +283,13 @@ void ArgsManager::SelectConfigNetwork(const std::string& network)
 {
     LOCK(cs_args);
     m_network = network;
+    BumpRevision();
 }
 
 bool ArgsManager::ParseParameters(int argc, const char* const argv[], std::string& error)
 {
     LOCK(cs_args);
+    BumpRevision();
     m_settings.command_line_options.clear();
 
     for (int i = 1; i < argc; i++) {
@@ -458,6 +462,7 @@ bool ArgsManager::ReadSettingsFile(std::vector<std::string>* errors)
     }
 
     LOCK(cs_args);
+    BumpRevision();
     m_settings.rw_settings.clear();
     std::vector<std::string> read_errors;
     if (!util::ReadSettings(path, m_settings.rw_settings, read_errors)) {
@@ -538,6 +543,7 @@ void ArgsManager::ForceSetArg(const std::string& strArg, const std::string& strV
 {
     LOCK(cs_args);
     m_settings.forced_settings[SettingName(strArg)] = strValue;
+    BumpRevision();
 }
 
 void ArgsManager::AddCommand(const std::string& cmd, const std::string& help, const OptionsCategory& cat)
@@ -896,6 +902,7 @@ bool ArgsManager::ReadConfigFiles(std::string& error, bool ignore_invalid_keys)
 {
     {
         LOCK(cs_args);
+        BumpRevision();
         m_settings.ro_config.clear();
         m_config_sections.clear();
     }
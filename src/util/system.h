@@ -25,12 +25,15 @@
 #include <util/threadnames.h>
 #include <util/time.h>
 
+#include <atomic>
 #include <exception>
+#include <limits>
 #include <map>
 #include <optional>
 #include <set>
 #include <stdint.h>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -408,6 +411,7 @@ public:
     {
         LOCK(cs_args);
         fn(m_settings);
+        BumpRevision();
     }
 
     /**
@@ -416,16 +420,73 @@ public:
      */
     void LogArgs() const;
 
+    /**
+     * Revision counter for cached argument handles (see CachedArg).
+     * Incremented whenever argument values may have changed: parameter and
+     * config parsing, network selection, settings file reload, ForceSetArg.
+     */
+    static uint32_t Revision() { return m_args_revision.load(std::memory_order_acquire); }
+
 private:
     // Helper function for LogArgs().
     void logArgsPrefix(
         const std::string& prefix,
         const std::string& section,
         const std::map<std::string, std::vector<util::SettingsValue>>& args) const;
+
+    //! Invalidate every CachedArg. Called by the mutating member functions.
+    static void BumpRevision() { m_args_revision.fetch_add(1, std::memory_order_release); }
+
+    static std::atomic<uint32_t> m_args_revision;
 };
 
 extern ArgsManager gArgs;
 
+/**
+ * A typed handle for a single argument, for hot paths.
+ *
+ * GetArg/GetBoolArg take cs_args and perform string map lookups on every
+ * call, which is fine during init but measurable when polled per transaction
+ * or per network message. A CachedArg resolves the argument against gArgs
+ * once and serves subsequent reads from an atomic, so hot code pays a couple
+ * of relaxed loads instead of a mutex. Any change to the underlying settings
+ * (config reload, ForceSetArg in tests) bumps a revision counter that
+ * transparently re-resolves the handle on its next read.
+ *
+ * Only the scalar types GetArg/GetBoolArg produce are supported. Handles are
+ * typically file-scope statics next to the code that reads them, and must
+ * not be read before argument parsing.
+ */
+template <typename T>
+class CachedArg
+{
+public:
+    CachedArg(const char* name, T default_value) : m_name(name), m_default(default_value) {}
+
+    T Get() const
+    {
+        const uint32_t revision{ArgsManager::Revision()};
+        if (m_revision.load(std::memory_order_acquire) != revision) {
+            T value;
+            if constexpr (std::is_same<T, bool>::value) {
+                value = gArgs.GetBoolArg(m_name, m_default);
+            } else {
+                value = static_cast<T>(gArgs.GetArg(m_name, m_default));
+            }
+            m_value.store(value, std::memory_order_relaxed);
+            m_revision.store(revision, std::memory_order_release);
+        }
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+private:
+    const std::string m_name;
+    const T m_default;
+    mutable std::atomic<T> m_value{};
+    //! Revision m_value was resolved at; initialized so the first read resolves.
+    mutable std::atomic<uint32_t> m_revision{std::numeric_limits<uint32_t>::max()};
+};
+
 /**
  * @return true if help has been requested via a command-line arg
  */
@@ -15,11 +15,13 @@
 #include <coins.h>
 #include <consensus/validation.h>
 #include <crypto/common.h> // for ReadLE64
+#include <flatfile.h>
 #include <fs.h>
 #include <node/utxo_snapshot.h>
 #include <policy/feerate.h>
 #include <protocol.h> // For CMessageHeader::MessageStartChars
 #include <script/script_error.h>
+#include <span.h>
 #include <sync.h>
 #include <txmempool.h> // For CTxMemPool::cs
 #include <txdb.h>
@@ -35,6 +37,7 @@
 #include <set>
 #include <stdint.h>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -69,6 +72,8 @@ static const unsigned int DEFAULT_DESCENDANT_LIMIT = 25;
 static const unsigned int DEFAULT_DESCENDANT_SIZE_LIMIT = 101;
 /** Default for -mempoolexpiry, expiration time for mempool transactions in hours */
 static const unsigned int DEFAULT_MEMPOOL_EXPIRY = 336;
+/** Default for -mempoolbgtrim, trimming the mempool to -maxmempool from a background task */
+static constexpr bool DEFAULT_MEMPOOL_BG_TRIM{false};
 /** The maximum size of a blk?????.dat file (since 0.8) */
 static const unsigned int MAX_BLOCKFILE_SIZE = 0x8000000; // 128 MiB
 /** Maximum number of dedicated script-checking threads allowed */
@@ -78,9 +83,17 @@ static const int DEFAULT_SCRIPTCHECK_THREADS = 0;
 static const int64_t DEFAULT_MAX_TIP_AGE = 24 * 60 * 60;
 static const bool DEFAULT_CHECKPOINTS_ENABLED = true;
 static const bool DEFAULT_TXINDEX = false;
+/** Default for -compressundo */
+static const bool DEFAULT_COMPRESS_UNDO = false;
 static const char* const DEFAULT_BLOCKFILTERINDEX = "0";
 /** Default for -persistmempool */
 static const bool DEFAULT_PERSIST_MEMPOOL = true;
+/** Default for -persistmempoolinterval, in minutes (0 = only save the mempool on shutdown) */
+static const int64_t DEFAULT_PERSIST_MEMPOOL_INTERVAL = 0;
+/** Default for -warmcoinscache */
+static const bool DEFAULT_WARM_COINS_CACHE = false;
+/** Default for -persistscriptcache */
+static const bool DEFAULT_PERSIST_SCRIPT_CACHE = false;
 /** Default for using fee filter */
 static const bool DEFAULT_FEEFILTER = true;
 /** Default for -stopatheight */
@@ -300,18 +313,36 @@ public:
 void InitScriptExecutionCache();
 
 
+/** Get a heap-allocated block for deserialization on the hot block paths
+ * (network block processing, IBD/reindex reads). Spent blocks are recycled
+ * through a small cache once the last reference outside the cache is gone,
+ * so the vtx pointer array (several thousand entries for a full block) stays
+ * allocated across blocks instead of making an allocator round trip per
+ * block. The returned block is empty; callers use it exactly like a fresh
+ * std::make_shared<CBlock>(). */
+std::shared_ptr<CBlock> GetRecycledBlock();
+
 /** Functions for disk access for blocks */
 bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::Params& consensusParams);
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
 bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos, const CMessageHeader::MessageStartChars& message_start);
 bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start);
+/** Memory-map the serialized bytes of a block in place. On success, map holds
+ * the mapping open and the returned span points at the block's on-disk bytes
+ * (witness included), so callers can hand them on without copying. Returns
+ * nullopt if the file cannot be mapped or the record fails validation;
+ * callers fall back to a buffered read. */
+std::optional<Span<const uint8_t>> MapRawBlockFromDisk(FlatFileMap& map, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start);
 
 bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex* pindex);
 
 /** Functions for validating blocks and updating the block tree */
 
-/** Context-independent validity checks */
-bool CheckBlock(const CBlock& block, BlockValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckMerkleRoot = true);
+/** Context-independent validity checks. fCheckTransactions may only be set
+ * to false when every transaction in the block is known to have passed
+ * CheckTransaction already (e.g. a template built from mempool entries);
+ * block-level checks (size, coinbase placement, sigop budget) always run. */
+bool CheckBlock(const CBlock& block, BlockValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckMerkleRoot = true, bool fCheckTransactions = true);
 
 /** Check a block is completely valid from start to finish (only works on top of our current best block) */
 bool TestBlockValidity(BlockValidationState& state,
@@ -320,7 +351,8 @@ bool TestBlockValidity(BlockValidationState& state,
                        const CBlock& block,
                        CBlockIndex* pindexPrev,
                        bool fCheckPOW = true,
-                       bool fCheckMerkleRoot = true) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+                       bool fCheckMerkleRoot = true,
+                       const CTxMemPool* trust_mempool = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
 /** Check whether witness commitments are required for a block, and whether to enforce NULLDUMMY (BIP 147) rules.
  *  Note that transaction witness validation rules are always enforced when P2SH is enforced. */
@@ -340,6 +372,51 @@ public:
     bool VerifyDB(const CChainParams& chainparams, CChainState& active_chainstate, CCoinsView *coinsview, int nCheckLevel, int nCheckDepth) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 };
 
+/** Background chain verification (driven by the verifychainasync RPC).
+ *
+ * Runs the level 0-2 checks of CVerifyDB (block reads, block validity, undo
+ * data) over the requested depth on a dedicated thread, taking cs_main only
+ * for one small batch of blocks at a time so the node keeps validating and
+ * serving requests in between. Levels 3-4 are not supported here: they
+ * need a coins view that stays consistent with the tip for the whole run,
+ * which is only possible while holding cs_main throughout.
+ *
+ * At most one verification runs at a time; progress and the final result
+ * stay queryable until the next run is started.
+ */
+class AsyncVerifyDB
+{
+public:
+    struct Progress {
+        bool started{false};
+        bool running{false};
+        int check_level{0};
+        int blocks_checked{0};
+        int blocks_total{0};
+        bool success{false};
+        std::string error;
+    };
+
+    ~AsyncVerifyDB();
+
+    //! Begin verification from the current tip. Returns false if a run is
+    //! already in progress. check_level must be 0, 1 or 2.
+    bool Start(const CChainParams& chainparams, CChainState& chainstate, int check_level, int check_depth);
+    Progress GetProgress() const;
+    //! Abort any in-progress run and join the worker. Called on shutdown.
+    void Interrupt();
+
+private:
+    void Run(const CChainParams& chainparams, CChainState& chainstate, int check_level, int check_depth);
+
+    mutable Mutex m_mutex;
+    Progress m_progress GUARDED_BY(m_mutex);
+    std::thread m_thread;
+    std::atomic<bool> m_interrupt{false};
+};
+
+extern AsyncVerifyDB g_async_verify_db;
+
 enum DisconnectResult
 {
     DISCONNECT_OK,      // All good.
@@ -362,6 +439,61 @@ struct CBlockIndexWorkComparator
     bool operator()(const CBlockIndex *pa, const CBlockIndex *pb) const;
 };
 
+/**
+ * Contiguous insertion-order storage for the CBlockIndex entries owned by
+ * BlockManager.
+ *
+ * The block index holds one entry per known header (several hundred thousand,
+ * growing forever) and every entry lives until shutdown. Allocating each one
+ * individually costs malloc bookkeeping per object and scatters them across
+ * the heap, which the header-walk loops (GetAncestor, FindFork) then chase
+ * pointer by pointer. Constructing entries into large chunks in insertion
+ * order removes the per-object overhead and keeps ancestors close together
+ * in memory. Pointers handed out are stable until Clear(), which destroys
+ * all entries at once.
+ */
+class CBlockIndexArena
+{
+private:
+    //! Entries per chunk; about 2.5 MB of CBlockIndex records.
+    static constexpr size_t CHUNK_ENTRIES{16384};
+    struct Chunk {
+        std::aligned_storage_t<sizeof(CBlockIndex), alignof(CBlockIndex)> entries[CHUNK_ENTRIES];
+    };
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    //! Number of constructed entries in the last chunk.
+    size_t m_used_in_last{CHUNK_ENTRIES};
+
+public:
+    //! Construct a new entry; the arena retains ownership.
+    template <typename... Args>
+    CBlockIndex* New(Args&&... args)
+    {
+        if (m_used_in_last == CHUNK_ENTRIES) {
+            m_chunks.push_back(std::make_unique<Chunk>());
+            m_used_in_last = 0;
+        }
+        return new (&m_chunks.back()->entries[m_used_in_last++]) CBlockIndex(std::forward<Args>(args)...);
+    }
+
+    //! Destroy every entry and release the memory. Invalidates all pointers
+    //! previously returned by New().
+    void Clear()
+    {
+        for (size_t c = 0; c < m_chunks.size(); ++c) {
+            const size_t used = c + 1 == m_chunks.size() ? m_used_in_last : CHUNK_ENTRIES;
+            for (size_t i = 0; i < used; ++i) {
+                reinterpret_cast<CBlockIndex*>(&m_chunks[c]->entries[i])->~CBlockIndex();
+            }
+        }
+        m_chunks.clear();
+        m_chunks.shrink_to_fit();
+        m_used_in_last = CHUNK_ENTRIES;
+    }
+
+    ~CBlockIndexArena() { Clear(); }
+};
+
 /**
  * Maintains a tree of blocks (stored in `m_block_index`) which is consulted
  * to determine where the most-work tip is.
@@ -374,6 +506,10 @@ class BlockManager
     friend CChainState;
 
 private:
+    //! Backing storage for the entries in m_block_index. Declared before the
+    //! maps of raw pointers into it so that it outlives them on destruction.
+    CBlockIndexArena m_block_index_arena GUARDED_BY(cs_main);
+
     /* Calculate the block/rev files to delete based on height specified by user with RPC command pruneblockchain */
     void FindFilesToPruneManual(std::set<int>& setFilesToPrune, int nManualPruneHeight, int chain_tip_height);
 
@@ -450,12 +586,15 @@ public:
     /**
      * If a block header hasn't already been seen, call CheckBlockHeader on it, ensure
      * that it doesn't descend from an invalid block, and then add it to m_block_index.
+     * If pow_checked is true, the header's proof of work has already been verified
+     * against its nBits (e.g. as part of a batch) and is not re-checked here.
      */
     bool AcceptBlockHeader(
         const CBlockHeader& block,
         BlockValidationState& state,
         const CChainParams& chainparams,
-        CBlockIndex** ppindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+        CBlockIndex** ppindex,
+        bool pow_checked = false) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     CBlockIndex* LookupBlockIndex(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
@@ -701,12 +840,17 @@ public:
     bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, BlockValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fRequested, const FlatFilePos* dbp, bool* fNewBlock) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     // Block (dis)connection on a given view:
-    DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view);
+    //! If undo is provided it is used instead of reading the rev file, and is
+    //! consumed (its vprevout entries are moved out).
+    DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view, CBlockUndo* undo = nullptr);
+    //! fCheckTransactions is forwarded to CheckBlock, see its declaration.
     bool ConnectBlock(const CBlock& block, BlockValidationState& state, CBlockIndex* pindex,
-                      CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck = false) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+                      CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck = false, bool fCheckTransactions = true) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     // Apply the effects of a block disconnection on the UTXO set.
-    bool DisconnectTip(BlockValidationState& state, const CChainParams& chainparams, DisconnectedBlockTransactions* disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool.cs);
+    //! pre_read optionally carries the block and undo data, read ahead on a
+    //! helper thread (see ActivateBestChainStep); it is consumed.
+    bool DisconnectTip(BlockValidationState& state, const CChainParams& chainparams, DisconnectedBlockTransactions* disconnectpool, struct DisconnectData* pre_read = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool.cs);
 
     // Manual block validity manipulation:
     /** Mark a block as precious and reorganize.
@@ -766,7 +910,8 @@ private:
     CBlockIndex* FindMostWorkChain() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     void ReceivedBlockTransactions(const CBlock& block, CBlockIndex* pindexNew, const FlatFilePos& pos, const Consensus::Params& consensusParams) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
-    bool RollforwardBlock(const CBlockIndex* pindex, CCoinsViewCache& inputs, const CChainParams& params) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    //! If pre_read is provided it is used instead of reading the block file.
+    bool RollforwardBlock(const CBlockIndex* pindex, CCoinsViewCache& inputs, const CChainParams& params, const CBlock* pre_read = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     //! Mark a block as not having block data
     void EraseBlockData(CBlockIndex* index) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -1020,6 +1165,47 @@ bool DumpMempool(const CTxMemPool& pool, FopenFn mockable_fopen_function = fsbri
 /** Load the mempool from disk. */
 bool LoadMempool(CTxMemPool& pool, CChainState& active_chainstate, FopenFn mockable_fopen_function = fsbridge::fopen);
 
+/** Dump the outpoints currently held in the coins cache to disk, so the next
+ * startup can prewarm the cache with WarmCoinsCache(). Must run before the
+ * shutdown flush empties the cache. */
+bool DumpCoinsCacheHotSet(CChainState& chainstate);
+
+/** Dump the live script execution cache entries (and the salt they were
+ * computed under) to scriptcache.dat, so a restarted node connects blocks at
+ * warm-cache speed for transactions it already validated. */
+bool DumpScriptExecutionCache();
+
+/** Load scriptcache.dat and rekey the salted script cache hasher to the
+ * persisted salt. Must run before any block or transaction validation. */
+bool LoadScriptExecutionCache();
+
+/** Timing statistics for one block-connect phase, see GetValidationBenchStats(). */
+struct ValidationBenchStats {
+    std::string name; //!< phase name; stable, part of the RPC interface
+    uint64_t count;   //!< samples since startup
+    size_t window;    //!< samples currently in the sliding window
+    double p50_ms;    //!< median over the window, in milliseconds
+    double p95_ms;    //!< 95th percentile over the window, in milliseconds
+    double max_ms;    //!< maximum over the window, in milliseconds
+};
+
+/** Per-phase block-connect timings over a sliding window of recently
+ * connected blocks - the same measurements the -debug=bench log prints,
+ * backing the getvalidationinfo RPC. */
+std::vector<ValidationBenchStats> GetValidationBenchStats();
+
+/** Stream the coins recorded by DumpCoinsCacheHotSet() back into the coins
+ * cache. Best-effort: missing file, spent outpoints and a full cache are all
+ * tolerated. Takes cs_main per batch; intended to run from a background
+ * thread. */
+void WarmCoinsCache(CChainState& chainstate);
+
+/** Expire old mempool transactions and evict packages until the pool fits in
+ * limit bytes, uncaching the coins of fully evicted transactions. Normally run
+ * inline from AcceptToMemoryPool; with -mempoolbgtrim also from a periodic
+ * background task. */
+void LimitMempoolSize(CTxMemPool& pool, CCoinsViewCache& coins_cache, size_t limit, std::chrono::seconds age) EXCLUSIVE_LOCKS_REQUIRED(pool.cs, ::cs_main);
+
 //! Check whether the block associated with this index entry is pruned or not.
 inline bool IsBlockPruned(const CBlockIndex* pblockindex)
 {
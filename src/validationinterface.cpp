@@ -12,10 +12,16 @@
 #include <primitives/transaction.h>
 #include <scheduler.h>
 
+#include <chrono>
 #include <future>
 #include <unordered_map>
 #include <utility>
 
+/** Maximum time a coalesced mempool event may wait before it is delivered. */
+static constexpr auto MEMPOOL_BATCH_FLUSH_INTERVAL{std::chrono::milliseconds{100}};
+/** Deliver a pending batch as soon as it holds this many events. */
+static constexpr size_t MEMPOOL_BATCH_FLUSH_SIZE{1000};
+
 //! The MainSignalsInstance manages a list of shared_ptr<CValidationInterface>
 //! callbacks.
 //!
@@ -39,8 +45,17 @@ public:
     // but must ensure all callbacks happen in-order, so we end up creating
     // our own queue here :(
     SingleThreadedSchedulerClient m_schedulerClient;
+    //! Scheduler used to time out pending mempool event batches.
+    CScheduler* m_scheduler;
+
+    //! Mempool events coalesced since the last flush, in generation order.
+    //! See CMainSignals::FlushMempoolBatch.
+    Mutex m_batch_mutex;
+    std::vector<MempoolTxEvent> m_pending_mempool_events GUARDED_BY(m_batch_mutex);
+    //! Whether a timed flush is already scheduled for the pending batch.
+    bool m_batch_flush_scheduled GUARDED_BY(m_batch_mutex){false};
 
-    explicit MainSignalsInstance(CScheduler *pscheduler) : m_schedulerClient(pscheduler) {}
+    explicit MainSignalsInstance(CScheduler *pscheduler) : m_schedulerClient(pscheduler), m_scheduler(pscheduler) {}
 
     void Register(std::shared_ptr<CValidationInterface> callbacks)
     {
@@ -103,6 +118,7 @@ void CMainSignals::UnregisterBackgroundSignalScheduler()
 void CMainSignals::FlushBackgroundCallbacks()
 {
     if (m_internals) {
+        FlushMempoolBatch();
         m_internals->m_schedulerClient.EmptyQueue();
     }
 }
@@ -154,6 +170,9 @@ void UnregisterAllValidationInterfaces()
 
 void CallFunctionInValidationInterfaceQueue(std::function<void()> func)
 {
+    // Any coalesced mempool events were generated before func, so they must
+    // reach the queue first to keep the documented ordering guarantee.
+    g_signals.FlushMempoolBatch();
     g_signals.m_internals->m_schedulerClient.AddToProcessQueue(std::move(func));
 }
 
@@ -185,10 +204,50 @@ void SyncWithValidationInterfaceQueue()
 #define LOG_EVENT(fmt, ...) \
     LogPrint(BCLog::VALIDATION, fmt "\n", __VA_ARGS__)
 
+void CMainSignals::QueueMempoolEvent(MempoolTxEvent&& event)
+{
+    bool flush_now;
+    {
+        LOCK(m_internals->m_batch_mutex);
+        m_internals->m_pending_mempool_events.push_back(std::move(event));
+        flush_now = m_internals->m_pending_mempool_events.size() >= MEMPOOL_BATCH_FLUSH_SIZE;
+        if (!flush_now && !m_internals->m_batch_flush_scheduled) {
+            m_internals->m_batch_flush_scheduled = true;
+            m_internals->m_scheduler->scheduleFromNow([this] {
+                if (!m_internals) return;
+                WITH_LOCK(m_internals->m_batch_mutex, m_internals->m_batch_flush_scheduled = false);
+                FlushMempoolBatch();
+            }, MEMPOOL_BATCH_FLUSH_INTERVAL, CScheduler::Priority::HIGH);
+        }
+    }
+    if (flush_now) FlushMempoolBatch();
+}
+
+// Coalescing mempool events means one queue operation and one subscriber
+// dispatch per batch instead of per transaction. To preserve the documented
+// per-subscriber event ordering, every event that bypasses the batch must
+// flush it first, and the batch itself travels through the same
+// SingleThreadedSchedulerClient queue as everything else.
+void CMainSignals::FlushMempoolBatch()
+{
+    if (!m_internals) return;
+    std::vector<MempoolTxEvent> batch;
+    {
+        LOCK(m_internals->m_batch_mutex);
+        if (m_internals->m_pending_mempool_events.empty()) return;
+        batch.swap(m_internals->m_pending_mempool_events);
+    }
+    LOG_EVENT("%s: %u mempool transaction events", __func__, batch.size());
+    m_internals->m_schedulerClient.AddToProcessQueue([batch = std::move(batch), this] {
+        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.MempoolTransactionsChanged(batch); });
+    });
+}
+
 void CMainSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) {
     // Dependencies exist that require UpdatedBlockTip events to be delivered in the order in which
     // the chain actually updates. One way to ensure this is for the caller to invoke this signal
     // in the same critical section where the chain is updated
+    FlushMempoolBatch();
 
     auto event = [pindexNew, pindexFork, fInitialDownload, this] {
         m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload); });
@@ -200,24 +259,21 @@ void CMainSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockInd
 }
 
 void CMainSignals::TransactionAddedToMempool(const CTransactionRef& tx, uint64_t mempool_sequence) {
-    auto event = [tx, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionAddedToMempool(tx, mempool_sequence); });
-    };
-    ENQUEUE_AND_LOG_EVENT(event, "%s: txid=%s wtxid=%s", __func__,
-                          tx->GetHash().ToString(),
-                          tx->GetWitnessHash().ToString());
+    LOG_EVENT("Batching %s: txid=%s wtxid=%s", __func__,
+              tx->GetHash().ToString(),
+              tx->GetWitnessHash().ToString());
+    QueueMempoolEvent({tx, mempool_sequence, /* added */ true, MemPoolRemovalReason{}});
 }
 
 void CMainSignals::TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) {
-    auto event = [tx, reason, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence); });
-    };
-    ENQUEUE_AND_LOG_EVENT(event, "%s: txid=%s wtxid=%s", __func__,
-                          tx->GetHash().ToString(),
-                          tx->GetWitnessHash().ToString());
+    LOG_EVENT("Batching %s: txid=%s wtxid=%s", __func__,
+              tx->GetHash().ToString(),
+              tx->GetWitnessHash().ToString());
+    QueueMempoolEvent({tx, mempool_sequence, /* added */ false, reason});
 }
 
 void CMainSignals::BlockConnected(const std::shared_ptr<const CBlock> &pblock, const CBlockIndex *pindex) {
+    FlushMempoolBatch();
     auto event = [pblock, pindex, this] {
         m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockConnected(pblock, pindex); });
     };
@@ -228,6 +284,7 @@ void CMainSignals::BlockConnected(const std::shared_ptr<const CBlock> &pblock, c
 
 void CMainSignals::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex)
 {
+    FlushMempoolBatch();
     auto event = [pblock, pindex, this] {
         m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockDisconnected(pblock, pindex); });
     };
@@ -237,6 +294,7 @@ void CMainSignals::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock
 }
 
 void CMainSignals::ChainStateFlushed(const CBlockLocator &locator) {
+    FlushMempoolBatch();
     auto event = [locator, this] {
         m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.ChainStateFlushed(locator); });
     };
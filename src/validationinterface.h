@@ -11,6 +11,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 extern RecursiveMutex cs_main;
 class BlockValidationState;
@@ -60,6 +61,18 @@ void CallFunctionInValidationInterfaceQueue(std::function<void ()> func);
  */
 void SyncWithValidationInterfaceQueue() LOCKS_EXCLUDED(cs_main);
 
+/**
+ * One coalesced mempool transaction event, see
+ * CValidationInterface::MempoolTransactionsChanged.
+ */
+struct MempoolTxEvent {
+    CTransactionRef tx;
+    uint64_t mempool_sequence;
+    //! True for an addition to the mempool; false for a removal, with reason set.
+    bool added;
+    MemPoolRemovalReason reason;
+};
+
 /**
  * Implement this to subscribe to events generated in validation
  *
@@ -132,6 +145,30 @@ protected:
      * Called on a background thread.
      */
     virtual void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) {}
+    /**
+     * Notifies listeners of a batch of mempool additions and removals, in
+     * event order. Mempool events are coalesced by CMainSignals and delivered
+     * as one batch per flush (short timer, size threshold, or a non-mempool
+     * event arriving), so a mempool flood costs one queue operation per batch
+     * instead of per transaction.
+     *
+     * The default implementation replays the batch through the
+     * per-transaction callbacks above, so existing subscribers see unchanged
+     * behavior; subscribers doing per-callback work that can be amortized
+     * (a lock, a socket write) can override this instead.
+     *
+     * Called on a background thread.
+     */
+    virtual void MempoolTransactionsChanged(const std::vector<MempoolTxEvent>& events)
+    {
+        for (const MempoolTxEvent& event : events) {
+            if (event.added) {
+                TransactionAddedToMempool(event.tx, event.mempool_sequence);
+            } else {
+                TransactionRemovedFromMempool(event.tx, event.reason, event.mempool_sequence);
+            }
+        }
+    }
     /**
      * Notifies listeners of a block being connected.
      * Provides a vector of transactions evicted from the mempool as a result.
@@ -186,6 +223,11 @@ private:
     friend void ::UnregisterAllValidationInterfaces();
     friend void ::CallFunctionInValidationInterfaceQueue(std::function<void ()> func);
 
+    /** Append a mempool event to the pending batch, flushing it when full. */
+    void QueueMempoolEvent(MempoolTxEvent&& event);
+    /** Hand the coalesced mempool events to the notification queue, if any. */
+    void FlushMempoolBatch();
+
 public:
     /** Register a CScheduler to give callbacks which should run in the background (may only be called once) */
     void RegisterBackgroundSignalScheduler(CScheduler& scheduler);
@@ -131,6 +131,10 @@ void StartWallets(CScheduler& scheduler, const ArgsManager& args)
         scheduler.scheduleEvery(MaybeCompactWalletDB, std::chrono::milliseconds{500});
     }
     scheduler.scheduleEvery(MaybeResendWalletTxs, std::chrono::milliseconds{1000});
+
+    // Refill keypools in the background so address requests do not stall on
+    // script derivation after a burst of use.
+    scheduler.scheduleEvery(MaybeTopUpWalletKeyPools, std::chrono::milliseconds{250});
 }
 
 void FlushWallets()
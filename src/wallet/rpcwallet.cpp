@@ -23,6 +23,7 @@
 #include <util/message.h> // For MessageSign()
 #include <util/moneystr.h>
 #include <util/ref.h>
+#include <util/strencodings.h>
 #include <util/string.h>
 #include <util/system.h>
 #include <util/translation.h>
@@ -1399,8 +1400,13 @@ static RPCHelpMan listtransactions()
                     {"count", RPCArg::Type::NUM, /* default */ "10", "The number of transactions to return"},
                     {"skip", RPCArg::Type::NUM, /* default */ "0", "The number of transactions to skip"},
                     {"include_watchonly", RPCArg::Type::BOOL, /* default */ "true for watch-only wallets, otherwise false", "Include transactions to watch-only addresses (see 'importaddress')"},
+                    {"cursor", RPCArg::Type::STR, RPCArg::Optional::OMITTED_NAMED_ARG, "Opaque pagination cursor. Pass the empty string to fetch the first page and the\n"
+                          "next_cursor from the previous response for subsequent pages. When given, skip must not be set, count is the\n"
+                          "minimum page size (a page never splits one transaction's entries), and the result is an object with the\n"
+                          "transactions (newest first) and the cursor for the next page"},
                 },
-                RPCResult{
+                {
+                    RPCResult{"without cursor",
                     RPCResult::Type::ARR, "", "",
                     {
                         {RPCResult::Type::OBJ, "", "", Cat(Cat<std::vector<RPCResult>>(
@@ -1425,7 +1431,16 @@ static RPCHelpMan listtransactions()
                             {RPCResult::Type::BOOL, "abandoned", "'true' if the transaction has been abandoned (inputs are respendable). Only available for the \n"
                                  "'send' category of transactions."},
                         })},
-                    }
+                    }},
+                    RPCResult{"when cursor is specified",
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::ARR, "transactions", "One page of transactions, newest first",
+                        {
+                            {RPCResult::Type::ELISION, "", "The same transaction fields as without a cursor"},
+                        }},
+                        {RPCResult::Type::STR, "next_cursor", /* optional */ true, "Pass as cursor to fetch the next page. Omitted once all transactions have been returned"},
+                    }},
                 },
                 RPCExamples{
             "\nList the most recent 10 transactions in the systems\n"
@@ -1463,12 +1478,26 @@ static RPCHelpMan listtransactions()
         filter |= ISMINE_WATCH_ONLY;
     }
 
+    bool paginate = false;
+    int64_t cursor_pos = std::numeric_limits<int64_t>::max();
+    if (!request.params[4].isNull()) {
+        paginate = true;
+        if (nFrom != 0) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "cursor is incompatible with skip");
+        }
+        const std::string& cursor_str = request.params[4].get_str();
+        if (!cursor_str.empty() && !ParseInt64(cursor_str, &cursor_pos)) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+        }
+    }
+
     if (nCount < 0)
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative count");
     if (nFrom < 0)
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative from");
 
     UniValue ret(UniValue::VARR);
+    std::optional<int64_t> next_cursor;
 
     {
         LOCK(pwallet->cs_wallet);
@@ -1476,12 +1505,32 @@ static RPCHelpMan listtransactions()
         const CWallet::TxItems & txOrdered = pwallet->wtxOrdered;
 
         // iterate backwards until we have nCount items to return:
-        for (CWallet::TxItems::const_reverse_iterator it = txOrdered.rbegin(); it != txOrdered.rend(); ++it)
+        CWallet::TxItems::const_reverse_iterator it = txOrdered.rbegin();
+        if (paginate) {
+            // Resume below the cursor: the first entry whose order position
+            // is smaller than the one the previous page stopped at.
+            it = CWallet::TxItems::const_reverse_iterator(txOrdered.lower_bound(cursor_pos));
+        }
+        for (; it != txOrdered.rend(); ++it)
         {
             CWalletTx *const pwtx = (*it).second;
             ListTransactions(*pwallet, *pwtx, 0, true, ret, filter, filter_label);
             if ((int)ret.size() >= (nCount+nFrom)) break;
         }
+        if (paginate && it != txOrdered.rend() && std::next(it) != txOrdered.rend()) {
+            next_cursor = (*it).first;
+        }
+    }
+
+    if (paginate) {
+        // One page, newest to oldest; the caller follows next_cursor instead
+        // of re-walking the skipped prefix on every call.
+        UniValue paged{UniValue::VOBJ};
+        paged.pushKV("transactions", ret);
+        if (next_cursor) {
+            paged.pushKV("next_cursor", ToString(*next_cursor));
+        }
+        return paged;
     }
 
     // ret is newest to oldest
@@ -1702,8 +1751,6 @@ static RPCHelpMan gettransaction()
     // the user could have gotten from another RPC command prior to now
     pwallet->BlockUntilSyncedToCurrentChain();
 
-    LOCK(pwallet->cs_wallet);
-
     uint256 hash(ParseHashV(request.params[0], "txid"));
 
     isminefilter filter = ISMINE_SPENDABLE;
@@ -1715,33 +1762,44 @@ static RPCHelpMan gettransaction()
     bool verbose = request.params[2].isNull() ? false : request.params[2].get_bool();
 
     UniValue entry(UniValue::VOBJ);
-    auto it = pwallet->mapWallet.find(hash);
-    if (it == pwallet->mapWallet.end()) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid or non-wallet transaction id");
-    }
-    const CWalletTx& wtx = it->second;
+    // The fields that depend on wallet state are computed under cs_wallet;
+    // the transaction itself is snapshotted so the raw hex encoding and the
+    // verbose decoding below run with the lock released and do not stall
+    // writers such as sendtoaddress on the same wallet.
+    CTransactionRef tx;
+    {
+        LOCK(pwallet->cs_wallet);
+
+        auto it = pwallet->mapWallet.find(hash);
+        if (it == pwallet->mapWallet.end()) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid or non-wallet transaction id");
+        }
+        const CWalletTx& wtx = it->second;
 
-    CAmount nCredit = wtx.GetCredit(filter);
-    CAmount nDebit = wtx.GetDebit(filter);
-    CAmount nNet = nCredit - nDebit;
-    CAmount nFee = (wtx.IsFromMe(filter) ? wtx.tx->GetValueOut() - nDebit : 0);
+        CAmount nCredit = wtx.GetCredit(filter);
+        CAmount nDebit = wtx.GetDebit(filter);
+        CAmount nNet = nCredit - nDebit;
+        CAmount nFee = (wtx.IsFromMe(filter) ? wtx.tx->GetValueOut() - nDebit : 0);
 
-    entry.pushKV("amount", ValueFromAmount(nNet - nFee));
-    if (wtx.IsFromMe(filter))
-        entry.pushKV("fee", ValueFromAmount(nFee));
+        entry.pushKV("amount", ValueFromAmount(nNet - nFee));
+        if (wtx.IsFromMe(filter))
+            entry.pushKV("fee", ValueFromAmount(nFee));
 
-    WalletTxToJSON(pwallet->chain(), wtx, entry);
+        WalletTxToJSON(pwallet->chain(), wtx, entry);
 
-    UniValue details(UniValue::VARR);
-    ListTransactions(*pwallet, wtx, 0, false, details, filter, nullptr /* filter_label */);
-    entry.pushKV("details", details);
+        UniValue details(UniValue::VARR);
+        ListTransactions(*pwallet, wtx, 0, false, details, filter, nullptr /* filter_label */);
+        entry.pushKV("details", details);
 
-    std::string strHex = EncodeHexTx(*wtx.tx, pwallet->chain().rpcSerializationFlags());
+        tx = wtx.tx;
+    }
+
+    std::string strHex = EncodeHexTx(*tx, pwallet->chain().rpcSerializationFlags());
     entry.pushKV("hex", strHex);
 
     if (verbose) {
         UniValue decoded(UniValue::VOBJ);
-        TxToUniv(*wtx.tx, uint256(), decoded, false);
+        TxToUniv(*tx, uint256(), decoded, false);
         entry.pushKV("decoded", decoded);
     }
 
@@ -1826,6 +1884,31 @@ static RPCHelpMan backupwallet()
 }
 
 
+static RPCHelpMan flushwallet()
+{
+    return RPCHelpMan{"flushwallet",
+                "\nForce all pending wallet database writes to be flushed to disk.\n"
+                "Wallet writes are normally batched and flushed once no new write has arrived\n"
+                "within the -walletflushwindow durability window. Call this to establish a hard\n"
+                "durability point, e.g. before settlement operations or taking a backup.\n",
+                {},
+                RPCResult{RPCResult::Type::NONE, "", ""},
+                RPCExamples{
+                    HelpExampleCli("flushwallet", "")
+            + HelpExampleRpc("flushwallet", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    std::shared_ptr<CWallet> const pwallet = GetWalletForJSONRPCRequest(request);
+    if (!pwallet) return NullUniValue;
+
+    pwallet->GetDatabase().Flush();
+
+    return NullUniValue;
+},
+    };
+}
+
 static RPCHelpMan keypoolrefill()
 {
     return RPCHelpMan{"keypoolrefill",
@@ -2852,11 +2935,15 @@ static RPCHelpMan listunspent()
                             {"minimumAmount", RPCArg::Type::AMOUNT, /* default */ "0", "Minimum value of each UTXO in " + CURRENCY_UNIT + ""},
                             {"maximumAmount", RPCArg::Type::AMOUNT, /* default */ "unlimited", "Maximum value of each UTXO in " + CURRENCY_UNIT + ""},
                             {"maximumCount", RPCArg::Type::NUM, /* default */ "unlimited", "Maximum number of UTXOs"},
-                            {"minimumSumAmount", RPCArg::Type::AMOUNT, /* default */ "unlimited", "Minimum sum value of all UTXOs in " + CURRENCY_UNIT + ""},
+                            {"minimumSumAmount", RPCArg::Type::AMOUNT, /* default */ "unlimited", "Minimum sum value of all UTXOs in " + CURRENCY_UNIT + ". Incompatible with cursor"},
+                            {"cursor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Opaque pagination cursor. Pass the empty string to fetch the first page and the\n"
+                              "next_cursor from the previous response for subsequent pages. maximumCount becomes the page size,\n"
+                              "and the result is an object with the outputs and the cursor for the next page"},
                         },
                         "query_options"},
                 },
-                RPCResult{
+                {
+                    RPCResult{"without cursor",
                     RPCResult::Type::ARR, "", "",
                     {
                         {RPCResult::Type::OBJ, "", "",
@@ -2878,7 +2965,16 @@ static RPCHelpMan listunspent()
                                                             "from outside keys and unconfirmed replacement transactions are considered unsafe\n"
                                                             "and are not eligible for spending by fundrawtransaction and sendtoaddress."},
                         }},
-                    }
+                    }},
+                    RPCResult{"when cursor is specified",
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::ARR, "unspents", "One page of unspent outputs, in a stable txid:vout order",
+                        {
+                            {RPCResult::Type::ELISION, "", "The same output fields as without a cursor"},
+                        }},
+                        {RPCResult::Type::STR, "next_cursor", /* optional */ true, "Pass as cursor to fetch the next page. Omitted once all outputs have been returned"},
+                    }},
                 },
                 RPCExamples{
                     HelpExampleCli("listunspent", "")
@@ -2930,6 +3026,8 @@ static RPCHelpMan listunspent()
     CAmount nMaximumAmount = MAX_MONEY;
     CAmount nMinimumSumAmount = MAX_MONEY;
     uint64_t nMaximumCount = 0;
+    bool paginate = false;
+    std::optional<COutPoint> cursor;
 
     if (!request.params[4].isNull()) {
         const UniValue& options = request.params[4].get_obj();
@@ -2940,6 +3038,7 @@ static RPCHelpMan listunspent()
                 {"maximumAmount", UniValueType()},
                 {"minimumSumAmount", UniValueType()},
                 {"maximumCount", UniValueType(UniValue::VNUM)},
+                {"cursor", UniValueType(UniValue::VSTR)},
             },
             true, true);
 
@@ -2954,6 +3053,22 @@ static RPCHelpMan listunspent()
 
         if (options.exists("maximumCount"))
             nMaximumCount = options["maximumCount"].get_int64();
+
+        if (options.exists("cursor")) {
+            paginate = true;
+            if (options.exists("minimumSumAmount")) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER, "cursor is incompatible with minimumSumAmount");
+            }
+            const std::string& cursor_str = options["cursor"].get_str();
+            if (!cursor_str.empty()) {
+                const size_t sep = cursor_str.find(':');
+                uint32_t vout;
+                if (sep != 64 || !IsHex(cursor_str.substr(0, sep)) || !ParseUInt32(cursor_str.substr(sep + 1), &vout)) {
+                    throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+                }
+                cursor = COutPoint(uint256S(cursor_str.substr(0, sep)), vout);
+            }
+        }
     }
 
     // Make sure the results are valid at least up to the most recent block
@@ -2968,14 +3083,36 @@ static RPCHelpMan listunspent()
         cctl.m_min_depth = nMinDepth;
         cctl.m_max_depth = nMaxDepth;
         LOCK(pwallet->cs_wallet);
-        pwallet->AvailableCoins(vecOutputs, !include_unsafe, &cctl, nMinimumAmount, nMaximumAmount, nMinimumSumAmount, nMaximumCount);
+        // When paginating, the stable cut into pages happens below; a scan
+        // order maximumCount would return the wrong outputs.
+        pwallet->AvailableCoins(vecOutputs, !include_unsafe, &cctl, nMinimumAmount, nMaximumAmount, nMinimumSumAmount, paginate ? 0 : nMaximumCount);
+    }
+
+    if (paginate) {
+        // Sort into a stable txid:vout order so a cursor from a previous call
+        // identifies the same position even if the wallet changed in between,
+        // and drop everything at or before the cursor.
+        std::sort(vecOutputs.begin(), vecOutputs.end(), [](const COutput& a, const COutput& b) {
+            return COutPoint(a.tx->GetHash(), a.i) < COutPoint(b.tx->GetHash(), b.i);
+        });
+        if (cursor) {
+            vecOutputs.erase(vecOutputs.begin(), std::upper_bound(vecOutputs.begin(), vecOutputs.end(), *cursor,
+                [](const COutPoint& point, const COutput& out) { return point < COutPoint(out.tx->GetHash(), out.i); }));
+        }
     }
 
     LOCK(pwallet->cs_wallet);
 
     const bool avoid_reuse = pwallet->IsWalletFlagSet(WALLET_FLAG_AVOID_REUSE);
+    std::optional<COutPoint> next_cursor;
+    COutPoint last_emitted;
 
     for (const COutput& out : vecOutputs) {
+        if (paginate && nMaximumCount > 0 && results.size() >= nMaximumCount) {
+            // Page is full and at least one candidate remains
+            next_cursor = last_emitted;
+            break;
+        }
         CTxDestination address;
         const CScript& scriptPubKey = out.tx->tx->vout[out.i].scriptPubKey;
         bool fValidAddress = ExtractDestination(scriptPubKey, address);
@@ -3045,6 +3182,16 @@ static RPCHelpMan listunspent()
         if (avoid_reuse) entry.pushKV("reused", reused);
         entry.pushKV("safe", out.fSafe);
         results.push_back(entry);
+        last_emitted = COutPoint(out.tx->GetHash(), out.i);
+    }
+
+    if (paginate) {
+        UniValue paged(UniValue::VOBJ);
+        paged.pushKV("unspents", results);
+        if (next_cursor) {
+            paged.pushKV("next_cursor", strprintf("%s:%u", next_cursor->hash.GetHex(), next_cursor->n));
+        }
+        return paged;
     }
 
     return results;
@@ -4554,6 +4701,7 @@ static const CRPCCommand commands[] =
     { "wallet",             &dumpprivkey,                    },
     { "wallet",             &dumpwallet,                     },
     { "wallet",             &encryptwallet,                  },
+    { "wallet",             &flushwallet,                    },
     { "wallet",             &getaddressesbylabel,            },
     { "wallet",             &getaddressinfo,                 },
     { "wallet",             &getbalance,                     },
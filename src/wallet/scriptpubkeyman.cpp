@@ -16,7 +16,9 @@
 #include <wallet/external_signer.h>
 #include <wallet/scriptpubkeyman.h>
 
+#include <atomic>
 #include <optional>
+#include <thread>
 
 //! Value for the first BIP 32 hardened derivation. Can be used as a bit mask and as a value. See BIP 32 for more details.
 const uint32_t BIP32_HARDENED_KEY_LIMIT = 0x80000000;
@@ -1260,6 +1262,9 @@ bool LegacyScriptPubKeyMan::TopUp(unsigned int kpSize)
         }
         bool internal = false;
         WalletBatch batch(m_storage.GetDatabase());
+        // Write the whole top-up as one database transaction so that a
+        // thousand new keys cost one sync rather than one each.
+        const bool txn_started = batch.TxnBegin();
         for (int64_t i = missingInternal + missingExternal; i--;)
         {
             if (i < missingInternal) {
@@ -1269,6 +1274,9 @@ bool LegacyScriptPubKeyMan::TopUp(unsigned int kpSize)
             CPubKey pubkey(GenerateNewKey(batch, m_hd_chain, internal));
             AddKeypoolPubkeyWithDB(pubkey, internal, batch);
         }
+        if (txn_started && !batch.TxnCommit()) {
+            throw std::runtime_error(std::string(__func__) + ": writing keypool keys failed");
+        }
         if (missingInternal + missingExternal > 0) {
             WalletLogPrintf("keypool added %d keys (%d internal), size=%u (%u internal)\n", missingInternal + missingExternal, missingInternal, setInternalKeyPool.size() + setExternalKeyPool.size() + set_pre_split_keypool.size(), setInternalKeyPool.size());
         }
@@ -1615,7 +1623,12 @@ bool DescriptorScriptPubKeyMan::GetNewDestination(const OutputType type, CTxDest
             throw std::runtime_error(std::string(__func__) + ": Types are inconsistent");
         }
 
-        TopUp();
+        // Only derive new scripts synchronously when the pool is truly
+        // empty; the scheduler keeps it above its low watermark in the
+        // background (see CWallet::MaybeTopUpKeyPools).
+        if (m_wallet_descriptor.next_index >= m_wallet_descriptor.range_end) {
+            TopUp();
+        }
 
         // Get the scriptPubKey from the descriptor
         FlatSigningProvider out_keys;
@@ -1744,91 +1757,165 @@ std::map<CKeyID, CKey> DescriptorScriptPubKeyMan::GetKeys() const
     return m_map_keys;
 }
 
-bool DescriptorScriptPubKeyMan::TopUp(unsigned int size)
+bool DescriptorScriptPubKeyMan::NeedsTopUp() const
 {
     LOCK(cs_desc_man);
-    unsigned int target_size;
-    if (size > 0) {
-        target_size = size;
-    } else {
-        target_size = std::max(gArgs.GetArg("-keypool", DEFAULT_KEYPOOL_SIZE), (int64_t) 1);
-    }
-
-    // Calculate the new range_end
-    int32_t new_range_end = std::max(m_wallet_descriptor.next_index + (int32_t)target_size, m_wallet_descriptor.range_end);
-
-    // If the descriptor is not ranged, we actually just want to fill the first cache item
-    if (!m_wallet_descriptor.descriptor->IsRange()) {
-        new_range_end = 1;
-        m_wallet_descriptor.range_end = 1;
-        m_wallet_descriptor.range_start = 0;
-    }
+    if (!m_wallet_descriptor.descriptor->IsRange()) return false;
+    const int64_t target = std::max(gArgs.GetArg("-keypool", DEFAULT_KEYPOOL_SIZE), (int64_t) 1);
+    const int64_t available = m_wallet_descriptor.range_end - m_wallet_descriptor.next_index;
+    // Low watermark: refill once half of the keypool has been handed out, so
+    // the pool is back at its high watermark (the full -keypool target) long
+    // before GetNewDestination would have to derive scripts synchronously.
+    return available < std::max(target / 2, (int64_t) 1);
+}
 
-    FlatSigningProvider provider;
-    provider.keys = GetKeys();
+bool DescriptorScriptPubKeyMan::TopUp(unsigned int size)
+{
+    std::set<CScript> new_spks;
+    bool ok = true;
+    {
+        LOCK(cs_desc_man);
+        unsigned int target_size;
+        if (size > 0) {
+            target_size = size;
+        } else {
+            target_size = std::max(gArgs.GetArg("-keypool", DEFAULT_KEYPOOL_SIZE), (int64_t) 1);
+        }
+
+        // Calculate the new range_end
+        int32_t new_range_end = std::max(m_wallet_descriptor.next_index + (int32_t)target_size, m_wallet_descriptor.range_end);
+
+        // If the descriptor is not ranged, we actually just want to fill the first cache item
+        if (!m_wallet_descriptor.descriptor->IsRange()) {
+            new_range_end = 1;
+            m_wallet_descriptor.range_end = 1;
+            m_wallet_descriptor.range_start = 0;
+        }
+
+        FlatSigningProvider provider;
+        provider.keys = GetKeys();
+
+        // Expand every new index up front. Expansion (BIP32 derivation and
+        // script construction) is independent per index and only reads the
+        // descriptor, the xpub cache and the signing provider, so for large
+        // ranges it is fanned out across all cores. The results are merged
+        // into the keyman state sequentially below.
+        struct ExpandedIndex {
+            bool ok{false};
+            std::vector<CScript> scripts;
+            FlatSigningProvider out_keys;
+            DescriptorCache cache;
+        };
+        const int32_t first_index = m_max_cached_index + 1;
+        const int32_t expand_count = std::max(new_range_end - first_index, 0);
+        std::vector<ExpandedIndex> expanded(expand_count);
+        if (expand_count > 0) {
+            std::atomic<int32_t> next_job{0};
+            auto expand_worker = [&]() {
+                int32_t job;
+                while ((job = next_job.fetch_add(1)) < expand_count) {
+                    ExpandedIndex& entry = expanded[job];
+                    const int32_t index = first_index + job;
+                    // Maybe we have a cached xpub and we can expand from the cache first
+                    if (!m_wallet_descriptor.descriptor->ExpandFromCache(index, m_wallet_descriptor.cache, entry.scripts, entry.out_keys)) {
+                        if (!m_wallet_descriptor.descriptor->Expand(index, provider, entry.scripts, entry.out_keys, &entry.cache)) continue;
+                    }
+                    entry.ok = true;
+                }
+            };
+            // Only spread small top-ups across threads when there is enough
+            // work per thread to amortize the thread start cost.
+            constexpr int32_t INDEXES_PER_THREAD{64};
+            const int num_threads = std::clamp(expand_count / INDEXES_PER_THREAD, 1, GetNumCores());
+            std::vector<std::thread> threads;
+            threads.reserve(num_threads - 1);
+            for (int t = 1; t < num_threads; ++t) threads.emplace_back(expand_worker);
+            expand_worker();
+            for (std::thread& thread : threads) thread.join();
+        }
 
-    WalletBatch batch(m_storage.GetDatabase());
-    uint256 id = GetID();
-    for (int32_t i = m_max_cached_index + 1; i < new_range_end; ++i) {
-        FlatSigningProvider out_keys;
-        std::vector<CScript> scripts_temp;
-        DescriptorCache temp_cache;
-        // Maybe we have a cached xpub and we can expand from the cache first
-        if (!m_wallet_descriptor.descriptor->ExpandFromCache(i, m_wallet_descriptor.cache, scripts_temp, out_keys)) {
-            if (!m_wallet_descriptor.descriptor->Expand(i, provider, scripts_temp, out_keys, &temp_cache)) return false;
-        }
-        // Add all of the scriptPubKeys to the scriptPubKey set
-        for (const CScript& script : scripts_temp) {
-            m_map_script_pub_keys[script] = i;
-        }
-        for (const auto& pk_pair : out_keys.pubkeys) {
-            const CPubKey& pubkey = pk_pair.second;
-            if (m_map_pubkeys.count(pubkey) != 0) {
-                // We don't need to give an error here.
-                // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
-                continue;
+        WalletBatch batch(m_storage.GetDatabase());
+        // Write the whole top-up as one database transaction so that the per
+        // index cache entries cost one sync rather than one each.
+        const bool txn_started = batch.TxnBegin();
+        uint256 id = GetID();
+        for (int32_t i = m_max_cached_index + 1; i < new_range_end; ++i) {
+            ExpandedIndex& entry = expanded[i - first_index];
+            if (!entry.ok) {
+                ok = false;
+                break;
             }
-            m_map_pubkeys[pubkey] = i;
-        }
-        // Write the cache
-        for (const auto& parent_xpub_pair : temp_cache.GetCachedParentExtPubKeys()) {
-            CExtPubKey xpub;
-            if (m_wallet_descriptor.cache.GetCachedParentExtPubKey(parent_xpub_pair.first, xpub)) {
-                if (xpub != parent_xpub_pair.second) {
-                    throw std::runtime_error(std::string(__func__) + ": New cached parent xpub does not match already cached parent xpub");
-                }
-                continue;
+            const FlatSigningProvider& out_keys = entry.out_keys;
+            const std::vector<CScript>& scripts_temp = entry.scripts;
+            const DescriptorCache& temp_cache = entry.cache;
+            // Add all of the scriptPubKeys to the scriptPubKey set
+            for (const CScript& script : scripts_temp) {
+                m_map_script_pub_keys[script] = i;
+                new_spks.insert(script);
             }
-            if (!batch.WriteDescriptorParentCache(parent_xpub_pair.second, id, parent_xpub_pair.first)) {
-                throw std::runtime_error(std::string(__func__) + ": writing cache item failed");
+            for (const auto& pk_pair : out_keys.pubkeys) {
+                const CPubKey& pubkey = pk_pair.second;
+                if (m_map_pubkeys.count(pubkey) != 0) {
+                    // We don't need to give an error here.
+                    // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
+                    continue;
+                }
+                m_map_pubkeys[pubkey] = i;
             }
-            m_wallet_descriptor.cache.CacheParentExtPubKey(parent_xpub_pair.first, parent_xpub_pair.second);
-        }
-        for (const auto& derived_xpub_map_pair : temp_cache.GetCachedDerivedExtPubKeys()) {
-            for (const auto& derived_xpub_pair : derived_xpub_map_pair.second) {
+            // Write the cache
+            for (const auto& parent_xpub_pair : temp_cache.GetCachedParentExtPubKeys()) {
                 CExtPubKey xpub;
-                if (m_wallet_descriptor.cache.GetCachedDerivedExtPubKey(derived_xpub_map_pair.first, derived_xpub_pair.first, xpub)) {
-                    if (xpub != derived_xpub_pair.second) {
-                        throw std::runtime_error(std::string(__func__) + ": New cached derived xpub does not match already cached derived xpub");
+                if (m_wallet_descriptor.cache.GetCachedParentExtPubKey(parent_xpub_pair.first, xpub)) {
+                    if (xpub != parent_xpub_pair.second) {
+                        throw std::runtime_error(std::string(__func__) + ": New cached parent xpub does not match already cached parent xpub");
                     }
                     continue;
                 }
-                if (!batch.WriteDescriptorDerivedCache(derived_xpub_pair.second, id, derived_xpub_map_pair.first, derived_xpub_pair.first)) {
+                if (!batch.WriteDescriptorParentCache(parent_xpub_pair.second, id, parent_xpub_pair.first)) {
                     throw std::runtime_error(std::string(__func__) + ": writing cache item failed");
                 }
-                m_wallet_descriptor.cache.CacheDerivedExtPubKey(derived_xpub_map_pair.first, derived_xpub_pair.first, derived_xpub_pair.second);
+                m_wallet_descriptor.cache.CacheParentExtPubKey(parent_xpub_pair.first, parent_xpub_pair.second);
             }
+            for (const auto& derived_xpub_map_pair : temp_cache.GetCachedDerivedExtPubKeys()) {
+                for (const auto& derived_xpub_pair : derived_xpub_map_pair.second) {
+                    CExtPubKey xpub;
+                    if (m_wallet_descriptor.cache.GetCachedDerivedExtPubKey(derived_xpub_map_pair.first, derived_xpub_pair.first, xpub)) {
+                        if (xpub != derived_xpub_pair.second) {
+                            throw std::runtime_error(std::string(__func__) + ": New cached derived xpub does not match already cached derived xpub");
+                        }
+                        continue;
+                    }
+                    if (!batch.WriteDescriptorDerivedCache(derived_xpub_pair.second, id, derived_xpub_map_pair.first, derived_xpub_pair.first)) {
+                        throw std::runtime_error(std::string(__func__) + ": writing cache item failed");
+                    }
+                    m_wallet_descriptor.cache.CacheDerivedExtPubKey(derived_xpub_map_pair.first, derived_xpub_pair.first, derived_xpub_pair.second);
+                }
+            }
+            m_max_cached_index++;
         }
-        m_max_cached_index++;
-    }
-    m_wallet_descriptor.range_end = new_range_end;
-    batch.WriteDescriptor(GetID(), m_wallet_descriptor);
+        if (ok) {
+            m_wallet_descriptor.range_end = new_range_end;
+            batch.WriteDescriptor(GetID(), m_wallet_descriptor);
 
-    // By this point, the cache size should be the size of the entire range
-    assert(m_wallet_descriptor.range_end - 1 == m_max_cached_index);
-
-    NotifyCanGetAddressesChanged();
-    return true;
+            // By this point, the cache size should be the size of the entire range
+            assert(m_wallet_descriptor.range_end - 1 == m_max_cached_index);
+        }
+        if (txn_started) {
+            if (ok) {
+                ok = batch.TxnCommit();
+            } else {
+                batch.TxnAbort();
+            }
+        }
+        if (ok) {
+            NotifyCanGetAddressesChanged();
+        }
+    }
+    // Let the wallet know about the new scriptPubKeys outside of cs_desc_man.
+    // This happens even when the loop above failed part way through, so that
+    // the wallet's cached copy never lags m_map_script_pub_keys.
+    if (!new_spks.empty()) m_storage.TopUpCallback(new_spks, this);
+    return ok;
 }
 
 void DescriptorScriptPubKeyMan::MarkUnusedAddresses(const CScript& script)
@@ -2190,32 +2277,39 @@ void DescriptorScriptPubKeyMan::SetInternal(bool internal)
 
 void DescriptorScriptPubKeyMan::SetCache(const DescriptorCache& cache)
 {
-    LOCK(cs_desc_man);
-    m_wallet_descriptor.cache = cache;
-    for (int32_t i = m_wallet_descriptor.range_start; i < m_wallet_descriptor.range_end; ++i) {
-        FlatSigningProvider out_keys;
-        std::vector<CScript> scripts_temp;
-        if (!m_wallet_descriptor.descriptor->ExpandFromCache(i, m_wallet_descriptor.cache, scripts_temp, out_keys)) {
-            throw std::runtime_error("Error: Unable to expand wallet descriptor from cache");
-        }
-        // Add all of the scriptPubKeys to the scriptPubKey set
-        for (const CScript& script : scripts_temp) {
-            if (m_map_script_pub_keys.count(script) != 0) {
-                throw std::runtime_error(strprintf("Error: Already loaded script at index %d as being at index %d", i, m_map_script_pub_keys[script]));
+    std::set<CScript> new_spks;
+    {
+        LOCK(cs_desc_man);
+        m_wallet_descriptor.cache = cache;
+        for (int32_t i = m_wallet_descriptor.range_start; i < m_wallet_descriptor.range_end; ++i) {
+            FlatSigningProvider out_keys;
+            std::vector<CScript> scripts_temp;
+            if (!m_wallet_descriptor.descriptor->ExpandFromCache(i, m_wallet_descriptor.cache, scripts_temp, out_keys)) {
+                throw std::runtime_error("Error: Unable to expand wallet descriptor from cache");
+            }
+            // Add all of the scriptPubKeys to the scriptPubKey set
+            for (const CScript& script : scripts_temp) {
+                if (m_map_script_pub_keys.count(script) != 0) {
+                    throw std::runtime_error(strprintf("Error: Already loaded script at index %d as being at index %d", i, m_map_script_pub_keys[script]));
+                }
+                m_map_script_pub_keys[script] = i;
+                new_spks.insert(script);
             }
-            m_map_script_pub_keys[script] = i;
-        }
-        for (const auto& pk_pair : out_keys.pubkeys) {
-            const CPubKey& pubkey = pk_pair.second;
-            if (m_map_pubkeys.count(pubkey) != 0) {
-                // We don't need to give an error here.
-                // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
-                continue;
+            for (const auto& pk_pair : out_keys.pubkeys) {
+                const CPubKey& pubkey = pk_pair.second;
+                if (m_map_pubkeys.count(pubkey) != 0) {
+                    // We don't need to give an error here.
+                    // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
+                    continue;
+                }
+                m_map_pubkeys[pubkey] = i;
             }
-            m_map_pubkeys[pubkey] = i;
+            m_max_cached_index++;
         }
-        m_max_cached_index++;
     }
+    // Report the scriptPubKeys loaded from the cache so the wallet's own
+    // cached copy of them stays in sync with m_map_script_pub_keys.
+    if (!new_spks.empty()) m_storage.TopUpCallback(new_spks, this);
 }
 
 bool DescriptorScriptPubKeyMan::AddKey(const CKeyID& key_id, const CKey& key)
@@ -23,6 +23,7 @@
 
 enum class OutputType;
 struct bilingual_str;
+class ScriptPubKeyMan;
 
 // Wallet storage things that ScriptPubKeyMans need in order to be able to store things to the wallet database.
 // It provides access to things that are part of the entire wallet and not specific to a ScriptPubKeyMan such as
@@ -42,6 +43,8 @@ public:
     virtual const CKeyingMaterial& GetEncryptionKey() const = 0;
     virtual bool HasEncryptionKeys() const = 0;
     virtual bool IsLocked() const = 0;
+    //! Callback function for after TopUp completes containing any scripts that were added by a SPKM
+    virtual void TopUpCallback(const std::set<CScript>& scripts, ScriptPubKeyMan* spkm) = 0;
 };
 
 //! Default for -keypool
@@ -191,6 +194,10 @@ public:
       */
     virtual bool TopUp(unsigned int size = 0) { return false; }
 
+    //! Whether the keypool is below its low watermark and should be topped up
+    //! in the background. See CWallet::MaybeTopUpKeyPools.
+    virtual bool NeedsTopUp() const { return false; }
+
     //! Mark unused addresses as being used
     virtual void MarkUnusedAddresses(const CScript& script) {}
 
@@ -575,6 +582,8 @@ public:
     // (with or without private keys), the "keypool" is a single xpub.
     bool TopUp(unsigned int size = 0) override;
 
+    bool NeedsTopUp() const override;
+
     void MarkUnusedAddresses(const CScript& script) override;
 
     bool IsHDEnabled() const override;
@@ -12,6 +12,9 @@
 struct bilingual_str;
 class SQLiteDatabase;
 
+//! -walletsqlitewal default
+static constexpr bool DEFAULT_WALLET_SQLITE_WAL{false};
+
 /** RAII class that provides access to a WalletDatabase */
 class SQLiteBatch : public DatabaseBatch
 {
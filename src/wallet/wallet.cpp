@@ -30,6 +30,8 @@
 #include <util/moneystr.h>
 #include <util/rbf.h>
 #include <util/string.h>
+#include <util/system.h>
+#include <util/threadnames.h>
 #include <util/translation.h>
 #include <wallet/coincontrol.h>
 #include <wallet/fees.h>
@@ -39,7 +41,10 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <condition_variable>
+#include <deque>
 #include <optional>
+#include <thread>
 
 #include <boost/algorithm/string/replace.hpp>
 
@@ -571,6 +576,35 @@ bool CWallet::IsSpent(const uint256& hash, unsigned int n) const
     return false;
 }
 
+void CWallet::UpdateCandidateCoin(const uint256& hash, const CWalletTx& wtx, uint32_t n)
+{
+    AssertLockHeld(cs_wallet);
+    if (IsMine(wtx.tx->vout[n]) != ISMINE_NO && !IsSpent(hash, n)) {
+        m_candidate_coins[hash].insert(n);
+    } else {
+        auto it = m_candidate_coins.find(hash);
+        if (it != m_candidate_coins.end()) {
+            it->second.erase(n);
+            if (it->second.empty()) m_candidate_coins.erase(it);
+        }
+    }
+}
+
+void CWallet::RebuildCandidateCoins() const
+{
+    AssertLockHeld(cs_wallet);
+    m_candidate_coins.clear();
+    for (const auto& entry : mapWallet) {
+        const CWalletTx& wtx = entry.second;
+        for (uint32_t i = 0; i < wtx.tx->vout.size(); ++i) {
+            if (IsMine(wtx.tx->vout[i]) != ISMINE_NO && !IsSpent(entry.first, i)) {
+                m_candidate_coins[entry.first].insert(i);
+            }
+        }
+    }
+    m_candidate_coins_dirty = false;
+}
+
 void CWallet::AddToSpends(const COutPoint& outpoint, const uint256& wtxid)
 {
     mapTxSpends.insert(std::make_pair(outpoint, wtxid));
@@ -772,6 +806,8 @@ void CWallet::MarkDirty()
         LOCK(cs_wallet);
         for (std::pair<const uint256, CWalletTx>& item : mapWallet)
             item.second.MarkDirty();
+        MarkBalanceDirty();
+        m_candidate_coins_dirty = true;
     }
 }
 
@@ -869,6 +905,8 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const CWalletTx::Confirmatio
 {
     LOCK(cs_wallet);
 
+    MarkBalanceDirty();
+
     WalletBatch batch(GetDatabase(), fFlushOnClose);
 
     uint256 hash = tx->GetHash();
@@ -923,6 +961,11 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const CWalletTx::Confirmatio
         }
     }
 
+    // Re-evaluate this transaction's outputs as coin selection candidates
+    for (uint32_t i = 0; i < wtx.tx->vout.size(); ++i) {
+        UpdateCandidateCoin(hash, wtx, i);
+    }
+
     //// debug print
     WalletLogPrintf("AddToWallet %s  %s%s\n", hash.ToString(), (fInsertedNew ? "new" : ""), (fUpdated ? "update" : ""));
 
@@ -1069,6 +1112,12 @@ void CWallet::MarkInputsDirty(const CTransactionRef& tx)
         auto it = mapWallet.find(txin.prevout.hash);
         if (it != mapWallet.end()) {
             it->second.MarkDirty();
+            MarkBalanceDirty();
+            // The spender may have appeared or changed 'conflicted' state, so
+            // this output may have become spent or unspent.
+            if (txin.prevout.n < it->second.tx->vout.size()) {
+                UpdateCandidateCoin(txin.prevout.hash, it->second, txin.prevout.n);
+            }
         }
     }
 }
@@ -1077,6 +1126,8 @@ bool CWallet::AbandonTransaction(const uint256& hashTx)
 {
     LOCK(cs_wallet);
 
+    MarkBalanceDirty();
+
     WalletBatch batch(GetDatabase());
 
     std::set<uint256> todo;
@@ -1131,6 +1182,8 @@ void CWallet::MarkConflicted(const uint256& hashBlock, int conflicting_height, c
 {
     LOCK(cs_wallet);
 
+    MarkBalanceDirty();
+
     int conflictconfirms = (m_last_block_processed_height - conflicting_height + 1) * -1;
     // If number of conflict confirms cannot be determined, this means
     // that the block is still unknown or not yet part of the main chain,
@@ -1197,6 +1250,7 @@ void CWallet::transactionAddedToMempool(const CTransactionRef& tx, uint64_t memp
     auto it = mapWallet.find(tx->GetHash());
     if (it != mapWallet.end()) {
         it->second.fInMempool = true;
+        MarkBalanceDirty();
     }
 }
 
@@ -1205,6 +1259,7 @@ void CWallet::transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRe
     auto it = mapWallet.find(tx->GetHash());
     if (it != mapWallet.end()) {
         it->second.fInMempool = false;
+        MarkBalanceDirty();
     }
     // Handle transactions that were removed from the mempool because they
     // conflict with transactions in a newly connected block.
@@ -1244,10 +1299,21 @@ void CWallet::blockConnected(const CBlock& block, int height)
 
     m_last_block_processed_height = height;
     m_last_block_processed = block_hash;
+
+    // Group the per-transaction writes below into one database transaction,
+    // so a block full of wallet transactions costs one sync instead of one
+    // per record. For SQLite wallets the batches created inside AddToWallet
+    // share this connection and join the transaction; BerkeleyDB wallets
+    // keep their per-write behavior.
+    WalletBatch batch(GetDatabase());
+    const bool txn_started = batch.TxnBegin();
     for (size_t index = 0; index < block.vtx.size(); index++) {
         SyncTransaction(block.vtx[index], {CWalletTx::Status::CONFIRMED, height, block_hash, (int)index});
         transactionRemovedFromMempool(block.vtx[index], MemPoolRemovalReason::BLOCK, 0 /* mempool_sequence */);
     }
+    if (txn_started && !batch.TxnCommit()) {
+        WalletLogPrintf("%s: Failed to commit block transactions to the wallet database\n", __func__);
+    }
 }
 
 void CWallet::blockDisconnected(const CBlock& block, int height)
@@ -1260,9 +1326,17 @@ void CWallet::blockDisconnected(const CBlock& block, int height)
     // future with a stickier abandoned state or even removing abandontransaction call.
     m_last_block_processed_height = height - 1;
     m_last_block_processed = block.hashPrevBlock;
+
+    // As in blockConnected, group the per-transaction writes into one
+    // database transaction.
+    WalletBatch batch(GetDatabase());
+    const bool txn_started = batch.TxnBegin();
     for (const CTransactionRef& ptx : block.vtx) {
         SyncTransaction(ptx, {CWalletTx::Status::UNCONFIRMED, /* block height */ 0, /* block hash */ {}, /* index */ 0});
     }
+    if (txn_started && !batch.TxnCommit()) {
+        WalletLogPrintf("%s: Failed to commit block transactions to the wallet database\n", __func__);
+    }
 }
 
 void CWallet::updatedBlockTip()
@@ -1328,6 +1402,18 @@ isminetype CWallet::IsMine(const CTxDestination& dest) const
 isminetype CWallet::IsMine(const CScript& script) const
 {
     AssertLockHeld(cs_wallet);
+
+    // Search the cache first. It mirrors the descriptor ScriptPubKeyMans'
+    // script maps exactly, so when it is complete a single lookup settles the
+    // question either way. Only wallets with a LegacyScriptPubKeyMan, whose
+    // IsMine answer cannot be enumerated, still pay for the loop below.
+    if (m_cached_spks.count(script) > 0) {
+        return ISMINE_SPENDABLE;
+    }
+    if (m_cached_spks_complete) {
+        return ISMINE_NO;
+    }
+
     isminetype result = ISMINE_NO;
     for (const auto& spk_man_pair : m_spk_managers) {
         result = std::max(result, spk_man_pair.second->IsMine(script));
@@ -1771,6 +1857,93 @@ int64_t CWallet::RescanFromTime(int64_t startTime, const WalletRescanReserver& r
  * the main chain after to the addition of any new keys you want to detect
  * transactions for.
  */
+namespace {
+/** Parallel block reader for ScanForWalletTransactions. Worker threads read
+ *  and deserialize upcoming blocks from disk while the scan thread matches
+ *  transactions and commits them to the wallet in height order. Reading is
+ *  the dominant rescan cost and only touches immutable chain data, so it can
+ *  run ahead freely; matching has to stay on the scan thread because IsMine
+ *  depends on wallet state mutated by earlier matches (e.g. keypool top-up
+ *  deriving fresh keys for a found transaction). */
+class RescanBlockReader
+{
+private:
+    interfaces::Chain& m_chain;
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::pair<int, uint256>> m_queued GUARDED_BY(m_mutex);
+    //! Completed reads by height, together with the hash that was read so the
+    //! consumer can detect a reorg that raced with the read-ahead.
+    std::map<int, std::pair<uint256, CBlock>> m_read GUARDED_BY(m_mutex);
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_workers;
+
+    void WorkerThread()
+    {
+        util::ThreadRename("rescanread");
+        for (;;) {
+            int height;
+            uint256 hash;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || !m_queued.empty(); });
+                if (m_stop) return;
+                std::tie(height, hash) = m_queued.front();
+                m_queued.pop_front();
+            }
+            // Read outside the lock. An unreadable (e.g. pruned) block is
+            // handed back as a null block, as findBlock leaves it.
+            CBlock block;
+            m_chain.findBlock(hash, interfaces::FoundBlock().data(block));
+            {
+                LOCK(m_mutex);
+                m_read.emplace(height, std::make_pair(hash, std::move(block)));
+            }
+            m_cv.notify_all();
+        }
+    }
+
+public:
+    RescanBlockReader(interfaces::Chain& chain, int num_workers) : m_chain(chain)
+    {
+        for (int i = 0; i < num_workers; ++i) {
+            m_workers.emplace_back(&RescanBlockReader::WorkerThread, this);
+        }
+    }
+
+    ~RescanBlockReader()
+    {
+        {
+            LOCK(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto& worker : m_workers) worker.join();
+    }
+
+    void Enqueue(int height, const uint256& hash)
+    {
+        {
+            LOCK(m_mutex);
+            m_queued.emplace_back(height, hash);
+        }
+        m_cv.notify_one();
+    }
+
+    //! Wait until the block at the given height has been read, and return the
+    //! hash that was read together with the block data.
+    std::pair<uint256, CBlock> WaitBlock(int height)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_read.count(height) > 0; });
+        auto it = m_read.find(height);
+        std::pair<uint256, CBlock> result = std::move(it->second);
+        m_read.erase(it);
+        return result;
+    }
+};
+} // namespace
+
 CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_block, int start_height, std::optional<int> max_height, const WalletRescanReserver& reserver, bool fUpdate)
 {
     int64_t nNow = GetTime();
@@ -1792,6 +1965,33 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     double progress_end = chain().guessVerificationProgress(end_hash);
     double progress_current = progress_begin;
     int block_height = start_height;
+
+    // Start worker threads that read and deserialize blocks ahead of the
+    // scan position, and an enumeration cursor handing them heights to read.
+    // The read-ahead window is kept small so little work is wasted on a
+    // reorg or abort.
+    int num_workers{(int)gArgs.GetArg("-rescanworkers", DEFAULT_RESCAN_WORKERS)};
+    if (num_workers <= 0) num_workers = std::max(1, GetNumCores() - 1);
+    RescanBlockReader reader(chain(), num_workers);
+    const int fetch_window = num_workers * 2 + 2;
+    int fetch_height = start_height;
+    uint256 fetch_hash = start_block;
+    int fetched_until = start_height - 1;
+    auto fetch_ahead = [&] {
+        while (fetched_until < block_height + fetch_window) {
+            if (fetched_until >= fetch_height) {
+                bool has_next = false;
+                uint256 next_hash;
+                chain().findBlock(fetch_hash, FoundBlock().nextBlock(FoundBlock().inActiveChain(has_next).hash(next_hash)));
+                if (!has_next) break;
+                fetch_hash = next_hash;
+                ++fetch_height;
+            }
+            reader.Enqueue(fetch_height, fetch_hash);
+            fetched_until = fetch_height;
+        }
+    };
+
     while (!fAbortRescan && !chain().shutdownRequested()) {
         if (progress_end - progress_begin > 0.0) {
             m_scanning_progress = (progress_current - progress_begin) / (progress_end - progress_begin);
@@ -1806,9 +2006,21 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
             WalletLogPrintf("Still rescanning. At block %d. Progress=%f\n", block_height, progress_current);
         }
 
-        // Read block data
+        // Read block data. Top up the read-ahead window and take the block
+        // for the current height from the reader; if the read-ahead raced
+        // with a reorg (or never reached this height), read synchronously.
         CBlock block;
-        chain().findBlock(block_hash, FoundBlock().data(block));
+        fetch_ahead();
+        if (fetched_until >= block_height) {
+            std::pair<uint256, CBlock> read = reader.WaitBlock(block_height);
+            if (read.first == block_hash) {
+                block = std::move(read.second);
+            } else {
+                chain().findBlock(block_hash, FoundBlock().data(block));
+            }
+        } else {
+            chain().findBlock(block_hash, FoundBlock().data(block));
+        }
 
         // Find next block separately from reading data above, because reading
         // is slow and there might be a reorg while it is read.
@@ -1826,9 +2038,16 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
                 result.status = ScanResult::FAILURE;
                 break;
             }
+            // As in blockConnected, group the per-transaction writes into one
+            // database transaction.
+            WalletBatch batch(GetDatabase());
+            const bool txn_started = batch.TxnBegin();
             for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
                 SyncTransaction(block.vtx[posInBlock], {CWalletTx::Status::CONFIRMED, block_height, block_hash, (int)posInBlock}, fUpdate);
             }
+            if (txn_started && !batch.TxnCommit()) {
+                WalletLogPrintf("%s: Failed to commit block transactions to the wallet database\n", __func__);
+            }
             // scan succeeded, record block as most recent successfully scanned
             result.last_scanned_block = block_hash;
             result.last_scanned_height = block_height;
@@ -2155,6 +2374,28 @@ void MaybeResendWalletTxs()
     }
 }
 
+void CWallet::MaybeTopUpKeyPools()
+{
+    // Holding cs_wallet for the refill mirrors the foreground path, where
+    // GetNewDestination tops up under the same lock; it just moves the cost
+    // off the address request and onto the scheduler thread.
+    LOCK(cs_wallet);
+    for (ScriptPubKeyMan* spk_man : GetActiveScriptPubKeyMans()) {
+        if (spk_man->NeedsTopUp()) {
+            // Failures (e.g. a locked wallet that cannot derive) are fine;
+            // GetNewDestination will report them if it ever runs dry.
+            spk_man->TopUp();
+        }
+    }
+}
+
+void MaybeTopUpWalletKeyPools()
+{
+    for (const std::shared_ptr<CWallet>& pwallet : GetWallets()) {
+        pwallet->MaybeTopUpKeyPools();
+    }
+}
+
 
 /** @defgroup Actions
  *
@@ -2168,6 +2409,14 @@ CWallet::Balance CWallet::GetBalance(const int min_depth, bool avoid_reuse) cons
     isminefilter reuse_filter = avoid_reuse ? ISMINE_NO : ISMINE_USED;
     {
         LOCK(cs_wallet);
+        // Serve repeated queries from the cache. Any depth, maturity or trust
+        // transition implies the tip moved, and everything else that can
+        // change the totals calls MarkBalanceDirty.
+        if (m_balance_cache_valid && m_balance_cache_min_depth == min_depth &&
+            m_balance_cache_avoid_reuse == avoid_reuse &&
+            m_balance_cache_tip == m_last_block_processed) {
+            return m_balance_cache;
+        }
         std::set<uint256> trusted_parents;
         for (const auto& entry : mapWallet)
         {
@@ -2187,6 +2436,11 @@ CWallet::Balance CWallet::GetBalance(const int min_depth, bool avoid_reuse) cons
             ret.m_mine_immature += wtx.GetImmatureCredit();
             ret.m_watchonly_immature += wtx.GetImmatureWatchOnlyCredit();
         }
+        m_balance_cache = ret;
+        m_balance_cache_min_depth = min_depth;
+        m_balance_cache_avoid_reuse = avoid_reuse;
+        m_balance_cache_tip = m_last_block_processed;
+        m_balance_cache_valid = true;
     }
     return ret;
 }
@@ -2218,27 +2472,33 @@ void CWallet::AvailableCoins(std::vector<COutput>& vCoins, bool fOnlySafe, const
     const int min_depth = {coinControl ? coinControl->m_min_depth : DEFAULT_MIN_DEPTH};
     const int max_depth = {coinControl ? coinControl->m_max_depth : DEFAULT_MAX_DEPTH};
 
-    std::set<uint256> trusted_parents;
-    for (const auto& entry : mapWallet)
-    {
-        const uint256& wtxid = entry.first;
-        const CWalletTx& wtx = entry.second;
+    // With a complete scriptPubKey cache the candidate index tracks every
+    // output that can be mine and unspent, so only the transactions it lists
+    // need to be visited. Wallets with a LegacyScriptPubKeyMan fall back to
+    // the full mapWallet walk, see m_candidate_coins.
+    const bool use_index{m_cached_spks_complete};
+    if (use_index && m_candidate_coins_dirty) {
+        RebuildCandidateCoins();
+    }
 
+    std::set<uint256> trusted_parents;
+    bool done = false;
+    const auto scan_tx = [&](const uint256& wtxid, const CWalletTx& wtx, const std::set<uint32_t>* output_indices) {
         if (!chain().checkFinalTx(*wtx.tx)) {
-            continue;
+            return;
         }
 
         if (wtx.IsImmatureCoinBase())
-            continue;
+            return;
 
         int nDepth = wtx.GetDepthInMainChain();
         if (nDepth < 0)
-            continue;
+            return;
 
         // We should not consider coins which aren't at least in our mempool
         // It's possible for these to be conflicted via ancestors which we may never be able to detect
         if (nDepth == 0 && !wtx.InMempool())
-            continue;
+            return;
 
         bool safeTx = IsTrusted(wtx, trusted_parents);
 
@@ -2274,26 +2534,30 @@ void CWallet::AvailableCoins(std::vector<COutput>& vCoins, bool fOnlySafe, const
         }
 
         if (fOnlySafe && !safeTx) {
-            continue;
+            return;
         }
 
         if (nDepth < min_depth || nDepth > max_depth) {
-            continue;
+            return;
         }
 
         for (unsigned int i = 0; i < wtx.tx->vout.size(); i++) {
+            if (output_indices && !output_indices->count(i)) {
+                continue;
+            }
+
             // Only consider selected coins if add_inputs is false
-            if (coinControl && !coinControl->m_add_inputs && !coinControl->IsSelected(COutPoint(entry.first, i))) {
+            if (coinControl && !coinControl->m_add_inputs && !coinControl->IsSelected(COutPoint(wtxid, i))) {
                 continue;
             }
 
             if (wtx.tx->vout[i].nValue < nMinimumAmount || wtx.tx->vout[i].nValue > nMaximumAmount)
                 continue;
 
-            if (coinControl && coinControl->HasSelected() && !coinControl->fAllowOtherInputs && !coinControl->IsSelected(COutPoint(entry.first, i)))
+            if (coinControl && coinControl->HasSelected() && !coinControl->fAllowOtherInputs && !coinControl->IsSelected(COutPoint(wtxid, i)))
                 continue;
 
-            if (IsLockedCoin(entry.first, i))
+            if (IsLockedCoin(wtxid, i))
                 continue;
 
             if (IsSpent(wtxid, i))
@@ -2321,15 +2585,31 @@ void CWallet::AvailableCoins(std::vector<COutput>& vCoins, bool fOnlySafe, const
                 nTotal += wtx.tx->vout[i].nValue;
 
                 if (nTotal >= nMinimumSumAmount) {
+                    done = true;
                     return;
                 }
             }
 
             // Checks the maximum number of UTXO's.
             if (nMaximumCount > 0 && vCoins.size() >= nMaximumCount) {
+                done = true;
                 return;
             }
         }
+    };
+
+    if (use_index) {
+        for (const auto& entry : m_candidate_coins) {
+            const auto mi = mapWallet.find(entry.first);
+            if (mi == mapWallet.end()) continue;
+            scan_tx(entry.first, mi->second, &entry.second);
+            if (done) return;
+        }
+    } else {
+        for (const auto& entry : mapWallet) {
+            scan_tx(entry.first, entry.second, nullptr);
+            if (done) return;
+        }
     }
 }
 
@@ -3402,6 +3682,7 @@ void CWallet::MarkDestinationsDirty(const std::set<CTxDestination>& destinations
             CTxDestination dst;
             if (ExtractDestination(wtx.tx->vout[i].scriptPubKey, dst) && destinations.count(dst)) {
                 wtx.MarkDirty();
+                MarkBalanceDirty();
                 break;
             }
         }
@@ -4489,6 +4770,12 @@ void CWallet::SetupLegacyScriptPubKeyMan()
         m_external_spk_managers[type] = spk_manager.get();
     }
     m_spk_managers[spk_manager->GetID()] = std::move(spk_manager);
+
+    // The set of scriptPubKeys a legacy wallet considers IsMine cannot be
+    // enumerated up front, so IsMine may no longer treat a miss in
+    // m_cached_spks as a definitive "not mine".
+    LOCK(cs_wallet);
+    m_cached_spks_complete = false;
 }
 
 const CKeyingMaterial& CWallet::GetEncryptionKey() const
@@ -4501,6 +4788,15 @@ bool CWallet::HasEncryptionKeys() const
     return !mapMasterKeys.empty();
 }
 
+void CWallet::TopUpCallback(const std::set<CScript>& scripts, ScriptPubKeyMan* spkm)
+{
+    // Update scriptPubKey cache
+    LOCK(cs_wallet);
+    m_cached_spks.insert(scripts.begin(), scripts.end());
+    // Outputs received before these scripts were derived may be mine now
+    m_candidate_coins_dirty = true;
+}
+
 void CWallet::ConnectScriptPubKeyManNotifiers()
 {
     for (const auto& spk_man : GetActiveScriptPubKeyMans()) {
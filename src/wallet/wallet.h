@@ -13,6 +13,7 @@
 #include <policy/feerate.h>
 #include <psbt.h>
 #include <tinyformat.h>
+#include <util/hasher.h>
 #include <util/message.h>
 #include <util/strencodings.h>
 #include <util/string.h>
@@ -35,6 +36,7 @@
 #include <stdexcept>
 #include <stdint.h>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -91,6 +93,8 @@ static const unsigned int DEFAULT_TX_CONFIRM_TARGET = 6;
 static const bool DEFAULT_WALLET_RBF = false;
 static const bool DEFAULT_WALLETBROADCAST = true;
 static const bool DEFAULT_DISABLE_WALLET = false;
+//! -rescanworkers default (0 = one reader thread per core, leaving one free)
+static const int DEFAULT_RESCAN_WORKERS = 0;
 //! -maxtxfee default
 constexpr CAmount DEFAULT_TRANSACTION_MAXFEE{COIN / 10};
 //! Discourage users to set fees higher than this amount (in satoshis) per kB
@@ -736,6 +740,49 @@ private:
     // ScriptPubKeyMan::GetID. In many cases it will be the hash of an internal structure
     std::map<uint256, std::unique_ptr<ScriptPubKeyMan>> m_spk_managers;
 
+    /**
+     * Cache of the scriptPubKeys that the descriptor ScriptPubKeyMans would
+     * report as ISMINE_SPENDABLE, i.e. the union of their script maps. It lets
+     * IsMine answer with a single hash table probe instead of querying every
+     * ScriptPubKeyMan, which matters when every mempool transaction is pushed
+     * through AddToWalletIfInvolvingMe for every loaded wallet. The cache is
+     * kept in sync through WalletStorage::TopUpCallback.
+     */
+    std::unordered_set<CScript, SaltedSipHasher> m_cached_spks GUARDED_BY(cs_wallet);
+
+    /**
+     * Whether m_cached_spks covers every scriptPubKey the wallet considers
+     * mine. False once a LegacyScriptPubKeyMan is loaded: its IsMine answer
+     * is computed from the key and script stores, so the matching
+     * scriptPubKeys cannot be enumerated up front and IsMine has to fall back
+     * to querying the ScriptPubKeyMans on a cache miss.
+     */
+    bool m_cached_spks_complete GUARDED_BY(cs_wallet){true};
+
+    /**
+     * Index of coin selection candidates: the output indices, grouped by
+     * txid, of every wallet transaction output that is mine and not spent by
+     * a live wallet transaction. AvailableCoins walks this index instead of
+     * all of mapWallet, so building the candidate set for a send scales with
+     * the number of unspent outputs rather than the wallet's history. The
+     * index is a superset — AvailableCoins re-applies every per-call filter
+     * (depth, trust, locks, coin control, IsSpent) to each candidate — and
+     * is only consumed while m_cached_spks_complete is true, because legacy
+     * IsMine answers can change without any wallet event to hook.
+     */
+    mutable std::map<uint256, std::set<uint32_t>> m_candidate_coins GUARDED_BY(cs_wallet);
+
+    //! Whether m_candidate_coins must be rebuilt before its next use, because
+    //! newly watched scriptPubKeys may have made old outputs mine (script
+    //! imports, keypool extension) or transactions were removed wholesale.
+    mutable bool m_candidate_coins_dirty GUARDED_BY(cs_wallet){true};
+
+    //! Re-evaluate whether output n of wallet transaction wtx belongs in m_candidate_coins
+    void UpdateCandidateCoin(const uint256& hash, const CWalletTx& wtx, uint32_t n) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    //! Rebuild m_candidate_coins from mapWallet
+    void RebuildCandidateCoins() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     bool CreateTransactionInternal(const std::vector<CRecipient>& vecSend, CTransactionRef& tx, CAmount& nFeeRet, int& nChangePosInOut, bilingual_str& error, const CCoinControl& coin_control, FeeCalculation& fee_calc_out, bool sign);
 
 public:
@@ -941,6 +988,10 @@ public:
     void transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) override;
     void ReacceptWalletTransactions() EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     void ResendWalletTransactions();
+    //! Top up any active keypool that has fallen below its low watermark.
+    //! Called periodically from the scheduler so GetNewDestination only has
+    //! to derive scripts synchronously when a pool is completely exhausted.
+    void MaybeTopUpKeyPools();
     struct Balance {
         CAmount m_mine_trusted{0};           //!< Trusted, at depth=GetBalance.min_depth or more
         CAmount m_mine_untrusted_pending{0}; //!< Untrusted, but in mempool (pending)
@@ -950,6 +1001,29 @@ public:
         CAmount m_watchonly_immature{0};
     };
     Balance GetBalance(int min_depth = 0, bool avoid_reuse = true) const;
+
+private:
+    /**
+     * Memoized result of the last GetBalance call. Recomputing the balance
+     * scans all of mapWallet under cs_wallet, which takes hundreds of
+     * milliseconds on large wallets, and balance pollers hit that path every
+     * few seconds. The cached result stays valid until the chain tip moves
+     * (m_balance_cache_tip no longer matching m_last_block_processed covers
+     * every depth, maturity and trust transition caused by new blocks) or
+     * until MarkBalanceDirty is called because a wallet transaction was
+     * added or changed state.
+     */
+    mutable bool m_balance_cache_valid GUARDED_BY(cs_wallet){false};
+    mutable int m_balance_cache_min_depth GUARDED_BY(cs_wallet){0};
+    mutable bool m_balance_cache_avoid_reuse GUARDED_BY(cs_wallet){false};
+    mutable uint256 m_balance_cache_tip GUARDED_BY(cs_wallet);
+    mutable Balance m_balance_cache GUARDED_BY(cs_wallet);
+
+    //! Drop the memoized GetBalance result. Called whenever a wallet
+    //! transaction is added or changes state.
+    void MarkBalanceDirty() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) { m_balance_cache_valid = false; }
+
+public:
     CAmount GetAvailableBalance(const CCoinControl* coinControl = nullptr) const;
 
     OutputType TransactionChangeType(const std::optional<OutputType>& change_type, const std::vector<CRecipient>& vecSend) const;
@@ -1247,6 +1321,9 @@ public:
     const CKeyingMaterial& GetEncryptionKey() const override;
     bool HasEncryptionKeys() const override;
 
+    //! Add scriptPubKeys produced by a ScriptPubKeyMan to the IsMine cache
+    void TopUpCallback(const std::set<CScript>& scripts, ScriptPubKeyMan* spkm) override;
+
     /** Get last block processed height */
     int GetLastBlockHeight() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet)
     {
@@ -1302,6 +1379,9 @@ public:
  */
 void MaybeResendWalletTxs();
 
+//! Called periodically by the schedule; keeps wallet keypools topped up
+void MaybeTopUpWalletKeyPools();
+
 /** RAII object to check and reserve a wallet rescan */
 class WalletRescanReserver
 {
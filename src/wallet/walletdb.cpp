@@ -25,6 +25,7 @@
 #include <atomic>
 #include <optional>
 #include <string>
+#include <thread>
 
 namespace DBKeys {
 const std::string ACENTRY{"acentry"};
@@ -693,6 +694,18 @@ DBErrors WalletBatch::LoadWallet(CWallet* pwallet)
     bool fNoncriticalErrors = false;
     DBErrors result = DBErrors::LOAD_OK;
 
+    //! A transaction record whose deserialization has been deferred to the
+    //! parallel parse below
+    struct PendingTx {
+        uint256 hash;
+        CDataStream value{SER_DISK, CLIENT_VERSION};
+        std::unique_ptr<CWalletTx> wtx;
+        std::string err;
+        bool upgraded{false};
+        bool ok{true};
+    };
+    std::vector<PendingTx> pending_txs;
+
     LOCK(pwallet->cs_wallet);
     try {
         int nMinVersion = 0;
@@ -736,6 +749,22 @@ DBErrors WalletBatch::LoadWallet(CWallet* pwallet)
                 return DBErrors::CORRUPT;
             }
 
+            // Transaction records carry no dependencies on other record
+            // types, and deserializing them dominates open time on large
+            // wallets. Defer them so they can be parsed on worker threads
+            // once the cursor scan is done.
+            {
+                CDataStream key_peek{ssKey};
+                std::string type;
+                key_peek >> type;
+                if (type == DBKeys::TX) {
+                    PendingTx& rec = pending_txs.emplace_back();
+                    key_peek >> rec.hash;
+                    rec.value = std::move(ssValue);
+                    continue;
+                }
+            }
+
             // Try to be tolerant of single corrupt records:
             std::string strType, strErr;
             if (!ReadKeyValue(pwallet, ssKey, ssValue, wss, strType, strErr))
@@ -763,6 +792,90 @@ DBErrors WalletBatch::LoadWallet(CWallet* pwallet)
     }
     m_batch->CloseCursor();
 
+    if (!pending_txs.empty() && result != DBErrors::CORRUPT) {
+        // Parse the deferred transaction records in parallel. The workers
+        // only deserialize into free-standing objects; all wallet state is
+        // wired up single-threaded below, in the original record order.
+        int num_workers{(int)gArgs.GetArg("-walletloadworkers", DEFAULT_WALLET_LOAD_WORKERS)};
+        if (num_workers <= 0) num_workers = std::max(1, GetNumCores() - 1);
+        num_workers = std::min<int>(num_workers, pending_txs.size());
+        std::atomic<size_t> next_rec{0};
+        auto parse_worker = [&]() {
+            size_t i;
+            while ((i = next_rec.fetch_add(1)) < pending_txs.size()) {
+                PendingTx& rec = pending_txs[i];
+                try {
+                    rec.wtx = std::make_unique<CWalletTx>(pwallet, nullptr);
+                    rec.value >> *rec.wtx;
+                    if (rec.wtx->GetHash() != rec.hash) {
+                        rec.ok = false;
+                        continue;
+                    }
+                    // Undo serialize changes in 31600
+                    if (31404 <= rec.wtx->fTimeReceivedIsTxTime && rec.wtx->fTimeReceivedIsTxTime <= 31703) {
+                        if (!rec.value.empty()) {
+                            char fTmp;
+                            char fUnused;
+                            std::string unused_string;
+                            rec.value >> fTmp >> fUnused >> unused_string;
+                            rec.err = strprintf("LoadWallet() upgrading tx ver=%d %d %s",
+                                                rec.wtx->fTimeReceivedIsTxTime, fTmp, rec.hash.ToString());
+                            rec.wtx->fTimeReceivedIsTxTime = fTmp;
+                        } else {
+                            rec.err = strprintf("LoadWallet() repairing tx ver=%d %s", rec.wtx->fTimeReceivedIsTxTime, rec.hash.ToString());
+                            rec.wtx->fTimeReceivedIsTxTime = 0;
+                        }
+                        rec.upgraded = true;
+                    }
+                } catch (const std::exception& e) {
+                    rec.ok = false;
+                    rec.err = e.what();
+                } catch (...) {
+                    rec.ok = false;
+                    rec.err = "Caught unknown exception deserializing tx record";
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(num_workers - 1);
+        for (int n = 1; n < num_workers; ++n) workers.emplace_back(parse_worker);
+        parse_worker();
+        for (std::thread& t : workers) t.join();
+
+        for (PendingTx& rec : pending_txs) {
+            bool loaded = rec.ok;
+            if (loaded) {
+                loaded = pwallet->LoadToWallet(rec.hash, [&rec](CWalletTx& wtx, bool new_tx) {
+                    assert(new_tx);
+                    // Adopt the pre-parsed record; this mirrors exactly the
+                    // fields CWalletTx::Unserialize fills in.
+                    wtx.SetTx(rec.wtx->tx);
+                    wtx.m_confirm = rec.wtx->m_confirm;
+                    wtx.mapValue = std::move(rec.wtx->mapValue);
+                    wtx.vOrderForm = std::move(rec.wtx->vOrderForm);
+                    wtx.fTimeReceivedIsTxTime = rec.wtx->fTimeReceivedIsTxTime;
+                    wtx.nTimeReceived = rec.wtx->nTimeReceived;
+                    wtx.fFromMe = rec.wtx->fFromMe;
+                    wtx.nOrderPos = rec.wtx->nOrderPos;
+                    wtx.nTimeSmart = rec.wtx->nTimeSmart;
+                    return true;
+                });
+                if (loaded) {
+                    if (rec.upgraded) wss.vWalletUpgrade.push_back(rec.hash);
+                    if (rec.wtx->nOrderPos == -1) wss.fAnyUnordered = true;
+                }
+            }
+            if (!loaded) {
+                // Same tolerance as ReadKeyValue: warn and rescan rather
+                // than refusing to load the wallet.
+                fNoncriticalErrors = true;
+                gArgs.SoftSetBoolArg("-rescan", true);
+            }
+            if (!rec.err.empty()) pwallet->WalletLogPrintf("%s\n", rec.err);
+            rec.wtx.reset();
+        }
+    }
+
     // Set the active ScriptPubKeyMans
     for (auto spk_man_pair : wss.m_active_external_spks) {
         pwallet->LoadActiveScriptPubKeyMan(spk_man_pair.second, spk_man_pair.first, /* internal */ false);
@@ -949,6 +1062,12 @@ void MaybeCompactWalletDB()
         return;
     }
 
+    // Write-behind durability window: keep deferring the flush while writes
+    // keep arriving, so a burst of deposits becomes one sync instead of many
+    // small ones. A hard durability point is available via the flushwallet
+    // RPC.
+    const int64_t flush_window_ms{gArgs.GetArg("-walletflushwindow", DEFAULT_WALLET_FLUSH_WINDOW_MS)};
+
     for (const std::shared_ptr<CWallet>& pwallet : GetWallets()) {
         WalletDatabase& dbh = pwallet->GetDatabase();
 
@@ -956,10 +1075,10 @@ void MaybeCompactWalletDB()
 
         if (dbh.nLastSeen != nUpdateCounter) {
             dbh.nLastSeen = nUpdateCounter;
-            dbh.nLastWalletUpdate = GetTime();
+            dbh.nLastWalletUpdate = GetTimeMillis();
         }
 
-        if (dbh.nLastFlushed != nUpdateCounter && GetTime() - dbh.nLastWalletUpdate >= 2) {
+        if (dbh.nLastFlushed != nUpdateCounter && GetTimeMillis() - dbh.nLastWalletUpdate >= flush_window_ms) {
             if (dbh.PeriodicFlush()) {
                 dbh.nLastFlushed = nUpdateCounter;
             }
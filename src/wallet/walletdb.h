@@ -29,6 +29,8 @@
  */
 
 static const bool DEFAULT_FLUSHWALLET = true;
+//! -walletloadworkers default; 0 means one per core, minus one for the loading thread
+static const int DEFAULT_WALLET_LOAD_WORKERS = 0;
 
 struct CBlockLocator;
 class CKeyPool;
@@ -276,6 +278,10 @@ private:
 };
 
 //! Compacts BDB state so that wallet.dat is self-contained (if there are changes)
+/** Default write-behind durability window: wallet writes are batched and
+ * flushed once no new write has arrived for this long. */
+static constexpr int64_t DEFAULT_WALLET_FLUSH_WINDOW_MS{2000};
+
 void MaybeCompactWalletDB();
 
 //! Callback for filtering key types to deserialize in ReadKeyValue
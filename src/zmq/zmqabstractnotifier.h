@@ -6,9 +6,12 @@
 #define BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
 
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 
+class CBlock;
 class CBlockIndex;
 class CTransaction;
 class CZMQAbstractNotifier;
@@ -34,6 +37,9 @@ public:
     std::string GetAddress() const { return address; }
     void SetAddress(const std::string &a) { address = a; }
     int GetOutboundMessageHighWaterMark() const { return outbound_message_high_water_mark; }
+    uint64_t GetMessagesPublished() const { return m_published; }
+    uint64_t GetMessagesDropped() const { return m_dropped; }
+    uint64_t GetQueueFullEvents() const { return m_queue_full_events; }
     void SetOutboundMessageHighWaterMark(const int sndhwm) {
         if (sndhwm >= 0) {
             outbound_message_high_water_mark = sndhwm;
@@ -55,12 +61,17 @@ public:
     virtual bool NotifyTransactionRemoval(const CTransaction &transaction, uint64_t mempool_sequence);
     // Notifies of transactions added to mempool or appearing in blocks
     virtual bool NotifyTransaction(const CTransaction &transaction);
+    // Notifies of a freshly assembled block template
+    virtual bool NotifyBlockTemplate(const CBlock &block);
 
 protected:
     void *psocket;
     std::string type;
     std::string address;
     int outbound_message_high_water_mark; // aka SNDHWM
+    std::atomic<uint64_t> m_published{0}; //!< messages handed to the transport
+    std::atomic<uint64_t> m_dropped{0}; //!< messages lost to a full queue or a failed send
+    std::atomic<uint64_t> m_queue_full_events{0}; //!< times a message arrived while the publish queue was full
 };
 
 #endif // BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
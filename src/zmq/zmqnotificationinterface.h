@@ -21,6 +21,10 @@ public:
 
     static CZMQNotificationInterface* Create();
 
+    //! Not a validation event: called directly by the block assembler
+    //! whenever a template is built from scratch.
+    void BlockTemplate(const CBlock& block);
+
 protected:
     bool Initialize();
     void Shutdown();
@@ -8,26 +8,102 @@
 #include <chainparams.h>
 #include <rpc/server.h>
 #include <streams.h>
+#include <sync.h>
 #include <util/system.h>
+#include <util/threadnames.h>
 #include <validation.h>
 #include <zmq/zmqutil.h>
 
 #include <zmq.h>
 
+#include <condition_variable>
 #include <cstdarg>
 #include <cstddef>
+#include <deque>
 #include <map>
 #include <optional>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 static std::multimap<std::string, CZMQAbstractPublishNotifier*> mapPublishNotifiers;
 
+/** A message queued for the publish thread. The sequence number is assigned
+ * at enqueue time so the wire ordering matches the notification ordering. */
+struct ZMQQueuedMessage
+{
+    CZMQAbstractPublishNotifier* notifier;
+    std::string command;
+    std::vector<unsigned char> data;
+    uint32_t sequence;
+};
+
+/** Maximum number of messages buffered for the publish thread. Beyond this,
+ * new messages are dropped rather than back-pressuring validation. */
+static const size_t MAX_PUBLISH_QUEUE_SIZE = 10000;
+/** Messages drained per lock acquisition, so mempool floods do not pay a
+ * wakeup and lock round trip per message. */
+static const size_t PUBLISH_BATCH_SIZE = 64;
+
+static Mutex g_publish_mutex;
+static std::condition_variable g_publish_cv;
+static std::deque<ZMQQueuedMessage> g_publish_queue GUARDED_BY(g_publish_mutex);
+static bool g_publish_running GUARDED_BY(g_publish_mutex) = false;
+static std::thread g_publish_thread;
+
+/** Drains the publish queue. The only thread touching the sockets once
+ * running; stopped (with a final flush) before any socket is closed. */
+static void ThreadZMQPublish()
+{
+    util::ThreadRename("zmqpub");
+    std::vector<ZMQQueuedMessage> batch;
+    while (true) {
+        batch.clear();
+        {
+            WAIT_LOCK(g_publish_mutex, lock);
+            while (g_publish_running && g_publish_queue.empty()) {
+                g_publish_cv.wait(lock);
+            }
+            // Flush whatever is left before exiting
+            if (!g_publish_running && g_publish_queue.empty()) break;
+            const size_t n = std::min(g_publish_queue.size(), PUBLISH_BATCH_SIZE);
+            for (size_t i = 0; i < n; ++i) {
+                batch.push_back(std::move(g_publish_queue.front()));
+                g_publish_queue.pop_front();
+            }
+        }
+        for (const ZMQQueuedMessage& msg : batch) {
+            msg.notifier->SendZmqMessageDirect(msg.command.c_str(), msg.data, msg.sequence);
+        }
+    }
+}
+
 static const char *MSG_HASHBLOCK = "hashblock";
 static const char *MSG_HASHTX    = "hashtx";
 static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
 static const char *MSG_SEQUENCE  = "sequence";
+static const char *MSG_RAWTMPL   = "rawtemplate";
+
+static void StartPublishThread()
+{
+    LOCK(g_publish_mutex);
+    if (g_publish_running) return;
+    g_publish_running = true;
+    g_publish_thread = std::thread(ThreadZMQPublish);
+}
+
+static void StopPublishThread()
+{
+    {
+        LOCK(g_publish_mutex);
+        if (!g_publish_running) return;
+        g_publish_running = false;
+        g_publish_cv.notify_all();
+    }
+    g_publish_thread.join();
+}
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -116,6 +192,7 @@ bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
 
         // register this notifier for the address, so it can be reused for other publish notifier
         mapPublishNotifiers.insert(std::make_pair(address, this));
+        StartPublishThread();
         return true;
     }
     else
@@ -125,6 +202,7 @@ bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
 
         psocket = i->second->psocket;
         mapPublishNotifiers.insert(std::make_pair(address, this));
+        StartPublishThread();
 
         return true;
     }
@@ -135,6 +213,10 @@ void CZMQAbstractPublishNotifier::Shutdown()
     // Early return if Initialize was not called
     if (!psocket) return;
 
+    // Stop the publish thread (flushing any queued messages) before the
+    // first socket is closed; queued messages may target any notifier.
+    StopPublishThread();
+
     int count = mapPublishNotifiers.count(address);
 
     // remove this notifier from the list of publishers using this address
@@ -161,20 +243,41 @@ void CZMQAbstractPublishNotifier::Shutdown()
     psocket = nullptr;
 }
 
-bool CZMQAbstractPublishNotifier::SendZmqMessage(const char *command, const void* data, size_t size)
+bool CZMQAbstractPublishNotifier::SendZmqMessageDirect(const char* command, const std::vector<unsigned char>& data, uint32_t sequence)
 {
     assert(psocket);
 
     /* send three parts, command & data & a LE 4byte sequence number */
     unsigned char msgseq[sizeof(uint32_t)];
-    WriteLE32(&msgseq[0], nSequence);
-    int rc = zmq_send_multipart(psocket, command, strlen(command), data, size, msgseq, (size_t)sizeof(uint32_t), nullptr);
-    if (rc == -1)
+    WriteLE32(&msgseq[0], sequence);
+    int rc = zmq_send_multipart(psocket, command, strlen(command), data.data(), data.size(), msgseq, (size_t)sizeof(uint32_t), nullptr);
+    if (rc == -1) {
+        m_dropped++;
         return false;
+    }
+
+    m_published++;
+    return true;
+}
 
-    /* increment memory only sequence number after sending */
-    nSequence++;
+bool CZMQAbstractPublishNotifier::SendZmqMessage(const char *command, const void* data, size_t size)
+{
+    assert(psocket);
 
+    LOCK(g_publish_mutex);
+    const uint32_t sequence = nSequence++;
+    if (!g_publish_running) {
+        // No publish thread (it is stopped during shutdown, after validation
+        // notifications have ceased); send synchronously.
+        return SendZmqMessageDirect(command, std::vector<unsigned char>((const unsigned char*)data, (const unsigned char*)data + size), sequence);
+    }
+    if (g_publish_queue.size() >= MAX_PUBLISH_QUEUE_SIZE) {
+        m_queue_full_events++;
+        m_dropped++;
+        return false;
+    }
+    g_publish_queue.push_back(ZMQQueuedMessage{this, command, std::vector<unsigned char>((const unsigned char*)data, (const unsigned char*)data + size), sequence});
+    g_publish_cv.notify_one();
     return true;
 }
 
@@ -228,6 +331,16 @@ bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &tr
     return SendZmqMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
 }
 
+bool CZMQPublishRawTemplateNotifier::NotifyBlockTemplate(const CBlock &block)
+{
+    // The header carries no valid proof of work yet, so identify the
+    // template by the tip it builds on.
+    LogPrint(BCLog::ZMQ, "zmq: Publish rawtemplate on %s to %s\n", block.hashPrevBlock.GetHex(), this->address);
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
+    ss << block;
+    return SendZmqMessage(MSG_RAWTMPL, &(*ss.begin()), ss.size());
+}
+
 // Helper function to send a 'sequence' topic message with the following structure:
 //    <32-byte hash> | <1-byte label> | <8-byte LE sequence> (optional)
 static bool SendSequenceMsg(CZMQAbstractPublishNotifier& notifier, uint256 hash, char label, std::optional<uint64_t> sequence = {})
@@ -7,23 +7,31 @@
 
 #include <zmq/zmqabstractnotifier.h>
 
+#include <vector>
+
 class CBlockIndex;
 
 class CZMQAbstractPublishNotifier : public CZMQAbstractNotifier
 {
 private:
-    uint32_t nSequence {0U}; //!< upcounting per message sequence number
+    uint32_t nSequence {0U}; //!< upcounting per message sequence number, assigned at enqueue time
 
 public:
 
-    /* send zmq multipart message
+    /* queue a zmq multipart message for the publish thread
        parts:
           * command
           * data
           * message sequence number
-    */
+       Returns false if the message was dropped because the queue is full.
+       A dropped message leaves a gap in the sequence numbers, which tells
+       subscribers they missed a notification. */
     bool SendZmqMessage(const char *command, const void* data, size_t size);
 
+    /* perform the actual socket send; only called by the publish thread (or
+       inline when it is not running) */
+    bool SendZmqMessageDirect(const char* command, const std::vector<unsigned char>& data, uint32_t sequence);
+
     bool Initialize(void *pcontext) override;
     void Shutdown() override;
 };
@@ -52,6 +60,12 @@ public:
     bool NotifyTransaction(const CTransaction &transaction) override;
 };
 
+class CZMQPublishRawTemplateNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyBlockTemplate(const CBlock &block) override;
+};
+
 class CZMQPublishSequenceNotifier : public CZMQAbstractPublishNotifier
 {
 public:
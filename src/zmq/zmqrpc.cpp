@@ -26,6 +26,9 @@ static RPCHelpMan getzmqnotifications()
                             {RPCResult::Type::STR, "type", "Type of notification"},
                             {RPCResult::Type::STR, "address", "Address of the publisher"},
                             {RPCResult::Type::NUM, "hwm", "Outbound message high water mark"},
+                            {RPCResult::Type::NUM, "published", "Number of messages handed to the transport"},
+                            {RPCResult::Type::NUM, "dropped", "Number of messages lost to a full publish queue or a failed send"},
+                            {RPCResult::Type::NUM, "queue_full_events", "Number of times a message arrived while the publish queue was full"},
                         }},
                     }
                 },
@@ -42,6 +45,9 @@ static RPCHelpMan getzmqnotifications()
             obj.pushKV("type", n->GetType());
             obj.pushKV("address", n->GetAddress());
             obj.pushKV("hwm", n->GetOutboundMessageHighWaterMark());
+            obj.pushKV("published", n->GetMessagesPublished());
+            obj.pushKV("dropped", n->GetMessagesDropped());
+            obj.pushKV("queue_full_events", n->GetQueueFullEvents());
             result.push_back(obj);
         }
     }